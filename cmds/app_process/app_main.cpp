@@ -7,6 +7,8 @@
 
 #define LOG_TAG "appproc"
 
+#include <dirent.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/prctl.h>
@@ -162,6 +164,37 @@ static void maybeCreateDalvikCache() {
             "Error changing dalvik-cache permissions : %s", strerror(errno));
 }
 
+// Ask the kernel to start paging the boot image files for this ISA into the
+// page cache.  The runtime maps them shortly after startup anyway; queueing
+// the readahead before VM creation overlaps the storage reads with runtime
+// initialization, which matters most when the zygote is restarted after a
+// system_server crash and every app is waiting on it.  Failures here are
+// harmless - the runtime simply faults the pages in on demand as before.
+static void prefetchBootImage() {
+    static const char bootImageDir[] = "/system/framework/" ABI_STRING;
+    DIR* dir = opendir(bootImageDir);
+    if (dir == NULL) {
+        return;
+    }
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+        char path[PATH_MAX];
+        if (snprintf(path, PATH_MAX, "%s/%s", bootImageDir, entry->d_name) >= PATH_MAX) {
+            continue;
+        }
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+    }
+    closedir(dir);
+}
+
 #if defined(__LP64__)
 static const char ABI_LIST_PROPERTY[] = "ro.product.cpu.abilist64";
 static const char ZYGOTE_NICE_NAME[] = "zygote64";
@@ -305,6 +338,7 @@ int main(int argc, char* const argv[])
     } else {
         // We're in zygote mode.
         maybeCreateDalvikCache();
+        prefetchBootImage();
 
         if (startSystemServer) {
             args.add(String8("start-system-server"));
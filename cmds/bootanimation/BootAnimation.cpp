@@ -29,6 +29,11 @@
 #include <signal.h>
 #include <time.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include <cutils/atomic.h>
 #include <cutils/properties.h>
 
@@ -98,6 +103,8 @@ static const int TEXT_MISSING_VALUE = INT_MIN;
 static const char EXIT_PROP_NAME[] = "service.bootanim.exit";
 static const int ANIM_ENTRY_NAME_MAX = 256;
 static constexpr size_t TEXT_POS_LEN_MAX = 16;
+// How many frames the decoder thread may run ahead of the playhead.
+static constexpr size_t DECODE_AHEAD_FRAMES = 2;
 
 // ---------------------------------------------------------------------------
 
@@ -211,16 +218,31 @@ status_t BootAnimation::initTexture(Texture* texture, AssetManager& assets,
 status_t BootAnimation::initTexture(FileMap* map, int* width, int* height)
 {
     SkBitmap bitmap;
+    status_t status = decodeFrame(map, &bitmap);
+    if (status != NO_ERROR) {
+        return status;
+    }
+    return uploadTexture(bitmap, width, height, /*allowStorageReuse=*/false);
+}
+
+status_t BootAnimation::decodeFrame(FileMap* map, SkBitmap* bitmap)
+{
     sk_sp<SkData> data = SkData::MakeWithoutCopy(map->getDataPtr(),
             map->getDataLength());
     sk_sp<SkImage> image = SkImage::MakeFromEncoded(data);
-    image->asLegacyBitmap(&bitmap, SkImage::kRO_LegacyBitmapMode);
+    image->asLegacyBitmap(bitmap, SkImage::kRO_LegacyBitmapMode);
 
     // FileMap memory is never released until application exit.
-    // Release it now as the texture is already loaded and the memory used for
+    // Release it now as the pixels are decoded and the memory used for
     // the packed resource can be released.
     delete map;
 
+    return NO_ERROR;
+}
+
+status_t BootAnimation::uploadTexture(const SkBitmap& bitmap, int* width, int* height,
+                                      bool allowStorageReuse)
+{
     const int w = bitmap.width();
     const int h = bitmap.height();
     const void* p = bitmap.getPixels();
@@ -231,34 +253,43 @@ status_t BootAnimation::initTexture(FileMap* map, int* width, int* height)
     if (tw < w) tw <<= 1;
     if (th < h) th <<= 1;
 
+    GLenum format = 0;
+    GLenum type = 0;
     switch (bitmap.colorType()) {
         case kN32_SkColorType:
-            if (!mUseNpotTextures && (tw != w || th != h)) {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tw, th, 0, GL_RGBA,
-                        GL_UNSIGNED_BYTE, nullptr);
-                glTexSubImage2D(GL_TEXTURE_2D, 0,
-                        0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, p);
-            } else {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA,
-                        GL_UNSIGNED_BYTE, p);
-            }
+            format = GL_RGBA;
+            type = GL_UNSIGNED_BYTE;
             break;
-
         case kRGB_565_SkColorType:
-            if (!mUseNpotTextures && (tw != w || th != h)) {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, tw, th, 0, GL_RGB,
-                        GL_UNSIGNED_SHORT_5_6_5, nullptr);
-                glTexSubImage2D(GL_TEXTURE_2D, 0,
-                        0, 0, w, h, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, p);
-            } else {
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, w, h, 0, GL_RGB,
-                        GL_UNSIGNED_SHORT_5_6_5, p);
-            }
+            format = GL_RGB;
+            type = GL_UNSIGNED_SHORT_5_6_5;
             break;
         default:
             break;
     }
 
+    if (format != 0) {
+        if (allowStorageReuse && w == mSharedTexWidth && h == mSharedTexHeight &&
+                format == mSharedTexFormat) {
+            // The bound texture already has storage of the right geometry.
+            // Respecifying it with glTexImage2D would make the driver
+            // reallocate, so just replace the texels.
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, format, type, p);
+        } else {
+            if (!mUseNpotTextures && (tw != w || th != h)) {
+                glTexImage2D(GL_TEXTURE_2D, 0, format, tw, th, 0, format, type, nullptr);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, w, h, format, type, p);
+            } else {
+                glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0, format, type, p);
+            }
+            if (allowStorageReuse) {
+                mSharedTexWidth = w;
+                mSharedTexHeight = h;
+                mSharedTexFormat = format;
+            }
+        }
+    }
+
     glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_CROP_RECT_OES, crop);
 
     *width = w;
@@ -938,6 +969,30 @@ bool BootAnimation::playAnimation(const Animation& animation)
             continue; //to next part
         }
 
+        // Decode runs ahead of the playhead on its own thread for the first
+        // pass over this part, so PNG decoding overlaps the upload and swap
+        // of the previous frame instead of stalling the GL thread. Each frame
+        // is decoded exactly once; repeats reuse the textures.
+        std::deque<SkBitmap> decodedFrames;
+        std::mutex decodeMutex;
+        std::condition_variable decodeCondition;
+        bool decodeCanceled = false;
+        std::thread decodeThread([&]() {
+            for (size_t j = 0; j < fcount; j++) {
+                SkBitmap bitmap;
+                decodeFrame(part.frames[j].map, &bitmap);
+                std::unique_lock<std::mutex> lock(decodeMutex);
+                decodeCondition.wait(lock, [&] {
+                    return decodedFrames.size() < DECODE_AHEAD_FRAMES || decodeCanceled;
+                });
+                if (decodeCanceled) {
+                    return;
+                }
+                decodedFrames.push_back(std::move(bitmap));
+                decodeCondition.notify_all();
+            }
+        });
+
         for (int r=0 ; !part.count || r<part.count ; r++) {
             // Exit any non playuntil complete parts immediately
             if(exitPending() && !part.playUntilComplete)
@@ -964,8 +1019,18 @@ bool BootAnimation::playAnimation(const Animation& animation)
                         glTexParameterx(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
                         glTexParameterx(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
                     }
+                    SkBitmap bitmap;
+                    {
+                        std::unique_lock<std::mutex> lock(decodeMutex);
+                        decodeCondition.wait(lock, [&] { return !decodedFrames.empty(); });
+                        bitmap = std::move(decodedFrames.front());
+                        decodedFrames.pop_front();
+                        decodeCondition.notify_all();
+                    }
                     int w, h;
-                    initTexture(frame.map, &w, &h);
+                    // Parts with count == 1 upload every frame into the same
+                    // unnamed texture, so its storage can be reused.
+                    uploadTexture(bitmap, &w, &h, part.count == 1);
                 }
 
                 const int xc = animationX + frame.trimX;
@@ -1019,6 +1084,12 @@ bool BootAnimation::playAnimation(const Animation& animation)
                 break;
         }
 
+        {
+            std::unique_lock<std::mutex> lock(decodeMutex);
+            decodeCanceled = true;
+        }
+        decodeCondition.notify_all();
+        decodeThread.join();
     }
 
     // Free textures created for looping parts now that the animation is done.
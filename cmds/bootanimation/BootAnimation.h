@@ -145,6 +145,13 @@ private:
 
     status_t initTexture(Texture* texture, AssetManager& asset, const char* name);
     status_t initTexture(FileMap* map, int* width, int* height);
+    // The two halves of initTexture(FileMap*, ...): decodeFrame runs on any
+    // thread and consumes the map, uploadTexture must run on the GL thread.
+    // allowStorageReuse uploads into the currently allocated storage of the
+    // bound texture when the geometry still matches.
+    status_t decodeFrame(FileMap* map, SkBitmap* bitmap);
+    status_t uploadTexture(const SkBitmap& bitmap, int* width, int* height,
+                           bool allowStorageReuse);
     status_t initFont(Font* font, const char* fallback);
     bool android();
     bool movie();
@@ -171,6 +178,11 @@ private:
     int         mCurrentInset;
     int         mTargetInset;
     bool        mUseNpotTextures = false;
+    // Geometry of the storage currently allocated for the shared frame
+    // texture, so equal-sized frames can reuse it via glTexSubImage2D.
+    int         mSharedTexWidth = 0;
+    int         mSharedTexHeight = 0;
+    uint32_t    mSharedTexFormat = 0;
     EGLDisplay  mDisplay;
     EGLDisplay  mContext;
     EGLDisplay  mSurface;
@@ -20,12 +20,18 @@
 #include <sys/types.h>  // umask
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstring>
 #include <fstream>
 #include <memory>
 #include <ostream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "android-base/macros.h"
 #include "android-base/stringprintf.h"
@@ -159,4 +165,111 @@ Status Idmap2Service::createIdmap(const std::string& target_apk_path,
   return ok();
 }
 
+Status Idmap2Service::createIdmapBatch(const std::vector<std::string>& target_apk_paths,
+                                       const std::vector<std::string>& overlay_apk_paths,
+                                       int32_t fulfilled_policies, bool enforce_overlayable,
+                                       int32_t user_id ATTRIBUTE_UNUSED,
+                                       std::vector<std::unique_ptr<std::string>>* _aidl_return) {
+  assert(_aidl_return);
+  SYSTRACE << "Idmap2Service::createIdmapBatch " << overlay_apk_paths.size() << " pairs";
+  _aidl_return->clear();
+  if (target_apk_paths.size() != overlay_apk_paths.size()) {
+    return error(base::StringPrintf("createIdmapBatch: %zu target paths but %zu overlay paths",
+                                    target_apk_paths.size(), overlay_apk_paths.size()));
+  }
+  _aidl_return->resize(overlay_apk_paths.size());
+  if (overlay_apk_paths.empty()) {
+    return ok();
+  }
+
+  const PolicyBitmask policy_bitmask = ConvertAidlArgToPolicyBitmask(fulfilled_policies);
+  // Worker threads have no binder identity; capture the caller here.
+  const uid_t uid = IPCThreadState::self()->getCallingUid();
+  umask(kIdmapFilePermissionMask);
+
+  // Several overlays typically share a target (framework-res most of all): parse each distinct
+  // target APK once up front and let the pairs below borrow it. The map is read-only once the
+  // workers start.
+  std::unordered_map<std::string, std::unique_ptr<const ApkAssets>> targets;
+  std::vector<std::string> distinct_target_paths;
+  for (const std::string& path : target_apk_paths) {
+    if (targets.emplace(path, nullptr).second) {
+      distinct_target_paths.push_back(path);
+    }
+  }
+  std::vector<std::unique_ptr<const ApkAssets>> loaded_targets =
+      ApkAssets::LoadParallel(distinct_target_paths);
+  for (size_t i = 0; i < distinct_target_paths.size(); i++) {
+    if (!loaded_targets[i]) {
+      LOG(ERROR) << "failed to load apk " << distinct_target_paths[i];
+    }
+    targets[distinct_target_paths[i]] = std::move(loaded_targets[i]);
+  }
+
+  // Each pair verifies and writes an independent idmap; a failed pair leaves its result entry
+  // null instead of failing the whole batch.
+  std::atomic<size_t> next_pair(0);
+  const auto worker = [&]() {
+    while (true) {
+      const size_t i = next_pair.fetch_add(1, std::memory_order_relaxed);
+      if (i >= overlay_apk_paths.size()) {
+        return;
+      }
+      const std::string& overlay_apk_path = overlay_apk_paths[i];
+      const std::string idmap_path = Idmap::CanonicalIdmapPathFor(kIdmapCacheDir, overlay_apk_path);
+      if (!UidHasWriteAccessToPath(uid, idmap_path)) {
+        LOG(ERROR) << "will not write to " << idmap_path << ": calling uid " << uid
+                   << " lacks write access";
+        continue;
+      }
+      const std::unique_ptr<const ApkAssets>& target_apk = targets.find(target_apk_paths[i])->second;
+      if (!target_apk) {
+        continue;  // already logged when the target was loaded
+      }
+      const std::unique_ptr<const ApkAssets> overlay_apk = ApkAssets::Load(overlay_apk_path);
+      if (!overlay_apk) {
+        LOG(ERROR) << "failed to load apk " << overlay_apk_path;
+        continue;
+      }
+      const auto idmap = Idmap::FromApkAssets(target_apk_paths[i], *target_apk, overlay_apk_path,
+                                              *overlay_apk, policy_bitmask, enforce_overlayable);
+      if (!idmap) {
+        LOG(ERROR) << idmap.GetErrorMessage();
+        continue;
+      }
+      std::ofstream fout(idmap_path);
+      if (fout.fail()) {
+        LOG(ERROR) << "failed to open idmap path " << idmap_path;
+        continue;
+      }
+      BinaryStreamVisitor visitor(fout);
+      (*idmap)->accept(&visitor);
+      fout.close();
+      if (fout.fail()) {
+        LOG(ERROR) << "failed to write to idmap path " << idmap_path;
+        continue;
+      }
+      (*_aidl_return)[i] = std::make_unique<std::string>(idmap_path);
+    }
+  };
+
+  constexpr size_t kMaxBatchThreads = 4u;
+  const size_t thread_count =
+      std::min({overlay_apk_paths.size(),
+                static_cast<size_t>(std::thread::hardware_concurrency()), kMaxBatchThreads});
+  if (thread_count <= 1u) {
+    worker();
+    return ok();
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (size_t t = 0; t < thread_count; t++) {
+    threads.emplace_back(worker);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return ok();
+}
+
 }  // namespace android::os
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "android/os/BnIdmap2.h"
 
@@ -46,6 +47,16 @@ class Idmap2Service : public BinderService<Idmap2Service>, public BnIdmap2 {
                              const std::string& overlay_apk_path, int32_t fulfilled_policies,
                              bool enforce_overlayable, int32_t user_id,
                              std::unique_ptr<std::string>* _aidl_return);
+
+  // Batch variant of createIdmap: creates an idmap for each (target, overlay) pair. Distinct
+  // target APKs are parsed once and shared between their overlays, and the pairs are processed
+  // on a small pool of threads. The returned vector matches the input order; an entry is null
+  // if creating that idmap failed.
+  binder::Status createIdmapBatch(const std::vector<std::string>& target_apk_paths,
+                                  const std::vector<std::string>& overlay_apk_paths,
+                                  int32_t fulfilled_policies, bool enforce_overlayable,
+                                  int32_t user_id,
+                                  std::vector<std::unique_ptr<std::string>>* _aidl_return);
 };
 
 }  // namespace android::os
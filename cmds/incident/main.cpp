@@ -21,6 +21,7 @@
 #include <android/os/BnIncidentReportStatusListener.h>
 #include <android/os/IIncidentManager.h>
 #include <android/os/IncidentReportArgs.h>
+#include <android/os/IncidentReportStreamReader.h>
 #include <android/util/ProtoOutputStream.h>
 #include <binder/IPCThreadState.h>
 #include <binder/IServiceManager.h>
@@ -197,6 +198,82 @@ parse_receiver_arg(const string& arg, string* pkg, string* cls)
     return true;
 }
 
+// ================================================================================
+static IncidentSection const*
+find_section_by_id(int id)
+{
+    for (int i = 0; i < INCIDENT_SECTION_COUNT; i++) {
+        if (INCIDENT_SECTIONS[i].id == id) {
+            return INCIDENT_SECTIONS + i;
+        }
+    }
+    return NULL;
+}
+
+// ================================================================================
+static bool
+write_all(int fd, const uint8_t* buf, size_t size)
+{
+    size_t pos = 0;
+    while (pos < size) {
+        ssize_t amt = TEMP_FAILURE_RETRY(write(fd, buf + pos, size - pos));
+        if (amt < 0) {
+            return false;
+        }
+        pos += amt;
+    }
+    return true;
+}
+
+static bool
+write_varint(int fd, uint64_t value)
+{
+    uint8_t buf[10];
+    size_t size = 0;
+    while (value >= 0x80) {
+        buf[size++] = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+    buf[size++] = value;
+    return write_all(fd, buf, size);
+}
+
+/*
+ * Forwards the report to stdout one section at a time as incidentd finishes
+ * each one, announcing section boundaries on stderr so a consumer that only
+ * needs early sections does not have to wait out the slow ones.  Buffering is
+ * bounded to a single section.  The proto framing is re-emitted unchanged, so
+ * stdout carries the same bytes as the plain stream mode.
+ */
+static int
+stream_sections(int fd)
+{
+    IncidentReportStreamReader reader(fd);
+    int sectionId;
+    vector<uint8_t> data;
+
+    status_t err;
+    while ((err = reader.nextSection(&sectionId, &data)) == NO_ERROR) {
+        IncidentSection const* ic = find_section_by_id(sectionId);
+        fprintf(stderr, "section %d (%s): %zu bytes\n", sectionId,
+                ic != NULL ? ic->name : "unknown", data.size());
+
+        if (!write_varint(STDOUT_FILENO, (uint64_t(sectionId) << 3) | 2)
+                || !write_varint(STDOUT_FILENO, data.size())
+                || !write_all(STDOUT_FILENO, data.data(), data.size())) {
+            fprintf(stderr, "error writing section %d to stdout: %s\n", sectionId,
+                    strerror(errno));
+            return 1;
+        }
+    }
+
+    if (err != NOT_ENOUGH_DATA) {
+        fprintf(stderr, "malformed incident report stream: %d\n", err);
+        return 1;
+    }
+    return 0;
+}
+
 // ================================================================================
 static void
 usage(FILE* out)
@@ -211,6 +288,7 @@ usage(FILE* out)
     fprintf(out, "\n");
     fprintf(out, "and one of these destinations:\n");
     fprintf(out, "  -b           (default) print the report to stdout (in proto format)\n");
+    fprintf(out, "  -S           like -b, but announce each section on stderr as it completes\n");
     fprintf(out, "  -d           send the report into dropbox\n");
     fprintf(out, "  -r REASON    human readable description of why the report is taken.\n");
     fprintf(out, "  -s PKG/CLS   send broadcast to the broadcast receiver.\n");
@@ -226,12 +304,13 @@ main(int argc, char** argv)
     IncidentReportArgs args;
     enum { DEST_UNSET, DEST_DROPBOX, DEST_STDOUT, DEST_BROADCAST } destination = DEST_UNSET;
     int privacyPolicy = PRIVACY_POLICY_AUTOMATIC;
+    bool sectioned = false;
     string reason;
     string receiverArg;
 
     // Parse the args
     int opt;
-    while ((opt = getopt(argc, argv, "bhdlp:r:s:")) != -1) {
+    while ((opt = getopt(argc, argv, "bhdlp:r:s:S")) != -1) {
         switch (opt) {
             case 'h':
                 usage(stdout);
@@ -246,6 +325,14 @@ main(int argc, char** argv)
                 }
                 destination = DEST_STDOUT;
                 break;
+            case 'S':
+                if (!(destination == DEST_UNSET || destination == DEST_STDOUT)) {
+                    usage(stderr);
+                    return 1;
+                }
+                destination = DEST_STDOUT;
+                sectioned = true;
+                break;
             case 'd':
                 if (!(destination == DEST_UNSET || destination == DEST_DROPBOX)) {
                     usage(stderr);
@@ -356,6 +443,10 @@ main(int argc, char** argv)
         // Wait for the result and print out the data they send.
         //IPCThreadState::self()->joinThreadPool();
 
+        if (sectioned) {
+            return stream_sections(fds[0]);
+        }
+
         while (true) {
             uint8_t buf[4096];
             ssize_t amt = TEMP_FAILURE_RETRY(read(fds[0], buf, sizeof(buf)));
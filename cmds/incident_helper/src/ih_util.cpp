@@ -30,25 +30,30 @@ bool isValidChar(char c) {
         || (v == (uint8_t)'_');
 }
 
-std::string trim(const std::string& s, const std::string& charset) {
+// Trim as a view into the caller's buffer, without copying the text.
+static std::string_view trimView(std::string_view s, std::string_view charset) {
     const auto head = s.find_first_not_of(charset);
-    if (head == std::string::npos) return "";
+    if (head == std::string_view::npos) return s.substr(0, 0);
 
     const auto tail = s.find_last_not_of(charset);
     return s.substr(head, tail - head + 1);
 }
 
+std::string trim(std::string_view s, const std::string& charset) {
+    return std::string(trimView(s, charset));
+}
+
 static inline std::string toLowerStr(const std::string& s) {
     std::string res(s);
     std::transform(res.begin(), res.end(), res.begin(), ::tolower);
     return res;
 }
 
-static inline std::string trimDefault(const std::string& s) {
+static inline std::string trimDefault(std::string_view s) {
     return trim(s, DEFAULT_WHITESPACE);
 }
 
-static inline std::string trimHeader(const std::string& s) {
+static inline std::string trimHeader(std::string_view s) {
     return toLowerStr(trimDefault(s));
 }
 
@@ -59,7 +64,7 @@ static inline bool isNumber(const std::string& s) {
 }
 
 // This is similiar to Split in android-base/file.h, but it won't add empty string
-static void split(const std::string& line, std::vector<std::string>& words,
+static void split(std::string_view line, std::vector<std::string>& words,
         const trans_func& func, const std::string& delimiters) {
     words.clear();  // clear the buffer before split
 
@@ -78,21 +83,21 @@ static void split(const std::string& line, std::vector<std::string>& words,
     }
 }
 
-header_t parseHeader(const std::string& line, const std::string& delimiters) {
+header_t parseHeader(std::string_view line, const std::string& delimiters) {
     header_t header;
     trans_func f = &trimHeader;
     split(line, header, f, delimiters);
     return header;
 }
 
-record_t parseRecord(const std::string& line, const std::string& delimiters) {
+record_t parseRecord(std::string_view line, const std::string& delimiters) {
     record_t record;
     trans_func f = &trimDefault;
     split(line, record, f, delimiters);
     return record;
 }
 
-bool getColumnIndices(std::vector<int>& indices, const char** headerNames, const std::string& line) {
+bool getColumnIndices(std::vector<int>& indices, const char** headerNames, std::string_view line) {
     indices.clear();
 
     size_t lastIndex = 0;
@@ -100,8 +105,8 @@ bool getColumnIndices(std::vector<int>& indices, const char** headerNames, const
     while (headerNames[i] != nullptr) {
         std::string s = headerNames[i];
         lastIndex = line.find(s, lastIndex);
-        if (lastIndex == std::string::npos) {
-            fprintf(stderr, "Bad Task Header: %s\n", line.c_str());
+        if (lastIndex == std::string_view::npos) {
+            fprintf(stderr, "Bad Task Header: %.*s\n", (int)line.size(), line.data());
             return false;
         }
         lastIndex += s.length();
@@ -112,7 +117,7 @@ bool getColumnIndices(std::vector<int>& indices, const char** headerNames, const
     return true;
 }
 
-record_t parseRecordByColumns(const std::string& line, const std::vector<int>& indices, const std::string& delimiters) {
+record_t parseRecordByColumns(std::string_view line, const std::vector<int>& indices, const std::string& delimiters) {
     record_t record;
     int lastIndex = 0;
     int lastBeginning = 0;
@@ -208,6 +213,27 @@ bool stripSuffix(std::string* line, const char* key, bool endAtDelimiter) {
     return true;
 }
 
+bool stripPrefix(std::string_view* line, const char* key, bool endAtDelimiter) {
+    const auto head = line->find_first_not_of(DEFAULT_WHITESPACE);
+    if (head == std::string_view::npos) return false;
+    int len = (int)line->length();
+    int i = 0;
+    int j = head;
+    while (key[i] != '\0') {
+        if (j >= len || key[i++] != (*line)[j++]) {
+            return false;
+        }
+    }
+
+    if (endAtDelimiter) {
+        // this means if the line only have prefix or no delimiter, we still return false.
+        if (j == len || isValidChar((*line)[j])) return false;
+    }
+
+    *line = trimView(line->substr(j), DEFAULT_WHITESPACE);
+    return true;
+}
+
 std::string behead(std::string* line, const char cut) {
     auto found = line->find_first_of(cut);
     if (found == std::string::npos) {
@@ -235,30 +261,44 @@ double toDouble(const std::string& s) {
 
 // ==============================================================================
 Reader::Reader(const int fd)
+        :mFd(fd),
+         mData(),
+         mPos(0),
+         mStatus("")
 {
-    mFile = fdopen(fd, "r");
-    mStatus = mFile == nullptr ? "Invalid fd " + std::to_string(fd) : "";
+    // Pull the whole stream in up front -- these are modest /proc-style dumps --
+    // so the parsers can tokenize it in place without a copy per line.
+    char buf[16384];
+    ssize_t amt;
+    while ((amt = TEMP_FAILURE_RETRY(read(fd, buf, sizeof(buf)))) > 0) {
+        mData.append(buf, amt);
+    }
+    if (amt < 0) {
+        mStatus = "Invalid fd " + std::to_string(fd);
+    }
 }
 
 Reader::~Reader()
 {
-    if (mFile != nullptr) fclose(mFile);
+    if (mFd >= 0) close(mFd);
+}
+
+bool Reader::nextLine(std::string_view* line) {
+    if (!mStatus.empty() || mPos >= mData.size()) return false;
+
+    size_t end = mData.find('\n', mPos);
+    if (end == std::string::npos) end = mData.size();
+    std::string_view s(mData.data() + mPos, end - mPos);
+    mPos = end + 1;
+    *line = trimView(s, DEFAULT_NEWLINE);
+    return true;
 }
 
 bool Reader::readLine(std::string* line) {
-    if (mFile == nullptr) return false;
-
-    char* buf = nullptr;
-    size_t len = 0;
-    ssize_t read = getline(&buf, &len, mFile);
-    if (read != -1) {
-        std::string s(buf);
-        line->assign(trim(s, DEFAULT_NEWLINE));
-    } else if (errno == EINVAL) {
-        mStatus = "Bad Argument";
-    }
-    free(buf);
-    return read != -1;
+    std::string_view s;
+    if (!nextLine(&s)) return false;
+    line->assign(s.data(), s.size());
+    return true;
 }
 
 bool Reader::ok(std::string* error) {
@@ -20,6 +20,7 @@
 #include <map>
 #include <stack>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <android/util/ProtoOutputStream.h>
@@ -28,7 +29,7 @@ using namespace android::util;
 
 typedef std::vector<std::string> header_t;
 typedef std::vector<std::string> record_t;
-typedef std::string (*trans_func) (const std::string&);
+typedef std::string (*trans_func) (std::string_view);
 
 const std::string DEFAULT_WHITESPACE = " \t";
 const std::string DEFAULT_NEWLINE = "\r\n";
@@ -41,7 +42,7 @@ const std::string PARENTHESES_DELIMITER = "()";
 bool isValidChar(char c);
 
 // trim the string with the given charset
-std::string trim(const std::string& s, const std::string& charset);
+std::string trim(std::string_view s, const std::string& charset);
 
 /**
  * When a text has a table format like this
@@ -54,8 +55,8 @@ std::string trim(const std::string& s, const std::string& charset);
  * parseRecord is used to parse other lines and returns a list of strings
  * empty strings are skipped
  */
-header_t parseHeader(const std::string& line, const std::string& delimiters = DEFAULT_WHITESPACE);
-record_t parseRecord(const std::string& line, const std::string& delimiters = DEFAULT_WHITESPACE);
+header_t parseHeader(std::string_view line, const std::string& delimiters = DEFAULT_WHITESPACE);
+record_t parseRecord(std::string_view line, const std::string& delimiters = DEFAULT_WHITESPACE);
 
 /**
  * Gets the list of end indices of each word in the line and places it in the given vector,
@@ -63,14 +64,14 @@ record_t parseRecord(const std::string& line, const std::string& delimiters = DE
  * Will return false if there was a problem getting the indices. headerNames
  * must be NULL terminated.
  */
-bool getColumnIndices(std::vector<int>& indices, const char* headerNames[], const std::string& line);
+bool getColumnIndices(std::vector<int>& indices, const char* headerNames[], std::string_view line);
 
 /**
  * When a text-format table aligns by its vertical position, it is not possible to split them by purely delimiters.
  * This function allows to parse record by its header's column position' indices, must in ascending order.
  * At the same time, it still looks at the char at index, if it doesn't belong to delimiters, moves forward to find the delimiters.
  */
-record_t parseRecordByColumns(const std::string& line, const std::vector<int>& indices, const std::string& delimiters = DEFAULT_WHITESPACE);
+record_t parseRecordByColumns(std::string_view line, const std::vector<int>& indices, const std::string& delimiters = DEFAULT_WHITESPACE);
 
 /** Prints record_t to stderr */
 void printRecord(const record_t& record);
@@ -90,6 +91,9 @@ void printRecord(const record_t& record);
 bool stripPrefix(std::string* line, const char* key, bool endAtDelimiter = false);
 bool stripSuffix(std::string* line, const char* key, bool endAtDelimiter = false);
 
+// Same as stripPrefix above, but adjusts the span in place without copying.
+bool stripPrefix(std::string_view* line, const char* key, bool endAtDelimiter = false);
+
 /**
  * behead the given line by the cut, return the head and reassign the line to be the rest.
  */
@@ -103,8 +107,11 @@ long long toLongLong(const std::string& s);
 double toDouble(const std::string& s);
 
 /**
- * Reader class reads data from given fd in streaming fashion.
- * The buffer size is controlled by capacity parameter.
+ * Reader class reads the whole stream from the given fd up front into a single
+ * buffer and then tokenizes it in place.  nextLine yields a span of that buffer
+ * with no per-line allocation; the span stays valid until the Reader is
+ * destroyed.  readLine copies the line into the caller's string for parsers
+ * that still want one.
  */
 class Reader
 {
@@ -112,11 +119,14 @@ public:
     explicit Reader(const int fd);
     ~Reader();
 
+    bool nextLine(std::string_view* line);
     bool readLine(std::string* line);
     bool ok(std::string* error);
 
 private:
-    FILE* mFile;
+    int mFd;
+    std::string mData;
+    size_t mPos;
     std::string mStatus;
 };
 
@@ -24,7 +24,7 @@
 using namespace android::os;
 
 static void writeSuffixLine(ProtoOutputStream* proto, uint64_t fieldId,
-        const string& line, const string& delimiter,
+        std::string_view line, const string& delimiter,
         const int count, const char* names[], const uint64_t ids[])
 {
     record_t record = parseRecord(line, delimiter);
@@ -44,7 +44,8 @@ status_t
 CpuInfoParser::Parse(const int in, const int out) const
 {
     Reader reader(in);
-    string line;
+    std::string_view line;
+    string error;
     header_t header;
     vector<int> columnIndices; // task table can't be split by purely delimiter, needs column positions.
     record_t record;
@@ -60,8 +61,8 @@ CpuInfoParser::Parse(const int in, const int out) const
     table.addEnumTypeMap("pcy", CpuInfoProto::Task::_ENUM_POLICY_NAMES,
             CpuInfoProto::Task::_ENUM_POLICY_VALUES, CpuInfoProto::Task::_ENUM_POLICY_COUNT);
 
-    // parse line by line
-    while (reader.readLine(&line)) {
+    // parse line by line; lines are views into the reader's buffer
+    while (reader.nextLine(&line)) {
         if (line.empty()) continue;
 
         nline++;
@@ -130,11 +131,11 @@ CpuInfoParser::Parse(const int in, const int out) const
         record = parseRecordByColumns(line, columnIndices);
         diff = record.size() - header.size();
         if (diff < 0) {
-            fprintf(stderr, "[%s]Line %d has %d missing fields\n%s\n", this->name.string(), nline, -diff, line.c_str());
+            fprintf(stderr, "[%s]Line %d has %d missing fields\n%.*s\n", this->name.string(), nline, -diff, (int)line.size(), line.data());
             printRecord(record);
             continue;
         } else if (diff > 0) {
-            fprintf(stderr, "[%s]Line %d has %d extra fields\n%s\n", this->name.string(), nline, diff, line.c_str());
+            fprintf(stderr, "[%s]Line %d has %d extra fields\n%.*s\n", this->name.string(), nline, diff, (int)line.size(), line.data());
             printRecord(record);
             continue;
         }
@@ -149,8 +150,8 @@ CpuInfoParser::Parse(const int in, const int out) const
         proto.end(token);
     }
 
-    if (!reader.ok(&line)) {
-        fprintf(stderr, "Bad read from fd %d: %s\n", in, line.c_str());
+    if (!reader.ok(&error)) {
+        fprintf(stderr, "Bad read from fd %d: %s\n", in, error.c_str());
         return -1;
     }
 
@@ -25,7 +25,8 @@ using namespace android::os;
 
 status_t PsParser::Parse(const int in, const int out) const {
     Reader reader(in);
-    string line;
+    std::string_view line;
+    string error;
     header_t header;  // the header of /d/wakeup_sources
     vector<int> columnIndices; // task table can't be split by purely delimiter, needs column positions.
     record_t record;  // retain each record
@@ -41,8 +42,8 @@ status_t PsParser::Parse(const int in, const int out) const {
     const int sValues[] = {PsProto::Process::STATE_D, PsProto::Process::STATE_R, PsProto::Process::STATE_S, PsProto::Process::STATE_T, PsProto::Process::STATE_TRACING, PsProto::Process::STATE_X, PsProto::Process::STATE_Z};
     table.addEnumTypeMap("s", sNames, sValues, 7);
 
-    // Parse line by line
-    while (reader.readLine(&line)) {
+    // Parse line by line; lines are views into the reader's buffer.
+    while (reader.nextLine(&line)) {
         if (line.empty()) continue;
 
         if (nline++ == 0) {
@@ -61,12 +62,12 @@ status_t PsParser::Parse(const int in, const int out) const {
         diff = record.size() - header.size();
         if (diff < 0) {
             // TODO: log this to incident report!
-            fprintf(stderr, "[%s]Line %d has %d missing fields\n%s\n", this->name.string(), nline, -diff, line.c_str());
+            fprintf(stderr, "[%s]Line %d has %d missing fields\n%.*s\n", this->name.string(), nline, -diff, (int)line.size(), line.data());
             printRecord(record);
             continue;
         } else if (diff > 0) {
             // TODO: log this to incident report!
-            fprintf(stderr, "[%s]Line %d has %d extra fields\n%s\n", this->name.string(), nline, diff, line.c_str());
+            fprintf(stderr, "[%s]Line %d has %d extra fields\n%.*s\n", this->name.string(), nline, diff, (int)line.size(), line.data());
             printRecord(record);
             continue;
         }
@@ -81,8 +82,8 @@ status_t PsParser::Parse(const int in, const int out) const {
         proto.end(token);
     }
 
-    if (!reader.ok(&line)) {
-        fprintf(stderr, "Bad read from fd %d: %s\n", in, line.c_str());
+    if (!reader.ok(&error)) {
+        fprintf(stderr, "Bad read from fd %d: %s\n", in, error.c_str());
         return -1;
     }
 
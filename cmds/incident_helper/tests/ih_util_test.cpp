@@ -117,6 +117,20 @@ TEST(IhUtilTest, stripPrefix) {
     EXPECT_THAT(data4, StrEq("Swap: abc "));
 }
 
+TEST(IhUtilTest, stripPrefixView) {
+    string_view data1 = "Swap: abc ";
+    EXPECT_TRUE(stripPrefix(&data1, "Swap:"));
+    EXPECT_THAT(string(data1), StrEq("abc"));
+
+    string_view data2 = "Swap: abc ";
+    EXPECT_FALSE(stripPrefix(&data2, "Total:"));
+    EXPECT_THAT(string(data2), StrEq("Swap: abc "));
+
+    string_view data3 = "Swap: abc ";
+    EXPECT_FALSE(stripPrefix(&data3, "Swa", true));
+    EXPECT_THAT(string(data3), StrEq("Swap: abc "));
+}
+
 TEST(IhUtilTest, stripSuffix) {
     string data1 = " 243%abc";
     EXPECT_TRUE(stripSuffix(&data1, "abc"));
@@ -168,6 +182,24 @@ TEST(IhUtilTest, Reader) {
     ASSERT_TRUE(r.ok(&line));
 }
 
+TEST(IhUtilTest, ReaderNextLine) {
+    TemporaryFile tf;
+    ASSERT_NE(tf.fd, -1);
+    ASSERT_TRUE(WriteStringToFile("test string\r\nsecond\nooo", tf.path));
+
+    Reader r(tf.fd);
+    string_view line;
+    string error;
+    ASSERT_TRUE(r.nextLine(&line));
+    EXPECT_THAT(string(line), StrEq("test string"));
+    ASSERT_TRUE(r.nextLine(&line));
+    EXPECT_THAT(string(line), StrEq("second"));
+    ASSERT_TRUE(r.nextLine(&line));
+    EXPECT_THAT(string(line), StrEq("ooo"));
+    ASSERT_FALSE(r.nextLine(&line));
+    ASSERT_TRUE(r.ok(&error));
+}
+
 TEST(IhUtilTest, ReaderEmpty) {
     TemporaryFile tf;
     ASSERT_NE(tf.fd, -1);
@@ -34,7 +34,7 @@ const ssize_t BUFFER_SIZE = 16 * 1024;  // 16 KB
 const ssize_t MAX_BUFFER_COUNT = 6144;   // 96 MB max
 
 FdBuffer::FdBuffer()
-        :mBuffer(new EncodedBuffer(BUFFER_SIZE)),
+        :mBuffer(EncodedBuffer::obtain()),
          mStartTime(-1),
          mFinishTime(-1),
          mTimedOut(false),
@@ -42,6 +42,12 @@ FdBuffer::FdBuffer()
 }
 
 FdBuffer::~FdBuffer() {
+    // Sections run back to back, each through its own FdBuffer; hand the chunk
+    // chain back to the pool for the next one unless a reader handed out by
+    // data() is still holding the buffer.
+    if (mBuffer->getStrongCount() == 1) {
+        EncodedBuffer::recycle(mBuffer);
+    }
 }
 
 status_t FdBuffer::read(int fd, int64_t timeout) {
@@ -149,6 +155,11 @@ status_t FdBuffer::readProcessedDataInStream(int fd, unique_fd toFd, unique_fd f
     fcntl(toFd.get(), F_SETFL, fcntl(toFd.get(), F_GETFL, 0) | O_NONBLOCK);
     fcntl(fromFd.get(), F_SETFL, fcntl(fromFd.get(), F_GETFL, 0) | O_NONBLOCK);
 
+    // Prefer moving bytes from fd into the parser's pipe kernel-side; fall
+    // back to copying through the circular buffer below if the kernel refuses
+    // to splice this pair of fds.
+    bool useSplice = true;
+
     // A circular buffer holds data read from fd and writes to parsing process
     uint8_t cirBuf[BUFFER_SIZE];
     size_t cirSize = 0;
@@ -196,8 +207,26 @@ status_t FdBuffer::readProcessedDataInStream(int fd, unique_fd toFd, unique_fd f
             }
         }
 
+        // relay from fd into the parsing process without a userspace copy
+        if (useSplice && pfds[0].fd != -1 && pfds[1].fd != -1) {
+            ssize_t amt = TEMP_FAILURE_RETRY(splice(fd, NULL, toFd.get(), NULL, BUFFER_SIZE,
+                                                    SPLICE_F_MOVE | SPLICE_F_NONBLOCK));
+            if (amt < 0) {
+                if (errno == EINVAL || errno == ENOSYS) {
+                    VLOG("splice unsupported for fd %d, copying instead", fd);
+                    useSplice = false;
+                } else if (!(errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    VLOG("Fail to splice fd %d: %s", fd, strerror(errno));
+                    return -errno;
+                }  // otherwise just continue
+            } else if (amt == 0) {
+                VLOG("Reached EOF of input file %d", fd);
+                pfds[0].fd = -1;  // reach EOF so don't have to poll pfds[0].
+            }
+        }
+
         // read from fd
-        if (cirSize != BUFFER_SIZE && pfds[0].fd != -1) {
+        if (!useSplice && cirSize != BUFFER_SIZE && pfds[0].fd != -1) {
             ssize_t amt;
             if (rpos >= wpos) {
                 amt = TEMP_FAILURE_RETRY(::read(fd, cirBuf + rpos, BUFFER_SIZE - rpos));
@@ -29,17 +29,20 @@
 #include <android/util/ProtoFileReader.h>
 #include <log/log.h>
 
+#include <memory>
+
 namespace android {
 namespace os {
 namespace incidentd {
 
 // ================================================================================
 /**
- * Write the field to buf based on the wire type, iterator will point to next field.
- * If skip is set to true, no data will be written to buf. Return number of bytes written.
+ * Write the field to every stream in outs based on the wire type, reading the
+ * input exactly once; the iterator will point to the next field afterwards.
+ * An empty outs skips the field.
  */
-void write_field_or_skip(ProtoOutputStream* out, const sp<ProtoReader>& in,
-        uint32_t fieldTag, bool skip) {
+static void write_field_to_all(const vector<ProtoOutputStream*>& outs, const sp<ProtoReader>& in,
+        uint32_t fieldTag) {
     uint8_t wireType = read_wire_type(fieldTag);
     size_t bytesToWrite = 0;
     uint64_t varint = 0;
@@ -47,51 +50,90 @@ void write_field_or_skip(ProtoOutputStream* out, const sp<ProtoReader>& in,
     switch (wireType) {
         case WIRE_TYPE_VARINT:
             varint = in->readRawVarint();
-            if (!skip) {
+            for (ProtoOutputStream* out: outs) {
                 out->writeRawVarint(fieldTag);
                 out->writeRawVarint(varint);
             }
             return;
         case WIRE_TYPE_FIXED64:
-            if (!skip) {
+            for (ProtoOutputStream* out: outs) {
                 out->writeRawVarint(fieldTag);
             }
             bytesToWrite = 8;
             break;
         case WIRE_TYPE_LENGTH_DELIMITED:
             bytesToWrite = in->readRawVarint();
-            if (!skip) {
+            for (ProtoOutputStream* out: outs) {
                 out->writeLengthDelimitedHeader(read_field_id(fieldTag), bytesToWrite);
             }
             break;
         case WIRE_TYPE_FIXED32:
-            if (!skip) {
+            for (ProtoOutputStream* out: outs) {
                 out->writeRawVarint(fieldTag);
             }
             bytesToWrite = 4;
             break;
     }
-    if (skip) {
+    if (outs.empty()) {
         in->move(bytesToWrite);
     } else {
         for (size_t i = 0; i < bytesToWrite; i++) {
-            out->writeRawByte(in->next());
+            uint8_t val = in->next();
+            for (ProtoOutputStream* out: outs) {
+                out->writeRawByte(val);
+            }
         }
     }
 }
 
 /**
- * Strip next field based on its private policy and request spec, then stores data in buf.
- * Return NO_ERROR if succeeds, otherwise BAD_VALUE is returned to indicate bad data in
- * FdBuffer.
+ * Write the field to buf based on the wire type, iterator will point to next field.
+ * If skip is set to true, no data will be written to buf. Return number of bytes written.
+ */
+void write_field_or_skip(ProtoOutputStream* out, const sp<ProtoReader>& in,
+        uint32_t fieldTag, bool skip) {
+    vector<ProtoOutputStream*> outs;
+    if (!skip) {
+        outs.push_back(out);
+    }
+    write_field_to_all(outs, in, fieldTag);
+}
+
+/**
+ * One privacy level shared by at least one output fd.  The proto stream collects
+ * the fields that survive this level during the single strip pass over a section.
+ */
+struct StripLevel {
+    explicit StripLevel(uint8_t privacyPolicy)
+            :spec(privacyPolicy),
+             proto(),
+             passthrough(false) {}
+
+    PrivacySpec spec;
+    ProtoOutputStream proto;
+
+    // True if the incoming buffer is already filtered at least this far, so the
+    // raw bytes can be written out without walking the proto again.
+    bool passthrough;
+};
+
+/**
+ * Strip the next field into each of the levels, walking the input only once.
+ * Return NO_ERROR if it succeeds, otherwise BAD_VALUE is returned to indicate bad
+ * data in the FdBuffer.
+ *
+ * A field whose policy has no child overrides is uniform: each level either takes
+ * the raw bytes or skips them, and the bytes are read once for all levels.  Only
+ * message fields with overriding children are recursed into.
  *
- * The iterator must point to the head of a protobuf formatted field for successful operation.
- * After exit with NO_ERROR, iterator points to the next protobuf field's head.
+ * The iterator must point to the head of a protobuf formatted field for successful
+ * operation.  After exit with NO_ERROR, iterator points to the next protobuf
+ * field's head.
  *
  * depth is the depth of recursion, for debugging.
  */
-status_t strip_field(ProtoOutputStream* out, const sp<ProtoReader>& in,
-        const Privacy* parentPolicy, const PrivacySpec& spec, int depth) {
+static status_t strip_field_to_all(const vector<StripLevel*>& levels, const sp<ProtoReader>& in,
+        const Privacy* parentPolicy, int depth) {
     if (!in->hasNext() || parentPolicy == NULL) {
         return BAD_VALUE;
     }
@@ -100,18 +142,28 @@ status_t strip_field(ProtoOutputStream* out, const sp<ProtoReader>& in,
     const Privacy* policy = lookup(parentPolicy, fieldId);
 
     if (policy == NULL || policy->children == NULL) {
-        bool skip = !spec.CheckPremission(policy, parentPolicy->policy);
+        // The subtree's policy is uniform: decide keep or skip per level and
+        // copy the raw bytes through once.
+        vector<ProtoOutputStream*> outs;
+        for (StripLevel* level: levels) {
+            if (level->spec.CheckPremission(policy, parentPolicy->policy)) {
+                outs.push_back(&level->proto);
+            }
+        }
         // iterator will point to head of next field
-        size_t currentAt = in->bytesRead();
-        write_field_or_skip(out, in, fieldTag, skip);
+        write_field_to_all(outs, in, fieldTag);
         return NO_ERROR;
     }
     // current field is message type and its sub-fields have extra privacy policies
     uint32_t msgSize = in->readRawVarint();
     size_t start = in->bytesRead();
-    uint64_t token = out->start(encode_field_id(policy));
+    vector<uint64_t> tokens;
+    tokens.reserve(levels.size());
+    for (StripLevel* level: levels) {
+        tokens.push_back(level->proto.start(encode_field_id(policy)));
+    }
     while (in->bytesRead() - start != msgSize) {
-        status_t err = strip_field(out, in, policy, spec, depth + 1);
+        status_t err = strip_field_to_all(levels, in, policy, depth + 1);
         if (err != NO_ERROR) {
             ALOGW("Bad value when stripping id %d, wiretype %d, tag %#x, depth %d, size %d, "
                     "relative pos %zu, ", fieldId, read_wire_type(fieldTag), fieldTag, depth,
@@ -119,120 +171,25 @@ status_t strip_field(ProtoOutputStream* out, const sp<ProtoReader>& in,
             return err;
         }
     }
-    out->end(token);
-    return NO_ERROR;
-}
-
-// ================================================================================
-class FieldStripper {
-public:
-    FieldStripper(const Privacy* restrictions, const sp<ProtoReader>& data,
-            uint8_t bufferLevel);
-
-    /**
-     * Take the data that we have, and filter it down so that no fields
-     * are more sensitive than the given privacy policy.
-     */
-    status_t strip(uint8_t privacyPolicy);
-
-    /**
-     * At the current filter level, how many bytes of data there is.
-     */
-    ssize_t dataSize() const { return mSize; }
-
-    /**
-     * Write the data from the current filter level to the file descriptor.
-     */
-    status_t writeData(int fd);
-
-private:
-    /**
-     * The global set of field --> required privacy level mapping.
-     */
-    const Privacy* mRestrictions;
-
-    /**
-     * The current buffer.
-     */
-    sp<ProtoReader> mData;
-
-    /**
-     * The current size of the buffer inside mData.
-     */
-    ssize_t mSize;
-
-    /**
-     * The current privacy policy that the data is filtered to, as an optimization
-     * so we don't always re-filter data that has already been filtered.
-     */
-    uint8_t mCurrentLevel;
-
-};
-
-FieldStripper::FieldStripper(const Privacy* restrictions, const sp<ProtoReader>& data,
-            uint8_t bufferLevel)
-        :mRestrictions(restrictions),
-         mData(data),
-         mSize(data->size()),
-         mCurrentLevel(bufferLevel) {
-    if (mSize < 0) {
-        ALOGW("FieldStripper constructed with a ProtoReader that doesn't support size."
-                " Data will be missing.");
-    }
-}
-
-status_t FieldStripper::strip(const uint8_t privacyPolicy) {
-    // If the current strip level is less (fewer fields retained) than what's already in the
-    // buffer, then we can skip it.
-    if (mCurrentLevel < privacyPolicy) {
-        PrivacySpec spec(privacyPolicy);
-        ProtoOutputStream proto;
-
-        // Optimization when no strip happens.
-        if (mRestrictions == NULL || spec.RequireAll()) {
-            if (spec.CheckPremission(mRestrictions)) {
-                mSize = mData->size();
-            }
-            return NO_ERROR;
-        }
-
-        while (mData->hasNext()) {
-            status_t err = strip_field(&proto, mData, mRestrictions, spec, 0);
-            if (err != NO_ERROR) {
-                return err; // Error logged in strip_field.
-            }
-        }
-
-        if (mData->bytesRead() != mData->size()) {
-            ALOGW("Buffer corrupted: expect %zu bytes, read %zu bytes", mData->size(),
-                    mData->bytesRead());
-            return BAD_VALUE;
-        }
-
-        mData = proto.data();
-        mSize = proto.size();
-        mCurrentLevel = privacyPolicy;
+    for (size_t i = 0; i < levels.size(); i++) {
+        levels[i]->proto.end(tokens[i]);
     }
     return NO_ERROR;
 }
 
-status_t FieldStripper::writeData(int fd) {
-    status_t err = NO_ERROR;
-    sp<ProtoReader> reader = mData;
-    if (mData == nullptr) {
-        // There had been an error processing the data. We won't write anything,
-        // but we also won't return an error, because errors are fatal.
-        return NO_ERROR;
-    }
+/**
+ * Write everything the reader has left to the file descriptor.
+ */
+static status_t write_all_to_fd(int fd, const sp<ProtoReader>& reader) {
     while (reader->readBuffer() != NULL) {
-        err = WriteFully(fd, reader->readBuffer(), reader->currentToRead()) ? NO_ERROR : -errno;
+        status_t err = WriteFully(fd, reader->readBuffer(), reader->currentToRead())
+                ? NO_ERROR : -errno;
         reader->move(reader->currentToRead());
         if (err != NO_ERROR) return err;
     }
     return NO_ERROR;
 }
 
-
 // ================================================================================
 FilterFd::FilterFd(uint8_t privacyPolicy, int fd)
         :mPrivacyPolicy(privacyPolicy),
@@ -264,29 +221,62 @@ status_t PrivacyFilter::writeData(const FdBuffer& buffer, uint8_t bufferLevel,
         *maxSize = 0;
     }
 
-    // Order the writes by privacy filter, with increasing levels of filtration,k
-    // so we can do the filter once, and then write many times.
-    sort(mOutputs.begin(), mOutputs.end(),
-        [](const sp<FilterFd>& a, const sp<FilterFd>& b) -> bool { 
-            return a->getPrivacyPolicy() < b->getPrivacyPolicy();
-        });
-
-    uint8_t privacyPolicy = PRIVACY_POLICY_LOCAL; // a.k.a. no filtering
-    FieldStripper fieldStripper(mRestrictions, buffer.data()->read(), bufferLevel);
+    // Collapse the outputs into the distinct privacy levels requested, so each
+    // level is produced once no matter how many listeners asked for it.
+    vector<std::unique_ptr<StripLevel>> levels;
     for (const sp<FilterFd>& output: mOutputs) {
-        // Do another level of filtering if necessary
-        if (privacyPolicy != output->getPrivacyPolicy()) {
-            privacyPolicy = output->getPrivacyPolicy();
-            err = fieldStripper.strip(privacyPolicy);
+        bool found = false;
+        for (const auto& level: levels) {
+            if (level->spec.getPolicy() == output->getPrivacyPolicy()) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            levels.emplace_back(new StripLevel(output->getPrivacyPolicy()));
+        }
+    }
+
+    // Levels the buffer has already been filtered to, and levels that would keep
+    // every field, reuse the raw bytes; the rest share one walk of the proto.
+    vector<StripLevel*> toStrip;
+    for (const auto& level: levels) {
+        if (mRestrictions == NULL || level->spec.getPolicy() <= bufferLevel
+                || level->spec.RequireAll()) {
+            level->passthrough = true;
+        } else {
+            toStrip.push_back(level.get());
+        }
+    }
+
+    if (!toStrip.empty()) {
+        sp<ProtoReader> reader = buffer.data()->read();
+        while (reader->hasNext()) {
+            err = strip_field_to_all(toStrip, reader, mRestrictions, 0);
             if (err != NO_ERROR) {
                 // We can't successfully strip this data.  We will skip
                 // the rest of this section.
                 return NO_ERROR;
             }
         }
+        if (reader->bytesRead() != reader->size()) {
+            ALOGW("Buffer corrupted: expect %zu bytes, read %zu bytes", reader->size(),
+                    reader->bytesRead());
+            return NO_ERROR;
+        }
+    }
 
-        // Write the resultant buffer to the fd, along with the header.
-        ssize_t dataSize = fieldStripper.dataSize();
+    for (const sp<FilterFd>& output: mOutputs) {
+        StripLevel* level = NULL;
+        for (const auto& candidate: levels) {
+            if (candidate->spec.getPolicy() == output->getPrivacyPolicy()) {
+                level = candidate.get();
+                break;
+            }
+        }
+
+        // Write the level's buffer to the fd, along with the header.
+        ssize_t dataSize = level->passthrough ? buffer.size() : level->proto.size();
         if (dataSize > 0) {
             err = write_section_header(output->getFd(), mSectionId, dataSize);
             if (err != NO_ERROR) {
@@ -294,7 +284,8 @@ status_t PrivacyFilter::writeData(const FdBuffer& buffer, uint8_t bufferLevel,
                 continue;
             }
 
-            err = fieldStripper.writeData(output->getFd());
+            err = write_all_to_fd(output->getFd(),
+                    level->passthrough ? buffer.data()->read() : level->proto.data());
             if (err != NO_ERROR) {
                 output->onWriteError(err);
                 continue;
@@ -336,7 +327,12 @@ void ReadbackFilterFd::onWriteError(status_t err) {
 status_t filter_and_write_report(int to, int from, uint8_t bufferLevel,
         const IncidentReportArgs& args) {
     status_t err;
-    sp<ProtoFileReader> reader = new ProtoFileReader(from);
+    // Map the report when possible so sections stream out of the page cache
+    // without a copy through a read buffer.
+    sp<ProtoReader> reader = ProtoFileMapReader::tryCreate(from);
+    if (reader == nullptr) {
+        reader = new ProtoFileReader(from);
+    }
 
     while (reader->hasNext()) {
         uint64_t fieldTag = reader->readRawVarint();
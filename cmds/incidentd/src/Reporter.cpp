@@ -38,12 +38,20 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <string>
+#include <thread>
 #include <time.h>
 
 namespace android {
 namespace os {
 namespace incidentd {
 
+/**
+ * How many sections may be collecting at the same time.  Sections mostly wait
+ * on dumpsys or file reads, so a small pool keeps a single wedged service from
+ * stalling the sections queued behind it without flooding the system with dumps.
+ */
+const size_t MAX_CONCURRENT_SECTIONS = 4;
+
 using namespace android::util;
 
 /**
@@ -338,7 +346,8 @@ void ReportBatch::removeRequest(const sp<ReportRequest>& request) {
 ReportWriter::ReportWriter(const sp<ReportBatch>& batch)
         :mBatch(batch),
          mPersistedFile(),
-         mMaxPersistedPrivacyPolicy(PRIVACY_POLICY_UNSET) {
+         mMaxPersistedPrivacyPolicy(PRIVACY_POLICY_UNSET),
+         mSectionLock(nullptr) {
 }
 
 ReportWriter::~ReportWriter() {
@@ -352,6 +361,10 @@ void ReportWriter::setMaxPersistedPrivacyPolicy(uint8_t privacyPolicy) {
     mMaxPersistedPrivacyPolicy = privacyPolicy;
 }
 
+void ReportWriter::setSectionLock(mutex* sectionLock) {
+    mSectionLock = sectionLock;
+}
+
 void ReportWriter::startSection(int sectionId) {
     mCurrentSectionId = sectionId;
     mSectionStartTimeMs = uptimeMillis();
@@ -447,6 +460,13 @@ void ReportWriter::vflog(const Section* section, status_t err, int level, const
 
 // Reads data from FdBuffer and writes it to the requests file descriptor.
 status_t ReportWriter::writeSection(const FdBuffer& buffer) {
+    // Sections collect concurrently, but their output to the shared fds, and
+    // the request list walked below, must not interleave.
+    unique_lock<mutex> lock;
+    if (mSectionLock != nullptr) {
+        lock = unique_lock<mutex>(*mSectionLock);
+    }
+
     PrivacyFilter filter(mCurrentSectionId, get_privacy_of_section(mCurrentSectionId));
 
     // Add the fd for the persisted requests
@@ -579,54 +599,8 @@ void Reporter::runReport(size_t* reportByteSize) {
 
     // For each of the report fields, see if we need it, and if so, execute the command
     // and report to those that care that we're doing it.
-    for (const Section** section = SECTION_LIST; *section; section++) {
-        const int sectionId = (*section)->id;
-
-        // If nobody wants this section, skip it.
-        if (!mBatch->containsSection(sectionId)) {
-            continue;
-        }
-
-        ALOGD("Start incident report section %d '%s'", sectionId, (*section)->name.string());
-        IncidentMetadata::SectionStats* sectionMetadata = metadata.add_sections();
-
-        // Notify listener of starting
-        mBatch->forEachListener(sectionId, [sectionId](const auto& listener) {
-            listener->onReportSectionStatus(
-                    sectionId, IIncidentReportStatusListener::STATUS_STARTING);
-        });
-
-        // Go get the data and write it into the file descriptors.
-        mWriter.startSection(sectionId);
-        err = (*section)->Execute(&mWriter);
-        mWriter.endSection(sectionMetadata);
-
-        // Sections returning errors are fatal. Most errors should not be fatal.
-        if (err != NO_ERROR) {
-            mWriter.error((*section), err, "Section failed. Stopping report.");
-            goto DONE;
-        }
-
-        // The returned max data size is used for throttling too many incident reports.
-        (*reportByteSize) += sectionMetadata->report_size_bytes();
-
-        // For any requests that failed during this section, remove them now.  We do this
-        // before calling back about section finished, so listeners do not erroniously get the
-        // impression that the section succeeded.  But we do it here instead of inside
-        // writeSection so that the callback is done from a known context and not from the
-        // bowels of a section, where changing the batch could cause odd errors.
-        cancel_and_remove_failed_requests();
+    err = runSections(&metadata, persistedPrivacyPolicy, reportByteSize);
 
-        // Notify listener of finishing
-        mBatch->forEachListener(sectionId, [sectionId](const auto& listener) {
-                listener->onReportSectionStatus(
-                        sectionId, IIncidentReportStatusListener::STATUS_FINISHED);
-        });
-
-        ALOGD("Finish incident report section %d '%s'", sectionId, (*section)->name.string());
-    }
-
-DONE:
     // Finish up the persisted file.
     if (mPersistedFile != nullptr) {
         mPersistedFile->closeDataFile();
@@ -681,6 +655,106 @@ DONE:
     ALOGI("Done taking incident report err=%s", strerror(-err));
 }
 
+// Run the sections that at least one request asked for, dispatching them to a
+// bounded pool of worker threads.  Each section still enforces its own timeout
+// from section_list.h, so a wedged service only costs its own deadline instead
+// of delaying every section queued behind it, and each section's data is
+// streamed to the requests as soon as it completes.  Returns the first fatal
+// section error, or NO_ERROR.
+status_t Reporter::runSections(IncidentMetadata* metadata, int persistedPrivacyPolicy,
+        size_t* reportByteSize) {
+    vector<const Section*> sections;
+    for (const Section** section = SECTION_LIST; *section; section++) {
+        // If nobody wants this section, skip it.
+        if (mBatch->containsSection((*section)->id)) {
+            sections.push_back(*section);
+        }
+    }
+    if (sections.empty()) {
+        return NO_ERROR;
+    }
+
+    // Guards everything except the data collection itself: writes to the
+    // request fds, changes to the batch, the metadata proto, and the shared
+    // bookkeeping below.
+    mutex lock;
+    size_t nextSection = 0;
+    status_t fatalErr = NO_ERROR;
+
+    const auto worker = [&]() {
+        unique_lock<mutex> guard(lock);
+        while (fatalErr == NO_ERROR && nextSection < sections.size()) {
+            const Section* section = sections[nextSection++];
+            const int sectionId = section->id;
+
+            ALOGD("Start incident report section %d '%s'", sectionId, section->name.string());
+            IncidentMetadata::SectionStats* sectionMetadata = metadata->add_sections();
+
+            // Notify listener of starting
+            mBatch->forEachListener(sectionId, [sectionId](const auto& listener) {
+                listener->onReportSectionStatus(
+                        sectionId, IIncidentReportStatusListener::STATUS_STARTING);
+            });
+
+            ReportWriter writer(mBatch);
+            writer.setPersistedFile(mPersistedFile);
+            writer.setMaxPersistedPrivacyPolicy(persistedPrivacyPolicy);
+            writer.setSectionLock(&lock);
+            writer.startSection(sectionId);
+
+            // Go get the data and write it into the file descriptors.  This is
+            // the slow part -- waiting on dumps -- and the only part that runs
+            // with the lock dropped; the writer re-takes it to fan the
+            // collected data out to the fds.
+            guard.unlock();
+            status_t sectionErr = section->Execute(&writer);
+            guard.lock();
+
+            writer.endSection(sectionMetadata);
+
+            // Sections returning errors are fatal. Most errors should not be fatal.
+            if (sectionErr != NO_ERROR) {
+                writer.error(section, sectionErr, "Section failed. Stopping report.");
+                if (fatalErr == NO_ERROR) {
+                    fatalErr = sectionErr;
+                }
+                continue;
+            }
+
+            // The returned max data size is used for throttling too many incident reports.
+            (*reportByteSize) += sectionMetadata->report_size_bytes();
+
+            // For any requests that failed during this section, remove them now.  We do this
+            // before calling back about section finished, so listeners do not erroniously get the
+            // impression that the section succeeded.  But we do it here instead of inside
+            // writeSection so that the callback is done from a known context and not from the
+            // bowels of a section, where changing the batch could cause odd errors.
+            cancel_and_remove_failed_requests();
+
+            // Notify listener of finishing
+            mBatch->forEachListener(sectionId, [sectionId](const auto& listener) {
+                    listener->onReportSectionStatus(
+                            sectionId, IIncidentReportStatusListener::STATUS_FINISHED);
+            });
+
+            ALOGD("Finish incident report section %d '%s'", sectionId, section->name.string());
+        }
+    };
+
+    vector<thread> extraWorkers;
+    const size_t threadCount =
+            sections.size() < MAX_CONCURRENT_SECTIONS ? sections.size() : MAX_CONCURRENT_SECTIONS;
+    for (size_t i = 1; i < threadCount; i++) {
+        extraWorkers.emplace_back(worker);
+    }
+    worker();  // this thread collects sections too, rather than just waiting
+    for (thread& t: extraWorkers) {
+        t.join();
+    }
+
+    return fatalErr;
+}
+
 void Reporter::cancel_and_remove_failed_requests() {
     // Handle a failure in the persisted file
     if (mPersistedFile != nullptr) {
@@ -25,6 +25,7 @@
 #include <android/util/protobuf.h>
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -189,6 +190,7 @@ public:
 
     void setPersistedFile(sp<ReportFile> file);
     void setMaxPersistedPrivacyPolicy(uint8_t privacyPolicy);
+    void setSectionLock(mutex* sectionLock);
 
     void startSection(int sectionId);
     void endSection(IncidentMetadata::SectionStats* sectionStats);
@@ -215,6 +217,12 @@ private:
      */
     uint8_t mMaxPersistedPrivacyPolicy;
 
+    /**
+     * Lock serializing section output to the request fds while sections are
+     * being collected concurrently.  Null when only one section can write.
+     */
+    mutex* mSectionLock;
+
     /**
      * The current section that is being written.
      */
@@ -264,6 +272,8 @@ private:
     sp<ReportBatch> mBatch;
     sp<ReportFile> mPersistedFile;
 
+    status_t runSections(IncidentMetadata* metadata, int persistedPrivacyPolicy,
+                         size_t* reportByteSize);
     void cancel_and_remove_failed_requests();
 };
 
@@ -60,6 +60,11 @@ static const string EXTENSION_ENVELOPE(".envelope");
  */
 static const string EXTENSION_DATA(".data");
 
+/**
+ * Name of the manifest file that indexes the directory contents.
+ */
+static const string FILENAME_MANIFEST("manifest");
+
 /**
  * Send these reports to dropbox.
  */
@@ -111,6 +116,13 @@ static string strip_extension(const string& filename) {
     return filename.substr(0, filename.find('.'));
 }
 
+// Zero pad the timestamp so it can also be alpha sorted.
+static string make_id_string(int64_t timestampNs) {
+    stringstream result;
+    result << setfill('0') << setw(20) << timestampNs;
+    return result.str();
+}
+
 static bool ends_with(const string& str, const string& ending) {
     if (str.length() >= ending.length()) {
         return str.compare(str.length()-ending.length(), ending.length(), ending) == 0;
@@ -215,26 +227,17 @@ void log_envelope(const ReportFileProto& envelope) {
 }
 
 // ================================================================================
-struct WorkDirectoryEntry {
-    WorkDirectoryEntry();
-    explicit WorkDirectoryEntry(const WorkDirectoryEntry& that);
-    ~WorkDirectoryEntry();
-
-    string envelope;
-    string data;
-    int64_t timestampNs;
-    off_t size;
-};
-
 WorkDirectoryEntry::WorkDirectoryEntry()
         :envelope(),
          data(),
+         timestampNs(0),
          size(0) {
 }
 
 WorkDirectoryEntry::WorkDirectoryEntry(const WorkDirectoryEntry& that)
         :envelope(that.envelope),
          data(that.data),
+         timestampNs(that.timestampNs),
          size(that.size) {
 }
 
@@ -498,15 +501,17 @@ status_t ReportFile::load_envelope_impl(bool cleanup) {
 WorkDirectory::WorkDirectory()
         :mDirectory("/data/misc/incidents"),
          mMaxFileCount(100),
-         mMaxDiskUsageBytes(100 * 1024 * 1024) {  // Incident reports can take up to 100MB on disk.
+         mMaxDiskUsageBytes(100 * 1024 * 1024),  // Incident reports can take up to 100MB on disk.
                                                  // TODO: Should be a flag.
+         mContentsLoaded(false) {
     create_directory(mDirectory.c_str());
 }
 
 WorkDirectory::WorkDirectory(const string& dir, int maxFileCount, long maxDiskUsageBytes)
         :mDirectory(dir),
          mMaxFileCount(maxFileCount),
-         mMaxDiskUsageBytes(maxDiskUsageBytes) {
+         mMaxDiskUsageBytes(maxDiskUsageBytes),
+         mContentsLoaded(false) {
     create_directory(mDirectory.c_str());
 }
 
@@ -520,11 +525,18 @@ sp<ReportFile> WorkDirectory::createReportFile() {
     string envelopeFileName = make_filename(timestampNs, EXTENSION_ENVELOPE);
     string dataFileName = make_filename(timestampNs, EXTENSION_DATA);
 
+    // Record the new report in the manifest before its files exist, so a crash
+    // in between leaves a prunable stale entry rather than an untracked file.
+    add_entry_locked(timestampNs);
+    save_manifest_locked();
+
     sp<ReportFile> result = new ReportFile(this, timestampNs, envelopeFileName, dataFileName);
 
     err = result->trySaveEnvelope();
     if (err != NO_ERROR) {
         ALOGW("Can't save envelope file %s: %s", strerror(-errno), envelopeFileName.c_str());
+        remove_entry_locked(timestampNs);
+        save_manifest_locked();
         return nullptr;
     }
 
@@ -645,6 +657,8 @@ void WorkDirectory::remove(const sp<ReportFile>& report) {
         unlink(report->getDataFileName().c_str());
         unlink(report->getEnvelopeFileName().c_str());
     }
+    remove_entry_locked(report->getTimestampNs());
+    save_manifest_locked();
 }
 
 int64_t WorkDirectory::make_timestamp_ns_locked() {
@@ -674,93 +688,143 @@ int64_t WorkDirectory::make_timestamp_ns_locked() {
  * our result is still correct for the caller.
  */
 bool WorkDirectory::file_exists_locked(int64_t timestampNs) {
+    load_contents_locked();
+    if (mContents.find(make_id_string(timestampNs)) != mContents.end()) {
+        return true;
+    }
+    // Also check the disk, in case something outside the manifest is squatting
+    // on the name.
     const string filename = make_filename(timestampNs, EXTENSION_ENVELOPE);
     struct stat st;
     return stat(filename.c_str(), &st) == 0;
 }
 
 string WorkDirectory::make_filename(int64_t timestampNs, const string& extension) {
-    // Zero pad the timestamp so it can also be alpha sorted.
-    stringstream result;
-    result << mDirectory << '/' << setfill('0') << setw(20) << timestampNs << extension;
-    return result.str();
+    return mDirectory + '/' + make_id_string(timestampNs) + extension;
 }
 
-off_t WorkDirectory::get_directory_contents_locked(map<string,WorkDirectoryEntry>* files,
-        int64_t after) {
+string WorkDirectory::make_manifest_filename() {
+    return mDirectory + '/' + FILENAME_MANIFEST;
+}
+
+void WorkDirectory::load_contents_locked() {
+    if (mContentsLoaded) {
+        return;
+    }
+    mContentsLoaded = true;
+
+    WorkDirectoryManifestProto manifest;
+    if (read_proto(&manifest, make_manifest_filename()) == NO_ERROR) {
+        const int count = manifest.report_timestamp_ns_size();
+        for (int i = 0; i < count; i++) {
+            add_entry_locked(manifest.report_timestamp_ns(i));
+        }
+        return;
+    }
+
+    // No manifest (first boot after an update, or it was corrupted).  Scan
+    // the directory the old way to rebuild it.  This is the expensive path
+    // the manifest exists to avoid, so save what we found right away.
     DIR* dir;
     struct dirent* entry;
 
     if ((dir = opendir(mDirectory.c_str())) == NULL) {
         ALOGE("Couldn't open incident directory: %s", mDirectory.c_str());
-        return -1;
+        return;
     }
 
-    string dirbase(mDirectory);
-    if (mDirectory[dirbase.size() - 1] != '/') dirbase += "/";
-
-    off_t totalSize = 0;
-
-    // Enumerate, count and add up size
     while ((entry = readdir(dir)) != NULL) {
         if (entry->d_name[0] == '.') {
             continue;
         }
         string entryname = entry->d_name;  // local to this dir
-        string filename = dirbase + entryname;  // fully qualified
-
-        bool isEnvelope = ends_with(entryname, EXTENSION_ENVELOPE);
-        bool isData = ends_with(entryname, EXTENSION_DATA);
-
-        // If the file isn't one of our files, just ignore it.  Otherwise,
-        // sum up the sizes.
-        if (isEnvelope || isData) {
-            string timestamp = strip_extension(entryname);
 
+        // If the file isn't one of our files, just ignore it.
+        if (ends_with(entryname, EXTENSION_ENVELOPE) || ends_with(entryname, EXTENSION_DATA)) {
             int64_t timestampNs;
-            if (!parse_timestamp_ns(timestamp, &timestampNs)) {
+            if (!parse_timestamp_ns(strip_extension(entryname), &timestampNs)) {
                 continue;
             }
-
-            if (after == 0 || timestampNs > after) {
-                struct stat st;
-                if (stat(filename.c_str(), &st) != 0) {
-                    ALOGE("Unable to stat file %s", filename.c_str());
-                    continue;
-                }
-                if (!S_ISREG(st.st_mode)) {
-                    continue;
-                }
-
-                WorkDirectoryEntry& entry = (*files)[timestamp];
-                if (isEnvelope) {
-                    entry.envelope = filename;
-                } else if (isData) {
-                    entry.data = filename;
-                }
-                entry.timestampNs = timestampNs;
-                entry.size += st.st_size;
-                totalSize += st.st_size;
-            }
+            add_entry_locked(timestampNs);
         }
     }
 
     closedir(dir);
 
-    // Now check if there are any data files that don't have envelope files.
-    // If there are, then just go ahead and delete them now.  Don't wait for
-    // a cleaning.
+    save_manifest_locked();
+}
 
-    if (DO_UNLINK) {
-        map<string,WorkDirectoryEntry>::iterator it = files->begin();
-        while (it != files->end()) {
-            if (it->second.envelope.length() == 0) {
-                unlink(it->second.data.c_str());
-                it = files->erase(it);
-            } else {
-                it++;
+void WorkDirectory::save_manifest_locked() {
+    WorkDirectoryManifestProto manifest;
+    for (map<string,WorkDirectoryEntry>::const_iterator it = mContents.begin();
+            it != mContents.end(); it++) {
+        manifest.add_report_timestamp_ns(it->second.timestampNs);
+    }
+
+    // Write to a temp file and rename, so a crash mid-write can't leave a
+    // half-written manifest; it either sees the old one or the new one.
+    const string filename = make_manifest_filename();
+    const string tempFilename = filename + ".tmp";
+    if (write_proto(manifest, tempFilename) != NO_ERROR
+            || rename(tempFilename.c_str(), filename.c_str()) != 0) {
+        ALOGW("Couldn't save work directory manifest %s", filename.c_str());
+        unlink(tempFilename.c_str());
+    }
+}
+
+void WorkDirectory::add_entry_locked(int64_t timestampNs) {
+    load_contents_locked();
+    WorkDirectoryEntry& entry = mContents[make_id_string(timestampNs)];
+    entry.envelope = make_filename(timestampNs, EXTENSION_ENVELOPE);
+    entry.data = make_filename(timestampNs, EXTENSION_DATA);
+    entry.timestampNs = timestampNs;
+    entry.size = 0;
+}
+
+void WorkDirectory::remove_entry_locked(int64_t timestampNs) {
+    mContents.erase(make_id_string(timestampNs));
+}
+
+off_t WorkDirectory::get_directory_contents_locked(map<string,WorkDirectoryEntry>* files,
+        int64_t after) {
+    load_contents_locked();
+
+    off_t totalSize = 0;
+    bool manifestDirty = false;
+    struct stat st;
+
+    map<string,WorkDirectoryEntry>::iterator it = mContents.begin();
+    while (it != mContents.end()) {
+        WorkDirectoryEntry& entry = it->second;
+
+        // The envelope is the file that keeps the report alive.  An entry
+        // whose envelope is gone is stale, left over from a crash between
+        // updating the manifest and the files; clean it up now.
+        if (stat(entry.envelope.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            if (DO_UNLINK) {
+                unlink(entry.data.c_str());
             }
+            it = mContents.erase(it);
+            manifestDirty = true;
+            continue;
         }
+        entry.size = st.st_size;
+
+        // The data file is written outside the lock, so its size is
+        // refreshed here instead of being tracked as it grows.
+        if (stat(entry.data.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+            entry.size += st.st_size;
+        }
+
+        if (after == 0 || entry.timestampNs > after) {
+            (*files)[it->first] = entry;
+            totalSize += entry.size;
+        }
+        it++;
+    }
+
+    if (manifestDirty) {
+        save_manifest_locked();
     }
 
     return totalSize;
@@ -787,15 +851,21 @@ void WorkDirectory::clean_directory_locked() {
 
     // Remove files until we're under our limits.
     if (DO_UNLINK) {
+        bool manifestDirty = false;
         for (map<string, WorkDirectoryEntry>::const_iterator it = files.begin();
                 it != files.end() && (totalSize >= mMaxDiskUsageBytes
                     || totalCount >= mMaxFileCount);
                 it++) {
             unlink(it->second.envelope.c_str());
             unlink(it->second.data.c_str());
+            remove_entry_locked(it->second.timestampNs);
+            manifestDirty = true;
             totalSize -= it->second.size;
             totalCount--;
         }
+        if (manifestDirty) {
+            save_manifest_locked();
+        }
     }
 }
 
@@ -806,6 +876,8 @@ void WorkDirectory::delete_files_for_report_if_necessary(const sp<ReportFile>& r
             unlink(report->getDataFileName().c_str());
             unlink(report->getEnvelopeFileName().c_str());
         }
+        remove_entry_locked(report->getTimestampNs());
+        save_manifest_locked();
     }
 }
 
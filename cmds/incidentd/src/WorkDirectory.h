@@ -23,6 +23,7 @@
 
 #include <utils/RefBase.h>
 
+#include <map>
 #include <mutex>
 #include <string>
 
@@ -37,7 +38,21 @@ using namespace std;
 extern const ComponentName DROPBOX_SENTINEL;
 
 class WorkDirectory;
-struct WorkDirectoryEntry;
+
+/**
+ * What we know about one report on disk: the two file names that back it,
+ * and the size they take up, refreshed when the entry is examined.
+ */
+struct WorkDirectoryEntry {
+    WorkDirectoryEntry();
+    explicit WorkDirectoryEntry(const WorkDirectoryEntry& that);
+    ~WorkDirectoryEntry();
+
+    string envelope;
+    string data;
+    int64_t timestampNs;
+    off_t size;
+};
 
 void get_args_from_report(IncidentReportArgs* out, const ReportFileProto_Report& report);
 
@@ -260,13 +275,25 @@ private:
     // the directory consistent.
     mutex mLock;
 
+    // The reports we know about, keyed by their zero-padded timestamp, loaded
+    // once from the manifest file (or by scanning the directory the first boot
+    // after the manifest was introduced), then kept in sync as reports come
+    // and go.  Queries walk this map instead of the directory.
+    bool mContentsLoaded;
+    map<string,WorkDirectoryEntry> mContents;
+
     int64_t make_timestamp_ns_locked();
-    bool file_exists_locked(int64_t timestampNs);    
+    bool file_exists_locked(int64_t timestampNs);
     off_t get_directory_contents_locked(map<string,WorkDirectoryEntry>* files, int64_t after);
     void clean_directory_locked();
     void delete_files_for_report_if_necessary(const sp<ReportFile>& report);
+    void load_contents_locked();
+    void save_manifest_locked();
+    void add_entry_locked(int64_t timestampNs);
+    void remove_entry_locked(int64_t timestampNs);
 
     string make_filename(int64_t timestampNs, const string& extension);
+    string make_manifest_filename();
 };
 
 
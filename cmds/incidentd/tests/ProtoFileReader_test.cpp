@@ -34,7 +34,7 @@ using ::testing::Test;
 const std::string kTestPath = GetExecutableDirectory();
 const std::string kTestDataPath = kTestPath + "/testdata/";
 
-status_t read(sp<ProtoFileReader> reader, size_t size) {
+status_t read(sp<ProtoReader> reader, size_t size) {
     uint8_t const* buf;
     while (size > 0 && (buf = reader->readBuffer()) != nullptr) {
         size_t amt = reader->currentToRead();
@@ -98,3 +98,60 @@ TEST(ProtoFileReaderTest, ParseOneLevel) {
     ASSERT_EQ(msg2Size, msg_size[1]);
     close(fd);
 }
+
+TEST(ProtoFileMapReaderTest, ParseOneLevel) {
+    const std::string testFile = kTestDataPath + "protoFileMapped.txt";
+    size_t msg1Size = 10;
+    size_t msg2Size = 5 * 1024;
+    {
+        unique_fd fd(open(testFile.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR));
+        ASSERT_NE(fd.get(), -1);
+        ProtoOutputStream proto;
+        string field1;
+        field1.resize(msg1Size, 'h');
+        string field2;
+        field2.resize(msg2Size, 'a');
+        proto.write(FIELD_TYPE_MESSAGE | 1, field1.data(), field1.length());
+        proto.write(FIELD_TYPE_MESSAGE | 2, field2.data(), field2.length());
+        proto.flush(fd);
+    }
+
+    int fd = open(testFile.c_str(), O_RDONLY | O_CLOEXEC);
+    ASSERT_NE(fd, -1);
+
+    status_t err;
+    sp<ProtoFileMapReader> reader = ProtoFileMapReader::tryCreate(fd);
+    ASSERT_NE(reader, nullptr);
+    int i = 0;
+    size_t msg_size[2];
+    while (reader->hasNext()) {
+        uint64_t fieldTag = reader->readRawVarint();
+        uint32_t fieldId = read_field_id(fieldTag);
+        uint8_t wireType = read_wire_type(fieldTag);
+        ASSERT_EQ(WIRE_TYPE_LENGTH_DELIMITED, wireType);
+        size_t sectionSize = reader->readRawVarint();
+        if (i < 2) {
+            msg_size[i] = sectionSize;
+        }
+        err = read(reader, sectionSize);
+        ASSERT_EQ(NO_ERROR, err);
+        i++;
+    }
+
+    ASSERT_EQ(2, i);
+
+    ASSERT_EQ(msg1Size, msg_size[0]);
+    ASSERT_EQ(msg2Size, msg_size[1]);
+    ASSERT_EQ((size_t)reader->size(), reader->bytesRead());
+    close(fd);
+}
+
+TEST(ProtoFileMapReaderTest, UnmappableFdFallsBack) {
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    // Pipes cannot be mapped; tryCreate must refuse so callers fall back to
+    // the buffered reader.
+    ASSERT_EQ(ProtoFileMapReader::tryCreate(fds[0]), nullptr);
+    close(fds[0]);
+    close(fds[1]);
+}
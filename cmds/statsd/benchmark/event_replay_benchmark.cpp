@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "logd/LogEvent.h"
+#include "metric_util.h"
+#include "stats_log_util.h"
+
+namespace android {
+namespace os {
+namespace statsd {
+
+using std::vector;
+
+// Replays a stream of raw events through a full StatsLogProcessor, exercising
+// matchers, conditions and metric producers together. By default the stream is
+// synthesized; point STATSD_REPLAY_TRACE at a file recorded on-device with
+// `adb shell cmd stats capture-events <path>` to replay production traffic.
+
+static const char EVENT_TYPE_LIST_STOP = '\n';
+static const char EVENT_TYPE_INT = 0;
+static const char EVENT_TYPE_LONG = 1;
+static const char EVENT_TYPE_LIST = 3;
+
+static const int kLogMsgHeaderSize = 28;
+
+// One record of the capture stream written by StatsLogProcessor:
+// payload length, logd timestamp, logging uid, then the raw payload.
+struct CapturedEvent {
+    int64_t timestampNs;
+    int32_t uid;
+    vector<uint8_t> payload;
+};
+
+static void write4Bytes(int val, vector<uint8_t>* buffer) {
+    buffer->push_back(static_cast<uint8_t>(val));
+    buffer->push_back(static_cast<uint8_t>((val >> 8) & 0xFF));
+    buffer->push_back(static_cast<uint8_t>((val >> 16) & 0xFF));
+    buffer->push_back(static_cast<uint8_t>((val >> 24) & 0xFF));
+}
+
+static void write8Bytes(int64_t val, vector<uint8_t>* buffer) {
+    write4Bytes(static_cast<int>(val & 0xFFFFFFFFLL), buffer);
+    write4Bytes(static_cast<int>((val >> 32) & 0xFFFFFFFFLL), buffer);
+}
+
+static bool readAll(int fd, void* data, size_t size) {
+    uint8_t* p = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t n = TEMP_FAILURE_RETRY(read(fd, p, size));
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool loadCapturedStream(const char* path, vector<CapturedEvent>* out) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    while (true) {
+        uint32_t len;
+        CapturedEvent event;
+        if (!readAll(fd, &len, sizeof(len))) {
+            break;  // Clean end of stream.
+        }
+        if (len > LOGGER_ENTRY_MAX_LEN ||
+            !readAll(fd, &event.timestampNs, sizeof(event.timestampNs)) ||
+            !readAll(fd, &event.uid, sizeof(event.uid))) {
+            close(fd);
+            return false;
+        }
+        event.payload.resize(len);
+        if (!readAll(fd, event.payload.data(), len)) {
+            close(fd);
+            return false;
+        }
+        out->push_back(std::move(event));
+    }
+    close(fd);
+    return !out->empty();
+}
+
+// A synthetic stand-in for captured traffic: screen on/off events at 10ms
+// spacing, in the same raw encoding logd would deliver.
+static void synthesizeStream(size_t count, vector<CapturedEvent>* out) {
+    for (size_t i = 0; i < count; i++) {
+        CapturedEvent event;
+        event.timestampNs = (int64_t)(i + 1) * 10000000LL;
+        event.uid = 1000;  // AID_SYSTEM
+        event.payload.push_back(EVENT_TYPE_LIST);
+        event.payload.push_back(3);  // field count
+        event.payload.push_back(EVENT_TYPE_LONG);
+        write8Bytes(event.timestampNs, &event.payload);
+        event.payload.push_back(EVENT_TYPE_INT);
+        write4Bytes(android::util::SCREEN_STATE_CHANGED, &event.payload);
+        event.payload.push_back(EVENT_TYPE_INT);
+        write4Bytes((i & 1) ? android::view::DisplayStateEnum::DISPLAY_STATE_OFF
+                            : android::view::DisplayStateEnum::DISPLAY_STATE_ON,
+                    &event.payload);
+        event.payload.push_back(EVENT_TYPE_LIST_STOP);
+        out->push_back(std::move(event));
+    }
+}
+
+static void getEventStream(vector<CapturedEvent>* out) {
+    const char* path = getenv("STATSD_REPLAY_TRACE");
+    if (path != nullptr && loadCapturedStream(path, out)) {
+        return;
+    }
+    out->clear();
+    synthesizeStream(1000, out);
+}
+
+static void toLogMsg(const CapturedEvent& event, log_msg* msg) {
+    msg->entry.hdr_size = kLogMsgHeaderSize;
+    msg->entry_v1.len = event.payload.size() + sizeof(uint32_t);
+    msg->entry_v1.sec = event.timestampNs / NS_PER_SEC;
+    msg->entry_v1.nsec = event.timestampNs % NS_PER_SEC;
+    msg->entry_v4.uid = event.uid;
+    // The first word after the header is the log tag, which LogEvent skips.
+    vector<uint8_t> tag;
+    write4Bytes(1937006964, &tag);
+    std::copy(tag.begin(), tag.end(), msg->buf + kLogMsgHeaderSize);
+    std::copy(event.payload.begin(), event.payload.end(),
+              msg->buf + kLogMsgHeaderSize + sizeof(uint32_t));
+}
+
+static StatsdConfig CreateReplayConfig() {
+    StatsdConfig config;
+    *config.add_atom_matcher() = CreateScreenTurnedOnAtomMatcher();
+    *config.add_atom_matcher() = CreateScreenTurnedOffAtomMatcher();
+    *config.add_atom_matcher() =
+            CreateSimpleAtomMatcher("ScreenStateChanged", android::util::SCREEN_STATE_CHANGED);
+    *config.add_predicate() = CreateScreenIsOffPredicate();
+
+    auto countMetric = config.add_count_metric();
+    countMetric->set_id(StringToId("ScreenStateCount"));
+    countMetric->set_what(config.atom_matcher(2).id());
+    countMetric->set_bucket(FIVE_MINUTES);
+
+    auto durationMetric = config.add_duration_metric();
+    durationMetric->set_id(StringToId("ScreenOffDuration"));
+    durationMetric->set_what(config.predicate(0).id());
+    durationMetric->set_aggregation_type(DurationMetric::SUM);
+    durationMetric->set_bucket(FIVE_MINUTES);
+    return config;
+}
+
+static void BM_ReplayEventStream(benchmark::State& state) {
+    vector<CapturedEvent> events;
+    getEventStream(&events);
+
+    ConfigKey cfgKey(0, 12345);
+    // Anchor the config before the stream so replayed timestamps fall inside
+    // the processor's buckets rather than triggering constant ttl churn.
+    const long timeBaseSec = events[0].timestampNs / NS_PER_SEC - 1;
+    sp<StatsLogProcessor> processor =
+            CreateStatsLogProcessor(timeBaseSec, CreateReplayConfig(), cfgKey);
+
+    while (state.KeepRunning()) {
+        for (const auto& captured : events) {
+            log_msg msg;
+            toLogMsg(captured, &msg);
+            LogEvent event(msg);
+            processor->OnLogEvent(&event);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_ReplayEventStream);
+
+static void BM_ReplayEventStreamParseOnly(benchmark::State& state) {
+    vector<CapturedEvent> events;
+    getEventStream(&events);
+
+    while (state.KeepRunning()) {
+        for (const auto& captured : events) {
+            log_msg msg;
+            toLogMsg(captured, &msg);
+            LogEvent event(msg);
+            benchmark::DoNotOptimize(event.getValues());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * events.size());
+}
+BENCHMARK(BM_ReplayEventStreamParseOnly);
+
+}  //  namespace statsd
+}  //  namespace os
+}  //  namespace android
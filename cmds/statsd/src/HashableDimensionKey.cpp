@@ -17,6 +17,7 @@
 #include "Log.h"
 
 #include <mutex>
+#include <unordered_map>
 
 #include "HashableDimensionKey.h"
 #include "FieldValue.h"
@@ -28,6 +29,35 @@ namespace statsd {
 using std::string;
 using std::vector;
 
+std::shared_ptr<const HashableDimensionKey> internDimension(const HashableDimensionKey& key) {
+    // Deliberately leaked: entries may still be released from static
+    // destructors (e.g. DEFAULT_METRIC_DIMENSION_KEY) at process exit.
+    static auto* table = new std::unordered_map<HashableDimensionKey,
+                                                std::weak_ptr<const HashableDimensionKey>>();
+    static auto* lock = new std::mutex();
+
+    std::lock_guard<std::mutex> guard(*lock);
+    auto it = table->find(key);
+    if (it != table->end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+    std::shared_ptr<const HashableDimensionKey> interned(
+            new HashableDimensionKey(key), [](const HashableDimensionKey* dropped) {
+                // The last reference is gone; evict the table entry unless the
+                // same contents were re-interned while this deleter was pending.
+                std::lock_guard<std::mutex> guard(*lock);
+                auto entry = table->find(*dropped);
+                if (entry != table->end() && entry->second.expired()) {
+                    table->erase(entry);
+                }
+                delete dropped;
+            });
+    (*table)[*interned] = interned;
+    return interned;
+}
+
 android::hash_t hashDimension(const HashableDimensionKey& value) {
     android::hash_t hash = 0;
     for (const auto& fieldValue : value.getValues()) {
@@ -174,22 +204,25 @@ string HashableDimensionKey::toString() const {
 }
 
 bool MetricDimensionKey::operator==(const MetricDimensionKey& that) const {
-    return mDimensionKeyInWhat == that.getDimensionKeyInWhat() &&
-           mDimensionKeyInCondition == that.getDimensionKeyInCondition();
+    // Interning guarantees pointer equality iff the contents are equal.
+    return mDimensionKeyInWhat == that.mDimensionKeyInWhat &&
+           mDimensionKeyInCondition == that.mDimensionKeyInCondition;
 };
 
 string MetricDimensionKey::toString() const {
-    return mDimensionKeyInWhat.toString() + mDimensionKeyInCondition.toString();
+    return mDimensionKeyInWhat->toString() + mDimensionKeyInCondition->toString();
 }
 
 bool MetricDimensionKey::operator<(const MetricDimensionKey& that) const {
-    if (mDimensionKeyInWhat < that.getDimensionKeyInWhat()) {
+    // Ordered containers still sort by contents, not by handle, so report
+    // ordering stays deterministic across runs.
+    if (*mDimensionKeyInWhat < that.getDimensionKeyInWhat()) {
         return true;
-    } else if (that.getDimensionKeyInWhat() < mDimensionKeyInWhat) {
+    } else if (that.getDimensionKeyInWhat() < *mDimensionKeyInWhat) {
         return false;
     }
 
-    return mDimensionKeyInCondition < that.getDimensionKeyInCondition();
+    return *mDimensionKeyInCondition < that.getDimensionKeyInCondition();
 }
 
 }  // namespace statsd
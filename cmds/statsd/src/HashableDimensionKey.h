@@ -17,6 +17,7 @@
 #pragma once
 
 #include <utils/JenkinsHash.h>
+#include <memory>
 #include <vector>
 #include "FieldValue.h"
 #include "android-base/stringprintf.h"
@@ -75,37 +76,58 @@ private:
     std::vector<FieldValue> mValues;
 };
 
+/**
+ * Returns the canonical shared instance for the given dimension contents.
+ *
+ * Dimension churn is a large allocation source: metric producers build the
+ * same dimension contents for every matched event and their bucket maps key
+ * on full copies. The intern table gives equal contents a single shared
+ * instance, so a MetricDimensionKey stores two pointers, copying one copies
+ * no FieldValues, and bucket lookups hash and compare the pointers instead
+ * of walking the vectors. Entries are refcounted: when the last key
+ * referencing a dimension is destroyed, its table entry is evicted.
+ */
+std::shared_ptr<const HashableDimensionKey> internDimension(const HashableDimensionKey& key);
+
 class MetricDimensionKey {
  public:
     explicit MetricDimensionKey(const HashableDimensionKey& dimensionKeyInWhat,
                                 const HashableDimensionKey& dimensionKeyInCondition)
-        : mDimensionKeyInWhat(dimensionKeyInWhat),
-          mDimensionKeyInCondition(dimensionKeyInCondition) {};
+        : mDimensionKeyInWhat(internDimension(dimensionKeyInWhat)),
+          mDimensionKeyInCondition(internDimension(dimensionKeyInCondition)) {};
 
-    MetricDimensionKey(){};
+    MetricDimensionKey() : MetricDimensionKey(HashableDimensionKey(), HashableDimensionKey()) {};
 
-    MetricDimensionKey(const MetricDimensionKey& that)
-        : mDimensionKeyInWhat(that.getDimensionKeyInWhat()),
-          mDimensionKeyInCondition(that.getDimensionKeyInCondition()) {};
+    MetricDimensionKey(const MetricDimensionKey& that) = default;
 
     MetricDimensionKey& operator=(const MetricDimensionKey& from) = default;
 
     std::string toString() const;
 
     inline const HashableDimensionKey& getDimensionKeyInWhat() const {
-        return mDimensionKeyInWhat;
+        return *mDimensionKeyInWhat;
     }
 
     inline const HashableDimensionKey& getDimensionKeyInCondition() const {
-        return mDimensionKeyInCondition;
+        return *mDimensionKeyInCondition;
     }
 
     inline void setDimensionKeyInCondition(const HashableDimensionKey& key) {
-        mDimensionKeyInCondition = key;
+        mDimensionKeyInCondition = internDimension(key);
     }
 
     bool hasDimensionKeyInCondition() const {
-        return mDimensionKeyInCondition.getValues().size() > 0;
+        return mDimensionKeyInCondition->getValues().size() > 0;
+    }
+
+    // The interned instances double as stable 64-bit handles: two keys carry
+    // the same handle iff their dimension contents are equal.
+    inline uintptr_t getWhatHandle() const {
+        return reinterpret_cast<uintptr_t>(mDimensionKeyInWhat.get());
+    }
+
+    inline uintptr_t getConditionHandle() const {
+        return reinterpret_cast<uintptr_t>(mDimensionKeyInCondition.get());
     }
 
     bool operator==(const MetricDimensionKey& that) const;
@@ -113,8 +135,8 @@ class MetricDimensionKey {
     bool operator<(const MetricDimensionKey& that) const;
 
   private:
-      HashableDimensionKey mDimensionKeyInWhat;
-      HashableDimensionKey mDimensionKeyInCondition;
+      std::shared_ptr<const HashableDimensionKey> mDimensionKeyInWhat;
+      std::shared_ptr<const HashableDimensionKey> mDimensionKeyInCondition;
 };
 
 android::hash_t hashDimension(const HashableDimensionKey& key);
@@ -164,8 +186,10 @@ struct hash<HashableDimensionKey> {
 template <>
 struct hash<MetricDimensionKey> {
     std::size_t operator()(const MetricDimensionKey& key) const {
-        android::hash_t hash = hashDimension(key.getDimensionKeyInWhat());
-        hash = android::JenkinsHashMix(hash, hashDimension(key.getDimensionKeyInCondition()));
+        // The handles are interned, so hashing them is equivalent to (and much
+        // cheaper than) hashing the dimension contents.
+        android::hash_t hash = android::hash_type((int64_t)key.getWhatHandle());
+        hash = android::JenkinsHashMix(hash, android::hash_type((int64_t)key.getConditionHandle()));
         return android::JenkinsHashWhiten(hash);
     }
 };
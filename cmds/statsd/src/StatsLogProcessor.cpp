@@ -20,6 +20,8 @@
 
 #include <android-base/file.h>
 #include <dirent.h>
+#include <string.h>
+#include <unistd.h>
 #include <frameworks/base/cmds/statsd/src/active_config_list.pb.h>
 #include "StatsLogProcessor.h"
 #include "android-base/stringprintf.h"
@@ -36,6 +38,7 @@
 
 using namespace android;
 using android::base::StringPrintf;
+using android::util::EncodedBuffer;
 using android::util::FIELD_COUNT_REPEATED;
 using android::util::FIELD_TYPE_BOOL;
 using android::util::FIELD_TYPE_FLOAT;
@@ -99,6 +102,38 @@ StatsLogProcessor::StatsLogProcessor(const sp<UidMap>& uidMap,
 }
 
 StatsLogProcessor::~StatsLogProcessor() {
+    if (mEventCaptureFd >= 0) {
+        close(mEventCaptureFd);
+    }
+}
+
+void StatsLogProcessor::setEventCaptureFd(int fd) {
+    std::lock_guard<std::mutex> lock(mMetricsMutex);
+    if (mEventCaptureFd >= 0) {
+        close(mEventCaptureFd);
+    }
+    mEventCaptureFd = fd < 0 ? -1 : fd;
+}
+
+void StatsLogProcessor::captureEventLocked(const LogEvent& event) {
+    size_t rawLen = 0;
+    const uint8_t* raw = event.rawPayload(&rawLen);
+    if (raw == nullptr) {
+        // Not socket traffic (or already decoded); nothing replayable to record.
+        return;
+    }
+    // Record framing: payload length, logd timestamp, logging uid, raw payload.
+    const uint32_t len = static_cast<uint32_t>(rawLen);
+    const int64_t timestampNs = event.GetLogdTimestampNs();
+    const int32_t uid = static_cast<int32_t>(event.GetUid());
+    if (!android::base::WriteFully(mEventCaptureFd, &len, sizeof(len)) ||
+        !android::base::WriteFully(mEventCaptureFd, &timestampNs, sizeof(timestampNs)) ||
+        !android::base::WriteFully(mEventCaptureFd, &uid, sizeof(uid)) ||
+        !android::base::WriteFully(mEventCaptureFd, raw, rawLen)) {
+        ALOGW("Event capture write failed, stopping capture: %s", strerror(errno));
+        close(mEventCaptureFd);
+        mEventCaptureFd = -1;
+    }
 }
 
 static void flushProtoToBuffer(ProtoOutputStream& proto, vector<uint8_t>* outData) {
@@ -200,6 +235,10 @@ void StatsLogProcessor::resetConfigsLocked(const int64_t timestampNs) {
 void StatsLogProcessor::OnLogEvent(LogEvent* event) {
     std::lock_guard<std::mutex> lock(mMetricsMutex);
 
+    if (mEventCaptureFd >= 0) {
+        captureEventLocked(*event);
+    }
+
 #ifdef VERY_VERBOSE_PRINTING
     if (mPrintAllLogs) {
         ALOGI("%s", event->ToString().c_str());
@@ -306,17 +345,38 @@ void StatsLogProcessor::GetActiveConfigsLocked(const int uid, vector<int64_t>& o
 
 void StatsLogProcessor::OnConfigUpdated(const int64_t timestampNs, const ConfigKey& key,
                                         const StatsdConfig& config) {
-    std::lock_guard<std::mutex> lock(mMetricsMutex);
-    WriteDataToDiskLocked(key, timestampNs, CONFIG_UPDATED, NO_TIME_CONSTRAINTS);
-    OnConfigUpdatedLocked(timestampNs, key, config);
+    // Build the replacement manager before taking the lock: large configs take
+    // hundreds of milliseconds to construct, and events keep flowing into the
+    // old manager until the swap below.
+    sp<MetricsManager> newMetricsManager = buildMetricsManager(timestampNs, key, config);
+    sp<MetricsManager> oldMetricsManager;
+    {
+        std::lock_guard<std::mutex> lock(mMetricsMutex);
+        WriteDataToDiskLocked(key, timestampNs, CONFIG_UPDATED, NO_TIME_CONSTRAINTS);
+        oldMetricsManager = swapMetricsManagerLocked(timestampNs, key, newMetricsManager);
+    }
+    // The old manager's last reference dies here, so its teardown (matcher
+    // trees, puller receivers, alarms) is not paid under mMetricsMutex.
 }
 
 void StatsLogProcessor::OnConfigUpdatedLocked(
         const int64_t timestampNs, const ConfigKey& key, const StatsdConfig& config) {
+    sp<MetricsManager> newMetricsManager = buildMetricsManager(timestampNs, key, config);
+    swapMetricsManagerLocked(timestampNs, key, newMetricsManager);
+}
+
+sp<MetricsManager> StatsLogProcessor::buildMetricsManager(const int64_t timestampNs,
+                                                          const ConfigKey& key,
+                                                          const StatsdConfig& config) {
     VLOG("Updated configuration for key %s", key.ToString().c_str());
-    sp<MetricsManager> newMetricsManager =
-            new MetricsManager(key, config, mTimeBaseNs, timestampNs, mUidMap, mPullerManager,
-                               mAnomalyAlarmMonitor, mPeriodicAlarmMonitor);
+    return new MetricsManager(key, config, mTimeBaseNs, timestampNs, mUidMap, mPullerManager,
+                              mAnomalyAlarmMonitor, mPeriodicAlarmMonitor);
+}
+
+sp<MetricsManager> StatsLogProcessor::swapMetricsManagerLocked(
+        const int64_t timestampNs, const ConfigKey& key,
+        const sp<MetricsManager>& newMetricsManager) {
+    sp<MetricsManager> oldMetricsManager;
     if (newMetricsManager->isConfigValid()) {
         mUidMap->OnConfigUpdated(key);
         if (newMetricsManager->shouldAddUidMapListener()) {
@@ -325,12 +385,17 @@ void StatsLogProcessor::OnConfigUpdatedLocked(
             mUidMap->addListener(newMetricsManager.get());
         }
         newMetricsManager->refreshTtl(timestampNs);
+        auto it = mMetricsManagers.find(key);
+        if (it != mMetricsManagers.end()) {
+            oldMetricsManager = it->second;
+        }
         mMetricsManagers[key] = newMetricsManager;
         VLOG("StatsdConfig valid");
     } else {
         // If there is any error in the config, don't use it.
         ALOGE("StatsdConfig NOT valid");
     }
+    return oldMetricsManager;
 }
 
 size_t StatsLogProcessor::GetMetricsSize(const ConfigKey& key) const {
@@ -412,7 +477,8 @@ void StatsLogProcessor::onDumpReport(const ConfigKey& key, const int64_t dumpTim
                                      const DumpReportReason dumpReportReason,
                                      const DumpLatency dumpLatency,
                                      vector<uint8_t>* outData) {
-    ProtoOutputStream proto;
+    sp<EncodedBuffer> buffer = EncodedBuffer::obtain();
+    ProtoOutputStream proto(buffer);
     onDumpReport(key, dumpTimeStampNs, include_current_partial_bucket, erase_data,
                  dumpReportReason, dumpLatency, &proto);
 
@@ -422,6 +488,7 @@ void StatsLogProcessor::onDumpReport(const ConfigKey& key, const int64_t dumpTim
     }
 
     StatsdStats::getInstance().noteMetricsReportSent(key, proto.size());
+    EncodedBuffer::recycle(buffer);
 }
 
 /*
@@ -443,7 +510,8 @@ void StatsLogProcessor::onConfigMetricsReportLocked(
 
     std::set<string> str_set;
 
-    ProtoOutputStream tempProto;
+    sp<EncodedBuffer> tempBuffer = EncodedBuffer::obtain();
+    ProtoOutputStream tempProto(tempBuffer);
     // First, fill in ConfigMetricsReport using current data on memory, which
     // starts from filling in StatsLogReport's.
     it->second->onDumpReport(dumpTimeStampNs, include_current_partial_bucket, erase_data,
@@ -482,8 +550,9 @@ void StatsLogProcessor::onConfigMetricsReportLocked(
         VLOG("save history to disk");
         string file_name = StorageManager::getDataHistoryFileName((long)getWallClockSec(),
                                                                   key.GetUid(), key.GetId());
-        StorageManager::writeFile(file_name.c_str(), buffer->data(), buffer->size());
+        StorageManager::appendDataRecord(file_name.c_str(), buffer->data(), buffer->size());
     }
+    EncodedBuffer::recycle(tempBuffer);
 }
 
 void StatsLogProcessor::resetConfigsLocked(const int64_t timestampNs,
@@ -604,7 +673,7 @@ void StatsLogProcessor::WriteDataToDiskLocked(const ConfigKey& key,
                                 &buffer);
     string file_name =
             StorageManager::getDataFileName((long)getWallClockSec(), key.GetUid(), key.GetId());
-    StorageManager::writeFile(file_name.c_str(), buffer.data(), buffer.size());
+    StorageManager::appendDataRecord(file_name.c_str(), buffer.data(), buffer.size());
 
     // We were able to write the ConfigMetricsReport to disk, so we should trigger collection ASAP.
     mOnDiskDataConfigs.insert(key);
@@ -111,6 +111,10 @@ public:
 #endif
     }
 
+    /* Starts (fd >= 0) or stops (fd < 0) appending the raw payload of every incoming
+     * log event to the given fd, for offline replay. Takes ownership of the fd. */
+    void setEventCaptureFd(int fd);
+
     // Add a specific config key to the possible configs to dump ASAP.
     void noteOnDiskData(const ConfigKey& key);
 
@@ -147,11 +151,30 @@ private:
 
     sp<AlarmMonitor> mPeriodicAlarmMonitor;
 
+    // Destination for captured raw event payloads, or -1 when capture is off. Owned.
+    int mEventCaptureFd = -1;
+
+    // Appends the event's raw payload to mEventCaptureFd. Must run before anything
+    // materializes the event's values, while the raw payload is still retained.
+    void captureEventLocked(const LogEvent& event);
+
     void resetIfConfigTtlExpiredLocked(const int64_t timestampNs);
 
     void OnConfigUpdatedLocked(
         const int64_t currentTimestampNs, const ConfigKey& key, const StatsdConfig& config);
 
+    // Builds a MetricsManager for the config. Construction is the expensive part of a
+    // config update and only touches the new manager, so callers run it without holding
+    // mMetricsMutex to keep event intake flowing into the old manager meanwhile.
+    sp<MetricsManager> buildMetricsManager(const int64_t currentTimestampNs, const ConfigKey& key,
+                                           const StatsdConfig& config);
+
+    // Publishes an already-built manager under mMetricsMutex and returns the manager it
+    // replaced, so the caller can let the old one destruct outside the lock.
+    sp<MetricsManager> swapMetricsManagerLocked(const int64_t currentTimestampNs,
+                                                const ConfigKey& key,
+                                                const sp<MetricsManager>& newMetricsManager);
+
     void GetActiveConfigsLocked(const int uid, vector<int64_t>& outActiveConfigs);
 
     void WriteActiveConfigsToProtoOutputStreamLocked(
@@ -34,6 +34,8 @@
 #include <binder/PermissionController.h>
 #include <cutils/multiuser.h>
 #include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <frameworks/base/cmds/statsd/src/statsd_config.pb.h>
 #include <frameworks/base/cmds/statsd/src/uid_data.pb.h>
 #include <private/android_filesystem_config.h>
@@ -215,18 +217,24 @@ StatsService::~StatsService() {
 
 /* Runs on a dedicated thread to process pushed events. */
 void StatsService::readLogs() {
+    std::vector<std::unique_ptr<LogEvent>> events;
     // Read forever..... long live statsd
     while (1) {
-        // Block until an event is available.
-        auto event = mEventQueue->waitPop();
-        // Pass it to StatsLogProcess to all configs/metrics
-        // At this point, the LogEventQueue is not blocked, so that the socketListener
-        // can read events from the socket and write to buffer to avoid data drop.
-        mProcessor->OnLogEvent(event.get());
-        // The ShellSubscriber is only used by shell for local debugging.
-        if (mShellSubscriber != nullptr) {
-            mShellSubscriber->onLogEvent(*event);
+        // Block until events are available, then take the whole batch. The
+        // ring is drained in one go so a burst doesn't sit behind the
+        // per-event processing below.
+        mEventQueue->waitPopAll(&events);
+        for (const auto& event : events) {
+            // Pass it to StatsLogProcess to all configs/metrics
+            // At this point, the LogEventQueue is not blocked, so that the socketListener
+            // can read events from the socket and write to buffer to avoid data drop.
+            mProcessor->OnLogEvent(event.get());
+            // The ShellSubscriber is only used by shell for local debugging.
+            if (mShellSubscriber != nullptr) {
+                mShellSubscriber->onLogEvent(*event);
+            }
         }
+        events.clear();
     }
 }
 
@@ -409,6 +417,9 @@ status_t StatsService::command(int in, int out, int err, Vector<String8>& args,
         if (!args[0].compare(String8("print-logs"))) {
             return cmd_print_logs(out, args);
         }
+        if (!args[0].compare(String8("capture-events"))) {
+            return cmd_capture_events(out, args);
+        }
         if (!args[0].compare(String8("send-active-configs"))) {
             return cmd_trigger_active_config_broadcast(out, args);
         }
@@ -548,6 +559,11 @@ void StatsService::print_cmd_help(int out) {
     dprintf(out, "\n");
     dprintf(out, "usage: adb shell cmd stats print-logs\n");
     dprintf(out, "      Only works on eng build\n");
+    dprintf(out, "\n");
+    dprintf(out, "usage: adb shell cmd stats capture-events [PATH|stop]\n");
+    dprintf(out, "  Record the raw payload of every incoming event to PATH until\n");
+    dprintf(out, "  'capture-events stop' is issued. The file can be replayed against\n");
+    dprintf(out, "  arbitrary configs by the statsd benchmarks.\n");
 }
 
 status_t StatsService::cmd_trigger_broadcast(int out, Vector<String8>& args) {
@@ -938,6 +954,33 @@ status_t StatsService::cmd_print_logs(int out, const Vector<String8>& args) {
     }
 }
 
+status_t StatsService::cmd_capture_events(int out, const Vector<String8>& args) {
+    IPCThreadState* ipc = IPCThreadState::self();
+    VLOG("StatsService::cmd_capture_events with Pid %i, Uid %i", ipc->getCallingPid(),
+         ipc->getCallingUid());
+    if (!checkCallingPermission(String16(kPermissionDump))) {
+        return PERMISSION_DENIED;
+    }
+    if (args.size() < 2) {
+        print_cmd_help(out);
+        return UNKNOWN_ERROR;
+    }
+    if (!args[1].compare(String8("stop"))) {
+        mProcessor->setEventCaptureFd(-1);
+        dprintf(out, "Event capture stopped.\n");
+        return NO_ERROR;
+    }
+    int fd = open(args[1].c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        dprintf(out, "Could not open '%s' for capture: %s\n", args[1].c_str(), strerror(errno));
+        return UNKNOWN_ERROR;
+    }
+    mProcessor->setEventCaptureFd(fd);
+    dprintf(out, "Capturing events to %s. Use 'capture-events stop' to finish.\n",
+            args[1].c_str());
+    return NO_ERROR;
+}
+
 bool StatsService::getUidFromArgs(const Vector<String8>& args, size_t uidArgIndex, int32_t& uid) {
     return getUidFromString(args[uidArgIndex].c_str(), uid);
 }
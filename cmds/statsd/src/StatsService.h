@@ -369,6 +369,11 @@ private:
      */
     status_t cmd_print_logs(int outFd, const Vector<String8>& args);
 
+    /**
+     * Start or stop recording raw incoming events to a file for offline replay.
+     */
+    status_t cmd_capture_events(int outFd, const Vector<String8>& args);
+
     /**
      * Writes the value of args[uidArgIndex] into uid.
      * Returns whether the uid is reasonable (type uid_t) and whether
@@ -16,7 +16,7 @@
 
 #pragma once
 
-#include "anomaly/indexed_priority_queue.h"
+#include "anomaly/timing_wheel.h"
 
 #include <android/os/IStatsCompanionService.h>
 #include <utils/RefBase.h>
@@ -112,15 +112,17 @@ private:
     /**
      * Timestamp (seconds since epoch) of the alarm registered with
      * StatsCompanionService. This, in general, may not be equal to the soonest
-     * alarm stored in mPq, but should be within minUpdateTimeSec of it.
+     * alarm stored in mWheel, but should be within minUpdateTimeSec of it.
      * A value of 0 indicates that no alarm is currently registered.
      */
     uint32_t mRegisteredAlarmTimeSec;
 
     /**
-     * Priority queue of alarms, prioritized by soonest alarm.timestampSec.
+     * Timing wheel of pending alarms. Duration expiry deadlines, anomaly
+     * deadlines and periodic alarms all funnel into this; expiring a batch of
+     * due alarms doesn't depend on how many others are pending.
      */
-    indexed_priority_queue<InternalAlarm, InternalAlarm::SmallerTimestamp> mPq;
+    timing_wheel<InternalAlarm> mWheel;
 
     /**
      * Binder interface for communicating with StatsCompanionService.
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "anomaly/indexed_priority_queue.h"
+
+#include <utils/RefBase.h>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace android;
+
+namespace android {
+namespace os {
+namespace statsd {
+
+/**
+ * Hierarchical timing wheel for generic type AA, which must expose a
+ * [uint32_t timestampSec] member (seconds since epoch).
+ *
+ * Four levels of 256 slots cover the full 32-bit second range. Insertion and
+ * removal are O(1); advancing time expires whole slots at once and only
+ * touches occupied ones, so expiring n due entries costs O(n) regardless of
+ * how many other entries are pending. This replaces heap maintenance whose
+ * cost grows with the total entry count, which matters with tens of
+ * thousands of concurrent duration-tracking deadlines.
+ */
+template <class AA>
+class timing_wheel {
+public:
+    timing_wheel() : mNowSec(0), mSize(0) {
+        for (int level = 0; level < kLevels; level++) {
+            mLevelCount[level] = 0;
+        }
+    }
+
+    /** Adds a into the wheel. If already present or a==nullptr, does nothing. */
+    void push(sp<const AA> a) {
+        if (a == nullptr || mIndex.find(a) != mIndex.end()) {
+            return;
+        }
+        if (mSize == 0 && a->timestampSec > mNowSec + 1) {
+            // Nothing is pending, so re-anchor the wheel just before the new
+            // entry. This keeps advance loops proportional to real alarm
+            // spreads instead of the distance from the previous anchor.
+            mNowSec = a->timestampSec - 1;
+        }
+        if (a->timestampSec <= mNowSec) {
+            // Already due; handed out by the next popSoonerThan().
+            mOverdue.insert(a);
+            mIndex[a] = kOverdueLevel;
+        } else {
+            insertAhead(a);
+        }
+        mSize++;
+    }
+
+    /*
+     * Removes a from the wheel. If not present or a==nullptr, does nothing.
+     * Returns true if a had been present (and is now removed), else false.
+     */
+    bool remove(sp<const AA> a) {
+        if (a == nullptr) {
+            return false;
+        }
+        auto it = mIndex.find(a);
+        if (it == mIndex.end()) {
+            return false;
+        }
+        if (it->second == kOverdueLevel) {
+            mOverdue.erase(a);
+        } else {
+            mSlots[it->second][slotIndex(a->timestampSec, it->second)].erase(a);
+            mLevelCount[it->second]--;
+        }
+        mIndex.erase(it);
+        mSize--;
+        return true;
+    }
+
+    /** Returns whether the wheel contains a (not just a copy of a, but a itself). */
+    bool contains(sp<const AA> a) const {
+        return a != nullptr && mIndex.find(a) != mIndex.end();
+    }
+
+    /** Returns the entry with the soonest timestampSec. Returns nullptr iff empty(). */
+    sp<const AA> top() const {
+        sp<const AA> soonest = nullptr;
+        for (const auto& a : mOverdue) {
+            if (soonest == nullptr || a->timestampSec < soonest->timestampSec) {
+                soonest = a;
+            }
+        }
+        // Levels don't strictly partition the time axis (an entry keeps its
+        // insertion level as time advances), so take each level's first
+        // occupied slot ahead of now and compare the candidates.
+        for (int level = 0; level < kLevels; level++) {
+            if (mLevelCount[level] == 0) {
+                continue;
+            }
+            const size_t start = slotIndex(mNowSec, level);
+            for (size_t offset = 1; offset <= kSlotsPerLevel; offset++) {
+                const Slot& slot = mSlots[level][(start + offset) & (kSlotsPerLevel - 1)];
+                if (slot.empty()) {
+                    continue;
+                }
+                for (const auto& a : slot) {
+                    if (soonest == nullptr || a->timestampSec < soonest->timestampSec) {
+                        soonest = a;
+                    }
+                }
+                break;
+            }
+        }
+        return soonest;
+    }
+
+    /**
+     * Advances the wheel to the given time, moving every entry with
+     * timestamp <= timestampSec into *fired.
+     */
+    void popSoonerThan(uint32_t timestampSec,
+                       std::unordered_set<sp<const AA>, SpHash<AA>>* fired) {
+        for (auto it = mOverdue.begin(); it != mOverdue.end();) {
+            if ((*it)->timestampSec <= timestampSec) {
+                fired->insert(*it);
+                mIndex.erase(*it);
+                it = mOverdue.erase(it);
+                mSize--;
+            } else {
+                ++it;
+            }
+        }
+        while (mNowSec < timestampSec && mSize > 0) {
+            // With the lowest levels empty nothing can fire before the next
+            // cascade from the first occupied level, so skip the gap.
+            uint32_t skipTo = mNowSec;
+            for (int level = 0; level < kLevels && mLevelCount[level] == 0; level++) {
+                skipTo = mNowSec | ((1u << (kSlotBits * (level + 1))) - 1);
+            }
+            if (skipTo > mNowSec) {
+                mNowSec = skipTo < timestampSec ? skipTo : timestampSec;
+                if (mNowSec >= timestampSec) {
+                    break;
+                }
+            }
+            mNowSec++;
+            // On a slot boundary, pull the matching higher-level slots down,
+            // highest first so lower levels see freshly cascaded entries.
+            int topLevel = 0;
+            for (int level = 1; level < kLevels; level++) {
+                if ((mNowSec & ((1u << (kSlotBits * level)) - 1)) != 0) {
+                    break;
+                }
+                topLevel = level;
+            }
+            for (int level = topLevel; level >= 1; level--) {
+                cascade(level);
+            }
+            Slot& slot = mSlots[0][slotIndex(mNowSec, 0)];
+            for (const auto& a : slot) {
+                fired->insert(a);
+                mIndex.erase(a);
+                mSize--;
+            }
+            mLevelCount[0] -= slot.size();
+            slot.clear();
+        }
+        if (mNowSec < timestampSec) {
+            mNowSec = timestampSec;
+        }
+    }
+
+    /** Returns number of entries in the wheel. */
+    size_t size() const {
+        return mSize;
+    }
+
+    /** Returns true iff the wheel is empty. */
+    bool empty() const {
+        return mSize == 0;
+    }
+
+private:
+    static const int kLevels = 4;
+    static const int kSlotBits = 8;
+    static const size_t kSlotsPerLevel = 1 << kSlotBits;
+    static const int kOverdueLevel = -1;
+
+    using Slot = std::unordered_set<sp<const AA>, SpHash<AA>>;
+
+    static size_t slotIndex(uint32_t timestampSec, int level) {
+        return (timestampSec >> (kSlotBits * level)) & (kSlotsPerLevel - 1);
+    }
+
+    /** Files an entry with timestampSec > mNowSec into the level its delta fits. */
+    void insertAhead(sp<const AA> a) {
+        const uint32_t delta = a->timestampSec - mNowSec;
+        int level = 0;
+        while (level < kLevels - 1 && (delta >> (kSlotBits * (level + 1))) != 0) {
+            level++;
+        }
+        mSlots[level][slotIndex(a->timestampSec, level)].insert(a);
+        mIndex[a] = level;
+        mLevelCount[level]++;
+    }
+
+    /** Redistributes the given level's current slot into the levels below. */
+    void cascade(int level) {
+        Slot& slot = mSlots[level][slotIndex(mNowSec, level)];
+        if (slot.empty()) {
+            return;
+        }
+        mLevelCount[level] -= slot.size();
+        Slot moving;
+        moving.swap(slot);
+        for (const auto& a : moving) {
+            if (a->timestampSec <= mNowSec) {
+                // Due right at this boundary; expired by the caller's level-0
+                // sweep that follows the cascade.
+                mSlots[0][slotIndex(mNowSec, 0)].insert(a);
+                mIndex[a] = 0;
+                mLevelCount[0]++;
+            } else {
+                insertAhead(a);
+            }
+        }
+    }
+
+    /** Seconds the wheel has been advanced to; slots at or before it are spent. */
+    uint32_t mNowSec;
+
+    /** Total entries, including overdue ones. */
+    size_t mSize;
+
+    /** Slot rings, finest granularity (1s) first. */
+    Slot mSlots[kLevels][kSlotsPerLevel];
+
+    /** Occupancy per level, so advancing can skip empty stretches. */
+    size_t mLevelCount[kLevels];
+
+    /** Entries that were already due when pushed. */
+    Slot mOverdue;
+
+    /** Maps each entry to the level holding it (or kOverdueLevel). */
+    std::unordered_map<sp<const AA>, int, SpHash<AA>> mIndex;
+};
+
+}  // namespace statsd
+}  // namespace os
+}  // namespace android
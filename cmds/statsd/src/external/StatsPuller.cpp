@@ -46,8 +46,15 @@ bool StatsPuller::Pull(std::vector<std::shared_ptr<LogEvent>>* data) {
         if (mHasGoodData) {
             (*data) = mCachedData;
             StatsdStats::getInstance().notePullFromCache(mTagId);
+            return true;
         }
-        return mHasGoodData;
+        // A cache invalidated by a missed deadline keeps serving the last
+        // good data until the next real pull is allowed. A failed pull does
+        // not: failure means the source had nothing valid to report.
+        if (mLastPullTimedOut) {
+            return serveStaleDataLocked(elapsedTimeNs, data);
+        }
+        return false;
     }
 
     if (mLastPullTimeNs > 0) {
@@ -56,6 +63,7 @@ bool StatsPuller::Pull(std::vector<std::shared_ptr<LogEvent>>* data) {
     }
     mCachedData.clear();
     mLastPullTimeNs = elapsedTimeNs;
+    mLastPullTimedOut = false;
     mHasGoodData = PullInternal(&mCachedData);
     if (!mHasGoodData) {
         return mHasGoodData;
@@ -68,22 +76,41 @@ bool StatsPuller::Pull(std::vector<std::shared_ptr<LogEvent>>* data) {
         // Something went wrong. Discard the data.
         clearCacheLocked();
         mHasGoodData = false;
+        mLastPullTimedOut = true;
         StatsdStats::getInstance().notePullTimeout(mTagId);
         ALOGW("Pull for atom %d exceeds timeout %lld nano seconds.", mTagId,
               (long long)pullDurationNs);
-        return mHasGoodData;
+        return serveStaleDataLocked(elapsedTimeNs, data);
     }
 
     if (mCachedData.size() > 0) {
         mapAndMergeIsolatedUidsToHostUid(mCachedData, mUidMap, mTagId);
     }
 
+    mLastGoodData = mCachedData;
+    mLastGoodDataElapsedNs = elapsedTimeNs;
     (*data) = mCachedData;
     return mHasGoodData;
 }
 
+bool StatsPuller::serveStaleDataLocked(int64_t elapsedTimeNs,
+                                       std::vector<std::shared_ptr<LogEvent>>* data) {
+    if (mLastGoodData.empty() ||
+        elapsedTimeNs - mLastGoodDataElapsedNs >
+                StatsPullerManager::kAllPullAtomInfo.at(mTagId).staleDataWindowNs) {
+        return false;
+    }
+    (*data) = mLastGoodData;
+    StatsdStats::getInstance().notePullStaleDataServed(mTagId);
+    return true;
+}
+
 int StatsPuller::ForceClearCache() {
-    return clearCache();
+    lock_guard<std::mutex> lock(mLock);
+    mLastGoodData.clear();
+    mLastGoodDataElapsedNs = 0;
+    mLastPullTimedOut = false;
+    return clearCacheLocked();
 }
 
 int StatsPuller::clearCache() {
@@ -42,7 +42,10 @@ public:
     // Returns true if the pull was successful.
     // Returns false when
     //   1) the pull fails
-    //   2) pull takes longer than mPullTimeoutNs (intrinsic to puller)
+    //   2) pull takes longer than mPullTimeoutNs (intrinsic to puller) and no
+    //      recent good data exists to fall back on
+    // A pull that misses its deadline discards the slow data but serves the
+    // last successfully pulled data if it is within the atom's stale window.
     // If a metric wants to make any change to the data, like timestamps, it
     // should make a copy as this data may be shared with multiple metrics.
     bool Pull(std::vector<std::shared_ptr<LogEvent>>* data);
@@ -78,6 +81,21 @@ private:
     //   3) clearCache is called.
     std::vector<std::shared_ptr<LogEvent>> mCachedData;
 
+    // Snapshot of the last successful pull, kept past cache clears so a pull
+    // that misses its deadline can fall back on it. Only ForceClearCache
+    // drops it, since after a system restart the old values are meaningless.
+    std::vector<std::shared_ptr<LogEvent>> mLastGoodData;
+
+    int64_t mLastGoodDataElapsedNs = 0;
+
+    // Whether the cache is empty because the last pull missed its deadline,
+    // as opposed to the source failing outright.
+    bool mLastPullTimedOut = false;
+
+    // Serves mLastGoodData if it is within the atom's stale window.
+    bool serveStaleDataLocked(int64_t elapsedTimeNs,
+                              std::vector<std::shared_ptr<LogEvent>>* data);
+
     int clearCache();
 
     int clearCacheLocked();
@@ -23,6 +23,8 @@
 #include <math.h>
 #include <stdint.h>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include "../StatsService.h"
 #include "../logd/LogEvent.h"
 #include "../stats_log_util.h"
@@ -54,6 +56,11 @@ namespace statsd {
 // Values smaller than this may require to update the alarm.
 const int64_t NO_ALARM_UPDATE = INT64_MAX;
 
+// How many pulls may run concurrently when one alarm has several atoms due.
+// Pullers are independent of each other, so one slow HAL or binder call
+// should not delay the data delivery of every other atom.
+const size_t kMaxParallelPulls = 4;
+
 std::map<int, PullAtomInfo> StatsPullerManager::kAllPullAtomInfo = {
         // wifi_bytes_transfer
         {android::util::WIFI_BYTES_TRANSFER,
@@ -405,9 +412,36 @@ void StatsPullerManager::OnAlarmFired(int64_t elapsedTimeNs) {
         }
     }
 
-    for (const auto& pullInfo : needToPull) {
-        vector<shared_ptr<LogEvent>> data;
-        bool pullSuccess = Pull(pullInfo.first, &data);
+    // Run the due pulls concurrently on a small pool and join before
+    // delivering, so receivers still get their data on this thread in a
+    // deterministic order. Each puller enforces its own deadline and falls
+    // back to its last good data when the deadline is missed.
+    vector<vector<shared_ptr<LogEvent>>> pulledData(needToPull.size());
+    vector<uint8_t> pullResults(needToPull.size(), false);
+    if (needToPull.size() == 1) {
+        pullResults[0] = Pull(needToPull[0].first, &pulledData[0]);
+    } else if (needToPull.size() > 1) {
+        std::atomic_size_t nextPullIndex(0);
+        vector<std::thread> workers;
+        const size_t workerCount = std::min(needToPull.size(), kMaxParallelPulls);
+        for (size_t i = 0; i < workerCount; i++) {
+            workers.emplace_back([this, &needToPull, &pulledData, &pullResults, &nextPullIndex] {
+                for (size_t pullIndex = nextPullIndex.fetch_add(1);
+                     pullIndex < needToPull.size(); pullIndex = nextPullIndex.fetch_add(1)) {
+                    pullResults[pullIndex] =
+                            Pull(needToPull[pullIndex].first, &pulledData[pullIndex]);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    for (size_t i = 0; i < needToPull.size(); i++) {
+        const auto& pullInfo = needToPull[i];
+        vector<shared_ptr<LogEvent>>& data = pulledData[i];
+        bool pullSuccess = pullResults[i];
         if (pullSuccess) {
             StatsdStats::getInstance().notePullDelay(
                     pullInfo.first, getElapsedRealtimeNs() - elapsedTimeNs);
@@ -51,6 +51,11 @@ typedef struct {
     // The data is discarded if the pull takes longer than this and mHasGoodData
     // marked as false.
     int64_t pullTimeoutNs = StatsdStats::kPullMaxDelayNs;
+    // When a pull misses its deadline, the last successfully pulled data is
+    // served instead as long as it is no older than this. Data from a slow
+    // pull is still discarded; the fallback only keeps receivers fed with the
+    // last known good values.
+    int64_t staleDataWindowNs = 5 * 60 * (int64_t)NS_PER_SEC;
 } PullAtomInfo;
 
 class StatsPullerManager : public virtual RefBase {
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "HashableDimensionKey.h"
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace android {
+namespace os {
+namespace statsd {
+
+/**
+ * Open-addressing hash map from MetricDimensionKey to V for the per-bucket
+ * aggregation state of metric producers.
+ *
+ * MetricDimensionKey holds interned dimension handles, so hashing and
+ * comparing keys is pointer arithmetic; what remained expensive about
+ * std::unordered_map on the event intake path was the node allocation per
+ * insert and the pointer chase per lookup. Entries here live in one flat
+ * power-of-two array probed linearly, so a bucket update touches adjacent
+ * memory and inserting into a warm table allocates nothing.
+ *
+ * Deletion uses tombstones rather than entry shifting, which keeps the
+ * erase-while-iterating pattern of the producers valid: no live entry ever
+ * moves between erase() calls. Tombstones are reclaimed on the next rehash.
+ *
+ * Supports the subset of the std::unordered_map interface the metric
+ * producers use. Iteration order is the slot order of the table.
+ */
+template <class V>
+class flat_dim_map {
+public:
+    using value_type = std::pair<MetricDimensionKey, V>;
+
+private:
+    template <class MapT, class ValueT>
+    class iterator_base {
+    public:
+        iterator_base(MapT* map, size_t index) : mMap(map), mIndex(index) {
+        }
+
+        ValueT& operator*() const {
+            return mMap->entryAt(mIndex);
+        }
+
+        ValueT* operator->() const {
+            return &mMap->entryAt(mIndex);
+        }
+
+        iterator_base& operator++() {
+            mIndex = mMap->nextOccupied(mIndex + 1);
+            return *this;
+        }
+
+        iterator_base operator++(int) {
+            iterator_base prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const iterator_base& that) const {
+            return mIndex == that.mIndex;
+        }
+
+        bool operator!=(const iterator_base& that) const {
+            return mIndex != that.mIndex;
+        }
+
+    private:
+        MapT* mMap;
+        size_t mIndex;
+
+        friend class flat_dim_map;
+    };
+
+public:
+    using iterator = iterator_base<flat_dim_map, value_type>;
+    using const_iterator = iterator_base<const flat_dim_map, const value_type>;
+
+    flat_dim_map() = default;
+
+    flat_dim_map(const flat_dim_map& that) {
+        *this = that;
+    }
+
+    flat_dim_map(flat_dim_map&& that)
+        : mSlots(std::move(that.mSlots)),
+          mCapacity(that.mCapacity),
+          mSize(that.mSize),
+          mDeleted(that.mDeleted) {
+        that.mCapacity = 0;
+        that.mSize = 0;
+        that.mDeleted = 0;
+    }
+
+    flat_dim_map& operator=(const flat_dim_map& that) {
+        if (this == &that) {
+            return *this;
+        }
+        clear();
+        for (const auto& entry : that) {
+            insert(entry);
+        }
+        return *this;
+    }
+
+    flat_dim_map& operator=(flat_dim_map&& that) {
+        clear();
+        mSlots = std::move(that.mSlots);
+        mCapacity = that.mCapacity;
+        mSize = that.mSize;
+        mDeleted = that.mDeleted;
+        that.mCapacity = 0;
+        that.mSize = 0;
+        that.mDeleted = 0;
+        return *this;
+    }
+
+    ~flat_dim_map() {
+        clear();
+    }
+
+    iterator begin() {
+        return iterator(this, nextOccupied(0));
+    }
+
+    iterator end() {
+        return iterator(this, mCapacity);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, nextOccupied(0));
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, mCapacity);
+    }
+
+    size_t size() const {
+        return mSize;
+    }
+
+    bool empty() const {
+        return mSize == 0;
+    }
+
+    iterator find(const MetricDimensionKey& key) {
+        return iterator(this, indexOf(key));
+    }
+
+    const_iterator find(const MetricDimensionKey& key) const {
+        return const_iterator(this, indexOf(key));
+    }
+
+    size_t count(const MetricDimensionKey& key) const {
+        return indexOf(key) == mCapacity ? 0 : 1;
+    }
+
+    V& operator[](const MetricDimensionKey& key) {
+        size_t index = indexOf(key);
+        if (index == mCapacity) {
+            index = placeNew(value_type(key, V()));
+        }
+        return entryAt(index).second;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& entry) {
+        const size_t index = indexOf(entry.first);
+        if (index != mCapacity) {
+            return {iterator(this, index), false};
+        }
+        return {iterator(this, placeNew(value_type(entry))), true};
+    }
+
+    /** Erases the pointed-to entry and returns an iterator to the next one. */
+    iterator erase(iterator pos) {
+        entryAt(pos.mIndex).~value_type();
+        mSlots[pos.mIndex].state = kDeleted;
+        mSize--;
+        mDeleted++;
+        return iterator(this, nextOccupied(pos.mIndex + 1));
+    }
+
+    /** Removes all entries; keeps the current table allocation. */
+    void clear() {
+        for (size_t i = 0; i < mCapacity; i++) {
+            if (mSlots[i].state == kOccupied) {
+                entryAt(i).~value_type();
+            }
+            mSlots[i].state = kEmpty;
+        }
+        mSize = 0;
+        mDeleted = 0;
+    }
+
+private:
+    enum : uint8_t { kEmpty = 0, kDeleted = 1, kOccupied = 2 };
+
+    struct Slot {
+        uint8_t state;
+        typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type storage;
+    };
+
+    value_type& entryAt(size_t index) {
+        return *reinterpret_cast<value_type*>(&mSlots[index].storage);
+    }
+
+    const value_type& entryAt(size_t index) const {
+        return *reinterpret_cast<const value_type*>(&mSlots[index].storage);
+    }
+
+    size_t nextOccupied(size_t from) const {
+        while (from < mCapacity && mSlots[from].state != kOccupied) {
+            from++;
+        }
+        return from;
+    }
+
+    /** Returns the slot holding key, or mCapacity (== end()) if absent. */
+    size_t indexOf(const MetricDimensionKey& key) const {
+        if (mSize == 0) {
+            return mCapacity;
+        }
+        size_t index = std::hash<MetricDimensionKey>()(key) & (mCapacity - 1);
+        for (size_t probes = 0; probes < mCapacity; probes++) {
+            const Slot& slot = mSlots[index];
+            if (slot.state == kEmpty) {
+                return mCapacity;
+            }
+            if (slot.state == kOccupied && entryAt(index).first == key) {
+                return index;
+            }
+            index = (index + 1) & (mCapacity - 1);
+        }
+        return mCapacity;
+    }
+
+    /** Inserts an entry known to be absent; returns its slot. */
+    size_t placeNew(value_type&& entry) {
+        reserveForInsert();
+        size_t index = std::hash<MetricDimensionKey>()(entry.first) & (mCapacity - 1);
+        size_t target = mCapacity;
+        while (true) {
+            const uint8_t state = mSlots[index].state;
+            if (state == kEmpty) {
+                if (target == mCapacity) {
+                    target = index;
+                }
+                break;
+            }
+            if (state == kDeleted && target == mCapacity) {
+                // Keep probing to the cluster's end, but reuse the first
+                // tombstone on the way.
+                target = index;
+            }
+            index = (index + 1) & (mCapacity - 1);
+        }
+        Slot& slot = mSlots[target];
+        if (slot.state == kDeleted) {
+            mDeleted--;
+        }
+        new (&slot.storage) value_type(std::move(entry));
+        slot.state = kOccupied;
+        mSize++;
+        return target;
+    }
+
+    /** Grows (or purges tombstones from) the table before an insert if needed. */
+    void reserveForInsert() {
+        if (mCapacity == 0) {
+            rehash(kMinCapacity);
+        } else if ((mSize + mDeleted + 1) * 4 >= mCapacity * 3) {
+            // Double only if live entries drive the load; otherwise the same
+            // capacity with tombstones dropped is enough.
+            rehash((mSize + 1) * 4 >= mCapacity * 3 ? mCapacity * 2 : mCapacity);
+        }
+    }
+
+    void rehash(size_t newCapacity) {
+        std::unique_ptr<Slot[]> oldSlots = std::move(mSlots);
+        const size_t oldCapacity = mCapacity;
+        mSlots.reset(new Slot[newCapacity]());
+        mCapacity = newCapacity;
+        mSize = 0;
+        mDeleted = 0;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldSlots[i].state != kOccupied) {
+                continue;
+            }
+            value_type& entry = *reinterpret_cast<value_type*>(&oldSlots[i].storage);
+            size_t index = std::hash<MetricDimensionKey>()(entry.first) & (mCapacity - 1);
+            while (mSlots[index].state == kOccupied) {
+                index = (index + 1) & (mCapacity - 1);
+            }
+            new (&mSlots[index].storage) value_type(std::move(entry));
+            mSlots[index].state = kOccupied;
+            mSize++;
+            entry.~value_type();
+        }
+    }
+
+    static const size_t kMinCapacity = 16;
+
+    /** Slot array; power-of-two length, zero-initialized to kEmpty. */
+    std::unique_ptr<Slot[]> mSlots;
+    size_t mCapacity = 0;
+    size_t mSize = 0;
+    size_t mDeleted = 0;
+};
+
+}  // namespace statsd
+}  // namespace os
+}  // namespace android
@@ -41,6 +41,16 @@ using std::shared_ptr;
 using std::string;
 using std::vector;
 
+const int64_t StatsdStats::kPullTimeHistogramBucketBoundariesNs[] = {
+        1 * 1000000LL,     // 1ms
+        10 * 1000000LL,    // 10ms
+        50 * 1000000LL,    // 50ms
+        100 * 1000000LL,   // 100ms
+        500 * 1000000LL,   // 500ms
+        1000 * 1000000LL,  // 1s
+        5000 * 1000000LL,  // 5s
+};
+
 const int FIELD_ID_BEGIN_TIME = 1;
 const int FIELD_ID_END_TIME = 2;
 const int FIELD_ID_CONFIG_STATS = 3;
@@ -419,6 +429,12 @@ void StatsdStats::notePullTime(int pullAtomId, int64_t pullTimeNs) {
     pullStats.avgPullTimeNs = (pullStats.avgPullTimeNs * pullStats.numPullTime + pullTimeNs) /
                               (pullStats.numPullTime + 1);
     pullStats.numPullTime += 1;
+    size_t bucket = 0;
+    while (bucket < kNumPullTimeHistogramBuckets - 1 &&
+           pullTimeNs >= kPullTimeHistogramBucketBoundariesNs[bucket]) {
+        bucket++;
+    }
+    pullStats.pullTimeHistogram[bucket]++;
 }
 
 void StatsdStats::notePullDelay(int pullAtomId, int64_t pullDelayNs) {
@@ -446,6 +462,11 @@ void StatsdStats::notePullExceedMaxDelay(int pullAtomId) {
     mPulledAtomStats[pullAtomId].pullExceedMaxDelay++;
 }
 
+void StatsdStats::notePullStaleDataServed(int pullAtomId) {
+    lock_guard<std::mutex> lock(mLock);
+    mPulledAtomStats[pullAtomId].staleDataServed++;
+}
+
 void StatsdStats::noteAtomLogged(int atomId, int32_t timeSec) {
     lock_guard<std::mutex> lock(mLock);
 
@@ -605,6 +626,10 @@ void StatsdStats::resetInternalLocked() {
         pullStats.second.pullExceedMaxDelay = 0;
         pullStats.second.registeredCount = 0;
         pullStats.second.unregisteredCount = 0;
+        pullStats.second.staleDataServed = 0;
+        for (size_t i = 0; i < kNumPullTimeHistogramBuckets; i++) {
+            pullStats.second.pullTimeHistogram[i] = 0;
+        }
     }
     mAtomMetricStats.clear();
     mActivationBroadcastGuardrailStats.clear();
@@ -737,14 +762,20 @@ void StatsdStats::dumpStats(int out) const {
                 "  (average pull time nanos)%lld, (max pull time nanos)%lld, (average pull delay "
                 "nanos)%lld, "
                 "  (max pull delay nanos)%lld, (data error)%ld\n"
-                "  (pull timeout)%ld, (pull exceed max delay)%ld\n"
+                "  (pull timeout)%ld, (pull exceed max delay)%ld, (stale data served)%ld\n"
                 "  (registered count) %ld, (unregistered count) %ld\n",
                 (int)pair.first, (long)pair.second.totalPull, (long)pair.second.totalPullFromCache,
                 (long)pair.second.pullFailed, (long)pair.second.minPullIntervalSec,
                 (long long)pair.second.avgPullTimeNs, (long long)pair.second.maxPullTimeNs,
                 (long long)pair.second.avgPullDelayNs, (long long)pair.second.maxPullDelayNs,
                 pair.second.dataError, pair.second.pullTimeout, pair.second.pullExceedMaxDelay,
-                pair.second.registeredCount, pair.second.unregisteredCount);
+                pair.second.staleDataServed, pair.second.registeredCount,
+                pair.second.unregisteredCount);
+        dprintf(out, "  (pull time histogram)");
+        for (size_t i = 0; i < kNumPullTimeHistogramBuckets; i++) {
+            dprintf(out, " %lld", (long long)pair.second.pullTimeHistogram[i]);
+        }
+        dprintf(out, "\n");
     }
 
     if (mAnomalyAlarmRegisteredStats > 0) {
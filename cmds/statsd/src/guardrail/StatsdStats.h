@@ -161,6 +161,13 @@ public:
     // Max time to do a pull.
     static const int64_t kPullMaxDelayNs = 10 * NS_PER_SEC;
 
+    // Number of buckets in the per-atom pull latency histogram. Bucket upper bounds are in
+    // kPullTimeHistogramBucketBoundariesNs; the last bucket holds everything beyond them.
+    static const size_t kNumPullTimeHistogramBuckets = 8;
+
+    // Exclusive upper bounds of the pull latency histogram buckets.
+    static const int64_t kPullTimeHistogramBucketBoundariesNs[kNumPullTimeHistogramBuckets - 1];
+
     // Maximum number of pushed atoms statsd stats will track above kMaxPushedAtomId.
     static const int kMaxNonPlatformPushedAtoms = 100;
 
@@ -344,6 +351,11 @@ public:
      */
     void notePullTimeout(int pullAtomId);
 
+    /*
+     * Records that a pull missed its deadline and the last good data was served instead.
+     */
+    void notePullStaleDataServed(int pullAtomId);
+
     /*
      * Records pull exceeds max delay for a metric.
      */
@@ -488,6 +500,9 @@ public:
         long emptyData = 0;
         long registeredCount = 0;
         long unregisteredCount = 0;
+        long staleDataServed = 0;
+        // Count of actual pulls per latency bucket; see kPullTimeHistogramBucketBoundariesNs.
+        int64_t pullTimeHistogram[kNumPullTimeHistogramBuckets] = {0};
     } PulledAtomStats;
 
     typedef struct {
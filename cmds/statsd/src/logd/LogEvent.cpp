@@ -20,6 +20,8 @@
 #include "stats_log_util.h"
 #include "statslog.h"
 
+#include <atomic>
+
 #include <binder/IPCThreadState.h>
 #include <private/android_filesystem_config.h>
 
@@ -36,23 +38,73 @@ using std::string;
 using std::vector;
 
 LogEvent::LogEvent(log_msg& msg) {
-    mContext =
-            create_android_log_parser(msg.msg() + sizeof(uint32_t), msg.len() - sizeof(uint32_t));
     mLogdTimestampNs = msg.entry_v1.sec * NS_PER_SEC + msg.entry_v1.nsec;
     mLogUid = msg.entry_v4.uid;
-    init(mContext);
-    if (mContext) {
-        // android_log_destroy will set mContext to NULL
-        android_log_destroy(&mContext);
-    }
+    // The receive buffer in the socket listener is reused for the next
+    // message, so take one copy of the payload; everything past the header is
+    // decoded from it on demand.
+    mRawLen = msg.len() - sizeof(uint32_t);
+    mRawBuffer.reset(new uint8_t[mRawLen]);
+    memcpy(mRawBuffer.get(), msg.msg() + sizeof(uint32_t), mRawLen);
+    mParsed = false;
+    parseHeader();
 }
 
 LogEvent::LogEvent(const LogEvent& event) {
+    event.ensureParsed();
     mTagId = event.mTagId;
     mLogUid = event.mLogUid;
     mElapsedTimestampNs = event.mElapsedTimestampNs;
     mLogdTimestampNs = event.mLogdTimestampNs;
     mValues = event.mValues;
+    mSequenceId = event.mSequenceId;
+}
+
+uint64_t LogEvent::nextSequenceId() {
+    // Starts at 1 so caches can use 0 as "no event seen yet".
+    static std::atomic<uint64_t> sNextSequenceId(1);
+    return sNextSequenceId.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LogEvent::parseHeader() {
+    mTagId = 0;
+    mElapsedTimestampNs = 0;
+    android_log_context context =
+            create_android_log_parser((const char*)mRawBuffer.get(), mRawLen);
+    if (context == NULL) {
+        return;
+    }
+    // elem at [0] is EVENT_TYPE_LIST, [1] is the timestamp, [2] is tag id.
+    android_log_list_element elem = android_log_read_next(context);
+    if (elem.type == EVENT_TYPE_LIST) {
+        elem = android_log_read_next(context);
+        if (elem.type == EVENT_TYPE_LONG) {
+            mElapsedTimestampNs = elem.data.int64;
+            elem = android_log_read_next(context);
+            if (elem.type == EVENT_TYPE_INT) {
+                mTagId = elem.data.int32;
+            }
+        }
+    }
+    android_log_destroy(&context);
+}
+
+void LogEvent::ensureParsed() const {
+    if (mParsed) {
+        return;
+    }
+    // Materialization mutates the cache members behind the const read
+    // accessors; this only ever runs on the processing thread.
+    LogEvent* self = const_cast<LogEvent*>(this);
+    self->mParsed = true;
+    android_log_context context =
+            create_android_log_parser((const char*)mRawBuffer.get(), mRawLen);
+    if (context != NULL) {
+        self->init(context);
+        android_log_destroy(&context);
+    }
+    self->mRawBuffer.reset();
+    self->mRawLen = 0;
 }
 
 LogEvent::LogEvent(const StatsLogEventWrapper& statsLogEventWrapper, int workChainIndex) {
@@ -558,6 +610,7 @@ void LogEvent::init(android_log_context context) {
 }
 
 int64_t LogEvent::GetLong(size_t key, status_t* err) const {
+    ensureParsed();
     // TODO(b/110561208): encapsulate the magical operations in Field struct as static functions
     int field = getSimpleField(key);
     for (const auto& value : mValues) {
@@ -581,6 +634,7 @@ int64_t LogEvent::GetLong(size_t key, status_t* err) const {
 }
 
 int LogEvent::GetInt(size_t key, status_t* err) const {
+    ensureParsed();
     int field = getSimpleField(key);
     for (const auto& value : mValues) {
         if (value.mField.getField() == field) {
@@ -601,6 +655,7 @@ int LogEvent::GetInt(size_t key, status_t* err) const {
 }
 
 const char* LogEvent::GetString(size_t key, status_t* err) const {
+    ensureParsed();
     int field = getSimpleField(key);
     for (const auto& value : mValues) {
         if (value.mField.getField() == field) {
@@ -621,6 +676,7 @@ const char* LogEvent::GetString(size_t key, status_t* err) const {
 }
 
 bool LogEvent::GetBool(size_t key, status_t* err) const {
+    ensureParsed();
     int field = getSimpleField(key);
     for (const auto& value : mValues) {
         if (value.mField.getField() == field) {
@@ -643,6 +699,7 @@ bool LogEvent::GetBool(size_t key, status_t* err) const {
 }
 
 float LogEvent::GetFloat(size_t key, status_t* err) const {
+    ensureParsed();
     int field = getSimpleField(key);
     for (const auto& value : mValues) {
         if (value.mField.getField() == field) {
@@ -663,6 +720,7 @@ float LogEvent::GetFloat(size_t key, status_t* err) const {
 }
 
 string LogEvent::ToString() const {
+    ensureParsed();
     string result;
     result += StringPrintf("{ uid(%d) %lld %lld (%d)", mLogUid, (long long)mLogdTimestampNs,
                            (long long)mElapsedTimestampNs, mTagId);
@@ -26,6 +26,7 @@
 #include <private/android_logger.h>
 #include <utils/Errors.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -69,7 +70,10 @@ struct InstallTrainInfo {
 class LogEvent {
 public:
     /**
-     * Read a LogEvent from a log_msg.
+     * Read a LogEvent from a log_msg. Only the header (timestamps, tag id and
+     * uid) is decoded up front; the payload is retained as raw bytes and the
+     * FieldValues are materialized lazily on first access, since most events
+     * are rejected by the tag filter without ever being looked at.
      */
     explicit LogEvent(log_msg& msg);
 
@@ -133,6 +137,13 @@ public:
         return mLogUid;
     }
 
+    /**
+     * A process-wide id assigned at construction, increasing in allocation order.
+     * Lets per-event caches (e.g. EventMatcherWizard) tell whether two lookups
+     * refer to the same event without comparing payloads. Never 0.
+     */
+    inline uint64_t GetSequenceId() const { return mSequenceId; }
+
     /**
      * Get the nth value, starting at 1.
      *
@@ -193,15 +204,31 @@ public:
         mLogdTimestampNs = timestampNs;
     }
 
+    /**
+     * The undecoded logd payload, or nullptr once the values have been
+     * materialized (or if the event was not built from a log_msg). Lets the
+     * event capture hook record replayable traffic without re-encoding.
+     */
+    inline const uint8_t* rawPayload(size_t* outLen) const {
+        if (mParsed) {
+            return nullptr;
+        }
+        *outLen = mRawLen;
+        return mRawBuffer.get();
+    }
+
     inline int size() const {
+        ensureParsed();
         return mValues.size();
     }
 
     const std::vector<FieldValue>& getValues() const {
+        ensureParsed();
         return mValues;
     }
 
     std::vector<FieldValue>* getMutableValues() {
+        ensureParsed();
         return &mValues;
     }
 
@@ -220,10 +247,31 @@ private:
      */
     void init(android_log_context context);
 
+    /**
+     * Reads the timestamp and tag id out of the retained raw payload without
+     * building any FieldValues.
+     */
+    void parseHeader();
+
+    /**
+     * Materializes mValues from the retained raw payload if that hasn't
+     * happened yet. Logically const: every read accessor funnels through here.
+     * Not thread safe; events are only ever read from the processing thread.
+     */
+    void ensureParsed() const;
+
     // The items are naturally sorted in DFS order as we read them. this allows us to do fast
     // matching.
     std::vector<FieldValue> mValues;
 
+    // The undecoded payload from logd, kept until the values are first needed.
+    // Only set by the log_msg constructor; released once parsed.
+    std::unique_ptr<uint8_t[]> mRawBuffer;
+    size_t mRawLen = 0;
+
+    // False only while mRawBuffer still awaits materialization.
+    bool mParsed = true;
+
     // This field is used when statsD wants to create log event object and write fields to it. After
     // calling init() function, this object would be destroyed to save memory usage.
     // When the log event is created from log msg, this field is never initiated.
@@ -238,6 +286,11 @@ private:
     int mTagId;
 
     uint32_t mLogUid;
+
+    // See GetSequenceId(). Copies share the original's id since their payloads
+    // are identical, so cached verdicts stay valid for them.
+    uint64_t mSequenceId = nextSequenceId();
+    static uint64_t nextSequenceId();
 };
 
 void writeExperimentIdsToProto(const std::vector<int64_t>& experimentIds, std::vector<uint8_t>* protoOut);
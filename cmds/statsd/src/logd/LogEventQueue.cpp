@@ -23,38 +23,84 @@ namespace android {
 namespace os {
 namespace statsd {
 
-using std::unique_lock;
 using std::unique_ptr;
 
-unique_ptr<LogEvent> LogEventQueue::waitPop() {
-    std::unique_lock<std::mutex> lock(mMutex);
-
-    if (mQueue.empty()) {
-        mCondition.wait(lock, [this] { return !this->mQueue.empty(); });
+LogEventQueue::LogEventQueue(size_t maxSize) : mCapacity(maxSize), mSlots(new Slot[maxSize]) {
+    for (uint64_t i = 0; i < maxSize; i++) {
+        mSlots[i].sequence.store(i, std::memory_order_relaxed);
     }
+}
 
-    unique_ptr<LogEvent> item = std::move(mQueue.front());
-    mQueue.pop();
+void LogEventQueue::waitPopAll(std::vector<unique_ptr<LogEvent>>* events) {
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mConsumerWaiting.store(true, std::memory_order_relaxed);
+        // Pairs with the fence in push(): either the predicate below sees the
+        // freshly published slot, or the producer sees mConsumerWaiting and
+        // takes the mutex to notify. Without it the wakeup could be missed.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        mCondition.wait(lock, [this] {
+            return mSlots[mHead % mCapacity].sequence.load(std::memory_order_acquire) == mHead + 1;
+        });
+        mConsumerWaiting.store(false, std::memory_order_relaxed);
+    }
 
-    return item;
+    const size_t firstIndex = events->size();
+    while (true) {
+        Slot& slot = mSlots[mHead % mCapacity];
+        if (slot.sequence.load(std::memory_order_acquire) != mHead + 1) {
+            break;
+        }
+        events->emplace_back(std::move(slot.event));
+        // Hand the slot back to the producers one lap later.
+        slot.sequence.store(mHead + mCapacity, std::memory_order_release);
+        mHead++;
+    }
+    // The predicate guarantees at least one event was popped.
+    mOldestTimestampNs.store((*events)[firstIndex]->GetElapsedTimestampNs(),
+                             std::memory_order_relaxed);
 }
 
 bool LogEventQueue::push(unique_ptr<LogEvent> item, int64_t* oldestTimestampNs) {
-    bool success;
-    {
-        std::unique_lock<std::mutex> lock(mMutex);
-        if (mQueue.size() < mQueueLimit) {
-            mQueue.push(std::move(item));
-            success = true;
+    // Until the consumer has processed its first batch, the oldest pending
+    // history is simply the first event that made it into the ring.
+    if (mOldestTimestampNs.load(std::memory_order_relaxed) == 0) {
+        int64_t expected = 0;
+        mOldestTimestampNs.compare_exchange_strong(expected, item->GetElapsedTimestampNs(),
+                                                   std::memory_order_relaxed);
+    }
+    uint64_t pos = mTail.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = mSlots[pos % mCapacity];
+        uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq == pos) {
+            if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.event = std::move(item);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                break;
+            }
+            // Lost the race for this slot; pos was reloaded by the CAS.
+        } else if (seq < pos) {
+            // The consumer hasn't freed this slot yet: the ring is full.
+            mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+            *oldestTimestampNs = mOldestTimestampNs.load(std::memory_order_relaxed);
+            return false;
         } else {
-            // safe operation as queue must not be empty.
-            *oldestTimestampNs = mQueue.front()->GetElapsedTimestampNs();
-            success = false;
+            // Another producer claimed pos and is (or was) filling it.
+            pos = mTail.load(std::memory_order_relaxed);
         }
     }
 
-    mCondition.notify_one();
-    return success;
+    // See the matching fence in waitPopAll().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (mConsumerWaiting.load(std::memory_order_relaxed)) {
+        // Taking the mutex serializes against the consumer's check-then-park,
+        // so the notification cannot land in between. Producers only get here
+        // when the consumer is going idle, never in a steady-state burst.
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCondition.notify_one();
+    }
+    return true;
 }
 
 }  // namespace statsd
@@ -18,40 +18,73 @@
 
 #include "LogEvent.h"
 
+#include <atomic>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <queue>
-#include <thread>
+#include <vector>
 
 namespace android {
 namespace os {
 namespace statsd {
 
 /**
- * A zero copy thread safe queue buffer for producing and consuming LogEvent.
+ * A zero copy queue buffer for producing and consuming LogEvent.
+ *
+ * Implemented as a bounded ring whose slots carry sequence numbers, so
+ * producers (the socket listener threads) never take a lock: a push is a CAS
+ * to claim a slot plus an atomic publish. The single consumer drains every
+ * queued event in one batch and only touches the mutex when it has to go to
+ * sleep, which keeps a burst of pushes from stalling behind a slow metric
+ * producer on the processing side. Events that arrive while the ring is full
+ * are dropped and counted.
  */
 class LogEventQueue {
 public:
-    explicit LogEventQueue(size_t maxSize) : mQueueLimit(maxSize){};
+    explicit LogEventQueue(size_t maxSize);
 
     /**
-     * Blocking read one event from the queue.
+     * Blocking read; waits until at least one event is queued, then moves
+     * every queued event into *events, oldest first.
      */
-    std::unique_ptr<LogEvent> waitPop();
+    void waitPopAll(std::vector<std::unique_ptr<LogEvent>>* events);
 
     /**
      * Puts a LogEvent ptr to the end of the queue.
-     * Returns false on failure when the queue is full, and output the oldest event timestamp
-     * in the queue.
+     * Returns false on failure when the queue is full, and outputs the timestamp
+     * of the oldest event still awaiting processing.
      */
     bool push(std::unique_ptr<LogEvent> event, int64_t* oldestTimestampNs);
 
+    /**
+     * Total number of events dropped because the ring was full.
+     */
+    int64_t getDroppedCount() const {
+        return mDroppedCount.load(std::memory_order_relaxed);
+    }
+
 private:
-    const size_t mQueueLimit;
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        std::unique_ptr<LogEvent> event;
+    };
+
+    const size_t mCapacity;
+    std::unique_ptr<Slot[]> mSlots;
+    // Next position a producer claims. A slot is writable when its sequence
+    // equals the position, and readable when it equals position + 1.
+    std::atomic<uint64_t> mTail{0};
+    // Next position to read; only ever touched by the consumer thread.
+    uint64_t mHead = 0;
+    std::atomic<int64_t> mDroppedCount{0};
+    // Timestamp of the first event of the batch currently being processed,
+    // i.e. the oldest history that is not yet reflected in the metrics.
+    std::atomic<int64_t> mOldestTimestampNs{0};
+    // True while the consumer is parked (or deciding to park) on mCondition;
+    // producers skip the mutex entirely while it is false.
+    std::atomic<bool> mConsumerWaiting{false};
     std::condition_variable mCondition;
     std::mutex mMutex;
-    std::queue<std::unique_ptr<LogEvent>> mQueue;
 };
 
 }  // namespace statsd
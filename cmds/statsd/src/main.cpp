@@ -83,7 +83,7 @@ int main(int /*argc*/, char** /*argv*/) {
     ::android::hardware::configureRpcThreadpool(4 /*threads*/, false /*willJoin*/);
 
     std::shared_ptr<LogEventQueue> eventQueue =
-            std::make_shared<LogEventQueue>(2000 /*buffer limit. Buffer is NOT pre-allocated*/);
+            std::make_shared<LogEventQueue>(2000 /*buffer limit. Ring slots are pre-allocated*/);
 
     // Create the service
     gStatsService = new StatsService(looper, eventQueue);
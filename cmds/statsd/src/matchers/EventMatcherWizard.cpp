@@ -28,9 +28,15 @@ MatchingState EventMatcherWizard::matchLogEvent(const LogEvent& event, int match
     if (matcher_index < 0 || matcher_index >= (int)mAllEventMatchers.size()) {
         return MatchingState::kNotComputed;
     }
-    vector<MatchingState> matcherCache(mAllEventMatchers.size(), MatchingState::kNotComputed);
-    mAllEventMatchers[matcher_index]->onLogEvent(event, mAllEventMatchers, matcherCache);
-    return matcherCache[matcher_index];
+    std::lock_guard<std::mutex> lock(mCacheMutex);
+    if (event.GetSequenceId() != mCachedEventSequenceId) {
+        mMatcherCache.assign(mAllEventMatchers.size(), MatchingState::kNotComputed);
+        mCachedEventSequenceId = event.GetSequenceId();
+    }
+    if (mMatcherCache[matcher_index] == MatchingState::kNotComputed) {
+        mAllEventMatchers[matcher_index]->onLogEvent(event, mAllEventMatchers, mMatcherCache);
+    }
+    return mMatcherCache[matcher_index];
 }
 
 }  // namespace statsd
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include "LogMatchingTracker.h"
 
 namespace android {
@@ -34,6 +36,16 @@ public:
 
 private:
     std::vector<sp<LogMatchingTracker>> mAllEventMatchers;
+
+    std::mutex mCacheMutex;
+
+    // Memoized verdicts for the most recent event, keyed by its sequence id.
+    // The wizard is shared by every pulled metric in a config, and a pull
+    // delivers the same events to each of them, so consecutive calls mostly
+    // repeat the previous event.
+    std::vector<MatchingState> mMatcherCache;
+
+    uint64_t mCachedEventSequenceId = 0;
 };
 
 }  // namespace statsd
@@ -140,6 +140,7 @@ void CountMetricProducer::onSlicedConditionMayChangeLocked(bool overallCondition
 
 void CountMetricProducer::clearPastBucketsLocked(const int64_t dumpTimeNs) {
     mPastBuckets.clear();
+    mTrackedByteSize = 0;
 }
 
 void CountMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
@@ -238,6 +239,7 @@ void CountMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
 
     if (erase_data) {
         mPastBuckets.clear();
+        mTrackedByteSize = 0;
     }
 }
 
@@ -245,6 +247,7 @@ void CountMetricProducer::dropDataLocked(const int64_t dropTimeNs) {
     flushIfNeededLocked(dropTimeNs);
     StatsdStats::getInstance().noteBucketDropped(mMetricId);
     mPastBuckets.clear();
+    mTrackedByteSize = 0;
 }
 
 void CountMetricProducer::onConditionChangedLocked(const bool conditionMet,
@@ -343,6 +346,7 @@ void CountMetricProducer::flushCurrentBucketLocked(const int64_t& eventTimeNs,
         info.mCount = counter.second;
         auto& bucketList = mPastBuckets[counter.first];
         bucketList.push_back(info);
+        mTrackedByteSize += kBucketSize;
         VLOG("metric %lld, dump key value: %s -> %lld", (long long)mMetricId,
              counter.first.toString().c_str(),
              (long long)counter.second);
@@ -490,11 +490,13 @@ void DurationMetricProducer::dropDataLocked(const int64_t dropTimeNs) {
     flushIfNeededLocked(dropTimeNs);
     StatsdStats::getInstance().noteBucketDropped(mMetricId);
     mPastBuckets.clear();
+    mTrackedByteSize = 0;
 }
 
 void DurationMetricProducer::clearPastBucketsLocked(const int64_t dumpTimeNs) {
     flushIfNeededLocked(dumpTimeNs);
     mPastBuckets.clear();
+    mTrackedByteSize = 0;
 }
 
 void DurationMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
@@ -593,6 +595,7 @@ void DurationMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
     protoOutput->end(protoToken);
     if (erase_data) {
         mPastBuckets.clear();
+        mTrackedByteSize = 0;
     }
 }
 
@@ -631,6 +634,10 @@ void DurationMetricProducer::flushCurrentBucketLocked(const int64_t& eventTimeNs
     }
     StatsdStats::getInstance().noteBucketCount(mMetricId);
     mCurrentBucketStartTimeNs = nextBucketStartTimeNs;
+    // The duration trackers appended the closed buckets to mPastBuckets above;
+    // refresh the running size counter here, once per flush, rather than
+    // plumbing per-insert accounting through every tracker.
+    mTrackedByteSize = byteSizeLocked();
 }
 
 void DurationMetricProducer::dumpStatesLocked(FILE* out, bool verbose) const {
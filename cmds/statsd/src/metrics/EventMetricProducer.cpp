@@ -77,6 +77,7 @@ EventMetricProducer::~EventMetricProducer() {
 
 void EventMetricProducer::dropDataLocked(const int64_t dropTimeNs) {
     mProto->clear();
+    mTrackedByteSize = 0;
     StatsdStats::getInstance().noteBucketDropped(mMetricId);
 }
 
@@ -103,6 +104,7 @@ std::unique_ptr<std::vector<uint8_t>> serializeProtoLocked(ProtoOutputStream& pr
 
 void EventMetricProducer::clearPastBucketsLocked(const int64_t dumpTimeNs) {
     mProto->clear();
+    mTrackedByteSize = 0;
 }
 
 void EventMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
@@ -127,6 +129,7 @@ void EventMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
 
     if (erase_data) {
         mProto->clear();
+        mTrackedByteSize = 0;
     }
 }
 
@@ -154,6 +157,7 @@ void EventMetricProducer::onMatchedLogEventInternalLocked(
     event.ToProto(*mProto);
     mProto->end(eventToken);
     mProto->end(wrapperToken);
+    mTrackedByteSize = mProto->bytesWritten();
 }
 
 size_t EventMetricProducer::byteSizeLocked() const {
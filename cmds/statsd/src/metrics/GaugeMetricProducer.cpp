@@ -176,6 +176,7 @@ void GaugeMetricProducer::clearPastBucketsLocked(const int64_t dumpTimeNs) {
     flushIfNeededLocked(dumpTimeNs);
     mPastBuckets.clear();
     mSkippedBuckets.clear();
+    mTrackedByteSize = 0;
 }
 
 void GaugeMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
@@ -304,6 +305,7 @@ void GaugeMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
     if (erase_data) {
         mPastBuckets.clear();
         mSkippedBuckets.clear();
+        mTrackedByteSize = 0;
     }
 }
 
@@ -531,6 +533,7 @@ void GaugeMetricProducer::dropDataLocked(const int64_t dropTimeNs) {
     flushIfNeededLocked(dropTimeNs);
     StatsdStats::getInstance().noteBucketDropped(mMetricId);
     mPastBuckets.clear();
+    mTrackedByteSize = 0;
 }
 
 // When a new matched event comes in, we check if event falls into the current
@@ -574,6 +577,12 @@ void GaugeMetricProducer::flushCurrentBucketLocked(const int64_t& eventTimeNs,
             info.mGaugeAtoms = slice.second;
             auto& bucketList = mPastBuckets[slice.first];
             bucketList.push_back(info);
+            mTrackedByteSize += info.mGaugeAtoms.size() * sizeof(GaugeAtom);
+            for (const auto& atom : info.mGaugeAtoms) {
+                if (atom.mFields != nullptr) {
+                    mTrackedByteSize += atom.mFields->size() * sizeof(FieldValue);
+                }
+            }
             VLOG("Gauge gauge metric %lld, dump key value: %s", (long long)mMetricId,
                  slice.first.toString().c_str());
         }
@@ -47,8 +47,7 @@ struct GaugeBucket {
     std::vector<GaugeAtom> mGaugeAtoms;
 };
 
-typedef std::unordered_map<MetricDimensionKey, std::vector<GaugeAtom>>
-    DimToGaugeAtomsMap;
+typedef flat_dim_map<std::vector<GaugeAtom>> DimToGaugeAtomsMap;
 
 // This gauge metric producer first register the puller to automatically pull the gauge at the
 // beginning of each bucket. If the condition is met, insert it to the bucket info. Otherwise
@@ -173,11 +173,18 @@ public:
         dumpStatesLocked(out, verbose);
     }
 
-    // Returns the memory in bytes currently used to store this metric's data. Does not change
-    // state.
+    // Returns the memory in bytes currently used to store this metric's data.
+    // Served from a running counter the producers keep up to date as data is
+    // added and erased, so guardrail checks do not pay for a walk of the very
+    // state they are bounding. Every few queries the counter is recomputed
+    // from scratch to correct any accounting drift.
     size_t byteSize() const {
         std::lock_guard<std::mutex> lock(mMutex);
-        return byteSizeLocked();
+        if (++mByteSizeQueriesSinceAudit >= kByteSizeQueriesPerAudit) {
+            mByteSizeQueriesSinceAudit = 0;
+            mTrackedByteSize = byteSizeLocked();
+        }
+        return mTrackedByteSize;
     }
 
     /* If alert is valid, adds an AnomalyTracker and returns it. If invalid, returns nullptr. */
@@ -366,6 +373,15 @@ protected:
 
     std::vector<sp<AnomalyTracker>> mAnomalyTrackers;
 
+    // Running counter behind byteSize(). Producers bump it when buckets are
+    // stored and zero it when past data is erased; byteSize() occasionally
+    // re-walks the state via byteSizeLocked() to absorb drift.
+    mutable size_t mTrackedByteSize = 0;
+
+    mutable int mByteSizeQueriesSinceAudit = 0;
+
+    static const int kByteSizeQueriesPerAudit = 128;
+
     /*
      * Individual metrics can implement their own business logic here. All pre-processing is done.
      *
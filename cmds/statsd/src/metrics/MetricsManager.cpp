@@ -32,6 +32,8 @@
 #include <private/android_filesystem_config.h>
 #include <utils/SystemClock.h>
 
+#include <algorithm>
+
 using android::util::FIELD_COUNT_REPEATED;
 using android::util::FIELD_TYPE_INT32;
 using android::util::FIELD_TYPE_INT64;
@@ -83,6 +85,10 @@ MetricsManager::MetricsManager(const ConfigKey& key, const StatsdConfig& config,
             mActivationAtomTrackerToMetricMap, mDeactivationAtomTrackerToMetricMap,
             mMetricIndexesWithActivation, mNoReportMetricIds);
 
+    if (mConfigValid) {
+        compileMatcherDispatch();
+    }
+
     mHashStringsInReport = config.hash_strings_in_metric_report();
     mVersionStringsInReport = config.version_strings_in_metric_report();
     mInstallerInReport = config.installer_in_metric_report();
@@ -168,6 +174,29 @@ void MetricsManager::initLogSourceWhiteList() {
     }
 }
 
+void MetricsManager::compileMatcherDispatch() {
+    for (size_t i = 0; i < mAllAtomMatchers.size(); i++) {
+        for (const int tagId : mAllAtomMatchers[i]->getAtomIds()) {
+            mMatcherIndexesByTag[tagId].push_back(i);
+        }
+    }
+
+    if (mTagIds.empty()) {
+        return;
+    }
+    // Size the bitmap to the largest interesting atom id, capped so one huge
+    // id (vendor atoms live at 100,000+) can't balloon it. Ids beyond the
+    // bitmap take the mTagIds fallback in onLogEvent.
+    static const int kMaxBitmapTagId = 1 << 17;
+    const int maxTagId = std::min(*mTagIds.rbegin(), kMaxBitmapTagId - 1);
+    mInterestingTagBitmap.assign(maxTagId + 1, false);
+    for (const int tagId : mTagIds) {
+        if (tagId >= 0 && tagId <= maxTagId) {
+            mInterestingTagBitmap[tagId] = true;
+        }
+    }
+}
+
 bool MetricsManager::isConfigValid() const {
     return mConfigValid;
 }
@@ -368,16 +397,27 @@ void MetricsManager::onLogEvent(const LogEvent& event) {
 
     mIsActive = isActive || !activeMetricsIndices.empty();
 
-    if (mTagIds.find(tagId) == mTagIds.end()) {
+    if (tagId >= 0 && tagId < (int)mInterestingTagBitmap.size()) {
+        if (!mInterestingTagBitmap[tagId]) {
+            // Not interesting...
+            return;
+        }
+    } else if (mTagIds.find(tagId) == mTagIds.end()) {
         // Not interesting...
         return;
     }
 
+    const auto matcherIndexesIt = mMatcherIndexesByTag.find(tagId);
+    if (matcherIndexesIt == mMatcherIndexesByTag.end()) {
+        return;
+    }
+
     vector<MatchingState> matcherCache(mAllAtomMatchers.size(), MatchingState::kNotComputed);
 
-    // Evaluate all atom matchers.
-    for (auto& matcher : mAllAtomMatchers) {
-        matcher->onLogEvent(event, mAllAtomMatchers, matcherCache);
+    // Evaluate only the matchers compiled for this atom id. The rest stay
+    // kNotComputed, which everything downstream reads as not matched.
+    for (const int matcherIndex : matcherIndexesIt->second) {
+        mAllAtomMatchers[matcherIndex]->onLogEvent(event, mAllAtomMatchers, matcherCache);
     }
 
     // Set of metrics that received an activation cancellation.
@@ -184,6 +184,15 @@ private:
     // All event tags that are interesting to my metrics.
     std::set<int> mTagIds;
 
+    // Compiled dispatch table, built from the matchers once the config is
+    // initialized. The bitmap is indexed by atom id so an event nobody cares
+    // about is rejected with a single array load; atom ids past the bitmap
+    // (e.g. vendor atoms with huge ids) fall back to mTagIds. For interesting
+    // atoms, mMatcherIndexesByTag lists the matchers worth evaluating, so a
+    // 400-matcher config doesn't walk 400 trackers per event.
+    std::vector<bool> mInterestingTagBitmap;
+    std::unordered_map<int, std::vector<int>> mMatcherIndexesByTag;
+
     // We only store the sp of LogMatchingTracker, MetricProducer, and ConditionTracker in
     // MetricsManager. There are relationships between them, and the relationships are denoted by
     // index instead of pointers. The reasons for this are: (1) the relationship between them are
@@ -238,6 +247,10 @@ private:
 
     void initLogSourceWhiteList();
 
+    // Builds mInterestingTagBitmap and mMatcherIndexesByTag from the
+    // initialized matchers.
+    void compileMatcherDispatch();
+
     // The metrics that don't need to be uploaded or even reported.
     std::set<int64_t> mNoReportMetricIds;
 
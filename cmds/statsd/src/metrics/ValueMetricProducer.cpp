@@ -200,6 +200,7 @@ void ValueMetricProducer::dropDataLocked(const int64_t dropTimeNs) {
 void ValueMetricProducer::clearPastBucketsLocked(const int64_t dumpTimeNs) {
     mPastBuckets.clear();
     mSkippedBuckets.clear();
+    mTrackedByteSize = 0;
 }
 
 void ValueMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
@@ -343,6 +344,7 @@ void ValueMetricProducer::onDumpReportLocked(const int64_t dumpTimeNs,
     if (erase_data) {
         mPastBuckets.clear();
         mSkippedBuckets.clear();
+        mTrackedByteSize = 0;
     }
 }
 
@@ -876,6 +878,7 @@ void ValueMetricProducer::flushCurrentBucketLocked(const int64_t& eventTimeNs,
             if (bucket.valueIndex.size() > 0) {
                 auto& bucketList = mPastBuckets[slice.first];
                 bucketList.push_back(bucket);
+                mTrackedByteSize += kBucketSize;
             }
         }
     } else {
@@ -167,9 +167,9 @@ private:
         bool seenNewData = false;
     } Interval;
 
-    std::unordered_map<MetricDimensionKey, std::vector<Interval>> mCurrentSlicedBucket;
+    flat_dim_map<std::vector<Interval>> mCurrentSlicedBucket;
 
-    std::unordered_map<MetricDimensionKey, int64_t> mCurrentFullBucket;
+    flat_dim_map<int64_t> mCurrentFullBucket;
 
     // Save the past buckets and we can clear when the StatsLogReport is dumped.
     std::unordered_map<MetricDimensionKey, std::vector<ValueBucket>> mPastBuckets;
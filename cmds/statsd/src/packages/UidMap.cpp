@@ -69,7 +69,11 @@ const int FIELD_ID_CHANGE_PREV_VERSION_STRING = 9;
 const int FIELD_ID_CHANGE_NEW_VERSION_STRING_HASH = 10;
 const int FIELD_ID_CHANGE_PREV_VERSION_STRING_HASH = 11;
 
-UidMap::UidMap() : mBytesUsed(0) {}
+UidMap::UidMap()
+    : mSnapshot(std::make_shared<const PackageMap>()),
+      mIsolatedSnapshot(std::make_shared<const IsolatedUidMap>()),
+      mBytesUsed(0) {
+}
 
 UidMap::~UidMap() {}
 
@@ -78,11 +82,30 @@ sp<UidMap> UidMap::getInstance() {
     return sInstance;
 }
 
+void UidMap::publishSnapshotLocked() {
+    std::atomic_store_explicit(&mSnapshot, std::make_shared<const PackageMap>(mMap),
+                               std::memory_order_release);
+}
+
+void UidMap::publishIsolatedSnapshotLocked() {
+    std::atomic_store_explicit(&mIsolatedSnapshot,
+                               std::make_shared<const IsolatedUidMap>(mIsolatedUidMap),
+                               std::memory_order_release);
+}
+
+std::shared_ptr<const UidMap::PackageMap> UidMap::getSnapshot() const {
+    return std::atomic_load_explicit(&mSnapshot, std::memory_order_acquire);
+}
+
+std::shared_ptr<const UidMap::IsolatedUidMap> UidMap::getIsolatedSnapshot() const {
+    return std::atomic_load_explicit(&mIsolatedSnapshot, std::memory_order_acquire);
+}
+
 bool UidMap::hasApp(int uid, const string& packageName) const {
-    lock_guard<mutex> lock(mMutex);
+    auto snapshot = getSnapshot();
 
-    auto it = mMap.find(std::make_pair(uid, packageName));
-    return it != mMap.end() && !it->second.deleted;
+    auto it = snapshot->find(std::make_pair(uid, packageName));
+    return it != snapshot->end() && !it->second.deleted;
 }
 
 string UidMap::normalizeAppName(const string& appName) const {
@@ -92,13 +115,10 @@ string UidMap::normalizeAppName(const string& appName) const {
 }
 
 std::set<string> UidMap::getAppNamesFromUid(const int32_t& uid, bool returnNormalized) const {
-    lock_guard<mutex> lock(mMutex);
-    return getAppNamesFromUidLocked(uid,returnNormalized);
-}
+    auto snapshot = getSnapshot();
 
-std::set<string> UidMap::getAppNamesFromUidLocked(const int32_t& uid, bool returnNormalized) const {
     std::set<string> names;
-    for (const auto& kv : mMap) {
+    for (const auto& kv : *snapshot) {
         if (kv.first.first == uid && !kv.second.deleted) {
             names.insert(returnNormalized ? normalizeAppName(kv.first.second) : kv.first.second);
         }
@@ -107,10 +127,10 @@ std::set<string> UidMap::getAppNamesFromUidLocked(const int32_t& uid, bool retur
 }
 
 int64_t UidMap::getAppVersion(int uid, const string& packageName) const {
-    lock_guard<mutex> lock(mMutex);
+    auto snapshot = getSnapshot();
 
-    auto it = mMap.find(std::make_pair(uid, packageName));
-    if (it == mMap.end() || it->second.deleted) {
+    auto it = snapshot->find(std::make_pair(uid, packageName));
+    if (it == snapshot->end() || it->second.deleted) {
         return 0;
     }
     return it->second.versionCode;
@@ -148,6 +168,7 @@ void UidMap::updateMap(const int64_t& timestamp, const vector<int32_t>& uid,
             }
         }
 
+        publishSnapshotLocked();
         ensureBytesUsedBelowLimit();
         StatsdStats::getInstance().setCurrentUidMapMemory(mBytesUsed);
         getListenerListCopyLocked(&broadcastList);
@@ -197,6 +218,7 @@ void UidMap::updateApp(const int64_t& timestamp, const String16& app_16, const i
             // app after deletion.
             getListenerListCopyLocked(&broadcastList);
         }
+        publishSnapshotLocked();
         mChanges.emplace_back(false, timestamp, appName, uid, versionCode, newVersionString,
                               prevVersion, prevVersionString);
         mBytesUsed += kBytesChangeRecord;
@@ -266,6 +288,7 @@ void UidMap::removeApp(const int64_t& timestamp, const String16& app_16, const i
             mMap.erase(oldest);
             StatsdStats::getInstance().noteUidMapAppDeletionDropped();
         }
+        publishSnapshotLocked();
         mChanges.emplace_back(true, timestamp, app, uid, 0, "", prevVersion, prevVersionString);
         mBytesUsed += kBytesChangeRecord;
         ensureBytesUsedBelowLimit();
@@ -296,6 +319,7 @@ void UidMap::assignIsolatedUid(int isolatedUid, int parentUid) {
     lock_guard<mutex> lock(mIsolatedMutex);
 
     mIsolatedUidMap[isolatedUid] = parentUid;
+    publishIsolatedSnapshotLocked();
 }
 
 void UidMap::removeIsolatedUid(int isolatedUid) {
@@ -304,14 +328,15 @@ void UidMap::removeIsolatedUid(int isolatedUid) {
     auto it = mIsolatedUidMap.find(isolatedUid);
     if (it != mIsolatedUidMap.end()) {
         mIsolatedUidMap.erase(it);
+        publishIsolatedSnapshotLocked();
     }
 }
 
 int UidMap::getHostUidOrSelf(int uid) const {
-    lock_guard<mutex> lock(mIsolatedMutex);
+    auto snapshot = getIsolatedSnapshot();
 
-    auto it = mIsolatedUidMap.find(uid);
-    if (it != mIsolatedUidMap.end()) {
+    auto it = snapshot->find(uid);
+    if (it != snapshot->end()) {
         return it->second;
     }
     return uid;
@@ -487,10 +512,10 @@ void UidMap::OnConfigRemoved(const ConfigKey& key) {
 }
 
 set<int32_t> UidMap::getAppUid(const string& package) const {
-    lock_guard<mutex> lock(mMutex);
+    auto snapshot = getSnapshot();
 
     set<int32_t> results;
-    for (const auto& kv : mMap) {
+    for (const auto& kv : *snapshot) {
         if (kv.first.second == package && !kv.second.deleted) {
             results.insert(kv.first.first);
         }
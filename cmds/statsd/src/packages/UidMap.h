@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <utils/RefBase.h>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <string>
@@ -86,6 +87,8 @@ const unsigned int kBytesChangeRecord = sizeof(struct ChangeRecord);
 
 // UidMap keeps track of what the corresponding app name (APK name) and version code for every uid
 // at any given moment. This map must be updated by StatsCompanionService.
+// Lookups used while processing log events read an immutable snapshot of the map, so they do not
+// block on (or get blocked by) package updates happening concurrently on a binder thread.
 class UidMap : public virtual android::RefBase {
 public:
     UidMap();
@@ -164,7 +167,6 @@ public:
                              ProtoOutputStream* proto);
 
 private:
-    std::set<string> getAppNamesFromUidLocked(const int32_t& uid, bool returnNormalized) const;
     string normalizeAppName(const string& appName) const;
 
     void getListenerListCopyLocked(std::vector<wp<PackageInfoListener>>* output);
@@ -182,12 +184,30 @@ private:
             return hash_fn(std::to_string(p.first) + p.second);
         }
     };
-    // Maps uid and package name to application data.
-    std::unordered_map<std::pair<int, string>, AppData, PairHash> mMap;
+    using PackageMap = std::unordered_map<std::pair<int, string>, AppData, PairHash>;
+    using IsolatedUidMap = std::unordered_map<int, int>;
+
+    // Maps uid and package name to application data. Only mutated with mMutex held; the
+    // OnLogEvent-path readers use mSnapshot instead so they never contend with updates.
+    PackageMap mMap;
 
     // Maps isolated uid to the parent uid. Any metrics for an isolated uid will instead contribute
-    // to the parent uid.
-    std::unordered_map<int, int> mIsolatedUidMap;
+    // to the parent uid. Same locking scheme as mMap, with mIsolatedMutex and mIsolatedSnapshot.
+    IsolatedUidMap mIsolatedUidMap;
+
+    // Immutable copies of the maps above, republished after every mutation. Readers pick them up
+    // with an atomic shared_ptr load and can keep iterating an old copy while a config change
+    // builds and publishes a new one.
+    std::shared_ptr<const PackageMap> mSnapshot;
+    std::shared_ptr<const IsolatedUidMap> mIsolatedSnapshot;
+
+    // Publish a fresh immutable copy of mMap (or mIsolatedUidMap) for lock-free readers. Must be
+    // called with mMutex (respectively mIsolatedMutex) held, after the map has been mutated.
+    void publishSnapshotLocked();
+    void publishIsolatedSnapshotLocked();
+
+    std::shared_ptr<const PackageMap> getSnapshot() const;
+    std::shared_ptr<const IsolatedUidMap> getIsolatedSnapshot() const;
 
     // Record the changes that can be provided with the uploads.
     std::list<ChangeRecord> mChanges;
@@ -19,6 +19,8 @@
 #include "ShellSubscriber.h"
 
 #include <android-base/file.h>
+#include <errno.h>
+#include <fcntl.h>
 #include "matchers/matcher_util.h"
 #include "stats_log_util.h"
 
@@ -29,6 +31,15 @@ namespace os {
 namespace statsd {
 
 const static int FIELD_ID_ATOM = 1;
+const static int FIELD_ID_DROPPED_ATOM_COUNT = 2;
+
+// Flush a batch of matched atoms once it reaches this many encoded bytes...
+const static size_t kMaxBatchBytes = 16 * 1024;
+// ...or once its oldest atom has been waiting this long.
+const static int64_t kMaxBatchDelayMillis = 100;
+// Cap on bytes queued for an output fd that is not keeping up. Beyond it,
+// whole batches are dropped (and counted) instead of blocking the logging path.
+const static size_t kMaxPendingBytes = 256 * 1024;
 
 void ShellSubscriber::startNewSubscription(int in, int out, sp<IResultReceiver> resultReceiver,
                                            int timeoutSec) {
@@ -43,6 +54,15 @@ void ShellSubscriber::startNewSubscription(int in, int out, sp<IResultReceiver>
         mOutput = out;
         mResultReceiver = resultReceiver;
         IInterface::asBinder(mResultReceiver)->linkToDeath(this);
+
+        // A stalled reader must never stall OnLogEvent: write what the fd
+        // will take, queue the rest and drop with accounting once the queue
+        // is full.
+        fcntl(mOutput, F_SETFL, fcntl(mOutput, F_GETFL) | O_NONBLOCK);
+
+        mFlushToken = getElapsedRealtimeNs();
+        std::thread flusher([token = mFlushToken, this] { startFlush(token); });
+        flusher.detach();
     }
 
     // Note that the following is blocking, and it's intended as we cannot return until the shell
@@ -100,13 +120,14 @@ void ShellSubscriber::updateConfig(const ShellSubscription& config) {
 void ShellSubscriber::writeToOutputLocked(const vector<std::shared_ptr<LogEvent>>& data,
                                           const SimpleAtomMatcher& matcher) {
     if (mOutput == 0) return;
-    int count = 0;
-    mProto.clear();
     for (const auto& event : data) {
         VLOG("%s", event->ToString().c_str());
         if (matchesSimple(*mUidMap, matcher, *event)) {
             VLOG("matched");
-            count++;
+            if (mBatchedAtomCount == 0) {
+                mBatchStartElapsedMillis = getElapsedRealtimeMillis();
+            }
+            mBatchedAtomCount++;
             uint64_t atomToken = mProto.start(util::FIELD_TYPE_MESSAGE |
                                               util::FIELD_COUNT_REPEATED | FIELD_ID_ATOM);
             event->ToProto(mProto);
@@ -114,15 +135,85 @@ void ShellSubscriber::writeToOutputLocked(const vector<std::shared_ptr<LogEvent>
         }
     }
 
-    if (count > 0) {
-        // First write the payload size.
-        size_t bufferSize = mProto.size();
-        write(mOutput, &bufferSize, sizeof(bufferSize));
-        VLOG("%d atoms, proto size: %zu", count, bufferSize);
-        // Then write the payload.
-        mProto.flush(mOutput);
+    // Pulled data already arrives in period-sized chunks; flush right away
+    // (together with any batched pushed atoms) rather than waiting for age.
+    flushBatchLocked(getElapsedRealtimeMillis());
+}
+
+void ShellSubscriber::flushBatchLocked(int64_t nowMillis) {
+    if (mOutput == 0) {
+        mProto.clear();
+        mBatchedAtomCount = 0;
+        return;
+    }
+    if (mBatchedAtomCount == 0) {
+        // Nothing to frame; just retry any bytes the fd refused earlier.
+        drainOutputLocked();
+        return;
+    }
+
+    // Report drops in-stream so the consumer knows its data has gaps.
+    if (mDroppedAtomCount > 0) {
+        mProto.write(util::FIELD_TYPE_INT64 | FIELD_ID_DROPPED_ATOM_COUNT,
+                     (long long)mDroppedAtomCount);
+    }
+
+    size_t frameSize = mProto.size();
+    if (mOutgoing.size() + sizeof(frameSize) + frameSize > kMaxPendingBytes) {
+        // The reader is too far behind; drop the whole batch and account for
+        // it in the next frame that makes it out.
+        mDroppedAtomCount += mBatchedAtomCount;
+        VLOG("dropped %d atoms, output queue full", mBatchedAtomCount);
+    } else {
+        mDroppedAtomCount = 0;
+        // First frame the payload size, then the payload itself.
+        const uint8_t* sizeBytes = reinterpret_cast<const uint8_t*>(&frameSize);
+        mOutgoing.insert(mOutgoing.end(), sizeBytes, sizeBytes + sizeof(frameSize));
+        mProto.serializeToVector(&mOutgoing);
+        VLOG("%d atoms, proto size: %zu", mBatchedAtomCount, frameSize);
     }
     mProto.clear();
+    mBatchedAtomCount = 0;
+    mBatchStartElapsedMillis = nowMillis;
+
+    drainOutputLocked();
+}
+
+void ShellSubscriber::drainOutputLocked() {
+    while (!mOutgoing.empty()) {
+        ssize_t written = write(mOutput, mOutgoing.data(), mOutgoing.size());
+        if (written > 0) {
+            mOutgoing.erase(mOutgoing.begin(), mOutgoing.begin() + written);
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // The shell is not reading fast enough; keep the rest queued.
+            return;
+        } else {
+            // Broken pipe or other unrecoverable error; binderDied() will
+            // clean the subscription up.
+            mOutgoing.clear();
+            return;
+        }
+    }
+}
+
+void ShellSubscriber::startFlush(int64_t token) {
+    while (1) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kMaxBatchDelayMillis));
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mFlushToken != token) {
+            VLOG("Flushing thread %lld done!", (long long)token);
+            return;
+        }
+        int64_t nowMillis = getElapsedRealtimeMillis();
+        if (mBatchedAtomCount > 0 &&
+            nowMillis - mBatchStartElapsedMillis >= kMaxBatchDelayMillis) {
+            flushBatchLocked(nowMillis);
+        } else {
+            drainOutputLocked();
+        }
+    }
 }
 
 void ShellSubscriber::startPull(int64_t token, int64_t intervalMillis) {
@@ -193,6 +284,11 @@ void ShellSubscriber::cleanUpLocked() {
     mPushedMatchers.clear();
     mPulledInfo.clear();
     mPullToken = 0;
+    mFlushToken = 0;
+    mProto.clear();
+    mBatchedAtomCount = 0;
+    mOutgoing.clear();
+    mDroppedAtomCount = 0;
     VLOG("done clean up");
 }
 
@@ -205,17 +301,18 @@ void ShellSubscriber::onLogEvent(const LogEvent& event) {
     for (const auto& matcher : mPushedMatchers) {
         if (matchesSimple(*mUidMap, matcher, event)) {
             VLOG("%s", event.ToString().c_str());
+            if (mBatchedAtomCount == 0) {
+                mBatchStartElapsedMillis = getElapsedRealtimeMillis();
+            }
+            mBatchedAtomCount++;
             uint64_t atomToken = mProto.start(util::FIELD_TYPE_MESSAGE |
                                               util::FIELD_COUNT_REPEATED | FIELD_ID_ATOM);
             event.ToProto(mProto);
             mProto.end(atomToken);
-            // First write the payload size.
-            size_t bufferSize = mProto.size();
-            write(mOutput, &bufferSize, sizeof(bufferSize));
-
-            // Then write the payload.
-            mProto.flush(mOutput);
-            mProto.clear();
+            // Flush by size here; the flusher thread covers the age bound.
+            if (mProto.bytesWritten() >= kMaxBatchBytes) {
+                flushBatchLocked(getElapsedRealtimeMillis());
+            }
             break;
         }
     }
@@ -54,6 +54,11 @@ namespace statsd {
  * The stream would be in the following format:
  * |size_t|shellData proto|size_t|shellData proto|....
  *
+ * Matched atoms are batched: a ShellData message is sent once enough bytes have
+ * accumulated or its oldest atom reaches an age bound. Writes to the output fd are
+ * non-blocking; if the client cannot keep up, whole batches are dropped and the count
+ * of dropped atoms is reported in the next ShellData that gets through.
+ *
  * Only one shell subscriber allowed at a time, because each shell subscriber blocks one thread
  * until it exits.
  */
@@ -87,17 +92,35 @@ private:
 
     void startPull(int64_t token, int64_t intervalMillis);
 
+    void startFlush(int64_t token);
+
     void cleanUpLocked();
 
     void writeToOutputLocked(const vector<std::shared_ptr<LogEvent>>& data,
                              const SimpleAtomMatcher& matcher);
 
+    void flushBatchLocked(int64_t nowMillis);
+
+    void drainOutputLocked();
+
     sp<UidMap> mUidMap;
 
     sp<StatsPullerManager> mPullerMgr;
 
+    // Accumulates matched atoms until the batch is flushed by size or by age.
     android::util::ProtoOutputStream mProto;
 
+    int mBatchedAtomCount = 0;
+
+    int64_t mBatchStartElapsedMillis = 0;
+
+    // Framed ShellData bytes the output fd has not accepted yet. The fd is
+    // non-blocking; once this queue is full, whole batches are dropped and
+    // accounted for in the next ShellData that does get through.
+    std::vector<uint8_t> mOutgoing;
+
+    int64_t mDroppedAtomCount = 0;
+
     mutable std::mutex mMutex;
 
     std::condition_variable mShellDied;  // semaphore for waiting until shell exits.
@@ -113,6 +136,8 @@ private:
     std::vector<PullInfo> mPulledInfo;
 
     int64_t mPullToken = 0;  // A unique token to identify a puller thread.
+
+    int64_t mFlushToken = 0;  // A unique token to identify a flusher thread.
 };
 
 }  // namespace statsd
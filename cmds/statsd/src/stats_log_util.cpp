@@ -72,6 +72,8 @@ const int FIELD_ID_STATS_COMPANION_BINDER_TRANSACTION_FAILED = 14;
 const int FIELD_ID_EMPTY_DATA = 15;
 const int FIELD_ID_PULL_REGISTERED_COUNT = 16;
 const int FIELD_ID_PULL_UNREGISTERED_COUNT = 17;
+const int FIELD_ID_STALE_DATA_SERVED = 18;
+const int FIELD_ID_PULL_TIME_HISTOGRAM = 19;
 // for AtomMetricStats proto
 const int FIELD_ID_ATOM_METRIC_STATS = 17;
 const int FIELD_ID_METRIC_ID = 1;
@@ -488,6 +490,11 @@ void writePullerStatsToStream(const std::pair<int, StatsdStats::PulledAtomStats>
                        (long long) pair.second.registeredCount);
     protoOutput->write(FIELD_TYPE_INT64 | FIELD_ID_PULL_UNREGISTERED_COUNT,
                        (long long) pair.second.unregisteredCount);
+    protoOutput->write(FIELD_TYPE_INT64 | FIELD_ID_STALE_DATA_SERVED,
+                       (long long) pair.second.staleDataServed);
+    protoOutput->writeRepeated(FIELD_TYPE_INT64 | FIELD_COUNT_REPEATED | FIELD_ID_PULL_TIME_HISTOGRAM,
+                               pair.second.pullTimeHistogram,
+                               StatsdStats::kNumPullTimeHistogramBuckets);
     protoOutput->end(token);
 }
 
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "HashableDimensionKey.h"
+#include "flat_dim_map.h"
 
 #include <unordered_map>
 
@@ -29,7 +30,7 @@ const MetricDimensionKey DEFAULT_METRIC_DIMENSION_KEY = MetricDimensionKey();
 
 typedef std::map<int64_t, HashableDimensionKey> ConditionKey;
 
-typedef std::unordered_map<MetricDimensionKey, int64_t> DimToValMap;
+typedef flat_dim_map<int64_t> DimToValMap;
 
 }  // namespace statsd
 }  // namespace os
@@ -25,6 +25,7 @@
 #include <android-base/file.h>
 #include <dirent.h>
 #include <private/android_filesystem_config.h>
+#include <zlib.h>
 #include <fstream>
 #include <iostream>
 
@@ -48,6 +49,21 @@ using std::map;
 // Magic word at the start of the train info file, change this if changing the file format
 const uint32_t TRAIN_INFO_FILE_MAGIC = 0xff7447ff;
 
+// Magic word at the start of each report record in a data file, change this if changing the
+// record format. Data files that do not begin with it hold a single raw ConfigMetricsReport
+// written before the record format existed.
+const uint32_t DATA_RECORD_MAGIC = 0xff7d54ff;
+
+// Each report appended to a data file is deflated and framed by this header.
+struct DataRecordHeader {
+    uint32_t mMagic;
+    uint32_t mRawSize;
+    uint32_t mCompressedSize;
+};
+
+// Chunk size used to stream record payloads between the disk and the output proto.
+const size_t kRecordIoChunkBytes = 16 * 1024;
+
 // for ConfigMetricsReportList
 const int FIELD_ID_REPORTS = 2;
 
@@ -125,6 +141,42 @@ void StorageManager::writeFile(const char* file, const void* buffer, int numByte
     close(fd);
 }
 
+void StorageManager::appendDataRecord(const char* file, const void* buffer, int numBytes) {
+    int fd = open(file, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+        VLOG("Attempt to access %s but failed", file);
+        return;
+    }
+    trimToFit(STATS_SERVICE_DIR);
+    trimToFit(STATS_DATA_DIR);
+
+    uLongf compressedSize = compressBound(numBytes);
+    unique_ptr<uint8_t[]> compressed(new uint8_t[compressedSize]);
+    if (compress(compressed.get(), &compressedSize, (const Bytef*)buffer, numBytes) != Z_OK) {
+        ALOGE("Failed to compress report record for %s", file);
+        close(fd);
+        return;
+    }
+
+    DataRecordHeader header;
+    header.mMagic = DATA_RECORD_MAGIC;
+    header.mRawSize = numBytes;
+    header.mCompressedSize = compressedSize;
+    if (android::base::WriteFully(fd, &header, sizeof(header)) &&
+        android::base::WriteFully(fd, compressed.get(), compressedSize)) {
+        VLOG("Successfully appended record to %s", file);
+    } else {
+        ALOGE("Failed to append record to %s", file);
+    }
+
+    int result = fchown(fd, AID_STATSD, AID_STATSD);
+    if (result) {
+        VLOG("Failed to chown %s to statsd", file);
+    }
+
+    close(fd);
+}
+
 bool StorageManager::writeTrainInfo(int64_t trainVersionCode, const std::string& trainName,
                                     int32_t status, const std::vector<int64_t>& experimentIds) {
     std::lock_guard<std::mutex> lock(sTrainInfoMutex);
@@ -406,6 +458,99 @@ bool StorageManager::hasConfigMetricsReport(const ConfigKey& key) {
     return false;
 }
 
+// Inflates one record's payload from fd into the proto as a repeated reports field,
+// pulling the bytes through small stack buffers so report assembly never holds a whole
+// report in memory. The field length is committed to the proto up front, so on a
+// truncated or corrupt record the remainder is zero-filled to keep the output framing
+// intact. Returns false if the rest of the file should not be trusted.
+static bool inflateRecordToProto(int fd, const DataRecordHeader& header,
+                                 ProtoOutputStream* proto) {
+    proto->writeLengthDelimitedHeader(FIELD_ID_REPORTS, header.mRawSize);
+
+    uint8_t inBuf[kRecordIoChunkBytes];
+    uint8_t outBuf[kRecordIoChunkBytes];
+    uint32_t produced = 0;
+    uint32_t compressedLeft = header.mCompressedSize;
+    z_stream stream = {};
+    bool ok = inflateInit(&stream) == Z_OK;
+    int zResult = Z_OK;
+    while (ok && compressedLeft > 0 && zResult != Z_STREAM_END) {
+        const size_t want =
+                compressedLeft < kRecordIoChunkBytes ? compressedLeft : kRecordIoChunkBytes;
+        ssize_t n = TEMP_FAILURE_RETRY(read(fd, inBuf, want));
+        if (n <= 0) {
+            ok = false;
+            break;
+        }
+        compressedLeft -= n;
+        stream.next_in = inBuf;
+        stream.avail_in = n;
+        do {
+            stream.next_out = outBuf;
+            stream.avail_out = sizeof(outBuf);
+            zResult = inflate(&stream, Z_NO_FLUSH);
+            if (zResult != Z_OK && zResult != Z_STREAM_END) {
+                ok = false;
+                break;
+            }
+            uint32_t got = sizeof(outBuf) - stream.avail_out;
+            if (got > header.mRawSize - produced) {
+                // Inflated past the size the header promised.
+                got = header.mRawSize - produced;
+                ok = false;
+            }
+            for (uint32_t i = 0; i < got; i++) {
+                proto->writeRawByte(outBuf[i]);
+            }
+            produced += got;
+        } while (ok && (stream.avail_in > 0 || stream.avail_out == 0));
+    }
+    if (ok) {
+        ok = zResult == Z_STREAM_END && produced == header.mRawSize;
+    }
+    if (ok && compressedLeft > 0) {
+        // Leave the fd on the next record boundary even if the deflate stream
+        // ended short of the recorded payload size.
+        lseek(fd, compressedLeft, SEEK_CUR);
+    }
+    inflateEnd(&stream);
+    for (; produced < header.mRawSize; produced++) {
+        proto->writeRawByte(0);
+    }
+    return ok;
+}
+
+// Appends every report in an open data file to the proto. Record-framed files are
+// streamed record by record; files from before the record format hold one raw report
+// and are appended whole, as they always were.
+static void appendDataFile(const char* fullPathName, int fd, ProtoOutputStream* proto) {
+    DataRecordHeader header;
+    ssize_t n = TEMP_FAILURE_RETRY(read(fd, &header, sizeof(header)));
+    if (n != (ssize_t)sizeof(header) || header.mMagic != DATA_RECORD_MAGIC) {
+        lseek(fd, 0, SEEK_SET);
+        string content;
+        if (android::base::ReadFdToString(fd, &content)) {
+            proto->write(FIELD_TYPE_MESSAGE | FIELD_COUNT_REPEATED | FIELD_ID_REPORTS,
+                         content.c_str(), content.size());
+        }
+        return;
+    }
+    do {
+        if (header.mRawSize > (uint32_t)StatsdStats::kMaxFileSize ||
+            header.mCompressedSize > (uint32_t)StatsdStats::kMaxFileSize) {
+            ALOGE("Implausible record header in %s, dropping the rest of the file",
+                  fullPathName);
+            return;
+        }
+        if (!inflateRecordToProto(fd, header, proto)) {
+            ALOGE("Truncated or corrupt record in %s, dropping the rest of the file",
+                  fullPathName);
+            return;
+        }
+    } while (TEMP_FAILURE_RETRY(read(fd, &header, sizeof(header))) == (ssize_t)sizeof(header) &&
+             header.mMagic == DATA_RECORD_MAGIC);
+}
+
 void StorageManager::appendConfigMetricsReport(const ConfigKey& key, ProtoOutputStream* proto,
                                                bool erase_data, bool isAdb) {
     unique_ptr<DIR, decltype(&closedir)> dir(opendir(STATS_DATA_DIR), closedir);
@@ -430,11 +575,7 @@ void StorageManager::appendConfigMetricsReport(const ConfigKey& key, ProtoOutput
         auto fullPathName = StringPrintf("%s/%s", STATS_DATA_DIR, fileName.c_str());
         int fd = open(fullPathName.c_str(), O_RDONLY | O_CLOEXEC);
         if (fd != -1) {
-            string content;
-            if (android::base::ReadFdToString(fd, &content)) {
-                proto->write(FIELD_TYPE_MESSAGE | FIELD_COUNT_REPEATED | FIELD_ID_REPORTS,
-                             content.c_str(), content.size());
-            }
+            appendDataFile(fullPathName.c_str(), fd, proto);
             close(fd);
         } else {
             ALOGE("file cannot be opened");
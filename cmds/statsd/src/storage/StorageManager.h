@@ -49,6 +49,15 @@ public:
      */
     static void writeFile(const char* file, const void* buffer, int numBytes);
 
+    /**
+     * Appends a serialized ConfigMetricsReport to the given data file as a
+     * compressed record. Data files grow append-only: writing a report for a
+     * config whose file already exists adds a record instead of rewriting the
+     * file, and an interrupted write can only lose the record being appended.
+     * appendConfigMetricsReport() streams the records back out.
+     */
+    static void appendDataRecord(const char* file, const void* buffer, int numBytes);
+
     /**
      * Writes train info.
      */
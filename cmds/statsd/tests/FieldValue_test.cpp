@@ -480,6 +480,54 @@ TEST(AtomMatcherTest, TestWriteAtomToProto) {
     EXPECT_EQ(999, atom.num_results());
 }
 
+TEST(MetricDimensionKeyTest, TestInternedHandles) {
+    int pos[] = {1, 1, 1};
+    Field field(10, pos, 0);
+
+    HashableDimensionKey dim;
+    dim.addValue(FieldValue(field, Value(10006)));
+    HashableDimensionKey sameDim;
+    sameDim.addValue(FieldValue(field, Value(10006)));
+    HashableDimensionKey otherDim;
+    otherDim.addValue(FieldValue(field, Value(10007)));
+
+    MetricDimensionKey key1(dim, DEFAULT_DIMENSION_KEY);
+    MetricDimensionKey key2(sameDim, DEFAULT_DIMENSION_KEY);
+    MetricDimensionKey key3(otherDim, DEFAULT_DIMENSION_KEY);
+
+    // Equal contents intern to the same handle; different contents don't.
+    EXPECT_EQ(key1.getWhatHandle(), key2.getWhatHandle());
+    EXPECT_NE(key1.getWhatHandle(), key3.getWhatHandle());
+    EXPECT_EQ(key1.getConditionHandle(), key3.getConditionHandle());
+    EXPECT_TRUE(key1 == key2);
+    EXPECT_FALSE(key1 == key3);
+
+    // Copies share the interned instance rather than the contents.
+    MetricDimensionKey copy = key1;
+    EXPECT_EQ(key1.getWhatHandle(), copy.getWhatHandle());
+    EXPECT_TRUE(copy == key1);
+}
+
+TEST(MetricDimensionKeyTest, TestInternEviction) {
+    int pos[] = {1, 1, 1};
+    Field field(10, pos, 0);
+
+    HashableDimensionKey dim;
+    dim.addValue(FieldValue(field, Value(20006)));
+
+    uintptr_t firstHandle;
+    {
+        MetricDimensionKey key(dim, DEFAULT_DIMENSION_KEY);
+        firstHandle = key.getWhatHandle();
+        // While a reference is live, re-interning returns the same instance.
+        MetricDimensionKey again(dim, DEFAULT_DIMENSION_KEY);
+        EXPECT_EQ(firstHandle, again.getWhatHandle());
+    }
+    // The entry was evicted with its last reference, so a fresh intern must
+    // still produce a key that behaves correctly.
+    MetricDimensionKey reborn(dim, DEFAULT_DIMENSION_KEY);
+    EXPECT_EQ(dim, reborn.getDimensionKeyInWhat());
+}
 
 }  // namespace statsd
 }  // namespace os
@@ -19,6 +19,7 @@
 #include <thread>
 #include <vector>
 #include "../metrics/metrics_test_helper.h"
+#include "src/external/StatsPullerManager.h"
 #include "src/stats_log_util.h"
 #include "tests/statsd_test_util.h"
 
@@ -201,6 +202,59 @@ TEST_F(StatsPullerTest, PullTooFast) {
     EXPECT_EQ(33, dataHolder[0]->getValues()[0].mValue.int_value);
 }
 
+// A pull that misses its deadline serves the last good data instead.
+TEST_F(StatsPullerTest, PullTimeoutServesLastGoodData) {
+    pullData.push_back(createSimpleEvent(1111L, 33));
+    pullSuccess = true;
+
+    vector<std::shared_ptr<LogEvent>> dataHolder;
+    EXPECT_TRUE(puller.Pull(&dataHolder));
+    EXPECT_EQ(1, dataHolder.size());
+    EXPECT_EQ(33, dataHolder[0]->getValues()[0].mValue.int_value);
+
+    sleep_for(std::chrono::seconds(1));
+
+    pullData.clear();
+    pullData.push_back(createSimpleEvent(2222L, 44));
+
+    pullSuccess = true;
+    // timeout is 0.5
+    pullDelayNs = (long)(0.8 * NS_PER_SEC);
+
+    dataHolder.clear();
+    EXPECT_TRUE(puller.Pull(&dataHolder));
+    // The slow data is discarded; the previous good data comes back instead.
+    EXPECT_EQ(1, dataHolder.size());
+    EXPECT_EQ(33, dataHolder[0]->getValues()[0].mValue.int_value);
+}
+
+TEST_F(StatsPullerTest, PullTimeoutOutsideStaleWindow) {
+    auto& pullInfo = StatsPullerManager::kAllPullAtomInfo.at(pullTagId);
+    const int64_t savedStaleWindowNs = pullInfo.staleDataWindowNs;
+    pullInfo.staleDataWindowNs = NS_PER_SEC / 2;
+
+    pullData.push_back(createSimpleEvent(1111L, 33));
+    pullSuccess = true;
+
+    vector<std::shared_ptr<LogEvent>> dataHolder;
+    EXPECT_TRUE(puller.Pull(&dataHolder));
+
+    sleep_for(std::chrono::seconds(1));
+
+    pullData.clear();
+    pullData.push_back(createSimpleEvent(2222L, 44));
+
+    pullSuccess = true;
+    pullDelayNs = (long)(0.8 * NS_PER_SEC);
+
+    // The last good data is older than the stale window, so nothing is served.
+    dataHolder.clear();
+    EXPECT_FALSE(puller.Pull(&dataHolder));
+    EXPECT_EQ(0, dataHolder.size());
+
+    pullInfo.staleDataWindowNs = savedStaleWindowNs;
+}
+
 TEST_F(StatsPullerTest, PullFailsAndTooFast) {
     pullData.push_back(createSimpleEvent(1111L, 33));
 
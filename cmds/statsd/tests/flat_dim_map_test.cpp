@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/flat_dim_map.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+using namespace android::os::statsd;
+
+namespace {
+MetricDimensionKey makeKey(int value) {
+    int pos[] = {1, 1, 1};
+    HashableDimensionKey dim;
+    dim.addValue(FieldValue(Field(1, pos, 0), Value(value)));
+    return MetricDimensionKey(dim, HashableDimensionKey());
+}
+}  // namespace
+
+#ifdef __ANDROID__
+TEST(flat_dim_map, insert_find_and_subscript) {
+    flat_dim_map<int64_t> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(0u, map.size());
+    EXPECT_TRUE(map.find(makeKey(1)) == map.end());
+
+    map[makeKey(1)] = 10;
+    map[makeKey(2)] = 20;
+    EXPECT_EQ(2u, map.size());
+    EXPECT_EQ(10, map.find(makeKey(1))->second);
+    map[makeKey(1)] += 5;
+    EXPECT_EQ(15, map.find(makeKey(1))->second);
+
+    auto result = map.insert({makeKey(2), 99});
+    EXPECT_FALSE(result.second);
+    EXPECT_EQ(20, result.first->second);
+    result = map.insert({makeKey(3), 30});
+    EXPECT_TRUE(result.second);
+    EXPECT_EQ(3u, map.size());
+}
+
+TEST(flat_dim_map, iteration_covers_all_entries) {
+    flat_dim_map<int64_t> map;
+    const int kCount = 100;  // forces several growths past the initial table
+    for (int i = 0; i < kCount; i++) {
+        map[makeKey(i)] = i;
+    }
+    EXPECT_EQ((size_t)kCount, map.size());
+
+    std::set<int64_t> seen;
+    for (const auto& entry : map) {
+        seen.insert(entry.second);
+    }
+    EXPECT_EQ((size_t)kCount, seen.size());
+}
+
+TEST(flat_dim_map, erase_while_iterating) {
+    flat_dim_map<int64_t> map;
+    for (int i = 0; i < 50; i++) {
+        map[makeKey(i)] = i;
+    }
+    // Erase odd values mid-iteration; every entry must be visited exactly once.
+    size_t visited = 0;
+    for (auto it = map.begin(); it != map.end();) {
+        visited++;
+        if (it->second % 2 == 1) {
+            it = map.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    EXPECT_EQ(50u, visited);
+    EXPECT_EQ(25u, map.size());
+    for (int i = 0; i < 50; i++) {
+        EXPECT_EQ(i % 2 == 0, map.find(makeKey(i)) != map.end());
+    }
+
+    // Tombstones left by the erases must not break further inserts.
+    for (int i = 50; i < 100; i++) {
+        map[makeKey(i)] = i;
+    }
+    EXPECT_EQ(75u, map.size());
+}
+
+TEST(flat_dim_map, clear_and_copy) {
+    flat_dim_map<int64_t> map;
+    map[makeKey(1)] = 1;
+    map[makeKey(2)] = 2;
+
+    flat_dim_map<int64_t> copy = map;
+    map.clear();
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(2u, copy.size());
+    EXPECT_EQ(2, copy.find(makeKey(2))->second);
+
+    // A cleared map stays usable.
+    map[makeKey(3)] = 3;
+    EXPECT_EQ(1u, map.size());
+}
+#else
+GTEST_LOG_(INFO) << "This test does nothing.\n";
+#endif
@@ -302,6 +302,7 @@ TEST(StatsdStatsTest, TestPullAtomStats) {
     stats.notePullerCallbackRegistrationChanged(android::util::DISK_SPACE, true);
     stats.notePullerCallbackRegistrationChanged(android::util::DISK_SPACE, false);
     stats.notePullerCallbackRegistrationChanged(android::util::DISK_SPACE, true);
+    stats.notePullStaleDataServed(android::util::DISK_SPACE);
 
 
     vector<uint8_t> output;
@@ -322,6 +323,12 @@ TEST(StatsdStatsTest, TestPullAtomStats) {
     EXPECT_EQ(3335L, report.pulled_atom_stats(0).max_pull_delay_nanos());
     EXPECT_EQ(2L, report.pulled_atom_stats(0).registered_count());
     EXPECT_EQ(1L, report.pulled_atom_stats(0).unregistered_count());
+    EXPECT_EQ(1L, report.pulled_atom_stats(0).stale_data_served());
+    EXPECT_EQ((int)StatsdStats::kNumPullTimeHistogramBuckets,
+              report.pulled_atom_stats(0).pull_time_histogram_size());
+    // Both recorded pull times are sub-1ms, so they land in the first bucket.
+    EXPECT_EQ(2L, report.pulled_atom_stats(0).pull_time_histogram(0));
+    EXPECT_EQ(0L, report.pulled_atom_stats(0).pull_time_histogram(1));
 }
 
 TEST(StatsdStatsTest, TestAtomMetricsStats) {
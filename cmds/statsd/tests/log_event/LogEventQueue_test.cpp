@@ -17,6 +17,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <thread>
+#include <vector>
 
 #include <stdio.h>
 
@@ -44,51 +45,85 @@ TEST(LogEventQueue_test, TestGoodConsumer) {
     });
 
     std::thread reader([&queue, timeBaseNs] {
-        for (int i = 0; i < 100; i++) {
-            auto event = queue.waitPop();
-            EXPECT_TRUE(event != nullptr);
-            // All events are in right order.
-            EXPECT_EQ(timeBaseNs + i * 1000, event->GetElapsedTimestampNs());
+        int read = 0;
+        std::vector<unique_ptr<LogEvent>> events;
+        while (read < 100) {
+            queue.waitPopAll(&events);
+            for (auto& event : events) {
+                EXPECT_TRUE(event != nullptr);
+                // All events are in right order.
+                EXPECT_EQ(timeBaseNs + read * 1000, event->GetElapsedTimestampNs());
+                read++;
+            }
+            events.clear();
         }
     });
 
     reader.join();
     writer.join();
+    EXPECT_EQ(0, queue.getDroppedCount());
 }
 
 TEST(LogEventQueue_test, TestSlowConsumer) {
     LogEventQueue queue(50);
     int64_t timeBaseNs = 100;
-    std::thread writer([&queue, timeBaseNs] {
-        int failure_count = 0;
-        int64_t oldestEventNs;
-        for (int i = 0; i < 100; i++) {
-            bool success = queue.push(std::make_unique<LogEvent>(10, timeBaseNs + i * 1000),
-                                      &oldestEventNs);
-            if (!success) failure_count++;
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
-        }
+    // The consumer is stuck (not reading at all), so only the first 50 events
+    // fit in the ring and the rest are dropped and counted.
+    int failure_count = 0;
+    int64_t oldestEventNs = 0;
+    for (int i = 0; i < 100; i++) {
+        bool success =
+                queue.push(std::make_unique<LogEvent>(10, timeBaseNs + i * 1000), &oldestEventNs);
+        if (!success) failure_count++;
+    }
 
-        // There is some remote chance that reader thread not get chance to run before writer thread
-        // ends. That's why the following comparison is not "==".
-        // There will be at least 45 events lost due to overflow.
-        EXPECT_TRUE(failure_count >= 45);
-        // The oldest event must be at least the 6th event.
-        EXPECT_TRUE(oldestEventNs <= (100 + 5 * 1000));
-    });
+    EXPECT_EQ(50, failure_count);
+    EXPECT_EQ(50, queue.getDroppedCount());
+    // Nothing has been processed, so the oldest pending history is the first
+    // event that made it into the ring.
+    EXPECT_EQ(timeBaseNs, oldestEventNs);
 
-    std::thread reader([&queue, timeBaseNs] {
-        // The consumer quickly processed 5 events, then it got stuck (not reading anymore).
-        for (int i = 0; i < 5; i++) {
-            auto event = queue.waitPop();
-            EXPECT_TRUE(event != nullptr);
-            // All events are in right order.
-            EXPECT_EQ(timeBaseNs + i * 1000, event->GetElapsedTimestampNs());
-        }
-    });
+    // Draining frees the slots for further pushes.
+    std::vector<unique_ptr<LogEvent>> events;
+    queue.waitPopAll(&events);
+    EXPECT_EQ(50u, events.size());
+    // All events are in right order.
+    for (int i = 0; i < 50; i++) {
+        EXPECT_EQ(timeBaseNs + i * 1000, events[i]->GetElapsedTimestampNs());
+    }
+    EXPECT_TRUE(queue.push(std::make_unique<LogEvent>(10, timeBaseNs + 100 * 1000),
+                           &oldestEventNs));
+    EXPECT_EQ(50, queue.getDroppedCount());
+}
 
-    reader.join();
-    writer.join();
+TEST(LogEventQueue_test, TestMultipleProducers) {
+    constexpr int kProducers = 4;
+    constexpr int kEventsPerProducer = 2000;
+    LogEventQueue queue(kProducers * kEventsPerProducer);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < kEventsPerProducer; i++) {
+                int64_t oldestEventNs;
+                queue.push(std::make_unique<LogEvent>(p, i + 1), &oldestEventNs);
+            }
+        });
+    }
+
+    int received = 0;
+    std::vector<unique_ptr<LogEvent>> events;
+    while (received < kProducers * kEventsPerProducer) {
+        queue.waitPopAll(&events);
+        received += events.size();
+        events.clear();
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    // The ring was sized for every event, so none may have been dropped.
+    EXPECT_EQ(kProducers * kEventsPerProducer, received);
+    EXPECT_EQ(0, queue.getDroppedCount());
 }
 
 #else
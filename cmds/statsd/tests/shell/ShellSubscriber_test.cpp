@@ -154,6 +154,37 @@ TEST(ShellSubscriberTest, testPushedSubscription) {
     runShellTest(config, uidMap, pullerManager, pushedList, shellData);
 }
 
+TEST(ShellSubscriberTest, testPushedSubscriptionBatchesAtoms) {
+    sp<MockUidMap> uidMap = new NaggyMock<MockUidMap>();
+
+    sp<MockStatsPullerManager> pullerManager = new StrictMock<MockStatsPullerManager>();
+    vector<std::shared_ptr<LogEvent>> pushedList;
+
+    // Two events logged back to back should be delivered in a single frame.
+    std::shared_ptr<LogEvent> event1 =
+            std::make_shared<LogEvent>(29 /*screen_state_atom_id*/, 1000 /*timestamp*/);
+    event1->write(::android::view::DisplayStateEnum::DISPLAY_STATE_ON);
+    event1->init();
+    pushedList.push_back(event1);
+
+    std::shared_ptr<LogEvent> event2 =
+            std::make_shared<LogEvent>(29 /*screen_state_atom_id*/, 2000 /*timestamp*/);
+    event2->write(::android::view::DisplayStateEnum::DISPLAY_STATE_OFF);
+    event2->init();
+    pushedList.push_back(event2);
+
+    ShellSubscription config;
+    config.add_pushed()->set_atom_id(29);
+
+    ShellData shellData;
+    shellData.add_atom()->mutable_screen_state_changed()->set_state(
+            ::android::view::DisplayStateEnum::DISPLAY_STATE_ON);
+    shellData.add_atom()->mutable_screen_state_changed()->set_state(
+            ::android::view::DisplayStateEnum::DISPLAY_STATE_OFF);
+
+    runShellTest(config, uidMap, pullerManager, pushedList, shellData);
+}
+
 namespace {
 
 int kUid1 = 1000;
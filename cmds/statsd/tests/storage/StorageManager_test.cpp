@@ -15,6 +15,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <stdio.h>
+#include <algorithm>
 #include "src/storage/StorageManager.h"
 
 #ifdef __ANDROID__
@@ -209,6 +210,34 @@ TEST(StorageManagerTest, AppendConfigReportTest3) {
     clearLocalHistoryTestFiles();
 }
 
+TEST(StorageManagerTest, CompressedRecordRoundTrip) {
+    const string reportFile = testDir + "2557169500_1066_1";
+    TEMP_FAILURE_RETRY(remove(reportFile.c_str()));
+
+    // Two appends to the same file must come back as two repeated reports
+    // fields, in append order.
+    string report1(1000, 'a');
+    report1 += "first-report-marker";
+    const string report2 = "second-report-marker";
+    StorageManager::appendDataRecord(reportFile.c_str(), report1.data(), report1.size());
+    StorageManager::appendDataRecord(reportFile.c_str(), report2.data(), report2.size());
+
+    ProtoOutputStream out;
+    StorageManager::appendConfigMetricsReport(ConfigKey(1066, 1), &out, true /*erase?*/,
+                                              true /*isAdb?*/);
+    EXPECT_FALSE(fileExist(reportFile));
+
+    vector<uint8_t> serialized;
+    out.serializeToVector(&serialized);
+    auto first =
+            std::search(serialized.begin(), serialized.end(), report1.begin(), report1.end());
+    auto second =
+            std::search(serialized.begin(), serialized.end(), report2.begin(), report2.end());
+    EXPECT_TRUE(first != serialized.end());
+    EXPECT_TRUE(second != serialized.end());
+    EXPECT_TRUE(first < second);
+}
+
 TEST(StorageManagerTest, AppendConfigReportTest4) {
     EXPECT_TRUE(prepareLocalHistoryTestFiles());
 
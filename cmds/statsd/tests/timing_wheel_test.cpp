@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "src/anomaly/timing_wheel.h"
+
+#include <gtest/gtest.h>
+
+using namespace android::os::statsd;
+
+/** struct for template in timing_wheel */
+struct WheelEntry : public RefBase {
+    explicit WheelEntry(uint32_t timestampSec) : timestampSec(timestampSec) {
+    }
+
+    const uint32_t timestampSec;
+};
+
+using Fired = std::unordered_set<sp<const WheelEntry>, SpHash<WheelEntry>>;
+
+#ifdef __ANDROID__
+TEST(timing_wheel, empty_and_size) {
+    timing_wheel<WheelEntry> wheel;
+    sp<const WheelEntry> e4 = new WheelEntry(4);
+    sp<const WheelEntry> e8 = new WheelEntry(8);
+
+    EXPECT_EQ(0u, wheel.size());
+    EXPECT_TRUE(wheel.empty());
+
+    wheel.push(e4);
+    EXPECT_EQ(1u, wheel.size());
+    EXPECT_FALSE(wheel.empty());
+
+    wheel.push(e8);
+    EXPECT_EQ(2u, wheel.size());
+
+    // Pushing the same entry again does nothing.
+    wheel.push(e4);
+    EXPECT_EQ(2u, wheel.size());
+
+    EXPECT_TRUE(wheel.remove(e4));
+    EXPECT_EQ(1u, wheel.size());
+    EXPECT_FALSE(wheel.remove(e4));
+
+    EXPECT_TRUE(wheel.remove(e8));
+    EXPECT_EQ(0u, wheel.size());
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timing_wheel, top) {
+    timing_wheel<WheelEntry> wheel;
+    EXPECT_EQ(wheel.top(), nullptr);
+
+    // Entries scattered over different levels of the wheel.
+    sp<const WheelEntry> soon = new WheelEntry(1000100);
+    sp<const WheelEntry> later = new WheelEntry(1000100 + 500);
+    sp<const WheelEntry> muchLater = new WheelEntry(1000100 + 100000);
+
+    wheel.push(muchLater);
+    EXPECT_EQ(wheel.top(), muchLater);
+    wheel.push(later);
+    EXPECT_EQ(wheel.top(), later);
+    wheel.push(soon);
+    EXPECT_EQ(wheel.top(), soon);
+
+    wheel.remove(soon);
+    EXPECT_EQ(wheel.top(), later);
+    wheel.remove(later);
+    EXPECT_EQ(wheel.top(), muchLater);
+    wheel.remove(muchLater);
+    EXPECT_EQ(wheel.top(), nullptr);
+}
+
+TEST(timing_wheel, pop_sooner_than) {
+    timing_wheel<WheelEntry> wheel;
+    const uint32_t base = 2000000;
+    sp<const WheelEntry> e1 = new WheelEntry(base + 10);
+    sp<const WheelEntry> e2 = new WheelEntry(base + 300);
+    sp<const WheelEntry> e3 = new WheelEntry(base + 70000);
+    wheel.push(e1);
+    wheel.push(e2);
+    wheel.push(e3);
+
+    Fired fired;
+    wheel.popSoonerThan(base + 5, &fired);
+    EXPECT_TRUE(fired.empty());
+
+    wheel.popSoonerThan(base + 10, &fired);
+    EXPECT_EQ(1u, fired.size());
+    EXPECT_EQ(1u, fired.count(e1));
+    EXPECT_EQ(2u, wheel.size());
+
+    // A large jump cascades through every level it crosses.
+    fired.clear();
+    wheel.popSoonerThan(base + 100000, &fired);
+    EXPECT_EQ(2u, fired.size());
+    EXPECT_EQ(1u, fired.count(e2));
+    EXPECT_EQ(1u, fired.count(e3));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(timing_wheel, overdue_push) {
+    timing_wheel<WheelEntry> wheel;
+    const uint32_t base = 3000000;
+    sp<const WheelEntry> future = new WheelEntry(base + 100);
+    wheel.push(future);
+
+    Fired fired;
+    wheel.popSoonerThan(base + 50, &fired);
+    EXPECT_TRUE(fired.empty());
+
+    // Pushed with a timestamp the wheel has already passed; fires on the
+    // next advancement.
+    sp<const WheelEntry> past = new WheelEntry(base + 20);
+    wheel.push(past);
+    EXPECT_EQ(wheel.top(), past);
+    wheel.popSoonerThan(base + 60, &fired);
+    EXPECT_EQ(1u, fired.size());
+    EXPECT_EQ(1u, fired.count(past));
+    EXPECT_EQ(1u, wheel.size());
+}
+
+TEST(timing_wheel, nulls) {
+    timing_wheel<WheelEntry> wheel;
+    wheel.push(nullptr);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_FALSE(wheel.remove(nullptr));
+    EXPECT_FALSE(wheel.contains(nullptr));
+}
+
+TEST(timing_wheel, many_dimensions) {
+    // Exercise a dense population like 50k duration-tracker deadlines.
+    timing_wheel<WheelEntry> wheel;
+    const uint32_t base = 4000000;
+    std::vector<sp<const WheelEntry>> entries;
+    const int kCount = 50000;
+    for (int i = 0; i < kCount; i++) {
+        entries.push_back(new WheelEntry(base + 1 + (i % 90000)));
+        wheel.push(entries.back());
+    }
+    EXPECT_EQ((size_t)kCount, wheel.size());
+
+    Fired fired;
+    wheel.popSoonerThan(base + 45000, &fired);
+    for (const auto& e : fired) {
+        EXPECT_LE(e->timestampSec, base + 45000);
+    }
+    wheel.popSoonerThan(base + 90001, &fired);
+    EXPECT_EQ((size_t)kCount, fired.size());
+    EXPECT_TRUE(wheel.empty());
+}
+#else
+GTEST_LOG_(INFO) << "This test does nothing.\n";
+#endif
@@ -1407,6 +1407,11 @@ typedef void (*RegJAMProc)();
 static int register_jni_procs(const RegJNIRec array[], size_t count, JNIEnv* env)
 {
     for (size_t i = 0; i < count; i++) {
+#ifndef NDEBUG
+        // On debug builds emit one trace slice per module so the expensive
+        // registrants show up individually under RegisterAndroidNatives.
+        ATRACE_NAME(array[i].mName);
+#endif
         if (array[i].mProc(env) < 0) {
 #ifndef NDEBUG
             ALOGD("----------!!! %s failed to load\n", array[i].mName);
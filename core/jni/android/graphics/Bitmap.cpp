@@ -299,6 +299,28 @@ bool unlockPixels(JNIEnv* env, jobject bitmap) {
     return true;
 }
 
+bool getHardwareBuffer(JNIEnv* env, jobject bitmap, AHardwareBuffer** outBuffer) {
+    SkASSERT(env);
+    SkASSERT(bitmap);
+    SkASSERT(outBuffer);
+    SkASSERT(env->IsInstanceOf(bitmap, gBitmap_class));
+    jlong bitmapHandle = env->GetLongField(bitmap, gBitmap_nativePtr);
+
+    LocalScopedBitmap localBitmap(bitmapHandle);
+    if (!localBitmap->valid() || !localBitmap->isHardware()) {
+        return false;
+    }
+
+    GraphicBuffer* buffer = localBitmap->bitmap().graphicBuffer();
+    if (!buffer) {
+        return false;
+    }
+    AHardwareBuffer* hardwareBuffer = AHardwareBuffer_from_GraphicBuffer(buffer);
+    AHardwareBuffer_acquire(hardwareBuffer);
+    *outBuffer = hardwareBuffer;
+    return true;
+}
+
 } // namespace bitmap
 
 } // namespace android
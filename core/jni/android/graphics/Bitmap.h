@@ -21,6 +21,8 @@
 #include <SkBitmap.h>
 #include <SkImageInfo.h>
 
+struct AHardwareBuffer;
+
 namespace android {
 
 class Bitmap;
@@ -49,6 +51,11 @@ void imageInfo(JNIEnv* env, jobject bitmap, AndroidBitmapInfo* info);
 void* lockPixels(JNIEnv* env, jobject bitmap);
 // Returns true if unlocked, false if the bitmap is no longer valid (destroyed)
 bool unlockPixels(JNIEnv* env, jobject bitmap);
+// For hardware bitmaps, stores an acquired reference to the backing
+// AHardwareBuffer in outBuffer and returns true; the caller owns the
+// reference and must release it with AHardwareBuffer_release. Returns false
+// for software bitmaps and invalid/destroyed bitmaps.
+bool getHardwareBuffer(JNIEnv* env, jobject bitmap, AHardwareBuffer** outBuffer);
 
 /** Reinitialize a bitmap. bitmap must already have its SkAlphaType set in
     sync with isPremultiplied
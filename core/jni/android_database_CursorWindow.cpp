@@ -34,6 +34,8 @@
 #include <sys/types.h>
 #include <dirent.h>
 
+#include <mutex>
+
 #undef LOG_NDEBUG
 #define LOG_NDEBUG 1
 
@@ -233,6 +235,74 @@ static jbyteArray nativeGetBlob(JNIEnv* env, jclass clazz, jlong windowPtr,
     return NULL;
 }
 
+// Short string values are overwhelmingly repeated (enum-like columns, booleans
+// stored as text), so they are interned in a small fixed-size table instead of
+// being materialized into a fresh jstring on every read. The table is process
+// global rather than per-window: windows are discarded and refilled on requery
+// while scrolling, which is exactly when the same values recur.
+static constexpr size_t kMaxInternedBytes = 32;
+static constexpr size_t kInternTableSize = 256;
+
+struct InternEntry {
+    uint32_t hash;
+    uint32_t length;
+    char bytes[kMaxInternedBytes];
+    jstring str;
+};
+
+static std::mutex gInternLock;
+static InternEntry gInternTable[kInternTableSize];
+
+static uint32_t hashStringBytes(const char* value, size_t length) {
+    uint32_t hash = 2166136261u; // FNV-1a
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ static_cast<uint8_t>(value[i])) * 16777619u;
+    }
+    return hash;
+}
+
+static jstring getInternedString(JNIEnv* env, const char* value, size_t length) {
+    uint32_t hash = hashStringBytes(value, length);
+    InternEntry& entry = gInternTable[hash % kInternTableSize];
+    {
+        std::lock_guard<std::mutex> lock(gInternLock);
+        if (entry.str && entry.hash == hash && entry.length == length
+                && memcmp(entry.bytes, value, length) == 0) {
+            // Pin the hit with a local ref while still holding the lock, so a
+            // concurrent eviction cannot delete the global ref under us.
+            return jstring(env->NewLocalRef(entry.str));
+        }
+    }
+
+    // Convert to UTF-16 here instead of calling NewStringUTF.  NewStringUTF
+    // doesn't like UTF-8 strings with high codepoints.  It actually expects
+    // Modified UTF-8 with encoded surrogate pairs.
+    String16 utf16(value, length);
+    jstring localStr = env->NewString(reinterpret_cast<const jchar*>(utf16.string()),
+            utf16.size());
+    if (!localStr) {
+        return NULL;
+    }
+    jstring globalStr = jstring(env->NewGlobalRef(localStr));
+    if (!globalStr) {
+        return localStr;
+    }
+
+    jstring evicted;
+    {
+        std::lock_guard<std::mutex> lock(gInternLock);
+        evicted = entry.str;
+        entry.hash = hash;
+        entry.length = length;
+        memcpy(entry.bytes, value, length);
+        entry.str = globalStr;
+    }
+    if (evicted) {
+        env->DeleteGlobalRef(evicted);
+    }
+    return localStr;
+}
+
 static jstring nativeGetString(JNIEnv* env, jclass clazz, jlong windowPtr,
         jint row, jint column) {
     CursorWindow* window = reinterpret_cast<CursorWindow*>(windowPtr);
@@ -255,10 +325,14 @@ static jstring nativeGetString(JNIEnv* env, jclass clazz, jlong windowPtr,
         if (sizeIncludingNull <= 1) {
             return gEmptyString;
         }
+        size_t length = sizeIncludingNull - 1;
+        if (length <= kMaxInternedBytes) {
+            return getInternedString(env, value, length);
+        }
         // Convert to UTF-16 here instead of calling NewStringUTF.  NewStringUTF
         // doesn't like UTF-8 strings with high codepoints.  It actually expects
         // Modified UTF-8 with encoded surrogate pairs.
-        String16 utf16(value, sizeIncludingNull - 1);
+        String16 utf16(value, length);
         return env->NewString(reinterpret_cast<const jchar*>(utf16.string()), utf16.size());
     } else if (type == CursorWindow::FIELD_TYPE_INTEGER) {
         int64_t value = window->getFieldSlotValueLong(fieldSlot);
@@ -281,6 +355,37 @@ static jstring nativeGetString(JNIEnv* env, jclass clazz, jlong windowPtr,
     }
 }
 
+static jobject nativeGetStringView(JNIEnv* env, jclass clazz, jlong windowPtr,
+        jint row, jint column) {
+    CursorWindow* window = reinterpret_cast<CursorWindow*>(windowPtr);
+    LOG_WINDOW("Getting string view for %d,%d from %p", row, column, window);
+
+    CursorWindow::FieldSlot* fieldSlot = window->getFieldSlot(row, column);
+    if (!fieldSlot) {
+        throwExceptionWithRowCol(env, row, column);
+        return NULL;
+    }
+
+    int32_t type = window->getFieldSlotType(fieldSlot);
+    if (type == CursorWindow::FIELD_TYPE_STRING) {
+        size_t sizeIncludingNull;
+        const char* value = window->getFieldSlotValueString(fieldSlot, &sizeIncludingNull);
+        if (!value) {
+            throw_sqlite3_exception(env, "Native could not read string slot");
+            return NULL;
+        }
+        // The buffer aliases the window's own storage and holds the raw UTF-8
+        // bytes without conversion or copy. It is only valid until the window
+        // is cleared or disposed, which the Java side must enforce.
+        return env->NewDirectByteBuffer(const_cast<char*>(value),
+                sizeIncludingNull > 0 ? sizeIncludingNull - 1 : 0);
+    } else if (type == CursorWindow::FIELD_TYPE_NULL) {
+        return NULL;
+    }
+    throw_sqlite3_exception(env, "nativeGetStringView only supports STRING fields");
+    return NULL;
+}
+
 static jcharArray allocCharArrayBuffer(JNIEnv* env, jobject bufferObj, size_t size) {
     jcharArray dataObj = jcharArray(env->GetObjectField(bufferObj,
             gCharArrayBufferClassInfo.data));
@@ -530,6 +635,8 @@ static const JNINativeMethod sMethods[] =
             (void*)nativeGetBlob },
     { "nativeGetString", "(JII)Ljava/lang/String;",
             (void*)nativeGetString },
+    { "nativeGetStringView", "(JII)Ljava/nio/ByteBuffer;",
+            (void*)nativeGetStringView },
     { "nativeCopyStringToBuffer", "(JIILandroid/database/CharArrayBuffer;)V",
             (void*)nativeCopyStringToBuffer },
     { "nativePutBlob", "(J[BII)Z",
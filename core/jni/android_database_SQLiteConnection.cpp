@@ -30,6 +30,11 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
 #include <androidfw/CursorWindow.h>
 
 #include <sqlite3.h>
@@ -58,6 +63,14 @@ namespace android {
  */
 static const int BUSY_TIMEOUT_MS = 2500;
 
+/* Maximum number of idle prepared statements retained per connection for reuse.
+ * Recompiling a statement costs a full SQL parse and code generation pass, so
+ * released statements are kept reset and ready for rebinding instead of being
+ * finalized. The cap bounds the memory spent on statements that are never
+ * prepared again (one-shot DDL and the like).
+ */
+static const size_t STATEMENT_CACHE_CAPACITY = 32;
+
 static struct {
     jfieldID name;
     jfieldID numArgs;
@@ -86,6 +99,14 @@ struct SQLiteConnection {
 
     volatile bool canceled;
 
+    // Idle statements ready for rebinding, most recently released first, keyed by
+    // the UTF-16 SQL text they were prepared from.
+    std::list<std::pair<std::u16string, sqlite3_stmt*>> idleStatements;
+
+    // SQL text of every statement currently handed out to the Java side, so a
+    // released statement can rejoin idleStatements under its original key.
+    std::unordered_map<sqlite3_stmt*, std::u16string> activeStatements;
+
     SQLiteConnection(sqlite3* db, int openFlags, const String8& path, const String8& label) :
         db(db), openFlags(openFlags), path(path), label(label), canceled(false) { }
 };
@@ -191,6 +212,13 @@ static void nativeClose(JNIEnv* env, jclass clazz, jlong connectionPtr) {
 
     if (connection) {
         ALOGV("Closing connection %p", connection->db);
+
+        // Cached idle statements count as unfinalized and would make close fail.
+        for (auto& entry : connection->idleStatements) {
+            sqlite3_finalize(entry.second);
+        }
+        connection->idleStatements.clear();
+
         int err = sqlite3_close(connection->db);
         if (err != SQLITE_OK) {
             // This can happen if sub-objects aren't closed first.  Make sure the caller knows.
@@ -299,9 +327,30 @@ static jlong nativePrepareStatement(JNIEnv* env, jclass clazz, jlong connectionP
 
     jsize sqlLength = env->GetStringLength(sqlString);
     const jchar* sql = env->GetStringCritical(sqlString, NULL);
-    sqlite3_stmt* statement;
-    int err = sqlite3_prepare16_v2(connection->db,
-            sql, sqlLength * sizeof(jchar), &statement, NULL);
+
+    // Reuse an idle statement with identical SQL if one was released earlier.
+    // The list is short, so a linear scan beats maintaining a second index.
+    sqlite3_stmt* statement = NULL;
+    for (auto it = connection->idleStatements.begin();
+            it != connection->idleStatements.end(); ++it) {
+        if (it->first.size() == static_cast<size_t>(sqlLength)
+                && memcmp(it->first.data(), sql, sqlLength * sizeof(jchar)) == 0) {
+            statement = it->second;
+            connection->activeStatements.emplace(statement, std::move(it->first));
+            connection->idleStatements.erase(it);
+            break;
+        }
+    }
+
+    int err = SQLITE_OK;
+    if (statement == NULL) {
+        err = sqlite3_prepare16_v2(connection->db,
+                sql, sqlLength * sizeof(jchar), &statement, NULL);
+        if (err == SQLITE_OK && statement != NULL) {
+            connection->activeStatements.emplace(statement,
+                    std::u16string(reinterpret_cast<const char16_t*>(sql), sqlLength));
+        }
+    }
     env->ReleaseStringCritical(sqlString, sql);
 
     if (err != SQLITE_OK) {
@@ -329,6 +378,24 @@ static void nativeFinalizeStatement(JNIEnv* env, jclass clazz, jlong connectionP
     SQLiteConnection* connection = reinterpret_cast<SQLiteConnection*>(connectionPtr);
     sqlite3_stmt* statement = reinterpret_cast<sqlite3_stmt*>(statementPtr);
 
+    // Instead of finalizing, reset the statement and keep it warm for the next
+    // prepare of the same SQL. sqlite3_reset() only reports the error of the last
+    // step, so the statement stays reusable regardless of its return value.
+    auto it = connection->activeStatements.find(statement);
+    if (it != connection->activeStatements.end()) {
+        sqlite3_reset(statement);
+        sqlite3_clear_bindings(statement);
+        connection->idleStatements.emplace_front(std::move(it->second), statement);
+        connection->activeStatements.erase(it);
+
+        if (connection->idleStatements.size() > STATEMENT_CACHE_CAPACITY) {
+            sqlite3_finalize(connection->idleStatements.back().second);
+            connection->idleStatements.pop_back();
+        }
+        ALOGV("Recycled statement %p on connection %p", statement, connection->db);
+        return;
+    }
+
     // We ignore the result of sqlite3_finalize because it is really telling us about
     // whether any errors occurred while executing the statement.  The statement itself
     // is always finalized regardless.
@@ -42,6 +42,7 @@ using namespace android;
 struct {
     jclass clazz;
     jmethodID dispatchSensorEvent;
+    jmethodID dispatchSensorEventBatch;
     jmethodID dispatchFlushCompleteEvent;
     jmethodID dispatchAdditionalInfoEvent;
 } gBaseEventQueueClassInfo;
@@ -290,12 +291,27 @@ static jint nativeSetOperationParameter(JNIEnv *_env, jclass _this, jlong sensor
 
 //----------------------------------------------------------------------------
 
+// Packed record layout shared with the Java side of dispatchSensorEventBatch;
+// simple sensor events are staged as these records in a direct ByteBuffer so
+// a whole drain of the queue costs one upcall instead of one per event.
+struct BatchedSensorEvent {
+    int32_t sensor;
+    int32_t accuracy;
+    int64_t timestamp;
+    float data[16];
+};
+
+static constexpr size_t kMaxBatchedEvents = 64;
+
 class Receiver : public LooperCallback {
     sp<SensorEventQueue> mSensorQueue;
     sp<MessageQueue> mMessageQueue;
     jobject mReceiverWeakGlobal;
     jfloatArray mFloatScratch;
     jintArray   mIntScratch;
+    jobject mBatchBufferGlobal;
+    BatchedSensorEvent* mBatchBuffer;
+    size_t mBatchCount;
 public:
     Receiver(const sp<SensorEventQueue>& sensorQueue,
             const sp<MessageQueue>& messageQueue,
@@ -307,12 +323,19 @@ public:
 
         mIntScratch = (jintArray) env->NewGlobalRef(env->NewIntArray(16));
         mFloatScratch = (jfloatArray) env->NewGlobalRef(env->NewFloatArray(16));
+
+        mBatchBuffer = (BatchedSensorEvent*) malloc(kMaxBatchedEvents * sizeof(BatchedSensorEvent));
+        mBatchBufferGlobal = env->NewGlobalRef(env->NewDirectByteBuffer(
+                mBatchBuffer, kMaxBatchedEvents * sizeof(BatchedSensorEvent)));
+        mBatchCount = 0;
     }
     ~Receiver() {
         JNIEnv* env = AndroidRuntime::getJNIEnv();
         env->DeleteGlobalRef(mReceiverWeakGlobal);
         env->DeleteGlobalRef(mFloatScratch);
         env->DeleteGlobalRef(mIntScratch);
+        env->DeleteGlobalRef(mBatchBufferGlobal);
+        free(mBatchBuffer);
     }
     sp<SensorEventQueue> getSensorEventQueue() const {
         return mSensorQueue;
@@ -329,6 +352,19 @@ private:
                 ALOOPER_EVENT_INPUT, this, mSensorQueue.get());
     }
 
+    // Dispatches the records staged so far in one upcall.
+    void flushBatch(JNIEnv* env, jobject receiverObj) {
+        if (mBatchCount == 0) {
+            return;
+        }
+        if (receiverObj) {
+            env->CallVoidMethod(receiverObj,
+                                gBaseEventQueueClassInfo.dispatchSensorEventBatch,
+                                mBatchBufferGlobal, (jint)mBatchCount);
+        }
+        mBatchCount = 0;
+    }
+
     virtual int handleEvent(int fd, int events, void* data) {
         JNIEnv* env = AndroidRuntime::getJNIEnv();
         sp<SensorEventQueue> q = reinterpret_cast<SensorEventQueue *>(data);
@@ -338,35 +374,23 @@ private:
         ASensorEvent buffer[16];
         while ((n = q->read(buffer, 16)) > 0) {
             for (int i=0 ; i<n ; i++) {
-                if (buffer[i].type == SENSOR_TYPE_STEP_COUNTER) {
-                    // step-counter returns a uint64, but the java API only deals with floats
-                    float value = float(buffer[i].u64.step_counter);
-                    env->SetFloatArrayRegion(mFloatScratch, 0, 1, &value);
-                } else if (buffer[i].type == SENSOR_TYPE_DYNAMIC_SENSOR_META) {
-                    float value[2];
-                    value[0] = buffer[i].dynamic_sensor_meta.connected ? 1.f: 0.f;
-                    value[1] = float(buffer[i].dynamic_sensor_meta.handle);
-                    env->SetFloatArrayRegion(mFloatScratch, 0, 2, value);
-                } else if (buffer[i].type == SENSOR_TYPE_ADDITIONAL_INFO) {
-                    env->SetIntArrayRegion(mIntScratch, 0, 14,
-                                           buffer[i].additional_info.data_int32);
-                    env->SetFloatArrayRegion(mFloatScratch, 0, 14,
-                                             buffer[i].additional_info.data_float);
-                } else {
-                    env->SetFloatArrayRegion(mFloatScratch, 0, 16, buffer[i].data);
-                }
-
                 if (buffer[i].type == SENSOR_TYPE_META_DATA) {
-                    // This is a flush complete sensor event. Call dispatchFlushCompleteEvent
-                    // method.
+                    // Flush complete event; uses its own callback, so deliver
+                    // what is staged first to keep events in order.
+                    flushBatch(env, receiverObj.get());
                     if (receiverObj.get()) {
                         env->CallVoidMethod(receiverObj.get(),
                                             gBaseEventQueueClassInfo.dispatchFlushCompleteEvent,
                                             buffer[i].meta_data.sensor);
                     }
                 } else if (buffer[i].type == SENSOR_TYPE_ADDITIONAL_INFO) {
-                    // This is a flush complete sensor event. Call dispatchAdditionalInfoEvent
-                    // method.
+                    // Additional info also has its own callback and carries
+                    // an int payload, so it keeps the scratch-array path.
+                    flushBatch(env, receiverObj.get());
+                    env->SetIntArrayRegion(mIntScratch, 0, 14,
+                                           buffer[i].additional_info.data_int32);
+                    env->SetFloatArrayRegion(mFloatScratch, 0, 14,
+                                             buffer[i].additional_info.data_float);
                     if (receiverObj.get()) {
                         int type = buffer[i].additional_info.type;
                         int serial = buffer[i].additional_info.serial;
@@ -378,7 +402,13 @@ private:
                                             mIntScratch,
                                             buffer[i].timestamp);
                     }
-                }else {
+                } else {
+                    // Ordinary sensor event: stage a packed record instead of
+                    // crossing into Java per event.
+                    BatchedSensorEvent& record = mBatchBuffer[mBatchCount];
+                    record.sensor = buffer[i].sensor;
+                    record.timestamp = buffer[i].timestamp;
+
                     int8_t status;
                     switch (buffer[i].type) {
                     case SENSOR_TYPE_ORIENTATION:
@@ -396,21 +426,39 @@ private:
                         status = SENSOR_STATUS_ACCURACY_HIGH;
                         break;
                     }
-                    if (receiverObj.get()) {
-                        env->CallVoidMethod(receiverObj.get(),
-                                            gBaseEventQueueClassInfo.dispatchSensorEvent,
-                                            buffer[i].sensor,
-                                            mFloatScratch,
-                                            status,
-                                            buffer[i].timestamp);
+                    record.accuracy = status;
+
+                    if (buffer[i].type == SENSOR_TYPE_STEP_COUNTER) {
+                        // step-counter returns a uint64, but the java API only deals with floats
+                        memset(record.data, 0, sizeof(record.data));
+                        record.data[0] = float(buffer[i].u64.step_counter);
+                    } else if (buffer[i].type == SENSOR_TYPE_DYNAMIC_SENSOR_META) {
+                        memset(record.data, 0, sizeof(record.data));
+                        record.data[0] = buffer[i].dynamic_sensor_meta.connected ? 1.f: 0.f;
+                        record.data[1] = float(buffer[i].dynamic_sensor_meta.handle);
+                    } else {
+                        memcpy(record.data, buffer[i].data, sizeof(record.data));
+                    }
+
+                    if (++mBatchCount == kMaxBatchedEvents) {
+                        flushBatch(env, receiverObj.get());
                     }
                 }
                 if (env->ExceptionCheck()) {
+                    mBatchCount = 0;
                     mSensorQueue->sendAck(buffer, n);
                     ALOGE("Exception dispatching input event.");
                     return 1;
                 }
             }
+            // Deliver before acking so the wakelock still covers the upcall.
+            flushBatch(env, receiverObj.get());
+            if (env->ExceptionCheck()) {
+                mBatchCount = 0;
+                mSensorQueue->sendAck(buffer, n);
+                ALOGE("Exception dispatching input event.");
+                return 1;
+            }
             mSensorQueue->sendAck(buffer, n);
         }
         if (n<0 && n != -EAGAIN) {
@@ -558,6 +606,10 @@ int register_android_hardware_SensorManager(JNIEnv *env)
     gBaseEventQueueClassInfo.dispatchSensorEvent = GetMethodIDOrDie(env,
             gBaseEventQueueClassInfo.clazz, "dispatchSensorEvent", "(I[FIJ)V");
 
+    gBaseEventQueueClassInfo.dispatchSensorEventBatch = GetMethodIDOrDie(env,
+            gBaseEventQueueClassInfo.clazz, "dispatchSensorEventBatch",
+            "(Ljava/nio/ByteBuffer;I)V");
+
     gBaseEventQueueClassInfo.dispatchFlushCompleteEvent = GetMethodIDOrDie(env,
             gBaseEventQueueClassInfo.clazz, "dispatchFlushCompleteEvent", "(I)V");
 
@@ -23,6 +23,7 @@
 #include <utils/Vector.h>
 #include <utils/SortedVector.h>
 #include <utils/KeyedVector.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <vector>
@@ -322,6 +323,57 @@ static jbyteArray CameraMetadata_readValues(JNIEnv *env, jobject thiz, jint tag)
     return byteArray;
 }
 
+// Copies the entry for a tag into a caller-provided direct ByteBuffer instead
+// of allocating a fresh byte[] per key. Returns the entry size in bytes, 0 for
+// an entry with no data, or -1 if the tag has no entry. The metadata owns its
+// backing buffer and may reallocate it on update, so the entry is copied out
+// rather than exposed in place.
+static jint CameraMetadata_readValuesInto(JNIEnv *env, jobject thiz, jint tag, jobject dst) {
+    ALOGV("%s (tag = %d)", __FUNCTION__, tag);
+
+    CameraMetadata* metadata = CameraMetadata_getPointerThrow(env, thiz);
+    if (metadata == NULL) return -1;
+
+    const camera_metadata_t *metaBuffer = metadata->getAndLock();
+    int tagType = get_local_camera_metadata_tag_type(tag, metaBuffer);
+    metadata->unlock(metaBuffer);
+    if (tagType == -1) {
+        jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException",
+                             "Tag (%d) did not have a type", tag);
+        return -1;
+    }
+    size_t tagSize = Helpers::getTypeSize(tagType);
+
+    camera_metadata_entry entry = metadata->find(tag);
+    if (entry.count == 0) {
+        if (!metadata->exists(tag)) {
+            ALOGV("%s: Tag %d does not have any entries", __FUNCTION__, tag);
+            return -1;
+        }
+        ALOGV("%s: Tag %d had an entry, but it had 0 data", __FUNCTION__, tag);
+        return 0;
+    }
+
+    jsize byteCount = entry.count * tagSize;
+
+    void* dstData = env->GetDirectBufferAddress(dst);
+    jlong dstCapacity = env->GetDirectBufferCapacity(dst);
+    if (dstData == NULL || dstCapacity < 0) {
+        jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException",
+                             "dst must be a direct ByteBuffer");
+        return -1;
+    }
+    if (dstCapacity < byteCount) {
+        jniThrowExceptionFmt(env, "java/lang/IllegalArgumentException",
+                             "dst capacity (%" PRId64 ") too small for tag %d (%d bytes)",
+                             static_cast<int64_t>(dstCapacity), tag, byteCount);
+        return -1;
+    }
+
+    memcpy(dstData, entry.data.u8, byteCount);
+    return byteCount;
+}
+
 static void CameraMetadata_writeValues(JNIEnv *env, jobject thiz, jint tag, jbyteArray src) {
     ALOGV("%s (tag = %d)", __FUNCTION__, tag);
 
@@ -576,6 +628,9 @@ static const JNINativeMethod gCameraMetadataMethods[] = {
   { "nativeReadValues",
     "(I)[B",
     (void *)CameraMetadata_readValues },
+  { "nativeReadValuesInto",
+    "(ILjava/nio/ByteBuffer;)I",
+    (void *)CameraMetadata_readValuesInto },
   { "nativeWriteValues",
     "(I[B)V",
     (void *)CameraMetadata_writeValues },
@@ -81,10 +81,16 @@ class AudioTrackJniStorage {
         audiotrack_callback_cookie mCallbackData;
         sp<JNIDeviceCallback>      mDeviceCallback;
 
+        // Region of the track's ring obtained through native_obtain_buffer
+        // and not yet released; only valid while mHasObtainedBuffer is set.
+        AudioTrack::Buffer         mObtainedBuffer;
+        bool                       mHasObtainedBuffer;
+
     AudioTrackJniStorage() {
         mCallbackData.audioTrack_class = 0;
         mCallbackData.audioTrack_ref = 0;
         mCallbackData.isOffload = false;
+        mHasObtainedBuffer = false;
     }
 
     ~AudioTrackJniStorage() {
@@ -727,6 +733,82 @@ static jint android_media_AudioTrack_write_native_bytes(JNIEnv *env,  jobject th
     return written;
 }
 
+// ----------------------------------------------------------------------------
+static AudioTrackJniStorage* getJniStorage(JNIEnv *env, jobject thiz) {
+    return (AudioTrackJniStorage *)env->GetLongField(thiz, javaAudioTrackFields.jniData);
+}
+
+/*
+ * Hands a contiguous region of the track's shared ring buffer to Java as a
+ * direct ByteBuffer, so a renderer can produce samples straight into the
+ * memory the mixer consumes instead of staging them through write().  At
+ * most one region may be outstanding per track; it is returned to the track
+ * with native_release_buffer below.  Returns null if the ring has no space
+ * (non-blocking) or the track is invalid.
+ */
+static jobject android_media_AudioTrack_obtain_buffer(JNIEnv *env, jobject thiz,
+        jint sizeInFrames, jboolean blocking) {
+    sp<AudioTrack> lpTrack = getAudioTrack(env, thiz);
+    AudioTrackJniStorage* lpJniStorage = getJniStorage(env, thiz);
+    if (lpTrack == NULL || lpJniStorage == NULL) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+            "Unable to retrieve AudioTrack pointer for obtainBuffer()");
+        return NULL;
+    }
+    if (lpJniStorage->mHasObtainedBuffer) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+            "obtainBuffer() called with a buffer still outstanding");
+        return NULL;
+    }
+    if (sizeInFrames <= 0) {
+        return NULL;
+    }
+
+    AudioTrack::Buffer& buffer = lpJniStorage->mObtainedBuffer;
+    buffer.frameCount = sizeInFrames;
+    status_t status = lpTrack->obtainBuffer(&buffer,
+            blocking == JNI_TRUE ? -1 /*waitCount, forever*/ : 0 /*non-blocking*/);
+    if (status != NO_ERROR) {
+        if (status != WOULD_BLOCK) {
+            ALOGE("Error %d obtaining AudioTrack buffer", status);
+        }
+        return NULL;
+    }
+
+    lpJniStorage->mHasObtainedBuffer = true;
+    return env->NewDirectByteBuffer(buffer.raw, buffer.size);
+}
+
+/*
+ * Returns the region handed out by native_obtain_buffer to the track,
+ * advancing the ring by the number of bytes actually rendered (which may be
+ * less than the obtained size).
+ */
+static jint android_media_AudioTrack_release_buffer(JNIEnv *env, jobject thiz,
+        jint bytesWritten) {
+    sp<AudioTrack> lpTrack = getAudioTrack(env, thiz);
+    AudioTrackJniStorage* lpJniStorage = getJniStorage(env, thiz);
+    if (lpTrack == NULL || lpJniStorage == NULL) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+            "Unable to retrieve AudioTrack pointer for releaseBuffer()");
+        return (jint)AUDIO_JAVA_INVALID_OPERATION;
+    }
+    if (!lpJniStorage->mHasObtainedBuffer) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+            "releaseBuffer() called without an outstanding buffer");
+        return (jint)AUDIO_JAVA_INVALID_OPERATION;
+    }
+
+    AudioTrack::Buffer& buffer = lpJniStorage->mObtainedBuffer;
+    if (bytesWritten < 0 || (size_t)bytesWritten > buffer.size) {
+        return (jint)AUDIO_JAVA_BAD_VALUE;
+    }
+    buffer.size = bytesWritten;
+    lpTrack->releaseBuffer(&buffer);
+    lpJniStorage->mHasObtainedBuffer = false;
+    return (jint)AUDIO_JAVA_SUCCESS;
+}
+
 // ----------------------------------------------------------------------------
 static jint android_media_AudioTrack_get_buffer_size_frames(JNIEnv *env,  jobject thiz) {
     sp<AudioTrack> lpTrack = getAudioTrack(env, thiz);
@@ -1321,6 +1403,9 @@ static const JNINativeMethod gMethods[] = {
                              "(Ljava/nio/ByteBuffer;IIIZ)I",
                                          (void *)android_media_AudioTrack_write_native_bytes},
     {"native_write_short",   "([SIIIZ)I",(void *)android_media_AudioTrack_writeArray<jshortArray>},
+    {"native_obtain_buffer", "(IZ)Ljava/nio/ByteBuffer;",
+                             (void *)android_media_AudioTrack_obtain_buffer},
+    {"native_release_buffer","(I)I",     (void *)android_media_AudioTrack_release_buffer},
     {"native_write_float",   "([FIIIZ)I",(void *)android_media_AudioTrack_writeArray<jfloatArray>},
     {"native_setVolume",     "(FF)V",    (void *)android_media_AudioTrack_set_volume},
     {"native_get_buffer_size_frames",
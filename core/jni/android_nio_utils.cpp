@@ -20,6 +20,10 @@
 
 namespace android {
 
+// Resolution is intentionally uncached: a jobject is a per-call local
+// reference, not a stable identity, so a cross-call cache would need global
+// references plus IsSameObject probes that cost more than the single
+// accelerated field lookup below.
 AutoBufferPointer::AutoBufferPointer(JNIEnv* env, jobject nioBuffer, jboolean commit)
         : fEnv(env), fCommit(commit) {
     jlong pointer = jniGetNioBufferPointer(fEnv, nioBuffer);
@@ -245,12 +245,17 @@ static void load_maps(int pid, stats_t* stats, bool* foundSwapPss)
         int which_heap = HEAP_UNKNOWN;
         int sub_heap = HEAP_UNKNOWN;
         bool is_swappable = false;
-        std::string name;
+
+        // Only deleted mappings need a trimmed copy of the name; everything else
+        // classifies straight off the Vma's own string, saving an allocation per
+        // mapping on processes with thousands of them.
+        std::string stripped_name;
+        const std::string* name_ref = &vma.name;
         if (base::EndsWith(vma.name, " (deleted)")) {
-            name = vma.name.substr(0, vma.name.size() - strlen(" (deleted)"));
-        } else {
-            name = vma.name;
+            stripped_name = vma.name.substr(0, vma.name.size() - strlen(" (deleted)"));
+            name_ref = &stripped_name;
         }
+        const std::string& name = *name_ref;
 
         uint32_t namesz = name.size();
         if (base::StartsWith(name, "[heap]")) {
@@ -109,6 +109,12 @@ void JHwBlob::setTo(const void *ptr, size_t handle) {
     mHandle = handle;
 }
 
+void JHwBlob::setOwner(const sp<RefBase> &owner) {
+    CHECK(!mOwnsBuffer);
+
+    mOwner = owner;
+}
+
 status_t JHwBlob::getHandle(size_t *handle) const {
     if (mOwnsBuffer) {
         return INVALID_OPERATION;
@@ -569,6 +575,38 @@ static void JHwBlob_native_putBlob(
     blob->putBlob(offset, subBlob);
 }
 
+/*
+ * Exposes a range of the blob's memory as a direct ByteBuffer without
+ * copying.  For blobs read out of a parcel the view aliases the parcel's
+ * transaction buffer; the blob pins that parcel, so the view is valid for as
+ * long as the caller holds the blob.
+ */
+static jobject JHwBlob_native_asByteBuffer(
+        JNIEnv *env, jobject thiz, jlong offset, jlong size) {
+    sp<JHwBlob> blob = JHwBlob::GetNativeContext(env, thiz);
+
+    if (offset < 0 || size < 0) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", NULL);
+        return nullptr;
+    }
+
+    if (blob->data() == nullptr) {
+        jniThrowException(env, "java/lang/NullPointerException", NULL);
+        return nullptr;
+    }
+
+    // Parcel-backed blobs carry no usable size of their own (see setTo); the
+    // caller supplies the embedded buffer's size, which the parcel already
+    // validated on read.  Locally allocated blobs are bounds-checked here.
+    if (blob->size() != SIZE_MAX
+            && ((uint64_t)offset + (uint64_t)size > blob->size())) {
+        signalExceptionForError(env, -ERANGE);
+        return nullptr;
+    }
+
+    return env->NewDirectByteBuffer((uint8_t *)blob->data() + offset, size);
+}
+
 static jlong JHwBlob_native_handle(JNIEnv *env, jobject thiz) {
     size_t handle;
     status_t err = JHwBlob::GetNativeContext(env, thiz)->getHandle(&handle);
@@ -624,6 +662,9 @@ static JNINativeMethod gMethods[] = {
     { "putBlob", "(JL" PACKAGE_PATH "/HwBlob;)V",
         (void *)JHwBlob_native_putBlob },
 
+    { "asByteBuffer", "(JJ)Ljava/nio/ByteBuffer;",
+        (void *)JHwBlob_native_asByteBuffer },
+
     { "handle", "()J", (void *)JHwBlob_native_handle },
 };
 
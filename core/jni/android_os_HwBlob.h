@@ -46,6 +46,11 @@ struct JHwBlob : public RefBase {
 
     void setTo(const void *ptr, size_t handle);
 
+    // Pins the object owning the memory this blob points into (typically the
+    // JHwParcel it was read from) for as long as the blob is alive, so direct
+    // ByteBuffer views handed out over that memory stay valid.
+    void setOwner(const sp<RefBase> &owner);
+
     status_t getHandle(size_t *handle) const;
 
     status_t read(size_t offset, void *data, size_t size) const;
@@ -87,6 +92,8 @@ private:
 
     size_t mHandle;
 
+    sp<RefBase> mOwner;
+
     Vector<BlobInfo> mSubBlobs;
 
     status_t writeSubBlobsToParcel(hardware::Parcel *parcel, size_t parentHandle) const;
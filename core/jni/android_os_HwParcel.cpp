@@ -892,8 +892,8 @@ static jobject JHwParcel_native_readStrongBinder(JNIEnv *env, jobject thiz) {
 
 static jobject JHwParcel_native_readBuffer(JNIEnv *env, jobject thiz,
                                            jlong expectedSize) {
-    hardware::Parcel *parcel =
-        JHwParcel::GetNativeContext(env, thiz)->getParcel();
+    sp<JHwParcel> parcelObj = JHwParcel::GetNativeContext(env, thiz);
+    hardware::Parcel *parcel = parcelObj->getParcel();
 
     size_t handle;
     const void *ptr;
@@ -910,14 +910,19 @@ static jobject JHwParcel_native_readBuffer(JNIEnv *env, jobject thiz,
         return nullptr;
     }
 
-    return JHwBlob::NewObject(env, ptr, handle);
+    jobject blobObj = JHwBlob::NewObject(env, ptr, handle);
+    // The blob aliases the parcel's memory; keep the parcel alive as long as
+    // the blob (and any ByteBuffer views of it) may be in use.
+    JHwBlob::GetNativeContext(env, blobObj)->setOwner(parcelObj);
+
+    return blobObj;
 }
 
 static jobject JHwParcel_native_readEmbeddedBuffer(
         JNIEnv *env, jobject thiz, jlong expectedSize,
         jlong parentHandle, jlong offset, jboolean nullable) {
-    hardware::Parcel *parcel =
-        JHwParcel::GetNativeContext(env, thiz)->getParcel();
+    sp<JHwParcel> parcelObj = JHwParcel::GetNativeContext(env, thiz);
+    hardware::Parcel *parcel = parcelObj->getParcel();
 
     size_t childHandle;
 
@@ -939,7 +944,10 @@ static jobject JHwParcel_native_readEmbeddedBuffer(
         return 0;
     }
 
-    return JHwBlob::NewObject(env, ptr, childHandle);
+    jobject blobObj = JHwBlob::NewObject(env, ptr, childHandle);
+    JHwBlob::GetNativeContext(env, blobObj)->setOwner(parcelObj);
+
+    return blobObj;
 }
 
 static void JHwParcel_native_writeBuffer(
@@ -23,6 +23,8 @@
 #include <utils/Log.h>
 #include "android_os_MessageQueue.h"
 
+#include <vector>
+
 #include "core_jni_helpers.h"
 
 namespace android {
@@ -30,6 +32,7 @@ namespace android {
 static struct {
     jfieldID mPtr;   // native object attached to the DVM MessageQueue
     jmethodID dispatchEvents;
+    jmethodID dispatchEventsBatch;
 } gMessageQueueClassInfo;
 
 // Must be kept in sync with the constants in Looper.FileDescriptorCallback
@@ -52,9 +55,16 @@ public:
     virtual int handleEvent(int fd, int events, void* data);
 
 private:
+    void dispatchFdEvents(JNIEnv* env);
+    void applyWatchUpdate(int fd, int oldWatchedEvents, int newWatchedEvents);
+
     JNIEnv* mPollEnv;
     jobject mPollObj;
     jthrowable mExceptionObj;
+
+    // (fd, events, oldWatchedEvents) triples gathered while the looper drains a
+    // wake, dispatched to Java in one upcall after the poll returns.
+    std::vector<int> mPendingFdEvents;
 };
 
 
@@ -108,6 +118,9 @@ void NativeMessageQueue::pollOnce(JNIEnv* env, jobject pollObj, int timeoutMilli
     mPollEnv = env;
     mPollObj = pollObj;
     mLooper->pollOnce(timeoutMillis);
+    if (!mPendingFdEvents.empty()) {
+        dispatchFdEvents(env);
+    }
     mPollObj = NULL;
     mPollEnv = NULL;
 
@@ -149,16 +162,71 @@ int NativeMessageQueue::handleEvent(int fd, int looperEvents, void* data) {
     if (looperEvents & (Looper::EVENT_ERROR | Looper::EVENT_HANGUP | Looper::EVENT_INVALID)) {
         events |= CALLBACK_EVENT_ERROR;
     }
-    int oldWatchedEvents = reinterpret_cast<intptr_t>(data);
-    int newWatchedEvents = mPollEnv->CallIntMethod(mPollObj,
-            gMessageQueueClassInfo.dispatchEvents, fd, events);
+
+    // Queue the event instead of crossing into Java here; when several fds fire
+    // in the same wake this collapses the upcalls into one batch after the poll.
+    // The fd stays registered until the Java side has been asked.
+    mPendingFdEvents.push_back(fd);
+    mPendingFdEvents.push_back(events);
+    mPendingFdEvents.push_back(static_cast<int>(reinterpret_cast<intptr_t>(data)));
+    return 1;
+}
+
+void NativeMessageQueue::applyWatchUpdate(int fd, int oldWatchedEvents, int newWatchedEvents) {
     if (!newWatchedEvents) {
-        return 0; // unregister the fd
-    }
-    if (newWatchedEvents != oldWatchedEvents) {
+        mLooper->removeFd(fd);
+    } else if (newWatchedEvents != oldWatchedEvents) {
         setFileDescriptorEvents(fd, newWatchedEvents);
     }
-    return 1;
+}
+
+void NativeMessageQueue::dispatchFdEvents(JNIEnv* env) {
+    // Snapshot and clear the queue first so callbacks that re-enter the looper
+    // don't see stale entries.
+    std::vector<int> pending;
+    pending.swap(mPendingFdEvents);
+    const size_t count = pending.size() / 3;
+
+    if (count == 1) {
+        // The common case: a single fd fired, so the per-fd entry point is the
+        // cheapest path and avoids the array round trip.
+        int newWatchedEvents = env->CallIntMethod(mPollObj,
+                gMessageQueueClassInfo.dispatchEvents, pending[0], pending[1]);
+        if (env->ExceptionCheck()) {
+            return;
+        }
+        applyWatchUpdate(pending[0], pending[2], newWatchedEvents);
+        return;
+    }
+
+    // Several fds fired in one wake; hand them all to Java in a single crossing
+    // as (fd, events) pairs. The returned array holds the new watch mask for
+    // each fd in the same order.
+    std::vector<jint> fdsAndEvents(count * 2);
+    for (size_t i = 0; i < count; i++) {
+        fdsAndEvents[i * 2] = pending[i * 3];
+        fdsAndEvents[(i * 2) + 1] = pending[(i * 3) + 1];
+    }
+    jintArray fdsAndEventsArray = env->NewIntArray(count * 2);
+    if (fdsAndEventsArray == NULL) {
+        return; // An exception is pending.
+    }
+    env->SetIntArrayRegion(fdsAndEventsArray, 0, static_cast<jsize>(count * 2),
+            fdsAndEvents.data());
+
+    jintArray newWatchArray = jintArray(env->CallObjectMethod(mPollObj,
+            gMessageQueueClassInfo.dispatchEventsBatch, fdsAndEventsArray));
+    env->DeleteLocalRef(fdsAndEventsArray);
+    if (env->ExceptionCheck() || newWatchArray == NULL) {
+        return;
+    }
+
+    std::vector<jint> newWatchedEvents(count);
+    env->GetIntArrayRegion(newWatchArray, 0, static_cast<jsize>(count), newWatchedEvents.data());
+    env->DeleteLocalRef(newWatchArray);
+    for (size_t i = 0; i < count; i++) {
+        applyWatchUpdate(pending[i * 3], pending[(i * 3) + 2], newWatchedEvents[i]);
+    }
 }
 
 
@@ -228,6 +296,8 @@ int register_android_os_MessageQueue(JNIEnv* env) {
     gMessageQueueClassInfo.mPtr = GetFieldIDOrDie(env, clazz, "mPtr", "J");
     gMessageQueueClassInfo.dispatchEvents = GetMethodIDOrDie(env, clazz,
             "dispatchEvents", "(II)I");
+    gMessageQueueClassInfo.dispatchEventsBatch = GetMethodIDOrDie(env, clazz,
+            "dispatchEventsBatch", "([I)[I");
 
     return res;
 }
@@ -378,6 +378,31 @@ static jboolean android_os_Parcel_readByteArray(JNIEnv* env, jclass clazz, jlong
     return ret;
 }
 
+static jobject android_os_Parcel_readDirectByteBuffer(JNIEnv* env, jclass clazz, jlong nativePtr)
+{
+    Parcel* parcel = reinterpret_cast<Parcel*>(nativePtr);
+    if (parcel == NULL) {
+        return NULL;
+    }
+
+    int32_t len = parcel->readInt32();
+
+    // sanity check the stored length against the true data size
+    if (len < 0 || len > (int32_t)parcel->dataAvail()) {
+        return NULL;
+    }
+
+    const void* data = parcel->readInplace(len);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    // The buffer aliases the parcel's data region instead of copying it, so it is
+    // only valid until the parcel is recycled, freed, or rewritten. The Java side
+    // is responsible for confining the view to that window.
+    return env->NewDirectByteBuffer(const_cast<void*>(data), len);
+}
+
 static jbyteArray android_os_Parcel_readBlob(JNIEnv* env, jclass clazz, jlong nativePtr)
 {
     jbyteArray ret = NULL;
@@ -728,6 +753,8 @@ static const JNINativeMethod gParcelMethods[] = {
     {"nativeCreateByteArray",     "(J)[B", (void*)android_os_Parcel_createByteArray},
     {"nativeReadByteArray",       "(J[BI)Z", (void*)android_os_Parcel_readByteArray},
     {"nativeReadBlob",            "(J)[B", (void*)android_os_Parcel_readBlob},
+    {"nativeReadDirectByteBuffer", "(J)Ljava/nio/ByteBuffer;",
+            (void*)android_os_Parcel_readDirectByteBuffer},
     // @CriticalNative
     {"nativeReadInt",             "(J)I", (void*)android_os_Parcel_readInt},
     // @CriticalNative
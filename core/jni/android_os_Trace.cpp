@@ -40,10 +40,11 @@ inline static void withString(JNIEnv* env, jstring jstr, F callback) {
     // So make a buffer of size 4097 and let it hold a string with a maximum length
     // of 1024. The extra last byte for the null terminator.
     std::array<char, 4097> buffer;
-    // We have no idea of knowing how much data GetStringUTFRegion wrote, so null it out in
-    // advance so we can have a reliable null terminator
-    memset(buffer.data(), 0, buffer.size());
     jsize size = std::min(env->GetStringLength(jstr), 1024);
+    // GetStringUTFRegion doesn't report how many bytes it wrote, but modified
+    // UTF-8 needs at most 3 bytes per jchar, so zeroing that many plus one byte
+    // guarantees a null terminator without clearing the whole buffer.
+    memset(buffer.data(), 0, size * 3 + 1);
     env->GetStringUTFRegion(jstr, 0, size, buffer.data());
     sanitizeString(buffer.data());
 
@@ -54,8 +55,18 @@ static jlong android_os_Trace_nativeGetEnabledTags(JNIEnv*, jclass) {
     return atrace_get_enabled_tags();
 }
 
+// The libcutils helpers check the tag themselves, but only after we've copied
+// and sanitized the string; testing it first makes a disabled tag cost a single
+// load, the same check the ATRACE macros compile down to.
+inline static bool isTagEnabled(jlong tag) {
+    return atrace_is_tag_enabled(tag) != 0;
+}
+
 static void android_os_Trace_nativeTraceCounter(JNIEnv* env, jclass,
         jlong tag, jstring nameStr, jlong value) {
+    if (!isTagEnabled(tag)) {
+        return;
+    }
     withString(env, nameStr, [tag, value](char* str) {
         atrace_int64(tag, str, value);
     });
@@ -63,6 +74,9 @@ static void android_os_Trace_nativeTraceCounter(JNIEnv* env, jclass,
 
 static void android_os_Trace_nativeTraceBegin(JNIEnv* env, jclass,
         jlong tag, jstring nameStr) {
+    if (!isTagEnabled(tag)) {
+        return;
+    }
     withString(env, nameStr, [tag](char* str) {
         atrace_begin(tag, str);
     });
@@ -74,6 +88,9 @@ static void android_os_Trace_nativeTraceEnd(JNIEnv*, jclass, jlong tag) {
 
 static void android_os_Trace_nativeAsyncTraceBegin(JNIEnv* env, jclass,
         jlong tag, jstring nameStr, jint cookie) {
+    if (!isTagEnabled(tag)) {
+        return;
+    }
     withString(env, nameStr, [tag, cookie](char* str) {
         atrace_async_begin(tag, str, cookie);
     });
@@ -81,6 +98,9 @@ static void android_os_Trace_nativeAsyncTraceBegin(JNIEnv* env, jclass,
 
 static void android_os_Trace_nativeAsyncTraceEnd(JNIEnv* env, jclass,
         jlong tag, jstring nameStr, jint cookie) {
+    if (!isTagEnabled(tag)) {
+        return;
+    }
     withString(env, nameStr, [tag, cookie](char* str) {
         atrace_async_end(tag, str, cookie);
     });
@@ -25,6 +25,10 @@
 #include <utils/String8.h>
 #include <utils/Log.h>
 
+#include <string.h>
+
+#include <vector>
+
 extern "C" {
 #include "crypto_scrypt.h"
 }
@@ -38,25 +42,35 @@ static jbyteArray android_security_Scrypt_nativeScrypt(JNIEnv* env, jobject, jby
 
     int passwordLen = env->GetArrayLength(password);
     int saltLen = env->GetArrayLength(salt);
-    jbyteArray ret = env->NewByteArray(outLen);
 
-    jbyte* passwordPtr = (jbyte*)env->GetByteArrayElements(password, NULL);
-    jbyte* saltPtr = (jbyte*)env->GetByteArrayElements(salt, NULL);
-    jbyte* retPtr = (jbyte*)env->GetByteArrayElements(ret, NULL);
+    // Work on copies so the heap arrays are not pinned for the duration of the
+    // KDF, which runs for hundreds of milliseconds on low-end devices.
+    std::vector<uint8_t> passwordBuf(passwordLen);
+    std::vector<uint8_t> saltBuf(saltLen);
+    std::vector<uint8_t> out(outLen);
+    if (passwordLen > 0) {
+        env->GetByteArrayRegion(password, 0, passwordLen,
+                                reinterpret_cast<jbyte*>(passwordBuf.data()));
+    }
+    if (saltLen > 0) {
+        env->GetByteArrayRegion(salt, 0, saltLen, reinterpret_cast<jbyte*>(saltBuf.data()));
+    }
 
-    int rc = crypto_scrypt((const uint8_t *)passwordPtr, passwordLen,
-                       (const uint8_t *)saltPtr, saltLen, N, r, p, (uint8_t *)retPtr,
-                       outLen);
-    env->ReleaseByteArrayElements(password, passwordPtr, JNI_ABORT);
-    env->ReleaseByteArrayElements(salt, saltPtr, JNI_ABORT);
-    env->ReleaseByteArrayElements(ret, retPtr, 0);
+    int rc = crypto_scrypt(passwordBuf.data(), passwordLen, saltBuf.data(), saltLen, N, r, p,
+                           out.data(), outLen);
+    memset(passwordBuf.data(), 0, passwordBuf.size());
 
-    if (!rc) {
-        return ret;
-    } else {
+    if (rc) {
         SLOGE("scrypt failed");
         return NULL;
     }
+
+    jbyteArray ret = env->NewByteArray(outLen);
+    if (ret == NULL) {
+        return NULL;
+    }
+    env->SetByteArrayRegion(ret, 0, outLen, reinterpret_cast<const jbyte*>(out.data()));
+    return ret;
 }
 
 static const JNINativeMethod sMethods[] = {
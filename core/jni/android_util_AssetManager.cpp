@@ -30,6 +30,7 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "android-base/logging.h"
 #include "android-base/properties.h"
@@ -613,7 +614,7 @@ static jlong NativeOpenAsset(JNIEnv* env, jclass /*clazz*/, jlong ptr, jstring a
     return 0;
   }
 
-  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+  ScopedReadLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
   std::unique_ptr<Asset> asset =
       assetmanager->Open(asset_path_utf8.c_str(), static_cast<Asset::AccessMode>(access_mode));
   if (!asset) {
@@ -633,7 +634,7 @@ static jobject NativeOpenAssetFd(JNIEnv* env, jclass /*clazz*/, jlong ptr, jstri
 
   ATRACE_NAME(base::StringPrintf("AssetManager::OpenAssetFd(%s)", asset_path_utf8.c_str()).c_str());
 
-  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+  ScopedReadLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
   std::unique_ptr<Asset> asset = assetmanager->Open(asset_path_utf8.c_str(), Asset::ACCESS_RANDOM);
   if (!asset) {
     jniThrowException(env, "java/io/FileNotFoundException", asset_path_utf8.c_str());
@@ -659,7 +660,7 @@ static jlong NativeOpenNonAsset(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint j
     return 0;
   }
 
-  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+  ScopedReadLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
   std::unique_ptr<Asset> asset;
   if (cookie != kInvalidCookie) {
     asset = assetmanager->OpenNonAsset(asset_path_utf8.c_str(), cookie,
@@ -687,7 +688,7 @@ static jobject NativeOpenNonAssetFd(JNIEnv* env, jclass /*clazz*/, jlong ptr, ji
 
   ATRACE_NAME(base::StringPrintf("AssetManager::OpenNonAssetFd(%s)", asset_path_utf8.c_str()).c_str());
 
-  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+  ScopedReadLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
   std::unique_ptr<Asset> asset;
   if (cookie != kInvalidCookie) {
     asset = assetmanager->OpenNonAsset(asset_path_utf8.c_str(), cookie, Asset::ACCESS_RANDOM);
@@ -713,7 +714,7 @@ static jlong NativeOpenXmlAsset(JNIEnv* env, jobject /*clazz*/, jlong ptr, jint
 
   ATRACE_NAME(base::StringPrintf("AssetManager::OpenXmlAsset(%s)", asset_path_utf8.c_str()).c_str());
 
-  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+  ScopedReadLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
   std::unique_ptr<Asset> asset;
   if (cookie != kInvalidCookie) {
     asset = assetmanager->OpenNonAsset(asset_path_utf8.c_str(), cookie, Asset::ACCESS_RANDOM);
@@ -740,23 +741,21 @@ static jlong NativeOpenXmlAsset(JNIEnv* env, jobject /*clazz*/, jlong ptr, jint
   return reinterpret_cast<jlong>(xml_tree.release());
 }
 
-static jint NativeGetResourceValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid,
-                                   jshort density, jobject typed_value,
-                                   jboolean resolve_references) {
-  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+static jint GetResourceValue(JNIEnv* env, const AssetManager2& assetmanager, jint resid,
+                             jshort density, jobject typed_value, jboolean resolve_references) {
   Res_value value;
   ResTable_config selected_config;
   uint32_t flags;
   ApkAssetsCookie cookie =
-      assetmanager->GetResource(static_cast<uint32_t>(resid), false /*may_be_bag*/,
-                                static_cast<uint16_t>(density), &value, &selected_config, &flags);
+      assetmanager.GetResource(static_cast<uint32_t>(resid), false /*may_be_bag*/,
+                               static_cast<uint16_t>(density), &value, &selected_config, &flags);
   if (cookie == kInvalidCookie) {
     return ApkAssetsCookieToJavaCookie(kInvalidCookie);
   }
 
   uint32_t ref = static_cast<uint32_t>(resid);
   if (resolve_references) {
-    cookie = assetmanager->ResolveReference(cookie, &value, &selected_config, &flags, &ref);
+    cookie = assetmanager.ResolveReference(cookie, &value, &selected_config, &flags, &ref);
     if (cookie == kInvalidCookie) {
       return ApkAssetsCookieToJavaCookie(kInvalidCookie);
     }
@@ -764,6 +763,24 @@ static jint NativeGetResourceValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jin
   return CopyValue(env, cookie, value, ref, flags, &selected_config, typed_value);
 }
 
+static jint NativeGetResourceValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid,
+                                   jshort density, jobject typed_value,
+                                   jboolean resolve_references) {
+  Guarded<AssetManager2>& guarded_assetmanager = AssetManagerFromLong(ptr);
+  {
+    // Resolution happens concurrently across threads unless resolution logging is recording
+    // each step back into the AssetManager2, in which case fall through to the exclusive lock.
+    ScopedReadLock<AssetManager2> assetmanager(guarded_assetmanager);
+    if (!assetmanager->IsResourceResolutionLoggingEnabled()) {
+      return GetResourceValue(env, *assetmanager, resid, density, typed_value,
+                              resolve_references);
+    }
+  }
+
+  ScopedLock<AssetManager2> assetmanager(guarded_assetmanager);
+  return GetResourceValue(env, *assetmanager, resid, density, typed_value, resolve_references);
+}
+
 static jint NativeGetResourceBagValue(JNIEnv* env, jclass /*clazz*/, jlong ptr, jint resid,
                                       jint bag_entry_id, jobject typed_value) {
   ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
@@ -810,10 +827,13 @@ static jintArray NativeGetStyleAttributes(JNIEnv* env, jclass /*clazz*/, jlong p
     return nullptr;
   }
 
+  // The keys are interleaved with the rest of the bag entry, so gather them into a
+  // contiguous buffer and cross the JNI boundary once instead of once per attribute.
+  std::vector<jint> attr_resids(bag->entry_count);
   for (uint32_t i = 0; i < bag->entry_count; i++) {
-    jint attr_resid = bag->entries[i].key;
-    env->SetIntArrayRegion(array, i, 1, &attr_resid);
+    attr_resids[i] = bag->entries[i].key;
   }
+  env->SetIntArrayRegion(array, 0, static_cast<jsize>(bag->entry_count), attr_resids.data());
   return array;
 }
 
@@ -1208,14 +1228,13 @@ static jintArray NativeAttributeResolutionStack(
     return nullptr;
   }
 
-  for (uint32_t i = 0; i < style_stack.size(); i++) {
-    jint attr_resid = style_stack[i];
-    env->SetIntArrayRegion(array, i, 1, &attr_resid);
-  }
-  for (uint32_t i = 0; i < def_style_stack.size(); i++) {
-    jint attr_resid = def_style_stack[i];
-    env->SetIntArrayRegion(array, style_stack.size() + i, 1, &attr_resid);
-  }
+  // Each stack is already a contiguous run of 32-bit ids; copy them with one region
+  // write apiece rather than a JNI call per id.
+  env->SetIntArrayRegion(array, 0, static_cast<jsize>(style_stack.size()),
+                         reinterpret_cast<const jint*>(style_stack.data()));
+  env->SetIntArrayRegion(array, static_cast<jsize>(style_stack.size()),
+                         static_cast<jsize>(def_style_stack.size()),
+                         reinterpret_cast<const jint*>(def_style_stack.data()));
   return array;
 }
 
@@ -1243,6 +1262,61 @@ static void NativeApplyStyle(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlong the
   env->ReleasePrimitiveArrayCritical(java_attrs, attrs, JNI_ABORT);
 }
 
+static void NativeApplyStyleBatched(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlong theme_ptr,
+                                    jint def_style_attr, jint def_style_resid,
+                                    jlongArray xml_parser_ptrs, jintArray java_attrs,
+                                    jlongArray out_values_ptrs, jlongArray out_indices_ptrs) {
+  const jsize entry_count = env->GetArrayLength(xml_parser_ptrs);
+  if (env->GetArrayLength(out_values_ptrs) < entry_count ||
+      env->GetArrayLength(out_indices_ptrs) < entry_count) {
+    jniThrowException(env, "java/lang/IndexOutOfBoundsException", "output arrays too small");
+    return;
+  }
+
+  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+  Theme* theme = reinterpret_cast<Theme*>(theme_ptr);
+  CHECK(theme->GetAssetManager() == &(*assetmanager));
+  (void) assetmanager;
+
+  // All views in the batch share one attrs array (RecyclerView-style repeated inflation of the
+  // same layout); only the parser position and output storage vary per view.
+  jsize attrs_len = env->GetArrayLength(java_attrs);
+  jint* attrs = reinterpret_cast<jint*>(env->GetPrimitiveArrayCritical(java_attrs, nullptr));
+  if (attrs == nullptr) {
+    return;
+  }
+
+  jlong* parsers = reinterpret_cast<jlong*>(env->GetPrimitiveArrayCritical(xml_parser_ptrs,
+                                                                           nullptr));
+  jlong* values = reinterpret_cast<jlong*>(env->GetPrimitiveArrayCritical(out_values_ptrs,
+                                                                          nullptr));
+  jlong* indices = reinterpret_cast<jlong*>(env->GetPrimitiveArrayCritical(out_indices_ptrs,
+                                                                           nullptr));
+  if (parsers != nullptr && values != nullptr && indices != nullptr) {
+    std::vector<StyleBatchEntry> entries(entry_count);
+    for (jsize i = 0; i < entry_count; i++) {
+      entries[i].xml_parser = reinterpret_cast<ResXMLParser*>(parsers[i]);
+      entries[i].attrs = reinterpret_cast<uint32_t*>(attrs);
+      entries[i].attrs_length = attrs_len;
+      entries[i].out_values = reinterpret_cast<uint32_t*>(values[i]);
+      entries[i].out_indices = reinterpret_cast<uint32_t*>(indices[i]);
+    }
+    ApplyStyleBatched(theme, static_cast<uint32_t>(def_style_attr),
+                      static_cast<uint32_t>(def_style_resid), entries.data(), entries.size());
+  }
+
+  if (indices != nullptr) {
+    env->ReleasePrimitiveArrayCritical(out_indices_ptrs, indices, JNI_ABORT);
+  }
+  if (values != nullptr) {
+    env->ReleasePrimitiveArrayCritical(out_values_ptrs, values, JNI_ABORT);
+  }
+  if (parsers != nullptr) {
+    env->ReleasePrimitiveArrayCritical(xml_parser_ptrs, parsers, JNI_ABORT);
+  }
+  env->ReleasePrimitiveArrayCritical(java_attrs, attrs, JNI_ABORT);
+}
+
 static jboolean NativeResolveAttrs(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlong theme_ptr,
                                    jint def_style_attr, jint def_style_resid, jintArray java_values,
                                    jintArray java_attrs, jintArray out_java_values,
@@ -1394,6 +1468,38 @@ static void NativeThemeApplyStyle(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlon
   // jniThrowException(env, "java/lang/IllegalArgumentException", error_msg.c_str());
 }
 
+static jboolean NativeThemeRebase(JNIEnv* env, jclass /*clazz*/, jlong ptr, jlong theme_ptr,
+                                  jintArray style_ids, jbooleanArray force, jint style_count) {
+  if (style_count < 0 || style_count > env->GetArrayLength(style_ids) ||
+      style_count > env->GetArrayLength(force)) {
+    jniThrowException(env, "java/lang/IndexOutOfBoundsException", "style count out of bounds");
+    return JNI_FALSE;
+  }
+
+  ScopedLock<AssetManager2> assetmanager(AssetManagerFromLong(ptr));
+  Theme* theme = reinterpret_cast<Theme*>(theme_ptr);
+  CHECK(theme->GetAssetManager() == &(*assetmanager));
+  (void) assetmanager;
+
+  jint* styles = reinterpret_cast<jint*>(env->GetPrimitiveArrayCritical(style_ids, nullptr));
+  if (styles == nullptr) {
+    return JNI_FALSE;
+  }
+
+  jboolean* forced = reinterpret_cast<jboolean*>(env->GetPrimitiveArrayCritical(force, nullptr));
+  if (forced == nullptr) {
+    env->ReleasePrimitiveArrayCritical(style_ids, styles, JNI_ABORT);
+    return JNI_FALSE;
+  }
+
+  const bool result = theme->Rebase(reinterpret_cast<const uint32_t*>(styles),
+                                    reinterpret_cast<const uint8_t*>(forced),
+                                    static_cast<size_t>(style_count));
+  env->ReleasePrimitiveArrayCritical(force, forced, JNI_ABORT);
+  env->ReleasePrimitiveArrayCritical(style_ids, styles, JNI_ABORT);
+  return result ? JNI_TRUE : JNI_FALSE;
+}
+
 static void NativeThemeCopy(JNIEnv* env, jclass /*clazz*/, jlong dst_asset_manager_ptr,
                             jlong dst_theme_ptr, jlong src_asset_manager_ptr, jlong src_theme_ptr) {
   Theme* dst_theme = reinterpret_cast<Theme*>(dst_theme_ptr);
@@ -1572,6 +1678,7 @@ static const JNINativeMethod gAssetManagerMethods[] = {
     // Style attribute related methods.
     {"nativeAttributeResolutionStack", "(JJIII)[I", (void*)NativeAttributeResolutionStack},
     {"nativeApplyStyle", "(JJIIJ[IJJ)V", (void*)NativeApplyStyle},
+    {"nativeApplyStyleBatched", "(JJII[J[I[J[J)V", (void*)NativeApplyStyleBatched},
     {"nativeResolveAttrs", "(JJII[I[I[I[I)Z", (void*)NativeResolveAttrs},
     {"nativeRetrieveAttributes", "(JJ[I[I[I)Z", (void*)NativeRetrieveAttributes},
 
@@ -1579,6 +1686,7 @@ static const JNINativeMethod gAssetManagerMethods[] = {
     {"nativeThemeCreate", "(J)J", (void*)NativeThemeCreate},
     {"nativeThemeDestroy", "(J)V", (void*)NativeThemeDestroy},
     {"nativeThemeApplyStyle", "(JJIZ)V", (void*)NativeThemeApplyStyle},
+    {"nativeThemeRebase", "(JJ[I[ZI)Z", (void*)NativeThemeRebase},
     {"nativeThemeCopy", "(JJJJ)V", (void*)NativeThemeCopy},
     {"nativeThemeClear", "(J)V", (void*)NativeThemeClear},
     {"nativeThemeGetAttributeValue", "(JJILandroid/util/TypedValue;Z)I",
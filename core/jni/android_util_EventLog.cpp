@@ -72,6 +72,7 @@ static const JNINativeMethod gRegisterMethods[] = {
     { "writeEvent", "(II)I", (void*) ELog::writeEventInteger },
     { "writeEvent", "(IJ)I", (void*) ELog::writeEventLong },
     { "writeEvent", "(IF)I", (void*) ELog::writeEventFloat },
+    { "writeEvents", "([I[J)I", (void*) ELog::writeEventLongs },
     { "writeEvent", "(ILjava/lang/String;)I", (void*) ELog::writeEventString },
     { "writeEvent", "(I[Ljava/lang/Object;)I", (void*) ELog::writeEventArray },
     { "readEvents",
@@ -857,36 +857,13 @@ enum {
     PROC_OUT_FLOAT = 0x4000,
 };
 
-jboolean android_os_Process_parseProcLineArray(JNIEnv* env, jobject clazz,
-        char* buffer, jint startIndex, jint endIndex, jintArray format,
-        jobjectArray outStrings, jlongArray outLongs, jfloatArray outFloats)
+// Parsing core shared by the single-file and batched entry points. Writes
+// output fields starting at index 0 of the given arrays; outStrings may be
+// NULL when the format requests no string fields.
+static jboolean parse_proc_line(JNIEnv* env, char* buffer, jint startIndex, jint endIndex,
+        const jint* formatData, jsize NF, jobjectArray outStrings, jsize NS,
+        jlong* longsData, jsize NL, jfloat* floatsData, jsize NR)
 {
-
-    const jsize NF = env->GetArrayLength(format);
-    const jsize NS = outStrings ? env->GetArrayLength(outStrings) : 0;
-    const jsize NL = outLongs ? env->GetArrayLength(outLongs) : 0;
-    const jsize NR = outFloats ? env->GetArrayLength(outFloats) : 0;
-
-    jint* formatData = env->GetIntArrayElements(format, 0);
-    jlong* longsData = outLongs ?
-        env->GetLongArrayElements(outLongs, 0) : NULL;
-    jfloat* floatsData = outFloats ?
-        env->GetFloatArrayElements(outFloats, 0) : NULL;
-    if (formatData == NULL || (NL > 0 && longsData == NULL)
-            || (NR > 0 && floatsData == NULL)) {
-        if (formatData != NULL) {
-            env->ReleaseIntArrayElements(format, formatData, 0);
-        }
-        if (longsData != NULL) {
-            env->ReleaseLongArrayElements(outLongs, longsData, 0);
-        }
-        if (floatsData != NULL) {
-            env->ReleaseFloatArrayElements(outFloats, floatsData, 0);
-        }
-        jniThrowException(env, "java/lang/OutOfMemoryError", NULL);
-        return JNI_FALSE;
-    }
-
     jsize i = startIndex;
     jsize di = 0;
 
@@ -970,6 +947,42 @@ jboolean android_os_Process_parseProcLineArray(JNIEnv* env, jobject clazz,
         }
     }
 
+    return res;
+}
+
+jboolean android_os_Process_parseProcLineArray(JNIEnv* env, jobject clazz,
+        char* buffer, jint startIndex, jint endIndex, jintArray format,
+        jobjectArray outStrings, jlongArray outLongs, jfloatArray outFloats)
+{
+
+    const jsize NF = env->GetArrayLength(format);
+    const jsize NS = outStrings ? env->GetArrayLength(outStrings) : 0;
+    const jsize NL = outLongs ? env->GetArrayLength(outLongs) : 0;
+    const jsize NR = outFloats ? env->GetArrayLength(outFloats) : 0;
+
+    jint* formatData = env->GetIntArrayElements(format, 0);
+    jlong* longsData = outLongs ?
+        env->GetLongArrayElements(outLongs, 0) : NULL;
+    jfloat* floatsData = outFloats ?
+        env->GetFloatArrayElements(outFloats, 0) : NULL;
+    if (formatData == NULL || (NL > 0 && longsData == NULL)
+            || (NR > 0 && floatsData == NULL)) {
+        if (formatData != NULL) {
+            env->ReleaseIntArrayElements(format, formatData, 0);
+        }
+        if (longsData != NULL) {
+            env->ReleaseLongArrayElements(outLongs, longsData, 0);
+        }
+        if (floatsData != NULL) {
+            env->ReleaseFloatArrayElements(outFloats, floatsData, 0);
+        }
+        jniThrowException(env, "java/lang/OutOfMemoryError", NULL);
+        return JNI_FALSE;
+    }
+
+    jboolean res = parse_proc_line(env, buffer, startIndex, endIndex, formatData, NF,
+            outStrings, NS, longsData, NL, floatsData, NR);
+
     env->ReleaseIntArrayElements(format, formatData, 0);
     if (longsData != NULL) {
         env->ReleaseLongArrayElements(outLongs, longsData, 0);
@@ -1052,6 +1065,149 @@ jboolean android_os_Process_readProcFile(JNIEnv* env, jobject clazz,
             format, outStrings, outLongs, outFloats);
 }
 
+/*
+ * Reads the same proc file (e.g. "stat") for every pid in the list and parses
+ * it with the shared format description, all in one JNI crossing.  Numeric
+ * results are packed row-major into outLongs/outFloats, one row of output
+ * fields per pid; rows for pids whose file could not be read or parsed are
+ * filled with -1.  String output fields are not supported in batch form.
+ * Returns the number of pids successfully parsed.
+ */
+jint android_os_Process_readProcFileBatch(JNIEnv* env, jobject clazz,
+        jintArray pids, jstring suffix, jintArray format,
+        jlongArray outLongs, jfloatArray outFloats)
+{
+    if (pids == NULL || suffix == NULL || format == NULL) {
+        jniThrowNullPointerException(env, NULL);
+        return 0;
+    }
+
+    const char* suffix8 = env->GetStringUTFChars(suffix, NULL);
+    if (suffix8 == NULL) {
+        jniThrowException(env, "java/lang/OutOfMemoryError", NULL);
+        return 0;
+    }
+    String8 fileSuffix(suffix8);
+    env->ReleaseStringUTFChars(suffix, suffix8);
+
+    const jsize N = env->GetArrayLength(pids);
+    const jsize NF = env->GetArrayLength(format);
+    const jsize NL = outLongs ? env->GetArrayLength(outLongs) : 0;
+    const jsize NR = outFloats ? env->GetArrayLength(outFloats) : 0;
+
+    jint* formatData = env->GetIntArrayElements(format, 0);
+    if (formatData == NULL) {
+        jniThrowException(env, "java/lang/OutOfMemoryError", NULL);
+        return 0;
+    }
+
+    // Output fields share one index space per row regardless of type.
+    jsize rowFields = 0;
+    for (jsize fi = 0; fi < NF; fi++) {
+        if ((formatData[fi]&PROC_OUT_STRING) != 0) {
+            env->ReleaseIntArrayElements(format, formatData, 0);
+            jniThrowException(env, "java/lang/IllegalArgumentException",
+                    "String fields not supported in batch reads");
+            return 0;
+        }
+        if ((formatData[fi]&(PROC_OUT_LONG|PROC_OUT_FLOAT)) != 0) {
+            rowFields++;
+        }
+    }
+    if ((outLongs && NL < N * rowFields) || (outFloats && NR < N * rowFields)) {
+        env->ReleaseIntArrayElements(format, formatData, 0);
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                "Output array too small for pid count");
+        return 0;
+    }
+
+    jint* pidsData = env->GetIntArrayElements(pids, 0);
+    jlong* longsData = outLongs ? env->GetLongArrayElements(outLongs, 0) : NULL;
+    jfloat* floatsData = outFloats ? env->GetFloatArrayElements(outFloats, 0) : NULL;
+    if (pidsData == NULL || (outLongs && longsData == NULL)
+            || (outFloats && floatsData == NULL)) {
+        env->ReleaseIntArrayElements(format, formatData, 0);
+        if (pidsData != NULL) {
+            env->ReleaseIntArrayElements(pids, pidsData, 0);
+        }
+        if (longsData != NULL) {
+            env->ReleaseLongArrayElements(outLongs, longsData, 0);
+        }
+        if (floatsData != NULL) {
+            env->ReleaseFloatArrayElements(outFloats, floatsData, 0);
+        }
+        jniThrowException(env, "java/lang/OutOfMemoryError", NULL);
+        return 0;
+    }
+
+    // Resolve the /proc prefix once and openat() below it, so each pid only
+    // costs the final two path components.  The read buffer keeps its
+    // capacity across pids instead of being reallocated per file.
+    int procFd = open("/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    std::vector<char> fileBuffer(kReadSize);
+    jint parsedCount = 0;
+
+    for (jsize pi = 0; pi < N; pi++) {
+        jlong* rowLongs = longsData ? longsData + pi * rowFields : NULL;
+        jfloat* rowFloats = floatsData ? floatsData + pi * rowFields : NULL;
+        bool parsed = false;
+
+        char path[64];
+        snprintf(path, sizeof(path), "%d/%s", pidsData[pi], fileSuffix.string());
+        int fd = procFd >= 0 ? openat(procFd, path, O_RDONLY | O_CLOEXEC) : -1;
+        if (fd >= 0) {
+            fileBuffer.resize(0);
+            int numBytesRead = 0;
+            while (true) {
+                fileBuffer.resize(numBytesRead + kReadSize, 0);
+                int len = TEMP_FAILURE_RETRY(
+                        read(fd, fileBuffer.data() + numBytesRead, kReadSize));
+                if (len < 0) {
+                    numBytesRead = -1;
+                    break;
+                } else if (len == 0) {
+                    break;
+                }
+                numBytesRead += len;
+            }
+            close(fd);
+
+            if (numBytesRead >= 0) {
+                fileBuffer.resize(numBytesRead);
+                fileBuffer.push_back('\0');
+                parsed = parse_proc_line(env, fileBuffer.data(), 0, numBytesRead,
+                        formatData, NF, NULL, 0, rowLongs, rowFields, rowFloats, rowFields);
+            }
+        } else if (kDebugProc) {
+            ALOGW("Unable to open /proc/%s\n", path);
+        }
+
+        if (parsed) {
+            parsedCount++;
+        } else {
+            for (jsize di = 0; di < rowFields; di++) {
+                if (rowLongs != NULL) rowLongs[di] = -1;
+                if (rowFloats != NULL) rowFloats[di] = -1;
+            }
+        }
+    }
+
+    if (procFd >= 0) {
+        close(procFd);
+    }
+
+    env->ReleaseIntArrayElements(format, formatData, 0);
+    env->ReleaseIntArrayElements(pids, pidsData, 0);
+    if (longsData != NULL) {
+        env->ReleaseLongArrayElements(outLongs, longsData, 0);
+    }
+    if (floatsData != NULL) {
+        env->ReleaseFloatArrayElements(outFloats, floatsData, 0);
+    }
+
+    return parsedCount;
+}
+
 void android_os_Process_setApplicationObject(JNIEnv* env, jobject clazz,
                                              jobject binderObject)
 {
@@ -1259,6 +1415,7 @@ static const JNINativeMethod methods[] = {
     {"readProcLines", "(Ljava/lang/String;[Ljava/lang/String;[J)V", (void*)android_os_Process_readProcLines},
     {"getPids", "(Ljava/lang/String;[I)[I", (void*)android_os_Process_getPids},
     {"readProcFile", "(Ljava/lang/String;[I[Ljava/lang/String;[J[F)Z", (void*)android_os_Process_readProcFile},
+    {"readProcFileBatch", "([ILjava/lang/String;[I[J[F)I", (void*)android_os_Process_readProcFileBatch},
     {"parseProcLine", "([BII[I[Ljava/lang/String;[J[F)Z", (void*)android_os_Process_parseProcLine},
     {"getElapsedCpuTime", "()J", (void*)android_os_Process_getElapsedCpuTime},
     {"getPss", "(I)J", (void*)android_os_Process_getPss},
@@ -129,10 +129,19 @@ jobject StrictJarFile_nativeNextEntry(JNIEnv* env, jobject, jlong iterationHandl
     return NULL;
   }
 
-  std::unique_ptr<char[]> entryNameCString(new char[entryName.name_length + 1]);
-  memcpy(entryNameCString.get(), entryName.name, entryName.name_length);
+  // The entry name isn't null-terminated, so it must be copied before
+  // NewStringUTF. A stack buffer covers virtually every real entry name and
+  // avoids a heap allocation per entry while the whole archive is iterated.
+  char stackBuffer[512];
+  std::unique_ptr<char[]> heapBuffer;
+  char* entryNameCString = stackBuffer;
+  if (entryName.name_length + 1 > sizeof(stackBuffer)) {
+    heapBuffer.reset(new char[entryName.name_length + 1]);
+    entryNameCString = heapBuffer.get();
+  }
+  memcpy(entryNameCString, entryName.name, entryName.name_length);
   entryNameCString[entryName.name_length] = '\0';
-  ScopedLocalRef<jstring> entryNameString(env, env->NewStringUTF(entryNameCString.get()));
+  ScopedLocalRef<jstring> entryNameString(env, env->NewStringUTF(entryNameCString));
 
   return newZipEntry(env, data, entryNameString.get());
 }
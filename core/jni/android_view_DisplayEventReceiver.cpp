@@ -22,6 +22,8 @@
 
 #include <inttypes.h>
 
+#include <vector>
+
 #include <android_runtime/AndroidRuntime.h>
 #include <androidfw/DisplayEventDispatcher.h>
 #include <utils/Log.h>
@@ -40,6 +42,7 @@ static struct {
     jclass clazz;
 
     jmethodID dispatchVsync;
+    jmethodID dispatchVsyncEvents;
     jmethodID dispatchHotplug;
     jmethodID dispatchConfigChanged;
 } gDisplayEventReceiverClassInfo;
@@ -62,6 +65,7 @@ private:
     DisplayEventReceiver mReceiver;
 
     void dispatchVsync(nsecs_t timestamp, PhysicalDisplayId displayId, uint32_t count) override;
+    void dispatchVsyncEvents(const std::vector<VsyncEvent>& events) override;
     void dispatchHotplug(nsecs_t timestamp, PhysicalDisplayId displayId, bool connected) override;
     void dispatchConfigChanged(nsecs_t timestamp, PhysicalDisplayId displayId,
                                int32_t configId) override;
@@ -105,6 +109,39 @@ void NativeDisplayEventReceiver::dispatchVsync(nsecs_t timestamp, PhysicalDispla
     mMessageQueue->raiseAndClearException(env, "dispatchVsync");
 }
 
+void NativeDisplayEventReceiver::dispatchVsyncEvents(const std::vector<VsyncEvent>& events) {
+    if (events.size() == 1) {
+        // The common single-display wake skips the array plumbing entirely.
+        dispatchVsync(events[0].timestamp, events[0].displayId, events[0].count);
+        return;
+    }
+
+    JNIEnv* env = AndroidRuntime::getJNIEnv();
+
+    ScopedLocalRef<jobject> receiverObj(env, jniGetReferent(env, mReceiverWeakGlobal));
+    if (receiverObj.get()) {
+        ALOGV("receiver %p ~ Invoking vsync handler for %zu displays.", this, events.size());
+        std::vector<jlong> packed;
+        packed.reserve(events.size() * 3);
+        for (const VsyncEvent& event : events) {
+            packed.push_back(event.timestamp);
+            packed.push_back(event.displayId);
+            packed.push_back(event.count);
+        }
+        ScopedLocalRef<jlongArray> array(env,
+                env->NewLongArray(static_cast<jsize>(packed.size())));
+        if (array.get()) {
+            env->SetLongArrayRegion(array.get(), 0, static_cast<jsize>(packed.size()),
+                    packed.data());
+            env->CallVoidMethod(receiverObj.get(),
+                    gDisplayEventReceiverClassInfo.dispatchVsyncEvents, array.get());
+        }
+        ALOGV("receiver %p ~ Returned from vsync handler.", this);
+    }
+
+    mMessageQueue->raiseAndClearException(env, "dispatchVsyncEvents");
+}
+
 void NativeDisplayEventReceiver::dispatchHotplug(nsecs_t timestamp, PhysicalDisplayId displayId,
                                                  bool connected) {
     JNIEnv* env = AndroidRuntime::getJNIEnv();
@@ -201,6 +238,8 @@ int register_android_view_DisplayEventReceiver(JNIEnv* env) {
 
     gDisplayEventReceiverClassInfo.dispatchVsync = GetMethodIDOrDie(env,
             gDisplayEventReceiverClassInfo.clazz, "dispatchVsync", "(JJI)V");
+    gDisplayEventReceiverClassInfo.dispatchVsyncEvents = GetMethodIDOrDie(env,
+            gDisplayEventReceiverClassInfo.clazz, "dispatchVsyncEvents", "([J)V");
     gDisplayEventReceiverClassInfo.dispatchHotplug = GetMethodIDOrDie(env,
             gDisplayEventReceiverClassInfo.clazz, "dispatchHotplug", "(JJZ)V");
     gDisplayEventReceiverClassInfo.dispatchConfigChanged = GetMethodIDOrDie(env,
@@ -99,19 +99,43 @@ status_t InputQueue::getEvent(InputEvent** outEvent) {
     }
 
     if (mPendingEvents.isEmpty()) {
-        char byteread[16];
-        ssize_t nRead;
-        do {
-            nRead = TEMP_FAILURE_RETRY(read(mDispatchReadFd, &byteread, sizeof(byteread)));
-            if (nRead < 0 && errno != EAGAIN) {
-                ALOGW("Failed to read from native dispatch pipe: %s", strerror(errno));
-            }
-        } while (nRead > 0);
+        clearDispatchPipeLocked();
     }
 
     return *outEvent != NULL ? OK : WOULD_BLOCK;
 }
 
+size_t InputQueue::drainEvents(InputEvent** outEvents, size_t maxEvents) {
+    Mutex::Autolock _l(mLock);
+    size_t count = mPendingEvents.size();
+    if (count > maxEvents) {
+        count = maxEvents;
+    }
+    for (size_t i = 0; i < count; i++) {
+        outEvents[i] = mPendingEvents[i];
+    }
+    if (count > 0) {
+        mPendingEvents.removeItemsAt(0, count);
+    }
+
+    if (mPendingEvents.isEmpty()) {
+        clearDispatchPipeLocked();
+    }
+
+    return count;
+}
+
+void InputQueue::clearDispatchPipeLocked() {
+    char byteread[16];
+    ssize_t nRead;
+    do {
+        nRead = TEMP_FAILURE_RETRY(read(mDispatchReadFd, &byteread, sizeof(byteread)));
+        if (nRead < 0 && errno != EAGAIN) {
+            ALOGW("Failed to read from native dispatch pipe: %s", strerror(errno));
+        }
+    } while (nRead > 0);
+}
+
 bool InputQueue::preDispatchEvent(InputEvent* e) {
     if (e->getType() == AINPUT_EVENT_TYPE_KEY) {
         KeyEvent* keyEvent = static_cast<KeyEvent*>(e);
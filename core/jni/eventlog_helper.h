@@ -84,6 +84,35 @@ public:
         ctx << (int64_t)value;
         return ctx.write(LogID);
     }
+    // Writes one (tag, value) counter event per entry. Callers accumulate
+    // high-frequency counters in Java arrays and drain them through a single
+    // JNI crossing; each entry is still its own logd record so readers see
+    // ordinary events with write-time ordering. Returns the number of events
+    // written, stopping at the first failed write.
+    static jint writeEventLongs(JNIEnv* env, jobject clazz ATTRIBUTE_UNUSED,
+            jintArray tags, jlongArray values) {
+        if (tags == nullptr || values == nullptr) {
+            jniThrowNullPointerException(env, nullptr);
+            return -1;
+        }
+        ScopedIntArrayRO tagArray(env, tags);
+        ScopedLongArrayRO valueArray(env, values);
+        if (tagArray.size() != valueArray.size()) {
+            jniThrowException(env, "java/lang/IllegalArgumentException",
+                    "tags and values differ in length");
+            return -1;
+        }
+        jint written = 0;
+        for (size_t i = 0; i < tagArray.size(); ++i) {
+            android_log_event_list ctx(tagArray[i]);
+            ctx << (int64_t)valueArray[i];
+            if (ctx.write(LogID) < 0) {
+                break;
+            }
+            ++written;
+        }
+        return written;
+    }
     static jint writeEventFloat(JNIEnv* env ATTRIBUTE_UNUSED, jobject clazz ATTRIBUTE_UNUSED,
             jint tag, jfloat value) {
         android_log_event_list ctx(tag);
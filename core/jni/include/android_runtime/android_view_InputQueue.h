@@ -44,6 +44,8 @@ public:
 
     status_t getEvent(InputEvent** outEvent);
 
+    size_t drainEvents(InputEvent** outEvents, size_t maxEvents);
+
     bool preDispatchEvent(InputEvent* event);
 
     void finishEvent(InputEvent* event, bool handled);
@@ -66,6 +68,7 @@ private:
             int readDispatchFd, int writeDispatchFd);
 
     void detachLooperLocked();
+    void clearDispatchPipeLocked();
 
     jobject mInputQueueWeakGlobal;
     int mDispatchReadFd;
@@ -17,6 +17,8 @@
 #include "androidfw/ApkAssets.h"
 
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "android-base/errors.h"
 #include "android-base/file.h"
@@ -55,6 +57,47 @@ std::unique_ptr<const ApkAssets> ApkAssets::LoadAsSharedLibrary(const std::strin
   return LoadImpl({} /*fd*/, path, nullptr, nullptr, system, true /*load_as_shared_library*/);
 }
 
+std::vector<std::unique_ptr<const ApkAssets>> ApkAssets::LoadParallel(
+    const std::vector<std::string>& paths, bool system) {
+  std::vector<std::unique_ptr<const ApkAssets>> results(paths.size());
+  if (paths.empty()) {
+    return results;
+  }
+
+  // Each load is independent, so hand the paths out to a small pool of threads. Cap the pool
+  // so that loading a large number of splits doesn't spawn a thread per split.
+  constexpr size_t kMaxLoadThreads = 4u;
+  const size_t thread_count =
+      std::min({paths.size(), static_cast<size_t>(std::thread::hardware_concurrency()),
+                kMaxLoadThreads});
+  if (thread_count <= 1u) {
+    for (size_t i = 0; i < paths.size(); i++) {
+      results[i] = Load(paths[i], system);
+    }
+    return results;
+  }
+
+  std::atomic<size_t> next_path(0);
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (size_t t = 0; t < thread_count; t++) {
+    threads.emplace_back([&]() {
+      while (true) {
+        const size_t i = next_path.fetch_add(1u, std::memory_order_relaxed);
+        if (i >= paths.size()) {
+          return;
+        }
+        results[i] = Load(paths[i], system);
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
 std::unique_ptr<const ApkAssets> ApkAssets::LoadOverlay(const std::string& idmap_path,
                                                         bool system) {
   std::unique_ptr<Asset> idmap_asset = CreateAssetFromFile(idmap_path);
@@ -74,6 +117,47 @@ std::unique_ptr<const ApkAssets> ApkAssets::LoadOverlay(const std::string& idmap
                   std::move(loaded_idmap), system, false /*load_as_shared_library*/);
 }
 
+std::vector<std::unique_ptr<const ApkAssets>> ApkAssets::LoadOverlayParallel(
+    const std::vector<std::string>& idmap_paths, bool system) {
+  std::vector<std::unique_ptr<const ApkAssets>> results(idmap_paths.size());
+  if (idmap_paths.empty()) {
+    return results;
+  }
+
+  // Each idmap references a distinct overlay APK, so the loads don't share any state and can
+  // be distributed the same way LoadParallel() distributes split APKs.
+  constexpr size_t kMaxLoadThreads = 4u;
+  const size_t thread_count =
+      std::min({idmap_paths.size(), static_cast<size_t>(std::thread::hardware_concurrency()),
+                kMaxLoadThreads});
+  if (thread_count <= 1u) {
+    for (size_t i = 0; i < idmap_paths.size(); i++) {
+      results[i] = LoadOverlay(idmap_paths[i], system);
+    }
+    return results;
+  }
+
+  std::atomic<size_t> next_path(0);
+  std::vector<std::thread> threads;
+  threads.reserve(thread_count);
+  for (size_t t = 0; t < thread_count; t++) {
+    threads.emplace_back([&]() {
+      while (true) {
+        const size_t i = next_path.fetch_add(1u, std::memory_order_relaxed);
+        if (i >= idmap_paths.size()) {
+          return;
+        }
+        results[i] = LoadOverlay(idmap_paths[i], system);
+      }
+    });
+  }
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  return results;
+}
+
 std::unique_ptr<const ApkAssets> ApkAssets::LoadFromFd(unique_fd fd,
                                                        const std::string& friendly_name,
                                                        bool system, bool force_shared_lib) {
@@ -223,8 +307,10 @@ bool ApkAssets::ForEachFile(const std::string& root_path,
   ::ZipEntry entry;
 
   // We need to hold back directories because many paths will contain them and we want to only
-  // surface one.
-  std::set<std::string> dirs;
+  // surface one. The names returned by the iterator point into the mmapped central directory,
+  // which outlives this scan, so views are enough and deduplicating a large assets/ tree does
+  // not allocate a string per entry.
+  std::set<StringPiece> dirs;
 
   int32_t result;
   while ((result = ::Next(cookie, &entry, &name)) == 0) {
@@ -234,9 +320,7 @@ bool ApkAssets::ForEachFile(const std::string& root_path,
     if (!leaf_file_path.empty()) {
       auto iter = std::find(leaf_file_path.begin(), leaf_file_path.end(), '/');
       if (iter != leaf_file_path.end()) {
-        std::string dir =
-            leaf_file_path.substr(0, std::distance(leaf_file_path.begin(), iter)).to_string();
-        dirs.insert(std::move(dir));
+        dirs.insert(leaf_file_path.substr(0, std::distance(leaf_file_path.begin(), iter)));
       } else {
         f(leaf_file_path, kFileTypeRegular);
       }
@@ -245,7 +329,7 @@ bool ApkAssets::ForEachFile(const std::string& root_path,
   ::EndIteration(cookie);
 
   // Now present the unique directories.
-  for (const std::string& dir : dirs) {
+  for (const StringPiece& dir : dirs) {
     f(dir, kFileTypeDirectory);
   }
 
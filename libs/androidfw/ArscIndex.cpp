@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "androidfw/ArscIndex.h"
+
+#include <limits>
+
+#include "android-base/logging.h"
+
+#include "androidfw/Chunk.h"
+#include "androidfw/ResourceTypes.h"
+#include "androidfw/Util.h"
+
+namespace android {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x58444941u;  // 'AIDX'
+constexpr uint32_t kVersion = 1u;
+
+// How many leading bytes of the resources.arsc participate in the fingerprint. The
+// fingerprint only guards against using an index with the wrong file; full validation
+// of the recorded offsets happens in Load().
+constexpr size_t kFingerprintLength = 4096u;
+
+struct IndexHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t arsc_size;
+  uint32_t arsc_fingerprint;
+  uint32_t table_count;
+};
+
+uint32_t Fingerprint(const StringPiece& arsc_data) {
+  // FNV-1a over the leading bytes. The resource table header and string pool header live
+  // here, which is enough to tell two different tables apart cheaply.
+  const size_t len = std::min(arsc_data.size(), kFingerprintLength);
+  uint32_t hash = 0x811c9dc5u;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<uint8_t>(arsc_data.data()[i])) * 0x01000193u;
+  }
+  return hash;
+}
+
+void WriteUint32(std::string* out, uint32_t value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+class IndexReader {
+ public:
+  IndexReader(const void* data, size_t size)
+      : data_(reinterpret_cast<const uint8_t*>(data)), size_(size) {
+  }
+
+  bool ReadUint32(uint32_t* out) {
+    if (size_ - pos_ < sizeof(uint32_t)) {
+      return false;
+    }
+    memcpy(out, data_ + pos_, sizeof(uint32_t));
+    pos_ += sizeof(uint32_t);
+    return true;
+  }
+
+  bool AtEnd() const {
+    return pos_ == size_;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t pos_ = 0u;
+};
+
+// Verifies that `offset` points at a well-formed chunk header lying entirely within
+// [parent_offset, parent_end) of the resources.arsc data.
+bool VerifyChunkOffset(const StringPiece& arsc_data, uint32_t offset, uint32_t parent_offset,
+                       uint32_t parent_end) {
+  if (offset & 0x03u) {
+    LOG(ERROR) << "ArscIndex chunk offset " << offset << " is not 4-byte aligned.";
+    return false;
+  }
+
+  if (offset < parent_offset || parent_end < sizeof(ResChunk_header) ||
+      offset > parent_end - sizeof(ResChunk_header)) {
+    LOG(ERROR) << "ArscIndex chunk offset " << offset << " is out of bounds.";
+    return false;
+  }
+
+  const ResChunk_header* header =
+      reinterpret_cast<const ResChunk_header*>(arsc_data.data() + offset);
+  const size_t chunk_size = dtohl(header->size);
+  const size_t header_size = dtohs(header->headerSize);
+  if (chunk_size < header_size || chunk_size < sizeof(ResChunk_header) ||
+      chunk_size > parent_end - offset) {
+    LOG(ERROR) << "ArscIndex chunk at offset " << offset << " has invalid size.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+std::string ArscIndex::Build(const StringPiece& arsc_data) {
+  std::string index;
+  std::string body;
+
+  const uint8_t* base = reinterpret_cast<const uint8_t*>(arsc_data.data());
+
+  uint32_t table_count = 0u;
+  ChunkIterator iter(arsc_data.data(), arsc_data.size());
+  while (iter.HasNext()) {
+    const Chunk chunk = iter.Next();
+    if (chunk.type() != RES_TABLE_TYPE) {
+      continue;
+    }
+    table_count++;
+
+    const uint32_t table_offset =
+        static_cast<uint32_t>(reinterpret_cast<const uint8_t*>(chunk.header<ResChunk_header>()) -
+                              base);
+    WriteUint32(&body, table_offset);
+
+    std::string children_body;
+    uint32_t child_count = 0u;
+    ChunkIterator table_iter(chunk.data_ptr(), chunk.data_size());
+    while (table_iter.HasNext()) {
+      const Chunk child_chunk = table_iter.Next();
+      child_count++;
+
+      const uint32_t child_offset = static_cast<uint32_t>(
+          reinterpret_cast<const uint8_t*>(child_chunk.header<ResChunk_header>()) - base);
+      WriteUint32(&children_body, child_offset);
+
+      // Only package chunks have children worth recording.
+      std::string grandchildren_body;
+      uint32_t grandchild_count = 0u;
+      if (child_chunk.type() == RES_TABLE_PACKAGE_TYPE) {
+        ChunkIterator package_iter(child_chunk.data_ptr(), child_chunk.data_size());
+        while (package_iter.HasNext()) {
+          const Chunk package_child = package_iter.Next();
+          grandchild_count++;
+          WriteUint32(&grandchildren_body,
+                      static_cast<uint32_t>(
+                          reinterpret_cast<const uint8_t*>(package_child.header<ResChunk_header>()) -
+                          base));
+        }
+
+        if (package_iter.HadError()) {
+          LOG(ERROR) << package_iter.GetLastError();
+          return {};
+        }
+      }
+
+      WriteUint32(&children_body, grandchild_count);
+      children_body += grandchildren_body;
+    }
+
+    if (table_iter.HadError()) {
+      LOG(ERROR) << table_iter.GetLastError();
+      return {};
+    }
+
+    WriteUint32(&body, child_count);
+    body += children_body;
+  }
+
+  if (iter.HadError()) {
+    LOG(ERROR) << iter.GetLastError();
+    return {};
+  }
+
+  if (table_count == 0u) {
+    LOG(ERROR) << "No RES_TABLE_TYPE chunk found while building ArscIndex.";
+    return {};
+  }
+
+  IndexHeader header;
+  header.magic = kMagic;
+  header.version = kVersion;
+  header.arsc_size = static_cast<uint32_t>(arsc_data.size());
+  header.arsc_fingerprint = Fingerprint(arsc_data);
+  header.table_count = table_count;
+  index.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  index += body;
+  return index;
+}
+
+std::unique_ptr<const ArscIndex> ArscIndex::Load(const StringPiece& index_data,
+                                                 const StringPiece& arsc_data) {
+  if (index_data.size() < sizeof(IndexHeader)) {
+    LOG(ERROR) << "ArscIndex too small to contain header.";
+    return {};
+  }
+
+  IndexHeader header;
+  memcpy(&header, index_data.data(), sizeof(header));
+  if (header.magic != kMagic) {
+    LOG(ERROR) << "ArscIndex has invalid magic.";
+    return {};
+  }
+
+  if (header.version != kVersion) {
+    LOG(ERROR) << "ArscIndex has unsupported version " << header.version << ".";
+    return {};
+  }
+
+  if (header.arsc_size != arsc_data.size() ||
+      header.arsc_fingerprint != Fingerprint(arsc_data)) {
+    LOG(ERROR) << "ArscIndex was built from different resources.arsc contents.";
+    return {};
+  }
+
+  // Not using make_unique because the constructor is private.
+  std::unique_ptr<ArscIndex> index(new ArscIndex());
+  index->tables_.reserve(header.table_count);
+
+  const uint32_t arsc_size = static_cast<uint32_t>(arsc_data.size());
+  IndexReader reader(index_data.data() + sizeof(IndexHeader),
+                     index_data.size() - sizeof(IndexHeader));
+  for (uint32_t t = 0; t < header.table_count; t++) {
+    TableIndex table;
+    uint32_t child_count;
+    if (!reader.ReadUint32(&table.offset) || !reader.ReadUint32(&child_count)) {
+      LOG(ERROR) << "ArscIndex truncated while reading table entries.";
+      return {};
+    }
+
+    if (!VerifyChunkOffset(arsc_data, table.offset, 0u, arsc_size)) {
+      return {};
+    }
+
+    const ResChunk_header* table_header =
+        reinterpret_cast<const ResChunk_header*>(arsc_data.data() + table.offset);
+    if (dtohs(table_header->type) != RES_TABLE_TYPE) {
+      LOG(ERROR) << "ArscIndex table offset does not point at a RES_TABLE_TYPE chunk.";
+      return {};
+    }
+    const uint32_t table_end = table.offset + dtohl(table_header->size);
+
+    table.children.reserve(child_count);
+    for (uint32_t c = 0; c < child_count; c++) {
+      ChunkIndex child;
+      uint32_t grandchild_count;
+      if (!reader.ReadUint32(&child.offset) || !reader.ReadUint32(&grandchild_count)) {
+        LOG(ERROR) << "ArscIndex truncated while reading chunk entries.";
+        return {};
+      }
+
+      if (!VerifyChunkOffset(arsc_data, child.offset, table.offset, table_end)) {
+        return {};
+      }
+
+      const ResChunk_header* child_header =
+          reinterpret_cast<const ResChunk_header*>(arsc_data.data() + child.offset);
+      const uint32_t child_end = child.offset + dtohl(child_header->size);
+
+      child.children.reserve(grandchild_count);
+      for (uint32_t g = 0; g < grandchild_count; g++) {
+        uint32_t grandchild_offset;
+        if (!reader.ReadUint32(&grandchild_offset)) {
+          LOG(ERROR) << "ArscIndex truncated while reading chunk entries.";
+          return {};
+        }
+
+        if (!VerifyChunkOffset(arsc_data, grandchild_offset, child.offset, child_end)) {
+          return {};
+        }
+        child.children.push_back(grandchild_offset);
+      }
+      table.children.push_back(std::move(child));
+    }
+    index->tables_.push_back(std::move(table));
+  }
+
+  if (!reader.AtEnd()) {
+    LOG(ERROR) << "ArscIndex has trailing data.";
+    return {};
+  }
+
+  // Need to force a move for mingw32.
+  return std::move(index);
+}
+
+}  // namespace android
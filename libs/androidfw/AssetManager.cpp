@@ -44,6 +44,7 @@
 #include <errno.h>
 #include <string.h> // strerror
 #include <strings.h>
+#include <sys/stat.h>
 
 #ifndef TEMP_FAILURE_RETRY
 /* Used to retry syscalls that can return EINTR. */
@@ -1420,8 +1421,22 @@ void AssetManager::mergeInfoLocked(SortedVector<AssetDir::FileInfo>* pMergedInfo
 Mutex AssetManager::SharedZip::gLock;
 DefaultKeyedVector<String8, wp<AssetManager::SharedZip> > AssetManager::SharedZip::gOpen;
 
-AssetManager::SharedZip::SharedZip(const String8& path, time_t modWhen)
-    : mPath(path), mZipFile(NULL), mModWhen(modWhen),
+// Stat the file once and report both values used to validate cached entries.
+// On failure both outputs are set to -1, which never matches a live zip.
+static void getFileStamp(const char* fileName, time_t* outModWhen, off64_t* outFileSize)
+{
+    struct stat sb;
+    if (stat(fileName, &sb) < 0) {
+        *outModWhen = (time_t) -1;
+        *outFileSize = (off64_t) -1;
+        return;
+    }
+    *outModWhen = sb.st_mtime;
+    *outFileSize = sb.st_size;
+}
+
+AssetManager::SharedZip::SharedZip(const String8& path, time_t modWhen, off64_t fileSize)
+    : mPath(path), mZipFile(NULL), mModWhen(modWhen), mFileSize(fileSize),
       mResourceTableAsset(NULL), mResourceTable(NULL)
 {
     if (kIsDebug) {
@@ -1435,7 +1450,7 @@ AssetManager::SharedZip::SharedZip(const String8& path, time_t modWhen)
 }
 
 AssetManager::SharedZip::SharedZip(int fd, const String8& path)
-    : mPath(path), mZipFile(NULL), mModWhen(0),
+    : mPath(path), mZipFile(NULL), mModWhen(0), mFileSize(-1),
       mResourceTableAsset(NULL), mResourceTable(NULL)
 {
     if (kIsDebug) {
@@ -1453,15 +1468,17 @@ sp<AssetManager::SharedZip> AssetManager::SharedZip::get(const String8& path,
         bool createIfNotPresent)
 {
     AutoMutex _l(gLock);
-    time_t modWhen = getFileModDate(path);
+    time_t modWhen;
+    off64_t fileSize;
+    getFileStamp(path, &modWhen, &fileSize);
     sp<SharedZip> zip = gOpen.valueFor(path).promote();
-    if (zip != NULL && zip->mModWhen == modWhen) {
+    if (zip != NULL && zip->mModWhen == modWhen && zip->mFileSize == fileSize) {
         return zip;
     }
     if (zip == NULL && !createIfNotPresent) {
         return NULL;
     }
-    zip = new SharedZip(path, modWhen);
+    zip = new SharedZip(path, modWhen, fileSize);
     gOpen.add(path, zip);
     return zip;
 }
@@ -1520,8 +1537,10 @@ ResTable* AssetManager::SharedZip::setResourceTable(ResTable* res)
 
 bool AssetManager::SharedZip::isUpToDate()
 {
-    time_t modWhen = getFileModDate(mPath.string());
-    return mModWhen == modWhen;
+    time_t modWhen;
+    off64_t fileSize;
+    getFileStamp(mPath.string(), &modWhen, &fileSize);
+    return mModWhen == modWhen && mFileSize == fileSize;
 }
 
 void AssetManager::SharedZip::addOverlay(const asset_path& ap)
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <iterator>
 #include <map>
+#include <numeric>
 #include <set>
 #include <sstream>
 
@@ -45,35 +46,13 @@
 
 namespace android {
 
-struct FindEntryResult {
-  // A pointer to the resource table entry for this resource.
-  // If the size of the entry is > sizeof(ResTable_entry), it can be cast to
-  // a ResTable_map_entry and processed as a bag/map.
-  const ResTable_entry* entry;
-
-  // The configuration for which the resulting entry was defined. This is already swapped to host
-  // endianness.
-  ResTable_config config;
-
-  // The bitmask of configuration axis with which the resource value varies.
-  uint32_t type_flags;
-
-  // The dynamic package ID map for the package from which this resource came from.
-  const DynamicRefTable* dynamic_ref_table;
-
-  // The string pool reference to the type's name. This uses a different string pool than
-  // the global string pool, but this is hidden from the caller.
-  StringPoolRef type_string_ref;
-
-  // The string pool reference to the entry's name. This uses a different string pool than
-  // the global string pool, but this is hidden from the caller.
-  StringPoolRef entry_string_ref;
-};
-
 AssetManager2::AssetManager2() {
   memset(&configuration_, 0, sizeof(configuration_));
 }
 
+// Defined here so that the cached Theme chain snapshots can be destroyed with a complete type.
+AssetManager2::~AssetManager2() = default;
+
 bool AssetManager2::SetApkAssets(const std::vector<const ApkAssets*>& apk_assets,
                                  bool invalidate_caches, bool filter_incompatible_configs) {
   apk_assets_ = apk_assets;
@@ -243,49 +222,65 @@ void AssetManager2::SetConfiguration(const ResTable_config& configuration) {
 std::set<ResTable_config> AssetManager2::GetResourceConfigurations(bool exclude_system,
                                                                    bool exclude_mipmap) const {
   ATRACE_NAME("AssetManager::GetResourceConfigurations");
-  std::set<ResTable_config> configurations;
-  for (const PackageGroup& package_group : package_groups_) {
-    bool found_system_package = false;
-    for (const ConfiguredPackage& package : package_group.packages_) {
-      if (exclude_system && package.loaded_package_->IsSystem()) {
-        found_system_package = true;
-        continue;
-      }
+  CachedConfigurations& cache =
+      cached_resource_configurations_[(exclude_system ? 2 : 0) + (exclude_mipmap ? 1 : 0)];
+  if (!cache.valid) {
+    std::set<ResTable_config> configurations;
+    for (const PackageGroup& package_group : package_groups_) {
+      bool found_system_package = false;
+      for (const ConfiguredPackage& package : package_group.packages_) {
+        if (exclude_system && package.loaded_package_->IsSystem()) {
+          found_system_package = true;
+          continue;
+        }
 
-      if (exclude_system && package.loaded_package_->IsOverlay() && found_system_package) {
-        // Overlays must appear after the target package to take effect. Any overlay found in the
-        // same package as a system package is able to overlay system resources.
-        continue;
-      }
+        if (exclude_system && package.loaded_package_->IsOverlay() && found_system_package) {
+          // Overlays must appear after the target package to take effect. Any overlay found in the
+          // same package as a system package is able to overlay system resources.
+          continue;
+        }
 
-      package.loaded_package_->CollectConfigurations(exclude_mipmap, &configurations);
+        package.loaded_package_->CollectConfigurations(exclude_mipmap, &configurations);
+      }
     }
+    cache.configurations.assign(configurations.begin(), configurations.end());
+    cache.valid = true;
   }
-  return configurations;
+
+  // The cached vector is sorted, so building the returned set is a linear merge instead of
+  // a walk over every type spec in every package.
+  return std::set<ResTable_config>(cache.configurations.begin(), cache.configurations.end());
 }
 
 std::set<std::string> AssetManager2::GetResourceLocales(bool exclude_system,
                                                         bool merge_equivalent_languages) const {
   ATRACE_NAME("AssetManager::GetResourceLocales");
-  std::set<std::string> locales;
-  for (const PackageGroup& package_group : package_groups_) {
-    bool found_system_package = false;
-    for (const ConfiguredPackage& package : package_group.packages_) {
-      if (exclude_system && package.loaded_package_->IsSystem()) {
-        found_system_package = true;
-        continue;
-      }
+  CachedLocales& cache =
+      cached_resource_locales_[(exclude_system ? 2 : 0) + (merge_equivalent_languages ? 1 : 0)];
+  if (!cache.valid) {
+    std::set<std::string> locales;
+    for (const PackageGroup& package_group : package_groups_) {
+      bool found_system_package = false;
+      for (const ConfiguredPackage& package : package_group.packages_) {
+        if (exclude_system && package.loaded_package_->IsSystem()) {
+          found_system_package = true;
+          continue;
+        }
 
-      if (exclude_system && package.loaded_package_->IsOverlay() && found_system_package) {
-        // Overlays must appear after the target package to take effect. Any overlay found in the
-        // same package as a system package is able to overlay system resources.
-        continue;
-      }
+        if (exclude_system && package.loaded_package_->IsOverlay() && found_system_package) {
+          // Overlays must appear after the target package to take effect. Any overlay found in the
+          // same package as a system package is able to overlay system resources.
+          continue;
+        }
 
-      package.loaded_package_->CollectLocales(merge_equivalent_languages, &locales);
+        package.loaded_package_->CollectLocales(merge_equivalent_languages, &locales);
+      }
     }
+    cache.locales.assign(locales.begin(), locales.end());
+    cache.valid = true;
   }
-  return locales;
+
+  return std::set<std::string>(cache.locales.begin(), cache.locales.end());
 }
 
 std::unique_ptr<Asset> AssetManager2::Open(const std::string& filename,
@@ -314,11 +309,14 @@ std::unique_ptr<AssetDir> AssetManager2::OpenDir(const std::string& dirname) con
       continue;
     }
 
+    // String8 shares its backing store between copies, so building the source name once per
+    // APK means every FileInfo for that APK references the same allocation.
+    const String8 source_name(apk_assets->GetPath().c_str());
     auto func = [&](const StringPiece& name, FileType type) {
       AssetDir::FileInfo info;
       info.setFileName(String8(name.data(), name.size()));
       info.setFileType(type);
-      info.setSourceName(String8(apk_assets->GetPath().c_str()));
+      info.setSourceName(source_name);
       files->add(info);
     };
 
@@ -419,6 +417,19 @@ ApkAssetsCookie AssetManager2::FindEntry(uint32_t resid, uint16_t density_overri
   // and we don't need to match the configurations, since they already matched.
   const bool use_fast_path = !ignore_configuration && desired_config == &configuration_;
 
+  // Lookups against the set configuration are fully determined by the resource ID and can be
+  // served from the resolved entry cache. Bypass the cache when resolution logging is enabled
+  // so that the resolution steps are recorded for every lookup.
+  const bool use_resolved_cache = use_fast_path && !resource_resolution_logging_enabled_;
+  if (use_resolved_cache) {
+    std::lock_guard<std::mutex> cache_lock(cached_resolved_entries_lock_);
+    auto cached_iter = cached_resolved_entries_.find(resid);
+    if (cached_iter != cached_resolved_entries_.end()) {
+      *out_entry = cached_iter->second.entry;
+      return cached_iter->second.cookie;
+    }
+  }
+
   for (size_t pi = 0; pi < package_count; pi++) {
     const ConfiguredPackage& loaded_package_impl = package_group.packages_[pi];
     const LoadedPackage* loaded_package = loaded_package_impl.loaded_package_;
@@ -454,7 +465,15 @@ ApkAssetsCookie AssetManager2::FindEntry(uint32_t resid, uint16_t density_overri
         const ResTable_config& this_config = candidate_configs[i];
 
         // We can skip calling ResTable_config::match() because we know that all candidate
-        // configurations that do NOT match have been filtered-out.
+        // configurations that do NOT match have been filtered-out. The candidates are also
+        // ranked best-match-first, so the first one that defines this entry wins within this
+        // package and only the cross-package comparison below still needs isBetterThan().
+        const ResTable_type* type = filtered_group.types[i];
+        const uint32_t offset = LoadedPackage::GetEntryOffset(type, local_entry_idx);
+        if (offset == ResTable_type::NO_ENTRY) {
+          continue;
+        }
+
         if (best_config == nullptr) {
           resolution_type = Resolution::Step::Type::INITIAL;
         } else if (this_config.isBetterThan(*best_config, desired_config)) {
@@ -462,15 +481,9 @@ ApkAssetsCookie AssetManager2::FindEntry(uint32_t resid, uint16_t density_overri
         } else if (package_is_overlay && this_config.compare(*best_config) == 0) {
           resolution_type = Resolution::Step::Type::OVERLAID;
         } else {
-          continue;
-        }
-
-        // The configuration matches and is better than the previous selection.
-        // Find the entry value if it exists for this configuration.
-        const ResTable_type* type = filtered_group.types[i];
-        const uint32_t offset = LoadedPackage::GetEntryOffset(type, local_entry_idx);
-        if (offset == ResTable_type::NO_ENTRY) {
-          continue;
+          // Everything ranked after this candidate is an equal or worse match, so nothing
+          // further in this package can beat the current best.
+          break;
         }
 
         best_cookie = cookie;
@@ -484,6 +497,12 @@ ApkAssetsCookie AssetManager2::FindEntry(uint32_t resid, uint16_t density_overri
                                                       this_config.toString(),
                                                       &loaded_package->GetPackageName()});
         }
+
+        if (!package_is_overlay) {
+          // For overlay packages an equivalent configuration later in the ranked order must
+          // still take precedence, so only non-overlay packages can stop at the first hit.
+          break;
+        }
       }
     } else {
       // This is the slower path, which doesn't use the filtered list of configurations.
@@ -569,9 +588,18 @@ ApkAssetsCookie AssetManager2::FindEntry(uint32_t resid, uint16_t density_overri
         StringPoolRef(best_package->GetKeyStringPool(), best_entry->key.index);
   }
 
+  if (use_resolved_cache) {
+    std::lock_guard<std::mutex> cache_lock(cached_resolved_entries_lock_);
+    cached_resolved_entries_[resid] = CachedResolvedEntry{best_cookie, *out_entry};
+  }
+
   return best_cookie;
 }
 
+bool AssetManager2::IsResourceResolutionLoggingEnabled() const {
+  return resource_resolution_logging_enabled_;
+}
+
 void AssetManager2::SetResourceResolutionLoggingEnabled(bool enabled) {
   resource_resolution_logging_enabled_ = enabled;
 
@@ -1054,6 +1082,29 @@ void AssetManager2::RebuildFilterList(bool filter_incompatible_configs) {
             group.types.push_back(*iter);
           }
         }
+
+        // Rank the candidates best-match-first for the current configuration so that
+        // FindEntry() can stop at the first one that defines the requested entry. The
+        // sort is stable so equivalent configurations keep their table order, which
+        // overlay resolution depends on.
+        const size_t candidate_count = group.configurations.size();
+        if (candidate_count > 1) {
+          std::vector<size_t> ranked(candidate_count);
+          std::iota(ranked.begin(), ranked.end(), 0u);
+          std::stable_sort(ranked.begin(), ranked.end(), [&group, this](size_t a, size_t b) {
+            return group.configurations[a].isBetterThan(group.configurations[b],
+                                                        &configuration_);
+          });
+
+          FilteredConfigGroup ranked_group;
+          ranked_group.configurations.reserve(candidate_count);
+          ranked_group.types.reserve(candidate_count);
+          for (const size_t original_index : ranked) {
+            ranked_group.configurations.push_back(group.configurations[original_index]);
+            ranked_group.types.push_back(group.types[original_index]);
+          }
+          group = std::move(ranked_group);
+        }
       });
     }
   }
@@ -1065,9 +1116,34 @@ void AssetManager2::InvalidateCaches(uint32_t diff) {
   if (diff == 0xffffffffu) {
     // Everything must go.
     cached_bags_.clear();
+    {
+      std::lock_guard<std::mutex> cache_lock(cached_resolved_entries_lock_);
+      cached_resolved_entries_.clear();
+    }
+    cached_theme_chains_.clear();
+
+    // The set of defined configurations and locales only varies with the set of ApkAssets,
+    // which is the only thing that invalidates with the full diff.
+    for (CachedConfigurations& cache : cached_resource_configurations_) {
+      cache.valid = false;
+      cache.configurations.clear();
+    }
+    for (CachedLocales& cache : cached_resource_locales_) {
+      cache.valid = false;
+      cache.locales.clear();
+    }
     return;
   }
 
+  // Purge the flattened theme chains that vary with an axis that changed.
+  for (auto iter = cached_theme_chains_.cbegin(); iter != cached_theme_chains_.cend();) {
+    if (diff & iter->second->GetChangingConfigurations()) {
+      iter = cached_theme_chains_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
   // Be more conservative with what gets purged. Only if the bag has other possible
   // variations with respect to what changed (diff) should we remove it.
   for (auto iter = cached_bags_.cbegin(); iter != cached_bags_.cend();) {
@@ -1077,6 +1153,16 @@ void AssetManager2::InvalidateCaches(uint32_t diff) {
       ++iter;
     }
   }
+
+  // The same applies to resolved entries: only purge those that vary with an axis that changed.
+  std::lock_guard<std::mutex> cache_lock(cached_resolved_entries_lock_);
+  for (auto iter = cached_resolved_entries_.cbegin(); iter != cached_resolved_entries_.cend();) {
+    if (diff & iter->second.entry.type_flags) {
+      iter = cached_resolved_entries_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
 }
 
 uint8_t AssetManager2::GetAssignedPackageId(const LoadedPackage* package) {
@@ -1094,6 +1180,21 @@ std::unique_ptr<Theme> AssetManager2::NewTheme() {
   return std::unique_ptr<Theme>(new Theme(this));
 }
 
+const Theme* AssetManager2::GetCachedThemeChain(const std::string& chain_key) const {
+  auto iter = cached_theme_chains_.find(chain_key);
+  return iter != cached_theme_chains_.end() ? iter->second.get() : nullptr;
+}
+
+void AssetManager2::CacheThemeChain(const std::string& chain_key, const Theme& theme) {
+  if (cached_theme_chains_.find(chain_key) != cached_theme_chains_.end()) {
+    return;
+  }
+
+  std::unique_ptr<Theme> snapshot(new Theme(this));
+  snapshot->SetTo(theme);
+  cached_theme_chains_[chain_key] = std::move(snapshot);
+}
+
 Theme::Theme(AssetManager2* asset_manager) : asset_manager_(asset_manager) {
 }
 
@@ -1125,8 +1226,23 @@ struct Theme::Package {
 bool Theme::ApplyStyle(uint32_t resid, bool force) {
   ATRACE_NAME("Theme::ApplyStyle");
 
+  if (cacheable_) {
+    // Extend the key identifying the chain of styles applied to this theme, and check whether
+    // another theme has already flattened this exact chain. On a hit the flattened attribute
+    // table is copied wholesale instead of replaying the style bags.
+    chain_key_.append(reinterpret_cast<const char*>(&resid), sizeof(resid));
+    chain_key_.push_back(force ? 1 : 0);
+    const Theme* cached_chain = asset_manager_->GetCachedThemeChain(chain_key_);
+    if (cached_chain != nullptr) {
+      SetTo(*cached_chain);
+      return true;
+    }
+  }
+
   const ResolvedBag* bag = asset_manager_->GetBag(resid);
   if (bag == nullptr) {
+    // The theme's contents no longer match its chain key, so it can't seed the cache.
+    cacheable_ = false;
     return false;
   }
 
@@ -1148,6 +1264,7 @@ bool Theme::ApplyStyle(uint32_t resid, bool force) {
     // If the resource ID passed in is not a style, the key can be some other identifier that is not
     // a resource ID. We should fail fast instead of operating with strange resource IDs.
     if (!is_valid_resid(attr_resid)) {
+      cacheable_ = false;
       return false;
     }
 
@@ -1201,9 +1318,38 @@ bool Theme::ApplyStyle(uint32_t resid, bool force) {
       entry.value = bag_iter->value;
     }
   }
+
+  if (cacheable_) {
+    asset_manager_->CacheThemeChain(chain_key_, *this);
+  }
   return true;
 }
 
+bool Theme::Rebase(const uint32_t* style_resids, const uint8_t* force, size_t style_count) {
+  ATRACE_NAME("Theme::Rebase");
+
+  // Serialize the requested chain the same way ApplyStyle() does. If it matches the chain
+  // that produced this theme's current contents, there is nothing to replay.
+  std::string new_key;
+  new_key.reserve(style_count * (sizeof(uint32_t) + 1));
+  for (size_t i = 0; i < style_count; i++) {
+    new_key.append(reinterpret_cast<const char*>(&style_resids[i]), sizeof(style_resids[i]));
+    new_key.push_back(force[i] ? 1 : 0);
+  }
+  if (cacheable_ && new_key == chain_key_) {
+    return true;
+  }
+
+  // The chains differ, so rebuild from scratch. Each ApplyStyle() still consults the
+  // flattened chain cache, so replaying a chain another theme has built stays cheap.
+  Clear();
+  bool success = true;
+  for (size_t i = 0; i < style_count; i++) {
+    success = ApplyStyle(style_resids[i], force[i] != 0u) && success;
+  }
+  return success;
+}
+
 ApkAssetsCookie Theme::GetAttribute(uint32_t resid, Res_value* out_value,
                                     uint32_t* out_flags) const {
   int cnt = 20;
@@ -1270,6 +1416,8 @@ ApkAssetsCookie Theme::ResolveAttributeReference(ApkAssetsCookie cookie, Res_val
 
 void Theme::Clear() {
   type_spec_flags_ = 0u;
+  chain_key_.clear();
+  cacheable_ = true;
   for (std::unique_ptr<Package>& package : packages_) {
     package.reset();
   }
@@ -1283,6 +1431,10 @@ void Theme::SetTo(const Theme& o) {
   type_spec_flags_ = o.type_spec_flags_;
 
   if (asset_manager_ == o.asset_manager_) {
+    // The copied theme has the exact same contents, so it inherits the source's chain key.
+    chain_key_ = o.chain_key_;
+    cacheable_ = o.cacheable_;
+
     // The theme comes from the same asset manager so all theme data can be copied exactly
     for (size_t p = 0; p < packages_.size(); p++) {
       const Package *package = o.packages_[p].get();
@@ -1313,6 +1465,11 @@ void Theme::SetTo(const Theme& o) {
       }
     }
   } else {
+    // Copied attributes may be filtered against the destination AssetManager, so the result
+    // is not described by the source's chain of applied styles.
+    chain_key_.clear();
+    cacheable_ = false;
+
     std::map<ApkAssetsCookie, ApkAssetsCookie> src_to_dest_asset_cookies;
     typedef std::map<int, int> SourceToDestinationRuntimePackageMap;
     std::map<ApkAssetsCookie, SourceToDestinationRuntimePackageMap> src_asset_cookie_id_map;
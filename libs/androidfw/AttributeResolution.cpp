@@ -17,9 +17,16 @@
 #include "androidfw/AttributeResolution.h"
 
 #include <cstdint>
+#include <vector>
 
 #include <log/log.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "androidfw/AssetManager2.h"
 #include "androidfw/AttributeFinder.h"
 
@@ -48,17 +55,81 @@ class XmlAttributeFinder
   const ResXMLParser* parser_;
 };
 
-class BagAttributeFinder
-    : public BackTrackingAttributeFinder<BagAttributeFinder, const ResolvedBag::Entry*> {
+// Returns the index of the first key in [start, count) that is not less than `ident`,
+// or `count` if there is none. The keys must be sorted in ascending order.
+static size_t ScanForFirstKeyNotLessThan(const uint32_t* keys, size_t start, size_t count,
+                                         uint32_t ident) {
+  size_t i = start;
+#if defined(__SSE2__)
+  // SSE2 has no unsigned compare, so bias both sides into signed range.
+  const __m128i bias = _mm_set1_epi32(static_cast<int32_t>(0x80000000u));
+  const __m128i needle = _mm_set1_epi32(static_cast<int32_t>(ident ^ 0x80000000u));
+  for (; i + 4 <= count; i += 4) {
+    const __m128i chunk = _mm_xor_si128(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), bias);
+    const int mask = _mm_movemask_epi8(_mm_cmplt_epi32(chunk, needle));
+    if (mask != 0xffff) {
+      return i + (__builtin_ctz(0xffff ^ mask) >> 2);
+    }
+  }
+#elif defined(__ARM_NEON)
+  const uint32x4_t needle = vdupq_n_u32(ident);
+  for (; i + 4 <= count; i += 4) {
+    const uint32x4_t less_than = vcltq_u32(vld1q_u32(keys + i), needle);
+    const uint64_t mask =
+        vget_lane_u64(vreinterpret_u64_u16(vmovn_u32(less_than)), 0);
+    if (mask != 0xffffffffffffffffu) {
+      return i + (__builtin_ctzll(~mask) >> 4);
+    }
+  }
+#endif
+  while (i < count && keys[i] < ident) {
+    i++;
+  }
+  return i;
+}
+
+// Finder over the sorted attribute keys of a ResolvedBag. The keys are extracted into a
+// contiguous array on construction so that Find() can compare several keys per step using
+// SIMD instead of striding over the full ResolvedBag::Entry structs.
+// Like BackTrackingAttributeFinder, the finder is optimized for idents queried in ascending
+// order, but falls back to restarting from the beginning when queried out of order.
+class BagAttributeFinder {
  public:
   explicit BagAttributeFinder(const ResolvedBag* bag)
-      : BackTrackingAttributeFinder(bag != nullptr ? bag->entries : nullptr,
-                                    bag != nullptr ? bag->entries + bag->entry_count : nullptr) {
+      : entries_(bag != nullptr ? bag->entries : nullptr),
+        count_(bag != nullptr ? bag->entry_count : 0u) {
+    keys_.reserve(count_);
+    for (size_t i = 0; i < count_; i++) {
+      keys_.push_back(entries_[i].key);
+    }
   }
 
-  inline uint32_t GetAttribute(const ResolvedBag::Entry* entry) const {
-    return entry->key;
+  // Returns the entry with the key `ident`, or nullptr if the bag does not contain it.
+  const ResolvedBag::Entry* Find(uint32_t ident) {
+    const size_t start = (next_index_ > 0u && ident < last_ident_) ? 0u : next_index_;
+    last_ident_ = ident;
+    const size_t idx = ScanForFirstKeyNotLessThan(keys_.data(), start, count_, ident);
+    next_index_ = idx;
+    if (idx < count_ && keys_[idx] == ident) {
+      next_index_ = idx + 1;
+      return entries_ + idx;
+    }
+    return nullptr;
   }
+
+  // Rewinds the finder so that it can be reused for another pass of ascending idents.
+  void Reset() {
+    next_index_ = 0u;
+    last_ident_ = 0u;
+  }
+
+ private:
+  const ResolvedBag::Entry* entries_;
+  size_t count_;
+  std::vector<uint32_t> keys_;
+  size_t next_index_ = 0u;
+  uint32_t last_ident_ = 0u;
 };
 
 bool ResolveAttrs(Theme* theme, uint32_t def_style_attr, uint32_t def_style_res,
@@ -126,7 +197,7 @@ bool ResolveAttrs(Theme* theme, uint32_t def_style_attr, uint32_t def_style_res,
       }
     } else {
       const ResolvedBag::Entry* const entry = def_style_attr_finder.Find(cur_ident);
-      if (entry != def_style_attr_finder.end()) {
+      if (entry != nullptr) {
         cookie = entry->cookie;
         type_set_flags = def_style_flags;
         value = entry->value;
@@ -202,31 +273,17 @@ bool ResolveAttrs(Theme* theme, uint32_t def_style_attr, uint32_t def_style_res,
   return true;
 }
 
-void ApplyStyle(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_attr,
-                uint32_t def_style_resid, const uint32_t* attrs, size_t attrs_length,
-                uint32_t* out_values, uint32_t* out_indices) {
-  if (kDebugStyles) {
-    ALOGI("APPLY STYLE: theme=0x%p defStyleAttr=0x%x defStyleRes=0x%x xml=0x%p", theme,
-          def_style_attr, def_style_resid, xml_parser);
-  }
-
+// The body of ApplyStyle() once the default style has been resolved. The default style
+// lookup is hoisted out so that ApplyStyleBatched() can share it across many views.
+static void ApplyStyleImpl(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_flags,
+                           BagAttributeFinder& def_style_attr_finder, const uint32_t* attrs,
+                           size_t attrs_length, uint32_t* out_values, uint32_t* out_indices) {
   AssetManager2* assetmanager = theme->GetAssetManager();
   ResTable_config config;
   Res_value value;
 
   int indices_idx = 0;
 
-  // Load default style from attribute, if specified...
-  uint32_t def_style_flags = 0u;
-  if (def_style_attr != 0) {
-    Res_value value;
-    if (theme->GetAttribute(def_style_attr, &value, &def_style_flags) != kInvalidCookie) {
-      if (value.dataType == Res_value::TYPE_REFERENCE) {
-        def_style_resid = value.data;
-      }
-    }
-  }
-
   // Retrieve the style resource ID associated with the current XML tag's style attribute.
   uint32_t style_resid = 0u;
   uint32_t style_flags = 0u;
@@ -246,17 +303,6 @@ void ApplyStyle(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_attr,
     }
   }
 
-  // Retrieve the default style bag, if requested.
-  const ResolvedBag* default_style_bag = nullptr;
-  if (def_style_resid != 0) {
-    default_style_bag = assetmanager->GetBag(def_style_resid);
-    if (default_style_bag != nullptr) {
-      def_style_flags |= default_style_bag->type_spec_flags;
-    }
-  }
-
-  BagAttributeFinder def_style_attr_finder(default_style_bag);
-
   // Retrieve the style class bag, if requested.
   const ResolvedBag* xml_style_bag = nullptr;
   if (style_resid != 0) {
@@ -306,7 +352,7 @@ void ApplyStyle(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_attr,
     if (value.dataType == Res_value::TYPE_NULL && value.data != Res_value::DATA_NULL_EMPTY) {
       // Walk through the style class values looking for the requested attribute.
       const ResolvedBag::Entry* entry = xml_style_attr_finder.Find(cur_ident);
-      if (entry != xml_style_attr_finder.end()) {
+      if (entry != nullptr) {
         // We found the attribute we were looking for.
         cookie = entry->cookie;
         type_set_flags = style_flags;
@@ -322,7 +368,7 @@ void ApplyStyle(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_attr,
     if (value.dataType == Res_value::TYPE_NULL && value.data != Res_value::DATA_NULL_EMPTY) {
       // Walk through the default style values looking for the requested attribute.
       const ResolvedBag::Entry* entry = def_style_attr_finder.Find(cur_ident);
-      if (entry != def_style_attr_finder.end()) {
+      if (entry != nullptr) {
         // We found the attribute we were looking for.
         cookie = entry->cookie;
         type_set_flags = def_style_flags;
@@ -403,6 +449,80 @@ void ApplyStyle(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_attr,
   out_indices[0] = indices_idx;
 }
 
+void ApplyStyle(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_attr,
+                uint32_t def_style_resid, const uint32_t* attrs, size_t attrs_length,
+                uint32_t* out_values, uint32_t* out_indices) {
+  if (kDebugStyles) {
+    ALOGI("APPLY STYLE: theme=0x%p defStyleAttr=0x%x defStyleRes=0x%x xml=0x%p", theme,
+          def_style_attr, def_style_resid, xml_parser);
+  }
+
+  AssetManager2* assetmanager = theme->GetAssetManager();
+
+  // Load default style from attribute, if specified...
+  uint32_t def_style_flags = 0u;
+  if (def_style_attr != 0) {
+    Res_value value;
+    if (theme->GetAttribute(def_style_attr, &value, &def_style_flags) != kInvalidCookie) {
+      if (value.dataType == Res_value::TYPE_REFERENCE) {
+        def_style_resid = value.data;
+      }
+    }
+  }
+
+  // Retrieve the default style bag, if requested.
+  const ResolvedBag* default_style_bag = nullptr;
+  if (def_style_resid != 0) {
+    default_style_bag = assetmanager->GetBag(def_style_resid);
+    if (default_style_bag != nullptr) {
+      def_style_flags |= default_style_bag->type_spec_flags;
+    }
+  }
+
+  BagAttributeFinder def_style_attr_finder(default_style_bag);
+  ApplyStyleImpl(theme, xml_parser, def_style_flags, def_style_attr_finder, attrs, attrs_length,
+                 out_values, out_indices);
+}
+
+void ApplyStyleBatched(Theme* theme, uint32_t def_style_attr, uint32_t def_style_resid,
+                       const StyleBatchEntry* entries, size_t entry_count) {
+  if (kDebugStyles) {
+    ALOGI("APPLY STYLE BATCHED: theme=0x%p defStyleAttr=0x%x defStyleRes=0x%x count=%zu", theme,
+          def_style_attr, def_style_resid, entry_count);
+  }
+
+  AssetManager2* assetmanager = theme->GetAssetManager();
+
+  // Load default style from attribute, if specified...
+  uint32_t def_style_flags = 0u;
+  if (def_style_attr != 0) {
+    Res_value value;
+    if (theme->GetAttribute(def_style_attr, &value, &def_style_flags) != kInvalidCookie) {
+      if (value.dataType == Res_value::TYPE_REFERENCE) {
+        def_style_resid = value.data;
+      }
+    }
+  }
+
+  // Retrieve the default style bag, if requested. Resolving the bag and extracting its keys
+  // happens once here, no matter how many views are in the batch.
+  const ResolvedBag* default_style_bag = nullptr;
+  if (def_style_resid != 0) {
+    default_style_bag = assetmanager->GetBag(def_style_resid);
+    if (default_style_bag != nullptr) {
+      def_style_flags |= default_style_bag->type_spec_flags;
+    }
+  }
+
+  BagAttributeFinder def_style_attr_finder(default_style_bag);
+  for (size_t i = 0; i < entry_count; i++) {
+    const StyleBatchEntry& entry = entries[i];
+    def_style_attr_finder.Reset();
+    ApplyStyleImpl(theme, entry.xml_parser, def_style_flags, def_style_attr_finder, entry.attrs,
+                   entry.attrs_length, entry.out_values, entry.out_indices);
+  }
+}
+
 bool RetrieveAttributes(AssetManager2* assetmanager, ResXMLParser* xml_parser, uint32_t* attrs,
                         size_t attrs_length, uint32_t* out_values, uint32_t* out_indices) {
   ResTable_config config;
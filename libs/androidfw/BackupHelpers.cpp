@@ -30,6 +30,12 @@
 #include <utime.h>
 #include <zlib.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <log/log.h>
 #include <utils/ByteOrder.h>
 #include <utils/KeyedVector.h>
@@ -329,6 +335,9 @@ compute_crc32(const char* file, FileRec* out) {
     return NO_ERROR;
 }
 
+// Max number of threads that will hash files concurrently during a backup pass.
+static const size_t kMaxHashThreads = 4;
+
 int
 back_up_files(int oldSnapshotFD, BackupDataWriter* dataStream, int newSnapshotFD,
         char const* const* files, char const* const* keys, int fileCount)
@@ -345,6 +354,8 @@ back_up_files(int oldSnapshotFD, BackupDataWriter* dataStream, int newSnapshotFD
         }
     }
 
+    std::vector<String8> pendingHashes;
+
     for (int i=0; i<fileCount; i++) {
         String8 key(keys[i]);
         FileRec r;
@@ -369,15 +380,85 @@ back_up_files(int oldSnapshotFD, BackupDataWriter* dataStream, int newSnapshotFD
                 return -1;
             }
 
-            // compute the CRC
-            if (compute_crc32(file, &r) != NO_ERROR) {
-                ALOGW("Unable to open file %s", file);
-                continue;
+            // If the stats match what the old snapshot recorded, carry its CRC
+            // over instead of re-reading the whole file. This is what keeps an
+            // incremental pass from re-hashing every unchanged file.
+            ssize_t oldIndex = oldSnapshot.indexOfKey(key);
+            if (oldIndex >= 0) {
+                const FileState& f = oldSnapshot.valueAt(oldIndex);
+                if (f.modTime_sec == r.s.modTime_sec && f.modTime_nsec == r.s.modTime_nsec
+                        && f.mode == r.s.mode && f.size == r.s.size) {
+                    r.s.crc32 = f.crc32;
+                    newSnapshot.add(key, r);
+                    continue;
+                }
             }
+
+            // New or changed: the CRC is computed below, after all entries are
+            // collected, so the hashing can be spread across threads.
+            pendingHashes.push_back(key);
         }
         newSnapshot.add(key, r);
     }
 
+    // Hash whatever couldn't be carried over from the old snapshot. The files
+    // are independent, so they are handed out to a small pool of threads by
+    // an atomic index.
+    const size_t pendingCount = pendingHashes.size();
+    if (pendingCount > 0) {
+        std::vector<FileRec*> pendingRecs;
+        pendingRecs.reserve(pendingCount);
+        for (const String8& key : pendingHashes) {
+            pendingRecs.push_back(&newSnapshot.editValueFor(key));
+        }
+
+        std::vector<uint8_t> failed(pendingCount, 0);
+        std::atomic<size_t> nextIndex(0);
+        auto hashWorker = [&pendingRecs, &failed, &nextIndex, pendingCount]() {
+            while (true) {
+                const size_t idx = nextIndex.fetch_add(1);
+                if (idx >= pendingCount) {
+                    break;
+                }
+                FileRec* r = pendingRecs[idx];
+                if (compute_crc32(r->file.string(), r) != NO_ERROR) {
+                    ALOGW("Unable to open file %s", r->file.string());
+                    failed[idx] = 1;
+                }
+            }
+        };
+
+        size_t threadCount = pendingCount;
+        const size_t hwThreads = std::thread::hardware_concurrency();
+        if (hwThreads != 0 && hwThreads < threadCount) {
+            threadCount = hwThreads;
+        }
+        if (threadCount > kMaxHashThreads) {
+            threadCount = kMaxHashThreads;
+        }
+
+        if (threadCount <= 1) {
+            hashWorker();
+        } else {
+            std::vector<std::thread> threads;
+            threads.reserve(threadCount);
+            for (size_t t = 0; t < threadCount; t++) {
+                threads.emplace_back(hashWorker);
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+
+        // Unreadable files don't belong in the snapshot, same as when the CRC
+        // was computed inline.
+        for (size_t idx = 0; idx < pendingCount; idx++) {
+            if (failed[idx]) {
+                newSnapshot.removeItem(pendingHashes[idx]);
+            }
+        }
+    }
+
     int n = 0;
     int N = oldSnapshot.size();
     int m = 0;
@@ -725,7 +806,83 @@ done:
 
 
 
-#define RESTORE_BUF_SIZE (8*1024)
+#define RESTORE_BUF_SIZE (64*1024)
+
+// Files whose payload is at least this large get their output preallocated
+// and their stream reads overlapped with the file writes.
+#define RESTORE_READAHEAD_MIN_SIZE (1024*1024)
+
+// Double-buffered copy from the backup stream into 'fd': a writer thread
+// flushes one buffer while the next chunk is read from the stream into the
+// other.  Restores commonly read from a transport socket, so overlapping the
+// two keeps both the transport and the storage busy instead of strictly
+// alternating between them.  Returns 0 on success or an errno value.
+static int
+restore_file_readahead(int fd, BackupDataReader* in, int* crc)
+{
+    char* bufs = (char*)malloc(2 * RESTORE_BUF_SIZE);
+    if (bufs == NULL) {
+        return ENOMEM;
+    }
+
+    std::mutex lock;
+    std::condition_variable cond;
+    char* pendingBuf = NULL;
+    ssize_t pendingAmt = 0;
+    bool done = false;
+    int writeErr = 0;
+
+    std::thread writer([&]() {
+        std::unique_lock<std::mutex> l(lock);
+        while (true) {
+            cond.wait(l, [&] { return pendingBuf != NULL || done; });
+            if (pendingBuf == NULL) {
+                return;
+            }
+            char* buf = pendingBuf;
+            ssize_t amt = pendingAmt;
+            l.unlock();
+            ssize_t written = write(fd, buf, amt);
+            l.lock();
+            if (written != amt && writeErr == 0) {
+                writeErr = errno != 0 ? errno : EIO;
+            }
+            pendingBuf = NULL;
+            cond.notify_all();
+        }
+    });
+
+    int cur = 0;
+    int err = 0;
+    ssize_t amt;
+    while ((amt = in->ReadEntityData(bufs + cur*RESTORE_BUF_SIZE, RESTORE_BUF_SIZE)) > 0) {
+        char* buf = bufs + cur*RESTORE_BUF_SIZE;
+        *crc = crc32(*crc, (Bytef*)buf, amt);
+        std::unique_lock<std::mutex> l(lock);
+        cond.wait(l, [&] { return pendingBuf == NULL; });
+        if (writeErr != 0) {
+            err = writeErr;
+            break;
+        }
+        pendingBuf = buf;
+        pendingAmt = amt;
+        cond.notify_all();
+        cur = 1 - cur;
+    }
+
+    {
+        std::unique_lock<std::mutex> l(lock);
+        cond.wait(l, [&] { return pendingBuf == NULL; });
+        done = true;
+        if (err == 0) {
+            err = writeErr;
+        }
+        cond.notify_all();
+    }
+    writer.join();
+    free(bufs);
+    return err;
+}
 
 RestoreHelperBase::RestoreHelperBase()
 {
@@ -785,14 +942,31 @@ RestoreHelperBase::WriteFile(const String8& filename, BackupDataReader* in)
         return errno;
     }
 
-    while ((amt = in->ReadEntityData(buf, RESTORE_BUF_SIZE)) > 0) {
-        err = write(fd, buf, amt);
-        if (err != amt) {
+    // The entity header told us how big the payload is.  Preallocating large
+    // files keeps their extents contiguous and saves the writes below from
+    // growing the file one buffer at a time.
+    size_t payloadSize = (dataSize > sizeof(metadata)) ? (dataSize - sizeof(metadata)) : 0;
+    if (payloadSize >= RESTORE_READAHEAD_MIN_SIZE) {
+        if (fallocate(fd, 0, 0, payloadSize) != 0) {
+            // Not every filesystem supports preallocation; the writes below
+            // extend the file as they always have.
+        }
+        err = restore_file_readahead(fd, in, &crc);
+        if (err != 0) {
             close(fd);
-            ALOGW("Error '%s' writing '%s'", strerror(errno), filename.string());
-            return errno;
+            ALOGW("Error '%s' writing '%s'", strerror(err), filename.string());
+            return err;
+        }
+    } else {
+        while ((amt = in->ReadEntityData(buf, RESTORE_BUF_SIZE)) > 0) {
+            err = write(fd, buf, amt);
+            if (err != amt) {
+                close(fd);
+                ALOGW("Error '%s' writing '%s'", strerror(errno), filename.string());
+                return errno;
+            }
+            crc = crc32(crc, (Bytef*)buf, amt);
         }
-        crc = crc32(crc, (Bytef*)buf, amt);
     }
 
     close(fd);
@@ -31,22 +31,36 @@
 namespace android {
 
 CursorWindow::CursorWindow(const String8& name, int ashmemFd,
-        void* data, size_t size, bool readOnly) :
-        mName(name), mAshmemFd(ashmemFd), mData(data), mSize(size), mReadOnly(readOnly) {
+        void* data, size_t size, size_t maxSize, bool readOnly) :
+        mName(name), mAshmemFd(ashmemFd), mData(data), mSize(size), mMaxSize(maxSize),
+        mReadOnly(readOnly), mTailChunkOffset(0), mTailChunkBaseRow(0),
+        mWriteFieldDirOffset(0), mWriteRow(0) {
     mHeader = static_cast<Header*>(mData);
 }
 
 CursorWindow::~CursorWindow() {
-    ::munmap(mData, mSize);
+    ::munmap(mData, mMaxSize);
     ::close(mAshmemFd);
 }
 
 status_t CursorWindow::create(const String8& name, size_t size, CursorWindow** outCursorWindow) {
+    return create(name, size, size, outCursorWindow);
+}
+
+status_t CursorWindow::create(const String8& name, size_t size, size_t maxSize,
+        CursorWindow** outCursorWindow) {
+    if (size > maxSize) {
+        *outCursorWindow = NULL;
+        return BAD_VALUE;
+    }
+
     String8 ashmemName("CursorWindow: ");
     ashmemName.append(name);
 
     status_t result;
-    int ashmemFd = ashmem_create_region(ashmemName.string(), size);
+    // The region and the mapping cover the growth cap up front; ashmem commits
+    // pages lazily, so unused slabs cost only address space until written.
+    int ashmemFd = ashmem_create_region(ashmemName.string(), maxSize);
     if (ashmemFd < 0) {
         result = -errno;
         ALOGE("CursorWindow: ashmem_create_region() failed: errno=%d.", errno);
@@ -55,7 +69,7 @@ status_t CursorWindow::create(const String8& name, size_t size, CursorWindow** o
         if (result < 0) {
             ALOGE("CursorWindow: ashmem_set_prot_region() failed: errno=%d",errno);
         } else {
-            void* data = ::mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, ashmemFd, 0);
+            void* data = ::mmap(NULL, maxSize, PROT_READ | PROT_WRITE, MAP_SHARED, ashmemFd, 0);
             if (data == MAP_FAILED) {
                 result = -errno;
                 ALOGE("CursorWindow: mmap() failed: errno=%d.", errno);
@@ -65,7 +79,7 @@ status_t CursorWindow::create(const String8& name, size_t size, CursorWindow** o
                     ALOGE("CursorWindow: ashmem_set_prot_region() failed: errno=%d.", errno);
                 } else {
                     CursorWindow* window = new CursorWindow(name, ashmemFd,
-                            data, size, false /*readOnly*/);
+                            data, size, maxSize, false /*readOnly*/);
                     result = window->clear();
                     if (!result) {
                         LOG_WINDOW("Created new CursorWindow: freeOffset=%d, "
@@ -80,7 +94,7 @@ status_t CursorWindow::create(const String8& name, size_t size, CursorWindow** o
                     delete window;
                 }
             }
-            ::munmap(data, size);
+            ::munmap(data, maxSize);
         }
         ::close(ashmemFd);
     }
@@ -122,7 +136,7 @@ status_t CursorWindow::createFromParcel(Parcel* parcel, CursorWindow** outCursor
                             actualSize, (int) size, errno);
                 } else {
                     CursorWindow* window = new CursorWindow(name, dupAshmemFd,
-                            data, size, true /*readOnly*/);
+                            data, size, size, true /*readOnly*/);
                     LOG_WINDOW("Created CursorWindow from parcel: freeOffset=%d, "
                             "numRows=%d, numColumns=%d, mSize=%d, mData=%p",
                             window->mHeader->freeOffset,
@@ -160,6 +174,10 @@ status_t CursorWindow::clear() {
 
     RowSlotChunk* firstChunk = static_cast<RowSlotChunk*>(offsetToPtr(mHeader->firstChunkOffset));
     firstChunk->nextChunkOffset = 0;
+
+    mTailChunkOffset = mHeader->firstChunkOffset;
+    mTailChunkBaseRow = 0;
+    mWriteFieldDirOffset = 0;
     return OK;
 }
 
@@ -203,6 +221,10 @@ status_t CursorWindow::allocRow() {
     LOG_WINDOW("Allocated row %u, rowSlot is at offset %u, fieldDir is %d bytes at offset %u\n",
             mHeader->numRows - 1, offsetFromPtr(rowSlot), fieldDirSize, fieldDirOffset);
     rowSlot->offset = fieldDirOffset;
+
+    // Remember the new row's directory; the caller fills its columns next.
+    mWriteFieldDirOffset = fieldDirOffset;
+    mWriteRow = mHeader->numRows - 1;
     return OK;
 }
 
@@ -214,6 +236,7 @@ status_t CursorWindow::freeLastRow() {
     if (mHeader->numRows > 0) {
         mHeader->numRows--;
     }
+    mWriteFieldDirOffset = 0;
     return OK;
 }
 
@@ -229,10 +252,23 @@ uint32_t CursorWindow::alloc(size_t size, bool aligned) {
     uint32_t offset = mHeader->freeOffset + padding;
     uint32_t nextFreeOffset = offset + size;
     if (nextFreeOffset > mSize) {
-        ALOGW("Window is full: requested allocation %zu bytes, "
-                "free space %zu bytes, window size %zu bytes",
-                size, freeSpace(), mSize);
-        return 0;
+        // Grow the window by doubling slabs until the allocation fits or the cap
+        // is reached. The region and mapping already span mMaxSize, so growth is
+        // pure accounting and never moves existing rows.
+        size_t newSize = mSize;
+        while (nextFreeOffset > newSize && newSize < mMaxSize) {
+            newSize *= 2;
+            if (newSize > mMaxSize) {
+                newSize = mMaxSize;
+            }
+        }
+        if (nextFreeOffset > newSize) {
+            ALOGW("Window is full: requested allocation %zu bytes, "
+                    "free space %zu bytes, window size %zu bytes, max size %zu bytes",
+                    size, freeSpace(), mSize, mMaxSize);
+            return 0;
+        }
+        mSize = newSize;
     }
 
     mHeader->freeOffset = nextFreeOffset;
@@ -252,11 +288,25 @@ CursorWindow::RowSlot* CursorWindow::getRowSlot(uint32_t row) {
 
 CursorWindow::RowSlot* CursorWindow::allocRowSlot() {
     uint32_t chunkPos = mHeader->numRows;
-    RowSlotChunk* chunk = static_cast<RowSlotChunk*>(
-            offsetToPtr(mHeader->firstChunkOffset));
-    while (chunkPos > ROW_SLOT_CHUNK_NUM_ROWS) {
-        chunk = static_cast<RowSlotChunk*>(offsetToPtr(chunk->nextChunkOffset));
-        chunkPos -= ROW_SLOT_CHUNK_NUM_ROWS;
+    RowSlotChunk* chunk;
+    if (mTailChunkOffset && chunkPos >= mTailChunkBaseRow
+            && chunkPos - mTailChunkBaseRow <= ROW_SLOT_CHUNK_NUM_ROWS) {
+        // Fast path: the next slot lives in (or directly after) the cached tail
+        // chunk, so there's no need to walk the chain from the start.
+        chunk = static_cast<RowSlotChunk*>(offsetToPtr(mTailChunkOffset));
+        chunkPos -= mTailChunkBaseRow;
+    } else {
+        // The cache is cold or freeLastRow() stepped back past the cached chunk;
+        // rewalk the chain and reseed it.
+        mTailChunkOffset = mHeader->firstChunkOffset;
+        mTailChunkBaseRow = 0;
+        chunk = static_cast<RowSlotChunk*>(offsetToPtr(mTailChunkOffset));
+        while (chunkPos > ROW_SLOT_CHUNK_NUM_ROWS) {
+            mTailChunkOffset = chunk->nextChunkOffset;
+            mTailChunkBaseRow += ROW_SLOT_CHUNK_NUM_ROWS;
+            chunk = static_cast<RowSlotChunk*>(offsetToPtr(mTailChunkOffset));
+            chunkPos -= ROW_SLOT_CHUNK_NUM_ROWS;
+        }
     }
     if (chunkPos == ROW_SLOT_CHUNK_NUM_ROWS) {
         if (!chunk->nextChunkOffset) {
@@ -265,7 +315,9 @@ CursorWindow::RowSlot* CursorWindow::allocRowSlot() {
                 return NULL;
             }
         }
-        chunk = static_cast<RowSlotChunk*>(offsetToPtr(chunk->nextChunkOffset));
+        mTailChunkOffset = chunk->nextChunkOffset;
+        mTailChunkBaseRow += ROW_SLOT_CHUNK_NUM_ROWS;
+        chunk = static_cast<RowSlotChunk*>(offsetToPtr(mTailChunkOffset));
         chunk->nextChunkOffset = 0;
         chunkPos = 0;
     }
@@ -273,6 +325,18 @@ CursorWindow::RowSlot* CursorWindow::allocRowSlot() {
     return &chunk->slots[chunkPos];
 }
 
+CursorWindow::FieldSlot* CursorWindow::getFieldSlotForWrite(uint32_t row, uint32_t column) {
+    // Rows are filled column by column right after allocRow(), so nearly every write
+    // targets the cached directory and skips the per-field chunk chain walk. Reads
+    // never consult the cache, keeping concurrent readers unaffected.
+    if (mWriteFieldDirOffset != 0 && row == mWriteRow && row < mHeader->numRows
+            && column < mHeader->numColumns) {
+        FieldSlot* fieldDir = static_cast<FieldSlot*>(offsetToPtr(mWriteFieldDirOffset));
+        return &fieldDir[column];
+    }
+    return getFieldSlot(row, column);
+}
+
 CursorWindow::FieldSlot* CursorWindow::getFieldSlot(uint32_t row, uint32_t column) {
     if (row >= mHeader->numRows || column >= mHeader->numColumns) {
         ALOGE("Failed to read row %d, column %d from a CursorWindow which "
@@ -304,7 +368,7 @@ status_t CursorWindow::putBlobOrString(uint32_t row, uint32_t column,
         return INVALID_OPERATION;
     }
 
-    FieldSlot* fieldSlot = getFieldSlot(row, column);
+    FieldSlot* fieldSlot = getFieldSlotForWrite(row, column);
     if (!fieldSlot) {
         return BAD_VALUE;
     }
@@ -327,7 +391,7 @@ status_t CursorWindow::putLong(uint32_t row, uint32_t column, int64_t value) {
         return INVALID_OPERATION;
     }
 
-    FieldSlot* fieldSlot = getFieldSlot(row, column);
+    FieldSlot* fieldSlot = getFieldSlotForWrite(row, column);
     if (!fieldSlot) {
         return BAD_VALUE;
     }
@@ -342,7 +406,7 @@ status_t CursorWindow::putDouble(uint32_t row, uint32_t column, double value) {
         return INVALID_OPERATION;
     }
 
-    FieldSlot* fieldSlot = getFieldSlot(row, column);
+    FieldSlot* fieldSlot = getFieldSlotForWrite(row, column);
     if (!fieldSlot) {
         return BAD_VALUE;
     }
@@ -357,7 +421,7 @@ status_t CursorWindow::putNull(uint32_t row, uint32_t column) {
         return INVALID_OPERATION;
     }
 
-    FieldSlot* fieldSlot = getFieldSlot(row, column);
+    FieldSlot* fieldSlot = getFieldSlotForWrite(row, column);
     if (!fieldSlot) {
         return BAD_VALUE;
     }
@@ -68,12 +68,10 @@ status_t DisplayEventDispatcher::scheduleVsync() {
         ALOGV("dispatcher %p ~ Scheduling vsync.", this);
 
         // Drain all pending events.
-        nsecs_t vsyncTimestamp;
-        PhysicalDisplayId vsyncDisplayId;
-        uint32_t vsyncCount;
-        if (processPendingEvents(&vsyncTimestamp, &vsyncDisplayId, &vsyncCount)) {
+        std::vector<VsyncEvent> vsyncEvents;
+        if (processPendingEvents(&vsyncEvents)) {
             ALOGE("dispatcher %p ~ last event processed while scheduling was for %" PRId64 "",
-                    this, ns2ms(static_cast<nsecs_t>(vsyncTimestamp)));
+                    this, ns2ms(vsyncEvents.back().timestamp));
         }
 
         status_t status = mReceiver.requestNextVsync();
@@ -100,24 +98,32 @@ int DisplayEventDispatcher::handleEvent(int, int events, void*) {
         return 1; // keep the callback
     }
 
-    // Drain all pending events, keep the last vsync.
-    nsecs_t vsyncTimestamp;
-    PhysicalDisplayId vsyncDisplayId;
-    uint32_t vsyncCount;
-    if (processPendingEvents(&vsyncTimestamp, &vsyncDisplayId, &vsyncCount)) {
-        ALOGV("dispatcher %p ~ Vsync pulse: timestamp=%" PRId64 ", displayId=%"
-                ANDROID_PHYSICAL_DISPLAY_ID_FORMAT ", count=%d",
-                this, ns2ms(vsyncTimestamp), vsyncDisplayId, vsyncCount);
+    // Drain all pending events, keep the last vsync of each display.
+    std::vector<VsyncEvent> vsyncEvents;
+    if (processPendingEvents(&vsyncEvents)) {
+        for (const VsyncEvent& vsync : vsyncEvents) {
+            ALOGV("dispatcher %p ~ Vsync pulse: timestamp=%" PRId64 ", displayId=%"
+                    ANDROID_PHYSICAL_DISPLAY_ID_FORMAT ", count=%d",
+                    this, ns2ms(vsync.timestamp), vsync.displayId, vsync.count);
+        }
         mWaitingForVsync = false;
-        dispatchVsync(vsyncTimestamp, vsyncDisplayId, vsyncCount);
+        dispatchVsyncEvents(vsyncEvents);
     }
 
     return 1; // keep the callback
 }
 
-bool DisplayEventDispatcher::processPendingEvents(
-        nsecs_t* outTimestamp, PhysicalDisplayId* outDisplayId, uint32_t* outCount) {
-    bool gotVsync = false;
+void DisplayEventDispatcher::dispatchVsyncEvents(const std::vector<VsyncEvent>& events) {
+    const VsyncEvent* newest = &events.front();
+    for (const VsyncEvent& event : events) {
+        if (event.timestamp >= newest->timestamp) {
+            newest = &event;
+        }
+    }
+    dispatchVsync(newest->timestamp, newest->displayId, newest->count);
+}
+
+bool DisplayEventDispatcher::processPendingEvents(std::vector<VsyncEvent>* outEvents) {
     DisplayEventReceiver::Event buf[EVENT_BUFFER_SIZE];
     ssize_t n;
     while ((n = mReceiver.getEvents(buf, EVENT_BUFFER_SIZE)) > 0) {
@@ -125,14 +131,26 @@ bool DisplayEventDispatcher::processPendingEvents(
         for (ssize_t i = 0; i < n; i++) {
             const DisplayEventReceiver::Event& ev = buf[i];
             switch (ev.header.type) {
-            case DisplayEventReceiver::DISPLAY_EVENT_VSYNC:
-                // Later vsync events will just overwrite the info from earlier
-                // ones. That's fine, we only care about the most recent.
-                gotVsync = true;
-                *outTimestamp = ev.header.timestamp;
-                *outDisplayId = ev.header.displayId;
-                *outCount = ev.vsync.count;
+            case DisplayEventReceiver::DISPLAY_EVENT_VSYNC: {
+                // Later vsync events overwrite the info from earlier ones for
+                // the same display; only the most recent pulse per display
+                // matters. There are at most a handful of displays, so a
+                // linear scan beats a map here.
+                bool found = false;
+                for (VsyncEvent& pending : *outEvents) {
+                    if (pending.displayId == ev.header.displayId) {
+                        pending.timestamp = ev.header.timestamp;
+                        pending.count = ev.vsync.count;
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    outEvents->push_back({ev.header.timestamp, ev.header.displayId,
+                            ev.vsync.count});
+                }
                 break;
+            }
             case DisplayEventReceiver::DISPLAY_EVENT_HOTPLUG:
                 dispatchHotplug(ev.header.timestamp, ev.header.displayId, ev.hotplug.connected);
                 break;
@@ -148,6 +166,6 @@ bool DisplayEventDispatcher::processPendingEvents(
     if (n < 0) {
         ALOGW("Failed to get events from display event dispatcher, status=%d", status_t(n));
     }
-    return gotVsync;
+    return !outEvents->empty();
 }
 }
@@ -401,7 +401,10 @@ const LoadedPackage* LoadedArsc::GetPackageById(uint8_t package_id) const {
 
 std::unique_ptr<const LoadedPackage> LoadedPackage::Load(const Chunk& chunk,
                                                          const LoadedIdmap* loaded_idmap,
-                                                         bool system, bool load_as_shared_library) {
+                                                         bool system, bool load_as_shared_library,
+                                                         const uint8_t* base,
+                                                         const ArscIndex::ChunkIndex*
+                                                             package_index) {
   ATRACE_NAME("LoadedPackage::Load");
   std::unique_ptr<LoadedPackage> loaded_package(new LoadedPackage());
 
@@ -447,9 +450,18 @@ std::unique_ptr<const LoadedPackage> LoadedPackage::Load(const Chunk& chunk,
   // contiguous block of memory that holds all the Types together with the TypeSpec.
   std::unordered_map<int, std::unique_ptr<TypeSpecPtrBuilder>> type_builder_map;
 
-  ChunkIterator iter(chunk.data_ptr(), chunk.data_size());
-  while (iter.HasNext()) {
-    const Chunk child_chunk = iter.Next();
+  // If an index was supplied, the child chunk boundaries have already been validated, so
+  // iterate over the recorded offsets instead of walking and re-verifying the chunks.
+  const bool use_index = package_index != nullptr;
+  const size_t indexed_count = use_index ? package_index->children.size() : 0u;
+  size_t indexed_pos = 0u;
+
+  ChunkIterator iter(chunk.data_ptr(), use_index ? 0u : chunk.data_size());
+  while (use_index ? indexed_pos < indexed_count : iter.HasNext()) {
+    const Chunk child_chunk =
+        use_index ? Chunk(reinterpret_cast<const ResChunk_header*>(
+                        base + package_index->children[indexed_pos++]))
+                  : iter.Next();
     switch (child_chunk.type()) {
       case RES_STRING_POOL_TYPE: {
         const uintptr_t pool_address =
@@ -696,7 +708,8 @@ std::unique_ptr<const LoadedPackage> LoadedPackage::Load(const Chunk& chunk,
 }
 
 bool LoadedArsc::LoadTable(const Chunk& chunk, const LoadedIdmap* loaded_idmap,
-                           bool load_as_shared_library) {
+                           bool load_as_shared_library, const uint8_t* base,
+                           const ArscIndex::TableIndex* table_index) {
   const ResTable_header* header = chunk.header<ResTable_header>();
   if (header == nullptr) {
     LOG(ERROR) << "RES_TABLE_TYPE too small.";
@@ -708,9 +721,19 @@ bool LoadedArsc::LoadTable(const Chunk& chunk, const LoadedIdmap* loaded_idmap,
 
   packages_.reserve(package_count);
 
-  ChunkIterator iter(chunk.data_ptr(), chunk.data_size());
-  while (iter.HasNext()) {
-    const Chunk child_chunk = iter.Next();
+  // If an index was supplied, jump to the recorded child chunks instead of walking the table.
+  const bool use_index = table_index != nullptr;
+  const size_t indexed_count = use_index ? table_index->children.size() : 0u;
+  size_t indexed_pos = 0u;
+
+  ChunkIterator iter(chunk.data_ptr(), use_index ? 0u : chunk.data_size());
+  while (use_index ? indexed_pos < indexed_count : iter.HasNext()) {
+    const ArscIndex::ChunkIndex* child_index =
+        use_index ? &table_index->children[indexed_pos++] : nullptr;
+    const Chunk child_chunk =
+        use_index
+            ? Chunk(reinterpret_cast<const ResChunk_header*>(base + child_index->offset))
+            : iter.Next();
     switch (child_chunk.type()) {
       case RES_STRING_POOL_TYPE:
         // Only use the first string pool. Ignore others.
@@ -734,8 +757,8 @@ bool LoadedArsc::LoadTable(const Chunk& chunk, const LoadedIdmap* loaded_idmap,
         }
         packages_seen++;
 
-        std::unique_ptr<const LoadedPackage> loaded_package =
-            LoadedPackage::Load(child_chunk, loaded_idmap, system_, load_as_shared_library);
+        std::unique_ptr<const LoadedPackage> loaded_package = LoadedPackage::Load(
+            child_chunk, loaded_idmap, system_, load_as_shared_library, base, child_index);
         if (!loaded_package) {
           return false;
         }
@@ -759,13 +782,29 @@ bool LoadedArsc::LoadTable(const Chunk& chunk, const LoadedIdmap* loaded_idmap,
 
 std::unique_ptr<const LoadedArsc> LoadedArsc::Load(const StringPiece& data,
                                                    const LoadedIdmap* loaded_idmap, bool system,
-                                                   bool load_as_shared_library) {
+                                                   bool load_as_shared_library,
+                                                   const ArscIndex* index) {
   ATRACE_NAME("LoadedArsc::LoadTable");
 
   // Not using make_unique because the constructor is private.
   std::unique_ptr<LoadedArsc> loaded_arsc(new LoadedArsc());
   loaded_arsc->system_ = system;
 
+  if (index != nullptr) {
+    // The index records the offsets of all resource table chunks and has already validated
+    // their boundaries, so jump straight to them instead of walking the data.
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(data.data());
+    for (const ArscIndex::TableIndex& table_index : index->tables()) {
+      const Chunk chunk(reinterpret_cast<const ResChunk_header*>(base + table_index.offset));
+      if (!loaded_arsc->LoadTable(chunk, loaded_idmap, load_as_shared_library, base,
+                                  &table_index)) {
+        return {};
+      }
+    }
+    // Need to force a move for mingw32.
+    return std::move(loaded_arsc);
+  }
+
   ChunkIterator iter(data.data(), data.size());
   while (iter.HasNext()) {
     const Chunk chunk = iter.Next();
@@ -14,18 +14,22 @@
  * limitations under the License.
  */
 
+#include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 #define LOG_TAG "ObbFile"
 
 #include <androidfw/ObbFile.h>
 #include <utils/Compat.h>
+#include <utils/KeyedVector.h>
 #include <utils/Log.h>
+#include <utils/threads.h>
 
 //#define DEBUG 1
 
@@ -72,6 +76,28 @@
 
 namespace android {
 
+/*
+ * Cache of parsed footers, keyed by path and validated against the file's
+ * mtime and size so a replaced OBB is re-parsed. Scanning a mounted drive
+ * re-opens hundreds of OBBs at boot whose footers never change between
+ * mounts.
+ */
+struct CachedFooter {
+    String8 packageName;
+    int32_t version;
+    int32_t flags;
+    unsigned char salt[8];
+    size_t footerStart;
+    time_t mtime;
+    long mtimeNsec;
+    off64_t size;
+};
+
+static Mutex gFooterCacheLock;
+static KeyedVector<String8, CachedFooter> gFooterCache;
+
+static const size_t kFooterCacheMaxEntries = 512;
+
 ObbFile::ObbFile()
         : mPackageName("")
         , mVersion(-1)
@@ -88,6 +114,26 @@ bool ObbFile::readFrom(const char* filename)
     int fd;
     bool success = false;
 
+    struct stat st;
+    const bool haveStat = (stat(filename, &st) == 0);
+    if (haveStat) {
+        AutoMutex _l(gFooterCacheLock);
+        ssize_t cacheIndex = gFooterCache.indexOfKey(String8(filename));
+        if (cacheIndex >= 0) {
+            const CachedFooter& footer = gFooterCache.valueAt(cacheIndex);
+            if (footer.mtime == st.st_mtim.tv_sec && footer.mtimeNsec == st.st_mtim.tv_nsec
+                    && footer.size == st.st_size) {
+                mPackageName = footer.packageName;
+                mVersion = footer.version;
+                mFlags = footer.flags;
+                memcpy(mSalt, footer.salt, sizeof(mSalt));
+                mFooterStart = footer.footerStart;
+                return true;
+            }
+            gFooterCache.removeItemsAt(cacheIndex);
+        }
+    }
+
     fd = ::open(filename, O_RDONLY);
     if (fd < 0) {
         ALOGW("couldn't open file %s: %s", filename, strerror(errno));
@@ -98,12 +144,58 @@ bool ObbFile::readFrom(const char* filename)
 
     if (!success) {
         ALOGW("failed to read from %s (fd=%d)\n", filename, fd);
+    } else if (haveStat) {
+        AutoMutex _l(gFooterCacheLock);
+        if (gFooterCache.size() < kFooterCacheMaxEntries) {
+            CachedFooter footer;
+            footer.packageName = mPackageName;
+            footer.version = mVersion;
+            footer.flags = mFlags;
+            memcpy(footer.salt, mSalt, sizeof(mSalt));
+            footer.footerStart = mFooterStart;
+            footer.mtime = st.st_mtim.tv_sec;
+            footer.mtimeNsec = st.st_mtim.tv_nsec;
+            footer.size = st.st_size;
+            gFooterCache.replaceValueFor(String8(filename), footer);
+        }
     }
 
 out:
     return success;
 }
 
+bool ObbFile::scanDirectory(const char* dirPath, Vector<sp<ObbFile> >* outFiles)
+{
+    DIR* dir = opendir(dirPath);
+    if (dir == NULL) {
+        ALOGW("couldn't open directory %s: %s", dirPath, strerror(errno));
+        return false;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        String8 path(dirPath);
+        path.appendPath(entry->d_name);
+
+        struct stat st;
+        if (stat(path.string(), &st) != 0 || !S_ISREG(st.st_mode)) {
+            continue;
+        }
+
+        sp<ObbFile> obbFile = new ObbFile();
+        if (obbFile->readFrom(path.string())) {
+            outFiles->add(obbFile);
+        }
+    }
+
+    closedir(dir);
+    return true;
+}
+
 bool ObbFile::readFrom(int fd)
 {
     if (fd < 0) {
@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <limits>
 #include <map>
 #include <memory>
@@ -655,15 +656,16 @@ status_t ResStringPool::getError() const
 void ResStringPool::uninit()
 {
     mError = NO_INIT;
-    if (mHeader != NULL && mCache != NULL) {
+    std::atomic<char16_t*>* cache = mCache.load(std::memory_order_relaxed);
+    if (mHeader != NULL && cache != NULL) {
         for (size_t x = 0; x < mHeader->stringCount; x++) {
-            if (mCache[x] != NULL) {
-                free(mCache[x]);
-                mCache[x] = NULL;
+            char16_t* entry = cache[x].load(std::memory_order_relaxed);
+            if (entry != NULL) {
+                free(entry);
             }
         }
-        free(mCache);
-        mCache = NULL;
+        free(cache);
+        mCache.store(NULL, std::memory_order_relaxed);
     }
     if (mOwnedData) {
         free(mOwnedData);
@@ -747,10 +749,12 @@ const char16_t* ResStringPool::stringAt(size_t idx, size_t* u16len) const
 
                 // encLen must be less than 0x7FFF due to encoding.
                 if ((uint32_t)(u8str+u8len-strings) < mStringPoolSize) {
-                    AutoMutex lock(mDecodeLock);
-
-                    if (mCache != NULL && mCache[idx] != NULL) {
-                        return mCache[idx];
+                    std::atomic<char16_t*>* cache = mCache.load(std::memory_order_acquire);
+                    if (cache != NULL) {
+                        char16_t* cached = cache[idx].load(std::memory_order_acquire);
+                        if (cached != NULL) {
+                            return cached;
+                        }
                     }
 
                     // Retrieve the actual length of the utf8 string if the
@@ -780,7 +784,7 @@ const char16_t* ResStringPool::stringAt(size_t idx, size_t* u16len) const
 
                     utf8_to_utf16(u8str, u8len, u16str, *u16len + 1);
 
-                    if (mCache == NULL) {
+                    if (cache == NULL) {
 #ifndef __ANDROID__
                         if (kDebugStringPoolNoisy) {
                             ALOGI("CREATING STRING CACHE OF %zu bytes",
@@ -791,19 +795,35 @@ const char16_t* ResStringPool::stringAt(size_t idx, size_t* u16len) const
                         ALOGW("CREATING STRING CACHE OF %zu bytes",
                                 static_cast<size_t>(mHeader->stringCount*sizeof(char16_t**)));
 #endif
-                        mCache = (char16_t**)calloc(mHeader->stringCount, sizeof(char16_t*));
-                        if (mCache == NULL) {
+                        std::atomic<char16_t*>* newCache = (std::atomic<char16_t*>*)calloc(
+                                mHeader->stringCount, sizeof(std::atomic<char16_t*>));
+                        if (newCache == NULL) {
                             ALOGW("No memory trying to allocate decode cache table of %d bytes\n",
                                   (int)(mHeader->stringCount*sizeof(char16_t**)));
+                            free(u16str);
                             return NULL;
                         }
+                        if (mCache.compare_exchange_strong(cache, newCache,
+                                std::memory_order_release, std::memory_order_acquire)) {
+                            cache = newCache;
+                        } else {
+                            // Another thread won the race to publish the table; cache now
+                            // holds its pointer.
+                            free(newCache);
+                        }
                     }
 
                     if (kDebugStringPoolNoisy) {
                       ALOGI("Caching UTF8 string: %s", u8str);
                     }
 
-                    mCache[idx] = u16str;
+                    char16_t* expected = NULL;
+                    if (!cache[idx].compare_exchange_strong(expected, u16str,
+                            std::memory_order_release, std::memory_order_acquire)) {
+                        // Lost the per-entry race; hand back the copy that was published first.
+                        free(u16str);
+                        return expected;
+                    }
                     return u16str;
                 } else {
                     ALOGW("Bad string block: string #%lld extends to %lld, past end at %lld\n",
@@ -820,6 +840,24 @@ const char16_t* ResStringPool::stringAt(size_t idx, size_t* u16len) const
     return NULL;
 }
 
+void ResStringPool::bulkDecodeRange(size_t firstIdx, size_t count) const
+{
+    if (mError != NO_ERROR || (mHeader->flags&ResStringPool_header::UTF8_FLAG) == 0) {
+        return;
+    }
+    if (firstIdx >= mHeader->stringCount) {
+        return;
+    }
+    const size_t avail = mHeader->stringCount - firstIdx;
+    if (count > avail) {
+        count = avail;
+    }
+    size_t u16len;
+    for (size_t i = 0; i < count; i++) {
+        stringAt(firstIdx + i, &u16len);
+    }
+}
+
 const char* ResStringPool::string8At(size_t idx, size_t* outLen) const
 {
     if (mError == NO_ERROR && idx < mHeader->stringCount) {
@@ -86,6 +86,8 @@ StreamingZipInflater::StreamingZipInflater(FileMap* dataMap, size_t uncompSize)
 }
 
 StreamingZipInflater::~StreamingZipInflater() {
+    stopReadahead();
+
     // tear down the in-flight zip state just in case
     ::inflateEnd(&mInflateState);
 
@@ -93,6 +95,7 @@ StreamingZipInflater::~StreamingZipInflater() {
         delete [] mInBuf;
     }
     delete [] mOutBuf;
+    delete [] mAheadBuf;
 }
 
 void StreamingZipInflater::initInflateState() {
@@ -151,59 +154,186 @@ ssize_t StreamingZipInflater::read(void* outBuf, size_t count) {
 
         // need more data?  time to decode some.
         if (toRead > 0) {
-            // if we don't have any data to decode, read some in.  If we're working
-            // from mmapped data this won't happen, because the clipping to total size
-            // will prevent reading off the end of the mapped input chunk.
-            if ((mInflateState.avail_in == 0) && (mDataMap == NULL)) {
-                int err = readNextChunk();
-                if (err < 0) {
-                    ALOGE("Unable to access asset data: %d", err);
+            if (mAheadThread != NULL) {
+                // the helper thread has been decoding ahead of us; just swap
+                // in the chunk it has ready, or fail if it hit an error.
+                if (!takeReadaheadChunk()) {
+                    stopReadahead();
                     if (!mStreamNeedsInit) {
                         ::inflateEnd(&mInflateState);
-                        initInflateState();
                     }
+                    initInflateState();
                     return -1;
                 }
-            }
-            // we know we've drained whatever is in the out buffer now, so just
-            // start from scratch there, reading all the input we have at present.
-            mInflateState.next_out = (Bytef*) mOutBuf;
-            mInflateState.avail_out = mOutBufSize;
-
-            /*
-            ALOGV("Inflating to outbuf: avail_in=%u avail_out=%u next_in=%p next_out=%p",
-                    mInflateState.avail_in, mInflateState.avail_out,
-                    mInflateState.next_in, mInflateState.next_out);
-            */
-            int result = Z_OK;
-            if (mStreamNeedsInit) {
-                ALOGV("Initializing zlib to inflate");
-                result = inflateInit2(&mInflateState, -MAX_WBITS);
-                mStreamNeedsInit = false;
-            }
-            if (result == Z_OK) result = ::inflate(&mInflateState, Z_SYNC_FLUSH);
-            if (result < 0) {
-                // Whoops, inflation failed
-                ALOGE("Error inflating asset: %d", result);
-                ::inflateEnd(&mInflateState);
-                initInflateState();
-                return -1;
             } else {
-                if (result == Z_STREAM_END) {
-                    // we know we have to have reached the target size here and will
-                    // not try to read any further, so just wind things up.
-                    ::inflateEnd(&mInflateState);
+                ssize_t decoded = decodeChunk(mOutBuf);
+                if (decoded < 0) {
+                    if (!mStreamNeedsInit) {
+                        ::inflateEnd(&mInflateState);
+                    }
+                    initInflateState();
+                    return -1;
                 }
 
                 // Note how much data we got, and off we go
                 mOutDeliverable = 0;
-                mOutLastDecoded = mOutBufSize - mInflateState.avail_out;
+                mOutLastDecoded = decoded;
             }
         }
     }
     return bytesRead;
 }
 
+/*
+ * Decode the next chunk of output into "buf", which must hold mOutBufSize
+ * bytes.  Returns the number of bytes decoded, or -1 on a read or inflate
+ * error.  The caller is responsible for resetting the inflate state after
+ * an error.
+ */
+ssize_t StreamingZipInflater::decodeChunk(uint8_t* buf) {
+    // if we don't have any data to decode, read some in.  If we're working
+    // from mmapped data this won't happen, because the clipping to total size
+    // will prevent reading off the end of the mapped input chunk.
+    if ((mInflateState.avail_in == 0) && (mDataMap == NULL)) {
+        int err = readNextChunk();
+        if (err < 0) {
+            ALOGE("Unable to access asset data: %d", err);
+            return -1;
+        }
+    }
+    // we know we've drained whatever is in the out buffer now, so just
+    // start from scratch there, reading all the input we have at present.
+    mInflateState.next_out = (Bytef*) buf;
+    mInflateState.avail_out = mOutBufSize;
+
+    /*
+    ALOGV("Inflating to outbuf: avail_in=%u avail_out=%u next_in=%p next_out=%p",
+            mInflateState.avail_in, mInflateState.avail_out,
+            mInflateState.next_in, mInflateState.next_out);
+    */
+    int result = Z_OK;
+    if (mStreamNeedsInit) {
+        ALOGV("Initializing zlib to inflate");
+        result = inflateInit2(&mInflateState, -MAX_WBITS);
+        mStreamNeedsInit = false;
+    }
+    if (result == Z_OK) result = ::inflate(&mInflateState, Z_SYNC_FLUSH);
+    if (result < 0) {
+        // Whoops, inflation failed
+        ALOGE("Error inflating asset: %d", result);
+        return -1;
+    }
+    if (result == Z_STREAM_END) {
+        // we know we have to have reached the target size here and will
+        // not try to read any further, so just wind things up.
+        ::inflateEnd(&mInflateState);
+    }
+    return mOutBufSize - mInflateState.avail_out;
+}
+
+void StreamingZipInflater::startReadahead() {
+    if (mAheadThread != NULL) {
+        return;
+    }
+
+    // the helper only decodes what's left of the stream past whatever has
+    // already landed in mOutBuf.
+    const size_t alreadyDecoded = mOutCurPosition + (mOutLastDecoded - mOutDeliverable);
+    const size_t remaining = mOutTotalSize - alreadyDecoded;
+    if (remaining == 0) {
+        return;
+    }
+
+    if (mAheadBuf == NULL) {
+        mAheadBuf = new uint8_t[mOutBufSize];
+    }
+    mAheadValid = false;
+    mAheadError = false;
+    mAheadStopRequested = false;
+    mAheadThread = new std::thread([this, remaining] { readaheadLoop(remaining); });
+}
+
+/*
+ * Body of the helper thread: keep mAheadBuf populated with the next decoded
+ * chunk until the stream is exhausted, an error occurs, or a stop is
+ * requested.  While this runs, the helper owns the z_stream and the input
+ * buffer; the consumer only swaps output buffers under mAheadLock.
+ */
+void StreamingZipInflater::readaheadLoop(size_t remaining) {
+    std::unique_lock<std::mutex> lock(mAheadLock);
+    while (remaining > 0 && !mAheadStopRequested) {
+        while (mAheadValid && !mAheadStopRequested) {
+            mAheadDrained.wait(lock);
+        }
+        if (mAheadStopRequested) {
+            break;
+        }
+
+        lock.unlock();
+        const ssize_t decoded = decodeChunk(mAheadBuf);
+        lock.lock();
+
+        if (decoded <= 0) {
+            // a zero-byte chunk with data still expected is as fatal as an
+            // explicit error; either way the consumer must not wait forever.
+            mAheadError = true;
+            mAheadFilled.notify_one();
+            break;
+        }
+        mAheadLastDecoded = decoded;
+        mAheadValid = true;
+        remaining -= min_of(remaining, (size_t) decoded);
+        mAheadFilled.notify_one();
+    }
+}
+
+/*
+ * Swap the helper's decoded chunk into mOutBuf, blocking until one is
+ * available.  Returns "false" if the helper hit an error with no chunk left
+ * to deliver.
+ */
+bool StreamingZipInflater::takeReadaheadChunk() {
+    std::unique_lock<std::mutex> lock(mAheadLock);
+    while (!mAheadValid && !mAheadError) {
+        mAheadFilled.wait(lock);
+    }
+    if (!mAheadValid) {
+        return false;
+    }
+
+    uint8_t* tmp = mOutBuf;
+    mOutBuf = mAheadBuf;
+    mAheadBuf = tmp;
+    mOutLastDecoded = mAheadLastDecoded;
+    mOutDeliverable = 0;
+    mAheadValid = false;
+    mAheadDrained.notify_one();
+    return true;
+}
+
+/*
+ * Join the helper thread.  Any chunk it had already decoded is discarded, so
+ * the caller must reset the inflate state (or be tearing the whole object
+ * down) before reading again.
+ */
+void StreamingZipInflater::stopReadahead() {
+    if (mAheadThread == NULL) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mAheadLock);
+        mAheadStopRequested = true;
+        mAheadDrained.notify_one();
+    }
+    mAheadThread->join();
+    delete mAheadThread;
+    mAheadThread = NULL;
+    mAheadValid = false;
+    mAheadError = false;
+    mAheadStopRequested = false;
+}
+
 int StreamingZipInflater::readNextChunk() {
     assert(mDataMap == NULL);
 
@@ -232,12 +362,18 @@ int StreamingZipInflater::readNextChunk() {
 // position to the destination.
 off64_t StreamingZipInflater::seekAbsolute(off64_t absoluteInputPosition) {
     if (absoluteInputPosition < mOutCurPosition) {
-        // rewind and reprocess the data from the beginning
+        // rewind and reprocess the data from the beginning, restarting the
+        // readahead helper afterwards if one was running
+        const bool restartReadahead = (mAheadThread != NULL);
+        stopReadahead();
         if (!mStreamNeedsInit) {
             ::inflateEnd(&mInflateState);
         }
         initInflateState();
         read(NULL, absoluteInputPosition);
+        if (restartReadahead) {
+            startReadahead();
+        }
     } else if (absoluteInputPosition > mOutCurPosition) {
         read(NULL, absoluteInputPosition - mOutCurPosition);
     }
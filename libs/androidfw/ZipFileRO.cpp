@@ -32,7 +32,9 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <assert.h>
+#include <inttypes.h>
 #include <unistd.h>
+#include <sys/stat.h>
 
 using namespace android;
 
@@ -54,6 +56,7 @@ private:
 };
 
 ZipFileRO::~ZipFileRO() {
+    delete mArchiveMap;
     CloseArchive(mHandle);
     if (mFileName != NULL) {
         free(mFileName);
@@ -190,6 +193,35 @@ void ZipFileRO::releaseEntry(ZipEntryRO entry) const
     delete reinterpret_cast<_ZipEntryRO*>(entry);
 }
 
+/*
+ * Snapshot every entry's stats in a single sequential walk of the central
+ * directory.
+ */
+bool ZipFileRO::getBulkEntries(std::vector<BulkEntry>* entries)
+{
+    void* iterationCookie;
+    if (!startIteration(&iterationCookie)) {
+        return false;
+    }
+
+    _ZipEntryRO* ze = reinterpret_cast<_ZipEntryRO*>(iterationCookie);
+    while (Next(ze->cookie, &(ze->entry), &(ze->name)) == 0) {
+        entries->push_back(BulkEntry());
+        BulkEntry& info = entries->back();
+        info.name = String8(reinterpret_cast<const char*>(ze->name.name),
+                ze->name.name_length);
+        info.method = ze->entry.method;
+        info.uncompressedLength = ze->entry.uncompressed_length;
+        info.compressedLength = ze->entry.compressed_length;
+        info.offset = ze->entry.offset;
+        info.modWhen = ze->entry.mod_time;
+        info.crc32 = ze->entry.crc32;
+    }
+
+    endIteration(iterationCookie);
+    return true;
+}
+
 /*
  * Copy the entry's filename to the buffer.
  */
@@ -235,6 +267,49 @@ FileMap* ZipFileRO::createEntryFileMap(ZipEntryRO entry) const
     return newMap;
 }
 
+/*
+ * Return a pointer directly into a shared mapping of the archive for a
+ * stored entry's data.
+ */
+StringPiece ZipFileRO::getEntryMappedData(ZipEntryRO entry) const
+{
+    const _ZipEntryRO* zipEntry = reinterpret_cast<_ZipEntryRO*>(entry);
+    const ZipEntry& ze = zipEntry->entry;
+
+    if (ze.method != kCompressStored) {
+        return StringPiece();
+    }
+
+    AutoMutex _l(mArchiveMapLock);
+    if (mArchiveMap == NULL) {
+        int fd = GetFileDescriptor(mHandle);
+        struct stat sb;
+        if (fstat(fd, &sb) < 0) {
+            ALOGW("fstat of archive %s failed: errno=%d",
+                    mFileName != NULL ? mFileName : "<null>", errno);
+            return StringPiece();
+        }
+
+        FileMap* newMap = new FileMap();
+        if (!newMap->create(mFileName, fd, 0, sb.st_size, true)) {
+            delete newMap;
+            return StringPiece();
+        }
+        mArchiveMap = newMap;
+    }
+
+    if (ze.offset < 0 || static_cast<uint64_t>(ze.offset) + ze.uncompressed_length >
+            mArchiveMap->getDataLength()) {
+        ALOGW("Bogus stored entry bounds: offset=%" PRId64 " len=%" PRIu32,
+                static_cast<int64_t>(ze.offset), ze.uncompressed_length);
+        return StringPiece();
+    }
+
+    return StringPiece(
+            reinterpret_cast<const char*>(mArchiveMap->getDataPtr()) + ze.offset,
+            ze.uncompressed_length);
+}
+
 /*
  * Uncompress an entry, in its entirety, into the provided output buffer.
  *
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "android-base/macros.h"
 #include "android-base/unique_fd.h"
@@ -42,6 +43,15 @@ class ApkAssets {
   // filter out this package when computing what configurations/resources are available.
   static std::unique_ptr<const ApkAssets> Load(const std::string& path, bool system = false);
 
+  // Creates an ApkAssets for each path in `paths`, loading them concurrently on a small
+  // thread pool. This is useful for applications that ship many split APKs, where loading
+  // the splits one after the other serializes zip central-directory parsing and resource
+  // table verification.
+  // The returned vector has the same size and order as `paths`. An entry is nullptr if the
+  // corresponding APK failed to load, mirroring the behavior of Load().
+  static std::vector<std::unique_ptr<const ApkAssets>> LoadParallel(
+      const std::vector<std::string>& paths, bool system = false);
+
   // Creates an ApkAssets, but forces any package with ID 0x7f to be loaded as a shared library.
   // If `system` is true, the package is marked as a system package, and allows some functions to
   // filter out this package when computing what configurations/resources are available.
@@ -55,6 +65,14 @@ class ApkAssets {
   static std::unique_ptr<const ApkAssets> LoadOverlay(const std::string& idmap_path,
                                                       bool system = false);
 
+  // LoadOverlay for each idmap path in `idmap_paths`, loading them concurrently on the same
+  // kind of thread pool LoadParallel() uses. Each idmap and its overlay APK are independent,
+  // so overlay-heavy configurations avoid serializing the per-overlay zip and resource table
+  // work. The returned vector has the same size and order as `idmap_paths`, with nullptr for
+  // entries that failed to load.
+  static std::vector<std::unique_ptr<const ApkAssets>> LoadOverlayParallel(
+      const std::vector<std::string>& idmap_paths, bool system = false);
+
   // Creates an ApkAssets from the given file descriptor, and takes ownership of the file
   // descriptor. The `friendly_name` is some name that will be used to identify the source of
   // this ApkAssets in log messages and other debug scenarios.
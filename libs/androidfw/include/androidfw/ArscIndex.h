@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROIDFW_ARSCINDEX_H_
+#define ANDROIDFW_ARSCINDEX_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "android-base/macros.h"
+
+#include "androidfw/StringPiece.h"
+
+namespace android {
+
+// A precomputed index over the chunk layout of a resources.arsc file.
+//
+// Loading a resource table normally requires walking every chunk in the file to discover
+// the offsets of the package, type spec, and type chunks. For large APKs this chunk walk is
+// repeated on every load even though the layout of the immutable resources.arsc never changes.
+// An ArscIndex records the chunk offsets once so that subsequent loads can jump straight to
+// the chunks of interest.
+//
+// The serialized form produced by Build() is a flat binary blob suitable for caching on disk
+// next to the APK (or in any other cache keyed by the APK) and memory-mapping later. Load()
+// validates a serialized index against the resources.arsc it will be used with: the index is
+// rejected if it was built from different contents or if any recorded offset does not describe
+// a well-formed chunk. A validated ArscIndex can be passed to LoadedArsc::Load(), which will
+// then consume the recorded offsets instead of walking the chunks again.
+class ArscIndex {
+ public:
+  // Offsets of a chunk and of its child chunks, all relative to the start of the
+  // resources.arsc data. Only package chunks have children recorded.
+  struct ChunkIndex {
+    uint32_t offset;
+    std::vector<uint32_t> children;
+  };
+
+  // Offsets for a single RES_TABLE_TYPE chunk and its children (string pool and packages).
+  struct TableIndex {
+    uint32_t offset;
+    std::vector<ChunkIndex> children;
+  };
+
+  // Builds a serialized index for the resource table in `arsc_data` by walking its chunks once.
+  // Returns an empty string if the data does not contain a well-formed resource table.
+  static std::string Build(const StringPiece& arsc_data);
+
+  // Parses the serialized index in `index_data` and validates it against `arsc_data`.
+  // Returns nullptr if the index is corrupt, was built from different contents, or contains
+  // offsets that do not describe well-formed chunks within `arsc_data`.
+  // The returned index does not own `arsc_data` and is only valid for use with it.
+  static std::unique_ptr<const ArscIndex> Load(const StringPiece& index_data,
+                                               const StringPiece& arsc_data);
+
+  inline const std::vector<TableIndex>& tables() const {
+    return tables_;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ArscIndex);
+
+  ArscIndex() = default;
+
+  std::vector<TableIndex> tables_;
+};
+
+}  // namespace android
+
+#endif  // ANDROIDFW_ARSCINDEX_H_
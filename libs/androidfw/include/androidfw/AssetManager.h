@@ -280,13 +280,14 @@ private:
         ~SharedZip();
 
     private:
-        SharedZip(const String8& path, time_t modWhen);
+        SharedZip(const String8& path, time_t modWhen, off64_t fileSize);
         SharedZip(int fd, const String8& path);
         SharedZip(); // <-- not implemented
 
         String8 mPath;
         ZipFileRO* mZipFile;
         time_t mModWhen;
+        off64_t mFileSize;
 
         Asset* mResourceTableAsset;
         ResTable* mResourceTable;
@@ -21,6 +21,7 @@
 
 #include <array>
 #include <limits>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 
@@ -72,7 +73,30 @@ struct ResolvedBag {
   Entry entries[0];
 };
 
-struct FindEntryResult;
+struct FindEntryResult {
+  // A pointer to the resource table entry for this resource.
+  // If the size of the entry is > sizeof(ResTable_entry), it can be cast to
+  // a ResTable_map_entry and processed as a bag/map.
+  const ResTable_entry* entry;
+
+  // The configuration for which the resulting entry was defined. This is already swapped to host
+  // endianness.
+  ResTable_config config;
+
+  // The bitmask of configuration axis with which the resource value varies.
+  uint32_t type_flags;
+
+  // The dynamic package ID map for the package from which this resource came from.
+  const DynamicRefTable* dynamic_ref_table;
+
+  // The string pool reference to the type's name. This uses a different string pool than
+  // the global string pool, but this is hidden from the caller.
+  StringPoolRef type_string_ref;
+
+  // The string pool reference to the entry's name. This uses a different string pool than
+  // the global string pool, but this is hidden from the caller.
+  StringPoolRef entry_string_ref;
+};
 
 // AssetManager2 is the main entry point for accessing assets and resources.
 // AssetManager2 provides caching of resources retrieved via the underlying ApkAssets.
@@ -94,6 +118,7 @@ class AssetManager2 {
   };
 
   AssetManager2();
+  ~AssetManager2();
 
   // Sets/resets the underlying ApkAssets for this AssetManager. The ApkAssets
   // are not owned by the AssetManager, and must have a longer lifetime.
@@ -236,6 +261,8 @@ class AssetManager2 {
   // disabled.
   void SetResourceResolutionLoggingEnabled(bool enabled);
 
+  bool IsResourceResolutionLoggingEnabled() const;
+
   // Returns formatted log of last resource resolution path, or empty if no
   // resource has been resolved yet.
   std::string GetLastResourceResolution() const;
@@ -307,6 +334,15 @@ class AssetManager2 {
   // been seen while traversing bag parents.
   const ResolvedBag* GetBag(uint32_t resid, std::vector<uint32_t>& child_resids);
 
+  // Returns the cached flattened theme for the given chain of applied styles, or nullptr if
+  // no theme with that exact chain has been flattened yet. Called by Theme::ApplyStyle().
+  const Theme* GetCachedThemeChain(const std::string& chain_key) const;
+
+  // Stores a flattened copy of `theme`, keyed by its chain of applied styles, so that other
+  // themes applying the same chain can copy the flattened table instead of replaying each
+  // style bag. Called by Theme::ApplyStyle().
+  void CacheThemeChain(const std::string& chain_key, const Theme& theme);
+
   // Retrieve the assigned package id of the package if loaded into this AssetManager
   uint8_t GetAssignedPackageId(const LoadedPackage* package);
 
@@ -315,7 +351,8 @@ class AssetManager2 {
   std::vector<const ApkAssets*> apk_assets_;
 
   // A collection of configurations and their associated ResTable_type that match the current
-  // AssetManager configuration.
+  // AssetManager configuration, ranked best-match-first so that lookups can stop at the first
+  // candidate that defines the requested entry.
   struct FilteredConfigGroup {
     std::vector<ResTable_config> configurations;
     std::vector<const ResTable_type*> types;
@@ -364,10 +401,49 @@ class AssetManager2 {
   // which involves some calculation.
   std::unordered_map<uint32_t, util::unique_cptr<ResolvedBag>> cached_bags_;
 
+  // A resolved entry for the currently set configuration, cached because hot resource IDs are
+  // resolved over and over again during inflation and the result only changes when the
+  // configuration or the set of ApkAssets changes.
+  struct CachedResolvedEntry {
+    ApkAssetsCookie cookie;
+    FindEntryResult entry;
+  };
+
+  // Cached set of resolved entries, keyed by resource ID. Entries are only cached for lookups
+  // against the currently set configuration and are purged by InvalidateCaches() whenever
+  // SetApkAssets() or SetConfiguration() changes what a resource ID resolves to.
+  // Guarded by cached_resolved_entries_lock_: FindEntry is const and runs under Guarded's
+  // shared read lock, so concurrent lookups may probe and populate this map at the same time.
+  mutable std::mutex cached_resolved_entries_lock_;
+  mutable std::unordered_map<uint32_t, CachedResolvedEntry> cached_resolved_entries_;
+
   // Cached set of bag resid stacks for each bag. These are cached because they might be requested
   // a number of times for each view during View inspection.
   std::unordered_map<uint32_t, std::vector<uint32_t>> cached_bag_resid_stacks_;
 
+  // Cached results of GetResourceConfigurations() and GetResourceLocales(), one slot per
+  // combination of each call's two boolean parameters. Frameworks call these repeatedly
+  // during configuration changes, so each slot keeps a sorted flat vector built on first
+  // use and dropped whenever the set of ApkAssets changes.
+  struct CachedConfigurations {
+    bool valid = false;
+    std::vector<ResTable_config> configurations;
+  };
+
+  struct CachedLocales {
+    bool valid = false;
+    std::vector<std::string> locales;
+  };
+
+  mutable std::array<CachedConfigurations, 4> cached_resource_configurations_;
+  mutable std::array<CachedLocales, 4> cached_resource_locales_;
+
+  // Cached flattened themes, keyed by the serialized chain of (style resid, force) pairs that
+  // was applied to produce them. Applications apply the same few style chains to every theme
+  // they create, so the number of distinct chains stays small. Purged by InvalidateCaches()
+  // based on each cached theme's changing configurations.
+  std::unordered_map<std::string, std::unique_ptr<Theme>> cached_theme_chains_;
+
   // Whether or not to save resource resolution steps
   bool resource_resolution_logging_enabled_ = false;
 
@@ -425,6 +501,13 @@ class Theme {
   // Returns false if the style failed to apply.
   bool ApplyStyle(uint32_t resid, bool force = false);
 
+  // Rebuilds this theme from the given chain of styles, as if Clear() were called followed by
+  // ApplyStyle() for each entry of the parallel arrays `style_resids` and `force`. If the
+  // requested chain is exactly the chain already applied, the theme is left untouched, which
+  // makes this cheap to call on every configuration change.
+  // Returns false if any style in the chain failed to apply.
+  bool Rebase(const uint32_t* style_resids, const uint8_t* force, size_t style_count);
+
   // Sets this Theme to be a copy of `o` if `o` has the same AssetManager as this Theme.
   // If `o` does not have the same AssetManager as this theme, only attributes from ApkAssets loaded
   // into both AssetManagers will be copied to this theme.
@@ -476,6 +559,14 @@ class Theme {
   AssetManager2* asset_manager_;
   uint32_t type_spec_flags_ = 0u;
 
+  // Serialized chain of (style resid, force) pairs applied to this theme. Used as the key
+  // into the AssetManager's flattened theme chain cache.
+  std::string chain_key_;
+
+  // Whether this theme's contents are fully described by chain_key_. Cleared when the theme
+  // is copied from a theme of a different AssetManager or an ApplyStyle() fails midway.
+  bool cacheable_ = true;
+
   // Defined in the cpp.
   struct Package;
 
@@ -55,6 +55,25 @@ void ApplyStyle(Theme* theme, ResXMLParser* xml_parser, uint32_t def_style_attr,
                 uint32_t def_style_resid, const uint32_t* attrs, size_t attrs_length,
                 uint32_t* out_values, uint32_t* out_indices);
 
+// A single view's inputs and outputs for ApplyStyleBatched().
+struct StyleBatchEntry {
+  // The XML parser positioned at the view's tag. May be nullptr.
+  ResXMLParser* xml_parser;
+
+  const uint32_t* attrs;
+  size_t attrs_length;
+
+  // `out_values` and `out_indices` must NOT be nullptr.
+  uint32_t* out_values;
+  uint32_t* out_indices;
+};
+
+// Batched variant of ApplyStyle() that applies the same theme and default style to several
+// views in one call. The default style resolution and its bag lookup are shared across the
+// whole batch instead of being repeated per view.
+void ApplyStyleBatched(Theme* theme, uint32_t def_style_attr, uint32_t def_style_resid,
+                       const StyleBatchEntry* entries, size_t entry_count);
+
 // `out_values` must NOT be nullptr.
 // `out_indices` may be nullptr.
 bool RetrieveAttributes(AssetManager2* assetmanager, ResXMLParser* xml_parser, uint32_t* attrs,
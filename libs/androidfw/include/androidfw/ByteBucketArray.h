@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <utility>
 
 #include "android-base/logging.h"
 
@@ -27,6 +28,10 @@ namespace android {
 /**
  * Stores a sparsely populated array. Has a fixed size of 256
  * (number of entries that a byte can represent).
+ *
+ * Starts out bucketed so sparse tables only pay for the buckets they touch.
+ * Once enough buckets have been allocated the contents collapse into a single
+ * contiguous array, trading the bucket indirection for one branch on access.
  */
 template <typename T>
 class ByteBucketArray {
@@ -34,12 +39,8 @@ class ByteBucketArray {
   ByteBucketArray() : default_() { memset(buckets_, 0, sizeof(buckets_)); }
 
   ~ByteBucketArray() {
-    for (size_t i = 0; i < kNumBuckets; i++) {
-      if (buckets_[i] != NULL) {
-        delete[] buckets_[i];
-      }
-    }
-    memset(buckets_, 0, sizeof(buckets_));
+    deleteBuckets();
+    delete[] dense_;
   }
 
   inline size_t size() const { return kNumBuckets * kBucketSize; }
@@ -51,6 +52,10 @@ class ByteBucketArray {
       return default_;
     }
 
+    if (dense_ != NULL) {
+      return dense_[static_cast<uint8_t>(index)];
+    }
+
     uint8_t bucket_index = static_cast<uint8_t>(index) >> 4;
     T* bucket = buckets_[bucket_index];
     if (bucket == NULL) {
@@ -63,10 +68,18 @@ class ByteBucketArray {
     CHECK(index < size()) << "ByteBucketArray.editItemAt(index=" << index
                           << ") with size=" << size();
 
+    if (dense_ != NULL) {
+      return dense_[static_cast<uint8_t>(index)];
+    }
+
     uint8_t bucket_index = static_cast<uint8_t>(index) >> 4;
     T* bucket = buckets_[bucket_index];
     if (bucket == NULL) {
       bucket = buckets_[bucket_index] = new T[kBucketSize]();
+      if (++allocated_buckets_ >= kDenseThreshold) {
+        collapseToDense();
+        return dense_[static_cast<uint8_t>(index)];
+      }
     }
     return bucket[0x0f & static_cast<uint8_t>(index)];
   }
@@ -81,9 +94,37 @@ class ByteBucketArray {
   }
 
  private:
-  enum { kNumBuckets = 16, kBucketSize = 16 };
+  enum { kNumBuckets = 16, kBucketSize = 16, kDenseThreshold = kNumBuckets / 2 };
+
+  // Move everything into one contiguous array once most buckets exist, at which
+  // point the extra indirection stops paying for itself. References returned by
+  // earlier calls to editItemAt() are invalidated, which is why this only runs
+  // while a fresh bucket is being created.
+  void collapseToDense() {
+    dense_ = new T[kNumBuckets * kBucketSize]();
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      if (buckets_[i] == NULL) {
+        continue;
+      }
+      for (size_t j = 0; j < kBucketSize; j++) {
+        dense_[(i << 4) + j] = std::move(buckets_[i][j]);
+      }
+    }
+    deleteBuckets();
+  }
+
+  void deleteBuckets() {
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      if (buckets_[i] != NULL) {
+        delete[] buckets_[i];
+      }
+    }
+    memset(buckets_, 0, sizeof(buckets_));
+  }
 
   T* buckets_[kNumBuckets];
+  T* dense_ = NULL;
+  size_t allocated_buckets_ = 0;
   T default_;
 };
 
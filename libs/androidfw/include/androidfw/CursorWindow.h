@@ -51,7 +51,7 @@ namespace android {
  */
 class CursorWindow {
     CursorWindow(const String8& name, int ashmemFd,
-            void* data, size_t size, bool readOnly);
+            void* data, size_t size, size_t maxSize, bool readOnly);
 
 public:
     /* Field types. */
@@ -82,6 +82,15 @@ public:
     ~CursorWindow();
 
     static status_t create(const String8& name, size_t size, CursorWindow** outCursorWindow);
+
+    /**
+     * Creates a window that starts at `size` bytes but may grow up to `maxSize` bytes
+     * as rows are added. The backing ashmem region is created at `maxSize` and committed
+     * lazily by the kernel, so growing the window is free of copies and existing row
+     * offsets remain valid.
+     */
+    static status_t create(const String8& name, size_t size, size_t maxSize,
+            CursorWindow** outCursorWindow);
     static status_t createFromParcel(Parcel* parcel, CursorWindow** outCursorWindow);
 
     status_t writeToParcel(Parcel* parcel);
@@ -165,9 +174,22 @@ private:
     int mAshmemFd;
     void* mData;
     size_t mSize;
+    size_t mMaxSize;
     bool mReadOnly;
     Header* mHeader;
 
+    // Cached tail of the row slot chunk chain so allocRowSlot() doesn't walk the
+    // whole chain for every row. mTailChunkBaseRow is the row index of the first
+    // slot in the chunk at mTailChunkOffset; 0/0 refers to the first chunk.
+    uint32_t mTailChunkOffset;
+    uint32_t mTailChunkBaseRow;
+
+    // Field directory of the row most recently created by allocRow(), so the writer
+    // can fill every column of that row without re-walking the chunk chain per field.
+    // Only touched by the writer methods; 0 means the cache is invalid.
+    uint32_t mWriteFieldDirOffset;
+    uint32_t mWriteRow;
+
     inline void* offsetToPtr(uint32_t offset, uint32_t bufferSize = 0) {
         if (offset >= mSize) {
             ALOGE("Offset %" PRIu32 " out of bounds, max value %zu", offset, mSize);
@@ -195,6 +217,10 @@ private:
     RowSlot* getRowSlot(uint32_t row);
     RowSlot* allocRowSlot();
 
+    // getFieldSlot() for the put methods; serves the row cached by allocRow() without
+    // a row slot lookup.
+    FieldSlot* getFieldSlotForWrite(uint32_t row, uint32_t column);
+
     status_t putBlobOrString(uint32_t row, uint32_t column,
             const void* value, size_t size, int32_t type);
 };
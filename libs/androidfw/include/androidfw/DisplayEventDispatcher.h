@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <vector>
+
 #include <gui/DisplayEventReceiver.h>
 #include <utils/Log.h>
 #include <utils/Looper.h>
@@ -33,6 +35,17 @@ public:
 protected:
     virtual ~DisplayEventDispatcher() = default;
 
+    struct VsyncEvent {
+        nsecs_t timestamp;
+        PhysicalDisplayId displayId;
+        uint32_t count;
+    };
+
+    // Called once per wake with the newest pending vsync of each display.
+    // The default implementation keeps the historical behavior of delivering
+    // only the single most recent pulse.
+    virtual void dispatchVsyncEvents(const std::vector<VsyncEvent>& events);
+
 private:
     sp<Looper> mLooper;
     DisplayEventReceiver mReceiver;
@@ -45,7 +58,6 @@ private:
                                        int32_t configId) = 0;
 
     virtual int handleEvent(int receiveFd, int events, void* data);
-    bool processPendingEvents(nsecs_t* outTimestamp, PhysicalDisplayId* outDisplayId,
-                              uint32_t* outCount);
+    bool processPendingEvents(std::vector<VsyncEvent>* outEvents);
 };
 }
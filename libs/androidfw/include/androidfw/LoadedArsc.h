@@ -25,6 +25,7 @@
 
 #include "android-base/macros.h"
 
+#include "androidfw/ArscIndex.h"
 #include "androidfw/ByteBucketArray.h"
 #include "androidfw/Chunk.h"
 #include "androidfw/Idmap.h"
@@ -135,9 +136,15 @@ class LoadedPackage {
     return iterator(this, resource_ids_.size() + 1, 0);
   }
 
+  // If `package_index` is non-null, the recorded child chunk offsets (relative to `base`)
+  // are consumed instead of walking the chunks within `chunk`. The offsets must have been
+  // validated by ArscIndex::Load().
   static std::unique_ptr<const LoadedPackage> Load(const Chunk& chunk,
                                                    const LoadedIdmap* loaded_idmap, bool system,
-                                                   bool load_as_shared_library);
+                                                   bool load_as_shared_library,
+                                                   const uint8_t* base = nullptr,
+                                                   const ArscIndex::ChunkIndex* package_index =
+                                                       nullptr);
 
   ~LoadedPackage();
 
@@ -279,10 +286,14 @@ class LoadedArsc {
   // If `load_as_shared_library` is set to true, the application package (0x7f) is treated
   // as a shared library (0x00). When loaded into an AssetManager, the package will be assigned an
   // ID.
+  // If `index` is non-null, it must have been validated against `data` with ArscIndex::Load().
+  // The recorded chunk offsets are then consumed instead of walking every chunk in `data`,
+  // which avoids re-deriving the table layout on every load of a large, immutable table.
   static std::unique_ptr<const LoadedArsc> Load(const StringPiece& data,
                                                 const LoadedIdmap* loaded_idmap = nullptr,
                                                 bool system = false,
-                                                bool load_as_shared_library = false);
+                                                bool load_as_shared_library = false,
+                                                const ArscIndex* index = nullptr);
 
   // Create an empty LoadedArsc. This is used when an APK has no resources.arsc.
   static std::unique_ptr<const LoadedArsc> CreateEmpty();
@@ -311,7 +322,9 @@ class LoadedArsc {
   DISALLOW_COPY_AND_ASSIGN(LoadedArsc);
 
   LoadedArsc() = default;
-  bool LoadTable(const Chunk& chunk, const LoadedIdmap* loaded_idmap, bool load_as_shared_library);
+  bool LoadTable(const Chunk& chunk, const LoadedIdmap* loaded_idmap, bool load_as_shared_library,
+                 const uint8_t* base = nullptr,
+                 const ArscIndex::TableIndex* table_index = nullptr);
 
   ResStringPool global_string_pool_;
   std::vector<std::unique_ptr<const LoadedPackage>> packages_;
@@ -18,6 +18,7 @@
 #define ANDROIDFW_MUTEXGUARD_H
 
 #include <mutex>
+#include <shared_mutex>
 #include <type_traits>
 
 #include "android-base/macros.h"
@@ -27,9 +28,14 @@ namespace android {
 template <typename T>
 class ScopedLock;
 
+template <typename T>
+class ScopedReadLock;
+
 // Owns the guarded object and protects access to it via a mutex.
 // The guarded object is inaccessible via this class.
-// The mutex is locked and the object accessed via the ScopedLock<T> class.
+// The mutex is locked and the object accessed via the ScopedLock<T> class,
+// or, for const access that may proceed concurrently with other readers,
+// via the ScopedReadLock<T> class.
 //
 // NOTE: The template parameter T should not be a raw pointer, since ownership
 // is ambiguous and error-prone. Instead use an std::unique_ptr<>.
@@ -64,10 +70,11 @@ class Guarded {
 
  private:
   friend class ScopedLock<T>;
+  friend class ScopedReadLock<T>;
 
   DISALLOW_COPY_AND_ASSIGN(Guarded);
 
-  std::mutex lock_;
+  std::shared_timed_mutex lock_;
   T guarded_;
 };
 
@@ -92,10 +99,39 @@ class ScopedLock {
  private:
   DISALLOW_COPY_AND_ASSIGN(ScopedLock);
 
-  std::lock_guard<std::mutex> lock_;
+  std::lock_guard<std::shared_timed_mutex> lock_;
   T& guarded_;
 };
 
+// Shared (reader) counterpart of ScopedLock. Multiple ScopedReadLocks may
+// hold the same Guarded object at once, so only const access is exposed;
+// anything the guarded object mutates behind const methods must be safe for
+// concurrent callers.
+template <typename T>
+class ScopedReadLock {
+ public:
+  explicit ScopedReadLock(Guarded<T>& guarded) : lock_(guarded.lock_), guarded_(guarded.guarded_) {
+  }
+
+  const T& operator*() const {
+    return guarded_;
+  }
+
+  const T* operator->() const {
+    return &guarded_;
+  }
+
+  const T* get() const {
+    return &guarded_;
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ScopedReadLock);
+
+  std::shared_lock<std::shared_timed_mutex> lock_;
+  const T& guarded_;
+};
+
 }  // namespace android
 
 #endif  // ANDROIDFW_MUTEXGUARD_H
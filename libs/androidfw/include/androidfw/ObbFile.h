@@ -22,6 +22,7 @@
 
 #include <utils/RefBase.h>
 #include <utils/String8.h>
+#include <utils/Vector.h>
 
 namespace android {
 
@@ -38,6 +39,16 @@ public:
 
     bool readFrom(const char* filename);
     bool readFrom(int fd);
+
+    /*
+     * Parses the footer of every regular file in the given directory in one
+     * pass and appends the successfully parsed files to outFiles. Footers
+     * that were already parsed for an unchanged file (same path, mtime and
+     * size) are served from a cache without reopening the file. Returns
+     * false only if the directory itself cannot be read.
+     */
+    static bool scanDirectory(const char* dirPath, Vector<sp<ObbFile> >* outFiles);
+
     bool writeTo(const char* filename);
     bool writeTo(int fd);
     bool removeFrom(const char* filename);
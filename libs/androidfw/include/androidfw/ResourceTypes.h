@@ -29,6 +29,7 @@
 
 #include <utils/threads.h>
 
+#include <atomic>
 #include <stdint.h>
 #include <sys/types.h>
 
@@ -508,6 +509,11 @@ public:
     }
     const char16_t* stringAt(size_t idx, size_t* outLen) const;
 
+    // Eagerly converts a contiguous run of strings to UTF16 (for example the
+    // strings referenced by a style's spans) so later stringAt calls on them
+    // are cache hits. No-op for UTF16 pools, which need no conversion.
+    void bulkDecodeRange(size_t firstIdx, size_t count) const;
+
     // Note: returns null if the string pool is not UTF8.
     const char* string8At(size_t idx, size_t* outLen) const;
 
@@ -532,11 +538,13 @@ private:
     void*                       mOwnedData;
     const ResStringPool_header* mHeader;
     size_t                      mSize;
-    mutable Mutex               mDecodeLock;
     const uint32_t*             mEntries;
     const uint32_t*             mEntryStyles;
     const void*                 mStrings;
-    char16_t mutable**          mCache;
+    // Lazily created table of decoded UTF16 strings. Both the table pointer
+    // and its slots are published with compare-and-swap, so readers never
+    // take a lock; a losing decoder frees its copy and uses the winner's.
+    mutable std::atomic<std::atomic<char16_t*>*> mCache;
     uint32_t                    mStringPoolSize;    // number of uint16_t
     const uint32_t*             mStyles;
     uint32_t                    mStylePoolSize;    // number of uint32_t
@@ -21,6 +21,10 @@
 #include <inttypes.h>
 #include <zlib.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <utils/Compat.h>
 
 namespace android {
@@ -47,9 +51,20 @@ public:
     // position to the destination.
     off64_t seekAbsolute(off64_t absoluteInputPosition);
 
+    // Start decoding ahead of the stream position on a helper thread.  While
+    // the consumer drains one output chunk the helper keeps the next one
+    // inflated in a second buffer, overlapping file reads and inflation with
+    // delivery.  Stays in effect until the end of the stream or a backwards
+    // seek (which restarts it after the rewind).  No-op if already started.
+    void startReadahead();
+
 private:
     void initInflateState();
     int readNextChunk();
+    ssize_t decodeChunk(uint8_t* buf);
+    void readaheadLoop(size_t remaining);
+    bool takeReadaheadChunk();
+    void stopReadahead();
 
     // where to find the uncompressed data
     int mFd;
@@ -77,6 +92,19 @@ private:
     // input state bookkeeping
     size_t mInNextChunkOffset;  // offset from start of blob at which the next input chunk lies
     // the z_stream contains state about input block consumption
+
+    // double-buffered readahead state.  While the helper thread is running it
+    // owns the z_stream and input bookkeeping above; the consumer only touches
+    // the mOut* delivery state and swaps buffers under mAheadLock.
+    std::thread* mAheadThread = nullptr;
+    uint8_t* mAheadBuf = nullptr;   // second output buf, decoded by the helper
+    size_t mAheadLastDecoded = 0;   // decoded bytes in mAheadBuf when valid
+    bool mAheadValid = false;       // mAheadBuf holds an undelivered chunk
+    bool mAheadError = false;       // the helper hit a read or inflate error
+    bool mAheadStopRequested = false;
+    std::mutex mAheadLock;
+    std::condition_variable mAheadFilled;   // helper filled mAheadBuf
+    std::condition_variable mAheadDrained;  // consumer took mAheadBuf
 };
 
 }
@@ -33,6 +33,7 @@
 #include <utils/Compat.h>
 #include <utils/Errors.h>
 #include <utils/FileMap.h>
+#include <utils/String8.h>
 #include <utils/threads.h>
 
 #include <stdint.h>
@@ -41,6 +42,10 @@
 #include <unistd.h>
 #include <time.h>
 
+#include <vector>
+
+#include "androidfw/StringPiece.h"
+
 struct ZipArchive;
 typedef ZipArchive* ZipArchiveHandle;
 
@@ -110,6 +115,29 @@ public:
 
     void releaseEntry(ZipEntryRO entry) const;
 
+    /*
+     * A snapshot of one entry's vital stats taken during a bulk scan.
+     */
+    struct BulkEntry {
+        String8 name;
+        uint16_t method;
+        uint32_t uncompressedLength;
+        uint32_t compressedLength;
+        off64_t offset;
+        uint32_t modWhen;
+        uint32_t crc32;
+    };
+
+    /*
+     * Scan the entire central directory in one sequential pass and append
+     * the stats for every entry to "entries". This touches the directory
+     * in storage order, so the walk is prefetch friendly, and it avoids
+     * the per-entry allocation that findEntryByName() pays.
+     *
+     * Returns "false" if iteration could not be started.
+     */
+    bool getBulkEntries(std::vector<BulkEntry>* entries);
+
     /*
      * Return the #of entries in the Zip archive.
      */
@@ -143,6 +171,18 @@ public:
      */
     FileMap* createEntryFileMap(ZipEntryRO entry) const;
 
+    /*
+     * Return a zero-copy view of an uncompressed (stored) entry's data.
+     * The view is backed by a single mapping of the whole archive that is
+     * created on first use and shared by every caller, so reading many
+     * stored entries does not pay a map/unmap per entry.
+     *
+     * Returns a piece with a NULL data pointer if the entry is compressed
+     * or its bounds look bogus. The view is valid for the lifetime of this
+     * ZipFileRO.
+     */
+    StringPiece getEntryMappedData(ZipEntryRO entry) const;
+
     /*
      * Uncompress the data into a buffer.  Depending on the compression
      * format, this is either an "inflate" operation or a memcpy.
@@ -167,12 +207,17 @@ private:
     ZipFileRO& operator=(const ZipFileRO& src);
 
     ZipFileRO(ZipArchiveHandle handle, char* fileName) : mHandle(handle),
-        mFileName(fileName)
+        mFileName(fileName), mArchiveMap(NULL)
     {
     }
 
     const ZipArchiveHandle mHandle;
     char* mFileName;
+
+    // Lazily created mapping of the entire archive, used by
+    // getEntryMappedData(). Guarded by mArchiveMapLock.
+    mutable Mutex mArchiveMapLock;
+    mutable FileMap* mArchiveMap;
 };
 
 }; // namespace android
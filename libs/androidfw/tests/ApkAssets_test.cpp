@@ -45,6 +45,26 @@ TEST(ApkAssetsTest, LoadApk) {
   ASSERT_THAT(loaded_apk->Open("res/layout/main.xml"), NotNull());
 }
 
+TEST(ApkAssetsTest, LoadApksParallel) {
+  const std::vector<std::string> paths = {
+      GetTestDataPath() + "/basic/basic.apk",
+      GetTestDataPath() + "/basic/basic_de_fr.apk",
+      GetTestDataPath() + "/basic/basic_hdpi-v4.apk",
+      GetTestDataPath() + "/basic/basic_xhdpi-v4.apk",
+      GetTestDataPath() + "/does/not/exist.apk",
+  };
+
+  std::vector<std::unique_ptr<const ApkAssets>> loaded_apks = ApkAssets::LoadParallel(paths);
+  ASSERT_THAT(loaded_apks, SizeIs(paths.size()));
+
+  // Results must line up with the input paths, with failures yielding nullptr.
+  for (size_t i = 0; i < paths.size() - 1; i++) {
+    ASSERT_THAT(loaded_apks[i], NotNull());
+    EXPECT_THAT(loaded_apks[i]->GetPath(), StrEq(paths[i]));
+  }
+  EXPECT_THAT(loaded_apks.back(), Eq(nullptr));
+}
+
 TEST(ApkAssetsTest, LoadApkFromFd) {
   const std::string path = GetTestDataPath() + "/basic/basic.apk";
   unique_fd fd(::open(path.c_str(), O_RDONLY | O_BINARY));
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "androidfw/ArscIndex.h"
+
+#include "androidfw/LoadedArsc.h"
+#include "androidfw/ResourceUtils.h"
+
+#include "TestHelpers.h"
+#include "data/basic/R.h"
+#include "data/styles/R.h"
+
+namespace app = com::android::app;
+namespace basic = com::android::basic;
+
+using ::testing::IsNull;
+using ::testing::NotNull;
+using ::testing::StrEq;
+
+namespace android {
+
+TEST(ArscIndexTest, BuildAndLoadIndex) {
+  std::string contents;
+  ASSERT_TRUE(ReadFileFromZipToString(GetTestDataPath() + "/styles/styles.apk", "resources.arsc",
+                                      &contents));
+
+  const std::string index_data = ArscIndex::Build(StringPiece(contents));
+  ASSERT_FALSE(index_data.empty());
+
+  std::unique_ptr<const ArscIndex> index =
+      ArscIndex::Load(StringPiece(index_data), StringPiece(contents));
+  ASSERT_THAT(index, NotNull());
+}
+
+TEST(ArscIndexTest, LoadArscWithIndexFindsSameEntries) {
+  std::string contents;
+  ASSERT_TRUE(ReadFileFromZipToString(GetTestDataPath() + "/styles/styles.apk", "resources.arsc",
+                                      &contents));
+
+  const std::string index_data = ArscIndex::Build(StringPiece(contents));
+  ASSERT_FALSE(index_data.empty());
+
+  std::unique_ptr<const ArscIndex> index =
+      ArscIndex::Load(StringPiece(index_data), StringPiece(contents));
+  ASSERT_THAT(index, NotNull());
+
+  std::unique_ptr<const LoadedArsc> loaded_arsc =
+      LoadedArsc::Load(StringPiece(contents), nullptr /*loaded_idmap*/, false /*system*/,
+                       false /*load_as_shared_library*/, index.get());
+  ASSERT_THAT(loaded_arsc, NotNull());
+
+  const LoadedPackage* package =
+      loaded_arsc->GetPackageById(get_package_id(app::R::string::string_one));
+  ASSERT_THAT(package, NotNull());
+  EXPECT_THAT(package->GetPackageName(), StrEq("com.android.app"));
+
+  const uint8_t type_index = get_type_id(app::R::string::string_one) - 1;
+  const uint16_t entry_index = get_entry_id(app::R::string::string_one);
+
+  const TypeSpec* type_spec = package->GetTypeSpecByTypeIndex(type_index);
+  ASSERT_THAT(type_spec, NotNull());
+  ASSERT_THAT(LoadedPackage::GetEntry(type_spec->types[0], entry_index), NotNull());
+}
+
+TEST(ArscIndexTest, RejectIndexBuiltFromDifferentContents) {
+  std::string contents;
+  ASSERT_TRUE(ReadFileFromZipToString(GetTestDataPath() + "/styles/styles.apk", "resources.arsc",
+                                      &contents));
+
+  std::string other_contents;
+  ASSERT_TRUE(ReadFileFromZipToString(GetTestDataPath() + "/basic/basic.apk", "resources.arsc",
+                                      &other_contents));
+
+  const std::string index_data = ArscIndex::Build(StringPiece(contents));
+  ASSERT_FALSE(index_data.empty());
+
+  EXPECT_THAT(ArscIndex::Load(StringPiece(index_data), StringPiece(other_contents)), IsNull());
+}
+
+TEST(ArscIndexTest, RejectCorruptIndex) {
+  std::string contents;
+  ASSERT_TRUE(ReadFileFromZipToString(GetTestDataPath() + "/styles/styles.apk", "resources.arsc",
+                                      &contents));
+
+  std::string index_data = ArscIndex::Build(StringPiece(contents));
+  ASSERT_FALSE(index_data.empty());
+
+  // Truncating the index must not yield a usable object.
+  const std::string truncated = index_data.substr(0, index_data.size() - sizeof(uint32_t));
+  EXPECT_THAT(ArscIndex::Load(StringPiece(truncated), StringPiece(contents)), IsNull());
+
+  // Corrupting a recorded offset must be caught by validation.
+  index_data[index_data.size() - 1] = static_cast<char>(0xff);
+  EXPECT_THAT(ArscIndex::Load(StringPiece(index_data), StringPiece(contents)), IsNull());
+}
+
+}  // namespace android
@@ -524,6 +524,29 @@ TEST_F(AssetManager2Test, GetResourceLocales) {
   EXPECT_GT(locales.count("fr"), 0u);
 }
 
+TEST_F(AssetManager2Test, CachedConfigurationsAndLocalesRefreshWithApkAssets) {
+  AssetManager2 assetmanager;
+  assetmanager.SetApkAssets({system_assets_.get(), basic_de_fr_assets_.get()});
+
+  // Repeated calls are served from the cache and must agree with the first result.
+  std::set<ResTable_config> configurations = assetmanager.GetResourceConfigurations();
+  EXPECT_EQ(configurations, assetmanager.GetResourceConfigurations());
+
+  std::set<std::string> locales = assetmanager.GetResourceLocales();
+  EXPECT_EQ(locales, assetmanager.GetResourceLocales());
+  EXPECT_EQ(3u, locales.size());
+
+  // Changing the set of ApkAssets must drop the cached results.
+  assetmanager.SetApkAssets({system_assets_.get()});
+
+  locales = assetmanager.GetResourceLocales();
+  EXPECT_EQ(1u, locales.size());
+  EXPECT_GT(locales.count("sv"), 0u);
+
+  configurations = assetmanager.GetResourceConfigurations();
+  EXPECT_EQ(2u, configurations.size());
+}
+
 TEST_F(AssetManager2Test, GetResourceId) {
   AssetManager2 assetmanager;
   assetmanager.SetApkAssets({basic_assets_.get()});
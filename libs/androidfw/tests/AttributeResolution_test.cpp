@@ -100,6 +100,41 @@ TEST(AttributeResolutionLibraryTest, ApplyStyleWithDefaultStyleResId) {
   EXPECT_EQ(public_flag, values_cursor[STYLE_CHANGING_CONFIGURATIONS]);
 }
 
+TEST(AttributeResolutionLibraryTest, ApplyStyleBatchedMatchesApplyStyle) {
+  AssetManager2 assetmanager;
+  auto apk_assets = ApkAssets::LoadAsSharedLibrary(GetTestDataPath() + "/styles/styles.apk");
+  ASSERT_NE(nullptr, apk_assets);
+  assetmanager.SetApkAssets({apk_assets.get()});
+
+  std::unique_ptr<Theme> theme = assetmanager.NewTheme();
+
+  std::array<uint32_t, 2> attrs{
+      {fix_package_id(R::attr::attr_one, 0x02), fix_package_id(R::attr::attr_two, 0x02)}};
+  std::array<uint32_t, attrs.size() * STYLE_NUM_ENTRIES> expected_values;
+  std::array<uint32_t, attrs.size() + 1> expected_indices;
+  ApplyStyle(theme.get(), nullptr /*xml_parser*/, 0u /*def_style_attr*/,
+             fix_package_id(R::style::StyleOne, 0x02), attrs.data(), attrs.size(),
+             expected_values.data(), expected_indices.data());
+
+  // Applying the same style to two views in one batch must produce the same values as two
+  // individual ApplyStyle calls.
+  std::array<uint32_t, attrs.size() * STYLE_NUM_ENTRIES> values_one;
+  std::array<uint32_t, attrs.size() + 1> indices_one;
+  std::array<uint32_t, attrs.size() * STYLE_NUM_ENTRIES> values_two;
+  std::array<uint32_t, attrs.size() + 1> indices_two;
+  std::array<StyleBatchEntry, 2> batch{{
+      {nullptr /*xml_parser*/, attrs.data(), attrs.size(), values_one.data(), indices_one.data()},
+      {nullptr /*xml_parser*/, attrs.data(), attrs.size(), values_two.data(), indices_two.data()},
+  }};
+  ApplyStyleBatched(theme.get(), 0u /*def_style_attr*/,
+                    fix_package_id(R::style::StyleOne, 0x02), batch.data(), batch.size());
+
+  EXPECT_EQ(expected_values, values_one);
+  EXPECT_EQ(expected_indices, indices_one);
+  EXPECT_EQ(expected_values, values_two);
+  EXPECT_EQ(expected_indices, indices_two);
+}
+
 TEST_F(AttributeResolutionTest, Theme) {
   std::unique_ptr<Theme> theme = assetmanager_.NewTheme();
   ASSERT_TRUE(theme->ApplyStyle(R::style::StyleTwo));
@@ -17,11 +17,28 @@
 #include "BenchmarkHelpers.h"
 
 #include "android-base/stringprintf.h"
+#include "androidfw/ApkAssets.h"
 #include "androidfw/AssetManager.h"
 #include "androidfw/AssetManager2.h"
 
 namespace android {
 
+bool LoadReplicatedApkAssets(const std::vector<std::string>& paths, size_t replications,
+                             std::vector<std::unique_ptr<const ApkAssets>>* out_assets,
+                             std::vector<const ApkAssets*>* out_ptrs) {
+  for (size_t i = 0; i < replications; i++) {
+    for (const std::string& path : paths) {
+      std::unique_ptr<const ApkAssets> apk = ApkAssets::Load(path);
+      if (apk == nullptr) {
+        return false;
+      }
+      out_ptrs->push_back(apk.get());
+      out_assets->push_back(std::move(apk));
+    }
+  }
+  return true;
+}
+
 void GetResourceBenchmarkOld(const std::vector<std::string>& paths, const ResTable_config* config,
                              uint32_t resid, benchmark::State& state) {
   AssetManager assetmanager;
@@ -17,6 +17,7 @@
 #ifndef ANDROIDFW_TESTS_BENCHMARKHELPERS_H
 #define ANDROIDFW_TESTS_BENCHMARKHELPERS_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -27,12 +28,23 @@
 
 namespace android {
 
+class ApkAssets;
+
 void GetResourceBenchmarkOld(const std::vector<std::string>& paths, const ResTable_config* config,
                              uint32_t resid, ::benchmark::State& state);
 
 void GetResourceBenchmark(const std::vector<std::string>& paths, const ResTable_config* config,
                           uint32_t resid, benchmark::State& state);
 
+// Loads each path in |paths|, repeating the whole list |replications| times so an asset set
+// shaped like production (many splits and overlays carrying the same package ID) can be
+// synthesized from the small fixtures in tests/data. Every load is an independent ApkAssets
+// instance. Returns false (and leaves the out parameters in an unspecified state) if any load
+// fails.
+bool LoadReplicatedApkAssets(const std::vector<std::string>& paths, size_t replications,
+                             std::vector<std::unique_ptr<const ApkAssets>>* out_assets,
+                             std::vector<const ApkAssets*>* out_ptrs);
+
 }  // namespace android
 
 #endif  // ANDROIDFW_TESTS_BENCHMARKHELPERS_H
@@ -52,4 +52,19 @@ TEST(ByteBucketArrayTest, TestSparseInsertion) {
   }
 }
 
+TEST(ByteBucketArrayTest, TestDenseInsertion) {
+  ByteBucketArray<int> bba;
+
+  // Touch every slot so the array crosses the density threshold and collapses
+  // to contiguous storage along the way. Everything written before and after
+  // the collapse must still read back.
+  for (size_t i = 0; i < bba.size(); i++) {
+    ASSERT_TRUE(bba.set(i, static_cast<int>(i) + 1));
+  }
+
+  for (size_t i = 0; i < bba.size(); i++) {
+    EXPECT_EQ(static_cast<int>(i) + 1, bba[i]);
+  }
+}
+
 }  // namespace android
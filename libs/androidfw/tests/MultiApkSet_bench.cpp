@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "androidfw/ApkAssets.h"
+#include "androidfw/AssetManager2.h"
+#include "androidfw/ResourceTypes.h"
+
+#include "BenchmarkHelpers.h"
+#include "data/basic/R.h"
+#include "data/styles/R.h"
+
+namespace app = com::android::app;
+namespace basic = com::android::basic;
+
+namespace android {
+
+// These benchmarks approximate the asset set we see in the field — a base APK
+// plus many configuration splits and overlays sharing its package ID, and
+// themes built from long style chains — using replicated copies of the small
+// fixtures in tests/data.
+
+constexpr const static size_t kReplications = 4;  // 5 paths x 4 = 20 packages.
+
+static std::vector<std::string> MultiApkPaths() {
+  const std::string& root = GetTestDataPath();
+  return {root + "/basic/basic.apk", root + "/basic/basic_de_fr.apk",
+          root + "/basic/basic_hdpi-v4.apk", root + "/basic/basic_xhdpi-v4.apk",
+          root + "/basic/basic_xxhdpi-v4.apk"};
+}
+
+static void BM_MultiApkFindEntry(benchmark::State& state) {
+  std::vector<std::unique_ptr<const ApkAssets>> apk_assets;
+  std::vector<const ApkAssets*> apk_assets_ptrs;
+  if (!LoadReplicatedApkAssets(MultiApkPaths(), kReplications, &apk_assets, &apk_assets_ptrs)) {
+    state.SkipWithError("Failed to load assets");
+    return;
+  }
+
+  AssetManager2 assetmanager;
+  assetmanager.SetApkAssets(apk_assets_ptrs);
+
+  ResTable_config config;
+  memset(&config, 0, sizeof(config));
+  config.density = 320;
+  assetmanager.SetConfiguration(config);
+
+  Res_value value;
+  ResTable_config selected_config;
+  uint32_t flags;
+
+  while (state.KeepRunning()) {
+    ApkAssetsCookie cookie =
+        assetmanager.GetResource(basic::R::integer::number1, false /* may_be_bag */,
+                                 0u /* density_override */, &value, &selected_config, &flags);
+    benchmark::DoNotOptimize(cookie);
+    benchmark::DoNotOptimize(value);
+  }
+}
+BENCHMARK(BM_MultiApkFindEntry);
+
+static void BM_MultiApkApplyStyleDeep(benchmark::State& state) {
+  std::unique_ptr<const ApkAssets> apk = ApkAssets::Load(GetTestDataPath() + "/styles/styles.apk");
+  if (apk == nullptr) {
+    state.SkipWithError("Failed to load assets");
+    return;
+  }
+
+  AssetManager2 assets;
+  assets.SetApkAssets({apk.get()});
+
+  // Layer every style the fixture defines, plus repeats, so each iteration
+  // builds a theme as deep as the 9-level hierarchies apps ship.
+  const uint32_t styles[] = {
+      app::R::style::StyleOne,  app::R::style::StyleTwo, app::R::style::StyleThree,
+      app::R::style::StyleFour, app::R::style::StyleFive, app::R::style::StyleSix,
+      app::R::style::StyleSeven, app::R::style::StyleTwo, app::R::style::StyleThree,
+  };
+
+  while (state.KeepRunning()) {
+    auto theme = assets.NewTheme();
+    for (const uint32_t style : styles) {
+      theme->ApplyStyle(style, false /* force */);
+    }
+  }
+}
+BENCHMARK(BM_MultiApkApplyStyleDeep);
+
+static void BM_MultiApkSetConfiguration(benchmark::State& state) {
+  std::vector<std::unique_ptr<const ApkAssets>> apk_assets;
+  std::vector<const ApkAssets*> apk_assets_ptrs;
+  if (!LoadReplicatedApkAssets(MultiApkPaths(), kReplications, &apk_assets, &apk_assets_ptrs)) {
+    state.SkipWithError("Failed to load assets");
+    return;
+  }
+
+  AssetManager2 assetmanager;
+  assetmanager.SetApkAssets(apk_assets_ptrs);
+
+  ResTable_config configs[2];
+  memset(&configs, 0, sizeof(configs));
+  memcpy(configs[0].language, "fr", 2);
+  configs[0].density = 240;
+  memcpy(configs[1].language, "de", 2);
+  configs[1].density = 480;
+
+  // Alternate between two configurations so every iteration pays the full
+  // cache-invalidation and filter-rebuild cost across all packages.
+  size_t i = 0;
+  while (state.KeepRunning()) {
+    assetmanager.SetConfiguration(configs[i++ & 1u]);
+  }
+}
+BENCHMARK(BM_MultiApkSetConfiguration);
+
+}  // namespace android
@@ -97,4 +97,30 @@ TEST_F(ObbFileTest, WriteThenRead) {
             << "salts should be the same";
 }
 
+TEST_F(ObbFileTest, RereadAfterRewrite) {
+    mObbFile->setPackageName(String8("com.example.obbfile"));
+    mObbFile->setVersion(1);
+
+    EXPECT_TRUE(mObbFile->writeTo(mFileName.string()))
+            << "couldn't write to fake .obb file";
+
+    mObbFile = new ObbFile();
+    EXPECT_TRUE(mObbFile->readFrom(mFileName.string()))
+            << "couldn't read from fake .obb file";
+    EXPECT_EQ(1, mObbFile->getVersion())
+            << "version should match the first write";
+
+    // Rewrite with a new version; a second read must not return the
+    // previously parsed footer.
+    mObbFile->setVersion(2);
+    EXPECT_TRUE(mObbFile->writeTo(mFileName.string()))
+            << "couldn't rewrite fake .obb file";
+
+    mObbFile = new ObbFile();
+    EXPECT_TRUE(mObbFile->readFrom(mFileName.string()))
+            << "couldn't re-read fake .obb file";
+    EXPECT_EQ(2, mObbFile->getVersion())
+            << "version should match the rewrite";
+}
+
 }
@@ -130,6 +130,38 @@ TEST_F(ThemeTest, SingleThemeWithParent) {
   EXPECT_EQ(static_cast<uint32_t>(ResTable_typeSpec::SPEC_PUBLIC), flags);
 }
 
+TEST_F(ThemeTest, RepeatedStyleChainServedFromCache) {
+  AssetManager2 assetmanager;
+  assetmanager.SetApkAssets({style_assets_.get()});
+
+  // The first theme flattens the chain and seeds the cache.
+  std::unique_ptr<Theme> first_theme = assetmanager.NewTheme();
+  ASSERT_TRUE(first_theme->ApplyStyle(app::R::style::StyleOne));
+  ASSERT_TRUE(first_theme->ApplyStyle(app::R::style::StyleTwo));
+
+  // The second theme applies the same chain and must resolve attributes identically.
+  std::unique_ptr<Theme> second_theme = assetmanager.NewTheme();
+  ASSERT_TRUE(second_theme->ApplyStyle(app::R::style::StyleOne));
+  ASSERT_TRUE(second_theme->ApplyStyle(app::R::style::StyleTwo));
+
+  Res_value value;
+  uint32_t flags;
+  ApkAssetsCookie cookie;
+
+  cookie = second_theme->GetAttribute(app::R::attr::attr_one, &value, &flags);
+  ASSERT_NE(kInvalidCookie, cookie);
+  EXPECT_EQ(Res_value::TYPE_INT_DEC, value.dataType);
+  EXPECT_EQ(1u, value.data);
+
+  cookie = second_theme->GetAttribute(app::R::attr::attr_three, &value, &flags);
+  ASSERT_NE(kInvalidCookie, cookie);
+  EXPECT_EQ(Res_value::TYPE_INT_DEC, value.dataType);
+  EXPECT_EQ(3u, value.data);
+
+  EXPECT_EQ(first_theme->GetChangingConfigurations(),
+            second_theme->GetChangingConfigurations());
+}
+
 TEST_F(ThemeTest, TryToUseBadResourceId) {
   AssetManager2 assetmanager;
   assetmanager.SetApkAssets({style_assets_.get()});
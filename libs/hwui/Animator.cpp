@@ -262,6 +262,34 @@ bool BaseRenderNodeAnimator::animate(AnimationContext& context) {
     return finished;
 }
 
+bool BaseRenderNodeAnimator::tryBatchProgress(AnimationContext& context, float* outFraction) {
+    if (mPlayState != PlayState::Running && mPlayState != PlayState::Reversing) {
+        return false;
+    }
+    nsecs_t playTime = context.frameTimeMs() - mStartTime;
+    if (playTime < 0 || mDuration <= 0) {
+        // Delayed starts and degenerate durations keep the scalar path.
+        return false;
+    }
+    mPlayTime = mPlayState == PlayState::Reversing ? mDuration - playTime : playTime;
+    onPlayTimeChanged(mPlayTime);
+    *outFraction = MathUtils::clamp(mPlayTime / (float)mDuration, 0.0f, 1.0f);
+    return true;
+}
+
+bool BaseRenderNodeAnimator::applyBatchFraction(AnimationContext& context, float fraction) {
+    setValue(mTarget, mFromValue + (mDeltaValue * fraction));
+    // Reconstruct the raw play time that tryBatchProgress() folded into
+    // mPlayTime so the finish check matches updatePlayTime().
+    nsecs_t playTime = mPlayState == PlayState::Reversing ? mDuration - mPlayTime : mPlayTime;
+    bool finished = playTime >= mDuration;
+    if (finished && mPlayState != PlayState::Finished) {
+        mPlayState = PlayState::Finished;
+        callOnFinishedListener(context);
+    }
+    return finished;
+}
+
 bool BaseRenderNodeAnimator::updatePlayTime(nsecs_t playTime) {
     mPlayTime = mPlayState == PlayState::Reversing ? mDuration - playTime : playTime;
     onPlayTimeChanged(mPlayTime);
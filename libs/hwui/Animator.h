@@ -80,6 +80,18 @@ public:
     ANDROID_API void pushStaging(AnimationContext& context);
     ANDROID_API bool animate(AnimationContext& context);
 
+    // Support for AnimatorManager's batched evaluation. tryBatchProgress()
+    // advances the play time and reports the raw (un-interpolated) progress
+    // fraction when the animator is in the plain running state; animators
+    // that need the full animate() path (not yet started, still delayed,
+    // finished with a pending action, or degenerate duration) return false.
+    bool tryBatchProgress(AnimationContext& context, float* outFraction);
+    // Applies an interpolated fraction produced from tryBatchProgress() and
+    // handles the finish transition. Returns true when the animator is done,
+    // mirroring animate().
+    bool applyBatchFraction(AnimationContext& context, float fraction);
+    Interpolator* interpolator() { return mInterpolator.get(); }
+
     // Returns the remaining time in ms for the animation. Note this should only be called during
     // an animation on RenderThread.
     ANDROID_API nsecs_t getRemainingPlayTime();
@@ -20,7 +20,9 @@
 #include "AnimationContext.h"
 #include "Animator.h"
 #include "DamageAccumulator.h"
+#include "Interpolator.h"
 #include "RenderNode.h"
+#include "utils/FatVector.h"
 
 namespace android {
 namespace uirenderer {
@@ -94,12 +96,28 @@ void AnimatorManager::onAnimatorTargetChanged(BaseRenderNodeAnimator* animator)
 
 class AnimateFunctor {
 public:
-    AnimateFunctor(TreeInfo& info, AnimationContext& context, uint32_t* outDirtyMask)
-            : mInfo(info), mContext(context), mDirtyMask(outDirtyMask) {}
+    AnimateFunctor(TreeInfo& info, AnimationContext& context, uint32_t* outDirtyMask,
+                   BaseRenderNodeAnimator* const* batch, const float* batchFractions,
+                   size_t batchCount, size_t* batchIndex)
+            : mInfo(info)
+            , mContext(context)
+            , mDirtyMask(outDirtyMask)
+            , mBatch(batch)
+            , mBatchFractions(batchFractions)
+            , mBatchCount(batchCount)
+            , mBatchIndex(batchIndex) {}
 
     bool operator()(sp<BaseRenderNodeAnimator>& animator) {
         *mDirtyMask |= animator->dirtyMask();
-        bool remove = animator->animate(mContext);
+        bool remove;
+        // Animators visit in the same order the batch was gathered in, so a
+        // simple cursor pairs each animator with its interpolated fraction.
+        if (*mBatchIndex < mBatchCount && mBatch[*mBatchIndex] == animator.get()) {
+            remove = animator->applyBatchFraction(mContext, mBatchFractions[*mBatchIndex]);
+            (*mBatchIndex)++;
+        } else {
+            remove = animator->animate(mContext);
+        }
         if (remove) {
             animator->detach();
         } else {
@@ -117,6 +135,10 @@ private:
     TreeInfo& mInfo;
     AnimationContext& mContext;
     uint32_t* mDirtyMask;
+    BaseRenderNodeAnimator* const* mBatch;
+    const float* mBatchFractions;
+    size_t mBatchCount;
+    size_t* mBatchIndex;
 };
 
 uint32_t AnimatorManager::animate(TreeInfo& info) {
@@ -142,7 +164,37 @@ void AnimatorManager::animateNoDamage(TreeInfo& info) {
 
 uint32_t AnimatorManager::animateCommon(TreeInfo& info) {
     uint32_t dirtyMask = 0;
-    AnimateFunctor functor(info, mAnimationHandle->context(), &dirtyMask);
+    AnimationContext& context = mAnimationHandle->context();
+
+    // Gather the raw progress of every animator in the plain running state
+    // into one array so interpolation can run over the whole batch; anything
+    // with pending state work falls through to the scalar animate() path.
+    FatVector<BaseRenderNodeAnimator*, 16> batch;
+    FatVector<float, 16> fractions;
+    for (auto& animator : mAnimators) {
+        float fraction;
+        if (animator->tryBatchProgress(context, &fraction)) {
+            batch.push_back(animator.get());
+            fractions.push_back(fraction);
+        }
+    }
+
+    // Interpolate runs of animators that share an interpolator instance with
+    // a single batched call; singleton runs degrade to one virtual call each,
+    // which is no worse than the scalar path.
+    for (size_t i = 0; i < batch.size();) {
+        size_t runEnd = i + 1;
+        Interpolator* interpolator = batch[i]->interpolator();
+        while (runEnd < batch.size() && batch[runEnd]->interpolator() == interpolator) {
+            runEnd++;
+        }
+        interpolator->interpolate(&fractions[i], &fractions[i], runEnd - i);
+        i = runEnd;
+    }
+
+    size_t batchIndex = 0;
+    AnimateFunctor functor(info, context, &dirtyMask, batch.data(), fractions.data(), batch.size(),
+                           &batchIndex);
     auto newEnd = std::remove_if(mAnimators.begin(), mAnimators.end(), functor);
     mAnimators.erase(newEnd, mAnimators.end());
     mAnimationHandle->notifyAnimationsRan();
@@ -18,6 +18,8 @@
 
 #include <log/log.h>
 
+#include <limits>
+
 #include "RenderNode.h"
 #include "utils/MathUtils.h"
 
@@ -112,7 +114,7 @@ void DamageAccumulator::popTransform() {
             applyMatrix4Transform(dirtyFrame);
             break;
         case TransformNone:
-            mHead->pendingDirty.join(dirtyFrame->pendingDirty);
+            joinToHead(dirtyFrame->pendingDirty);
             break;
         default:
             LOG_ALWAYS_FATAL("Tried to pop an invalid type: %d", dirtyFrame->type);
@@ -134,7 +136,9 @@ static inline void mapRect(const Matrix4* matrix, const SkRect& in, SkRect* out)
 }
 
 void DamageAccumulator::applyMatrix4Transform(DirtyStack* frame) {
-    mapRect(frame->matrix4, frame->pendingDirty, &mHead->pendingDirty);
+    SkRect mapped = SkRect::MakeEmpty();
+    mapRect(frame->matrix4, frame->pendingDirty, &mapped);
+    joinToHead(mapped);
 }
 
 static inline void mapRect(const RenderProperties& props, const SkRect& in, SkRect* out) {
@@ -207,7 +211,9 @@ void DamageAccumulator::applyRenderNodeTransform(DirtyStack* frame) {
     }
 
     // apply all transforms
-    mapRect(props, frame->pendingDirty, &mHead->pendingDirty);
+    SkRect mapped = SkRect::MakeEmpty();
+    mapRect(props, frame->pendingDirty, &mapped);
+    joinToHead(mapped);
 
     // project backwards if necessary
     if (props.getProjectBackwards() && !frame->pendingDirty.isEmpty()) {
@@ -224,7 +230,50 @@ void DamageAccumulator::applyRenderNodeTransform(DirtyStack* frame) {
     }
 }
 
+void DamageAccumulator::joinToHead(const SkRect& rect) {
+    if (rect.isEmpty()) return;
+    mHead->pendingDirty.join(rect);
+    if (mHead->prev == mHead) {
+        // Damage that reaches the root frame is fully mapped; track it as a
+        // region rect in addition to the single union.
+        addToRegion(rect);
+    }
+}
+
+void DamageAccumulator::addToRegion(const SkRect& rect) {
+    // Fold into an overlapping rect first so the region stays disjoint.
+    for (int i = 0; i < mRegionRectCount; i++) {
+        if (SkRect::Intersects(mRegionRects[i], rect)) {
+            mRegionRects[i].join(rect);
+            return;
+        }
+    }
+    if (mRegionRectCount < kMaxDamageRects) {
+        mRegionRects[mRegionRectCount++] = rect;
+        return;
+    }
+    // Region is full; merge into whichever rect grows the least.
+    int bestIndex = 0;
+    float bestGrowth = std::numeric_limits<float>::max();
+    for (int i = 0; i < mRegionRectCount; i++) {
+        SkRect joined = mRegionRects[i];
+        joined.join(rect);
+        float growth = joined.width() * joined.height() -
+                       mRegionRects[i].width() * mRegionRects[i].height();
+        if (growth < bestGrowth) {
+            bestGrowth = growth;
+            bestIndex = i;
+        }
+    }
+    mRegionRects[bestIndex].join(rect);
+}
+
 void DamageAccumulator::dirty(float left, float top, float right, float bottom) {
+    if (mHead->prev == mHead) {
+        SkRect rect = SkRect::MakeLTRB(left, top, right, bottom);
+        joinToHead(rect);
+        return;
+    }
     mHead->pendingDirty.join(left, top, right, bottom);
 }
 
@@ -232,13 +281,26 @@ void DamageAccumulator::peekAtDirty(SkRect* dest) const {
     *dest = mHead->pendingDirty;
 }
 
-void DamageAccumulator::finish(SkRect* totalDirty) {
+void DamageAccumulator::finish(SkRect* totalDirty, LsaVector<SkRect>* dirtyRegion) {
     LOG_ALWAYS_FATAL_IF(mHead->prev != mHead, "Cannot finish, mismatched push/pop calls! %p vs. %p",
                         mHead->prev, mHead);
     // Root node never has a transform, so this is the fully mapped dirty rect
     *totalDirty = mHead->pendingDirty;
     totalDirty->roundOut(totalDirty);
     mHead->pendingDirty.setEmpty();
+    if (dirtyRegion) {
+        dirtyRegion->clear();
+        // A single rect carries no more information than totalDirty.
+        if (mRegionRectCount > 1) {
+            dirtyRegion->reserve(mRegionRectCount);
+            for (int i = 0; i < mRegionRectCount; i++) {
+                SkRect rect;
+                mRegionRects[i].roundOut(&rect);
+                dirtyRegion->push_back(rect);
+            }
+        }
+    }
+    mRegionRectCount = 0;
 }
 
 } /* namespace uirenderer */
@@ -22,6 +22,8 @@
 #include <SkMatrix.h>
 #include <SkRect.h>
 
+#include <vector>
+
 #include "utils/Macros.h"
 
 // Smaller than INT_MIN/INT_MAX because we offset these values
@@ -60,15 +62,30 @@ public:
 
     ANDROID_API void computeCurrentTransform(Matrix4* outMatrix) const;
 
-    void finish(SkRect* totalDirty);
+    void finish(SkRect* totalDirty) { finish(totalDirty, nullptr); }
+
+    // Same as above, but additionally reports the damage as a bounded list of
+    // disjoint-ish rects so distant updates don't have to repaint the area
+    // between them. The list is only populated when it carries more
+    // information than totalDirty, i.e. when there are at least two rects;
+    // otherwise it is left empty and totalDirty should be used alone.
+    void finish(SkRect* totalDirty, LsaVector<SkRect>* dirtyRegion);
+
+    // The maximum number of rects tracked for the damage region; further
+    // damage merges into whichever tracked rect it grows the least.
+    static constexpr int kMaxDamageRects = 4;
 
 private:
     void pushCommon();
     void applyMatrix4Transform(DirtyStack* frame);
     void applyRenderNodeTransform(DirtyStack* frame);
+    void joinToHead(const SkRect& rect);
+    void addToRegion(const SkRect& rect);
 
     LinearAllocator mAllocator;
     DirtyStack* mHead;
+    SkRect mRegionRects[kMaxDamageRects];
+    int mRegionRectCount = 0;
 };
 
 } /* namespace uirenderer */
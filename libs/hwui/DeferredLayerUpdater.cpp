@@ -83,20 +83,29 @@ void DeferredLayerUpdater::apply() {
         }
         if (mUpdateTexImage) {
             mUpdateTexImage = false;
-            sk_sp<SkImage> layerImage;
-            SkMatrix textureTransform;
-            bool queueEmpty = true;
-            // If the SurfaceTexture queue is in synchronous mode, need to discard all
-            // but latest frame. Since we can't tell which mode it is in,
-            // do this unconditionally.
-            do {
-                layerImage = mSurfaceTexture->dequeueImage(textureTransform, &queueEmpty,
-                        mRenderState);
-            } while (layerImage.get() && (!queueEmpty));
-            if (layerImage.get()) {
-                // force filtration if buffer size != layer size
-                bool forceFilter = mWidth != layerImage->width() || mHeight != layerImage->height();
-                updateLayer(forceFilter, textureTransform, layerImage);
+            // Skip the acquire attempt entirely when the producer hasn't
+            // queued a buffer since the one currently latched. A buffer
+            // queued mid-dequeue advances the generation, so the next
+            // apply() re-arms instead of missing it.
+            uint64_t frameGeneration = mSurfaceTexture->frameGeneration();
+            if (frameGeneration != mLastFrameGeneration || !mLayer->getImage()) {
+                mLastFrameGeneration = frameGeneration;
+                sk_sp<SkImage> layerImage;
+                SkMatrix textureTransform;
+                bool queueEmpty = true;
+                // If the SurfaceTexture queue is in synchronous mode, need to discard all
+                // but latest frame. Since we can't tell which mode it is in,
+                // do this unconditionally.
+                do {
+                    layerImage = mSurfaceTexture->dequeueImage(textureTransform, &queueEmpty,
+                            mRenderState);
+                } while (layerImage.get() && (!queueEmpty));
+                if (layerImage.get()) {
+                    // force filtration if buffer size != layer size
+                    bool forceFilter =
+                            mWidth != layerImage->width() || mHeight != layerImage->height();
+                    updateLayer(forceFilter, textureTransform, layerImage);
+                }
             }
         }
 
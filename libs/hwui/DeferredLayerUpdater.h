@@ -116,6 +116,9 @@ private:
     SkMatrix* mTransform;
     bool mGLContextAttached;
     bool mUpdateTexImage;
+    // Producer generation of the buffer currently latched into mLayer; lets
+    // apply() no-op when the producer hasn't advanced.
+    uint64_t mLastFrameGeneration = 0;
 
     Layer* mLayer;
 };
@@ -51,6 +51,11 @@ enum class FrameInfoIndex {
     DequeueBufferDuration,
     QueueBufferDuration,
 
+    // GPU execution time measured with timer queries. Queries resolve
+    // asynchronously, so this reports the most recently completed frame's
+    // measurement; 0 when the backend cannot measure it.
+    GpuDuration,
+
     // Must be the last value!
     // Also must be kept in sync with FrameMetrics.java#FRAME_STATS_COUNT
     NumIndexes
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FrameMetricsRingObserver.h"
+
+#include <log/log.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace android {
+namespace uirenderer {
+
+FrameMetricsRingObserver::FrameMetricsRingObserver(size_t ringSize, size_t batchSize)
+        : mRingSize(ringSize > 0 ? ringSize : 1)
+        , mBatchSize(batchSize > 0 ? batchSize : 1)
+        , mRing(new FrameRecord[mRingSize]) {
+    // Semaphore semantics let the consumer decrement one batch per read
+    // instead of clearing every outstanding signal at once.
+    mEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    LOG_ALWAYS_FATAL_IF(mEventFd < 0, "Unable to create frame metrics eventfd: %s",
+                        strerror(errno));
+}
+
+FrameMetricsRingObserver::~FrameMetricsRingObserver() {
+    if (mEventFd >= 0) {
+        close(mEventFd);
+    }
+}
+
+void FrameMetricsRingObserver::notify(const int64_t* stats) {
+    FrameRecord& record = mRing[mNextFree];
+
+    if (!record.hasData.load(std::memory_order_acquire)) {
+        memcpy(record.buffer, stats, kBufferSize * sizeof(stats[0]));
+        record.dropCount = mDroppedReports;
+        mDroppedReports = 0;
+
+        mNextFree = (mNextFree + 1) % mRingSize;
+        record.hasData.store(true, std::memory_order_release);
+
+        if (++mPendingInBatch >= mBatchSize) {
+            mPendingInBatch = 0;
+            if (TEMP_FAILURE_RETRY(eventfd_write(mEventFd, 1)) < 0) {
+                ALOGW("Unable to signal frame metrics batch: %s", strerror(errno));
+            }
+        }
+    } else {
+        // Consumer has fallen behind; account for the lost frame so the next
+        // delivered record carries an accurate drop count.
+        mDroppedReports++;
+    }
+}
+
+bool FrameMetricsRingObserver::nextFrame(int64_t* buffer, int* outDropCount) {
+    FrameRecord& record = mRing[mNextToRead];
+
+    if (!record.hasData.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    memcpy(buffer, record.buffer, kBufferSize * sizeof(buffer[0]));
+    *outDropCount = record.dropCount;
+    mNextToRead = (mNextToRead + 1) % mRingSize;
+    record.hasData.store(false, std::memory_order_release);
+    return true;
+}
+
+}  // namespace uirenderer
+}  // namespace android
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "FrameInfo.h"
+#include "FrameMetricsObserver.h"
+
+#include <atomic>
+#include <memory>
+
+namespace android {
+namespace uirenderer {
+
+/**
+ * A FrameMetricsObserver that buffers frame records in a preallocated ring
+ * instead of posting a wakeup per frame.
+ *
+ * The RenderThread copies each frame's timing buffer into the next free slot
+ * and only signals the observer's eventfd once batchSize records have
+ * accumulated, so a consumer that samples every session pays one wakeup per
+ * batch rather than one per frame. The consumer polls fd() from any thread
+ * and drains completed records with nextFrame(); records that arrive while
+ * the ring is full are counted and reported as drops alongside the next
+ * successful record, matching the JNI observer's behavior.
+ *
+ * Single producer (RenderThread), single consumer.
+ */
+class FrameMetricsRingObserver : public FrameMetricsObserver {
+public:
+    FrameMetricsRingObserver(size_t ringSize, size_t batchSize);
+    virtual ~FrameMetricsRingObserver();
+
+    // Eventfd signalled once per completed batch. Owned by the observer.
+    int fd() const { return mEventFd; }
+
+    // Copies the oldest undrained frame record into buffer, which must hold
+    // FrameInfoIndex::NumIndexes int64_t values. Returns false when the ring
+    // is empty. outDropCount receives the number of frames dropped between
+    // the previous record and this one.
+    bool nextFrame(int64_t* buffer, int* outDropCount);
+
+    // FrameMetricsObserver, called on the RenderThread.
+    void notify(const int64_t* stats) override;
+
+private:
+    static constexpr size_t kBufferSize = static_cast<size_t>(FrameInfoIndex::NumIndexes);
+
+    struct FrameRecord {
+        std::atomic_bool hasData{false};
+        int dropCount = 0;
+        int64_t buffer[kBufferSize];
+    };
+
+    const size_t mRingSize;
+    const size_t mBatchSize;
+    std::unique_ptr<FrameRecord[]> mRing;
+
+    // Producer state, RenderThread only.
+    size_t mNextFree = 0;
+    size_t mPendingInBatch = 0;
+    int mDroppedReports = 0;
+
+    // Consumer state, reader thread only.
+    size_t mNextToRead = 0;
+
+    int mEventFd = -1;
+};
+
+}  // namespace uirenderer
+}  // namespace android
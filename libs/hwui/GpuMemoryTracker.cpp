@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include "utils/RingBuffer.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 #include <GpuMemoryTracker.h>
 #include <cutils/compiler.h>
@@ -43,6 +45,12 @@ struct TypeStats {
 static std::array<TypeStats, NUM_TYPES> gObjectStats;
 static std::unordered_set<GpuMemoryTracker*> gObjectSet;
 
+// 32 snapshots taken every 30 seconds cover the most recent ~16 minutes of a
+// long-running session; capturing one is a few dozen integer copies.
+static constexpr nsecs_t SNAPSHOT_INTERVAL = 30_s;
+static RingBuffer<GpuMemoryTracker::Snapshot, 32> gSnapshots;
+static nsecs_t gLastSnapshotTime = 0;
+
 void GpuMemoryTracker::notifySizeChanged(int newSize) {
     int delta = newSize - mSize;
     mSize = newSize;
@@ -105,7 +113,67 @@ int GpuMemoryTracker::getTotalSize(GpuObjectType type) {
     return gObjectStats[static_cast<int>(type)].totalSize;
 }
 
+void GpuMemoryTracker::snapshot() {
+    Snapshot& entry = gSnapshots.next();
+    entry.when = systemTime(CLOCK_MONOTONIC);
+    for (int type = 0; type < NUM_TYPES; type++) {
+        entry.totalSize[type] = gObjectStats[type].totalSize;
+        entry.count[type] = gObjectStats[type].count;
+    }
+    gLastSnapshotTime = entry.when;
+}
+
+static void printDelta(std::ostream& stream, int sizeDelta, int countDelta) {
+    stream << (sizeDelta < 0 ? "-" : "+") << SizePrinter{sizeDelta < 0 ? -sizeDelta : sizeDelta}
+           << "/"
+           << (countDelta < 0 ? "" : "+") << countDelta;
+}
+
+void GpuMemoryTracker::dumpSnapshots(std::ostream& stream) {
+    const size_t count = gSnapshots.size();
+    if (!count) {
+        stream << "No GPU memory snapshots captured" << std::endl;
+        return;
+    }
+    const nsecs_t now = systemTime(CLOCK_MONOTONIC);
+    stream << "GPU memory snapshots, oldest first:" << std::endl;
+    for (size_t i = 0; i < count; i++) {
+        const Snapshot& snapshot = gSnapshots[i];
+        stream << "  [" << ns2s(snapshot.when - now) << "s]";
+        for (int type = 0; type < NUM_TYPES; type++) {
+            stream << " " << TYPE_NAMES[type] << " " << SizePrinter{snapshot.totalSize[type]}
+                   << " (" << snapshot.count[type] << ")";
+            if (i > 0) {
+                const Snapshot& prev = gSnapshots[i - 1];
+                int sizeDelta = snapshot.totalSize[type] - prev.totalSize[type];
+                int countDelta = snapshot.count[type] - prev.count[type];
+                if (sizeDelta || countDelta) {
+                    stream << " [";
+                    printDelta(stream, sizeDelta, countDelta);
+                    stream << "]";
+                }
+            }
+        }
+        stream << std::endl;
+    }
+    if (count > 1) {
+        const Snapshot& first = gSnapshots[0];
+        const Snapshot& last = gSnapshots[count - 1];
+        stream << "  net over " << ns2s(last.when - first.when) << "s:";
+        for (int type = 0; type < NUM_TYPES; type++) {
+            stream << " " << TYPE_NAMES[type] << " ";
+            printDelta(stream, last.totalSize[type] - first.totalSize[type],
+                       last.count[type] - first.count[type]);
+        }
+        stream << std::endl;
+    }
+}
+
 void GpuMemoryTracker::onFrameCompleted() {
+    nsecs_t now = systemTime(CLOCK_MONOTONIC);
+    if (now - gLastSnapshotTime >= SNAPSHOT_INTERVAL) {
+        snapshot();
+    }
     if (ATRACE_ENABLED()) {
         char buf[128];
         for (int type = 0; type < NUM_TYPES; type++) {
@@ -19,6 +19,7 @@
 #include <ostream>
 
 #include <log/log.h>
+#include <utils/Timers.h>
 
 namespace android {
 namespace uirenderer {
@@ -44,6 +45,14 @@ public:
     GpuObjectType objectType() { return mType; }
     int objectSize() { return mSize; }
 
+    // A compact capture of the per-type totals at one point in time, kept in
+    // a small ring so growth can be located in time instead of bisected.
+    struct Snapshot {
+        nsecs_t when = 0;
+        int totalSize[static_cast<int>(GpuObjectType::TypeCount)] = {};
+        int count[static_cast<int>(GpuObjectType::TypeCount)] = {};
+    };
+
     static void onGpuContextCreated();
     static void onGpuContextDestroyed();
     static void dump();
@@ -52,6 +61,13 @@ public:
     static int getTotalSize(GpuObjectType type);
     static void onFrameCompleted();
 
+    // Records the current totals into the snapshot ring. Called periodically
+    // from onFrameCompleted; may also be called directly (e.g. from tests).
+    static void snapshot();
+    // Writes the snapshot ring to the stream, oldest first, with each entry
+    // diffed against the one before it and a net-change summary at the end.
+    static void dumpSnapshots(std::ostream& stream);
+
 protected:
     explicit GpuMemoryTracker(GpuObjectType type) : mType(type) {
         ASSERT_GPU_THREAD();
@@ -29,10 +29,13 @@
 #include <GrContext.h>
 #include <SkCanvas.h>
 #include <SkImage.h>
+#include <SkPixelRef.h>
 #include <utils/GLUtils.h>
 #include <utils/Trace.h>
 #include <utils/TraceUtils.h>
+#include <memory>
 #include <thread>
+#include <vector>
 
 namespace android::uirenderer {
 
@@ -49,6 +52,14 @@ struct FormatInfo {
     bool valid = true;
 };
 
+// A source bitmap that has been made hardware compatible and paired with its
+// destination GraphicBuffer, ready to be handed to the upload thread.
+struct PendingUpload {
+    SkBitmap bitmap;
+    FormatInfo format;
+    sp<GraphicBuffer> buffer;
+};
+
 class AHBUploader : public RefBase {
 public:
     virtual ~AHBUploader() {}
@@ -79,6 +90,14 @@ public:
         return result;
     }
 
+    bool uploadHardwareBitmaps(const std::vector<PendingUpload>& uploads) {
+        ATRACE_CALL();
+        beginUpload();
+        bool result = onUploadHardwareBitmaps(uploads);
+        endUpload();
+        return result;
+    }
+
     void postIdleTimeoutCheck() {
         mUploadThread->queue().postDelayed(5000_ms, [this](){ this->idleTimeoutCheck(); });
     }
@@ -94,6 +113,16 @@ private:
 
     virtual bool onUploadHardwareBitmap(const SkBitmap& bitmap, const FormatInfo& format,
                                         sp<GraphicBuffer> graphicBuffer) = 0;
+    // Uploads the whole batch in one pass. The default implementation loops
+    // over the single-bitmap hook for backends with no per-upload fence to
+    // amortize (Vulkan uploads through Skia synchronously).
+    virtual bool onUploadHardwareBitmaps(const std::vector<PendingUpload>& uploads) {
+        bool result = true;
+        for (const PendingUpload& upload : uploads) {
+            result &= onUploadHardwareBitmap(upload.bitmap, upload.format, upload.buffer);
+        }
+        return result;
+    }
     virtual void onBeginUpload() = 0;
 
     bool shouldTimeOutLocked() {
@@ -214,6 +243,62 @@ private:
         return true;
     }
 
+    bool onUploadHardwareBitmaps(const std::vector<PendingUpload>& uploads) override {
+        ATRACE_CALL();
+
+        EGLDisplay display = getUploadEglDisplay();
+
+        LOG_ALWAYS_FATAL_IF(display == EGL_NO_DISPLAY, "Failed to get EGL_DEFAULT_DISPLAY! err=%s",
+                            uirenderer::renderthread::EglManager::eglErrorString());
+        // Create all the EGL images up front; a failure drops the batch just
+        // like a failed single upload.
+        std::vector<std::unique_ptr<AutoEglImage>> images;
+        images.reserve(uploads.size());
+        for (const PendingUpload& upload : uploads) {
+            EGLClientBuffer clientBuffer = (EGLClientBuffer)upload.buffer->getNativeBuffer();
+            auto image = std::make_unique<AutoEglImage>(display, clientBuffer);
+            if (image->image == EGL_NO_IMAGE_KHR) {
+                ALOGW("Could not create EGL image, err =%s",
+                      uirenderer::renderthread::EglManager::eglErrorString());
+                return false;
+            }
+            images.push_back(std::move(image));
+        }
+
+        {
+            ATRACE_FORMAT("CPU -> gralloc batch transfer (%zu bitmaps)", uploads.size());
+            // A single thread hop covers every texture in the batch, and one
+            // fence at the tail covers all of them.
+            EGLSyncKHR fence = mUploadThread->queue().runSync([&]() -> EGLSyncKHR {
+                for (size_t i = 0; i < uploads.size(); i++) {
+                    const SkBitmap& bitmap = uploads[i].bitmap;
+                    AutoSkiaGlTexture glTexture;
+                    glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, images[i]->image);
+                    GL_CHECKPOINT(MODERATE);
+
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, bitmap.width(), bitmap.height(),
+                                    uploads[i].format.format, uploads[i].format.type,
+                                    bitmap.getPixels());
+                    GL_CHECKPOINT(MODERATE);
+                }
+
+                EGLSyncKHR uploadFence =
+                        eglCreateSyncKHR(eglGetCurrentDisplay(), EGL_SYNC_FENCE_KHR, NULL);
+                LOG_ALWAYS_FATAL_IF(uploadFence == EGL_NO_SYNC_KHR,
+                                    "Could not create sync fence %#x", eglGetError());
+                glFlush();
+                return uploadFence;
+            });
+
+            EGLint waitStatus = eglClientWaitSyncKHR(display, fence, 0, FENCE_TIMEOUT);
+            LOG_ALWAYS_FATAL_IF(waitStatus != EGL_CONDITION_SATISFIED_KHR,
+                                "Failed to wait for the fence %#x", eglGetError());
+
+            eglDestroySyncKHR(display, fence);
+        }
+        return true;
+    }
+
     renderthread::EglManager mEglManager;
 };
 
@@ -343,13 +428,46 @@ static FormatInfo determineFormat(const SkBitmap& skBitmap, bool usingGL) {
     return formatInfo;
 }
 
+// Staging bitmaps used for converting unsupported source formats are pooled
+// for reuse; batches of thumbnails hit this path with identical dimensions,
+// so the allocation is almost always recyclable.
+static std::mutex sStagingLock;
+static std::vector<SkBitmap> sStagingPool;
+static constexpr size_t kMaxPooledStagingBitmaps = 4;
+
+static SkBitmap obtainStagingBitmap(const SkImageInfo& info) {
+    {
+        std::lock_guard _lock{sStagingLock};
+        for (auto it = sStagingPool.begin(); it != sStagingPool.end(); ++it) {
+            if (it->info() == info) {
+                SkBitmap bitmap = *it;
+                sStagingPool.erase(it);
+                return bitmap;
+            }
+        }
+    }
+    SkBitmap bitmap;
+    bitmap.allocPixels(info);
+    return bitmap;
+}
+
+static void recycleStagingBitmap(SkBitmap bitmap) {
+    // Only recycle allocations we own exclusively; supported formats upload
+    // the caller's bitmap directly and must not end up in the pool.
+    if (!bitmap.pixelRef() || !bitmap.pixelRef()->unique()) {
+        return;
+    }
+    std::lock_guard _lock{sStagingLock};
+    if (sStagingPool.size() < kMaxPooledStagingBitmaps) {
+        sStagingPool.push_back(std::move(bitmap));
+    }
+}
+
 static SkBitmap makeHwCompatible(const FormatInfo& format, const SkBitmap& source) {
     if (format.isSupported) {
         return source;
     } else {
-        SkBitmap bitmap;
-        const SkImageInfo& info = source.info();
-        bitmap.allocPixels(info.makeColorType(kN32_SkColorType));
+        SkBitmap bitmap = obtainStagingBitmap(source.info().makeColorType(kN32_SkColorType));
 
         SkCanvas canvas(bitmap);
         canvas.drawColor(0);
@@ -372,15 +490,10 @@ static void createUploader(bool usingGL) {
     }
 }
 
-sk_sp<Bitmap> HardwareBitmapUploader::allocateHardwareBitmap(const SkBitmap& sourceBitmap) {
-    ATRACE_CALL();
-
-    bool usingGL = uirenderer::Properties::getRenderPipelineType() ==
-            uirenderer::RenderPipelineType::SkiaGL;
-
+static bool prepareUpload(const SkBitmap& sourceBitmap, bool usingGL, PendingUpload* outUpload) {
     FormatInfo format = determineFormat(sourceBitmap, usingGL);
     if (!format.valid) {
-        return nullptr;
+        return false;
     }
 
     SkBitmap bitmap = makeHwCompatible(format, sourceBitmap);
@@ -395,16 +508,80 @@ sk_sp<Bitmap> HardwareBitmapUploader::allocateHardwareBitmap(const SkBitmap& sou
     status_t error = buffer->initCheck();
     if (error < 0) {
         ALOGW("createGraphicBuffer() failed in GraphicBuffer.create()");
+        recycleStagingBitmap(std::move(bitmap));
+        return false;
+    }
+
+    outUpload->bitmap = std::move(bitmap);
+    outUpload->format = format;
+    outUpload->buffer = std::move(buffer);
+    return true;
+}
+
+sk_sp<Bitmap> HardwareBitmapUploader::allocateHardwareBitmap(const SkBitmap& sourceBitmap) {
+    ATRACE_CALL();
+
+    bool usingGL = uirenderer::Properties::getRenderPipelineType() ==
+            uirenderer::RenderPipelineType::SkiaGL;
+
+    PendingUpload upload;
+    if (!prepareUpload(sourceBitmap, usingGL, &upload)) {
         return nullptr;
     }
 
     createUploader(usingGL);
 
-    if (!sUploader->uploadHardwareBitmap(bitmap, format, buffer)) {
-        return nullptr;
+    sk_sp<Bitmap> result;
+    if (sUploader->uploadHardwareBitmap(upload.bitmap, upload.format, upload.buffer)) {
+        result = Bitmap::createFrom(upload.buffer, upload.bitmap.colorType(),
+                                    upload.bitmap.refColorSpace(), upload.bitmap.alphaType(),
+                                    Bitmap::computePalette(upload.bitmap));
+    }
+    recycleStagingBitmap(std::move(upload.bitmap));
+    return result;
+}
+
+std::vector<sk_sp<Bitmap>> HardwareBitmapUploader::allocateHardwareBitmaps(
+        const std::vector<SkBitmap>& sourceBitmaps) {
+    ATRACE_CALL();
+
+    std::vector<sk_sp<Bitmap>> results(sourceBitmaps.size());
+    if (sourceBitmaps.empty()) {
+        return results;
+    }
+
+    bool usingGL = uirenderer::Properties::getRenderPipelineType() ==
+            uirenderer::RenderPipelineType::SkiaGL;
+
+    std::vector<PendingUpload> uploads;
+    std::vector<size_t> resultSlots;
+    uploads.reserve(sourceBitmaps.size());
+    resultSlots.reserve(sourceBitmaps.size());
+    for (size_t i = 0; i < sourceBitmaps.size(); i++) {
+        PendingUpload upload;
+        if (prepareUpload(sourceBitmaps[i], usingGL, &upload)) {
+            uploads.push_back(std::move(upload));
+            resultSlots.push_back(i);
+        }
+    }
+    if (uploads.empty()) {
+        return results;
+    }
+
+    createUploader(usingGL);
+
+    if (sUploader->uploadHardwareBitmaps(uploads)) {
+        for (size_t i = 0; i < uploads.size(); i++) {
+            const PendingUpload& upload = uploads[i];
+            results[resultSlots[i]] = Bitmap::createFrom(
+                    upload.buffer, upload.bitmap.colorType(), upload.bitmap.refColorSpace(),
+                    upload.bitmap.alphaType(), Bitmap::computePalette(upload.bitmap));
+        }
+    }
+    for (PendingUpload& upload : uploads) {
+        recycleStagingBitmap(std::move(upload.bitmap));
     }
-    return Bitmap::createFrom(buffer, bitmap.colorType(), bitmap.refColorSpace(),
-                              bitmap.alphaType(), Bitmap::computePalette(bitmap));
+    return results;
 }
 
 void HardwareBitmapUploader::initialize() {
@@ -418,6 +595,8 @@ void HardwareBitmapUploader::terminate() {
     if (sUploader) {
         sUploader->destroy();
     }
+    std::lock_guard _lock{sStagingLock};
+    sStagingPool.clear();
 }
 
 }  // namespace android::uirenderer
@@ -18,6 +18,8 @@
 
 #include <hwui/Bitmap.h>
 
+#include <vector>
+
 namespace android::uirenderer {
 
 class ANDROID_API HardwareBitmapUploader {
@@ -27,6 +29,14 @@ public:
 
     static sk_sp<Bitmap> allocateHardwareBitmap(const SkBitmap& sourceBitmap);
 
+    /**
+     * Uploads several bitmaps in one upload-thread pass behind a single fence,
+     * which amortizes the per-bitmap thread hop and fence wait. The result
+     * vector parallels the input; entries that failed to upload are null.
+     */
+    static std::vector<sk_sp<Bitmap>> allocateHardwareBitmaps(
+            const std::vector<SkBitmap>& sourceBitmaps);
+
     static bool hasFP16Support();
 };
 
@@ -29,10 +29,23 @@ Interpolator* Interpolator::createDefaultInterpolator() {
     return new AccelerateDecelerateInterpolator();
 }
 
+void Interpolator::interpolate(const float* fractions, float* out, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = interpolate(fractions[i]);
+    }
+}
+
 float AccelerateDecelerateInterpolator::interpolate(float input) {
     return (float)(cosf((input + 1) * M_PI) / 2.0f) + 0.5f;
 }
 
+void AccelerateDecelerateInterpolator::interpolate(const float* fractions, float* out,
+                                                   size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        out[i] = (float)(cosf((fractions[i] + 1) * M_PI) / 2.0f) + 0.5f;
+    }
+}
+
 float AccelerateInterpolator::interpolate(float input) {
     if (mFactor == 1.0f) {
         return input * input;
@@ -156,5 +169,24 @@ float LUTInterpolator::interpolate(float input) {
     return MathUtils::lerp(v1, v2, weight);
 }
 
+void LUTInterpolator::interpolate(const float* fractions, float* out, size_t count) {
+    // Batched inputs come pre-clamped to [0, 1], so the negative-index check
+    // of the scalar path is unnecessary here.
+    const float* values = mValues.get();
+    const float lastIndex = mSize - 1;
+    for (size_t i = 0; i < count; i++) {
+        float lutpos = fractions[i] * lastIndex;
+        if (lutpos >= lastIndex) {
+            out[i] = values[mSize - 1];
+            continue;
+        }
+        float ipart, weight;
+        weight = modff(lutpos, &ipart);
+        int i1 = (int)ipart;
+        int i2 = std::min(i1 + 1, (int)mSize - 1);
+        out[i] = MathUtils::lerp(values[i1], values[i2], weight);
+    }
+}
+
 } /* namespace uirenderer */
 } /* namespace android */
@@ -31,6 +31,13 @@ public:
 
     virtual float interpolate(float input) = 0;
 
+    // Evaluates a batch of fractions, writing one output per input (in and
+    // out may alias). The default implementation dispatches to the scalar
+    // interpolate() per element; table-driven and closed-form interpolators
+    // override it with a single tight loop so AnimatorManager can evaluate
+    // many animators' fractions without per-element virtual calls.
+    virtual void interpolate(const float* fractions, float* out, size_t count);
+
     static Interpolator* createDefaultInterpolator();
 
 protected:
@@ -40,6 +47,7 @@ protected:
 class ANDROID_API AccelerateDecelerateInterpolator : public Interpolator {
 public:
     virtual float interpolate(float input) override;
+    virtual void interpolate(const float* fractions, float* out, size_t count) override;
 };
 
 class ANDROID_API AccelerateInterpolator : public Interpolator {
@@ -123,6 +131,7 @@ public:
     ~LUTInterpolator();
 
     virtual float interpolate(float input) override;
+    virtual void interpolate(const float* fractions, float* out, size_t count) override;
 
 private:
     std::unique_ptr<float[]> mValues;
@@ -20,10 +20,12 @@
 #include <inttypes.h>
 #include <statslog.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <cmath>
 #include <cstdio>
+#include <cstring>
 #include <limits>
 
 #include <cutils/ashmem.h>
@@ -96,6 +98,7 @@ JankTracker::JankTracker(ProfileDataContainer* globalData, const DisplayInfo& di
         mDequeueTimeForgiveness = offsetDelta + 4_ms;
     }
     setFrameInterval(frameIntervalNanos);
+    mTelemetry = std::make_unique<TelemetryRecord[]>(kTelemetryFrames);
 }
 
 void JankTracker::setFrameInterval(nsecs_t frameInterval) {
@@ -106,7 +109,38 @@ void JankTracker::setFrameInterval(nsecs_t frameInterval) {
     }
 }
 
+void JankTracker::recordTelemetry(const FrameInfo& frame) {
+    uint32_t head = mTelemetryHead.load(std::memory_order_relaxed);
+    TelemetryRecord& record = mTelemetry[head % kTelemetryFrames];
+    memcpy(record.data, frame.data(), sizeof(record.data));
+    // Publish only after the record is fully written; a reader that observes
+    // the new head sees a complete record behind it.
+    mTelemetryHead.store(head + 1, std::memory_order_release);
+}
+
+void JankTracker::dumpTelemetry(int fd) {
+    // A versioned binary section: magic, layout version, int64s per record,
+    // record count, then records oldest-first in FrameInfoIndex order. The
+    // reader treats it as an opaque blob and decodes it offline.
+    static constexpr uint32_t kMagic = 0x31525446;  // 'FTR1'
+    static constexpr uint32_t kVersion = 1;
+    const uint32_t head = mTelemetryHead.load(std::memory_order_acquire);
+    const uint32_t count = std::min<uint32_t>(head, kTelemetryFrames);
+    const uint32_t stride = static_cast<uint32_t>(FrameInfoIndex::NumIndexes);
+    uint32_t header[4] = {kMagic, kVersion, stride, count};
+    if (write(fd, header, sizeof(header)) < 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const TelemetryRecord& record = mTelemetry[(head - count + i) % kTelemetryFrames];
+        if (write(fd, record.data, sizeof(record.data)) < 0) {
+            return;
+        }
+    }
+}
+
 void JankTracker::finishFrame(const FrameInfo& frame) {
+    recordTelemetry(frame);
     // Fast-path for jank-free frames
     int64_t totalDuration = frame.duration(sFrameStart, FrameInfoIndex::FrameCompleted);
     if (mDequeueTimeForgiveness && frame[FrameInfoIndex::DequeueBufferDuration] > 500_us) {
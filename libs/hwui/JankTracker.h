@@ -26,6 +26,7 @@
 #include <ui/DisplayInfo.h>
 
 #include <array>
+#include <atomic>
 #include <memory>
 
 namespace android {
@@ -61,6 +62,7 @@ public:
 
     void dumpStats(int fd) { dumpData(fd, &mDescription, mData.get()); }
     void dumpFrames(int fd);
+    void dumpTelemetry(int fd);
     void reset();
 
     // Exposed for FrameInfoVisualizer
@@ -90,6 +92,24 @@ private:
 
     // Ring buffer large enough for 2 seconds worth of frames
     RingBuffer<FrameInfo, 120> mFrames;
+
+    // Raw per-frame telemetry, kept separately from mFrames because the
+    // visualizer resets that ring and because telemetry needs a deeper
+    // window to reconstruct which stage overran across a whole jank episode.
+    static constexpr size_t kTelemetryFrames = 512;
+
+    struct TelemetryRecord {
+        int64_t data[static_cast<size_t>(FrameInfoIndex::NumIndexes)];
+    };
+
+    void recordTelemetry(const FrameInfo& frame);
+
+    // Single-writer (render thread) ring. The head counter is published with
+    // release ordering after each record is fully written, so a reader can
+    // copy a consistent snapshot without any lock; the slot the writer is
+    // about to overwrite is simply the oldest and gets dropped.
+    std::unique_ptr<TelemetryRecord[]> mTelemetry;
+    std::atomic<uint32_t> mTelemetryHead{0};
 };
 
 } /* namespace uirenderer */
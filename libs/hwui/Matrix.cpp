@@ -22,6 +22,10 @@
 
 #include <SkMatrix.h>
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "Matrix.h"
 
 namespace android {
@@ -375,6 +379,24 @@ void Matrix4::loadRotate(float angle, float x, float y, float z) {
 }
 
 void Matrix4::loadMultiply(const Matrix4& u, const Matrix4& v) {
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    // Each result column is u's columns combined with the weights from the
+    // matching column of v. Loading u up front also makes this safe when
+    // either operand aliases this matrix.
+    const float32x4_t u0 = vld1q_f32(u.data);
+    const float32x4_t u1 = vld1q_f32(u.data + 4);
+    const float32x4_t u2 = vld1q_f32(u.data + 8);
+    const float32x4_t u3 = vld1q_f32(u.data + 12);
+
+    for (int i = 0; i < 4; i++) {
+        const float* col = v.data + i * 4;
+        float32x4_t result = vmulq_n_f32(u0, col[0]);
+        result = vmlaq_n_f32(result, u1, col[1]);
+        result = vmlaq_n_f32(result, u2, col[2]);
+        result = vmlaq_n_f32(result, u3, col[3]);
+        vst1q_f32(data + i * 4, result);
+    }
+#else
     for (int i = 0; i < 4; i++) {
         float x = 0;
         float y = 0;
@@ -394,6 +416,7 @@ void Matrix4::loadMultiply(const Matrix4& u, const Matrix4& v) {
         set(i, 2, z);
         set(i, 3, w);
     }
+#endif
 
     mType = kTypeUnknown;
 }
@@ -509,6 +532,62 @@ void Matrix4::mapRect(Rect& r) const {
     }
 }
 
+/**
+ * Maps each rect as mapRect() would, but classifies the matrix once for the
+ * whole batch instead of per rect. Intended for callers that accumulate many
+ * rects under a single transform, such as damage tracking.
+ */
+void Matrix4::mapRects(Rect* rects, int count) const {
+    if (isIdentity()) return;
+
+    if (!isSimple()) {
+        for (int i = 0; i < count; i++) {
+            mapRect(rects[i]);
+        }
+        return;
+    }
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    // A Rect is four contiguous floats, so each one maps with a single
+    // multiply-accumulate against (sx, sy, sx, sy) and (tx, ty, tx, ty).
+    const float scales[4] = {data[kScaleX], data[kScaleY], data[kScaleX], data[kScaleY]};
+    const float translates[4] = {data[kTranslateX], data[kTranslateY], data[kTranslateX],
+                                 data[kTranslateY]};
+    const float32x4_t scale = vld1q_f32(scales);
+    const float32x4_t translate = vld1q_f32(translates);
+
+    for (int i = 0; i < count; i++) {
+        const float32x4_t ltrb = vmlaq_f32(translate, vld1q_f32(&rects[i].left), scale);
+        // A negative scale flips an edge pair; sort each pair against its
+        // rotation by two lanes, which holds the opposing edges.
+        const float32x4_t swapped = vextq_f32(ltrb, ltrb, 2);
+        const float32x4_t lo = vminq_f32(ltrb, swapped);
+        const float32x4_t hi = vmaxq_f32(ltrb, swapped);
+        vst1q_f32(&rects[i].left, vcombine_f32(vget_low_f32(lo), vget_high_f32(hi)));
+    }
+#else
+    for (int i = 0; i < count; i++) {
+        Rect& r = rects[i];
+        MUL_ADD_STORE(r.left, data[kScaleX], data[kTranslateX]);
+        MUL_ADD_STORE(r.right, data[kScaleX], data[kTranslateX]);
+        MUL_ADD_STORE(r.top, data[kScaleY], data[kTranslateY]);
+        MUL_ADD_STORE(r.bottom, data[kScaleY], data[kTranslateY]);
+
+        if (r.left > r.right) {
+            float x = r.left;
+            r.left = r.right;
+            r.right = x;
+        }
+
+        if (r.top > r.bottom) {
+            float y = r.top;
+            r.top = r.bottom;
+            r.bottom = y;
+        }
+    }
+#endif
+}
+
 void Matrix4::decomposeScale(float& sx, float& sy) const {
     float len;
     len = data[mat4::kScaleX] * data[mat4::kScaleX] + data[mat4::kSkewX] * data[mat4::kSkewX];
@@ -200,6 +200,7 @@ public:
     void mapPoint3d(Vector3& vec) const;
     void mapPoint(float& x, float& y) const;  // 2d only
     void mapRect(Rect& r) const;              // 2d only
+    void mapRects(Rect* rects, int count) const;  // 2d only
 
     float getTranslateX() const;
     float getTranslateY() const;
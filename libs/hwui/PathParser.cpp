@@ -21,6 +21,8 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <utils/Log.h>
+#include <array>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -45,6 +47,32 @@ static size_t nextStart(const char* s, size_t length, size_t startIndex) {
     return index;
 }
 
+// Character classes the tokenizer cares about. A 256-entry table turns the
+// per-character switch into a single load, which matters for multi-kilobyte
+// path strings where almost every byte is a digit.
+enum CharClass : uint8_t {
+    kOther = 0,
+    kDigit,
+    kSeparator,  // ' ' or ','
+    kMinus,
+    kDot,
+    kExponent,  // 'e' or 'E'
+};
+
+static const std::array<uint8_t, 256> sCharClass = []() {
+    std::array<uint8_t, 256> table{};
+    for (char c = '0'; c <= '9'; c++) {
+        table[static_cast<uint8_t>(c)] = kDigit;
+    }
+    table[static_cast<uint8_t>(' ')] = kSeparator;
+    table[static_cast<uint8_t>(',')] = kSeparator;
+    table[static_cast<uint8_t>('-')] = kMinus;
+    table[static_cast<uint8_t>('.')] = kDot;
+    table[static_cast<uint8_t>('e')] = kExponent;
+    table[static_cast<uint8_t>('E')] = kExponent;
+    return table;
+}();
+
 /**
  * Calculate the position of the next comma or space or negative sign
  * @param s the string to search
@@ -60,23 +88,32 @@ static void extract(int* outEndPosition, bool* outEndWithNegOrDot, const char* s
     *outEndWithNegOrDot = false;
     bool secondDot = false;
     bool isExponential = false;
-    for (; currentIndex < end; currentIndex++) {
+    while (currentIndex < end) {
+        uint8_t charClass = sCharClass[static_cast<uint8_t>(s[currentIndex])];
+        if (charClass == kDigit) {
+            // Digits can never terminate a number, so burn through whole runs
+            // of them with the class table alone.
+            do {
+                currentIndex++;
+            } while (currentIndex < end &&
+                     sCharClass[static_cast<uint8_t>(s[currentIndex])] == kDigit);
+            isExponential = false;
+            continue;
+        }
         bool isPrevExponential = isExponential;
         isExponential = false;
-        char currentChar = s[currentIndex];
-        switch (currentChar) {
-            case ' ':
-            case ',':
+        switch (charClass) {
+            case kSeparator:
                 foundSeparator = true;
                 break;
-            case '-':
+            case kMinus:
                 // The negative sign following a 'e' or 'E' is not a separator.
                 if (currentIndex != start && !isPrevExponential) {
                     foundSeparator = true;
                     *outEndWithNegOrDot = true;
                 }
                 break;
-            case '.':
+            case kDot:
                 if (!secondDot) {
                     secondDot = true;
                 } else {
@@ -85,20 +122,82 @@ static void extract(int* outEndPosition, bool* outEndWithNegOrDot, const char* s
                     *outEndWithNegOrDot = true;
                 }
                 break;
-            case 'e':
-            case 'E':
+            case kExponent:
                 isExponential = true;
                 break;
         }
         if (foundSeparator) {
             break;
         }
+        currentIndex++;
     }
     // In the case where nothing is found, we put the end position to the end of
     // our extract range. Otherwise, end position will be where separator is found.
     *outEndPosition = currentIndex;
 }
 
+/**
+ * Fast path for the short decimal literals that dominate path data. A value
+ * with at most seven significant digits fits a float mantissa exactly and its
+ * power-of-ten divisor (up to 1e10) is also exact, so one correctly-rounded
+ * division produces the same bits strtof would. Returns false for anything
+ * else (scientific notation, long mantissas), which falls back to strtof.
+ */
+static bool fastParseFloat(const char* s, const char* end, float* outValue) {
+    static const float kPowersOfTen[11] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                           1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    const char* p = s;
+    bool negative = false;
+    if (p < end && *p == '-') {
+        negative = true;
+        p++;
+    }
+    uint32_t mantissa = 0;
+    int fractionDigits = 0;
+    int pendingZeros = 0;
+    bool sawDot = false;
+    bool sawDigit = false;
+    for (; p < end; p++) {
+        char c = *p;
+        if (c >= '0' && c <= '9') {
+            sawDigit = true;
+            if (c == '0' && sawDot) {
+                // Fraction zeros only count if a nonzero digit follows;
+                // trailing ones ("22.000000") would otherwise waste the
+                // mantissa budget without changing the value.
+                pendingZeros++;
+                continue;
+            }
+            while (pendingZeros > 0) {
+                mantissa *= 10;
+                fractionDigits++;
+                pendingZeros--;
+                if (mantissa >= (1 << 24)) {
+                    return false;
+                }
+            }
+            mantissa = mantissa * 10 + (c - '0');
+            if (mantissa >= (1 << 24)) {
+                // The mantissa no longer fits a float exactly.
+                return false;
+            }
+            if (sawDot) {
+                fractionDigits++;
+            }
+        } else if (c == '.' && !sawDot) {
+            sawDot = true;
+        } else {
+            return false;
+        }
+    }
+    if (!sawDigit || fractionDigits > 10) {
+        return false;
+    }
+    float value = static_cast<float>(mantissa) / kPowersOfTen[fractionDigits];
+    *outValue = negative ? -value : value;
+    return true;
+}
+
 static float parseFloat(PathParser::ParseResult* result, const char* startPtr,
                         size_t expectedLength) {
     char* endPtr = NULL;
@@ -139,9 +238,14 @@ static void getFloats(std::vector<float>* outPoints, PathParser::ParseResult* re
         extract(&endPosition, &endWithNegOrDot, pathStr, startPosition, end);
 
         if (startPosition < endPosition) {
-            float currentValue = parseFloat(result, &pathStr[startPosition], end - startPosition);
-            if (result->failureOccurred) {
-                return;
+            // The token boundaries are already known from extract(), so try
+            // the exact fast-parse kernel before paying for strtof.
+            float currentValue;
+            if (!fastParseFloat(&pathStr[startPosition], &pathStr[endPosition], &currentValue)) {
+                currentValue = parseFloat(result, &pathStr[startPosition], end - startPosition);
+                if (result->failureOccurred) {
+                    return;
+                }
             }
             outPoints->push_back(currentValue);
         }
@@ -236,9 +340,12 @@ void PathParser::getPathDataFromAsciiString(PathData* data, ParseResult* result,
 
     while (end < strLen) {
         end = nextStart(pathStr, strLen, end);
-        std::vector<float> points;
-        getFloats(&points, result, pathStr, start, end);
-        validateVerbAndPoints(pathStr[start], points.size(), result);
+        // Parse straight into the output array instead of staging each verb's
+        // floats in a temporary vector.
+        size_t pointsBefore = data->points.size();
+        getFloats(&data->points, result, pathStr, start, end);
+        size_t pointCount = data->points.size() - pointsBefore;
+        validateVerbAndPoints(pathStr[start], pointCount, result);
         if (result->failureOccurred) {
             // If either verb or points is not valid, return immediately.
             result->failureMessage += "Failure occurred at position " + std::to_string(start) +
@@ -246,8 +353,7 @@ void PathParser::getPathDataFromAsciiString(PathData* data, ParseResult* result,
             return;
         }
         data->verbs.push_back(pathStr[start]);
-        data->verbSizes.push_back(points.size());
-        data->points.insert(data->points.end(), points.begin(), points.end());
+        data->verbSizes.push_back(pointCount);
         start = end;
         end++;
     }
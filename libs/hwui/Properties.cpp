@@ -56,8 +56,10 @@ bool Properties::waitForGpuCompletion = false;
 bool Properties::forceDrawFrame = false;
 
 bool Properties::filterOutTestOverhead = false;
+bool Properties::deferDisplayListFree = false;
 bool Properties::disableVsync = false;
 bool Properties::skpCaptureEnabled = false;
+bool Properties::enableFrameBatching = false;
 bool Properties::enableRTAnimations = true;
 
 bool Properties::runningInEmulator = false;
@@ -116,9 +118,12 @@ bool Properties::load() {
     enablePartialUpdates = property_get_bool(PROPERTY_ENABLE_PARTIAL_UPDATES, true);
 
     filterOutTestOverhead = property_get_bool(PROPERTY_FILTER_TEST_OVERHEAD, false);
+    deferDisplayListFree = property_get_bool(PROPERTY_DEFER_DISPLAYLIST_FREE, false);
 
     skpCaptureEnabled = debuggingEnabled && property_get_bool(PROPERTY_CAPTURE_SKP_ENABLED, false);
 
+    enableFrameBatching = property_get_bool(PROPERTY_FRAME_BATCHING, false);
+
     SkAndroidFrameworkTraceUtil::setEnableTracing(
             property_get_bool(PROPERTY_SKIA_ATRACE_ENABLED, false));
 
@@ -126,6 +126,12 @@ enum DebugLevel {
 
 #define PROPERTY_FILTER_TEST_OVERHEAD "debug.hwui.filter_test_overhead"
 
+/**
+ * Setting this property to "true" frees replaced display lists on a CommonPool
+ * worker instead of the UI thread during recording. Default is "false".
+ */
+#define PROPERTY_DEFER_DISPLAYLIST_FREE "debug.hwui.defer_displaylist_free"
+
 /**
  * Indicates whether PBOs can be used to back pixel buffers.
  * Accepted values are "true" and "false". Default is true.
@@ -165,6 +171,12 @@ enum DebugLevel {
 
 #define PROPERTY_RENDERAHEAD "debug.hwui.render_ahead"
 
+/**
+ * Allows draws from multiple windows syncing against the same vsync pulse to
+ * be coalesced into a single render thread pass ordered by deadline slack.
+ */
+#define PROPERTY_FRAME_BATCHING "debug.hwui.frame_batching"
+
 ///////////////////////////////////////////////////////////////////////////////
 // Misc
 ///////////////////////////////////////////////////////////////////////////////
@@ -227,6 +239,11 @@ public:
     // any overhead they add
     static bool filterOutTestOverhead;
 
+    // When true, display lists replaced during recording are destroyed on a
+    // CommonPool worker so the UI thread doesn't pay for tearing down the
+    // previous frame's drawables.
+    static bool deferDisplayListFree;
+
     // Workaround a device lockup in edge cases by switching to async mode
     // instead of the default vsync (b/38372997). Only system_server should hit this.
     // Any existing RenderProxy & Surface combination will be unaffected, only things
@@ -235,6 +252,11 @@ public:
 
     static bool skpCaptureEnabled;
 
+    // When true, windows that sync against the same vsync pulse defer their
+    // draws into one render thread pass instead of drawing per sync; the pass
+    // runs the window with the least deadline slack first.
+    static bool enableFrameBatching;
+
     // For experimentation b/68769804
     ANDROID_API static bool enableRTAnimations;
 
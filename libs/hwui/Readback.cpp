@@ -26,6 +26,7 @@
 #include "DeferredLayerUpdater.h"
 #include "Properties.h"
 #include "hwui/Bitmap.h"
+#include "thread/CommonPool.h"
 #include "utils/Color.h"
 #include "utils/MathUtils.h"
 #include "utils/TraceUtils.h"
@@ -72,6 +73,59 @@ CopyResult Readback::copySurfaceInto(Surface& surface, const Rect& srcRect, SkBi
     return copyImageInto(image, texTransform, srcRect, bitmap);
 }
 
+void Readback::copySurfaceIntoAsync(Surface& surface, const Rect& srcRect, SkBitmap* bitmap,
+                                    std::function<void(CopyResult)>&& callback) {
+    ATRACE_CALL();
+    // Setup the source. getLastQueuedBuffer is a cheap binder call; the
+    // expensive parts (fence wait, GPU copy) are deferred below.
+    sp<GraphicBuffer> sourceBuffer;
+    sp<Fence> sourceFence;
+    Matrix4 texTransform;
+    status_t err = surface.getLastQueuedBuffer(&sourceBuffer, &sourceFence, texTransform.data);
+    texTransform.invalidateType();
+    if (err != NO_ERROR) {
+        ALOGW("Failed to get last queued buffer, error = %d", err);
+        CommonPool::post([callback = std::move(callback)]() { callback(CopyResult::UnknownError); });
+        return;
+    }
+    if (!sourceBuffer.get()) {
+        ALOGW("Surface doesn't have any previously queued frames, nothing to readback from");
+        CommonPool::post([callback = std::move(callback)]() { callback(CopyResult::SourceEmpty); });
+        return;
+    }
+    if (sourceBuffer->getUsage() & GRALLOC_USAGE_PROTECTED) {
+        ALOGW("Surface is protected, unable to copy from it");
+        CommonPool::post(
+                [callback = std::move(callback)]() { callback(CopyResult::SourceInvalid); });
+        return;
+    }
+    const android_dataspace dataSpace =
+            static_cast<android_dataspace>(surface.getBuffersDataSpace());
+
+    // Wait for the producer's fence on a CommonPool worker so the render
+    // thread keeps drawing frames, then hop back for the GPU copy.
+    CommonPool::post([this, sourceBuffer, sourceFence, texTransform, dataSpace, srcRect, bitmap,
+                      callback = std::move(callback)]() mutable {
+        status_t fenceStatus = sourceFence->wait(500 /* ms */);
+        if (fenceStatus != NO_ERROR) {
+            ALOGE("Timeout (500ms) exceeded waiting for buffer fence, abandoning readback attempt");
+            callback(CopyResult::Timeout);
+            return;
+        }
+        mRenderThread.queue().post([this, sourceBuffer, texTransform, dataSpace, srcRect, bitmap,
+                                    callback = std::move(callback)]() mutable {
+            sk_sp<SkColorSpace> colorSpace = DataSpaceToColorSpace(dataSpace);
+            sk_sp<SkImage> image = SkImage::MakeFromAHardwareBuffer(
+                    reinterpret_cast<AHardwareBuffer*>(sourceBuffer.get()), kPremul_SkAlphaType,
+                    colorSpace);
+            CopyResult result = copyImageInto(image, texTransform, srcRect, bitmap);
+            // Deliver the result off the render thread; the callback is
+            // allowed to block (e.g. to wake a waiting binder caller).
+            CommonPool::post([callback = std::move(callback), result]() { callback(result); });
+        });
+    });
+}
+
 CopyResult Readback::copyHWBitmapInto(Bitmap* hwBitmap, SkBitmap* bitmap) {
     LOG_ALWAYS_FATAL_IF(!hwBitmap->isHardware());
 
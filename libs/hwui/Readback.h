@@ -22,6 +22,8 @@
 
 #include <SkBitmap.h>
 
+#include <functional>
+
 namespace android {
 class Bitmap;
 class GraphicBuffer;
@@ -49,6 +51,17 @@ public:
      */
     CopyResult copySurfaceInto(Surface& surface, const Rect& srcRect, SkBitmap* bitmap);
 
+    /**
+     * Non-blocking variant of copySurfaceInto. Must be called on the render
+     * thread; the wait for the producer's release fence happens on CommonPool
+     * instead of stalling the render thread, and the GPU copy is re-queued
+     * once the fence has signaled. The callback is invoked exactly once on a
+     * CommonPool worker, so it may block without stealing frame time. The
+     * caller must keep the bitmap alive until the callback runs.
+     */
+    void copySurfaceIntoAsync(Surface& surface, const Rect& srcRect, SkBitmap* bitmap,
+                              std::function<void(CopyResult)>&& callback);
+
     CopyResult copyHWBitmapInto(Bitmap* hwBitmap, SkBitmap* bitmap);
 
     CopyResult copyLayerInto(DeferredLayerUpdater* layer, SkBitmap* bitmap);
@@ -33,6 +33,7 @@
 #include "SkTextBlob.h"
 #include "SkVertices.h"
 
+#include <cstring>
 #include <experimental/type_traits>
 
 namespace android {
@@ -94,26 +95,24 @@ struct Restore final : Op {
 };
 struct SaveLayer final : Op {
     static const auto kType = Type::SaveLayer;
-    SaveLayer(const SkRect* bounds, const SkPaint* paint, const SkImageFilter* backdrop,
-              const SkImage* clipMask, const SkMatrix* clipMatrix, SkCanvas::SaveLayerFlags flags) {
+    SaveLayer(const SkRect* bounds, uint32_t paintIndex, const SkImageFilter* backdrop,
+              const SkImage* clipMask, const SkMatrix* clipMatrix, SkCanvas::SaveLayerFlags flags)
+            : paintIndex(paintIndex) {
         if (bounds) {
             this->bounds = *bounds;
         }
-        if (paint) {
-            this->paint = *paint;
-        }
         this->backdrop = sk_ref_sp(backdrop);
         this->clipMask = sk_ref_sp(clipMask);
         this->clipMatrix = clipMatrix ? *clipMatrix : SkMatrix::I();
         this->flags = flags;
     }
     SkRect bounds = kUnset;
-    SkPaint paint;
+    uint32_t paintIndex;
     sk_sp<const SkImageFilter> backdrop;
     sk_sp<const SkImage> clipMask;
     SkMatrix clipMatrix;
     SkCanvas::SaveLayerFlags flags;
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         c->saveLayer({maybe_unset(bounds), &paint, backdrop.get(), clipMask.get(),
                       clipMatrix.isIdentity() ? nullptr : &clipMatrix, flags});
     }
@@ -184,76 +183,91 @@ struct ClipRegion final : Op {
 
 struct DrawPaint final : Op {
     static const auto kType = Type::DrawPaint;
-    DrawPaint(const SkPaint& paint) : paint(paint) {}
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawPaint(paint); }
+    DrawPaint(uint32_t paintIndex) : paintIndex(paintIndex) {}
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const { c->drawPaint(paint); }
 };
 struct DrawBehind final : Op {
     static const auto kType = Type::DrawBehind;
-    DrawBehind(const SkPaint& paint) : paint(paint) {}
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { SkCanvasPriv::DrawBehind(c, paint); }
+    DrawBehind(uint32_t paintIndex) : paintIndex(paintIndex) {}
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        SkCanvasPriv::DrawBehind(c, paint);
+    }
 };
 struct DrawPath final : Op {
     static const auto kType = Type::DrawPath;
-    DrawPath(const SkPath& path, const SkPaint& paint) : path(path), paint(paint) {}
+    DrawPath(const SkPath& path, uint32_t paintIndex) : path(path), paintIndex(paintIndex) {}
     SkPath path;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawPath(path, paint); }
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        c->drawPath(path, paint);
+    }
 };
 struct DrawRect final : Op {
     static const auto kType = Type::DrawRect;
-    DrawRect(const SkRect& rect, const SkPaint& paint) : rect(rect), paint(paint) {}
+    DrawRect(const SkRect& rect, uint32_t paintIndex) : rect(rect), paintIndex(paintIndex) {}
     SkRect rect;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawRect(rect, paint); }
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        c->drawRect(rect, paint);
+    }
 };
 struct DrawRegion final : Op {
     static const auto kType = Type::DrawRegion;
-    DrawRegion(const SkRegion& region, const SkPaint& paint) : region(region), paint(paint) {}
+    DrawRegion(const SkRegion& region, uint32_t paintIndex)
+            : region(region), paintIndex(paintIndex) {}
     SkRegion region;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawRegion(region, paint); }
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        c->drawRegion(region, paint);
+    }
 };
 struct DrawOval final : Op {
     static const auto kType = Type::DrawOval;
-    DrawOval(const SkRect& oval, const SkPaint& paint) : oval(oval), paint(paint) {}
+    DrawOval(const SkRect& oval, uint32_t paintIndex) : oval(oval), paintIndex(paintIndex) {}
     SkRect oval;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawOval(oval, paint); }
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        c->drawOval(oval, paint);
+    }
 };
 struct DrawArc final : Op {
     static const auto kType = Type::DrawArc;
     DrawArc(const SkRect& oval, SkScalar startAngle, SkScalar sweepAngle, bool useCenter,
-            const SkPaint& paint)
+            uint32_t paintIndex)
             : oval(oval)
             , startAngle(startAngle)
             , sweepAngle(sweepAngle)
             , useCenter(useCenter)
-            , paint(paint) {}
+            , paintIndex(paintIndex) {}
     SkRect oval;
     SkScalar startAngle;
     SkScalar sweepAngle;
     bool useCenter;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         c->drawArc(oval, startAngle, sweepAngle, useCenter, paint);
     }
 };
 struct DrawRRect final : Op {
     static const auto kType = Type::DrawRRect;
-    DrawRRect(const SkRRect& rrect, const SkPaint& paint) : rrect(rrect), paint(paint) {}
+    DrawRRect(const SkRRect& rrect, uint32_t paintIndex) : rrect(rrect), paintIndex(paintIndex) {}
     SkRRect rrect;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawRRect(rrect, paint); }
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        c->drawRRect(rrect, paint);
+    }
 };
 struct DrawDRRect final : Op {
     static const auto kType = Type::DrawDRRect;
-    DrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint)
-            : outer(outer), inner(inner), paint(paint) {}
+    DrawDRRect(const SkRRect& outer, const SkRRect& inner, uint32_t paintIndex)
+            : outer(outer), inner(inner), paintIndex(paintIndex) {}
     SkRRect outer, inner;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawDRRect(outer, inner, paint); }
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        c->drawDRRect(outer, inner, paint);
+    }
 };
 
 struct DrawAnnotation final : Op {
@@ -278,21 +292,18 @@ struct DrawDrawable final : Op {
 };
 struct DrawPicture final : Op {
     static const auto kType = Type::DrawPicture;
-    DrawPicture(const SkPicture* picture, const SkMatrix* matrix, const SkPaint* paint)
-            : picture(sk_ref_sp(picture)) {
+    DrawPicture(const SkPicture* picture, const SkMatrix* matrix, uint32_t paintIndex,
+                bool has_paint)
+            : picture(sk_ref_sp(picture)), paintIndex(paintIndex), has_paint(has_paint) {
         if (matrix) {
             this->matrix = *matrix;
         }
-        if (paint) {
-            this->paint = *paint;
-            has_paint = true;
-        }
     }
     sk_sp<const SkPicture> picture;
     SkMatrix matrix = SkMatrix::I();
-    SkPaint paint;
-    bool has_paint = false;  // TODO: why is a default paint not the same?
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    uint32_t paintIndex;
+    bool has_paint;  // TODO: why is a default paint not the same?
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         c->drawPicture(picture.get(), &matrix, has_paint ? &paint : nullptr);
     }
 };
@@ -315,17 +326,13 @@ struct DrawImage final : Op {
 struct DrawImageNine final : Op {
     static const auto kType = Type::DrawImageNine;
     DrawImageNine(sk_sp<const SkImage>&& image, const SkIRect& center, const SkRect& dst,
-                  const SkPaint* paint)
-            : image(std::move(image)), center(center), dst(dst) {
-        if (paint) {
-            this->paint = *paint;
-        }
-    }
+                  uint32_t paintIndex)
+            : image(std::move(image)), center(center), dst(dst), paintIndex(paintIndex) {}
     sk_sp<const SkImage> image;
     SkIRect center;
     SkRect dst;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         c->drawImageNine(image.get(), center, dst, &paint);
     }
 };
@@ -382,19 +389,21 @@ struct DrawImageLattice final : Op {
 
 struct DrawTextBlob final : Op {
     static const auto kType = Type::DrawTextBlob;
-    DrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y, const SkPaint& paint)
-            : blob(sk_ref_sp(blob)), x(x), y(y), paint(paint) {}
+    DrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y, uint32_t paintIndex)
+            : blob(sk_ref_sp(blob)), x(x), y(y), paintIndex(paintIndex) {}
     sk_sp<const SkTextBlob> blob;
     SkScalar x, y;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const { c->drawTextBlob(blob.get(), x, y, paint); }
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
+        c->drawTextBlob(blob.get(), x, y, paint);
+    }
 };
 
 struct DrawPatch final : Op {
     static const auto kType = Type::DrawPatch;
     DrawPatch(const SkPoint cubics[12], const SkColor colors[4], const SkPoint texs[4],
-              SkBlendMode bmode, const SkPaint& paint)
-            : xfermode(bmode), paint(paint) {
+              SkBlendMode bmode, uint32_t paintIndex)
+            : xfermode(bmode), paintIndex(paintIndex) {
         copy_v(this->cubics, cubics, 12);
         if (colors) {
             copy_v(this->colors, colors, 4);
@@ -409,56 +418,60 @@ struct DrawPatch final : Op {
     SkColor colors[4];
     SkPoint texs[4];
     SkBlendMode xfermode;
-    SkPaint paint;
+    uint32_t paintIndex;
     bool has_colors = false;
     bool has_texs = false;
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         c->drawPatch(cubics, has_colors ? colors : nullptr, has_texs ? texs : nullptr, xfermode,
                      paint);
     }
 };
 struct DrawPoints final : Op {
     static const auto kType = Type::DrawPoints;
-    DrawPoints(SkCanvas::PointMode mode, size_t count, const SkPaint& paint)
-            : mode(mode), count(count), paint(paint) {}
+    DrawPoints(SkCanvas::PointMode mode, size_t count, uint32_t paintIndex)
+            : mode(mode), count(count), paintIndex(paintIndex) {}
     SkCanvas::PointMode mode;
     size_t count;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         c->drawPoints(mode, count, pod<SkPoint>(this), paint);
     }
 };
 struct DrawVertices final : Op {
     static const auto kType = Type::DrawVertices;
-    DrawVertices(const SkVertices* v, int bc, SkBlendMode m, const SkPaint& p)
-            : vertices(sk_ref_sp(const_cast<SkVertices*>(v))), boneCount(bc), mode(m), paint(p) {}
+    DrawVertices(const SkVertices* v, int bc, SkBlendMode m, uint32_t paintIndex)
+            : vertices(sk_ref_sp(const_cast<SkVertices*>(v)))
+            , boneCount(bc)
+            , mode(m)
+            , paintIndex(paintIndex) {}
     sk_sp<SkVertices> vertices;
     int boneCount;
     SkBlendMode mode;
-    SkPaint paint;
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    uint32_t paintIndex;
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         c->drawVertices(vertices, pod<SkVertices::Bone>(this), boneCount, mode, paint);
     }
 };
 struct DrawAtlas final : Op {
     static const auto kType = Type::DrawAtlas;
     DrawAtlas(const SkImage* atlas, int count, SkBlendMode xfermode, const SkRect* cull,
-              const SkPaint* paint, bool has_colors)
-            : atlas(sk_ref_sp(atlas)), count(count), xfermode(xfermode), has_colors(has_colors) {
+              uint32_t paintIndex, bool has_colors)
+            : atlas(sk_ref_sp(atlas))
+            , count(count)
+            , xfermode(xfermode)
+            , paintIndex(paintIndex)
+            , has_colors(has_colors) {
         if (cull) {
             this->cull = *cull;
         }
-        if (paint) {
-            this->paint = *paint;
-        }
     }
     sk_sp<const SkImage> atlas;
     int count;
     SkBlendMode xfermode;
     SkRect cull = kUnset;
-    SkPaint paint;
+    uint32_t paintIndex;
     bool has_colors;
-    void draw(SkCanvas* c, const SkMatrix&) const {
+    void draw(SkCanvas* c, const SkMatrix&, const SkPaint& paint) const {
         auto xforms = pod<SkRSXform>(this, 0);
         auto texs = pod<SkRect>(this, count * sizeof(SkRSXform));
         auto colors = has_colors ? pod<SkColor>(this, count * (sizeof(SkRSXform) + sizeof(SkRect)))
@@ -506,6 +519,9 @@ void* DisplayListData::push(size_t pod, Args&&... args) {
     SkASSERT(fUsed + skip <= fReserved);
     auto op = (T*)(fBytes.get() + fUsed);
     fUsed += skip;
+    // Zero the slot first so struct padding and alignment gaps are
+    // deterministic, which lets hasSameBytes() compare op streams directly.
+    memset(op, 0, skip);
     new (op) T{std::forward<Args>(args)...};
     op->type = (uint32_t)T::kType;
     op->skip = skip;
@@ -539,7 +555,8 @@ void DisplayListData::restore() {
 void DisplayListData::saveLayer(const SkRect* bounds, const SkPaint* paint,
                                 const SkImageFilter* backdrop, const SkImage* clipMask,
                                 const SkMatrix* clipMatrix, SkCanvas::SaveLayerFlags flags) {
-    this->push<SaveLayer>(0, bounds, paint, backdrop, clipMask, clipMatrix, flags);
+    this->push<SaveLayer>(0, bounds, this->internPaint(paint ? *paint : SkPaint()), backdrop,
+                          clipMask, clipMatrix, flags);
 }
 
 void DisplayListData::saveBehind(const SkRect* subset) {
@@ -570,32 +587,32 @@ void DisplayListData::clipRegion(const SkRegion& region, SkClipOp op) {
 }
 
 void DisplayListData::drawPaint(const SkPaint& paint) {
-    this->push<DrawPaint>(0, paint);
+    this->push<DrawPaint>(0, this->internPaint(paint));
 }
 void DisplayListData::drawBehind(const SkPaint& paint) {
-    this->push<DrawBehind>(0, paint);
+    this->push<DrawBehind>(0, this->internPaint(paint));
 }
 void DisplayListData::drawPath(const SkPath& path, const SkPaint& paint) {
-    this->push<DrawPath>(0, path, paint);
+    this->push<DrawPath>(0, path, this->internPaint(paint));
 }
 void DisplayListData::drawRect(const SkRect& rect, const SkPaint& paint) {
-    this->push<DrawRect>(0, rect, paint);
+    this->push<DrawRect>(0, rect, this->internPaint(paint));
 }
 void DisplayListData::drawRegion(const SkRegion& region, const SkPaint& paint) {
-    this->push<DrawRegion>(0, region, paint);
+    this->push<DrawRegion>(0, region, this->internPaint(paint));
 }
 void DisplayListData::drawOval(const SkRect& oval, const SkPaint& paint) {
-    this->push<DrawOval>(0, oval, paint);
+    this->push<DrawOval>(0, oval, this->internPaint(paint));
 }
 void DisplayListData::drawArc(const SkRect& oval, SkScalar startAngle, SkScalar sweepAngle,
                               bool useCenter, const SkPaint& paint) {
-    this->push<DrawArc>(0, oval, startAngle, sweepAngle, useCenter, paint);
+    this->push<DrawArc>(0, oval, startAngle, sweepAngle, useCenter, this->internPaint(paint));
 }
 void DisplayListData::drawRRect(const SkRRect& rrect, const SkPaint& paint) {
-    this->push<DrawRRect>(0, rrect, paint);
+    this->push<DrawRRect>(0, rrect, this->internPaint(paint));
 }
 void DisplayListData::drawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
-    this->push<DrawDRRect>(0, outer, inner, paint);
+    this->push<DrawDRRect>(0, outer, inner, this->internPaint(paint));
 }
 
 void DisplayListData::drawAnnotation(const SkRect& rect, const char* key, SkData* value) {
@@ -608,7 +625,8 @@ void DisplayListData::drawDrawable(SkDrawable* drawable, const SkMatrix* matrix)
 }
 void DisplayListData::drawPicture(const SkPicture* picture, const SkMatrix* matrix,
                                   const SkPaint* paint) {
-    this->push<DrawPicture>(0, picture, matrix, paint);
+    this->push<DrawPicture>(0, picture, matrix, this->internPaint(paint ? *paint : SkPaint()),
+                            paint != nullptr);
 }
 void DisplayListData::drawImage(sk_sp<const SkImage> image, SkScalar x, SkScalar y,
                                 const SkPaint* paint, BitmapPalette palette) {
@@ -616,7 +634,8 @@ void DisplayListData::drawImage(sk_sp<const SkImage> image, SkScalar x, SkScalar
 }
 void DisplayListData::drawImageNine(sk_sp<const SkImage> image, const SkIRect& center,
                                     const SkRect& dst, const SkPaint* paint) {
-    this->push<DrawImageNine>(0, std::move(image), center, dst, paint);
+    this->push<DrawImageNine>(0, std::move(image), center, dst,
+                              this->internPaint(paint ? *paint : SkPaint()));
 }
 void DisplayListData::drawImageRect(sk_sp<const SkImage> image, const SkRect* src,
                                     const SkRect& dst, const SkPaint* paint,
@@ -639,23 +658,24 @@ void DisplayListData::drawImageLattice(sk_sp<const SkImage> image, const SkCanva
 
 void DisplayListData::drawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                    const SkPaint& paint) {
-    this->push<DrawTextBlob>(0, blob, x, y, paint);
+    this->push<DrawTextBlob>(0, blob, x, y, this->internPaint(paint));
     mHasText = true;
 }
 
 void DisplayListData::drawPatch(const SkPoint points[12], const SkColor colors[4],
                                 const SkPoint texs[4], SkBlendMode bmode, const SkPaint& paint) {
-    this->push<DrawPatch>(0, points, colors, texs, bmode, paint);
+    this->push<DrawPatch>(0, points, colors, texs, bmode, this->internPaint(paint));
 }
 void DisplayListData::drawPoints(SkCanvas::PointMode mode, size_t count, const SkPoint points[],
                                  const SkPaint& paint) {
-    void* pod = this->push<DrawPoints>(count * sizeof(SkPoint), mode, count, paint);
+    void* pod = this->push<DrawPoints>(count * sizeof(SkPoint), mode, count,
+                                       this->internPaint(paint));
     copy_v(pod, points, count);
 }
 void DisplayListData::drawVertices(const SkVertices* vertices, const SkVertices::Bone bones[],
                                    int boneCount, SkBlendMode mode, const SkPaint& paint) {
     void* pod = this->push<DrawVertices>(boneCount * sizeof(SkVertices::Bone), vertices, boneCount,
-                                         mode, paint);
+                                         mode, this->internPaint(paint));
     copy_v(pod, bones, boneCount);
 }
 void DisplayListData::drawAtlas(const SkImage* atlas, const SkRSXform xforms[], const SkRect texs[],
@@ -665,8 +685,9 @@ void DisplayListData::drawAtlas(const SkImage* atlas, const SkRSXform xforms[],
     if (colors) {
         bytes += count * sizeof(SkColor);
     }
-    void* pod =
-            this->push<DrawAtlas>(bytes, atlas, count, xfermode, cull, paint, colors != nullptr);
+    void* pod = this->push<DrawAtlas>(bytes, atlas, count, xfermode, cull,
+                                      this->internPaint(paint ? *paint : SkPaint()),
+                                      colors != nullptr);
     copy_v(pod, xforms, count, texs, count, colors, colors ? count : 0);
 }
 void DisplayListData::drawShadowRec(const SkPath& path, const SkDrawShadowRec& rec) {
@@ -676,14 +697,25 @@ void DisplayListData::drawVectorDrawable(VectorDrawableRoot* tree) {
     this->push<DrawVectorDrawable>(0, tree);
 }
 
-typedef void (*draw_fn)(const void*, SkCanvas*, const SkMatrix&);
+typedef void (*draw_fn)(const void*, SkCanvas*, const SkMatrix&, const SkPaint[]);
 typedef void (*void_fn)(const void*);
 typedef void (*color_transform_fn)(const void*, ColorTransform);
 
-// All ops implement draw().
-#define X(T)                                                    \
-    [](const void* op, SkCanvas* c, const SkMatrix& original) { \
-        ((const T*)op)->draw(c, original);                      \
+template <class T>
+using has_paint_index_helper = decltype(std::declval<T>().paintIndex);
+
+template <class T>
+constexpr bool has_paint_index = std::experimental::is_detected_v<has_paint_index_helper, T>;
+
+// All ops implement draw(). Ops that interned their paint are handed the
+// resolved table entry; everything else keeps the two-argument form.
+#define X(T)                                                                            \
+    [](const void* op, SkCanvas* c, const SkMatrix& original, const SkPaint paints[]) { \
+        if constexpr (has_paint_index<T>) {                                             \
+            ((const T*)op)->draw(c, original, paints[((const T*)op)->paintIndex]);      \
+        } else {                                                                        \
+            ((const T*)op)->draw(c, original);                                          \
+        }                                                                               \
     },
 static const draw_fn draw_fns[] = {
 #include "DisplayListOps.in"
@@ -702,7 +734,7 @@ static const void_fn dtor_fns[] = {
 
 void DisplayListData::draw(SkCanvas* canvas) const {
     SkAutoCanvasRestore acr(canvas, false);
-    this->map(draw_fns, canvas, canvas->getTotalMatrix());
+    this->map(draw_fns, canvas, canvas->getTotalMatrix(), fPaints.data());
 }
 
 DisplayListData::~DisplayListData() {
@@ -714,6 +746,42 @@ void DisplayListData::reset() {
 
     // Leave fBytes and fReserved alone.
     fUsed = 0;
+    fPaints.clear();
+}
+
+uint32_t DisplayListData::internPaint(const SkPaint& paint) {
+    // Scan most-recent-first since recorded paints overwhelmingly repeat
+    // back-to-back, and bound the scan so lists with thousands of unique
+    // paints don't turn recording quadratic.
+    static constexpr size_t kMaxScan = 16;
+    size_t stop = fPaints.size() > kMaxScan ? fPaints.size() - kMaxScan : 0;
+    for (size_t i = fPaints.size(); i > stop;) {
+        i--;
+        if (fPaints[i] == paint) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+    fPaints.push_back(paint);
+    return static_cast<uint32_t>(fPaints.size() - 1);
+}
+
+void DisplayListData::forEachTextBlob(
+        const std::function<void(const SkTextBlob*, const SkPaint&)>& fn) const {
+    auto end = fBytes.get() + fUsed;
+    for (const uint8_t* ptr = fBytes.get(); ptr < end;) {
+        auto op = (const Op*)ptr;
+        if (op->type == (uint32_t)Type::DrawTextBlob) {
+            auto blobOp = (const DrawTextBlob*)op;
+            fn(blobOp->blob.get(), fPaints[blobOp->paintIndex]);
+        }
+        ptr += op->skip;
+    }
+}
+
+bool DisplayListData::hasSameBytes(const DisplayListData& other) const {
+    return fUsed == other.fUsed &&
+           (fUsed == 0 || !memcmp(fBytes.get(), other.fBytes.get(), fUsed)) &&
+           fPaints == other.fPaints;
 }
 
 template <class T>
@@ -762,6 +830,12 @@ static const color_transform_fn color_transform_fns[] = {
 
 void DisplayListData::applyColorTransform(ColorTransform transform) {
     this->map(color_transform_fns, transform);
+    // Ops that interned their paint carry only an index, so the map above
+    // skips them; transform each unique table entry once instead. Palette
+    // -aware ops (bitmaps) embed their paint and were handled by the map.
+    for (SkPaint& paint : fPaints) {
+        transformPaint(transform, &paint);
+    }
 }
 
 RecordingCanvas::RecordingCanvas() : INHERITED(1, 1), fDL(nullptr) {}
@@ -32,6 +32,7 @@
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 
+#include <functional>
 #include <vector>
 
 namespace android {
@@ -67,6 +68,21 @@ public:
     bool hasText() const { return mHasText; }
     size_t usedSize() const { return fUsed; }
 
+    /**
+     * Returns true if the recorded op stream is byte-for-byte identical to the
+     * other list's and the interned paint tables match. Ops store ref-counted
+     * objects (SkTextBlob, SkImage, ...) by pointer, so a match additionally
+     * guarantees both lists reference the exact same objects;
+     * equal-but-reallocated content compares unequal.
+     */
+    bool hasSameBytes(const DisplayListData& other) const;
+
+    /**
+     * Invokes fn once per recorded text blob with the blob and its resolved
+     * paint, letting callers harvest glyph work without replaying the list.
+     */
+    void forEachTextBlob(const std::function<void(const SkTextBlob*, const SkPaint&)>& fn) const;
+
 private:
     friend class RecordingCanvas;
 
@@ -127,10 +143,17 @@ private:
     template <typename Fn, typename... Args>
     void map(const Fn[], Args...) const;
 
+    // Returns the index of a table entry equal to the given paint, appending
+    // one if needed. Draw ops reference their paint by index so runs of ops
+    // sharing one paint store it once instead of embedding a copy each.
+    uint32_t internPaint(const SkPaint&);
+
     SkAutoTMalloc<uint8_t> fBytes;
     size_t fUsed = 0;
     size_t fReserved = 0;
 
+    std::vector<SkPaint> fPaints;
+
     bool mHasText : 1;
 };
 
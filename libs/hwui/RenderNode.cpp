@@ -18,10 +18,12 @@
 
 #include "DamageAccumulator.h"
 #include "Debug.h"
+#include "Properties.h"
 #include "TreeInfo.h"
 #include "VectorDrawable.h"
 #include "renderstate/RenderState.h"
 #include "renderthread/CanvasContext.h"
+#include "thread/CommonPool.h"
 #include "utils/FatVector.h"
 #include "utils/MathUtils.h"
 #include "utils/StringUtils.h"
@@ -72,8 +74,19 @@ RenderNode::~RenderNode() {
 void RenderNode::setStagingDisplayList(DisplayList* displayList) {
     mValid = (displayList != nullptr);
     mNeedsDisplayListSync = true;
-    delete mStagingDisplayList;
+    DisplayList* old = mStagingDisplayList;
     mStagingDisplayList = displayList;
+    if (!old) {
+        return;
+    }
+    if (Properties::deferDisplayListFree) {
+        // Tearing down the replaced list walks every drawable it recorded; on
+        // deep trees that's a measurable chunk of the UI thread's frame, so
+        // push it to a worker. The list is fully owned by the task by now.
+        CommonPool::post([old] { delete old; });
+    } else {
+        delete old;
+    }
 }
 
 /**
@@ -259,8 +272,55 @@ void RenderNode::prepareTreeImpl(TreeObserver& observer, TreeInfo& info, bool fu
     info.damageAccumulator->popTransform();
 }
 
-void RenderNode::syncProperties() {
-    mProperties = mStagingProperties;
+void RenderNode::syncProperties(uint32_t dirtyMask) {
+    if (CC_UNLIKELY(dirtyMask & GENERIC)) {
+        mProperties = mStagingProperties;
+        return;
+    }
+
+    // Only tagged animatable fields changed, so copy those individually
+    // instead of paying for the full assignment -- outline, clip bounds,
+    // layer properties and a forced matrix rebuild -- on every animation
+    // pulse. The setters keep the matrix-dirty flag accurate, and
+    // updateMatrix() below is a no-op when no transform field moved.
+    if (dirtyMask & ALPHA) {
+        mProperties.setAlpha(mStagingProperties.getAlpha());
+    }
+    if (dirtyMask & (X | Y)) {
+        mProperties.setLeftTopRightBottom(mStagingProperties.getLeft(), mStagingProperties.getTop(),
+                                          mStagingProperties.getRight(),
+                                          mStagingProperties.getBottom());
+    }
+    if (dirtyMask & TRANSLATION_X) {
+        mProperties.setTranslationX(mStagingProperties.getTranslationX());
+    }
+    if (dirtyMask & TRANSLATION_Y) {
+        mProperties.setTranslationY(mStagingProperties.getTranslationY());
+    }
+    if (dirtyMask & (TRANSLATION_Z | Z)) {
+        mProperties.setTranslationZ(mStagingProperties.getTranslationZ());
+        mProperties.setElevation(mStagingProperties.getElevation());
+    }
+    if (dirtyMask & ROTATION) {
+        mProperties.setRotation(mStagingProperties.getRotation());
+    }
+    if (dirtyMask & ROTATION_X) {
+        mProperties.setRotationX(mStagingProperties.getRotationX());
+    }
+    if (dirtyMask & ROTATION_Y) {
+        mProperties.setRotationY(mStagingProperties.getRotationY());
+    }
+    if (dirtyMask & SCALE_X) {
+        mProperties.setScaleX(mStagingProperties.getScaleX());
+    }
+    if (dirtyMask & SCALE_Y) {
+        mProperties.setScaleY(mStagingProperties.getScaleY());
+    }
+    // Recording can flip this on a child without tagging a field; carry it
+    // whenever a sync happens at all, as the full copy used to.
+    mProperties.setClipMayBeComplex(mStagingProperties.isClipMayBeComplex());
+
+    mProperties.updateMatrix();
 }
 
 void RenderNode::pushStagingPropertiesChanges(TreeInfo& info) {
@@ -277,10 +337,11 @@ void RenderNode::pushStagingPropertiesChanges(TreeInfo& info) {
         mAnimatorManager.pushStaging();
     }
     if (mDirtyPropertyFields) {
+        const uint32_t dirtyMask = mDirtyPropertyFields;
         mDirtyPropertyFields = 0;
         damageSelf(info);
         info.damageAccumulator->popTransform();
-        syncProperties();
+        syncProperties(dirtyMask);
         // We could try to be clever and only re-damage if the matrix changed.
         // However, we don't need to worry about that. The cost of over-damaging
         // here is only going to be a single additional map rect of this node
@@ -292,14 +353,30 @@ void RenderNode::pushStagingPropertiesChanges(TreeInfo& info) {
 }
 
 void RenderNode::syncDisplayList(TreeObserver& observer, TreeInfo* info) {
-    // Make sure we inc first so that we don't fluctuate between 0 and 1,
-    // which would thrash the layer cache
-    if (mStagingDisplayList) {
-        mStagingDisplayList->updateChildren([](RenderNode* child) { child->incParentRefCount(); });
+    if (mStagingDisplayList && mDisplayList &&
+        mDisplayList->hasSameContentAs(*mStagingDisplayList)) {
+        // The re-record produced an identical op stream (common for text that
+        // re-laid-out to the same result), so keep drawing from the current
+        // list and drop the staging copy. Skia's caches stay warm because the
+        // surviving list still references the same blobs and images.
+        delete mStagingDisplayList;
+        mStagingDisplayList = nullptr;
+    } else {
+        // Make sure we inc first so that we don't fluctuate between 0 and 1,
+        // which would thrash the layer cache
+        if (mStagingDisplayList) {
+            mStagingDisplayList->updateChildren(
+                    [](RenderNode* child) { child->incParentRefCount(); });
+        }
+        deleteDisplayList(observer, info);
+        mDisplayList = mStagingDisplayList;
+        mStagingDisplayList = nullptr;
+        if (mDisplayList) {
+            // Genuinely new content; overlap glyph rasterization with the
+            // rest of the sync traversal.
+            mDisplayList->prewarmContent();
+        }
     }
-    deleteDisplayList(observer, info);
-    mDisplayList = mStagingDisplayList;
-    mStagingDisplayList = nullptr;
     if (mDisplayList) {
         WebViewSyncData syncData {
             .applyForceDark = info && !info->disableForceDark
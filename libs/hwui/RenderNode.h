@@ -221,7 +221,7 @@ private:
                              std::vector<RenderNodeOp*>* compositedChildrenOfProjectionSurface,
                              const mat4* transformFromProjectionSurface);
 
-    void syncProperties();
+    void syncProperties(uint32_t dirtyMask = GENERIC);
     void syncDisplayList(TreeObserver& observer, TreeInfo* info);
     void handleForceDark(TreeInfo* info);
 
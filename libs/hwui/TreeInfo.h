@@ -33,6 +33,7 @@ class CanvasContext;
 
 class DamageAccumulator;
 class LayerUpdateQueue;
+class LinearAllocator;
 class RenderNode;
 class RenderState;
 
@@ -93,6 +94,11 @@ public:
     LayerUpdateQueue* layerUpdateQueue = nullptr;
     ErrorHandler* errorHandler = nullptr;
 
+    // Frame-scoped scratch allocator (RenderThread::frameArena), rewound by
+    // the frame driver once the frame completes. Null outside of frame
+    // traversals such as buildLayer.
+    LinearAllocator* frameAllocator = nullptr;
+
     bool updateWindowPositions = false;
 
     int disableForceDark;
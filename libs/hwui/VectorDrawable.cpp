@@ -21,6 +21,7 @@
 #include "SkColorFilter.h"
 #include "SkImageInfo.h"
 #include "SkShader.h"
+#include "thread/CommonPool.h"
 #include "utils/Macros.h"
 #include "utils/TraceUtils.h"
 #include "utils/VectorDrawableUtils.h"
@@ -286,6 +287,17 @@ void Group::draw(SkCanvas* outCanvas, bool useStagingData) {
     // Restore the previous clip and matrix information.
 }
 
+void Group::drawChildRange(size_t begin, size_t end, SkCanvas* outCanvas, bool useStagingData) {
+    SkAutoCanvasRestore saver(outCanvas, true);
+    SkMatrix stackedMatrix;
+    const GroupProperties& prop = useStagingData ? mStagingProperties : mProperties;
+    getLocalMatrix(&stackedMatrix, prop);
+    outCanvas->concat(stackedMatrix);
+    for (size_t i = begin; i < end && i < mChildren.size(); i++) {
+        mChildren[i]->draw(outCanvas, useStagingData);
+    }
+}
+
 void Group::dump() {
     ALOGD("Group %s has %zu children: ", mName.c_str(), mChildren.size());
     ALOGD("Group translateX, Y : %f, %f, scaleX, Y: %f, %f", mProperties.getTranslateX(),
@@ -591,20 +603,81 @@ void Tree::draw(SkCanvas* canvas, const SkRect& bounds, const SkPaint& inPaint)
     }
 }
 
+// Repaints smaller than this finish faster than the cost of fanning the work
+// out to the pool, so they stay on the calling thread.
+static constexpr int kParallelRepaintMinArea = 256 * 256;
+// Each slice rasterizes into its own full-size layer, so the slice count also
+// bounds the transient memory of a parallel repaint.
+static constexpr size_t kMaxParallelRepaintSlices = 4;
+
+bool Tree::updateBitmapCacheParallel(SkBitmap& outCache, float scaleX, float scaleY,
+                                     bool useStagingData) {
+    const size_t childCount = mRootNode->numChildren();
+    if (childCount < 2 || outCache.width() * outCache.height() < kParallelRepaintMinArea) {
+        return false;
+    }
+    // A ClipPath child clips its later siblings, in which case separately
+    // rasterized slices would no longer composite to the same image.
+    if (!mRootNode->childrenDrawIndependently()) {
+        return false;
+    }
+
+    const size_t sliceCount = std::min(childCount, kMaxParallelRepaintSlices);
+    SkImageInfo layerInfo =
+            SkImageInfo::MakeN32(outCache.width(), outCache.height(), kPremul_SkAlphaType);
+    std::vector<SkBitmap> layers(sliceCount);
+    for (auto& layer : layers) {
+        if (!layer.tryAllocPixels(layerInfo)) {
+            return false;  // not enough memory for the layers, rasterize in place
+        }
+    }
+
+    auto rasterizeSlice = [&](size_t slice) {
+        SkBitmap& layer = layers[slice];
+        layer.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(layer);
+        canvas.scale(scaleX, scaleY);
+        mRootNode->drawChildRange(childCount * slice / sliceCount,
+                                  childCount * (slice + 1) / sliceCount, &canvas, useStagingData);
+    };
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(sliceCount - 1);
+    for (size_t i = 1; i < sliceCount; i++) {
+        pending.push_back(CommonPool::async([&rasterizeSlice, i] { rasterizeSlice(i); }));
+    }
+    rasterizeSlice(0);
+    for (auto& future : pending) {
+        future.wait();
+    }
+
+    // Composite the slices in child order; every leaf draws srcOver, so the
+    // stacked layers produce the same image as the sequential walk.
+    outCache.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas outCanvas(outCache);
+    for (auto& layer : layers) {
+        outCanvas.drawBitmap(layer, 0, 0);
+    }
+    return true;
+}
+
 void Tree::updateBitmapCache(Bitmap& bitmap, bool useStagingData) {
     SkBitmap outCache;
     bitmap.getSkBitmap(&outCache);
     int cacheWidth = outCache.width();
     int cacheHeight = outCache.height();
     ATRACE_FORMAT("VectorDrawable repaint %dx%d", cacheWidth, cacheHeight);
-    outCache.eraseColor(SK_ColorTRANSPARENT);
-    SkCanvas outCanvas(outCache);
     float viewportWidth =
             useStagingData ? mStagingProperties.getViewportWidth() : mProperties.getViewportWidth();
     float viewportHeight = useStagingData ? mStagingProperties.getViewportHeight()
                                           : mProperties.getViewportHeight();
     float scaleX = cacheWidth / viewportWidth;
     float scaleY = cacheHeight / viewportHeight;
+    if (updateBitmapCacheParallel(outCache, scaleX, scaleY, useStagingData)) {
+        return;
+    }
+    outCache.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas outCanvas(outCache);
     outCanvas.scale(scaleX, scaleY);
     mRootNode->draw(&outCanvas, useStagingData);
 }
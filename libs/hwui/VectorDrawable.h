@@ -119,6 +119,10 @@ public:
     virtual ~Node() {}
     virtual void syncProperties() = 0;
     virtual void setAntiAlias(bool aa) = 0;
+    // True when drawing this node changes the canvas state seen by the siblings
+    // after it (e.g. a clip), in which case siblings cannot be rasterized
+    // independently.
+    virtual bool affectsSiblingDraws() const { return false; }
 
     virtual void forEachFillColor(const std::function<void(SkColor)>& func) const { }
 
@@ -376,6 +380,7 @@ public:
     ClipPath() : Path() {}
     void draw(SkCanvas* outCanvas, bool useStagingData) override;
     virtual void setAntiAlias(bool aa) {}
+    virtual bool affectsSiblingDraws() const override { return true; }
 };
 
 class ANDROID_API Group : public Node {
@@ -463,6 +468,16 @@ public:
     // Methods below could be called from either UI thread or Render Thread.
     virtual void draw(SkCanvas* outCanvas, bool useStagingData) override;
     void getLocalMatrix(SkMatrix* outMatrix, const GroupProperties& properties);
+    size_t numChildren() const { return mChildren.size(); }
+    bool childrenDrawIndependently() const {
+        for (const auto& child : mChildren) {
+            if (child->affectsSiblingDraws()) return false;
+        }
+        return true;
+    }
+    // Draws the children in [begin, end) under this group's local matrix,
+    // exactly as the matching slice of draw() would.
+    void drawChildRange(size_t begin, size_t end, SkCanvas* outCanvas, bool useStagingData);
     void dump() override;
     static bool isValidProperty(int propertyId);
 
@@ -696,6 +711,8 @@ private:
     bool allocateBitmapIfNeeded(Cache& cache, int width, int height);
     bool canReuseBitmap(Bitmap*, int width, int height);
     void updateBitmapCache(Bitmap& outCache, bool useStagingData);
+    bool updateBitmapCacheParallel(SkBitmap& outCache, float scaleX, float scaleY,
+                                   bool useStagingData);
 
     // Cap the bitmap size, such that it won't hurt the performance too much
     // and it won't crash due to a very large scale.
@@ -31,6 +31,16 @@ namespace android {
 namespace uirenderer {
 namespace skiapipeline {
 
+// Damage and buffer age of the frame currently being rendered. Render thread
+// confined, valid between setCurrentFrameInfo() and the end of the frame.
+static SkIRect gCurrentFrameDamage = SkIRect::MakeEmpty();
+static int gCurrentFrameBufferAge = 0;
+
+void GLFunctorDrawable::setCurrentFrameInfo(const SkIRect& damage, int bufferAge) {
+    gCurrentFrameDamage = damage;
+    gCurrentFrameBufferAge = bufferAge;
+}
+
 GLFunctorDrawable::~GLFunctorDrawable() {
     if (auto lp = std::get_if<LegacyFunctor>(&mAnyFunctor)) {
         if (lp->listener) {
@@ -139,6 +149,16 @@ void GLFunctorDrawable::onDraw(SkCanvas* canvas) {
     info.height = fboSize.height();
     mat4.asColMajorf(&info.transform[0]);
     info.color_space_ptr = canvas->imageInfo().colorSpace();
+    if (fboID == 0) {
+        // Only the window surface carries meaningful partial-update state; an
+        // offscreen layer was just (re)drawn from scratch, so the defaults
+        // (age 0, full redraw) already describe it.
+        info.damageLeft = gCurrentFrameDamage.fLeft;
+        info.damageTop = gCurrentFrameDamage.fTop;
+        info.damageRight = gCurrentFrameDamage.fRight;
+        info.damageBottom = gCurrentFrameDamage.fBottom;
+        info.bufferAge = gCurrentFrameBufferAge;
+    }
 
     // ensure that the framebuffer that the webview will render into is bound before we clear
     // the stencil and/or draw the functor.
@@ -35,6 +35,11 @@ public:
 
     virtual ~GLFunctorDrawable();
 
+    // Records the damage bounds and buffer age of the frame about to be
+    // rendered so functors drawn into it can report them to the WebView.
+    // Only called on the render thread, before the frame's drawables run.
+    static void setCurrentFrameInfo(const SkIRect& damage, int bufferAge);
+
 protected:
     void onDraw(SkCanvas* canvas) override;
 };
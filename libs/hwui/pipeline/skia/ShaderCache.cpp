@@ -82,11 +82,34 @@ void ShaderCache::initShaderDiskCache(const void* identity, ssize_t size) {
     // Emulators can switch between different renders either as part of config
     // or snapshot migration. Also, program binaries may not work well on some
     // desktop / laptop GPUs. Thus, disable the shader disk cache for emulator builds.
-    if (!Properties::runningInEmulator && mFilename.length() > 0) {
-        mBlobCache.reset(new FileBlobCache(maxKeySize, maxValueSize, maxTotalSize, mFilename));
-        validateCache(identity, size);
-        mInitialized = true;
+    if (Properties::runningInEmulator || mFilename.length() == 0 || mInitPending) {
+        return;
+    }
+
+    // Read and validate the cache file off the render thread; the first load or
+    // store blocks on mInitCondition instead. Skia asks for the Vulkan pipeline
+    // cache blob through load() when it first builds pipeline state, so by then
+    // the data is (usually) already in memory.
+    std::vector<uint8_t> identityCopy;
+    if (identity != nullptr && size > 0) {
+        identityCopy.assign(static_cast<const uint8_t*>(identity),
+                            static_cast<const uint8_t*>(identity) + size);
     }
+    mInitPending = true;
+    std::thread initThread([this, identityCopy = std::move(identityCopy), size,
+                            filename = mFilename]() {
+        ATRACE_NAME("ShaderCache::initThread");
+        // The file read happens in the FileBlobCache constructor, outside the lock.
+        std::unique_ptr<FileBlobCache> blobCache(
+                new FileBlobCache(maxKeySize, maxValueSize, maxTotalSize, filename));
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBlobCache = std::move(blobCache);
+        validateCache(identityCopy.empty() ? nullptr : identityCopy.data(), size);
+        mInitialized = true;
+        mInitPending = false;
+        mInitCondition.notify_all();
+    });
+    initThread.detach();
 }
 
 void ShaderCache::setFilename(const char* filename) {
@@ -102,7 +125,8 @@ BlobCache* ShaderCache::getBlobCacheLocked() {
 sk_sp<SkData> ShaderCache::load(const SkData& key) {
     ATRACE_NAME("ShaderCache::load");
     size_t keySize = key.size();
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mInitCondition.wait(lock, [this] { return !mInitPending; });
     if (!mInitialized) {
         return nullptr;
     }
@@ -153,7 +177,8 @@ void ShaderCache::saveToDiskLocked() {
 
 void ShaderCache::store(const SkData& key, const SkData& data) {
     ATRACE_NAME("ShaderCache::store");
-    std::lock_guard<std::mutex> lock(mMutex);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mInitCondition.wait(lock, [this] { return !mInitPending; });
 
     if (!mInitialized) {
         return;
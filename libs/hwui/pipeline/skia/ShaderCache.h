@@ -18,6 +18,7 @@
 
 #include <GrContextOptions.h>
 #include <cutils/compiler.h>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -48,6 +49,12 @@ public:
      * no data. If size is less than zero, the cache is initilaized but
      * contains no data.
      *
+     * The disk read and validation happen on a worker thread so the render
+     * thread is not blocked on I/O during pipeline construction; the first
+     * load or store waits for that work to finish. This matters most for the
+     * Vulkan pipeline cache blob, which Skia pulls through "load" while
+     * building its VkPipelineCache.
+     *
      * This should be called when HWUI pipeline is initialized. When not in
      * the initialized state the load and store methods will return without
      * performing any cache operations.
@@ -121,6 +128,16 @@ private:
      */
     bool mInitialized = false;
 
+    /**
+     * "mInitPending" is true while the worker thread spawned by
+     * initShaderDiskCache is reading and validating the cache file. The
+     * load/store methods wait on "mInitCondition" instead of skipping the
+     * cache while this is set.
+     */
+    bool mInitPending = false;
+
+    std::condition_variable mInitCondition;
+
     /**
      * "mBlobCache" is the cache in which the key/value blob pairs are stored.  It
      * is initially NULL, and will be initialized by getBlobCacheLocked the
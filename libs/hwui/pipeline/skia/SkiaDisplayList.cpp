@@ -20,9 +20,12 @@
 #include "SkiaPipeline.h"
 #include "VectorDrawable.h"
 #include "renderthread/CanvasContext.h"
+#include "thread/CommonPool.h"
 
 #include <SkImagePriv.h>
 #include <SkPathOps.h>
+#include <SkSurface.h>
+#include <SkTextBlob.h>
 
 namespace android {
 namespace uirenderer {
@@ -40,6 +43,52 @@ void SkiaDisplayList::syncContents(const WebViewSyncData& data) {
     }
 }
 
+bool SkiaDisplayList::hasSameContentAs(const SkiaDisplayList& staging) const {
+    // The emptiness checks are redundant with the byte comparison (the ops
+    // recorded for these drawables embed allocator-owned pointers that differ
+    // between recordings) but they reject the common mismatch cases before we
+    // touch either op buffer.
+    if (!mChildNodes.empty() || !staging.mChildNodes.empty() || !mChildFunctors.empty() ||
+        !staging.mChildFunctors.empty() || !mAnimatedImages.empty() ||
+        !staging.mAnimatedImages.empty()) {
+        return false;
+    }
+    return mDisplayList.hasSameBytes(staging.mDisplayList);
+}
+
+void SkiaDisplayList::prewarmContent() {
+    if (!hasText()) {
+        return;
+    }
+    // The blob refs keep the glyph data alive even if this list is destroyed
+    // before the task runs; the paints are copied because the interned table
+    // can be rewritten by a force-dark pass in the meantime.
+    std::vector<std::pair<sk_sp<const SkTextBlob>, SkPaint>> blobs;
+    mDisplayList.forEachTextBlob([&blobs](const SkTextBlob* blob, const SkPaint& paint) {
+        blobs.emplace_back(sk_ref_sp(blob), paint);
+    });
+    CommonPool::post([blobs = std::move(blobs)]() {
+        // Drawing into a throwaway raster surface rasterizes each glyph mask
+        // into the shared strike cache, which the GPU text path consults
+        // before generating masks for atlas upload. SDF-rendered large text
+        // uses differently keyed strikes and still rasterizes on first draw.
+        sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(1, 1);
+        if (!surface) {
+            return;
+        }
+        SkCanvas* canvas = surface->getCanvas();
+        for (const auto& entry : blobs) {
+            const SkRect& bounds = entry.first->bounds();
+            // Translate the blob onto the surface; a draw that is entirely
+            // clipped out would be rejected before touching any glyphs.
+            canvas->save();
+            canvas->translate(-bounds.fLeft, -bounds.fTop);
+            canvas->drawTextBlob(entry.first.get(), 0, 0, entry.second);
+            canvas->restore();
+        }
+    });
+}
+
 bool SkiaDisplayList::reuseDisplayList(RenderNode* node, renderthread::CanvasContext* context) {
     reset();
     node->attachAvailableList(this);
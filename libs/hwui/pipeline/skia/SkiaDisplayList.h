@@ -90,6 +90,25 @@ public:
 
     bool hasText() const { return mDisplayList.hasText(); }
 
+    /**
+     * Returns true if a freshly recorded staging list produced exactly the
+     * same op stream as this one, meaning the RenderNode can keep drawing from
+     * this list (and whatever GPU resources Skia has cached for it) instead of
+     * swapping in the staging copy. Drawables for child nodes, functors and
+     * animated content live in each list's own allocator, so their ops can
+     * never byte-match across recordings; only leaf content can be reused.
+     */
+    bool hasSameContentAs(const SkiaDisplayList& staging) const;
+
+    /**
+     * Hands this list's text blobs to a background task that rasterizes their
+     * glyph masks into the process-wide strike cache, so the render thread's
+     * first draw finds them ready for atlas upload instead of rasterizing
+     * inline. Called when a freshly recorded list is installed on a
+     * RenderNode; a no-op for lists without text.
+     */
+    void prewarmContent();
+
     /**
      * Attempts to reset and reuse this DisplayList.
      *
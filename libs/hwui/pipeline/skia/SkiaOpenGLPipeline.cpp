@@ -17,6 +17,7 @@
 #include "SkiaOpenGLPipeline.h"
 
 #include "DeferredLayerUpdater.h"
+#include "GLFunctorDrawable.h"
 #include "LayerDrawable.h"
 #include "SkiaPipeline.h"
 #include "SkiaProfileRenderer.h"
@@ -28,6 +29,7 @@
 #include "utils/GLUtils.h"
 #include "utils/TraceUtils.h"
 
+#include <GLES2/gl2ext.h>
 #include <GLES3/gl3.h>
 
 #include <GrBackendSurface.h>
@@ -35,6 +37,7 @@
 #include <SkImageInfo.h>
 
 #include <cutils/properties.h>
+#include <string.h>
 #include <strings.h>
 
 using namespace android::uirenderer::renderthread;
@@ -69,12 +72,17 @@ Frame SkiaOpenGLPipeline::getFrame() {
 }
 
 bool SkiaOpenGLPipeline::draw(const Frame& frame, const SkRect& screenDirty, const SkRect& dirty,
+                              const LsaVector<SkRect>& dirtyRegion,
                               const LightGeometry& lightGeometry,
                               LayerUpdateQueue* layerUpdateQueue, const Rect& contentDrawBounds,
                               bool opaque, const LightInfo& lightInfo,
                               const std::vector<sp<RenderNode>>& renderNodes,
                               FrameInfoVisualizer* profiler) {
-    mEglManager.damageFrame(frame, dirty);
+    mEglManager.damageFrame(frame, dirty, dirtyRegion);
+
+    SkIRect frameDamage;
+    dirty.roundOut(&frameDamage);
+    GLFunctorDrawable::setCurrentFrameInfo(frameDamage, frame.bufferAge());
 
     SkColorType colorType = getSurfaceColorType();
     // setup surface for fbo0
@@ -100,8 +108,10 @@ bool SkiaOpenGLPipeline::draw(const Frame& frame, const SkRect& screenDirty, con
             mSurfaceColorSpace, &props));
 
     SkiaPipeline::updateLighting(lightGeometry, lightInfo);
+    startGpuFrameTimer();
     renderFrame(*layerUpdateQueue, dirty, renderNodes, opaque, contentDrawBounds, surface,
-                SkMatrix::I());
+                SkMatrix::I(), &dirtyRegion);
+    stopGpuFrameTimer();
     layerUpdateQueue->clear();
 
     // Draw visual debugging features
@@ -128,6 +138,9 @@ bool SkiaOpenGLPipeline::swapBuffers(const Frame& frame, bool drew, const SkRect
     // Even if we decided to cancel the frame, from the perspective of jank
     // metrics the frame was swapped at this point
     currentFrameInfo->markSwapBuffers();
+    // Attribute the most recently resolved GPU measurement so traces can
+    // separate driver load from CPU-side overruns; see startGpuFrameTimer().
+    currentFrameInfo->set(FrameInfoIndex::GpuDuration) = mLastGpuFrameTime;
 
     *requireSwap = drew || mEglManager.damageRequiresSwap();
 
@@ -144,12 +157,76 @@ DeferredLayerUpdater* SkiaOpenGLPipeline::createTextureLayer() {
 }
 
 void SkiaOpenGLPipeline::onContextDestroyed() {
+    if (mGpuTimerState == GpuTimerState::Ready) {
+        glDeleteQueriesEXT(kGpuTimerQueryCount, mGpuTimerQueries);
+        for (int i = 0; i < kGpuTimerQueryCount; i++) {
+            mGpuTimerQueryPending[i] = false;
+        }
+        mGpuTimerHead = mGpuTimerTail = 0;
+        mGpuTimerRecording = false;
+        mGpuTimerState = GpuTimerState::Uninitialized;
+    }
     if (mEglSurface != EGL_NO_SURFACE) {
         mEglManager.destroySurface(mEglSurface);
         mEglSurface = EGL_NO_SURFACE;
     }
 }
 
+void SkiaOpenGLPipeline::startGpuFrameTimer() {
+    if (mGpuTimerState == GpuTimerState::Uninitialized) {
+        auto extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+        if (extensions && strstr(extensions, "GL_EXT_disjoint_timer_query")) {
+            glGenQueriesEXT(kGpuTimerQueryCount, mGpuTimerQueries);
+            mGpuTimerState = GpuTimerState::Ready;
+        } else {
+            mGpuTimerState = GpuTimerState::Unsupported;
+        }
+    }
+    if (mGpuTimerState != GpuTimerState::Ready) {
+        return;
+    }
+    pollGpuFrameTimers();
+    if (mGpuTimerQueryPending[mGpuTimerHead]) {
+        // Every slot is still in flight; skip instrumenting this frame
+        // rather than stall waiting on the driver.
+        return;
+    }
+    glBeginQueryEXT(GL_TIME_ELAPSED_EXT, mGpuTimerQueries[mGpuTimerHead]);
+    mGpuTimerRecording = true;
+}
+
+void SkiaOpenGLPipeline::stopGpuFrameTimer() {
+    if (!mGpuTimerRecording) {
+        return;
+    }
+    glEndQueryEXT(GL_TIME_ELAPSED_EXT);
+    mGpuTimerRecording = false;
+    mGpuTimerQueryPending[mGpuTimerHead] = true;
+    mGpuTimerHead = (mGpuTimerHead + 1) % kGpuTimerQueryCount;
+}
+
+void SkiaOpenGLPipeline::pollGpuFrameTimers() {
+    while (mGpuTimerQueryPending[mGpuTimerTail]) {
+        GLuint available = 0;
+        glGetQueryObjectuivEXT(mGpuTimerQueries[mGpuTimerTail], GL_QUERY_RESULT_AVAILABLE_EXT,
+                               &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64vEXT(mGpuTimerQueries[mGpuTimerTail], GL_QUERY_RESULT_EXT, &elapsed);
+        // A disjoint event (context switch, power transition) makes the
+        // measurement meaningless; keep the previous value in that case.
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+        if (!disjoint) {
+            mLastGpuFrameTime = static_cast<nsecs_t>(elapsed);
+        }
+        mGpuTimerQueryPending[mGpuTimerTail] = false;
+        mGpuTimerTail = (mGpuTimerTail + 1) % kGpuTimerQueryCount;
+    }
+}
+
 void SkiaOpenGLPipeline::onStop() {
     if (mEglManager.isCurrent(mEglSurface)) {
         mEglManager.makeCurrent(EGL_NO_SURFACE);
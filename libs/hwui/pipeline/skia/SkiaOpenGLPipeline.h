@@ -35,6 +35,7 @@ public:
     renderthread::MakeCurrentResult makeCurrent() override;
     renderthread::Frame getFrame() override;
     bool draw(const renderthread::Frame& frame, const SkRect& screenDirty, const SkRect& dirty,
+              const LsaVector<SkRect>& dirtyRegion,
               const LightGeometry& lightGeometry, LayerUpdateQueue* layerUpdateQueue,
               const Rect& contentDrawBounds, bool opaque, const LightInfo& lightInfo,
               const std::vector<sp<RenderNode> >& renderNodes,
@@ -55,9 +56,29 @@ protected:
     void onContextDestroyed() override;
 
 private:
+    // GPU frame timing via GL_EXT_disjoint_timer_query. A small ring of
+    // queries brackets renderFrame() each frame and is polled without
+    // blocking, so the duration folded into FrameInfo belongs to the most
+    // recently completed frame rather than the one being recorded.
+    void startGpuFrameTimer();
+    void stopGpuFrameTimer();
+    void pollGpuFrameTimers();
+
+    static constexpr int kGpuTimerQueryCount = 4;
+
+    enum class GpuTimerState { Uninitialized, Unsupported, Ready };
+
     renderthread::EglManager& mEglManager;
     EGLSurface mEglSurface = EGL_NO_SURFACE;
     bool mBufferPreserved = false;
+
+    GpuTimerState mGpuTimerState = GpuTimerState::Uninitialized;
+    uint32_t mGpuTimerQueries[kGpuTimerQueryCount] = {0, 0, 0, 0};
+    bool mGpuTimerQueryPending[kGpuTimerQueryCount] = {false, false, false, false};
+    int mGpuTimerHead = 0;  // next query slot to begin
+    int mGpuTimerTail = 0;  // oldest in-flight query slot
+    bool mGpuTimerRecording = false;
+    nsecs_t mLastGpuFrameTime = 0;
 };
 
 } /* namespace skiapipeline */
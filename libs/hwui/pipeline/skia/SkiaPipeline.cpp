@@ -23,6 +23,7 @@
 #include <SkOverdrawColorFilter.h>
 #include <SkPicture.h>
 #include <SkPictureRecorder.h>
+#include <SkRegion.h>
 #include "TreeInfo.h"
 #include "VectorDrawable.h"
 #include "thread/CommonPool.h"
@@ -92,7 +93,9 @@ void SkiaPipeline::renderLayers(const LightGeometry& lightGeometry,
 void SkiaPipeline::renderLayersImpl(const LayerUpdateQueue& layers, bool opaque) {
     sk_sp<GrContext> cachedContext;
 
-    // Render all layers that need to be updated, in order.
+    // Render all layers that need to be updated, in order. The entries were
+    // enqueued post-order during prepare, so a child layer is always repainted
+    // before any parent layer that draws it.
     for (size_t i = 0; i < layers.entries().size(); i++) {
         RenderNode* layerNode = layers.entries()[i].renderNode.get();
         // only schedule repaint if node still on layer - possible it may have been
@@ -103,7 +106,7 @@ void SkiaPipeline::renderLayersImpl(const LayerUpdateQueue& layers, bool opaque)
             SkiaDisplayList* displayList = (SkiaDisplayList*)layerNode->getDisplayList();
             if (!displayList || displayList->isEmpty()) {
                 SkDEBUGF(("%p drawLayers(%s) : missing drawable", layerNode, layerNode->getName()));
-                return;
+                continue;
             }
 
             const Rect& layerDamage = layers.entries()[i].damage;
@@ -113,18 +116,24 @@ void SkiaPipeline::renderLayersImpl(const LayerUpdateQueue& layers, bool opaque)
             int saveCount = layerCanvas->save();
             SkASSERT(saveCount == 1);
 
+            // Restricting the device clip to the damage makes the clear and
+            // the redraw below partial: pixels outside the damage keep their
+            // previous contents.
             layerCanvas->androidFramework_setDeviceClipRestriction(layerDamage.toSkIRect());
 
-            auto savedLightCenter = mLightCenter;
-            // map current light center into RenderNode's coordinate space
-            layerNode->getSkiaLayer()->inverseTransformInWindow.mapPoint3d(mLightCenter);
-
             const RenderProperties& properties = layerNode->properties();
             const SkRect bounds = SkRect::MakeWH(properties.getWidth(), properties.getHeight());
             if (properties.getClipToBounds() && layerCanvas->quickReject(bounds)) {
-                return;
+                // Damage fell entirely outside the content; skip this layer
+                // without abandoning the rest of the queue.
+                layerCanvas->restoreToCount(saveCount);
+                continue;
             }
 
+            auto savedLightCenter = mLightCenter;
+            // map current light center into RenderNode's coordinate space
+            layerNode->getSkiaLayer()->inverseTransformInWindow.mapPoint3d(mLightCenter);
+
             ATRACE_FORMAT("drawLayer [%s] %.1f x %.1f", layerNode->getName(), bounds.width(),
                           bounds.height());
 
@@ -292,7 +301,8 @@ void SkiaPipeline::endCapture(SkSurface* surface) {
 void SkiaPipeline::renderFrame(const LayerUpdateQueue& layers, const SkRect& clip,
                                const std::vector<sp<RenderNode>>& nodes, bool opaque,
                                const Rect& contentDrawBounds, sk_sp<SkSurface> surface,
-                               const SkMatrix& preTransform) {
+                               const SkMatrix& preTransform,
+                               const LsaVector<SkRect>* dirtyRegion) {
     bool previousSkpEnabled = Properties::skpCaptureEnabled;
     if (mPictureCapturedCallback) {
         Properties::skpCaptureEnabled = true;
@@ -308,7 +318,8 @@ void SkiaPipeline::renderFrame(const LayerUpdateQueue& layers, const SkRect& cli
     std::unique_ptr<SkPictureRecorder> recorder;
     SkCanvas* canvas = tryCapture(surface.get());
 
-    renderFrameImpl(layers, clip, nodes, opaque, contentDrawBounds, canvas, preTransform);
+    renderFrameImpl(layers, clip, nodes, opaque, contentDrawBounds, canvas, preTransform,
+                    dirtyRegion);
 
     endCapture(surface.get());
 
@@ -332,9 +343,19 @@ static Rect nodeBounds(RenderNode& node) {
 void SkiaPipeline::renderFrameImpl(const LayerUpdateQueue& layers, const SkRect& clip,
                                    const std::vector<sp<RenderNode>>& nodes, bool opaque,
                                    const Rect& contentDrawBounds, SkCanvas* canvas,
-                                   const SkMatrix& preTransform) {
+                                   const SkMatrix& preTransform,
+                                   const LsaVector<SkRect>* dirtyRegion) {
     SkAutoCanvasRestore saver(canvas, true);
     canvas->androidFramework_setDeviceClipRestriction(preTransform.mapRect(clip).roundOut());
+    if (dirtyRegion && dirtyRegion->size() > 1) {
+        // Clip to the individual damage rects so two small, distant updates
+        // don't force a repaint of everything between them.
+        SkRegion clipRegion;
+        for (const SkRect& rect : *dirtyRegion) {
+            clipRegion.op(preTransform.mapRect(rect).roundOut(), SkRegion::kUnion_Op);
+        }
+        canvas->clipRegion(clipRegion);
+    }
     canvas->concat(preTransform);
 
     // STOPSHIP: Revert, temporary workaround to clear always F16 frame buffer for b/74976293
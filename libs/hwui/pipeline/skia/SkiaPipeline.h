@@ -49,10 +49,14 @@ public:
     SkColorType getSurfaceColorType() const override { return mSurfaceColorType; }
     sk_sp<SkColorSpace> getSurfaceColorSpace() override { return mSurfaceColorSpace; }
 
+    // When dirtyRegion holds two or more rects the frame content is clipped
+    // to their union as a region, so disjoint damage doesn't repaint the area
+    // in between; clip remains the overall scissor/damage bounds.
     void renderFrame(const LayerUpdateQueue& layers, const SkRect& clip,
                      const std::vector<sp<RenderNode>>& nodes, bool opaque,
                      const Rect& contentDrawBounds, sk_sp<SkSurface> surface,
-                     const SkMatrix& preTransform);
+                     const SkMatrix& preTransform,
+                     const LsaVector<SkRect>* dirtyRegion = nullptr);
 
     std::vector<VectorDrawableRoot*>* getVectorDrawables() { return &mVectorDrawables; }
 
@@ -120,7 +124,8 @@ private:
     void renderFrameImpl(const LayerUpdateQueue& layers, const SkRect& clip,
                          const std::vector<sp<RenderNode>>& nodes, bool opaque,
                          const Rect& contentDrawBounds, SkCanvas* canvas,
-                         const SkMatrix& preTransform);
+                         const SkMatrix& preTransform,
+                         const LsaVector<SkRect>* dirtyRegion = nullptr);
 
     /**
      *  Debugging feature.  Draws a semi-transparent overlay on each pixel, indicating
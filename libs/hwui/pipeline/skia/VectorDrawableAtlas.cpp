@@ -45,6 +45,11 @@ void VectorDrawableAtlas::prepareForDraw(GrContext* context) {
             if (isFragmented()) {
                 // Invoke repack outside renderFrame to avoid jank.
                 renderthread::RenderProxy::repackVectorDrawableAtlas();
+            } else if (isUnderutilized() && !mIdleDefragScheduled) {
+                // Not bad enough to force a repack, but worth compacting once
+                // the thread has no frame work pending.
+                mIdleDefragScheduled = true;
+                renderthread::RenderProxy::defragVectorDrawableAtlas();
             }
         }
     }
@@ -52,12 +57,49 @@ void VectorDrawableAtlas::prepareForDraw(GrContext* context) {
 
 #define MAX_CONSECUTIVE_FAILURES 5
 #define MAX_UNUSED_RATIO 2.0f
+// A more relaxed ratio used only for idle-time compaction, where the repack
+// cost cannot cause jank. The absolute floor avoids repacking over trivia.
+#define IDLE_DEFRAG_UNUSED_RATIO 1.25f
+#define IDLE_DEFRAG_MIN_UNUSED_FRACTION 8
 
 bool VectorDrawableAtlas::isFragmented() {
     return mConsecutiveFailures > MAX_CONSECUTIVE_FAILURES &&
            mPixelUsedByVDs * MAX_UNUSED_RATIO < mPixelAllocated;
 }
 
+bool VectorDrawableAtlas::isUnderutilized() {
+    return !mRects.empty() && mPixelUsedByVDs * IDLE_DEFRAG_UNUSED_RATIO < mPixelAllocated &&
+           mPixelAllocated - mPixelUsedByVDs > (mWidth * mHeight) / IDLE_DEFRAG_MIN_UNUSED_FRACTION;
+}
+
+void VectorDrawableAtlas::idleDefrag(GrContext* context, bool threadIsIdle) {
+    mIdleDefragScheduled = false;
+    if (!threadIsIdle) {
+        // A frame is in flight or scheduled; the next prepareForDraw will
+        // re-arm the task if compaction is still worthwhile.
+        return;
+    }
+    if (mSurface && isUnderutilized()) {
+        repack(context);
+        // Hand the surface we just replaced (and any other scratch memory)
+        // back to the GPU while nobody is waiting on the thread.
+        context->purgeUnlockedResources(true);
+    }
+}
+
+VectorDrawableAtlas::Stats VectorDrawableAtlas::getStats() const {
+    Stats stats;
+    stats.pixelsUsedByVDs = mPixelUsedByVDs;
+    stats.pixelsAllocated = mPixelAllocated;
+    stats.entryCount = mRects.size();
+    for (const CacheEntry& entry : mRects) {
+        if (entry.surface) {
+            stats.standaloneCount++;
+        }
+    }
+    return stats;
+}
+
 void VectorDrawableAtlas::repackIfNeeded(GrContext* context) {
     // We repackage when atlas failed to allocate space MAX_CONSECUTIVE_FAILURES consecutive
     // times and the atlas allocated pixels are at least MAX_UNUSED_RATIO times higher than pixels
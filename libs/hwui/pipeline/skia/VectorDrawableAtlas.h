@@ -82,6 +82,32 @@ public:
      */
     bool isFragmented();
 
+    /**
+     * Returns true if the atlas has accumulated enough unused allocated space
+     * to make an idle-time compaction worthwhile, even though it is not yet
+     * fragmented enough to force a repack.
+     */
+    bool isUnderutilized();
+
+    /**
+     * "idleDefrag" is invoked on the render thread by a delayed task scheduled
+     * from "prepareForDraw". It compacts the atlas only if the thread is still
+     * idle; otherwise the next frame's "prepareForDraw" re-arms the task.
+     */
+    void idleDefrag(GrContext* context, bool threadIsIdle);
+
+    struct Stats {
+        size_t pixelsUsedByVDs = 0;
+        size_t pixelsAllocated = 0;
+        size_t entryCount = 0;
+        size_t standaloneCount = 0;
+    };
+
+    /**
+     * Snapshot of occupancy and fragmentation counters for dumpsys.
+     */
+    Stats getStats() const;
+
     /**
      * "requestNewEntry" is called by VectorDrawable to allocate a new rectangle area from the atlas
      * or create a standalone surface if atlas is full.
@@ -178,6 +204,12 @@ private:
      */
     int mConsecutiveFailures = 0;
 
+    /**
+     * True while an idle defragmentation task is queued, so "prepareForDraw"
+     * does not schedule another one every frame.
+     */
+    bool mIdleDefragScheduled = false;
+
     /**
      * mStorageMode allows using a shared surface to store small vector drawables.
      * Using a shared surface can boost the performance by allowing GL ops to be batched, but may
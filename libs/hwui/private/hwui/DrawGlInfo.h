@@ -46,6 +46,18 @@ struct DrawGlInfo {
     // Input: Color space.
     const SkColorSpace* color_space_ptr;
 
+    // Input: damage bounds of the current frame in surface coordinates, and
+    // the age of the destination buffer in frames. A bufferAge of 0 means the
+    // buffer contents are undefined and everything must be redrawn; when the
+    // age is known, content outside the damage bounds is preserved from an
+    // earlier frame and the functor may limit its raster and composite work
+    // to the damage.
+    int damageLeft = 0;
+    int damageTop = 0;
+    int damageRight = 0;
+    int damageBottom = 0;
+    int bufferAge = 0;
+
     // Output: dirty region to redraw
     float dirtyLeft;
     float dirtyTop;
@@ -16,6 +16,7 @@
 
 #include "CacheManager.h"
 
+#include "GpuMemoryTracker.h"
 #include "Layer.h"
 #include "Properties.h"
 #include "RenderThread.h"
@@ -30,7 +31,9 @@
 #include <SkMathPriv.h>
 #include <gui/Surface.h>
 #include <math.h>
+#include <algorithm>
 #include <set>
+#include <sstream>
 
 namespace android {
 namespace uirenderer {
@@ -42,6 +45,10 @@ namespace renderthread {
 // be ARGB_8888.
 #define SURFACE_SIZE_MULTIPLIER (12.0f * 4.0f)
 #define BACKGROUND_RETENTION_PERCENTAGE (0.5f)
+// Fraction of the resource cache budget we consider acceptable for scratch
+// (purgeable) resources to occupy before the scratch tier counts as over
+// budget in the tiered trim policy.
+#define SCRATCH_BUDGET_PERCENTAGE (0.25f)
 
 CacheManager::CacheManager(const DisplayInfo& display)
         : mMaxSurfaceArea(display.w * display.h)
@@ -58,6 +65,10 @@ CacheManager::CacheManager(const DisplayInfo& display)
 
     SkGraphics::SetFontCacheLimit(mMaxCpuFontCacheBytes);
 
+    mTierStats[kTierScratch].budgetBytes = mMaxResourceBytes * SCRATCH_BUDGET_PERCENTAGE;
+    mTierStats[kTierResource].budgetBytes = mMaxResourceBytes;
+    mTierStats[kTierFont].budgetBytes = mMaxCpuFontCacheBytes;
+
     mVectorDrawableAtlas = new skiapipeline::VectorDrawableAtlas(
             mMaxSurfaceArea / 2,
             skiapipeline::VectorDrawableAtlas::StorageMode::disallowSharedSurface);
@@ -102,6 +113,64 @@ void CacheManager::configureContext(GrContextOptions* contextOptions, const void
     contextOptions->fGpuPathRenderers &= ~GpuPathRenderers::kCoverageCounting;
 }
 
+const char* CacheManager::tierName(CacheTier tier) {
+    switch (tier) {
+        case kTierScratch:
+            return "Scratch";
+        case kTierResource:
+            return "Resources";
+        case kTierFont:
+            return "Font";
+        default:
+            return "Unknown";
+    }
+}
+
+void CacheManager::sampleTierStats() {
+    if (!mGrContext) {
+        return;
+    }
+    size_t resourceBytes = 0;
+    mGrContext->getResourceCacheUsage(nullptr, &resourceBytes);
+    const size_t purgeableBytes =
+            std::min(mGrContext->getResourceCachePurgeableBytes(), resourceBytes);
+    const size_t used[kTierCount] = {
+            purgeableBytes,                  // kTierScratch
+            resourceBytes - purgeableBytes,  // kTierResource
+            SkGraphics::GetFontCacheUsed(),  // kTierFont
+    };
+    const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    for (int i = 0; i < kTierCount; i++) {
+        if (used[i] > mTierStats[i].usedBytes || mTierStats[i].lastGrowthTime == 0) {
+            mTierStats[i].lastGrowthTime = now;
+        }
+        mTierStats[i].usedBytes = used[i];
+    }
+}
+
+void CacheManager::trimTier(CacheTier tier) {
+    switch (tier) {
+        case kTierScratch:
+            // Scratch resources hold no persistent data, so dropping all of
+            // the unlocked ones is cheap to recover from.
+            mGrContext->purgeUnlockedResources(true);
+            break;
+        case kTierResource:
+            // Toggling the limits purges unlocked resources with persistent
+            // data in LRU order down to the background budget.
+            mGrContext->setResourceCacheLimits(mMaxResources, mBackgroundResourceBytes);
+            mGrContext->setResourceCacheLimits(mMaxResources, mMaxResourceBytes);
+            break;
+        case kTierFont:
+            SkGraphics::SetFontCacheLimit(mBackgroundCpuFontCacheBytes);
+            SkGraphics::SetFontCacheLimit(mMaxCpuFontCacheBytes);
+            break;
+        default:
+            break;
+    }
+    mTierStats[tier].trimCount++;
+}
+
 void CacheManager::trimMemory(TrimMemoryMode mode) {
     if (!mGrContext) {
         return;
@@ -115,6 +184,31 @@ void CacheManager::trimMemory(TrimMemoryMode mode) {
             mGrContext->freeGpuResources();
             SkGraphics::PurgeAllCaches();
             break;
+        case TrimMemoryMode::Moderate: {
+            // Release tiers starting with the one whose usage grew least
+            // recently, and stop as soon as the total fits in the background
+            // budget. Hot tiers keep their contents unless the cold ones
+            // alone cannot free enough.
+            sampleTierStats();
+            CacheTier order[kTierCount] = {kTierScratch, kTierResource, kTierFont};
+            std::sort(order, order + kTierCount, [this](CacheTier a, CacheTier b) {
+                return mTierStats[a].lastGrowthTime < mTierStats[b].lastGrowthTime;
+            });
+            const size_t backgroundBudget =
+                    mBackgroundResourceBytes + mBackgroundCpuFontCacheBytes;
+            for (CacheTier tier : order) {
+                trimTier(tier);
+                sampleTierStats();
+                size_t totalUsed = 0;
+                for (int i = 0; i < kTierCount; i++) {
+                    totalUsed += mTierStats[i].usedBytes;
+                }
+                if (totalUsed <= backgroundBudget) {
+                    break;
+                }
+            }
+            break;
+        }
         case TrimMemoryMode::UiHidden:
             // Here we purge all the unlocked scratch resources and then toggle the resources cache
             // limits between the background and max amounts. This causes the unlocked resources
@@ -178,8 +272,13 @@ void CacheManager::dumpMemoryUsage(String8& log, const RenderState* renderState)
 
     log.appendFormat("Other Caches:\n");
     log.appendFormat("                         Current / Maximum\n");
-    log.appendFormat("  VectorDrawableAtlas  %6.2f kB / %6.2f KB (entries = %zu)\n", 0.0f, 0.0f,
-                     (size_t)0);
+    const auto atlasStats = mVectorDrawableAtlas->getStats();
+    // Atlas surfaces are N32, so 4 bytes per pixel. The gap between the two
+    // numbers is the fragmentation the idle defrag pass works to reclaim.
+    log.appendFormat("  VectorDrawableAtlas  %6.2f kB / %6.2f KB (entries = %zu, standalone = %zu)\n",
+                     atlasStats.pixelsUsedByVDs * 4 / 1024.0f,
+                     atlasStats.pixelsAllocated * 4 / 1024.0f, atlasStats.entryCount,
+                     atlasStats.standaloneCount);
 
     if (renderState) {
         if (renderState->mActiveLayers.size() > 0) {
@@ -201,8 +300,24 @@ void CacheManager::dumpMemoryUsage(String8& log, const RenderState* renderState)
                          layerMemoryTotal / 1024.0f, renderState->mActiveLayers.size());
     }
 
+    sampleTierStats();
+    const nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+    log.appendFormat("Trim policy:\n");
+    log.appendFormat("                         Current / Budget\n");
+    for (int i = 0; i < kTierCount; i++) {
+        const TierStats& stats = mTierStats[i];
+        log.appendFormat("  %-12s %8.2f kB / %8.2f kB (trims = %d, last growth %.1fs ago)\n",
+                         tierName(static_cast<CacheTier>(i)), stats.usedBytes / 1024.0f,
+                         stats.budgetBytes / 1024.0f, stats.trimCount,
+                         stats.lastGrowthTime ? (now - stats.lastGrowthTime) / 1e9f : 0.0f);
+    }
+
     log.appendFormat("Total GPU memory usage:\n");
     gpuTracer.logTotals(log);
+
+    std::stringstream snapshots;
+    GpuMemoryTracker::dumpSnapshots(snapshots);
+    log.appendFormat("%s", snapshots.str().c_str());
 }
 
 } /* namespace renderthread */
@@ -21,6 +21,7 @@
 #include <SkSurface.h>
 #include <ui/DisplayInfo.h>
 #include <utils/String8.h>
+#include <utils/Timers.h>
 #include <vector>
 
 #include "pipeline/skia/VectorDrawableAtlas.h"
@@ -40,7 +41,7 @@ class RenderThread;
 
 class CacheManager {
 public:
-    enum class TrimMemoryMode { Complete, UiHidden };
+    enum class TrimMemoryMode { Complete, Moderate, UiHidden };
 
     void configureContext(GrContextOptions* context, const void* identity, ssize_t size);
     void trimMemory(TrimMemoryMode mode);
@@ -60,6 +61,25 @@ private:
     void reset(sk_sp<GrContext> grContext);
     void destroy();
 
+    /**
+     * The caches we manage fall into three tiers, each with its own byte
+     * budget. Under moderate pressure we release the coldest tier first (the
+     * one whose usage grew least recently) instead of purging everything,
+     * which keeps hot caches warm on memory-constrained devices.
+     */
+    enum CacheTier { kTierScratch = 0, kTierResource, kTierFont, kTierCount };
+
+    struct TierStats {
+        size_t budgetBytes = 0;
+        size_t usedBytes = 0;
+        nsecs_t lastGrowthTime = 0;
+        int trimCount = 0;
+    };
+
+    static const char* tierName(CacheTier tier);
+    void sampleTierStats();
+    void trimTier(CacheTier tier);
+
     const size_t mMaxSurfaceArea;
     sk_sp<GrContext> mGrContext;
 
@@ -77,6 +97,8 @@ private:
     };
 
     sp<skiapipeline::VectorDrawableAtlas> mVectorDrawableAtlas;
+
+    TierStats mTierStats[kTierCount];
 };
 
 } /* namespace renderthread */
@@ -46,6 +46,7 @@
 #include <functional>
 
 #define TRIM_MEMORY_COMPLETE 80
+#define TRIM_MEMORY_MODERATE 60
 #define TRIM_MEMORY_UI_HIDDEN 20
 
 #define LOG_FRAMETIME_MMA 0
@@ -310,6 +311,11 @@ void CanvasContext::prepareTree(TreeInfo& info, int64_t* uiFrameInfo, int64_t sy
 
     mAnimationContext->startFrame(info.mode);
     mRenderPipeline->onPrepareTree();
+    // Note: the roots are prepared serially on purpose, even when several
+    // independent trees are registered. Each walk feeds shared render-thread
+    // state -- layer creation against the GrContext, the layer update queue,
+    // image pinning, and tree-observer node destruction -- none of which can
+    // be touched from a worker thread without a much deeper restructuring.
     for (const sp<RenderNode>& node : mRenderNodes) {
         // Only the primary target node will be drawn full - all other nodes would get drawn in
         // real time mode. In case of a window, the primary node is the window content and the other
@@ -432,7 +438,10 @@ void CanvasContext::setPresentTime() {
 
 void CanvasContext::draw() {
     SkRect dirty;
-    mDamageAccumulator.finish(&dirty);
+    // Built from the frame arena: the region lives exactly as long as this
+    // frame and its backing memory is reclaimed by the driver's rewind.
+    LsaVector<SkRect> dirtyRegion(LinearStdAllocator<SkRect>(mRenderThread.frameArena()));
+    mDamageAccumulator.finish(&dirty, &dirtyRegion);
 
     if (dirty.isEmpty() && Properties::skipEmptyFrames && !surfaceRequiresRedraw()) {
         mCurrentFrameInfo->addFlag(FrameInfoFlags::SkippedFrame);
@@ -444,11 +453,18 @@ void CanvasContext::draw() {
     Frame frame = mRenderPipeline->getFrame();
     setPresentTime();
 
+    const SkRect reportedDirty = dirty;
     SkRect windowDirty = computeDirtyRect(frame, &dirty);
+    if (dirty != reportedDirty) {
+        // Buffer age, a resize or a new surface extended the repaint area
+        // beyond this frame's damage, so the split region is no longer a
+        // valid clip.
+        dirtyRegion.clear();
+    }
 
-    bool drew = mRenderPipeline->draw(frame, windowDirty, dirty, mLightGeometry, &mLayerUpdateQueue,
-                                      mContentDrawBounds, mOpaque, mLightInfo, mRenderNodes,
-                                      &(profiler()));
+    bool drew = mRenderPipeline->draw(frame, windowDirty, dirty, dirtyRegion, mLightGeometry,
+                                      &mLayerUpdateQueue, mContentDrawBounds, mOpaque, mLightInfo,
+                                      mRenderNodes, &(profiler()));
 
     int64_t frameCompleteNr = mFrameCompleteCallbacks.size() ? getFrameNumber() : -1;
 
@@ -496,6 +512,8 @@ void CanvasContext::draw() {
 
     // TODO: Use a fence for real completion?
     mCurrentFrameInfo->markFrameCompleted();
+    mRenderThread.timeLord().frameWorkCompleted(
+            mCurrentFrameInfo->duration(FrameInfoIndex::SyncStart, FrameInfoIndex::FrameCompleted));
 
 #if LOG_FRAMETIME_MMA
     float thisFrame = mCurrentFrameInfo->duration(FrameInfoIndex::IssueDrawCommandsStart,
@@ -551,7 +569,11 @@ void CanvasContext::prepareAndDraw(RenderNode* node) {
     int64_t frameInfo[UI_THREAD_FRAME_INFO_SIZE];
     UiFrameInfoBuilder(frameInfo).addFlag(FrameInfoFlags::RTAnimation).setVsync(vsync, vsync);
 
+    LinearAllocator& frameArena = mRenderThread.frameArena();
+    LinearAllocator::Snapshot frameArenaStart = frameArena.snapshot();
+
     TreeInfo info(TreeInfo::MODE_RT_ONLY, *this);
+    info.frameAllocator = &frameArena;
     prepareTree(info, frameInfo, systemTime(CLOCK_MONOTONIC), node);
     if (info.out.canDrawThisFrame) {
         draw();
@@ -559,6 +581,8 @@ void CanvasContext::prepareAndDraw(RenderNode* node) {
         // wait on fences so tasks don't overlap next frame
         waitOnFences();
     }
+
+    frameArena.rewindTo(frameArenaStart);
 }
 
 void CanvasContext::markLayerInUse(RenderNode* node) {
@@ -621,6 +645,8 @@ void CanvasContext::trimMemory(RenderThread& thread, int level) {
     if (level >= TRIM_MEMORY_COMPLETE) {
         thread.cacheManager().trimMemory(CacheManager::TrimMemoryMode::Complete);
         thread.destroyRenderingContext();
+    } else if (level >= TRIM_MEMORY_MODERATE) {
+        thread.cacheManager().trimMemory(CacheManager::TrimMemoryMode::Moderate);
     } else if (level >= TRIM_MEMORY_UI_HIDDEN) {
         thread.cacheManager().trimMemory(CacheManager::TrimMemoryMode::UiHidden);
     }
@@ -654,7 +680,8 @@ void CanvasContext::waitOnFences() {
 }
 
 void CanvasContext::enqueueFrameWork(std::function<void()>&& func) {
-    mFrameFences.push_back(CommonPool::async(std::move(func)));
+    // The frame waits on these fences, so they must not queue behind background work.
+    mFrameFences.push_back(CommonPool::asyncHighPriority(std::move(func)));
 }
 
 int64_t CanvasContext::getFrameNumber() {
@@ -143,6 +143,17 @@ public:
     FrameInfoVisualizer& profiler() { return mProfiler; }
 
     void dumpFrames(int fd);
+    void dumpFrameTelemetry(int fd) { mJankTracker.dumpTelemetry(fd); }
+
+    // Total duration of the most recently completed frame, or 0 if none has
+    // completed yet. The batched draw path in DrawFrameTask uses this as the
+    // expected cost of the next frame when ordering windows by deadline slack.
+    nsecs_t lastFrameDurationNanos() {
+        auto& frames = mJankTracker.frames();
+        // back() is the frame currently being produced; the one before it is
+        // the most recent frame with a complete set of timestamps.
+        return frames.size() > 1 ? frames[frames.size() - 2].totalDuration() : 0;
+    }
     void resetFrameStats();
 
     void setName(const std::string&& name);
@@ -19,8 +19,11 @@
 #include <utils/Log.h>
 #include <utils/Trace.h>
 
+#include <algorithm>
+
 #include "../DeferredLayerUpdater.h"
 #include "../DisplayList.h"
+#include "../Properties.h"
 #include "../RenderNode.h"
 #include "CanvasContext.h"
 #include "RenderThread.h"
@@ -29,6 +32,40 @@ namespace android {
 namespace uirenderer {
 namespace renderthread {
 
+namespace {
+
+// Synced frames whose draws were deferred into a shared pass. Only populated
+// when Properties::enableFrameBatching is set; touched exclusively from the
+// render thread.
+struct BatchedFrame {
+    CanvasContext* context;
+    nsecs_t expectedDuration;
+};
+std::vector<BatchedFrame> gFrameBatch;
+LinearAllocator::Snapshot gFrameBatchArenaStart;
+
+void drainFrameBatch(RenderThread& thread) {
+    if (gFrameBatch.empty()) {
+        // An earlier drain already drew us along with its own frame.
+        return;
+    }
+    ATRACE_NAME("drainFrameBatch");
+    // Every frame in the batch shares the same vsync deadline, so the window
+    // with the least slack is the one expected to take the longest; draw it
+    // first so it isn't queued behind cheaper windows.
+    std::stable_sort(gFrameBatch.begin(), gFrameBatch.end(),
+                     [](const BatchedFrame& a, const BatchedFrame& b) {
+                         return a.expectedDuration > b.expectedDuration;
+                     });
+    for (const BatchedFrame& frame : gFrameBatch) {
+        frame.context->draw();
+    }
+    gFrameBatch.clear();
+    thread.frameArena().rewindTo(gFrameBatchArenaStart);
+}
+
+}  // namespace
+
 DrawFrameTask::DrawFrameTask()
         : mRenderThread(nullptr)
         , mContext(nullptr)
@@ -84,10 +121,16 @@ void DrawFrameTask::postAndWait() {
 void DrawFrameTask::run() {
     ATRACE_NAME("DrawFrame");
 
+    // Everything allocated from the frame arena during sync and draw is
+    // released in a single rewind once the frame is done.
+    LinearAllocator& frameArena = mRenderThread->frameArena();
+    LinearAllocator::Snapshot frameArenaStart = frameArena.snapshot();
+
     bool canUnblockUiThread;
     bool canDrawThisFrame;
     {
         TreeInfo info(TreeInfo::MODE_FULL, *mContext);
+        info.frameAllocator = &frameArena;
         canUnblockUiThread = syncFrameState(info);
         canDrawThisFrame = info.out.canDrawThisFrame;
 
@@ -99,6 +142,7 @@ void DrawFrameTask::run() {
 
     // Grab a copy of everything we need
     CanvasContext* context = mContext;
+    RenderThread* renderThread = mRenderThread;
     std::function<void(int64_t)> callback = std::move(mFrameCallback);
     mFrameCallback = nullptr;
 
@@ -113,13 +157,33 @@ void DrawFrameTask::run() {
                 [callback, frameNr = context->getFrameNumber()]() { callback(frameNr); });
     }
 
+    bool batchedDraw = false;
     if (CC_LIKELY(canDrawThisFrame)) {
-        context->draw();
+        if (CC_UNLIKELY(Properties::enableFrameBatching) && canUnblockUiThread) {
+            // Defer the draw so the other windows syncing against this vsync
+            // pulse can join the same pass; the drain task runs once the
+            // queue holds no further syncs. Frames that kept the UI thread
+            // blocked draw immediately since the caller is waiting on them.
+            if (gFrameBatch.empty()) {
+                gFrameBatchArenaStart = frameArenaStart;
+            }
+            gFrameBatch.push_back({context, context->lastFrameDurationNanos()});
+            renderThread->queue().post([renderThread]() { drainFrameBatch(*renderThread); });
+            batchedDraw = true;
+        } else {
+            context->draw();
+        }
     } else {
         // wait on fences so tasks don't overlap next frame
         context->waitOnFences();
     }
 
+    if (!batchedDraw) {
+        // Batched frames keep their sync-time allocations alive until the
+        // batch drains; the drain rewinds to the start of the batch.
+        frameArena.rewindTo(frameArenaStart);
+    }
+
     if (!canUnblockUiThread) {
         unblockUiThread();
     }
@@ -128,7 +192,15 @@ void DrawFrameTask::run() {
 bool DrawFrameTask::syncFrameState(TreeInfo& info) {
     ATRACE_CALL();
     int64_t vsync = mFrameInfo[static_cast<int>(FrameInfoIndex::Vsync)];
-    mRenderThread->timeLord().vsyncReceived(vsync);
+    TimeLord& timeLord = mRenderThread->timeLord();
+    timeLord.vsyncReceived(vsync);
+    if (CC_UNLIKELY(timeLord.predictedVsyncsToSkip() > 0)) {
+        // The pacing predictor says this frame cannot make the upcoming
+        // deadline, so pace it against the following vsync now rather than
+        // committing a frame that will miss and cascade.
+        ATRACE_NAME("predicted miss, retargeting vsync");
+        timeLord.targetFollowingVsync();
+    }
     bool canDraw = mContext->makeCurrent();
     mContext->unpinImages();
 
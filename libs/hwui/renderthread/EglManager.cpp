@@ -74,6 +74,7 @@ const char* EglManager::eglErrorString() {
 static struct {
     bool bufferAge = false;
     bool setDamage = false;
+    bool swapBuffersWithDamage = false;
     bool noConfigContext = false;
     bool pixelFormatFloat = false;
     bool glColorSpace = false;
@@ -218,8 +219,12 @@ void EglManager::initExtensions() {
     EglExtensions.bufferAge =
             extensions.has("EGL_EXT_buffer_age") || extensions.has("EGL_KHR_partial_update");
     EglExtensions.setDamage = extensions.has("EGL_KHR_partial_update");
-    LOG_ALWAYS_FATAL_IF(!extensions.has("EGL_KHR_swap_buffers_with_damage"),
-                        "Missing required extension EGL_KHR_swap_buffers_with_damage");
+    EglExtensions.swapBuffersWithDamage = extensions.has("EGL_KHR_swap_buffers_with_damage");
+    if (!EglExtensions.swapBuffersWithDamage) {
+        // Partial rendering via buffer age still works without it; only the
+        // presentation hint is lost, so fall back to plain eglSwapBuffers.
+        ALOGW("Missing EGL_KHR_swap_buffers_with_damage, presenting full buffers");
+    }
 
     EglExtensions.glColorSpace = extensions.has("EGL_KHR_gl_colorspace");
     EglExtensions.noConfigContext = extensions.has("EGL_KHR_no_config_context");
@@ -434,12 +439,26 @@ Frame EglManager::beginFrame(EGLSurface surface) {
     return frame;
 }
 
-void EglManager::damageFrame(const Frame& frame, const SkRect& dirty) {
+// More rects than this and the per-rect driver bookkeeping stops paying for
+// itself; collapse to the single bounding rect instead.
+static constexpr size_t kMaxDamageRects = 10;
+
+void EglManager::damageFrame(const Frame& frame, const SkRect& dirty,
+                             const LsaVector<SkRect>& dirtyRegion) {
 #ifdef EGL_KHR_partial_update
     if (EglExtensions.setDamage && mSwapBehavior == SwapBehavior::BufferAge) {
-        EGLint rects[4];
-        frame.map(dirty, rects);
-        if (!eglSetDamageRegionKHR(mEglDisplay, frame.mSurface, rects, 1)) {
+        EGLint rects[kMaxDamageRects * 4];
+        EGLint count;
+        if (!dirtyRegion.empty() && dirtyRegion.size() <= kMaxDamageRects) {
+            count = dirtyRegion.size();
+            for (EGLint i = 0; i < count; i++) {
+                frame.map(dirtyRegion[i], rects + i * 4);
+            }
+        } else {
+            count = 1;
+            frame.map(dirty, rects);
+        }
+        if (!eglSetDamageRegionKHR(mEglDisplay, frame.mSurface, rects, count)) {
             LOG_ALWAYS_FATAL("Failed to set damage region on surface %p, error=%s",
                              (void*)frame.mSurface, eglErrorString());
         }
@@ -457,9 +476,14 @@ bool EglManager::swapBuffers(const Frame& frame, const SkRect& screenDirty) {
         fence();
     }
 
-    EGLint rects[4];
-    frame.map(screenDirty, rects);
-    eglSwapBuffersWithDamageKHR(mEglDisplay, frame.mSurface, rects, screenDirty.isEmpty() ? 0 : 1);
+    if (EglExtensions.swapBuffersWithDamage) {
+        EGLint rects[4];
+        frame.map(screenDirty, rects);
+        eglSwapBuffersWithDamageKHR(mEglDisplay, frame.mSurface, rects,
+                                    screenDirty.isEmpty() ? 0 : 1);
+    } else {
+        eglSwapBuffers(mEglDisplay, frame.mSurface);
+    }
 
     EGLint err = eglGetError();
     if (CC_LIKELY(err == EGL_SUCCESS)) {
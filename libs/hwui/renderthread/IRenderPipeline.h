@@ -59,6 +59,7 @@ public:
     virtual MakeCurrentResult makeCurrent() = 0;
     virtual Frame getFrame() = 0;
     virtual bool draw(const Frame& frame, const SkRect& screenDirty, const SkRect& dirty,
+                      const LsaVector<SkRect>& dirtyRegion,
                       const LightGeometry& lightGeometry, LayerUpdateQueue* layerUpdateQueue,
                       const Rect& contentDrawBounds, bool opaque, const LightInfo& lightInfo,
                       const std::vector<sp<RenderNode>>& renderNodes,
@@ -18,13 +18,14 @@
 
 #include <private/android/AHardwareBufferHelpers.h>
 
+#include "thread/CommonPool.h"
+
 namespace android::uirenderer::renderthread {
 
-// TODO: Re-enable after addressing more of the TODO's
-// With this disabled we won't have a good up-front signal that the surface is no longer valid,
-// however we can at least handle that reactively post-draw. There's just not a good mechanism
-// to propagate this error back to the caller
-constexpr bool DISABLE_BUFFER_PREFETCH = true;
+// The prefetch runs asynchronously, so reserveNext() cannot give an up-front
+// signal that the surface died; errors surface reactively when dequeueBuffer
+// retries and falls back to the scratch buffer, same as with no prefetch.
+constexpr bool DISABLE_BUFFER_PREFETCH = false;
 
 // TODO: Make surface less protected
 // This exists because perform is a varargs, and ANativeWindow has no va_list perform.
@@ -89,7 +90,7 @@ void ReliableSurface::perform(int operation, va_list args) {
 int ReliableSurface::reserveNext() {
     {
         std::lock_guard _lock{mMutex};
-        if (mReservedBuffer) {
+        if (mReservedBuffer || mReservationPending) {
             ALOGW("reserveNext called but there was already a buffer reserved?");
             return OK;
         }
@@ -102,6 +103,7 @@ int ReliableSurface::reserveNext() {
         if constexpr (DISABLE_BUFFER_PREFETCH) {
             return OK;
         }
+        mReservationPending = true;
     }
 
     // TODO: Update this to better handle when requested dimensions have changed
@@ -109,25 +111,34 @@ int ReliableSurface::reserveNext() {
     // reserved a buffer. Should we do that logic instead? Or should we drop
     // the backing Surface to the ground and go full manual on the IGraphicBufferProducer instead?
 
-    int fenceFd = -1;
-    ANativeWindowBuffer* buffer = nullptr;
-    int result = callProtected(mSurface, dequeueBuffer, &buffer, &fenceFd);
-
-    {
-        std::lock_guard _lock{mMutex};
-        LOG_ALWAYS_FATAL_IF(mReservedBuffer, "race condition in reserveNext");
-        mReservedBuffer = buffer;
-        mReservedFenceFd.reset(fenceFd);
-    }
+    // The dequeue may block until the composer releases a buffer; do that wait
+    // on a worker so the render thread keeps syncing. A failed dequeue leaves
+    // the reservation empty and dequeueBuffer retries it inline.
+    CommonPool::post([self = sp<ReliableSurface>(this)]() {
+        int fenceFd = -1;
+        ANativeWindowBuffer* buffer = nullptr;
+        callProtected(self->mSurface, dequeueBuffer, &buffer, &fenceFd);
+        {
+            std::lock_guard _lock{self->mMutex};
+            LOG_ALWAYS_FATAL_IF(self->mReservedBuffer, "race condition in reserveNext");
+            self->mReservedBuffer = buffer;
+            self->mReservedFenceFd.reset(fenceFd);
+            self->mReservationPending = false;
+        }
+        self->mReservationDone.notify_all();
+    });
 
-    return result;
+    return OK;
 }
 
 void ReliableSurface::clearReservedBuffer() {
     ANativeWindowBuffer* buffer = nullptr;
     int releaseFd = -1;
     {
-        std::lock_guard _lock{mMutex};
+        std::unique_lock _lock{mMutex};
+        // A reservation in flight can't be cancelled mid-dequeue; settle it
+        // first so the buffer is actually ours to return.
+        mReservationDone.wait(_lock, [this]() { return !mReservationPending; });
         if (mReservedBuffer) {
             ALOGW("Reserved buffer %p was never used", mReservedBuffer);
             buffer = mReservedBuffer;
@@ -156,7 +167,8 @@ int ReliableSurface::cancelBuffer(ANativeWindowBuffer* buffer, int fenceFd) {
 
 int ReliableSurface::dequeueBuffer(ANativeWindowBuffer** buffer, int* fenceFd) {
     {
-        std::lock_guard _lock{mMutex};
+        std::unique_lock _lock{mMutex};
+        mReservationDone.wait(_lock, [this]() { return !mReservationPending; });
         if (mReservedBuffer) {
             *buffer = mReservedBuffer;
             *fenceFd = mReservedFenceFd.release();
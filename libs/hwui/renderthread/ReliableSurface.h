@@ -20,6 +20,7 @@
 #include <utils/Macros.h>
 #include <utils/StrongPointer.h>
 
+#include <condition_variable>
 #include <memory>
 
 namespace android::uirenderer::renderthread {
@@ -54,6 +55,10 @@ private:
             nullptr, AHardwareBuffer_release};
     ANativeWindowBuffer* mReservedBuffer = nullptr;
     base::unique_fd mReservedFenceFd;
+    // True while a worker is filling mReservedBuffer; consumers that need the
+    // reservation settled wait on mReservationDone.
+    bool mReservationPending = false;
+    std::condition_variable mReservationDone;
     bool mHasDequeuedBuffer = false;
     bool mInErrorState = false;
 
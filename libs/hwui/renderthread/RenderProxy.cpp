@@ -22,6 +22,10 @@
 #include "Readback.h"
 #include "Rect.h"
 #include "WebViewFunctorManager.h"
+#include "hwui/Canvas.h"
+#include "hwui/MinikinUtils.h"
+#include "hwui/Paint.h"
+#include "hwui/Typeface.h"
 #include "pipeline/skia/SkiaOpenGLPipeline.h"
 #include "pipeline/skia/VectorDrawableAtlas.h"
 #include "renderstate/RenderState.h"
@@ -29,6 +33,7 @@
 #include "renderthread/EglManager.h"
 #include "renderthread/RenderTask.h"
 #include "renderthread/RenderThread.h"
+#include "thread/CommonPool.h"
 #include "utils/Macros.h"
 #include "utils/TimeUtils.h"
 #include "utils/TraceUtils.h"
@@ -227,6 +232,9 @@ void RenderProxy::dumpProfileInfo(int fd, int dumpFlags) {
         if (dumpFlags & DumpFlags::JankStats) {
             mRenderThread.globalProfileData()->dump(fd);
         }
+        if (dumpFlags & DumpFlags::FrameTelemetry) {
+            mContext->dumpFrameTelemetry(fd);
+        }
         if (dumpFlags & DumpFlags::Reset) {
             mContext->resetFrameStats();
         }
@@ -326,6 +334,20 @@ int RenderProxy::copySurfaceInto(sp<Surface>& surface, int left, int top, int ri
     }));
 }
 
+void RenderProxy::copySurfaceIntoAsync(sp<Surface>& surface, int left, int top, int right,
+                                       int bottom, SkBitmap* bitmap,
+                                       std::function<void(int)>&& callback) {
+    auto& thread = RenderThread::getInstance();
+    thread.queue().post([&thread, surface, left, top, right, bottom, bitmap,
+                         callback = std::move(callback)]() mutable {
+        thread.readback().copySurfaceIntoAsync(
+                *surface, Rect(left, top, right, bottom), bitmap,
+                [callback = std::move(callback)](CopyResult result) {
+                    callback(static_cast<int>(result));
+                });
+    });
+}
+
 void RenderProxy::prepareToDraw(Bitmap& bitmap) {
     // If we haven't spun up a hardware accelerated window yet, there's no
     // point in precaching these bitmaps as it can't impact jank.
@@ -380,6 +402,17 @@ void RenderProxy::repackVectorDrawableAtlas() {
     });
 }
 
+void RenderProxy::defragVectorDrawableAtlas() {
+    RenderThread& thread = RenderThread::getInstance();
+    thread.queue().postDelayed(500_ms, [&thread]() {
+        // The context may be null if trimMemory executed, but then the atlas was deleted too.
+        if (thread.getGrContext() != nullptr) {
+            thread.cacheManager().acquireVectorDrawableAtlas()->idleDefrag(thread.getGrContext(),
+                                                                           thread.isIdle());
+        }
+    });
+}
+
 void RenderProxy::releaseVDAtlasEntries() {
     RenderThread& thread = RenderThread::getInstance();
     thread.queue().post([&thread]() {
@@ -396,6 +429,56 @@ void RenderProxy::preload() {
     thread.queue().post([&thread]() { thread.preload(); });
 }
 
+void RenderProxy::preloadGlyphCaches(const Typeface* typeface, std::vector<uint16_t>&& text,
+                                     std::vector<float>&& textSizes) {
+    if (text.empty() || textSizes.empty()) {
+        return;
+    }
+    // Resolve and copy the typeface up front; the worker must not depend on
+    // the caller keeping its Typeface alive.
+    Typeface face = *Typeface::resolveDefault(typeface);
+    CommonPool::post(
+            [face = std::move(face), text = std::move(text), sizes = std::move(textSizes)]() {
+                ATRACE_NAME("preloadGlyphCaches");
+                Paint paint;
+                paint.setAntiAlias(true);
+                for (float size : sizes) {
+                    if (size <= 0) {
+                        continue;
+                    }
+                    paint.getSkFont().setSize(size);
+                    std::vector<float> advances(text.size());
+                    MinikinUtils::measureText(&paint, minikin::Bidi::LTR, &face, text.data(), 0,
+                                              text.size(), text.size(), advances.data());
+                    // Glyphs outside the clip are culled before rasterization,
+                    // so wrap the manifest into strips that fit the scratch
+                    // bitmap rather than drawing one long clipped-out line.
+                    const int width = std::max(256, static_cast<int>(size) * 8);
+                    const float maxAdvance = width - size;
+                    SkBitmap scratch;
+                    scratch.allocN32Pixels(width, static_cast<int>(size) * 2);
+                    std::unique_ptr<Canvas> canvas(Canvas::create_canvas(scratch));
+                    size_t start = 0;
+                    while (start < text.size()) {
+                        size_t end = start + 1;
+                        float advance = advances[start];
+                        // A zero advance marks a continuation of the cluster
+                        // begun by an earlier code unit (surrogate pairs,
+                        // combining marks); never split one across strips.
+                        while (end < text.size() &&
+                               (advances[end] == 0 || advance + advances[end] <= maxAdvance)) {
+                            advance += advances[end];
+                            end++;
+                        }
+                        const size_t count = end - start;
+                        canvas->drawText(text.data(), text.size(), start, count, start, count, 0,
+                                         size * 1.5f, minikin::Bidi::LTR, paint, &face, nullptr);
+                        start = end;
+                    }
+                }
+            });
+}
+
 } /* namespace renderthread */
 } /* namespace uirenderer */
 } /* namespace android */
@@ -22,6 +22,9 @@
 #include <gui/Surface.h>
 #include <utils/Functor.h>
 
+#include <functional>
+#include <vector>
+
 #include "../FrameMetricsObserver.h"
 #include "../IContextFactory.h"
 #include "DrawFrameTask.h"
@@ -30,6 +33,7 @@
 
 namespace android {
 class GraphicBuffer;
+struct Typeface;
 
 namespace uirenderer {
 
@@ -48,6 +52,9 @@ enum {
     FrameStats = 1 << 0,
     Reset = 1 << 1,
     JankStats = 1 << 2,
+    // Raw per-frame telemetry ring as a versioned binary blob; callers
+    // (GraphicsStatsService) should pass a dedicated fd, not a text stream.
+    FrameTelemetry = 1 << 3,
 };
 }
 
@@ -142,6 +149,14 @@ public:
 
     ANDROID_API static int copySurfaceInto(sp<Surface>& surface, int left, int top, int right,
                                            int bottom, SkBitmap* bitmap);
+    /**
+     * Same as copySurfaceInto but does not block the calling thread or the
+     * render thread. The callback receives a CopyResult cast to int and runs
+     * on a CommonPool worker; the bitmap must outlive the callback.
+     */
+    ANDROID_API static void copySurfaceIntoAsync(sp<Surface>& surface, int left, int top, int right,
+                                                 int bottom, SkBitmap* bitmap,
+                                                 std::function<void(int)>&& callback);
     ANDROID_API static void prepareToDraw(Bitmap& bitmap);
 
     static int copyHWBitmapInto(Bitmap* hwBitmap, SkBitmap* bitmap);
@@ -150,8 +165,25 @@ public:
 
     ANDROID_API static void preload();
 
+    /**
+     * Pre-rasterizes the glyphs needed to draw `text` at each of `textSizes`
+     * with the given typeface (nullptr for the default) on a CommonPool
+     * worker, so a text-heavy first frame doesn't pay cold shaping and glyph
+     * mask caches. Intended to run during application init, before the first
+     * frame is drawn; the typeface is copied so the caller's may be released.
+     */
+    ANDROID_API static void preloadGlyphCaches(const Typeface* typeface,
+                                               std::vector<uint16_t>&& text,
+                                               std::vector<float>&& textSizes);
+
     static void repackVectorDrawableAtlas();
 
+    /**
+     * Schedules a delayed VectorDrawableAtlas compaction that only runs if the
+     * render thread is still idle when the task fires.
+     */
+    static void defragVectorDrawableAtlas();
+
     static void releaseVDAtlasEntries();
 
 private:
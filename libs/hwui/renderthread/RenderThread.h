@@ -24,6 +24,7 @@
 #include "TimeLord.h"
 #include "WebViewFunctorManager.h"
 #include "thread/ThreadBase.h"
+#include "utils/LinearAllocator.h"
 #include "utils/TimeUtils.h"
 
 #include <GrContext.h>
@@ -97,6 +98,14 @@ public:
     void pushBackFrameCallback(IFrameCallback* callback);
 
     TimeLord& timeLord() { return mTimeLord; }
+
+    /**
+     * Scratch memory for the frame in progress. The frame driver
+     * (DrawFrameTask::run or CanvasContext::prepareAndDraw) snapshots the
+     * arena before sync and rewinds it once the frame is done, so anything
+     * allocated from it must not outlive the frame that allocated it.
+     */
+    LinearAllocator& frameArena() { return mFrameArena; }
     RenderState& renderState() const { return *mRenderState; }
     EglManager& eglManager() const { return *mEglManager; }
     ProfileDataContainer& globalProfileData() { return mGlobalProfileData; }
@@ -153,6 +162,16 @@ private:
     void dispatchFrameCallbacks();
     void requestVsync();
 
+    /**
+     * Returns true when no frame work is pending or scheduled. Used to gate
+     * housekeeping (e.g. atlas defragmentation) that must not compete with
+     * drawing. Only meaningful when called from the render thread.
+     */
+    bool isIdle() const {
+        return !mVsyncRequested && !mFrameCallbackTaskPending && mFrameCallbacks.empty() &&
+               mPendingRegistrationFrameCallbacks.empty();
+    }
+
     VsyncSource* mVsyncSource;
     bool mVsyncRequested;
     std::set<IFrameCallback*> mFrameCallbacks;
@@ -164,6 +183,7 @@ private:
     bool mFrameCallbackTaskPending;
 
     TimeLord mTimeLord;
+    LinearAllocator mFrameArena;
     nsecs_t mDispatchFrameDelay = 4_ms;
     RenderState* mRenderState;
     EglManager* mEglManager;
@@ -29,6 +29,46 @@ bool TimeLord::vsyncReceived(nsecs_t vsync) {
     return false;
 }
 
+void TimeLord::frameWorkCompleted(nsecs_t workDuration) {
+    if (workDuration > 0) {
+        mFrameWorkHistory.next() = workDuration;
+    }
+}
+
+nsecs_t TimeLord::predictedFrameWorkDuration() const {
+    if (mFrameWorkHistory.size() < mFrameWorkHistory.capacity()) {
+        // Not enough signal yet; predict nothing rather than guess.
+        return 0;
+    }
+    // Use the second-largest recent duration: nearly as conservative as the
+    // max, without a single outlier (shader compile, cold caches) pinning the
+    // prediction high for the whole window.
+    nsecs_t largest = 0;
+    nsecs_t secondLargest = 0;
+    for (size_t i = 0; i < mFrameWorkHistory.size(); i++) {
+        nsecs_t duration = mFrameWorkHistory[i];
+        if (duration > largest) {
+            secondLargest = largest;
+            largest = duration;
+        } else if (duration > secondLargest) {
+            secondLargest = duration;
+        }
+    }
+    return secondLargest;
+}
+
+int TimeLord::predictedVsyncsToSkip() const {
+    const nsecs_t predicted = predictedFrameWorkDuration();
+    if (predicted == 0 || predicted >= mFrameIntervalNanos * 2) {
+        // No signal yet, or a workload that misses every deadline regardless;
+        // retargeting a single vsync cannot help either case.
+        return 0;
+    }
+    const nsecs_t now = systemTime(CLOCK_MONOTONIC);
+    const nsecs_t deadline = mFrameTimeNanos + mFrameIntervalNanos;
+    return (now + predicted > deadline) ? 1 : 0;
+}
+
 nsecs_t TimeLord::computeFrameTimeNanos() {
     // Logic copied from Choreographer.java
     nsecs_t now = systemTime(CLOCK_MONOTONIC);
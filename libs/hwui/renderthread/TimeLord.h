@@ -18,6 +18,8 @@
 
 #include <utils/Timers.h>
 
+#include "utils/RingBuffer.h"
+
 namespace android {
 namespace uirenderer {
 namespace renderthread {
@@ -36,6 +38,26 @@ public:
     nsecs_t latestVsync() { return mFrameTimeNanos; }
     nsecs_t computeFrameTimeNanos();
 
+    // Records how long a completed frame's render thread work took (sync
+    // start through swap completion), feeding the pacing predictor.
+    void frameWorkCompleted(nsecs_t workDuration);
+
+    // Conservative estimate of the next frame's CPU+GPU work duration based
+    // on recent completions. Returns 0 until enough history has accumulated.
+    nsecs_t predictedFrameWorkDuration() const;
+
+    // Returns 1 if work started now is predicted to miss the upcoming vsync
+    // deadline and the frame should be paced against the following pulse
+    // instead, 0 otherwise. DrawFrameTask consults this before committing a
+    // frame, then applies the decision with targetFollowingVsync().
+    int predictedVsyncsToSkip() const;
+
+    // Advances the frame time by one interval so animations, swap history and
+    // the present time all line up with the vsync the frame will actually
+    // make. The UI thread's commit for the pulse we skipped then arrives with
+    // a matching vsync and is dropped instead of queued late.
+    void targetFollowingVsync() { mFrameTimeNanos += mFrameIntervalNanos; }
+
 private:
     friend class RenderThread;
 
@@ -44,6 +66,7 @@ private:
 
     nsecs_t mFrameIntervalNanos;
     nsecs_t mFrameTimeNanos;
+    RingBuffer<nsecs_t, 6> mFrameWorkHistory;
 };
 
 } /* namespace renderthread */
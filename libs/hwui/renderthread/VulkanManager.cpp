@@ -541,7 +541,7 @@ void VulkanManager::swapBuffers(VulkanSurface* surface, const SkRect& dirtyRect)
         mQueueWaitIdle(mGraphicsQueue);
     }
 
-    surface->presentCurrentBuffer(dirtyRect, fenceFd);
+    surface->presentCurrentBufferAsync(dirtyRect, fenceFd);
 }
 
 void VulkanManager::destroySurface(VulkanSurface* surface) {
@@ -20,6 +20,7 @@
 #include <algorithm>
 
 #include "VulkanManager.h"
+#include "thread/CommonPool.h"
 #include "utils/Color.h"
 #include "utils/TraceUtils.h"
 
@@ -389,6 +390,7 @@ VulkanSurface::VulkanSurface(ANativeWindow* window, const WindowInfo& windowInfo
         , mMaxWindowSize(maxWindowSize) {}
 
 VulkanSurface::~VulkanSurface() {
+    waitForPendingPresent();
     releaseBuffers();
 
     // release the native window to be available for use by other clients
@@ -425,6 +427,9 @@ void VulkanSurface::releaseBuffers() {
 }
 
 VulkanSurface::NativeBufferInfo* VulkanSurface::dequeueNativeBuffer() {
+    // Join the previous frame's present before touching any state its task may still use.
+    waitForPendingPresent();
+
     // Set the mCurrentBufferInfo to invalid in case of error and only reset it to the correct
     // value at the end of the function if everything dequeued correctly.
     mCurrentBufferInfo = nullptr;
@@ -563,6 +568,23 @@ bool VulkanSurface::presentCurrentBuffer(const SkRect& dirtyRect, int semaphoreF
     return err == 0;
 }
 
+void VulkanSurface::presentCurrentBufferAsync(const SkRect& dirtyRect, int semaphoreFd) {
+    waitForPendingPresent();
+    // The task owns semaphoreFd; presentCurrentBuffer() hands it to queueBuffer(),
+    // which always closes it.
+    mPendingPresent = CommonPool::async(
+            [this, dirtyRect, semaphoreFd] { presentCurrentBuffer(dirtyRect, semaphoreFd); });
+}
+
+void VulkanSurface::waitForPendingPresent() {
+    if (!mPendingPresent.valid()) {
+        return;
+    }
+    ATRACE_NAME("Wait for pending present");
+    mPendingPresent.wait();
+    mPendingPresent = {};
+}
+
 int VulkanSurface::getCurrentBuffersAge() {
     LOG_ALWAYS_FATAL_IF(!mCurrentBufferInfo);
     VulkanSurface::NativeBufferInfo& currentBuffer = *mCurrentBufferInfo;
@@ -22,6 +22,8 @@
 #include <SkRefCnt.h>
 #include <SkSize.h>
 
+#include <future>
+
 #include "IRenderPipeline.h"
 
 class SkSurface;
@@ -66,6 +68,11 @@ private:
     NativeBufferInfo* dequeueNativeBuffer();
     NativeBufferInfo* getCurrentBufferInfo() { return mCurrentBufferInfo; }
     bool presentCurrentBuffer(const SkRect& dirtyRect, int semaphoreFd);
+    // Hands the present off to the common task pool so the RenderThread does not sit in
+    // the queueBuffer() binder call while it could already be starting the next frame.
+    // At most one present is in flight per surface; dequeueNativeBuffer() and the
+    // destructor join it before touching the buffer state again.
+    void presentCurrentBufferAsync(const SkRect& dirtyRect, int semaphoreFd);
 
     // The width and height are are the logical width and height for when submitting draws to the
     // surface. In reality if the window is rotated the underlying window may have the width and
@@ -107,6 +114,7 @@ private:
     static void ComputeWindowSizeAndTransform(WindowInfo* windowInfo, const SkISize& minSize,
                                               const SkISize& maxSize);
     void releaseBuffers();
+    void waitForPendingPresent();
 
     // TODO: Just use a vector?
     NativeBufferInfo mNativeBuffers[android::BufferQueueDefs::NUM_BUFFER_SLOTS];
@@ -117,6 +125,7 @@ private:
 
     uint32_t mPresentCount = 0;
     NativeBufferInfo* mCurrentBufferInfo = nullptr;
+    std::future<void> mPendingPresent;
 
     const SkISize mMinWindowSize;
     const SkISize mMaxWindowSize;
@@ -279,32 +279,53 @@ void GraphicsStatsService::saveBuffer(const std::string& path, const std::string
               statsProto.has_summary());
         return;
     }
-    int outFd = open(path.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0660);
+    // Write to a sibling temp file and rename over the target so a crash
+    // mid-write can never destroy the previously saved stats; readers always
+    // see either the old file or the complete new one.
+    std::string tempPath = path + ".tmp";
+    int outFd = open(tempPath.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0660);
     if (outFd <= 0) {
         int err = errno;
-        ALOGW("Failed to open '%s', error=%d (%s)", path.c_str(), err, strerror(err));
+        ALOGW("Failed to open '%s', error=%d (%s)", tempPath.c_str(), err, strerror(err));
         return;
     }
     int wrote = write(outFd, &sCurrentFileVersion, sHeaderSize);
     if (wrote != sHeaderSize) {
         int err = errno;
-        ALOGW("Failed to write header to '%s', returned=%d errno=%d (%s)", path.c_str(), wrote, err,
-              strerror(err));
+        ALOGW("Failed to write header to '%s', returned=%d errno=%d (%s)", tempPath.c_str(), wrote,
+              err, strerror(err));
         close(outFd);
+        unlink(tempPath.c_str());
         return;
     }
+    bool success;
     {
         FileOutputStreamLite output(outFd);
-        bool success = statsProto.SerializeToZeroCopyStream(&output) && output.Flush();
+        success = statsProto.SerializeToZeroCopyStream(&output) && output.Flush();
         if (output.GetErrno() != 0) {
-            ALOGW("Error writing to fd=%d, path='%s' err=%d (%s)", outFd, path.c_str(),
+            ALOGW("Error writing to fd=%d, path='%s' err=%d (%s)", outFd, tempPath.c_str(),
                   output.GetErrno(), strerror(output.GetErrno()));
             success = false;
         } else if (!success) {
-            ALOGW("Serialize failed on '%s' unknown error", path.c_str());
+            ALOGW("Serialize failed on '%s' unknown error", tempPath.c_str());
         }
     }
+    if (success && fdatasync(outFd) != 0) {
+        int err = errno;
+        ALOGW("Failed to fdatasync '%s', errno=%d (%s)", tempPath.c_str(), err, strerror(err));
+        success = false;
+    }
     close(outFd);
+    if (!success) {
+        unlink(tempPath.c_str());
+        return;
+    }
+    if (rename(tempPath.c_str(), path.c_str()) != 0) {
+        int err = errno;
+        ALOGW("Failed to rename '%s' to '%s', errno=%d (%s)", tempPath.c_str(), path.c_str(), err,
+              strerror(err));
+        unlink(tempPath.c_str());
+    }
 }
 
 class GraphicsStatsService::Dump {
@@ -205,6 +205,13 @@ status_t SurfaceTexture::attachToContext(uint32_t tex) {
     return mEGLConsumer.attachToContext(tex, *this);
 }
 
+void SurfaceTexture::onFrameAvailable(const BufferItem& item) {
+    // Advance before forwarding so a consumer woken by the listener observes
+    // the new generation.
+    mFrameGeneration.fetch_add(1, std::memory_order_relaxed);
+    ConsumerBase::onFrameAvailable(item);
+}
+
 void SurfaceTexture::attachToView() {
     ATRACE_CALL();
     Mutex::Autolock _l(mMutex);
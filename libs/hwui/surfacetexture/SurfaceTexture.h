@@ -19,6 +19,8 @@
 #include <gui/BufferQueueDefs.h>
 #include <gui/ConsumerBase.h>
 
+#include <atomic>
+
 #include <ui/FenceTime.h>
 #include <ui/GraphicBuffer.h>
 
@@ -261,6 +263,13 @@ public:
     sk_sp<SkImage> dequeueImage(SkMatrix& transformMatrix, bool* queueEmpty,
                                 uirenderer::RenderState& renderState);
 
+    /**
+     * frameGeneration returns a counter that advances each time the producer
+     * queues a buffer. Consumers can compare values across frames to skip
+     * acquire attempts when nothing new has been queued.
+     */
+    uint64_t frameGeneration() const { return mFrameGeneration.load(std::memory_order_relaxed); }
+
     /**
      * attachToView attaches a SurfaceTexture that is currently in the
      * 'detached' state to HWUI View system.
@@ -285,6 +294,12 @@ protected:
      */
     virtual void dumpLocked(String8& result, const char* prefix) const override;
 
+    /**
+     * onFrameAvailable overrides the ConsumerBase method to advance the
+     * frame generation counter before the frame-available listener runs.
+     */
+    virtual void onFrameAvailable(const BufferItem& item) override;
+
     /**
      * acquireBufferLocked overrides the ConsumerBase method to update the
      * mEglSlots array in addition to the ConsumerBase behavior.
@@ -434,6 +449,13 @@ protected:
      */
     OpMode mOpMode;
 
+    /**
+     * mFrameGeneration counts buffers queued by the producer; see
+     * frameGeneration(). Written from the producer's thread via
+     * onFrameAvailable, read from the render thread.
+     */
+    std::atomic<uint64_t> mFrameGeneration{0};
+
     /**
      * mEGLConsumer has SurfaceTexture logic used when attached to GL context.
      */
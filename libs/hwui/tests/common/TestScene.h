@@ -39,6 +39,9 @@ public:
         int reportFrametimeWeight = 0;
         bool renderOffscreen = true;
         int renderAhead = 0;
+        // Path to an .skp sequence recorded via debug.hwui.capture_skp_enabled,
+        // consumed by scenes that replay captured frames.
+        std::string skpCapture;
     };
 
     template <class T>
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TestSceneBase.h"
+
+#include "Properties.h"
+
+#include <SkPicture.h>
+#include <SkStream.h>
+
+#include <unistd.h>
+#include <cstdio>
+#include <vector>
+
+class SkpReplayAnimation;
+
+static test::TestScene* createSkpReplay(const TestScene::Options& opts);
+
+static TestScene::Registrar _SkpReplay(TestScene::Info{
+        "skpreplay",
+        "Replays a sequence of frames captured from a real app with "
+        "debug.hwui.capture_skp_enabled, so renderer changes can be measured against an actual "
+        "workload instead of a synthetic scene. Pass the capture via --skp.",
+        createSkpReplay});
+
+class SkpReplayAnimation : public TestScene {
+public:
+    explicit SkpReplayAnimation(const TestScene::Options& opts) { loadCapture(opts.skpCapture); }
+
+    void createContent(int width, int height, Canvas& canvas) override {
+        content = TestUtils::createNode(0, 0, width, height, nullptr);
+        doFrame(0);
+
+        canvas.drawColor(Color::White, SkBlendMode::kSrcOver);
+        canvas.drawRenderNode(content.get());
+    }
+
+    void doFrame(int frameNr) override {
+        if (pictures.empty()) {
+            return;
+        }
+        std::unique_ptr<Canvas> canvas(
+                Canvas::create_recording_canvas(content->stagingProperties().getWidth(),
+                                                content->stagingProperties().getHeight(),
+                                                content.get()));
+        canvas->asSkCanvas()->drawPicture(pictures[frameNr % pictures.size()]);
+        content->setStagingDisplayList(canvas->finishRecording());
+    }
+
+private:
+    void loadCapture(const std::string& path) {
+        if (path.empty()) {
+            fprintf(stderr,
+                    "skpreplay needs --skp=<file>, where <file> was recorded on the device via "
+                    "%s/%s\n",
+                    PROPERTY_CAPTURE_SKP_ENABLED, PROPERTY_CAPTURE_SKP_FILENAME);
+            return;
+        }
+        // A multi-frame capture counts its sequence number down: the first
+        // frames land in <file>_N .. <file>_2 and the last one in the plain
+        // <file>, so chronological order is descending suffix, plain file
+        // last.
+        std::vector<std::string> numbered;
+        for (int i = 2;; i++) {
+            std::string file = path + "_" + std::to_string(i);
+            if (access(file.c_str(), F_OK) != 0) break;
+            numbered.push_back(std::move(file));
+        }
+        for (auto it = numbered.rbegin(); it != numbered.rend(); ++it) {
+            loadPicture(*it);
+        }
+        loadPicture(path);
+        if (pictures.empty()) {
+            fprintf(stderr, "No frames loaded from '%s'\n", path.c_str());
+        } else {
+            printf("Replaying %zu captured frame(s) from '%s'\n", pictures.size(), path.c_str());
+        }
+    }
+
+    void loadPicture(const std::string& file) {
+        SkFILEStream stream(file.c_str());
+        if (!stream.isValid()) {
+            fprintf(stderr, "Unable to open '%s'\n", file.c_str());
+            return;
+        }
+        sk_sp<SkPicture> picture = SkPicture::MakeFromStream(&stream);
+        if (!picture) {
+            fprintf(stderr, "'%s' is not a deserializable SkPicture\n", file.c_str());
+            return;
+        }
+        pictures.push_back(std::move(picture));
+    }
+
+    sp<RenderNode> content;
+    std::vector<sk_sp<SkPicture>> pictures;
+};
+
+static test::TestScene* createSkpReplay(const TestScene::Options& opts) {
+    return new SkpReplayAnimation(opts);
+}
@@ -70,6 +70,9 @@ OPTIONS:
   --benchmark_format   Set output format. Possible values are tabular, json, csv
   --renderer=TYPE      Sets the render pipeline to use. May be skiagl or skiavk
   --render-ahead=NUM   Sets how far to render-ahead. Must be 0 (default), 1, or 2.
+  --skp=FILE           Path to an .skp sequence recorded on a device with
+                       debug.hwui.capture_skp_enabled, for scenes that replay
+                       captured frames (see the skpreplay test)
 )");
 }
 
@@ -172,6 +175,7 @@ enum {
     Offscreen,
     Renderer,
     RenderAhead,
+    Skp,
 };
 }
 
@@ -188,6 +192,7 @@ static const struct option LONG_OPTIONS[] = {
         {"offscreen", no_argument, nullptr, LongOpts::Offscreen},
         {"renderer", required_argument, nullptr, LongOpts::Renderer},
         {"render-ahead", required_argument, nullptr, LongOpts::RenderAhead},
+        {"skp", required_argument, nullptr, LongOpts::Skp},
         {0, 0, 0, 0}};
 
 static const char* SHORT_OPTIONS = "c:r:h";
@@ -296,6 +301,14 @@ void parseOptions(int argc, char* argv[]) {
                 }
                 break;
 
+            case LongOpts::Skp:
+                if (!optarg) {
+                    error = true;
+                    break;
+                }
+                gOpts.skpCapture = optarg;
+                break;
+
             case 'h':
                 printHelp();
                 exit(EXIT_SUCCESS);
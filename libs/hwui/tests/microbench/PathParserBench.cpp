@@ -21,6 +21,8 @@
 
 #include <SkPath.h>
 
+#include <string>
+
 using namespace android;
 using namespace android::uirenderer;
 
@@ -51,3 +53,27 @@ void BM_PathParser_parseStringPathForPathData(benchmark::State& state) {
     }
 }
 BENCHMARK(BM_PathParser_parseStringPathForPathData);
+
+// Synthesizes a multi-kilobyte path of the shape illustration-heavy
+// VectorDrawables produce, where float parsing dominates inflation time.
+static std::string makeLongPathString() {
+    std::string path = "M 0.0,-1.0";
+    for (int i = 0; i < 100; i++) {
+        path += " c 0.5522847498,0.0 1.0,0.4477152502 1.0,1.0 l 20.75,0.0 q -6.25,3.5 6.0,6.0";
+    }
+    path += " Z";
+    return path;
+}
+
+void BM_PathParser_parseStringPathForPathData_long(benchmark::State& state) {
+    std::string longPath = makeLongPathString();
+    while (state.KeepRunning()) {
+        PathData outData;
+        PathParser::ParseResult result;
+        PathParser::getPathDataFromAsciiString(&outData, &result, longPath.c_str(),
+                                               longPath.length());
+        benchmark::DoNotOptimize(&result);
+        benchmark::DoNotOptimize(&outData);
+    }
+}
+BENCHMARK(BM_PathParser_parseStringPathForPathData_long);
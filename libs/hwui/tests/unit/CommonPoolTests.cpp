@@ -22,6 +22,7 @@
 #include <condition_variable>
 #include <set>
 #include <thread>
+#include <vector>
 #include "unistd.h"
 
 using namespace android;
@@ -141,6 +142,65 @@ TEST(DISABLED_CommonPool, fullQueue) {
     }
 }
 
+TEST(CommonPool, highPriorityRunsFirst) {
+    std::mutex mutex;
+    std::condition_variable fence;
+    int releasedWorkers = 0;
+    std::atomic_int blockedWorkers{0};
+    std::vector<int> order;
+
+    // Park every worker so queued tasks cannot start until we release them.
+    std::array<std::future<void>, CommonPool::THREAD_COUNT> blockers;
+    for (auto& blocker : blockers) {
+        blocker = CommonPool::async([&] {
+            int self = ++blockedWorkers;
+            std::unique_lock lock{mutex};
+            while (releasedWorkers < self) {
+                fence.wait(lock);
+            }
+        });
+    }
+    for (int i = 0; blockedWorkers < CommonPool::THREAD_COUNT && i < 1000000; i++) {
+        usleep(1);
+    }
+    ASSERT_EQ(CommonPool::THREAD_COUNT, blockedWorkers.load());
+
+    auto background = CommonPool::async([&] { order.push_back(0); });
+    auto critical = CommonPool::asyncHighPriority([&] { order.push_back(1); });
+
+    // Release a single worker; it drains both queued tasks by itself, so the
+    // order it picks them in is exactly the lane priority.
+    {
+        std::unique_lock lock{mutex};
+        releasedWorkers = 1;
+        fence.notify_all();
+    }
+    background.get();
+    critical.get();
+
+    ASSERT_EQ(2u, order.size());
+    EXPECT_EQ(1, order[0]) << "high-priority task should run before the background task";
+    EXPECT_EQ(0, order[1]);
+
+    // Let the remaining workers go.
+    {
+        std::unique_lock lock{mutex};
+        releasedWorkers = CommonPool::THREAD_COUNT;
+        fence.notify_all();
+    }
+    for (auto& blocker : blockers) {
+        blocker.get();
+    }
+}
+
+TEST(CommonPool, stats) {
+    CommonPool::waitForIdle();
+    auto stats = CommonPool::stats();
+    EXPECT_EQ(0, stats.highPriorityQueueDepth);
+    EXPECT_EQ(0, stats.queueDepth);
+    EXPECT_EQ(CommonPool::THREAD_COUNT, stats.waitingThreads);
+}
+
 class ObjectTracker {
     static std::atomic_int sGlobalCount;
 
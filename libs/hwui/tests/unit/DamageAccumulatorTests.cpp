@@ -81,6 +81,52 @@ TEST(DamageAccumulator, union) {
     ASSERT_EQ(SkRect::MakeLTRB(50, 50, 200, 125), curDirty);
 }
 
+// Test that disjoint damage is reported as separate region rects while the
+// total dirty rect remains their union.
+TEST(DamageAccumulator, dirtyRegion) {
+    DamageAccumulator da;
+    SkRect curDirty;
+    LinearAllocator arena;
+    LsaVector<SkRect> region(LinearStdAllocator<SkRect>(arena));
+    da.pushTransform(&Matrix4::identity());
+    {
+        da.pushTransform(&Matrix4::identity());
+        da.dirty(0, 0, 10, 10);
+        da.popTransform();
+        da.pushTransform(&Matrix4::identity());
+        da.dirty(500, 500, 520, 520);
+        da.popTransform();
+    }
+    da.popTransform();
+    da.finish(&curDirty, &region);
+    ASSERT_EQ(SkRect::MakeLTRB(0, 0, 520, 520), curDirty);
+    ASSERT_EQ(2u, region.size());
+    ASSERT_EQ(SkRect::MakeLTRB(0, 0, 10, 10), region[0]);
+    ASSERT_EQ(SkRect::MakeLTRB(500, 500, 520, 520), region[1]);
+
+    // Overlapping damage folds into a single rect, and a single rect is not
+    // reported as a region.
+    da.pushTransform(&Matrix4::identity());
+    da.dirty(0, 0, 10, 10);
+    da.popTransform();
+    da.pushTransform(&Matrix4::identity());
+    da.dirty(5, 5, 20, 20);
+    da.popTransform();
+    da.finish(&curDirty, &region);
+    ASSERT_EQ(SkRect::MakeLTRB(0, 0, 20, 20), curDirty);
+    ASSERT_TRUE(region.empty());
+
+    // Once the rect budget is exhausted, further damage merges into the
+    // nearest tracked rect instead of growing the list.
+    for (int i = 0; i < DamageAccumulator::kMaxDamageRects + 2; i++) {
+        da.pushTransform(&Matrix4::identity());
+        da.dirty(i * 100, 0, i * 100 + 10, 10);
+        da.popTransform();
+    }
+    da.finish(&curDirty, &region);
+    ASSERT_EQ((size_t)DamageAccumulator::kMaxDamageRects, region.size());
+}
+
 TEST(DamageAccumulator, basicRenderNode) {
     DamageAccumulator da;
     RenderNode node1;
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2018 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <FrameMetricsRingObserver.h>
+
+#include <sys/eventfd.h>
+
+using namespace android;
+using namespace android::uirenderer;
+
+static constexpr size_t kNumIndexes = static_cast<size_t>(FrameInfoIndex::NumIndexes);
+
+static void makeStats(int64_t seed, int64_t* stats) {
+    for (size_t i = 0; i < kNumIndexes; i++) {
+        stats[i] = seed + i;
+    }
+}
+
+static bool batchSignalled(int fd) {
+    eventfd_t value;
+    return eventfd_read(fd, &value) == 0;
+}
+
+TEST(FrameMetricsRingObserver, drainsInOrder) {
+    sp<FrameMetricsRingObserver> observer = new FrameMetricsRingObserver(4, 1);
+    int64_t stats[kNumIndexes];
+
+    makeStats(100, stats);
+    observer->notify(stats);
+    makeStats(200, stats);
+    observer->notify(stats);
+
+    int dropCount = -1;
+    int64_t out[kNumIndexes];
+    ASSERT_TRUE(observer->nextFrame(out, &dropCount));
+    EXPECT_EQ(100, out[0]);
+    EXPECT_EQ(0, dropCount);
+    ASSERT_TRUE(observer->nextFrame(out, &dropCount));
+    EXPECT_EQ(200, out[0]);
+    EXPECT_EQ(0, dropCount);
+    EXPECT_FALSE(observer->nextFrame(out, &dropCount));
+}
+
+TEST(FrameMetricsRingObserver, signalsPerBatch) {
+    sp<FrameMetricsRingObserver> observer = new FrameMetricsRingObserver(8, 3);
+    int64_t stats[kNumIndexes];
+    makeStats(0, stats);
+
+    observer->notify(stats);
+    observer->notify(stats);
+    EXPECT_FALSE(batchSignalled(observer->fd()));
+
+    observer->notify(stats);
+    EXPECT_TRUE(batchSignalled(observer->fd()));
+    // EFD_SEMAPHORE: one read per completed batch.
+    EXPECT_FALSE(batchSignalled(observer->fd()));
+}
+
+TEST(FrameMetricsRingObserver, countsDropsWhenFull) {
+    sp<FrameMetricsRingObserver> observer = new FrameMetricsRingObserver(2, 1);
+    int64_t stats[kNumIndexes];
+
+    makeStats(1, stats);
+    observer->notify(stats);
+    makeStats(2, stats);
+    observer->notify(stats);
+    // Ring is full; these two are dropped.
+    makeStats(3, stats);
+    observer->notify(stats);
+    observer->notify(stats);
+
+    int dropCount = -1;
+    int64_t out[kNumIndexes];
+    ASSERT_TRUE(observer->nextFrame(out, &dropCount));
+    EXPECT_EQ(1, out[0]);
+    EXPECT_EQ(0, dropCount);
+
+    // A slot is free again; the next record carries the drop count.
+    makeStats(4, stats);
+    observer->notify(stats);
+    ASSERT_TRUE(observer->nextFrame(out, &dropCount));
+    EXPECT_EQ(2, out[0]);
+    ASSERT_TRUE(observer->nextFrame(out, &dropCount));
+    EXPECT_EQ(4, out[0]);
+    EXPECT_EQ(2, dropCount);
+}
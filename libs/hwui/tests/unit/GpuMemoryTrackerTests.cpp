@@ -23,6 +23,9 @@
 
 #include <utils/StrongPointer.h>
 
+#include <sstream>
+#include <string>
+
 using namespace android;
 using namespace android::uirenderer;
 using namespace android::uirenderer::renderthread;
@@ -63,3 +66,24 @@ TEST(GpuMemoryTracker, sizeCheck) {
     ASSERT_EQ(0, GpuMemoryTracker::getInstanceCount(GpuObjectType::Texture));
     GpuMemoryTracker::onGpuContextDestroyed();
 }
+
+TEST(GpuMemoryTracker, snapshotDiff) {
+    destroyEglContext();
+
+    GpuMemoryTracker::onGpuContextCreated();
+    {
+        TestGPUObject myObj;
+        myObj.changeSize(500);
+        GpuMemoryTracker::snapshot();
+        myObj.changeSize(2548);  // +2KiB
+        GpuMemoryTracker::snapshot();
+
+        std::stringstream stream;
+        GpuMemoryTracker::dumpSnapshots(stream);
+        std::string output = stream.str();
+        EXPECT_TRUE(output.find("Texture 500.00B (1)") != std::string::npos) << output;
+        EXPECT_TRUE(output.find("[+2.00KiB/+0]") != std::string::npos) << output;
+        EXPECT_TRUE(output.find("net over") != std::string::npos) << output;
+    }
+    GpuMemoryTracker::onGpuContextDestroyed();
+}
@@ -86,6 +86,53 @@ TEST(LinearAllocator, rewind) {
     EXPECT_EQ(1, destroyed);
 }
 
+TEST(LinearAllocator, snapshotRewind) {
+    int destroyed[3] = {0};
+    LinearAllocator la;
+    la.create<TestUtils::SignalingDtor>(destroyed);
+    size_t sizeAtSnapshot = la.usedSize();
+    LinearAllocator::Snapshot snapshot = la.snapshot();
+
+    la.create<TestUtils::SignalingDtor>(destroyed + 1);
+    la.create<TestUtils::SignalingDtor>(destroyed + 2);
+    la.alloc<char>(100);
+    EXPECT_LT(sizeAtSnapshot, la.usedSize());
+
+    la.rewindTo(snapshot);
+    // Only the objects created after the snapshot are destroyed
+    EXPECT_EQ(0, destroyed[0]);
+    EXPECT_EQ(1, destroyed[1]);
+    EXPECT_EQ(1, destroyed[2]);
+    EXPECT_EQ(sizeAtSnapshot, la.usedSize());
+
+    // The allocator must be reusable after a rewind
+    la.create<TestUtils::SignalingDtor>(destroyed + 1);
+    EXPECT_LT(sizeAtSnapshot, la.usedSize());
+}
+
+TEST(LinearAllocator, snapshotRewindAcrossPages) {
+    int destroyed = 0;
+    LinearAllocator la;
+    LinearAllocator::Snapshot snapshot = la.snapshot();
+    // Spill well past the first page, including a dedicated large allocation
+    for (int i = 0; i < 20; i++) {
+        la.alloc<char>(1024);
+    }
+    la.alloc<char>(200 * 1024);
+    la.create<TestUtils::SignalingDtor>(&destroyed);
+
+    la.rewindTo(snapshot);
+    EXPECT_EQ(1, destroyed);
+    EXPECT_EQ(0u, la.usedSize());
+
+    // A second cycle must behave just like the first
+    for (int i = 0; i < 20; i++) {
+        la.alloc<char>(1024);
+    }
+    la.rewindTo(snapshot);
+    EXPECT_EQ(0u, la.usedSize());
+}
+
 TEST(LinearStdAllocator, simpleAllocate) {
     LinearAllocator la;
     LinearStdAllocator<void*> stdAllocator(la);
@@ -35,6 +35,31 @@ TEST(Matrix, mapRect_emptyScaleSkew) {
     EXPECT_FALSE(empty.isEmpty()) << "Empty 'line' rect doesn't remain empty when skewed.";
 }
 
+TEST(Matrix, mapRects_matchesMapRect) {
+    Matrix4 matrices[4];
+    matrices[0].loadTranslate(5, -3, 0);
+    matrices[1].loadScale(2.5f, -4, 1);  // negative scale flips top/bottom
+    matrices[1].translate(10, 20);
+    matrices[2].loadRotate(30);
+    matrices[3].loadRotate(45);
+    matrices[3].data[Matrix4::kPerspective0] = 0.001f;
+    matrices[3].invalidateType();
+
+    Rect rects[3] = {Rect(0, 0, 100, 50), Rect(-20, -40, 30, 10), Rect(15, 20, 15, 100)};
+    for (const Matrix4& matrix : matrices) {
+        Rect batched[3];
+        Rect single[3];
+        for (int i = 0; i < 3; i++) {
+            batched[i] = single[i] = rects[i];
+            matrix.mapRect(single[i]);
+        }
+        matrix.mapRects(batched, 3);
+        for (int i = 0; i < 3; i++) {
+            EXPECT_EQ(single[i], batched[i]);
+        }
+    }
+}
+
 TEST(Matrix, mapRect_emptyRotate) {
     // Skew, so we don't hit identity/translate/simple fast paths
     Matrix4 skewMatrix;
@@ -86,5 +86,29 @@ TEST(Interpolator, pathInterpolation) {
         }
     }
 }
+
+TEST(Interpolator, batchMatchesScalar) {
+    const float in[] = {0.0f, 0.1f, 0.25f, 0.5f, 0.75f, 0.9f, 1.0f};
+    constexpr size_t count = sizeof(in) / sizeof(in[0]);
+
+    float* lut = new float[count];  // owned by LUTInterpolator
+    for (size_t i = 0; i < count; i++) {
+        lut[i] = in[i] * in[i];
+    }
+
+    std::unique_ptr<Interpolator> interpolators[] = {
+            std::unique_ptr<Interpolator>(new AccelerateDecelerateInterpolator()),
+            std::unique_ptr<Interpolator>(new LUTInterpolator(lut, count)),
+            std::unique_ptr<Interpolator>(new BounceInterpolator()),
+    };
+
+    for (auto& interpolator : interpolators) {
+        float out[count];
+        interpolator->interpolate(in, out, count);
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_FLOAT_EQ(interpolator->interpolate(in[i]), out[i]);
+        }
+    }
+}
 }
 }
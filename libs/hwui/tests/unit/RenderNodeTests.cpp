@@ -295,6 +295,41 @@ RENDERTHREAD_TEST(RenderNode, prepareTree_nullableDisplayList) {
     canvasContext->destroy();
 }
 
+RENDERTHREAD_TEST(RenderNode, prepareTree_maskedPropertySync) {
+    auto rootNode = TestUtils::createNode(0, 0, 200, 400, nullptr);
+    ContextFactory contextFactory;
+    std::unique_ptr<CanvasContext> canvasContext(
+            CanvasContext::create(renderThread, false, rootNode.get(), &contextFactory));
+    TreeInfo info(TreeInfo::MODE_FULL, *canvasContext.get());
+    DamageAccumulator damageAccumulator;
+    LayerUpdateQueue layerUpdateQueue;
+    info.damageAccumulator = &damageAccumulator;
+    info.layerUpdateQueue = &layerUpdateQueue;
+
+    auto node = TestUtils::createNode(0, 0, 200, 400, [](RenderProperties& props, Canvas& canvas) {
+        canvas.drawColor(Color::Red_500, SkBlendMode::kSrcOver);
+    });
+    TestUtils::syncHierarchyPropertiesAndDisplayList(node);
+    // Flush the all-dirty mask set at creation so the masked path below runs.
+    node->prepareTree(info);
+
+    // A precisely tagged change syncs just that field group.
+    node->mutateStagingProperties().setTranslationX(25);
+    node->setPropertyFieldsDirty(RenderNode::TRANSLATION_X | RenderNode::X);
+    node->prepareTree(info);
+    EXPECT_EQ(25, node->properties().getTranslationX());
+
+    // GENERIC still performs the full assignment.
+    node->mutateStagingProperties().setAlpha(0.5f);
+    node->mutateStagingProperties().setPivotX(10);
+    node->setPropertyFieldsDirty(RenderNode::GENERIC);
+    node->prepareTree(info);
+    EXPECT_EQ(0.5f, node->properties().getAlpha());
+    EXPECT_EQ(10, node->properties().getPivotX());
+
+    canvasContext->destroy();
+}
+
 // TODO: Is this supposed to work in SkiaGL/SkiaVK?
 RENDERTHREAD_TEST(DISABLED_RenderNode, prepareTree_HwLayer_AVD_enqueueDamage) {
     VectorDrawable::Group* group = new VectorDrawable::Group();
@@ -47,7 +47,8 @@ public:
      * Next call to "initShaderDiskCache" will load again the in-memory cache from disk.
      */
     static void terminate(ShaderCache& cache, bool saveContent) {
-        std::lock_guard<std::mutex> lock(cache.mMutex);
+        std::unique_lock<std::mutex> lock(cache.mMutex);
+        cache.mInitCondition.wait(lock, [&cache] { return !cache.mInitPending; });
         cache.mSavePending = saveContent;
         cache.saveToDiskLocked();
         cache.mBlobCache = NULL;
@@ -58,6 +59,8 @@ public:
      */
     template <typename T>
     static bool validateCache(ShaderCache& cache, std::vector<T> hash) {
+        std::unique_lock<std::mutex> lock(cache.mMutex);
+        cache.mInitCondition.wait(lock, [&cache] { return !cache.mInitPending; });
         return cache.validateCache(hash.data(), hash.size() * sizeof(T));
     }
 };
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <SkFont.h>
+#include <SkTextBlob.h>
 #include <VectorDrawable.h>
 #include <gtest/gtest.h>
 
@@ -93,6 +95,52 @@ TEST(SkiaDisplayList, reuseDisplayList) {
     ASSERT_EQ(availableList.get(), nullptr);
 }
 
+TEST(SkiaDisplayList, hasSameContentAs) {
+    auto record = [](SkColor color) {
+        SkiaRecordingCanvas canvas{nullptr, 100, 100};
+        SkPaint paint;
+        paint.setColor(color);
+        canvas.drawRect(10, 10, 60, 60, paint);
+        return std::unique_ptr<SkiaDisplayList>(canvas.finishRecording());
+    };
+
+    auto first = record(SK_ColorRED);
+    auto identical = record(SK_ColorRED);
+    auto recolored = record(SK_ColorBLUE);
+
+    EXPECT_TRUE(first->hasSameContentAs(*identical));
+    EXPECT_FALSE(first->hasSameContentAs(*recolored));
+
+    // Child node drawables are allocated per-list, so lists with children are
+    // never considered reusable.
+    SkCanvas dummyCanvas;
+    first->mChildNodes.emplace_back(nullptr, &dummyCanvas);
+    identical->mChildNodes.emplace_back(nullptr, &dummyCanvas);
+    EXPECT_FALSE(first->hasSameContentAs(*identical));
+}
+
+TEST(SkiaDisplayList, forEachTextBlob) {
+    SkiaRecordingCanvas canvas{nullptr, 100, 100};
+    sk_sp<SkTextBlob> blob = SkTextBlob::MakeFromString("prewarm", SkFont());
+    SkPaint red;
+    red.setColor(SK_ColorRED);
+    SkPaint blue;
+    blue.setColor(SK_ColorBLUE);
+    canvas.asSkCanvas()->drawTextBlob(blob, 0, 20, red);
+    canvas.drawRect(10, 10, 60, 60, red);  // non-text ops must be skipped
+    canvas.asSkCanvas()->drawTextBlob(blob, 0, 40, blue);
+    std::unique_ptr<SkiaDisplayList> list(canvas.finishRecording());
+
+    std::vector<SkColor> colors;
+    list->mDisplayList.forEachTextBlob([&](const SkTextBlob* visited, const SkPaint& paint) {
+        EXPECT_EQ(blob.get(), visited);
+        colors.push_back(paint.getColor());
+    });
+    ASSERT_EQ(2u, colors.size());
+    EXPECT_EQ(SK_ColorRED, colors[0]);
+    EXPECT_EQ(SK_ColorBLUE, colors[1]);
+}
+
 TEST(SkiaDisplayList, syncContexts) {
     SkiaDisplayList skiaDL;
 
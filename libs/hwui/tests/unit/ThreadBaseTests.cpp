@@ -20,6 +20,7 @@
 #include "utils/TimeUtils.h"
 
 #include <chrono>
+#include <thread>
 #include "unistd.h"
 
 using namespace android;
@@ -49,6 +50,44 @@ TEST(ThreadBase, post) {
     ASSERT_TRUE(ran) << "Failed to flip atomic after 1 second";
 }
 
+TEST(ThreadBase, postBurstOrdering) {
+    // A single producer's posts must run in order, and a multi-threaded burst
+    // must not lose any work.
+    constexpr int kPostCount = 200;
+    std::vector<int> ran;
+    std::mutex ranLock;
+    for (int i = 0; i < kPostCount; i++) {
+        queue().post([&, i]() {
+            std::lock_guard _lock{ranLock};
+            ran.push_back(i);
+        });
+    }
+    queue().runSync([]() {});
+    {
+        std::lock_guard _lock{ranLock};
+        ASSERT_EQ(kPostCount, (int)ran.size());
+        for (int i = 0; i < kPostCount; i++) {
+            ASSERT_EQ(i, ran[i]);
+        }
+    }
+
+    constexpr int kThreadCount = 4;
+    std::atomic_int totalRan(0);
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreadCount; t++) {
+        producers.emplace_back([&]() {
+            for (int i = 0; i < kPostCount; i++) {
+                queue().post([&totalRan]() { totalRan++; });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    queue().runSync([]() {});
+    ASSERT_EQ(kThreadCount * kPostCount, totalRan.load());
+}
+
 TEST(ThreadBase, postDelay) {
     using clock = WorkQueue::clock;
 
@@ -22,6 +22,7 @@
 #include "utils/VectorDrawableUtils.h"
 
 #include <functional>
+#include <string.h>
 
 namespace android {
 namespace uirenderer {
@@ -409,5 +410,62 @@ TEST(VectorDrawable, drawPathWithoutIncrementingShaderRefCount) {
     EXPECT_TRUE(shader->unique());
 }
 
+TEST(VectorDrawable, drawChildRangeMatchesFullDraw) {
+    VectorDrawable::Group* group = new VectorDrawable::Group();
+    const char* pathStrings[] = {"M0 0 h10 v10 h-10 z", "M10 10 h20 v20 h-20 z",
+                                 "M5 30 h15 v10 h-15 z"};
+    const SkColor colors[] = {SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE};
+    for (size_t i = 0; i < 3; i++) {
+        VectorDrawable::FullPath* path =
+                new VectorDrawable::FullPath(pathStrings[i], strlen(pathStrings[i]));
+        path->mutateStagingProperties()->setFillColor(colors[i]);
+        group->addChild(path);
+    }
+    sp<VectorDrawable::Tree> tree(new VectorDrawable::Tree(group));
+    EXPECT_EQ(3u, group->numChildren());
+    EXPECT_TRUE(group->childrenDrawIndependently());
+
+    SkBitmap full;
+    full.allocN32Pixels(50, 50);
+    full.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas fullCanvas(full);
+    group->draw(&fullCanvas, true);
+
+    // Rasterizing child ranges into separate layers and compositing them in
+    // order must produce the same image as the sequential walk.
+    SkBitmap layerA, layerB, sliced;
+    layerA.allocN32Pixels(50, 50);
+    layerA.eraseColor(SK_ColorTRANSPARENT);
+    layerB.allocN32Pixels(50, 50);
+    layerB.eraseColor(SK_ColorTRANSPARENT);
+    {
+        SkCanvas canvas(layerA);
+        group->drawChildRange(0, 1, &canvas, true);
+    }
+    {
+        SkCanvas canvas(layerB);
+        group->drawChildRange(1, 3, &canvas, true);
+    }
+    sliced.allocN32Pixels(50, 50);
+    sliced.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas slicedCanvas(sliced);
+    slicedCanvas.drawBitmap(layerA, 0, 0);
+    slicedCanvas.drawBitmap(layerB, 0, 0);
+
+    ASSERT_EQ(full.computeByteSize(), sliced.computeByteSize());
+    EXPECT_EQ(0, memcmp(full.getPixels(), sliced.getPixels(), full.computeByteSize()));
+}
+
+TEST(VectorDrawable, clipPathChildrenAreNotIndependent) {
+    VectorDrawable::Group* group = new VectorDrawable::Group();
+    group->addChild(new VectorDrawable::FullPath("M0 0 h10 v10 z", 14));
+    group->addChild(new VectorDrawable::ClipPath("M0 0 h5 v5 z", 12));
+    group->addChild(new VectorDrawable::FullPath("M0 0 h20 v20 z", 14));
+    sp<VectorDrawable::Tree> tree(new VectorDrawable::Tree(group));
+    // The clip applies to the sibling after it, so the children cannot be
+    // rasterized into independent layers.
+    EXPECT_FALSE(group->childrenDrawIndependently());
+}
+
 }  // namespace uirenderer
 }  // namespace android
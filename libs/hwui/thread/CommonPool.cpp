@@ -55,34 +55,54 @@ CommonPool& CommonPool::instance() {
 }
 
 void CommonPool::post(Task&& task) {
-    instance().enqueue(std::move(task));
+    instance().enqueue(std::move(task), false /* highPriority */);
 }
 
-void CommonPool::enqueue(Task&& task) {
+void CommonPool::postHighPriority(Task&& task) {
+    instance().enqueue(std::move(task), true /* highPriority */);
+}
+
+void CommonPool::enqueue(Task&& task, bool highPriority) {
     std::unique_lock lock(mLock);
-    while (!mWorkQueue.hasSpace()) {
+    auto& queue = highPriority ? mHighPriorityQueue : mWorkQueue;
+    while (!queue.hasSpace()) {
         lock.unlock();
         usleep(100);
         lock.lock();
     }
-    mWorkQueue.push(std::move(task));
-    if (mWaitingThreads == THREAD_COUNT || (mWaitingThreads > 0 && mWorkQueue.size() > 1)) {
+    queue.push(std::move(task));
+    const int queued = mHighPriorityQueue.size() + mWorkQueue.size();
+    if (mWaitingThreads == THREAD_COUNT || (mWaitingThreads > 0 && queued > 1)) {
         mCondition.notify_one();
     }
 }
 
+CommonPool::Stats CommonPool::stats() {
+    return instance().doStats();
+}
+
+CommonPool::Stats CommonPool::doStats() {
+    std::unique_lock lock(mLock);
+    Stats stats;
+    stats.highPriorityQueueDepth = mHighPriorityQueue.size();
+    stats.queueDepth = mWorkQueue.size();
+    stats.waitingThreads = mWaitingThreads;
+    return stats;
+}
+
 void CommonPool::workerLoop() {
     std::unique_lock lock(mLock);
     while (true) {
-        if (!mWorkQueue.hasWork()) {
+        if (!mHighPriorityQueue.hasWork() && !mWorkQueue.hasWork()) {
             mWaitingThreads++;
             mCondition.wait(lock);
             mWaitingThreads--;
         }
         // Need to double-check that work is still available now that we have the lock
         // It may have already been grabbed by a different thread
-        while (mWorkQueue.hasWork()) {
-            auto work = mWorkQueue.pop();
+        while (mHighPriorityQueue.hasWork() || mWorkQueue.hasWork()) {
+            // Frame-critical tasks always run ahead of the regular queue.
+            auto work = mHighPriorityQueue.hasWork() ? mHighPriorityQueue.pop() : mWorkQueue.pop();
             lock.unlock();
             work();
             lock.lock();
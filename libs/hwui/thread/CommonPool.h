@@ -42,10 +42,10 @@ public:
     constexpr bool hasWork() const { return mHead != mTail; }
     constexpr bool hasSpace() const { return ((mHead + 1) % SIZE) != mTail; }
     constexpr int size() const {
-        if (mHead > mTail) {
+        if (mHead >= mTail) {
             return mHead - mTail;
         } else {
-            return mTail - mHead + SIZE;
+            return mHead - mTail + SIZE;
         }
     }
 
@@ -80,8 +80,20 @@ public:
     static constexpr auto THREAD_COUNT = 2;
     static constexpr auto QUEUE_SIZE = 128;
 
+    // Queue depths and worker state, snapshotted under the pool lock.
+    struct Stats {
+        int highPriorityQueueDepth;
+        int queueDepth;
+        int waitingThreads;
+    };
+
     static void post(Task&& func);
 
+    // Posts a task to the high-priority lane, which workers drain before the regular queue.
+    // For frame-critical work (e.g. layer updates) that must not sit behind background tasks
+    // like cache writes.
+    static void postHighPriority(Task&& func);
+
     template <class F>
     static auto async(F&& func) -> std::future<decltype(func())> {
         typedef std::packaged_task<decltype(func())()> task_t;
@@ -90,6 +102,16 @@ public:
         return task->get_future();
     }
 
+    template <class F>
+    static auto asyncHighPriority(F&& func) -> std::future<decltype(func())> {
+        typedef std::packaged_task<decltype(func())()> task_t;
+        auto task = std::make_shared<task_t>(std::forward<F>(func));
+        postHighPriority([task]() { std::invoke(*task); });
+        return task->get_future();
+    }
+
+    static Stats stats();
+
     template <class F>
     static auto runSync(F&& func) -> decltype(func()) {
         std::packaged_task<decltype(func())()> task{std::forward<F>(func)};
@@ -106,7 +128,8 @@ private:
     CommonPool();
     ~CommonPool() {}
 
-    void enqueue(Task&&);
+    void enqueue(Task&&, bool highPriority);
+    Stats doStats();
     void doWaitForIdle();
 
     void workerLoop();
@@ -114,6 +137,7 @@ private:
     std::mutex mLock;
     std::condition_variable mCondition;
     int mWaitingThreads = 0;
+    ArrayQueue<Task, QUEUE_SIZE> mHighPriorityQueue;
     ArrayQueue<Task, QUEUE_SIZE> mWorkQueue;
 };
 
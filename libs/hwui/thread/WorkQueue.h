@@ -22,6 +22,7 @@
 #include <log/log.h>
 #include <utils/Timers.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <future>
@@ -59,7 +60,17 @@ public:
     WorkQueue(std::function<void()>&& wakeFunc, std::mutex& lock)
             : mWakeFunc(move(wakeFunc)), mLock(lock) {}
 
+    ~WorkQueue() {
+        ImmediateItem* item = mImmediateHead.exchange(nullptr);
+        while (item) {
+            ImmediateItem* next = item->next;
+            delete item;
+            item = next;
+        }
+    }
+
     void process() {
+        processImmediate();
         auto now = clock::now();
         std::vector<WorkItem> toProcess;
         {
@@ -91,7 +102,7 @@ public:
 
     template <class F>
     void post(F&& func) {
-        postAt(0, std::forward<F>(func));
+        enqueueImmediate(std::function<void()>(std::forward<F>(func)));
     }
 
     template <class F>
@@ -110,6 +121,9 @@ public:
     };
 
     nsecs_t nextWakeup(std::unique_lock<std::mutex>& lock) {
+        if (mImmediateHead.load(std::memory_order_relaxed)) {
+            return 0;
+        }
         if (mWorkQueue.empty()) {
             return std::numeric_limits<nsecs_t>::max();
         } else {
@@ -118,6 +132,48 @@ public:
     }
 
 private:
+    // Immediate work (post/async/runSync) skips the mutex-guarded sorted
+    // vector and goes through this lock-free MPSC list instead; only timed
+    // work still pays for the lock and the sorted insert.
+    struct ImmediateItem {
+        explicit ImmediateItem(std::function<void()>&& work) : work(std::move(work)) {}
+
+        ImmediateItem* next = nullptr;
+        std::function<void()> work;
+    };
+
+    void enqueueImmediate(std::function<void()>&& func) {
+        ImmediateItem* item = new ImmediateItem{std::move(func)};
+        ImmediateItem* head = mImmediateHead.load(std::memory_order_relaxed);
+        do {
+            item->next = head;
+        } while (!mImmediateHead.compare_exchange_weak(head, item, std::memory_order_release,
+                                                       std::memory_order_relaxed));
+        // Only the producer that found the list empty wakes the consumer, so
+        // a burst of posts from animators costs a single wakeup.
+        if (!head) {
+            mWakeFunc();
+        }
+    }
+
+    void processImmediate() {
+        ImmediateItem* item = mImmediateHead.exchange(nullptr, std::memory_order_acquire);
+        // The list pops in LIFO order; reverse it to run in post order.
+        ImmediateItem* pending = nullptr;
+        while (item) {
+            ImmediateItem* next = item->next;
+            item->next = pending;
+            pending = item;
+            item = next;
+        }
+        while (pending) {
+            ImmediateItem* next = pending->next;
+            pending->work();
+            delete pending;
+            pending = next;
+        }
+    }
+
     void enqueue(WorkItem&& item) {
         bool needsWakeup;
         {
@@ -137,6 +193,7 @@ private:
 
     std::mutex& mLock;
     std::vector<WorkItem> mWorkQueue;
+    std::atomic<ImmediateItem*> mImmediateHead{nullptr};
 };
 
 }  // namespace android::uirenderer
@@ -216,6 +216,63 @@ void LinearAllocator::rewindIfLastAlloc(void* ptr, size_t allocSize) {
     }
 }
 
+LinearAllocator::Snapshot LinearAllocator::snapshot() const {
+    Snapshot s;
+    s.currentPage = mCurrentPage;
+    s.next = mNext;
+    s.pages = mPages;
+    s.dtorList = mDtorList;
+    s.pageSize = mPageSize;
+    s.maxAllocSize = mMaxAllocSize;
+    s.totalAllocated = mTotalAllocated;
+    s.wastedSpace = mWastedSpace;
+    s.pageCount = mPageCount;
+    s.dedicatedPageCount = mDedicatedPageCount;
+    return s;
+}
+
+void LinearAllocator::rewindTo(const Snapshot& snapshot) {
+    // The destructor list is LIFO, so this unwinds objects created since the
+    // snapshot in reverse allocation order. Must happen before any page is
+    // freed since the nodes live in those pages.
+    while (mDtorList != snapshot.dtorList) {
+        auto node = mDtorList;
+        mDtorList = node->next;
+        node->dtor(node->addr);
+    }
+    // Dedicated pages created since the snapshot were prepended to the list.
+    while (mPages != snapshot.pages) {
+        Page* next = mPages->next();
+        mPages->~Page();
+        free(mPages);
+        RM_ALLOCATION();
+        mPages = next;
+    }
+    // Normal pages created since the snapshot were chained after its current
+    // page. They are freed rather than kept for reuse because pages don't
+    // record their own size, so end() is only computable for pages allocated
+    // under the current mPageSize.
+    Page* p = snapshot.currentPage ? snapshot.currentPage->next() : nullptr;
+    while (p) {
+        Page* next = p->next();
+        p->~Page();
+        free(p);
+        RM_ALLOCATION();
+        p = next;
+    }
+    if (snapshot.currentPage) {
+        snapshot.currentPage->setNext(nullptr);
+    }
+    mCurrentPage = snapshot.currentPage;
+    mNext = snapshot.next;
+    mPageSize = snapshot.pageSize;
+    mMaxAllocSize = snapshot.maxAllocSize;
+    mTotalAllocated = snapshot.totalAllocated;
+    mWastedSpace = snapshot.wastedSpace;
+    mPageCount = snapshot.pageCount;
+    mDedicatedPageCount = snapshot.dedicatedPageCount;
+}
+
 LinearAllocator::Page* LinearAllocator::newPage(size_t pageSize) {
     pageSize = ALIGN(pageSize + sizeof(LinearAllocator::Page));
     ADD_ALLOCATION();
@@ -41,6 +41,9 @@ namespace uirenderer {
  * allocations.
  */
 class LinearAllocator {
+    class Page;
+    struct DestructorNode;
+
 public:
     LinearAllocator();
     ~LinearAllocator();
@@ -105,6 +108,39 @@ public:
         rewindIfLastAlloc((void*)ptr, sizeof(T));
     }
 
+    /**
+     * An opaque marker of the allocator's current position, taken with
+     * snapshot() and restored with rewindTo(). While a snapshot is
+     * outstanding, objects allocated before it must not be individually
+     * destroyed with rewindIfLastAlloc(); snapshots must be rewound in
+     * reverse order of creation.
+     */
+    struct Snapshot {
+    private:
+        friend class LinearAllocator;
+        Page* currentPage;
+        void* next;
+        Page* pages;
+        DestructorNode* dtorList;
+        size_t pageSize;
+        size_t maxAllocSize;
+        size_t totalAllocated;
+        size_t wastedSpace;
+        size_t pageCount;
+        size_t dedicatedPageCount;
+    };
+
+    Snapshot snapshot() const;
+
+    /**
+     * Releases everything allocated since the given snapshot, running the
+     * destructors of non-trivial objects in reverse allocation order. Pages
+     * that already existed at the snapshot are kept for reuse, so rewinding
+     * at a recurring checkpoint (e.g. per frame) reaches a steady state with
+     * no page churn.
+     */
+    void rewindTo(const Snapshot& snapshot);
+
     /**
      * Dump memory usage statistics to the log (allocated and wasted space)
      */
@@ -119,7 +155,6 @@ public:
 private:
     LinearAllocator(const LinearAllocator& other);
 
-    class Page;
     typedef void (*Destructor)(void* addr);
     struct DestructorNode {
         Destructor dtor;
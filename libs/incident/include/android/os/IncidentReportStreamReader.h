@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2018, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ANDROID_OS_INCIDENT_REPORT_STREAM_READER_H_
+#define ANDROID_OS_INCIDENT_REPORT_STREAM_READER_H_
+
+#include <utils/Errors.h>
+
+#include <vector>
+
+namespace android {
+namespace os {
+
+using namespace std;
+
+/**
+ * Incrementally parses an incident report as it is streamed from incidentd.
+ *
+ * An incident report is a sequence of length-delimited protobuf fields, where
+ * the field number is the section id.  incidentd writes each section to the
+ * stream as soon as that section's data collection finishes, so a caller that
+ * reads with this class sees early sections while slow ones are still being
+ * gathered, instead of waiting for the whole report.
+ *
+ * The reader does not own the file descriptor and never closes it.
+ */
+class IncidentReportStreamReader {
+public:
+    explicit IncidentReportStreamReader(int fd);
+    ~IncidentReportStreamReader();
+
+    /**
+     * Block until the next complete section has been read from the stream.
+     *
+     * On success returns NO_ERROR and fills in the section id and its
+     * serialized protobuf payload.  Returns NOT_ENOUGH_DATA once the writer
+     * has closed the stream cleanly at a section boundary, BAD_VALUE if the
+     * stream is malformed or truncated mid-section, or -errno for read
+     * failures.
+     */
+    status_t nextSection(int* sectionId, vector<uint8_t>* data);
+
+private:
+    // Reads a varint.  Returns NO_ERROR, NOT_ENOUGH_DATA if the stream ended
+    // before the first byte, or BAD_VALUE if it ended in the middle of one.
+    status_t read_varint(uint64_t* result);
+
+    int mFd;
+};
+
+}
+}
+
+#endif // ANDROID_OS_INCIDENT_REPORT_STREAM_READER_H_
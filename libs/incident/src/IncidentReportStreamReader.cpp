@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2018, The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "incident"
+
+#include <android/os/IncidentReportStreamReader.h>
+
+#include <log/log.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+namespace android {
+namespace os {
+
+// Wire type for length-delimited protobuf fields; every incident report
+// section is framed this way by incidentd's write_section_header().
+const uint32_t WIRE_TYPE_LENGTH_DELIMITED = 2;
+
+// Refuse sections claiming to be larger than this; a bad length prefix must
+// not make us buffer unbounded amounts of data.  Matches incidentd's cap on
+// the data an individual section may produce.
+const uint64_t MAX_SECTION_SIZE = 96 * 1024 * 1024;
+
+static ssize_t
+read_all(int fd, uint8_t* buf, size_t size)
+{
+    size_t pos = 0;
+    while (pos < size) {
+        ssize_t amt = TEMP_FAILURE_RETRY(read(fd, buf + pos, size - pos));
+        if (amt < 0) {
+            return -errno;
+        } else if (amt == 0) {
+            break;
+        }
+        pos += amt;
+    }
+    return pos;
+}
+
+IncidentReportStreamReader::IncidentReportStreamReader(int fd)
+    :mFd(fd)
+{
+}
+
+IncidentReportStreamReader::~IncidentReportStreamReader()
+{
+}
+
+status_t
+IncidentReportStreamReader::read_varint(uint64_t* result)
+{
+    uint64_t value = 0;
+    int shift = 0;
+    for (;;) {
+        uint8_t byte;
+        ssize_t amt = TEMP_FAILURE_RETRY(read(mFd, &byte, 1));
+        if (amt < 0) {
+            return -errno;
+        } else if (amt == 0) {
+            // End of stream.  Only clean if no varint was in progress.
+            return shift == 0 ? NOT_ENOUGH_DATA : BAD_VALUE;
+        }
+        if (shift >= 64) {
+            ALOGW("Incident report stream contains an overlong varint");
+            return BAD_VALUE;
+        }
+        value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            *result = value;
+            return NO_ERROR;
+        }
+        shift += 7;
+    }
+}
+
+status_t
+IncidentReportStreamReader::nextSection(int* sectionId, vector<uint8_t>* data)
+{
+    uint64_t tag;
+    status_t err = read_varint(&tag);
+    if (err != NO_ERROR) {
+        return err;
+    }
+    if ((tag & 0x7) != WIRE_TYPE_LENGTH_DELIMITED) {
+        ALOGW("Incident report stream has unexpected wire type %d",
+                int(tag & 0x7));
+        return BAD_VALUE;
+    }
+
+    uint64_t size;
+    err = read_varint(&size);
+    if (err == NOT_ENOUGH_DATA) {
+        // The tag was read, so the stream ended mid-section.
+        return BAD_VALUE;
+    } else if (err != NO_ERROR) {
+        return err;
+    }
+    if (size > MAX_SECTION_SIZE) {
+        ALOGW("Incident report stream section claims %llu bytes; rejecting",
+                (unsigned long long)size);
+        return BAD_VALUE;
+    }
+
+    data->resize(size);
+    ssize_t amt = read_all(mFd, data->data(), size);
+    if (amt < 0) {
+        return amt;
+    } else if (size_t(amt) != size) {
+        ALOGW("Incident report stream truncated inside a section");
+        return BAD_VALUE;
+    }
+
+    *sectionId = int(tag >> 3);
+    return NO_ERROR;
+}
+
+}
+}
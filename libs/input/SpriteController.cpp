@@ -147,6 +147,7 @@ void SpriteController::doUpdateSprites() {
     // Resize and/or reparent sprites if needed.
     SurfaceComposerClient::Transaction t;
     bool needApplyTransaction = false;
+    bool surfaceResized = false;
     for (size_t i = 0; i < numSprites; i++) {
         SpriteUpdate& update = updates.editItemAt(i);
         if (update.state.surfaceControl == nullptr) {
@@ -159,6 +160,7 @@ void SpriteController::doUpdateSprites() {
             if (update.state.surfaceWidth < desiredWidth
                     || update.state.surfaceHeight < desiredHeight) {
                 needApplyTransaction = true;
+                surfaceResized = true;
 
                 t.setSize(update.state.surfaceControl,
                         desiredWidth, desiredHeight);
@@ -180,8 +182,13 @@ void SpriteController::doUpdateSprites() {
             needApplyTransaction = true;
         }
     }
-    if (needApplyTransaction) {
+    // Only a resize has to reach the composer before the redraw below, so
+    // that locking the surface hands back a buffer of the new size.  Layer
+    // stack changes just stay queued in the transaction and ride along with
+    // the property updates applied at the end of the pass.
+    if (surfaceResized) {
         t.apply();
+        needApplyTransaction = false;
     }
 
     // Redraw sprites if needed.
@@ -234,7 +241,6 @@ void SpriteController::doUpdateSprites() {
         }
     }
 
-    needApplyTransaction = false;
     for (size_t i = 0; i < numSprites; i++) {
         SpriteUpdate& update = updates.editItemAt(i);
 
@@ -382,23 +388,39 @@ void SpriteController::SpriteImpl::setIcon(const SpriteIcon& icon) {
 
     uint32_t dirty;
     if (icon.isValid()) {
-        SkBitmap* bitmapCopy = &mLocked.state.icon.bitmap;
-        if (bitmapCopy->tryAllocPixels(icon.bitmap.info().makeColorType(kN32_SkColorType))) {
-            icon.bitmap.readPixels(bitmapCopy->info(), bitmapCopy->getPixels(),
-                    bitmapCopy->rowBytes(), 0, 0);
+        // Pointer trails and drag shadows re-post the same icon at input
+        // rate.  The bitmap's generation id identifies its pixels, so a
+        // match means the copy retained from an earlier call is still
+        // current and no reallocation, pixel copy or surface redraw is
+        // needed.
+        const uint32_t generationId = icon.bitmap.getGenerationID();
+        const bool samePixels = mLocked.state.icon.isValid()
+                && mLocked.state.iconGenerationId == generationId;
+        const bool hotSpotChanged = !mLocked.state.icon.isValid()
+                || mLocked.state.icon.hotSpotX != icon.hotSpotX
+                || mLocked.state.icon.hotSpotY != icon.hotSpotY;
+        if (samePixels && !hotSpotChanged) {
+            return; // nothing changed
         }
 
-        if (!mLocked.state.icon.isValid()
-                || mLocked.state.icon.hotSpotX != icon.hotSpotX
-                || mLocked.state.icon.hotSpotY != icon.hotSpotY) {
+        if (!samePixels) {
+            SkBitmap* bitmapCopy = &mLocked.state.icon.bitmap;
+            if (bitmapCopy->tryAllocPixels(icon.bitmap.info().makeColorType(kN32_SkColorType))) {
+                icon.bitmap.readPixels(bitmapCopy->info(), bitmapCopy->getPixels(),
+                        bitmapCopy->rowBytes(), 0, 0);
+            }
+            mLocked.state.iconGenerationId = generationId;
+        }
+
+        dirty = samePixels ? 0 : DIRTY_BITMAP;
+        if (hotSpotChanged) {
             mLocked.state.icon.hotSpotX = icon.hotSpotX;
             mLocked.state.icon.hotSpotY = icon.hotSpotY;
-            dirty = DIRTY_BITMAP | DIRTY_HOTSPOT;
-        } else {
-            dirty = DIRTY_BITMAP;
+            dirty |= DIRTY_HOTSPOT;
         }
     } else if (mLocked.state.icon.isValid()) {
         mLocked.state.icon.bitmap.reset();
+        mLocked.state.iconGenerationId = 0;
         dirty = DIRTY_BITMAP | DIRTY_HOTSPOT;
     } else {
         return; // setting to invalid icon and already invalid so nothing to do
@@ -191,6 +191,9 @@ private:
         uint32_t dirty;
 
         SpriteIcon icon;
+        // Generation id of the source bitmap the retained icon copy was made
+        // from, used to recognize when setIcon() re-posts the same pixels.
+        uint32_t iconGenerationId = 0;
         bool visible;
         float positionX;
         float positionY;
@@ -46,6 +46,21 @@ public:
     explicit EncodedBuffer(size_t chunkSize);
     virtual ~EncodedBuffer();
 
+    /**
+     * Returns a cleared buffer from the process-wide pool, or a new one if the
+     * pool is empty. A pooled buffer keeps the chunk chain of its previous use,
+     * so repeated sessions of similar size write without allocating.
+     */
+    static sp<EncodedBuffer> obtain();
+
+    /**
+     * Returns a buffer obtained from obtain() to the pool. The caller must not
+     * touch the buffer afterwards, and no ProtoReader returned by read() may
+     * still be in use. Oversized buffers are dropped instead of pooled so one
+     * huge session does not pin its memory forever.
+     */
+    static void recycle(const sp<EncodedBuffer>& buffer);
+
     class Pointer {
     public:
         Pointer();
@@ -79,6 +94,11 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Returns the total number of bytes the allocated chunks can hold.
+     */
+    size_t capacity() const;
+
     /**
      * Returns the write pointer.
      */
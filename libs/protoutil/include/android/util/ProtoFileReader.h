@@ -70,6 +70,67 @@ private:
     bool ensure_data();
 };
 
+/**
+ * A ProtoReader over a memory mapped file.
+ *
+ * Maps the file in large chunks instead of copying it through a read buffer,
+ * so readBuffer() hands consumers ranges of the mapped file itself.  Each
+ * chunk is advised MADV_SEQUENTIAL and unmapped before the next one is
+ * mapped, which bounds both address space use and page cache pressure on
+ * multi-hundred-megabyte files.
+ */
+class ProtoFileMapReader : public ProtoReader
+{
+public:
+    /**
+     * Returns a reader that starts at the fd's current offset, or NULL if the
+     * fd cannot be mapped (pipes, sockets).  Callers should fall back to
+     * ProtoFileReader in that case.
+     */
+    static sp<ProtoFileMapReader> tryCreate(int fd);
+
+    /**
+     * Unmaps the current chunk.  Does NOT close the file.
+     */
+    virtual ~ProtoFileMapReader();
+
+    // From ProtoReader.
+    virtual ssize_t size() const;
+    virtual size_t bytesRead() const;
+    virtual uint8_t const* readBuffer();
+    virtual size_t currentToRead();
+    virtual bool hasNext();
+    virtual uint8_t next();
+    virtual uint64_t readRawVarint();
+    virtual void move(size_t amt);
+
+    status_t getError() const;
+private:
+    ProtoFileMapReader(int fd, off_t start, size_t size);
+
+    // How much of the file is mapped at once.  Bounds address space use while
+    // keeping the remap rate negligible.
+    static const size_t kChunkSize = 4 * 1024 * 1024;
+
+    int mFd;                // File descriptor for input.
+    status_t mStatus;       // Any errors encountered during mapping.
+    off_t mStart;           // File offset where reading began.
+    size_t mSize;           // Bytes from mStart to the end of the file.
+    size_t mPos;            // How much data has been read so far.
+    void* mMapping;         // Current mapped chunk, or NULL.
+    size_t mMappingSize;    // Size of the current mapping, including alignment slop.
+    size_t mOffset;         // Read offset in the current mapping.
+    size_t mMaxOffset;      // End of valid data in the current mapping.
+    off_t mNextChunkStart;  // File offset of the next chunk to map.
+
+    /**
+     * Same contract as ProtoFileReader::ensure_data, except that running out
+     * of the current chunk unmaps it and maps the next one.
+     */
+    bool ensure_data();
+    bool map_next_chunk();
+};
+
 }
 }
 
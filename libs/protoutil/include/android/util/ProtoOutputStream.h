@@ -90,6 +90,13 @@ class ProtoOutputStream
 {
 public:
     ProtoOutputStream();
+    /**
+     * Constructs a stream that writes into the given buffer, which is cleared
+     * first. Lets callers run repeated encode sessions over one buffer, e.g.
+     * obtained from EncodedBuffer::obtain(); the caller stays responsible for
+     * recycling it once the serialized data is no longer referenced.
+     */
+    explicit ProtoOutputStream(const sp<EncodedBuffer>& buffer);
     ~ProtoOutputStream();
 
     /**
@@ -103,6 +110,15 @@ public:
     bool write(uint64_t fieldId, std::string val);
     bool write(uint64_t fieldId, const char* val, size_t size);
 
+    /**
+     * Bulk write APIs for repeated varint fields. Encodes the tag and value pairs
+     * into scratch slabs that are copied into the buffer in one pass each, which is
+     * considerably cheaper than a write() call per element for large arrays such as
+     * histogram buckets. The wire bytes are identical to the per-element calls.
+     */
+    bool writeRepeated(uint64_t fieldId, const int32_t* vals, size_t count);
+    bool writeRepeated(uint64_t fieldId, const int64_t* vals, size_t count);
+
     /**
      * Starts a sub-message write session.
      * Returns a token of this write session.
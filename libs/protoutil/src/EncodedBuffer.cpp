@@ -17,6 +17,8 @@
 
 #include <stdlib.h>
 
+#include <mutex>
+
 #include <android/util/EncodedBuffer.h>
 #include <android/util/protobuf.h>
 #include <cutils/log.h>
@@ -26,6 +28,15 @@ namespace util {
 
 const size_t BUFFER_SIZE = 8 * 1024; // 8 KB
 
+// Pool shared by obtain()/recycle(). Kept small: the point is to reuse the
+// chunk chains of the few encoder sessions a process runs back to back, not
+// to cache every buffer ever created.
+const size_t MAX_POOLED_BUFFERS = 4;
+const size_t MAX_POOLED_CAPACITY = 256 * 1024; // per buffer
+
+static std::mutex sPoolLock;
+static std::vector<sp<EncodedBuffer>> sPool;
+
 EncodedBuffer::Pointer::Pointer() : Pointer(BUFFER_SIZE)
 {
 }
@@ -102,6 +113,32 @@ EncodedBuffer::~EncodedBuffer()
     }
 }
 
+sp<EncodedBuffer>
+EncodedBuffer::obtain()
+{
+    {
+        std::lock_guard<std::mutex> lock(sPoolLock);
+        if (!sPool.empty()) {
+            sp<EncodedBuffer> buffer = sPool.back();
+            sPool.pop_back();
+            return buffer;
+        }
+    }
+    return new EncodedBuffer();
+}
+
+void
+EncodedBuffer::recycle(const sp<EncodedBuffer>& buffer)
+{
+    if (buffer == NULL) return;
+    buffer->clear();
+    std::lock_guard<std::mutex> lock(sPoolLock);
+    if (sPool.size() >= MAX_POOLED_BUFFERS || buffer->capacity() > MAX_POOLED_CAPACITY) {
+        return;
+    }
+    sPool.push_back(buffer);
+}
+
 inline uint8_t*
 EncodedBuffer::at(const Pointer& p) const
 {
@@ -122,6 +159,12 @@ EncodedBuffer::size() const
     return mWp.pos();
 }
 
+size_t
+EncodedBuffer::capacity() const
+{
+    return mBuffers.size() * mChunkSize;
+}
+
 EncodedBuffer::Pointer*
 EncodedBuffer::wp()
 {
@@ -160,6 +203,20 @@ EncodedBuffer::writeRawByte(uint8_t val)
 size_t
 EncodedBuffer::writeRawVarint64(uint64_t val)
 {
+    // A varint takes at most 10 bytes; when they all fit in the current chunk,
+    // encode straight into it with a single bounds check and pointer move
+    // instead of one per byte.
+    if (currentToWrite() >= 10 && writeBuffer() != NULL) {
+        uint8_t* buf = at(mWp);
+        size_t size = 0;
+        while ((val & ~UINT64_C(0x7F)) != 0) {
+            buf[size++] = (uint8_t)((val & 0x7F) | 0x80);
+            val >>= 7;
+        }
+        buf[size++] = (uint8_t)val;
+        mWp.move(size);
+        return size;
+    }
     size_t size = 0;
     while (true) {
         size++;
@@ -21,6 +21,9 @@
 #include <cinttypes>
 #include <type_traits>
 
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 namespace android {
@@ -160,6 +163,175 @@ ProtoFileReader::ensure_data() {
     }
 }
 
+// =========================================================================
+sp<ProtoFileMapReader>
+ProtoFileMapReader::tryCreate(int fd)
+{
+    off_t current = lseek(fd, 0, SEEK_CUR);
+    if (current < 0) {
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < current) {
+        return NULL;
+    }
+    // Probe a mapping now so an unmappable fd fails here instead of on the
+    // first read.
+    if (st.st_size > 0) {
+        void* probe = mmap(NULL, 1, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (probe == MAP_FAILED) {
+            return NULL;
+        }
+        munmap(probe, 1);
+    }
+    return new ProtoFileMapReader(fd, current, st.st_size - current);
+}
+
+ProtoFileMapReader::ProtoFileMapReader(int fd, off_t start, size_t size)
+        :mFd(fd),
+         mStatus(NO_ERROR),
+         mStart(start),
+         mSize(size),
+         mPos(0),
+         mMapping(NULL),
+         mMappingSize(0),
+         mOffset(0),
+         mMaxOffset(0),
+         mNextChunkStart(start) {
+}
+
+ProtoFileMapReader::~ProtoFileMapReader()
+{
+    if (mMapping != NULL) {
+        munmap(mMapping, mMappingSize);
+    }
+}
+
+ssize_t
+ProtoFileMapReader::size() const
+{
+    return (ssize_t)mSize;
+}
+
+size_t
+ProtoFileMapReader::bytesRead() const
+{
+    return mPos;
+}
+
+uint8_t const*
+ProtoFileMapReader::readBuffer()
+{
+    return hasNext() ? (uint8_t const*)mMapping + mOffset : NULL;
+}
+
+size_t
+ProtoFileMapReader::currentToRead()
+{
+    return mMaxOffset - mOffset;
+}
+
+bool
+ProtoFileMapReader::hasNext()
+{
+    return ensure_data();
+}
+
+uint8_t
+ProtoFileMapReader::next()
+{
+    if (!ensure_data()) {
+        // Shouldn't get to here.  Always call hasNext() before calling next().
+        return 0;
+    }
+    mPos++;
+    return ((uint8_t const*)mMapping)[mOffset++];
+}
+
+uint64_t
+ProtoFileMapReader::readRawVarint()
+{
+    uint64_t val = 0, shift = 0;
+    while (true) {
+        if (!hasNext()) {
+            ALOGW("readRawVarint() called without hasNext() called first.");
+            mStatus = NOT_ENOUGH_DATA;
+            return 0;
+        }
+        uint8_t byte = next();
+        val |= (INT64_C(0x7F) & byte) << shift;
+        if ((byte & 0x80) == 0) break;
+        shift += 7;
+    }
+    return val;
+}
+
+void
+ProtoFileMapReader::move(size_t amt)
+{
+    while (mStatus == NO_ERROR && amt > 0) {
+        if (!ensure_data()) {
+            return;
+        }
+        const size_t chunk =
+                mMaxOffset - mOffset > amt ? amt : mMaxOffset - mOffset;
+        mOffset += chunk;
+        mPos += chunk;
+        amt -= chunk;
+    }
+}
+
+status_t
+ProtoFileMapReader::getError() const {
+    return mStatus;
+}
+
+bool
+ProtoFileMapReader::ensure_data()
+{
+    if (mStatus != NO_ERROR) {
+        return false;
+    }
+    if (mOffset < mMaxOffset) {
+        return true;
+    }
+    return map_next_chunk();
+}
+
+bool
+ProtoFileMapReader::map_next_chunk()
+{
+    if (mMapping != NULL) {
+        munmap(mMapping, mMappingSize);
+        mMapping = NULL;
+        mMappingSize = 0;
+        mOffset = 0;
+        mMaxOffset = 0;
+    }
+    if ((size_t)(mNextChunkStart - mStart) >= mSize) {
+        return false;  // end of file
+    }
+    const off_t pageMask = (off_t)sysconf(_SC_PAGESIZE) - 1;
+    off_t alignedStart = mNextChunkStart & ~pageMask;
+    size_t slop = mNextChunkStart - alignedStart;
+    size_t remaining = mSize - (mNextChunkStart - mStart);
+    size_t want = remaining < kChunkSize ? remaining : kChunkSize;
+    void* map = mmap(NULL, want + slop, PROT_READ, MAP_PRIVATE, mFd, alignedStart);
+    if (map == MAP_FAILED) {
+        mStatus = -errno;
+        return false;
+    }
+    if (madvise(map, want + slop, MADV_SEQUENTIAL) != 0) {
+        ALOGW("madvise(MADV_SEQUENTIAL) failed: %s", strerror(errno));
+    }
+    mMapping = map;
+    mMappingSize = want + slop;
+    mOffset = slop;
+    mMaxOffset = slop + want;
+    mNextChunkStart += want;
+    return true;
+}
+
 
 } // util
 } // android
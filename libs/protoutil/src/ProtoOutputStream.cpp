@@ -16,6 +16,7 @@
 #define LOG_TAG "libprotoutil"
 
 #include <cinttypes>
+#include <cstring>
 #include <type_traits>
 
 #include <android-base/file.h>
@@ -27,13 +28,19 @@ namespace android {
 namespace util {
 
 ProtoOutputStream::ProtoOutputStream()
-        :mBuffer(new EncodedBuffer()),
+        :ProtoOutputStream(new EncodedBuffer())
+{
+}
+
+ProtoOutputStream::ProtoOutputStream(const sp<EncodedBuffer>& buffer)
+        :mBuffer(buffer),
          mCopyBegin(0),
          mCompact(false),
          mDepth(0),
          mObjectId(0),
          mExpectedObjectToken(UINT64_C(-1))
 {
+    mBuffer->clear();
 }
 
 ProtoOutputStream::~ProtoOutputStream()
@@ -174,6 +181,81 @@ ProtoOutputStream::write(uint64_t fieldId, const char* val, size_t size)
     }
 }
 
+/**
+ * Encode a varint into buf, which must have at least 10 writable bytes.
+ * Returns the number of bytes used.
+ */
+static inline size_t
+encodeRawVarint(uint8_t* buf, uint64_t val)
+{
+    size_t size = 0;
+    while ((val & ~UINT64_C(0x7F)) != 0) {
+        buf[size++] = (uint8_t)((val & 0x7F) | 0x80);
+        val >>= 7;
+    }
+    buf[size++] = (uint8_t)val;
+    return size;
+}
+
+/**
+ * Encode count tag+varint pairs through a stack slab so the underlying buffer
+ * sees a handful of bulk copies instead of a bounds check per byte. getVal
+ * maps an element index to the already-widened varint value.
+ */
+template<typename F>
+static bool
+writeRepeatedVarintImpl(const sp<EncodedBuffer>& buffer, uint32_t id, size_t count, F getVal)
+{
+    uint8_t tag[10];
+    const size_t tagSize = encodeRawVarint(tag, (id << FIELD_ID_SHIFT) | WIRE_TYPE_VARINT);
+    uint8_t slab[1024];
+    size_t used = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (used + tagSize + 10 > sizeof(slab)) {
+            if (buffer->writeRaw(slab, used) != NO_ERROR) return false;
+            used = 0;
+        }
+        memcpy(slab + used, tag, tagSize);
+        used += tagSize;
+        used += encodeRawVarint(slab + used, getVal(i));
+    }
+    return used == 0 || buffer->writeRaw(slab, used) == NO_ERROR;
+}
+
+bool
+ProtoOutputStream::writeRepeated(uint64_t fieldId, const int32_t* vals, size_t count)
+{
+    if (mCompact) return false;
+    switch (fieldId & FIELD_TYPE_MASK) {
+        case FIELD_TYPE_INT32:
+        case FIELD_TYPE_UINT32:
+        case FIELD_TYPE_ENUM:
+            // Matches writeInt32Impl: the value is zero-extended on the wire.
+            return writeRepeatedVarintImpl(mBuffer, (uint32_t)fieldId, count,
+                    [vals](size_t i) { return (uint64_t)(uint32_t)vals[i]; });
+        default:
+            ALOGW("Field type %" PRIu64 " is not supported when writing repeated int32 vals.",
+                    (fieldId & FIELD_TYPE_MASK) >> FIELD_TYPE_SHIFT);
+            return false;
+    }
+}
+
+bool
+ProtoOutputStream::writeRepeated(uint64_t fieldId, const int64_t* vals, size_t count)
+{
+    if (mCompact) return false;
+    switch (fieldId & FIELD_TYPE_MASK) {
+        case FIELD_TYPE_INT64:
+        case FIELD_TYPE_UINT64:
+            return writeRepeatedVarintImpl(mBuffer, (uint32_t)fieldId, count,
+                    [vals](size_t i) { return (uint64_t)vals[i]; });
+        default:
+            ALOGW("Field type %" PRIu64 " is not supported when writing repeated int64 vals.",
+                    (fieldId & FIELD_TYPE_MASK) >> FIELD_TYPE_SHIFT);
+            return false;
+    }
+}
+
 /**
  * Make a token.
  *  Bits 61-63 - tag size (So we can go backwards later if the object had not data)
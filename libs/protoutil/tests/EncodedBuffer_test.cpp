@@ -150,3 +150,22 @@ TEST(EncodedBufferTest, ReadVarint) {
     EXPECT_EQ(reader->size(), len);
     EXPECT_EQ(reader->readRawVarint(), val);
 }
+
+TEST(EncodedBufferTest, ObtainRecycleReuse) {
+    sp<EncodedBuffer> buffer = EncodedBuffer::obtain();
+    buffer->writeRawFixed64(UINT64_C(0xdeadbeefdeadbeef));
+    size_t capacity = buffer->capacity();
+    EXPECT_GT(capacity, 0UL);
+
+    EncodedBuffer* raw = buffer.get();
+    EncodedBuffer::recycle(buffer);
+    buffer = NULL;
+
+    // The recycled buffer comes back cleared but with its chunks still
+    // allocated, so the next session starts without growing the heap.
+    sp<EncodedBuffer> reused = EncodedBuffer::obtain();
+    EXPECT_EQ(reused.get(), raw);
+    EXPECT_EQ(reused->size(), 0UL);
+    EXPECT_EQ(reused->capacity(), capacity);
+    EncodedBuffer::recycle(reused);
+}
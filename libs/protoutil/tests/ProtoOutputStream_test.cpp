@@ -218,6 +218,39 @@ TEST(ProtoOutputStreamTest, Complex) {
     EXPECT_THAT(log2.data(), StrEq("food"));
 }
 
+TEST(ProtoOutputStreamTest, WriteRepeatedVarints) {
+    const int32_t ints[4] = { 23, 101, -72, 0 };
+    // Big enough to force the bulk path to flush its scratch slab mid-array.
+    int64_t longs[500];
+    for (int i = 0; i < 500; i++) {
+        longs[i] = (i % 7 == 0) ? -1 : (int64_t)i * 1000003;
+    }
+
+    ProtoOutputStream proto;
+    EXPECT_TRUE(proto.writeRepeated(FIELD_TYPE_INT32 | FIELD_COUNT_REPEATED |
+                                            ComplexProto::kIntsFieldNumber,
+                                    ints, 4));
+    EXPECT_TRUE(proto.writeRepeated(FIELD_TYPE_INT64 | FIELD_COUNT_REPEATED |
+                                            ComplexProto::kLongsFieldNumber,
+                                    longs, 500));
+    // Wrong field type must be rejected.
+    EXPECT_FALSE(proto.writeRepeated(FIELD_TYPE_STRING | FIELD_COUNT_REPEATED |
+                                             ComplexProto::kIntsFieldNumber,
+                                     ints, 4));
+
+    ComplexProto complex;
+    ASSERT_TRUE(complex.ParseFromString(iterateToString(&proto)));
+    EXPECT_EQ(complex.ints_size(), 4);
+    EXPECT_EQ(complex.ints(0), 23);
+    EXPECT_EQ(complex.ints(1), 101);
+    EXPECT_EQ(complex.ints(2), -72);
+    EXPECT_EQ(complex.ints(3), 0);
+    EXPECT_EQ(complex.longs_size(), 500);
+    for (int i = 0; i < 500; i++) {
+        EXPECT_EQ(complex.longs(i), longs[i]);
+    }
+}
+
 TEST(ProtoOutputStreamTest, SerializeToStringComplex) {
     std::string name1 = "cat";
     std::string name2 = "dog";
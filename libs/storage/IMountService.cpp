@@ -50,6 +50,8 @@ enum {
     TRANSACTION_isExternalStorageEmulated,
     TRANSACTION_decryptStorage,
     TRANSACTION_encryptStorage,
+    TRANSACTION_getVolumeStateBatch,
+    TRANSACTION_isObbMountedBatch,
 };
 
 class BpMountService: public BpInterface<IMountService>
@@ -239,6 +241,35 @@ public:
         return reply.readInt32();
     }
 
+    status_t getVolumeStateBatch(const Vector<String16>& mountPoints, Vector<int32_t>* states)
+    {
+        states->clear();
+        Parcel data, reply;
+        data.writeInterfaceToken(IMountService::getInterfaceDescriptor());
+        data.writeInt32(mountPoints.size());
+        for (size_t i = 0; i < mountPoints.size(); i++) {
+            data.writeString16(mountPoints[i]);
+        }
+        status_t status = remote()->transact(TRANSACTION_getVolumeStateBatch, data, &reply);
+        if (status == UNKNOWN_TRANSACTION || (status == NO_ERROR && reply.readExceptionCode() < 0)) {
+            // The remote service predates the batched call; answer with one
+            // transaction per mount point like callers used to issue.
+            for (size_t i = 0; i < mountPoints.size(); i++) {
+                states->push(getVolumeState(mountPoints[i]));
+            }
+            return NO_ERROR;
+        }
+        if (status != NO_ERROR) {
+            ALOGD("getVolumeStateBatch could not contact remote\n");
+            return status;
+        }
+        const int32_t count = reply.readInt32();
+        for (int32_t i = 0; i < count; i++) {
+            states->push(reply.readInt32());
+        }
+        return NO_ERROR;
+    }
+
     int32_t createSecureContainer(const String16& id, const int32_t sizeMb, const String16& fstype,
             const String16& key, const int32_t ownerUid)
     {
@@ -501,6 +532,33 @@ public:
         return reply.readInt32() != 0;
     }
 
+    status_t isObbMountedBatch(const Vector<String16>& filenames, Vector<bool>* mounted)
+    {
+        mounted->clear();
+        Parcel data, reply;
+        data.writeInterfaceToken(IMountService::getInterfaceDescriptor());
+        data.writeInt32(filenames.size());
+        for (size_t i = 0; i < filenames.size(); i++) {
+            data.writeString16(filenames[i]);
+        }
+        status_t status = remote()->transact(TRANSACTION_isObbMountedBatch, data, &reply);
+        if (status == UNKNOWN_TRANSACTION || (status == NO_ERROR && reply.readExceptionCode() < 0)) {
+            for (size_t i = 0; i < filenames.size(); i++) {
+                mounted->push(isObbMounted(filenames[i]));
+            }
+            return NO_ERROR;
+        }
+        if (status != NO_ERROR) {
+            ALOGD("isObbMountedBatch could not contact remote\n");
+            return status;
+        }
+        const int32_t count = reply.readInt32();
+        for (int32_t i = 0; i < count; i++) {
+            mounted->push(reply.readInt32() != 0);
+        }
+        return NO_ERROR;
+    }
+
     bool getMountedObbPath(const String16& filename, String16& path)
     {
         Parcel data, reply;
@@ -36,12 +36,14 @@ status_t ObbInfo::readFromParcel(const Parcel*) {
 status_t ObbInfo::writeToParcel(Parcel* p) const {
     // Parcel write code must be kept in sync with
     // frameworks/base/core/java/android/content/res/ObbInfo.java
-    p->writeString16(mFileName);
-    p->writeString16(mPackageName);
-    p->writeInt32(mVersion);
-    p->writeInt32(mFlags);
-    p->writeByteArray(mSaltSize, mSalt);
-    return OK;
+    if (mParcelled.dataSize() == 0) {
+        mParcelled.writeString16(mFileName);
+        mParcelled.writeString16(mPackageName);
+        mParcelled.writeInt32(mVersion);
+        mParcelled.writeInt32(mFlags);
+        mParcelled.writeByteArray(mSaltSize, mSalt);
+    }
+    return p->appendFrom(&mParcelled, 0, mParcelled.dataSize());
 }
 
 }; // namespace android
\ No newline at end of file
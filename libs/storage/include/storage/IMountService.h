@@ -23,6 +23,7 @@
 #include <storage/ObbInfo.h>
 
 #include <utils/String8.h>
+#include <utils/Vector.h>
 
 #include <binder/IInterface.h>
 #include <binder/Parcel.h>
@@ -46,6 +47,12 @@ public:
     virtual int32_t
             getStorageUsers(const String16& mountPoint, int32_t** users) = 0;
     virtual int32_t getVolumeState(const String16& mountPoint) = 0;
+    // Queries the state of several mount points in one binder transaction.
+    // `states` is filled with one getVolumeState() result per entry of
+    // `mountPoints`, in order. Falls back to one transaction per mount point
+    // when the remote service does not implement the batched call.
+    virtual status_t getVolumeStateBatch(const Vector<String16>& mountPoints,
+            Vector<int32_t>* states) = 0;
     virtual int32_t createSecureContainer(const String16& id,
             const int32_t sizeMb, const String16& fstype, const String16& key,
             const int32_t ownerUid) = 0;
@@ -69,6 +76,10 @@ public:
     virtual void unmountObb(const String16& filename, const bool force,
             const sp<IObbActionListener>& token, const int32_t nonce) = 0;
     virtual bool isObbMounted(const String16& filename) = 0;
+    // Batched isObbMounted(): one transaction answering for every filename,
+    // with the same per-path fallback behavior as getVolumeStateBatch().
+    virtual status_t isObbMountedBatch(const Vector<String16>& filenames,
+            Vector<bool>* mounted) = 0;
     virtual bool getMountedObbPath(const String16& filename, String16& path) = 0;
     virtual int32_t decryptStorage(const String16& password) = 0;
     virtual int32_t encryptStorage(const String16& password) = 0;
@@ -17,6 +17,7 @@
 #ifndef ANDROID_OBBINFO_H
 #define ANDROID_OBBINFO_H
 
+#include <binder/Parcel.h>
 #include <binder/Parcelable.h>
 #include <utils/RefBase.h>
 #include <utils/String16.h>
@@ -41,6 +42,10 @@ private:
     int32_t mFlags;
     size_t mSaltSize;
     const uint8_t* mSalt;
+
+    // All fields are fixed at construction, so the flattened form is built
+    // once on the first writeToParcel() and appended to later parcels as-is.
+    mutable Parcel mParcelled;
 };
 
 }; // namespace android
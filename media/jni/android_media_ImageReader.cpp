@@ -502,44 +502,12 @@ static void ImageReader_imageRelease(JNIEnv* env, jobject thiz, jobject image)
     ALOGV("%s: Image (format: 0x%x) has been released", __FUNCTION__, ctx->getBufferFormat());
 }
 
-static jint ImageReader_imageSetup(JNIEnv* env, jobject thiz, jobject image) {
-    ALOGV("%s:", __FUNCTION__);
-    JNIImageReaderContext* ctx = ImageReader_getContext(env, thiz);
-    if (ctx == NULL) {
-        jniThrowException(env, "java/lang/IllegalStateException",
-                "ImageReader is not initialized or was already closed");
-        return -1;
-    }
-
+// Validates an acquired buffer against the reader configuration and publishes
+// it to the SurfaceImage fields. On failure the buffer is released back to the
+// queue and returned to the item pool.
+static jint ImageReader_finishImageSetup(JNIEnv* env, JNIImageReaderContext* ctx,
+        jobject image, BufferItem* buffer) {
     BufferItemConsumer* bufferConsumer = ctx->getBufferConsumer();
-    BufferItem* buffer = ctx->getBufferItem();
-    if (buffer == NULL) {
-        ALOGW("Unable to acquire a buffer item, very likely client tried to acquire more than"
-            " maxImages buffers");
-        return ACQUIRE_MAX_IMAGES;
-    }
-
-    status_t res = bufferConsumer->acquireBuffer(buffer, 0);
-    if (res != OK) {
-        ctx->returnBufferItem(buffer);
-        if (res != BufferQueue::NO_BUFFER_AVAILABLE) {
-            if (res == INVALID_OPERATION) {
-                // Max number of images were already acquired.
-                ALOGE("%s: Max number of buffers allowed are already acquired : %s (%d)",
-                        __FUNCTION__, strerror(-res), res);
-                return ACQUIRE_MAX_IMAGES;
-            } else {
-                ALOGE("%s: Acquire image failed with some unknown error: %s (%d)",
-                        __FUNCTION__, strerror(-res), res);
-                jniThrowExceptionFmt(env, "java/lang/IllegalStateException",
-                        "Unknown error (%d) when we tried to acquire an image.",
-                                          res);
-                return ACQUIRE_NO_BUFFERS;
-            }
-        }
-        // This isn't really an error case, as the application may acquire buffer at any time.
-        return ACQUIRE_NO_BUFFERS;
-    }
 
     // Add some extra checks for non-opaque formats.
     if (!isFormatOpaque(ctx->getBufferFormat())) {
@@ -614,6 +582,103 @@ static jint ImageReader_imageSetup(JNIEnv* env, jobject thiz, jobject image) {
     return ACQUIRE_SUCCESS;
 }
 
+static jint ImageReader_imageSetup(JNIEnv* env, jobject thiz, jobject image) {
+    ALOGV("%s:", __FUNCTION__);
+    JNIImageReaderContext* ctx = ImageReader_getContext(env, thiz);
+    if (ctx == NULL) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+                "ImageReader is not initialized or was already closed");
+        return -1;
+    }
+
+    BufferItemConsumer* bufferConsumer = ctx->getBufferConsumer();
+    BufferItem* buffer = ctx->getBufferItem();
+    if (buffer == NULL) {
+        ALOGW("Unable to acquire a buffer item, very likely client tried to acquire more than"
+            " maxImages buffers");
+        return ACQUIRE_MAX_IMAGES;
+    }
+
+    status_t res = bufferConsumer->acquireBuffer(buffer, 0);
+    if (res != OK) {
+        ctx->returnBufferItem(buffer);
+        if (res != BufferQueue::NO_BUFFER_AVAILABLE) {
+            if (res == INVALID_OPERATION) {
+                // Max number of images were already acquired.
+                ALOGE("%s: Max number of buffers allowed are already acquired : %s (%d)",
+                        __FUNCTION__, strerror(-res), res);
+                return ACQUIRE_MAX_IMAGES;
+            } else {
+                ALOGE("%s: Acquire image failed with some unknown error: %s (%d)",
+                        __FUNCTION__, strerror(-res), res);
+                jniThrowExceptionFmt(env, "java/lang/IllegalStateException",
+                        "Unknown error (%d) when we tried to acquire an image.",
+                                          res);
+                return ACQUIRE_NO_BUFFERS;
+            }
+        }
+        // This isn't really an error case, as the application may acquire buffer at any time.
+        return ACQUIRE_NO_BUFFERS;
+    }
+
+    return ImageReader_finishImageSetup(env, ctx, image, buffer);
+}
+
+static jint ImageReader_imageSetupLatest(JNIEnv* env, jobject thiz, jobject image) {
+    ALOGV("%s:", __FUNCTION__);
+    JNIImageReaderContext* ctx = ImageReader_getContext(env, thiz);
+    if (ctx == NULL) {
+        jniThrowException(env, "java/lang/IllegalStateException",
+                "ImageReader is not initialized or was already closed");
+        return -1;
+    }
+
+    BufferItemConsumer* bufferConsumer = ctx->getBufferConsumer();
+    BufferItem* buffer = ctx->getBufferItem();
+    if (buffer == NULL) {
+        ALOGW("Unable to acquire a buffer item, very likely client tried to acquire more than"
+            " maxImages buffers");
+        return ACQUIRE_MAX_IMAGES;
+    }
+
+    status_t res = bufferConsumer->acquireBuffer(buffer, 0);
+    if (res != OK) {
+        ctx->returnBufferItem(buffer);
+        if (res != BufferQueue::NO_BUFFER_AVAILABLE) {
+            if (res == INVALID_OPERATION) {
+                ALOGE("%s: Max number of buffers allowed are already acquired : %s (%d)",
+                        __FUNCTION__, strerror(-res), res);
+                return ACQUIRE_MAX_IMAGES;
+            } else {
+                ALOGE("%s: Acquire image failed with some unknown error: %s (%d)",
+                        __FUNCTION__, strerror(-res), res);
+                jniThrowExceptionFmt(env, "java/lang/IllegalStateException",
+                        "Unknown error (%d) when we tried to acquire an image.",
+                                          res);
+                return ACQUIRE_NO_BUFFERS;
+            }
+        }
+        // This isn't really an error case, as the application may acquire buffer at any time.
+        return ACQUIRE_NO_BUFFERS;
+    }
+
+    // Drop everything the producer queued behind this frame without ever
+    // surfacing it to Java: keep swapping for the newer item and release the
+    // older one. None of the skipped buffers were locked, so no release fence
+    // is needed.
+    for (;;) {
+        BufferItem next;
+        status_t err = bufferConsumer->acquireBuffer(&next, 0);
+        if (err != OK) {
+            break;
+        }
+        bufferConsumer->releaseBuffer(*buffer);
+        *buffer = next;
+    }
+
+    return ImageReader_finishImageSetup(env, ctx, image, buffer);
+}
+
 static jint ImageReader_detachImage(JNIEnv* env, jobject thiz, jobject image) {
     ALOGV("%s:", __FUNCTION__);
     JNIImageReaderContext* ctx = ImageReader_getContext(env, thiz);
@@ -832,6 +897,7 @@ static const JNINativeMethod gImageReaderMethods[] = {
     {"nativeClose",            "()V",                        (void*)ImageReader_close },
     {"nativeReleaseImage",     "(Landroid/media/Image;)V",   (void*)ImageReader_imageRelease },
     {"nativeImageSetup",       "(Landroid/media/Image;)I",   (void*)ImageReader_imageSetup },
+    {"nativeImageSetupLatest", "(Landroid/media/Image;)I",   (void*)ImageReader_imageSetupLatest },
     {"nativeGetSurface",       "()Landroid/view/Surface;",   (void*)ImageReader_getSurface },
     {"nativeDetachImage",      "(Landroid/media/Image;)I",   (void*)ImageReader_detachImage },
     {"nativeDiscardFreeBuffers", "()V",                      (void*)ImageReader_discardFreeBuffers }
@@ -51,6 +51,8 @@
 
 #include <system/window.h>
 
+#include <vector>
+
 namespace android {
 
 // Keep these in sync with their equivalents in MediaCodec.java !!!
@@ -60,6 +62,11 @@ enum {
     DEQUEUE_INFO_OUTPUT_BUFFERS_CHANGED     = -3,
 };
 
+// Number of jlong slots each dequeued buffer occupies in the array passed to
+// native_dequeueOutputBuffers: index, offset, size, presentationTimeUs, flags.
+// Keep in sync with MediaCodec.java.
+static constexpr size_t kDequeueOutputInfoStride = 5;
+
 enum {
     EVENT_CALLBACK = 1,
     EVENT_SET_CALLBACK = 2,
@@ -200,6 +207,14 @@ void JMediaCodec::cacheJavaObjects(JNIEnv *env) {
     mByteBufferLimitMethodID = env->GetMethodID(
             mByteBufferClass, "limit", "(I)Ljava/nio/Buffer;");
     CHECK(mByteBufferLimitMethodID != NULL);
+
+    clazz = (jclass)env->FindClass("android/media/MediaCodec$BufferInfo");
+    mBufferInfoClass = (jclass)env->NewGlobalRef(clazz);
+    CHECK(mBufferInfoClass != NULL);
+
+    mBufferInfoSetMethodID = env->GetMethodID(
+            mBufferInfoClass, "set", "(IIJI)V");
+    CHECK(mBufferInfoSetMethodID != NULL);
 }
 
 status_t JMediaCodec::initCheck() const {
@@ -255,7 +270,10 @@ void JMediaCodec::deleteJavaObjects(JNIEnv *env) {
     mByteBufferClass = NULL;
     env->DeleteGlobalRef(mNativeByteOrderObj);
     mNativeByteOrderObj = NULL;
+    env->DeleteGlobalRef(mBufferInfoClass);
+    mBufferInfoClass = NULL;
 
+    mBufferInfoSetMethodID = NULL;
     mByteBufferOrderMethodID = NULL;
     mByteBufferAsReadOnlyBufferMethodID = NULL;
     mByteBufferPositionMethodID = NULL;
@@ -386,12 +404,63 @@ status_t JMediaCodec::dequeueOutputBuffer(
         return err;
     }
 
-    ScopedLocalRef<jclass> clazz(
-            env, env->FindClass("android/media/MediaCodec$BufferInfo"));
+    env->CallVoidMethod(bufferInfo, mBufferInfoSetMethodID,
+            (jint)offset, (jint)size, timeUs, flags);
 
-    jmethodID method = env->GetMethodID(clazz.get(), "set", "(IIJI)V");
-    env->CallVoidMethod(bufferInfo, method, (jint)offset, (jint)size, timeUs, flags);
+    return OK;
+}
 
+status_t JMediaCodec::dequeueOutputBuffers(
+        JNIEnv *env, jlongArray infoArray, size_t *count, int64_t timeoutUs) {
+    jsize length = env->GetArrayLength(infoArray);
+    if (length < (jsize)(kDequeueOutputInfoStride + 1)) {
+        return BAD_VALUE;
+    }
+    size_t capacity = (length - 1) / kDequeueOutputInfoStride;
+
+    std::vector<jlong> packed;
+    packed.reserve(capacity * kDequeueOutputInfoStride + 1);
+
+    // 0 in the trailer slot means we stopped at capacity; more buffers may
+    // already be ready.
+    jlong trailer = 0;
+    *count = 0;
+    while (*count < capacity) {
+        size_t index, offset, size;
+        int64_t timeUs;
+        uint32_t flags;
+        status_t err = mCodec->dequeueOutputBuffer(
+                &index, &offset, &size, &timeUs, &flags,
+                *count == 0 ? timeoutUs : 0 /* drain without waiting */);
+        if (err != OK) {
+            if (*count == 0) {
+                return err;
+            }
+            switch (err) {
+                case INFO_FORMAT_CHANGED:
+                    trailer = DEQUEUE_INFO_OUTPUT_FORMAT_CHANGED;
+                    break;
+                case INFO_OUTPUT_BUFFERS_CHANGED:
+                    trailer = DEQUEUE_INFO_OUTPUT_BUFFERS_CHANGED;
+                    break;
+                default:
+                    // -EAGAIN means the codec is drained. A persistent error
+                    // resurfaces on the caller's next dequeue, so it is safe
+                    // to report the buffers we already have.
+                    trailer = DEQUEUE_INFO_TRY_AGAIN_LATER;
+                    break;
+            }
+            break;
+        }
+        packed.push_back(static_cast<jlong>(index));
+        packed.push_back(static_cast<jlong>(offset));
+        packed.push_back(static_cast<jlong>(size));
+        packed.push_back(timeUs);
+        packed.push_back(static_cast<jlong>(flags));
+        ++*count;
+    }
+    packed.push_back(trailer);
+    env->SetLongArrayRegion(infoArray, 0, static_cast<jsize>(packed.size()), packed.data());
     return OK;
 }
 
@@ -1634,6 +1703,27 @@ static jint android_media_MediaCodec_dequeueOutputBuffer(
     return throwExceptionAsNecessary(env, err);
 }
 
+static jint android_media_MediaCodec_dequeueOutputBuffers(
+        JNIEnv *env, jobject thiz, jlongArray infoArray, jlong timeoutUs) {
+    ALOGV("android_media_MediaCodec_dequeueOutputBuffers");
+
+    sp<JMediaCodec> codec = getMediaCodec(env, thiz);
+
+    if (codec == NULL || infoArray == NULL) {
+        throwExceptionAsNecessary(env, INVALID_OPERATION);
+        return 0;
+    }
+
+    size_t count;
+    status_t err = codec->dequeueOutputBuffers(env, infoArray, &count, timeoutUs);
+
+    if (err == OK) {
+        return (jint) count;
+    }
+
+    return throwExceptionAsNecessary(env, err);
+}
+
 static void android_media_MediaCodec_releaseOutputBuffer(
         JNIEnv *env, jobject thiz,
         jint index, jboolean render, jboolean updatePTS, jlong timestampNs) {
@@ -2204,6 +2294,9 @@ static const JNINativeMethod gMethods[] = {
     { "native_dequeueOutputBuffer", "(Landroid/media/MediaCodec$BufferInfo;J)I",
       (void *)android_media_MediaCodec_dequeueOutputBuffer },
 
+    { "native_dequeueOutputBuffers", "([JJ)I",
+      (void *)android_media_MediaCodec_dequeueOutputBuffers },
+
     { "releaseOutputBuffer", "(IZZJ)V",
       (void *)android_media_MediaCodec_releaseOutputBuffer },
 
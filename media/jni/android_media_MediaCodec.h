@@ -102,6 +102,13 @@ struct JMediaCodec : public AHandler {
     status_t dequeueOutputBuffer(
             JNIEnv *env, jobject bufferInfo, size_t *index, int64_t timeoutUs);
 
+    // Drains every output buffer that is already ready into infoArray, waiting
+    // at most timeoutUs for the first one. Each buffer occupies a fixed stride
+    // of jlong slots and the slot after the last buffer carries the reason the
+    // drain stopped.
+    status_t dequeueOutputBuffers(
+            JNIEnv *env, jlongArray infoArray, size_t *count, int64_t timeoutUs);
+
     status_t releaseOutputBuffer(
             size_t index, bool render, bool updatePTS, int64_t timestampNs);
 
@@ -154,6 +161,8 @@ private:
     jmethodID mByteBufferPositionMethodID;
     jmethodID mByteBufferLimitMethodID;
     jmethodID mByteBufferAsReadOnlyBufferMethodID;
+    jclass mBufferInfoClass;
+    jmethodID mBufferInfoSetMethodID;
 
     sp<ALooper> mLooper;
     sp<MediaCodec> mCodec;
@@ -45,10 +45,17 @@
 #include <media/stagefright/NuMediaExtractor.h>
 #include <nativehelper/ScopedLocalRef.h>
 
+#include <vector>
+
 namespace android {
 
 using namespace hardware::cas::V1_0;
 
+// Number of jlong slots each sample occupies in the array passed to
+// nativeReadMultipleSamples: offset, size, trackIndex, presentationTimeUs,
+// flags. Keep in sync with MediaExtractor.java.
+static constexpr size_t kSampleInfoStride = 5;
+
 struct fields_t {
     jfieldID context;
 
@@ -239,6 +246,73 @@ status_t JMediaExtractor::readSampleData(
     return OK;
 }
 
+status_t JMediaExtractor::readMultipleSamples(
+        jobject byteBuf, jlongArray infoArray, size_t *count) {
+    JNIEnv *env = AndroidRuntime::getJNIEnv();
+
+    // The batch entry point requires a direct buffer; an array-backed buffer
+    // would force a pin/release per sample and lose the point of batching.
+    void *dst = env->GetDirectBufferAddress(byteBuf);
+    if (dst == NULL) {
+        return BAD_VALUE;
+    }
+    size_t dstSize = (size_t) env->GetDirectBufferCapacity(byteBuf);
+
+    size_t capacity = env->GetArrayLength(infoArray) / kSampleInfoStride;
+    if (capacity == 0) {
+        return BAD_VALUE;
+    }
+
+    std::vector<jlong> info;
+    info.reserve(capacity * kSampleInfoStride);
+
+    size_t offset = 0;
+    *count = 0;
+    while (*count < capacity) {
+        sp<ABuffer> buffer = new ABuffer((char *)dst + offset, dstSize - offset);
+
+        status_t err = mImpl->readSampleData(buffer);
+        if (err != OK) {
+            // -ERANGE: the remaining space cannot hold the next sample, which
+            // stays current for a later read. ERROR_END_OF_STREAM: done.
+            if (*count == 0) {
+                return err;
+            }
+            break;
+        }
+
+        size_t trackIndex;
+        int64_t timeUs;
+        uint32_t flags;
+        if (getSampleTrackIndex(&trackIndex) != OK
+                || getSampleTime(&timeUs) != OK
+                || getSampleFlags(&flags) != OK) {
+            // Leave the sample current so the single-sample path can surface
+            // the error; data already copied beyond `offset` is unreported.
+            if (*count == 0) {
+                return INVALID_OPERATION;
+            }
+            break;
+        }
+
+        info.push_back(static_cast<jlong>(offset));
+        info.push_back(static_cast<jlong>(buffer->size()));
+        info.push_back(static_cast<jlong>(trackIndex));
+        info.push_back(timeUs);
+        info.push_back(static_cast<jlong>(flags));
+        ++*count;
+        offset += buffer->size();
+
+        if (advance() != OK) {
+            // End of stream; the samples gathered so far are still valid.
+            break;
+        }
+    }
+
+    env->SetLongArrayRegion(infoArray, 0, static_cast<jsize>(info.size()), info.data());
+    return OK;
+}
+
 status_t JMediaExtractor::getSampleTrackIndex(size_t *trackIndex) {
     return mImpl->getSampleTrackIndex(trackIndex);
 }
@@ -472,6 +546,33 @@ static jint android_media_MediaExtractor_readSampleData(
     return (jint) sampleSize;
 }
 
+static jint android_media_MediaExtractor_readMultipleSamples(
+        JNIEnv *env, jobject thiz, jobject byteBuf, jlongArray infoArray) {
+    sp<JMediaExtractor> extractor = getMediaExtractor(env, thiz);
+
+    if (extractor == NULL) {
+        jniThrowException(env, "java/lang/IllegalStateException", NULL);
+        return -1;
+    }
+
+    if (byteBuf == NULL || infoArray == NULL) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", NULL);
+        return -1;
+    }
+
+    size_t count;
+    status_t err = extractor->readMultipleSamples(byteBuf, infoArray, &count);
+
+    if (err == ERROR_END_OF_STREAM) {
+        return -1;
+    } else if (err != OK) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", NULL);
+        return -1;
+    }
+
+    return (jint) count;
+}
+
 static jint android_media_MediaExtractor_getSampleTrackIndex(
         JNIEnv *env, jobject thiz) {
     sp<JMediaExtractor> extractor = getMediaExtractor(env, thiz);
@@ -944,6 +1045,9 @@ static const JNINativeMethod gMethods[] = {
     { "readSampleData", "(Ljava/nio/ByteBuffer;I)I",
         (void *)android_media_MediaExtractor_readSampleData },
 
+    { "nativeReadMultipleSamples", "(Ljava/nio/ByteBuffer;[J)I",
+        (void *)android_media_MediaExtractor_readMultipleSamples },
+
     { "getSampleTrackIndex", "()I",
         (void *)android_media_MediaExtractor_getSampleTrackIndex },
 
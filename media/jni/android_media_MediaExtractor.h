@@ -59,6 +59,12 @@ struct JMediaExtractor : public RefBase {
 
     status_t advance();
     status_t readSampleData(jobject byteBuf, size_t offset, size_t *sampleSize);
+
+    // Reads consecutive samples into a direct ByteBuffer in one crossing,
+    // packing per-sample (offset, size, trackIndex, timeUs, flags) records
+    // into infoArray and advancing past every sample returned. Stops when the
+    // buffer or infoArray is full or the stream ends.
+    status_t readMultipleSamples(jobject byteBuf, jlongArray infoArray, size_t *count);
     status_t getSampleTrackIndex(size_t *trackIndex);
     status_t getSampleTime(int64_t *sampleTimeUs);
     status_t getSampleSize(size_t *sampleSize);
@@ -18,7 +18,10 @@
 //#define LOG_NDEBUG 0
 #define LOG_TAG "MediaMetadataRetrieverJNI"
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <vector>
 #include <assert.h>
 #include <utils/Log.h>
 #include <utils/threads.h>
@@ -407,6 +410,62 @@ static jobject android_media_MediaMetadataRetriever_getFrameAtTime(
     return getBitmapFromVideoFrame(env, videoFrame, dst_width, dst_height, kRGB_565_SkColorType);
 }
 
+static jobjectArray android_media_MediaMetadataRetriever_getFramesAtTimes(
+        JNIEnv *env, jobject thiz, jlongArray timesUsArray, jint option,
+        jint dst_width, jint dst_height)
+{
+    sp<MediaMetadataRetriever> retriever = getRetriever(env, thiz);
+    if (retriever == 0) {
+        jniThrowException(env, "java/lang/IllegalStateException", "No retriever available");
+        return NULL;
+    }
+    if (timesUsArray == NULL) {
+        jniThrowException(env, "java/lang/IllegalArgumentException", "No timestamps given");
+        return NULL;
+    }
+
+    jsize count = env->GetArrayLength(timesUsArray);
+    std::vector<jlong> timesUs(count);
+    env->GetLongArrayRegion(timesUsArray, 0, count, timesUs.data());
+
+    jobjectArray bitmaps = env->NewObjectArray(count, fields.bitmapClazz, NULL);
+    if (bitmaps == NULL) {
+        return NULL;
+    }
+
+    // Extract in presentation order so the retriever's decoder only ever
+    // seeks forward through the stream, but hand each bitmap back in the
+    // caller's slot. A strip request in arbitrary order thus costs the same
+    // as a sorted one.
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&timesUs](size_t a, size_t b) {
+        return timesUs[a] < timesUs[b];
+    });
+
+    for (size_t i : order) {
+        ALOGV("getFramesAtTimes: %lld us", (long long)timesUs[i]);
+        VideoFrame *videoFrame = NULL;
+        sp<IMemory> frameMemory = retriever->getFrameAtTime(timesUs[i], option);
+        if (frameMemory != 0) {
+            videoFrame = static_cast<VideoFrame *>(frameMemory->pointer());
+        }
+        if (videoFrame == NULL) {
+            // Leave a null slot rather than failing the whole strip.
+            ALOGE("getFramesAtTimes: no frame at %lld us", (long long)timesUs[i]);
+            continue;
+        }
+
+        ScopedLocalRef<jobject> bitmapObj(env, getBitmapFromVideoFrame(
+                env, videoFrame, dst_width, dst_height, kRGB_565_SkColorType));
+        if (bitmapObj.get() != NULL) {
+            env->SetObjectArrayElement(bitmaps, i, bitmapObj.get());
+        }
+    }
+
+    return bitmaps;
+}
+
 static jobject android_media_MediaMetadataRetriever_getImageAtIndex(
         JNIEnv *env, jobject thiz, jint index, jobject params)
 {
@@ -714,6 +773,8 @@ static const JNINativeMethod nativeMethods[] = {
                 (void *)android_media_MediaMetadataRetriever_setDataSourceCallback},
         {"_getFrameAtTime", "(JIII)Landroid/graphics/Bitmap;",
                 (void *)android_media_MediaMetadataRetriever_getFrameAtTime},
+        {"_getFramesAtTimes", "([JIII)[Landroid/graphics/Bitmap;",
+                (void *)android_media_MediaMetadataRetriever_getFramesAtTimes},
         {
             "_getImageAtIndex",
             "(ILandroid/media/MediaMetadataRetriever$BitmapParams;)Landroid/graphics/Bitmap;",
@@ -46,6 +46,9 @@ static const char* const kIllegalArgumentException =
 
 struct fields_t {
     jfieldID    context;
+    jmethodID   scanFileID;
+    jmethodID   handleStringTagID;
+    jmethodID   setMimeTypeID;
 };
 static fields_t fields;
 
@@ -112,33 +115,9 @@ class MyMediaScannerClient : public MediaScannerClient
 public:
     MyMediaScannerClient(JNIEnv *env, jobject client)
         :   mEnv(env),
-            mClient(env->NewGlobalRef(client)),
-            mScanFileMethodID(0),
-            mHandleStringTagMethodID(0),
-            mSetMimeTypeMethodID(0)
+            mClient(env->NewGlobalRef(client))
     {
         ALOGV("MyMediaScannerClient constructor");
-        jclass mediaScannerClientInterface =
-                env->FindClass(kClassMediaScannerClient);
-
-        if (mediaScannerClientInterface == NULL) {
-            ALOGE("Class %s not found", kClassMediaScannerClient);
-        } else {
-            mScanFileMethodID = env->GetMethodID(
-                                    mediaScannerClientInterface,
-                                    "scanFile",
-                                    "(Ljava/lang/String;JJZZ)V");
-
-            mHandleStringTagMethodID = env->GetMethodID(
-                                    mediaScannerClientInterface,
-                                    "handleStringTag",
-                                    "(Ljava/lang/String;Ljava/lang/String;)V");
-
-            mSetMimeTypeMethodID = env->GetMethodID(
-                                    mediaScannerClientInterface,
-                                    "setMimeType",
-                                    "(Ljava/lang/String;)V");
-        }
     }
 
     virtual ~MyMediaScannerClient()
@@ -159,7 +138,7 @@ public:
             return NO_MEMORY;
         }
 
-        mEnv->CallVoidMethod(mClient, mScanFileMethodID, pathStr, lastModified,
+        mEnv->CallVoidMethod(mClient, fields.scanFileID, pathStr, lastModified,
                 fileSize, isDirectory, noMedia);
 
         mEnv->DeleteLocalRef(pathStr);
@@ -196,7 +175,7 @@ public:
         }
 
         mEnv->CallVoidMethod(
-            mClient, mHandleStringTagMethodID, nameStr, valueStr);
+            mClient, fields.handleStringTagID, nameStr, valueStr);
 
         mEnv->DeleteLocalRef(nameStr);
         mEnv->DeleteLocalRef(valueStr);
@@ -212,7 +191,7 @@ public:
             return NO_MEMORY;
         }
 
-        mEnv->CallVoidMethod(mClient, mSetMimeTypeMethodID, mimeTypeStr);
+        mEnv->CallVoidMethod(mClient, fields.setMimeTypeID, mimeTypeStr);
 
         mEnv->DeleteLocalRef(mimeTypeStr);
         return checkAndClearExceptionFromCallback(mEnv, "setMimeType");
@@ -221,9 +200,6 @@ public:
 private:
     JNIEnv *mEnv;
     jobject mClient;
-    jmethodID mScanFileMethodID;
-    jmethodID mHandleStringTagMethodID;
-    jmethodID mSetMimeTypeMethodID;
 };
 
 
@@ -387,6 +363,21 @@ android_media_MediaScanner_native_init(JNIEnv *env)
     if (fields.context == NULL) {
         return;
     }
+
+    // The client interface is called once per scanned file; resolving its
+    // method IDs here keeps FindClass/GetMethodID out of the scan loop.
+    jclass clientInterface = env->FindClass(kClassMediaScannerClient);
+    if (clientInterface == NULL) {
+        ALOGE("Class %s not found", kClassMediaScannerClient);
+        return;
+    }
+
+    fields.scanFileID = env->GetMethodID(clientInterface, "scanFile",
+            "(Ljava/lang/String;JJZZ)V");
+    fields.handleStringTagID = env->GetMethodID(clientInterface, "handleStringTag",
+            "(Ljava/lang/String;Ljava/lang/String;)V");
+    fields.setMimeTypeID = env->GetMethodID(clientInterface, "setMimeType",
+            "(Ljava/lang/String;)V");
 }
 
 static void
@@ -51,6 +51,10 @@ extern "C" {
 #include <stdio.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 using namespace android;
 
 // ----------------------------------------------------------------------------
@@ -69,6 +73,7 @@ static jmethodID method_getDeviceProperty;
 static jmethodID method_setDeviceProperty;
 static jmethodID method_getObjectPropertyList;
 static jmethodID method_getObjectInfo;
+static jmethodID method_getObjectInfoList;
 static jmethodID method_getObjectFilePath;
 static jmethodID method_beginDeleteObject;
 static jmethodID method_endDeleteObject;
@@ -97,6 +102,9 @@ IMtpDatabase* getMtpDatabase(JNIEnv *env, jobject database) {
 
 // ----------------------------------------------------------------------------
 
+// Number of object info records fetched per getObjectInfoList() call.
+static constexpr size_t kObjectInfoPrefetchCount = 64;
+
 class MtpDatabase : public IMtpDatabase {
 private:
     jobject         mDatabase;
@@ -104,6 +112,26 @@ private:
     jlongArray      mLongBuffer;
     jcharArray      mStringBuffer;
 
+    // Object info records pulled from Java in batches while the host walks
+    // the handle list returned by the last GetObjectHandles request.
+    // Each record is consumed by the single GetObjectInfo that asks for it,
+    // and the whole cache is dropped whenever an object changes.
+    struct CachedObjectInfo {
+        MtpStorageID    storageID;
+        MtpObjectFormat format;
+        MtpObjectHandle parent;
+        time_t          dateCreated;
+        time_t          dateModified;
+        int64_t         fileLength;
+        MtpStringBuffer name;
+        MtpStringBuffer path;
+    };
+    std::vector<MtpObjectHandle> mEnumeration;
+    std::unordered_map<MtpObjectHandle, CachedObjectInfo> mObjectInfoCache;
+
+    void                            invalidateObjectInfoCache();
+    void                            prefetchObjectInfo(JNIEnv* env, size_t start);
+
 public:
                                     MtpDatabase(JNIEnv *env, jobject client);
     virtual                         ~MtpDatabase();
@@ -259,6 +287,7 @@ MtpObjectHandle MtpDatabase::beginSendObject(const char* path,
 
 void MtpDatabase::endSendObject(MtpObjectHandle handle, bool succeeded) {
     JNIEnv* env = AndroidRuntime::getJNIEnv();
+    invalidateObjectInfoCache();
     env->CallVoidMethod(mDatabase, method_endSendObject, (jint)handle, (jboolean)succeeded);
 
     checkAndClearExceptionFromCallback(env, __FUNCTION__);
@@ -267,6 +296,7 @@ void MtpDatabase::endSendObject(MtpObjectHandle handle, bool succeeded) {
 void MtpDatabase::rescanFile(const char* path, MtpObjectHandle handle,
                                   MtpObjectFormat format) {
     JNIEnv* env = AndroidRuntime::getJNIEnv();
+    invalidateObjectInfoCache();
     jstring pathStr = env->NewStringUTF(path);
     env->CallVoidMethod(mDatabase, method_rescanFile, pathStr,
                         (jint)handle, (jint)format);
@@ -292,6 +322,12 @@ MtpObjectHandleList* MtpDatabase::getObjectList(MtpStorageID storageID,
     env->ReleaseIntArrayElements(array, handles, 0);
     env->DeleteLocalRef(array);
 
+    // Hosts typically follow an enumeration with one GetObjectInfo per
+    // handle, in this order. Remember it so getObjectInfo() can prefetch
+    // records in batches instead of crossing into Java per object.
+    invalidateObjectInfoCache();
+    mEnumeration.assign(list->begin(), list->end());
+
     checkAndClearExceptionFromCallback(env, __FUNCTION__);
     return list;
 }
@@ -545,6 +581,9 @@ MtpResponseCode MtpDatabase::setObjectPropertyValue(MtpObjectHandle handle,
     if (!getObjectPropertyInfo(property, type))
         return MTP_RESPONSE_OBJECT_PROP_NOT_SUPPORTED;
 
+    // Property writes can rename or re-date an object.
+    invalidateObjectInfoCache();
+
     JNIEnv* env = AndroidRuntime::getJNIEnv();
     jlong longValue = 0;
     jstring stringValue = NULL;
@@ -831,46 +870,146 @@ static ExifData *getExifFromExtractor(const char *path) {
     return exifdata;
 }
 
+void MtpDatabase::invalidateObjectInfoCache() {
+    mObjectInfoCache.clear();
+    mEnumeration.clear();
+}
+
+void MtpDatabase::prefetchObjectInfo(JNIEnv* env, size_t start) {
+    size_t count = std::min(kObjectInfoPrefetchCount, mEnumeration.size() - start);
+
+    jintArray handleArray = env->NewIntArray(count);
+    jintArray intArray = env->NewIntArray(count * 3);
+    jlongArray longArray = env->NewLongArray(count * 3);
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray nameArray = stringClass
+            ? env->NewObjectArray(count, stringClass, NULL) : NULL;
+    jobjectArray pathArray = stringClass
+            ? env->NewObjectArray(count, stringClass, NULL) : NULL;
+
+    if (handleArray && intArray && longArray && nameArray && pathArray) {
+        env->SetIntArrayRegion(handleArray, 0, count, (const jint *)&mEnumeration[start]);
+        if (env->CallBooleanMethod(mDatabase, method_getObjectInfoList,
+                    handleArray, intArray, longArray, nameArray, pathArray)) {
+            jint* intValues = env->GetIntArrayElements(intArray, 0);
+            jlong* longValues = env->GetLongArrayElements(longArray, 0);
+            for (size_t i = 0; i < count; i++) {
+                // Records the database could not resolve carry a zero
+                // storage id; leave them uncached so getObjectInfo() can
+                // report the failure through the per-object path.
+                if (intValues[i * 3] == 0)
+                    continue;
+                jstring nameStr = (jstring)env->GetObjectArrayElement(nameArray, i);
+                jstring pathStr = (jstring)env->GetObjectArrayElement(pathArray, i);
+                if (nameStr && pathStr) {
+                    CachedObjectInfo& entry = mObjectInfoCache[mEnumeration[start + i]];
+                    entry.storageID = intValues[i * 3];
+                    entry.format = intValues[i * 3 + 1];
+                    entry.parent = intValues[i * 3 + 2];
+                    entry.dateCreated = longValues[i * 3];
+                    entry.dateModified = longValues[i * 3 + 1];
+                    entry.fileLength = longValues[i * 3 + 2];
+                    const jchar* name = env->GetStringChars(nameStr, NULL);
+                    entry.name.set(name);
+                    env->ReleaseStringChars(nameStr, name);
+                    const jchar* filePath = env->GetStringChars(pathStr, NULL);
+                    entry.path.set(filePath);
+                    env->ReleaseStringChars(pathStr, filePath);
+                }
+                if (nameStr)
+                    env->DeleteLocalRef(nameStr);
+                if (pathStr)
+                    env->DeleteLocalRef(pathStr);
+            }
+            env->ReleaseLongArrayElements(longArray, longValues, JNI_ABORT);
+            env->ReleaseIntArrayElements(intArray, intValues, JNI_ABORT);
+        }
+    }
+
+    if (pathArray)
+        env->DeleteLocalRef(pathArray);
+    if (nameArray)
+        env->DeleteLocalRef(nameArray);
+    if (stringClass)
+        env->DeleteLocalRef(stringClass);
+    if (longArray)
+        env->DeleteLocalRef(longArray);
+    if (intArray)
+        env->DeleteLocalRef(intArray);
+    if (handleArray)
+        env->DeleteLocalRef(handleArray);
+    checkAndClearExceptionFromCallback(env, __FUNCTION__);
+}
+
 MtpResponseCode MtpDatabase::getObjectInfo(MtpObjectHandle handle,
                                              MtpObjectInfo& info) {
     MtpStringBuffer path;
     int64_t         length;
     MtpObjectFormat format;
+    JNIEnv* env = AndroidRuntime::getJNIEnv();
 
-    MtpResponseCode result = getObjectFilePath(handle, path, length, format);
-    if (result != MTP_RESPONSE_OK) {
-        return result;
+    auto cached = mObjectInfoCache.find(handle);
+    if (cached == mObjectInfoCache.end()) {
+        // A miss on a handle inside the current enumeration means the host
+        // has reached this point of the handle list, so pull the next batch
+        // of records across in one call before serving it.
+        auto cursor = std::find(mEnumeration.begin(), mEnumeration.end(), handle);
+        if (cursor != mEnumeration.end()) {
+            prefetchObjectInfo(env, cursor - mEnumeration.begin());
+            cached = mObjectInfoCache.find(handle);
+        }
     }
-    info.mCompressedSize = (length > 0xFFFFFFFFLL ? 0xFFFFFFFF : (uint32_t)length);
 
-    JNIEnv* env = AndroidRuntime::getJNIEnv();
-    if (!env->CallBooleanMethod(mDatabase, method_getObjectInfo,
-                (jint)handle, mIntBuffer, mStringBuffer, mLongBuffer)) {
-        return MTP_RESPONSE_INVALID_OBJECT_HANDLE;
-    }
+    if (cached != mObjectInfoCache.end()) {
+        const CachedObjectInfo& entry = cached->second;
+        path = entry.path;
+        length = entry.fileLength;
+        format = entry.format;
+        info.mStorageID = entry.storageID;
+        info.mFormat = entry.format;
+        info.mParent = entry.parent;
+        info.mDateCreated = entry.dateCreated;
+        info.mDateModified = entry.dateModified;
+        info.mCompressedSize = (length > 0xFFFFFFFFLL ? 0xFFFFFFFF : (uint32_t)length);
+        info.mAssociationType = MTP_ASSOCIATION_TYPE_UNDEFINED;
+        info.mName = strdup(entry.name);
+        // The enumeration asks for each record exactly once.
+        mObjectInfoCache.erase(cached);
+    } else {
+        MtpResponseCode result = getObjectFilePath(handle, path, length, format);
+        if (result != MTP_RESPONSE_OK) {
+            return result;
+        }
+        info.mCompressedSize = (length > 0xFFFFFFFFLL ? 0xFFFFFFFF : (uint32_t)length);
 
-    jint* intValues = env->GetIntArrayElements(mIntBuffer, 0);
-    info.mStorageID = intValues[0];
-    info.mFormat = intValues[1];
-    info.mParent = intValues[2];
-    env->ReleaseIntArrayElements(mIntBuffer, intValues, 0);
+        if (!env->CallBooleanMethod(mDatabase, method_getObjectInfo,
+                    (jint)handle, mIntBuffer, mStringBuffer, mLongBuffer)) {
+            return MTP_RESPONSE_INVALID_OBJECT_HANDLE;
+        }
 
-    jlong* longValues = env->GetLongArrayElements(mLongBuffer, 0);
-    info.mDateCreated = longValues[0];
-    info.mDateModified = longValues[1];
-    env->ReleaseLongArrayElements(mLongBuffer, longValues, 0);
+        jint* intValues = env->GetIntArrayElements(mIntBuffer, 0);
+        info.mStorageID = intValues[0];
+        info.mFormat = intValues[1];
+        info.mParent = intValues[2];
+        env->ReleaseIntArrayElements(mIntBuffer, intValues, 0);
+
+        jlong* longValues = env->GetLongArrayElements(mLongBuffer, 0);
+        info.mDateCreated = longValues[0];
+        info.mDateModified = longValues[1];
+        env->ReleaseLongArrayElements(mLongBuffer, longValues, 0);
+
+        if ((false)) {
+            info.mAssociationType = (format == MTP_FORMAT_ASSOCIATION ?
+                                    MTP_ASSOCIATION_TYPE_GENERIC_FOLDER :
+                                    MTP_ASSOCIATION_TYPE_UNDEFINED);
+        }
+        info.mAssociationType = MTP_ASSOCIATION_TYPE_UNDEFINED;
 
-    if ((false)) {
-        info.mAssociationType = (format == MTP_FORMAT_ASSOCIATION ?
-                                MTP_ASSOCIATION_TYPE_GENERIC_FOLDER :
-                                MTP_ASSOCIATION_TYPE_UNDEFINED);
+        jchar* str = env->GetCharArrayElements(mStringBuffer, 0);
+        MtpStringBuffer temp(str);
+        info.mName = strdup(temp);
+        env->ReleaseCharArrayElements(mStringBuffer, str, 0);
     }
-    info.mAssociationType = MTP_ASSOCIATION_TYPE_UNDEFINED;
-
-    jchar* str = env->GetCharArrayElements(mStringBuffer, 0);
-    MtpStringBuffer temp(str);
-    info.mName = strdup(temp);
-    env->ReleaseCharArrayElements(mStringBuffer, str, 0);
 
     // read EXIF data for thumbnail information
     switch (info.mFormat) {
@@ -1035,6 +1174,7 @@ MtpResponseCode MtpDatabase::beginDeleteObject(MtpObjectHandle handle) {
 
 void MtpDatabase::endDeleteObject(MtpObjectHandle handle, bool succeeded) {
     JNIEnv* env = AndroidRuntime::getJNIEnv();
+    invalidateObjectInfoCache();
     env->CallVoidMethod(mDatabase, method_endDeleteObject, (jint)handle, (jboolean) succeeded);
 
     checkAndClearExceptionFromCallback(env, __FUNCTION__);
@@ -1054,6 +1194,7 @@ void MtpDatabase::endMoveObject(MtpObjectHandle oldParent, MtpObjectHandle newPa
                                             MtpStorageID oldStorage, MtpStorageID newStorage,
                                              MtpObjectHandle handle, bool succeeded) {
     JNIEnv* env = AndroidRuntime::getJNIEnv();
+    invalidateObjectInfoCache();
     env->CallVoidMethod(mDatabase, method_endMoveObject,
                 (jint)oldParent, (jint) newParent, (jint) oldStorage, (jint) newStorage,
                 (jint) handle, (jboolean) succeeded);
@@ -1073,6 +1214,7 @@ MtpResponseCode MtpDatabase::beginCopyObject(MtpObjectHandle handle, MtpObjectHa
 
 void MtpDatabase::endCopyObject(MtpObjectHandle handle, bool succeeded) {
     JNIEnv* env = AndroidRuntime::getJNIEnv();
+    invalidateObjectInfoCache();
     env->CallVoidMethod(mDatabase, method_endCopyObject, (jint)handle, (jboolean)succeeded);
 
     checkAndClearExceptionFromCallback(env, __FUNCTION__);
@@ -1388,6 +1530,8 @@ int register_android_mtp_MtpDatabase(JNIEnv *env)
     GET_METHOD_ID(setDeviceProperty, clazz, "(IJLjava/lang/String;)I");
     GET_METHOD_ID(getObjectPropertyList, clazz, "(IIIII)Landroid/mtp/MtpPropertyList;");
     GET_METHOD_ID(getObjectInfo, clazz, "(I[I[C[J)Z");
+    GET_METHOD_ID(getObjectInfoList, clazz,
+            "([I[I[J[Ljava/lang/String;[Ljava/lang/String;)Z");
     GET_METHOD_ID(getObjectFilePath, clazz, "(I[C[J)I");
     GET_METHOD_ID(beginDeleteObject, clazz, "(I)I");
     GET_METHOD_ID(endDeleteObject, clazz, "(IZ)V");
@@ -232,7 +232,8 @@ int SoundPool::load(int fd, int64_t offset, int64_t length, int priority __unuse
     // mDecodeThread->loadSample() may block on mDecodeThread message queue space;
     // the message queue emptying may block on SoundPool::findSample().
     //
-    // It theoretically possible that sample loads might decode out-of-order.
+    // Sample loads may decode out-of-order across the decode workers;
+    // each SAMPLE_LOADED event still names its own sampleID.
     mDecodeThread->loadSample(sampleID);
     return sampleID;
 }
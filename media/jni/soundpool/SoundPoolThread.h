@@ -36,7 +36,9 @@ public:
 };
 
 /*
- * This class handles background requests from the SoundPool
+ * This class handles background requests from the SoundPool on a small
+ * pool of decode workers, so a burst of load() calls is not serialized
+ * behind a single decoder.
  */
 class SoundPoolThread {
 public:
@@ -48,6 +50,7 @@ public:
 
 private:
     static const size_t maxMessages = 128;
+    static const size_t maxWorkers = 4;
 
     static int beginThread(void* arg);
     int run();
@@ -59,6 +62,7 @@ private:
     Vector<SoundPoolMsg>    mMsgQueue;
     SoundPool*              mSoundPool;
     bool                    mRunning;
+    size_t                  mNumWorkers;
 };
 
 } // end namespace android
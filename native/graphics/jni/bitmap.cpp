@@ -16,6 +16,7 @@
 
 #include <android/bitmap.h>
 #include <android/graphics/Bitmap.h>
+#include <android/hardware_buffer.h>
 
 int AndroidBitmap_getInfo(JNIEnv* env, jobject jbitmap,
                           AndroidBitmapInfo* info) {
@@ -56,3 +57,19 @@ int AndroidBitmap_unlockPixels(JNIEnv* env, jobject jbitmap) {
     }
     return ANDROID_BITMAP_RESULT_SUCCESS;
 }
+
+int AndroidBitmap_getHardwareBuffer(JNIEnv* env, jobject jbitmap,
+                                    AHardwareBuffer** outBuffer) {
+    if (NULL == env || NULL == jbitmap || NULL == outBuffer) {
+        return ANDROID_BITMAP_RESULT_BAD_PARAMETER;
+    }
+
+    // Hands out an acquired reference to the GPU buffer backing a hardware
+    // bitmap, so callers can operate on it (e.g. bind it as a GL/Vulkan
+    // image) without the CPU readback that lockPixels would force. Fails for
+    // software bitmaps; those should keep using AndroidBitmap_lockPixels.
+    if (!android::bitmap::getHardwareBuffer(env, jbitmap, outBuffer)) {
+        return ANDROID_BITMAP_RESULT_BAD_PARAMETER;
+    }
+    return ANDROID_BITMAP_RESULT_SUCCESS;
+}
@@ -34,7 +34,12 @@ extern "C" {
 // the GL renderer. Skia already maintains and restores its GL state, so there
 // is no need for WebView to restore this state. Skia also no longer promises
 // GL state on entering draw, such as no vertex array buffer binding.
-static const int kAwDrawGLInfoVersion = 3;
+// 4 appends the frame damage bounds and destination buffer age, so the
+// WebView can restrict raster and composite work to the changed area when
+// the rest of the buffer is known to be preserved from an earlier frame.
+// The fields are appended at the end of the struct and only meaningful when
+// both sides speak version 4 or later.
+static const int kAwDrawGLInfoVersion = 4;
 
 // Holds the information required to trigger an OpenGL drawing operation.
 struct AwDrawGLInfo {
@@ -81,6 +86,17 @@ struct AwDrawGLInfo {
   // Input: current transformation matrix in surface pixels.
   // Uses the column-based OpenGL matrix format.
   float transform[16];
+
+  // Input (version >= 4): damage bounds of the current frame in surface
+  // coordinates, and the age of the destination buffer in frames. A
+  // buffer_age of 0 means the buffer contents are undefined and everything
+  // must be redrawn; otherwise pixels outside the damage bounds are
+  // preserved from the frame drawn buffer_age frames ago.
+  int damage_left;
+  int damage_top;
+  int damage_right;
+  int damage_bottom;
+  int buffer_age;
 };
 
 // Function to invoke a direct GL draw into the client's pre-configured
@@ -65,6 +65,11 @@ class DrawGLFunctor : public Functor {
         aw_info.width = gl_info->width;
         aw_info.height = gl_info->height;
         aw_info.is_layer = gl_info->isLayer;
+        aw_info.damage_left = gl_info->damageLeft;
+        aw_info.damage_top = gl_info->damageTop;
+        aw_info.damage_right = gl_info->damageRight;
+        aw_info.damage_bottom = gl_info->damageBottom;
+        aw_info.buffer_age = gl_info->bufferAge;
         COMPILE_ASSERT(NELEM(aw_info.transform) == NELEM(gl_info->transform),
                        mismatched_transform_matrix_sizes);
         for (int i = 0; i < NELEM(aw_info.transform); ++i) {
@@ -2103,6 +2103,161 @@ nScriptForEach(JNIEnv *_env, jobject _this, jlong con, jlong script, jint slot,
     }
 }
 
+// Issues a batch of kernel launches recorded by the Java side in one JNI
+// crossing.  Launch i uses scripts[i] / slots[i], takes inCounts[i] input
+// allocations in order from allIns, writes to aouts[i] (0 for none), passes
+// the params bytes in [paramRanges[2i], paramRanges[2i] + paramRanges[2i+1])
+// (a zero length means no params), and is bounded by limits row 6i..6i+5 (an
+// all-zero row launches over the full range).  The whole batch is validated
+// before the first launch is issued; the launches themselves are queued
+// asynchronously by the runtime as usual.
+static void
+nScriptForEachBatch(JNIEnv *_env, jobject _this, jlong con, jlongArray scripts, jintArray slots,
+                    jintArray inCounts, jlongArray allIns, jlongArray aouts,
+                    jbyteArray params, jintArray paramRanges, jintArray limits)
+{
+    if (kLogApi) {
+        ALOGD("nScriptForEachBatch, con(%p)", (RsContext)con);
+    }
+
+    const jint count = _env->GetArrayLength(scripts);
+    if (count == 0) {
+        return;
+    }
+    if (_env->GetArrayLength(slots) != count || _env->GetArrayLength(inCounts) != count
+            || _env->GetArrayLength(aouts) != count
+            || (paramRanges != nullptr && _env->GetArrayLength(paramRanges) != 2 * count)
+            || (limits != nullptr && _env->GetArrayLength(limits) != 6 * count)) {
+        ALOGE("Mismatched array lengths in kernel batch.");
+        // TODO (b/20758983): Report back to Java and throw an exception
+        return;
+    }
+    const jint total_ins = allIns != nullptr ? _env->GetArrayLength(allIns) : 0;
+    const jint total_params = params != nullptr ? _env->GetArrayLength(params) : 0;
+
+    jlong *script_ptr = _env->GetLongArrayElements(scripts, nullptr);
+    jint  *slot_ptr = _env->GetIntArrayElements(slots, nullptr);
+    jint  *in_count_ptr = _env->GetIntArrayElements(inCounts, nullptr);
+    jlong *all_in_ptr = allIns != nullptr ? _env->GetLongArrayElements(allIns, nullptr) : nullptr;
+    jlong *aout_ptr = _env->GetLongArrayElements(aouts, nullptr);
+    jbyte *param_ptr = params != nullptr ? _env->GetByteArrayElements(params, nullptr) : nullptr;
+    jint  *param_range_ptr =
+            paramRanges != nullptr ? _env->GetIntArrayElements(paramRanges, nullptr) : nullptr;
+    jint  *limit_ptr = limits != nullptr ? _env->GetIntArrayElements(limits, nullptr) : nullptr;
+
+    bool valid = script_ptr != nullptr && slot_ptr != nullptr && in_count_ptr != nullptr
+            && aout_ptr != nullptr && (allIns == nullptr || all_in_ptr != nullptr)
+            && (params == nullptr || param_ptr != nullptr)
+            && (paramRanges == nullptr || param_range_ptr != nullptr)
+            && (limits == nullptr || limit_ptr != nullptr);
+    if (!valid) {
+        ALOGE("Failed to get Java array elements");
+    }
+
+    // Validate every launch up front so a bad one aborts the batch before
+    // any work has been queued.
+    if (valid) {
+        jint ins_used = 0;
+        for (jint i = 0; i < count; i++) {
+            if (in_count_ptr[i] < 0 || in_count_ptr[i] > (jint)RS_KERNEL_MAX_ARGUMENTS) {
+                ALOGE("Too many arguments in kernel launch.");
+                valid = false;
+                break;
+            }
+            ins_used += in_count_ptr[i];
+            if (param_range_ptr != nullptr) {
+                const jint offset = param_range_ptr[2 * i];
+                const jint len = param_range_ptr[2 * i + 1];
+                if (offset < 0 || len < 0 || offset > total_params - len) {
+                    ALOGE("Bad params range in kernel batch.");
+                    valid = false;
+                    break;
+                }
+            }
+        }
+        if (valid && ins_used > total_ins) {
+            ALOGE("Not enough input allocations in kernel batch.");
+            valid = false;
+        }
+    }
+
+    if (valid) {
+        jint in_offset = 0;
+        for (jint i = 0; i < count; i++) {
+            const jint in_len = in_count_ptr[i];
+            RsAllocation *in_allocs = nullptr;
+            if (in_len > 0) {
+                if (sizeof(RsAllocation) == sizeof(jlong)) {
+                    in_allocs = (RsAllocation*)(all_in_ptr + in_offset);
+                } else {
+                    // Convert from 64-bit jlong types to the native pointer type.
+                    in_allocs = (RsAllocation*)alloca(in_len * sizeof(RsAllocation));
+                    for (int index = in_len; --index >= 0;) {
+                        in_allocs[index] = (RsAllocation)all_in_ptr[in_offset + index];
+                    }
+                }
+            }
+
+            RsScriptCall sc, *sca = nullptr;
+            uint32_t sc_size = 0;
+            if (limit_ptr != nullptr) {
+                const jint *row = limit_ptr + 6 * i;
+                if (row[0] != 0 || row[1] != 0 || row[2] != 0
+                        || row[3] != 0 || row[4] != 0 || row[5] != 0) {
+                    memset(&sc, 0, sizeof(sc));
+                    sc.xStart   = row[0];
+                    sc.xEnd     = row[1];
+                    sc.yStart   = row[2];
+                    sc.yEnd     = row[3];
+                    sc.zStart   = row[4];
+                    sc.zEnd     = row[5];
+                    sc.strategy = RS_FOR_EACH_STRATEGY_DONT_CARE;
+                    sca = &sc;
+                    // sc_size is required, but unused, by the runtime and drivers.
+                    sc_size = sizeof(sc);
+                }
+            }
+
+            jbyte *launch_params = nullptr;
+            jint launch_param_len = 0;
+            if (param_range_ptr != nullptr && param_range_ptr[2 * i + 1] > 0) {
+                launch_params = param_ptr + param_range_ptr[2 * i];
+                launch_param_len = param_range_ptr[2 * i + 1];
+            }
+
+            rsScriptForEachMulti((RsContext)con, (RsScript)script_ptr[i], slot_ptr[i],
+                                 in_allocs, in_len, (RsAllocation)aout_ptr[i],
+                                 launch_params, launch_param_len, sca, sc_size);
+            in_offset += in_len;
+        }
+    }
+
+    if (script_ptr != nullptr) {
+        _env->ReleaseLongArrayElements(scripts, script_ptr, JNI_ABORT);
+    }
+    if (slot_ptr != nullptr) {
+        _env->ReleaseIntArrayElements(slots, slot_ptr, JNI_ABORT);
+    }
+    if (in_count_ptr != nullptr) {
+        _env->ReleaseIntArrayElements(inCounts, in_count_ptr, JNI_ABORT);
+    }
+    if (all_in_ptr != nullptr) {
+        _env->ReleaseLongArrayElements(allIns, all_in_ptr, JNI_ABORT);
+    }
+    if (aout_ptr != nullptr) {
+        _env->ReleaseLongArrayElements(aouts, aout_ptr, JNI_ABORT);
+    }
+    if (param_ptr != nullptr) {
+        _env->ReleaseByteArrayElements(params, param_ptr, JNI_ABORT);
+    }
+    if (param_range_ptr != nullptr) {
+        _env->ReleaseIntArrayElements(paramRanges, param_range_ptr, JNI_ABORT);
+    }
+    if (limit_ptr != nullptr) {
+        _env->ReleaseIntArrayElements(limits, limit_ptr, JNI_ABORT);
+    }
+}
+
 static void
 nScriptReduce(JNIEnv *_env, jobject _this, jlong con, jlong script, jint slot,
               jlongArray ains, jlong aout, jintArray limits)
@@ -2905,6 +3060,7 @@ static const JNINativeMethod methods[] = {
 {"rsnScriptInvokeV",                 "(JJI[B)V",                              (void*)nScriptInvokeV },
 
 {"rsnScriptForEach",                 "(JJI[JJ[B[I)V",                         (void*)nScriptForEach },
+{"rsnScriptForEachBatch",            "(J[J[I[I[J[J[B[I[I)V",                  (void*)nScriptForEachBatch },
 {"rsnScriptReduce",                  "(JJI[JJ[I)V",                           (void*)nScriptReduce },
 
 {"rsnScriptSetVarI",                 "(JJII)V",                               (void*)nScriptSetVarI },
@@ -60,8 +60,13 @@ static struct {
     struct {
         jclass clazz;
         jmethodID cstor;
+        jmethodID cstorCollection;
         jmethodID add;
     } ArrayList;
+    struct {
+        jclass clazz;
+        jmethodID asList;
+    } Arrays;
     struct {
         jfieldID nativeContext;
         jfieldID region;
@@ -352,11 +357,13 @@ static jobject nativeGetProgramList(JNIEnv *env, jobject obj, jlong nativeContex
         halResult = result;
         if (halResult != ProgramListResult::OK) return;
 
-        jList = make_javaref(env, env->NewObject(gjni.ArrayList.clazz, gjni.ArrayList.cstor));
-        for (auto& program : programList) {
-            auto jProgram = convert::ProgramInfoFromHal(env, program);
-            env->CallBooleanMethod(jList.get(), gjni.ArrayList.add, jProgram.get());
-        }
+        // Build the whole array natively and hand it to Java in two calls,
+        // instead of constructing the list element by element through add().
+        auto jProgramArr = convert::ProgramInfosFromHal(env, programList);
+        auto jProgramList = make_javaref(env, env->CallStaticObjectMethod(
+                gjni.Arrays.clazz, gjni.Arrays.asList, jProgramArr.get()));
+        jList = make_javaref(env, env->NewObject(gjni.ArrayList.clazz,
+                gjni.ArrayList.cstorCollection, jProgramList.get()));
     });
 
     if (convert::ThrowIfFailed(env, hidlResult, halResult)) return nullptr;
@@ -470,8 +477,15 @@ void register_android_server_broadcastradio_Tuner(JavaVM *vm, JNIEnv *env) {
     auto arrayListClass = FindClassOrDie(env, "java/util/ArrayList");
     gjni.ArrayList.clazz = MakeGlobalRefOrDie(env, arrayListClass);
     gjni.ArrayList.cstor = GetMethodIDOrDie(env, arrayListClass, "<init>", "()V");
+    gjni.ArrayList.cstorCollection = GetMethodIDOrDie(env, arrayListClass, "<init>",
+            "(Ljava/util/Collection;)V");
     gjni.ArrayList.add = GetMethodIDOrDie(env, arrayListClass, "add", "(Ljava/lang/Object;)Z");
 
+    auto arraysClass = FindClassOrDie(env, "java/util/Arrays");
+    gjni.Arrays.clazz = MakeGlobalRefOrDie(env, arraysClass);
+    gjni.Arrays.asList = GetStaticMethodIDOrDie(env, arraysClass, "asList",
+            "([Ljava/lang/Object;)Ljava/util/List;");
+
     auto res = jniRegisterNativeMethods(env, "com/android/server/broadcastradio/hal1/Tuner",
             gTunerMethods, NELEM(gTunerMethods));
     LOG_ALWAYS_FATAL_IF(res < 0, "Unable to register native methods.");
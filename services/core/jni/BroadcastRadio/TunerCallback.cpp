@@ -24,8 +24,12 @@
 
 #include <broadcastradio-utils-1x/Utils.h>
 #include <core_jni_helpers.h>
+#include <cutils/properties.h>
 #include <nativehelper/JNIHelp.h>
 #include <utils/Log.h>
+#include <utils/Timers.h>
+
+#include <chrono>
 
 namespace android {
 namespace server {
@@ -98,6 +102,15 @@ class NativeCallback : public ITunerCallback {
     // Carries current program info data for 1.0 newMetadata callback.
     V1_0::ProgramInfo mCurrentProgramInfo;
 
+    // Minimum spacing between onProgramListChanged upcalls; Java re-fetches
+    // the whole list on each one, so during band scans the HAL's hundreds of
+    // notifications per second are coalesced down to this cadence.
+    const nsecs_t mProgramListUpdatePeriodNs;
+    nsecs_t mLastProgramListChangeNs;   // protected by mMut
+    bool mProgramListFlushScheduled;    // protected by mMut
+
+    void notifyProgramListChanged();
+
     DISALLOW_COPY_AND_ASSIGN(NativeCallback);
 
 public:
@@ -132,7 +145,10 @@ private:
 };
 
 NativeCallback::NativeCallback(JNIEnv *env, jobject jTuner, jobject jCallback, HalRevision halRev)
-        : mCallbackThread(gvm), mHalRev(halRev) {
+        : mCallbackThread(gvm), mHalRev(halRev),
+          mProgramListUpdatePeriodNs(
+                  ms2ns(property_get_int32("radio.programlist.min_period_ms", 100))),
+          mLastProgramListChangeNs(0), mProgramListFlushScheduled(false) {
     ALOGV("%s", __func__);
     mJTuner = env->NewGlobalRef(jTuner);
     mJCallback = env->NewGlobalRef(jCallback);
@@ -319,13 +335,51 @@ Return<void> NativeCallback::backgroundScanComplete(ProgramListResult result) {
     return Return<void>();
 }
 
-Return<void> NativeCallback::programListChanged() {
-    ALOGV("%s", __func__);
-
+void NativeCallback::notifyProgramListChanged() {
     mCallbackThread.enqueue([this](JNIEnv *env) {
         env->CallVoidMethod(mJCallback, gjni.TunerCallback.onProgramListChanged);
     });
+}
+
+Return<void> NativeCallback::programListChanged() {
+    ALOGV("%s", __func__);
+
+    if (mProgramListUpdatePeriodNs <= 0) {
+        notifyProgramListChanged();
+        return Return<void>();
+    }
+
+    auto now = systemTime();
+    {
+        lock_guard<mutex> lk(mMut);
+        if (mProgramListFlushScheduled) {
+            // The pending trailing flush will cover this change too.
+            return Return<void>();
+        }
+        auto sinceLast = now - mLastProgramListChangeNs;
+        if (sinceLast < mProgramListUpdatePeriodNs) {
+            /* Too soon after the previous upcall. Schedule a trailing flush so
+             * the last change of a burst is always delivered; the timer runs
+             * on its own thread to keep the callback thread free for scan
+             * progress callbacks.
+             */
+            mProgramListFlushScheduled = true;
+            auto delay = mProgramListUpdatePeriodNs - sinceLast;
+            std::thread([this, self = sp<NativeCallback>(this), delay]() {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(delay));
+                {
+                    lock_guard<mutex> lk(mMut);
+                    mProgramListFlushScheduled = false;
+                    mLastProgramListChangeNs = systemTime();
+                }
+                notifyProgramListChanged();
+            }).detach();
+            return Return<void>();
+        }
+        mLastProgramListChangeNs = now;
+    }
 
+    notifyProgramListChanged();
     return Return<void>();
 }
 
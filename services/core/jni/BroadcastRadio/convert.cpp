@@ -637,6 +637,15 @@ JavaRef<jobject> ProgramInfoFromHal(JNIEnv *env, const V1_1::ProgramInfo &info)
     return ProgramInfoFromHal(env, info.base, &info, info.selector);
 }
 
+JavaRef<jobjectArray> ProgramInfosFromHal(JNIEnv *env,
+        const hidl_vec<V1_1::ProgramInfo> &programList) {
+    ALOGV("%s", __func__);
+    return ArrayFromHal<V1_1::ProgramInfo>(env, programList, gjni.ProgramInfo.clazz,
+            [](JNIEnv *env, const V1_1::ProgramInfo &info) {
+                return ProgramInfoFromHal(env, info);
+            });
+}
+
 } // namespace convert
 } // namespace BroadcastRadio
 } // namespace server
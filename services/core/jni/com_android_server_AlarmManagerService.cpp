@@ -80,10 +80,13 @@ public:
 
     int set(int type, struct timespec *ts);
     int setTime(struct timeval *tv);
-    int waitForAlarm();
+    int waitForAlarm(int64_t windowMillis);
     int getTime(int type, struct itimerspec *spec);
 
 private:
+    int processEvents(const epoll_event *events, int nevents);
+    int64_t soonestDeadlineMillis();
+
     const TimerFds fds;
     const int epollfd;
     const int rtc_id;
@@ -180,15 +183,8 @@ done:
     return res;
 }
 
-int AlarmImpl::waitForAlarm()
+int AlarmImpl::processEvents(const epoll_event *events, int nevents)
 {
-    epoll_event events[N_ANDROID_TIMERFDS];
-
-    int nevents = epoll_wait(epollfd, events, N_ANDROID_TIMERFDS, -1);
-    if (nevents < 0) {
-        return nevents;
-    }
-
     int result = 0;
     for (int i = 0; i < nevents; i++) {
         uint32_t alarm_idx = events[i].data.u32;
@@ -210,6 +206,72 @@ int AlarmImpl::waitForAlarm()
     return result;
 }
 
+/* Returns the milliseconds until the next armed alarm deadline (rounded up),
+   or -1 if no alarm timer is currently armed. The cancel-on-set fd is
+   excluded; it is never armed. */
+int64_t AlarmImpl::soonestDeadlineMillis()
+{
+    int64_t soonest = -1;
+    for (size_t i = 0; i < ANDROID_ALARM_TYPE_COUNT; i++) {
+        struct itimerspec spec;
+        if (timerfd_gettime(fds[i], &spec) < 0) {
+            continue;
+        }
+        if (!spec.it_value.tv_sec && !spec.it_value.tv_nsec) {
+            continue; // disarmed
+        }
+        int64_t millis = spec.it_value.tv_sec * 1000LL
+                + (spec.it_value.tv_nsec + 999999LL) / 1000000LL;
+        if (soonest < 0 || millis < soonest) {
+            soonest = millis;
+        }
+    }
+    return soonest;
+}
+
+int AlarmImpl::waitForAlarm(int64_t windowMillis)
+{
+    epoll_event events[N_ANDROID_TIMERFDS];
+
+    int nevents = epoll_wait(epollfd, events, N_ANDROID_TIMERFDS, -1);
+    if (nevents < 0) {
+        return nevents;
+    }
+
+    int result = processEvents(events, nevents);
+    if (result < 0 || windowMillis <= 0) {
+        return result;
+    }
+
+    // Alarm clocks whose deadlines land inside the batching window are about
+    // to wake us right back up; wait them out here and fold their expirations
+    // into this delivery instead of paying one wake per clock.
+    int64_t budgetMillis = windowMillis;
+    while (budgetMillis > 0) {
+        int64_t soonest = soonestDeadlineMillis();
+        if (soonest < 0 || soonest > budgetMillis) {
+            break;
+        }
+        struct timespec before;
+        clock_gettime(CLOCK_MONOTONIC, &before);
+        nevents = epoll_wait(epollfd, events, N_ANDROID_TIMERFDS, soonest + 1);
+        if (nevents <= 0) {
+            break;
+        }
+        int more = processEvents(events, nevents);
+        if (more < 0) {
+            break;
+        }
+        result |= more;
+        struct timespec after;
+        clock_gettime(CLOCK_MONOTONIC, &after);
+        budgetMillis -= (after.tv_sec - before.tv_sec) * 1000LL
+                + (after.tv_nsec - before.tv_nsec) / 1000000LL;
+    }
+
+    return result;
+}
+
 static jint android_server_AlarmManagerService_setKernelTime(JNIEnv*, jobject, jlong nativeData, jlong millis)
 {
     AlarmImpl *impl = reinterpret_cast<AlarmImpl *>(nativeData);
@@ -432,14 +494,14 @@ static jint android_server_AlarmManagerService_set(JNIEnv*, jobject, jlong nativ
     return result >= 0 ? 0 : errno;
 }
 
-static jint android_server_AlarmManagerService_waitForAlarm(JNIEnv*, jobject, jlong nativeData)
+static jint android_server_AlarmManagerService_waitForAlarm(JNIEnv*, jobject, jlong nativeData, jlong windowMillis)
 {
     AlarmImpl *impl = reinterpret_cast<AlarmImpl *>(nativeData);
     int result = 0;
 
     do
     {
-        result = impl->waitForAlarm();
+        result = impl->waitForAlarm(windowMillis);
     } while (result < 0 && errno == EINTR);
 
     if (result < 0)
@@ -456,7 +518,7 @@ static const JNINativeMethod sMethods[] = {
     {"init", "()J", (void*)android_server_AlarmManagerService_init},
     {"close", "(J)V", (void*)android_server_AlarmManagerService_close},
     {"set", "(JIJJ)I", (void*)android_server_AlarmManagerService_set},
-    {"waitForAlarm", "(J)I", (void*)android_server_AlarmManagerService_waitForAlarm},
+    {"waitForAlarm", "(JJ)I", (void*)android_server_AlarmManagerService_waitForAlarm},
     {"setKernelTime", "(JJ)I", (void*)android_server_AlarmManagerService_setKernelTime},
     {"setKernelTimezone", "(JI)I", (void*)android_server_AlarmManagerService_setKernelTimezone},
     {"getNextAlarm", "(JI)J", (void*)android_server_AlarmManagerService_getNextAlarm},
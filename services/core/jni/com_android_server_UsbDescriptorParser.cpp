@@ -19,6 +19,10 @@
 
 #include <stdlib.h>
 
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "jni.h"
 #include <nativehelper/JNIHelp.h>
 
@@ -27,6 +31,25 @@
 #define MAX_DESCRIPTORS_LENGTH 4096
 static const int USB_CONTROL_TRANSFER_TIMEOUT_MS = 200;
 
+// Each string descriptor costs a control transfer to the device, so a device
+// that disconnects and reconnects repeatedly (docks, flaky hubs) pays that
+// round trip again on every enumeration. Manufacturer and product strings are
+// fixed for a given firmware revision, so remember them keyed by
+// (idVendor, idProduct, bcdDevice, string index). Serial number strings are
+// deliberately never cached: two units of the same model share the key but
+// carry distinct serial strings.
+struct CachedDeviceString {
+    uint16_t vendorId;
+    uint16_t productId;
+    uint16_t bcdDevice;
+    uint8_t stringId;
+    std::u16string value;
+};
+
+static const size_t MAX_CACHED_DEVICE_STRINGS = 64;
+static std::mutex sDeviceStringLock;
+static std::vector<CachedDeviceString> sDeviceStrings;
+
 // com.android.server.usb.descriptors
 extern "C" {
 jbyteArray JNICALL Java_com_android_server_usb_descriptors_UsbDescriptorParser_getRawDescriptors_1native(
@@ -82,6 +105,28 @@ jstring JNICALL Java_com_android_server_usb_descriptors_UsbDescriptorParser_getD
         return NULL;
     }
 
+    // Only the manufacturer and product indices from the device descriptor are
+    // stable across units, so those are the only ones worth remembering.
+    const usb_device_descriptor* deviceDesc = usb_device_get_device_descriptor(device);
+    bool cacheable = stringId != 0
+            && (stringId == deviceDesc->iManufacturer || stringId == deviceDesc->iProduct)
+            && stringId != deviceDesc->iSerialNumber;
+    uint16_t vendorId = usb_device_get_vendor_id(device);
+    uint16_t productId = usb_device_get_product_id(device);
+    uint16_t bcdDevice = __le16_to_cpu(deviceDesc->bcdDevice);
+
+    if (cacheable) {
+        std::lock_guard<std::mutex> lock(sDeviceStringLock);
+        for (const CachedDeviceString& cached : sDeviceStrings) {
+            if (cached.vendorId == vendorId && cached.productId == productId
+                    && cached.bcdDevice == bcdDevice && cached.stringId == stringId) {
+                usb_device_close(device);
+                return env->NewString((const jchar*)cached.value.data(),
+                                      cached.value.length());
+            }
+        }
+    }
+
     // Get Raw UCS2 Bytes
     jbyte* byteBuffer = NULL;
     size_t numUSC2Bytes = 0;
@@ -94,6 +139,14 @@ jstring JNICALL Java_com_android_server_usb_descriptors_UsbDescriptorParser_getD
 
     if (retVal == 0) {
         j_str = env->NewString((jchar*)byteBuffer, numUSC2Bytes/2);
+        if (cacheable) {
+            std::lock_guard<std::mutex> lock(sDeviceStringLock);
+            if (sDeviceStrings.size() >= MAX_CACHED_DEVICE_STRINGS) {
+                sDeviceStrings.erase(sDeviceStrings.begin());
+            }
+            sDeviceStrings.push_back({vendorId, productId, bcdDevice, (uint8_t)stringId,
+                    std::u16string((const char16_t*)byteBuffer, numUSC2Bytes/2)});
+        }
         free(byteBuffer);
     }
 
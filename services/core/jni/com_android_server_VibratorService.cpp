@@ -35,6 +35,8 @@
 #include <inttypes.h>
 #include <stdio.h>
 
+#include <atomic>
+
 using android::hardware::Return;
 using android::hardware::vibrator::V1_0::EffectStrength;
 using android::hardware::vibrator::V1_0::Status;
@@ -49,6 +51,14 @@ namespace android {
 
 static constexpr int NUM_TRIES = 2;
 
+// Effects the HAL has answered UNSUPPORTED_OPERATION for, one bit per effect
+// id, indexed by EffectStrength. Which effects the motor can perform is a
+// static property of its firmware, so a verdict never changes; remembering it
+// saves the doomed HAL round trip before the framework-waveform fallback on
+// every repeat of the same effect.
+static constexpr size_t NUM_STRENGTHS = 3;
+static std::atomic<uint64_t> sUnsupportedEffects[NUM_STRENGTHS];
+
 // Creates a Return<R> with STATUS::EX_NULL_POINTER.
 template<class R>
 inline Return<R> NullptrStatus() {
@@ -160,6 +170,13 @@ static jlong vibratorPerformEffect(JNIEnv*, jobject, jlong effect, jlong strengt
     };
     EffectStrength effectStrength(static_cast<EffectStrength>(strength));
 
+    const bool cacheable = effect >= 0 && effect < 64
+            && strength >= 0 && strength < static_cast<jlong>(NUM_STRENGTHS);
+    if (cacheable && (sUnsupportedEffects[strength].load() & (1ULL << effect))) {
+        // Already known unsupported; let the caller fall back right away.
+        return -1;
+    }
+
     Return<void> ret;
     if (isValidEffect<V1_0::Effect>(effect)) {
         ret = halCall(&V1_0::IVibrator::perform, static_cast<V1_0::Effect>(effect),
@@ -186,10 +203,15 @@ static jlong vibratorPerformEffect(JNIEnv*, jobject, jlong effect, jlong strengt
 
     if (status == Status::OK) {
         return lengthMs;
-    } else if (status != Status::UNSUPPORTED_OPERATION) {
-        // Don't warn on UNSUPPORTED_OPERATION, that's a normal event and just means the motor
-        // doesn't have a pre-defined waveform to perform for it, so we should just give the
-        // opportunity to fall back to the framework waveforms.
+    } else if (status == Status::UNSUPPORTED_OPERATION) {
+        // That's a normal event and just means the motor doesn't have a pre-defined
+        // waveform to perform for it, so we should just give the opportunity to fall
+        // back to the framework waveforms. Don't warn, but do remember the verdict so
+        // the next request for this effect skips the HAL entirely.
+        if (cacheable) {
+            sUnsupportedEffects[strength].fetch_or(1ULL << effect);
+        }
+    } else {
         ALOGE("Failed to perform haptic effect: effect=%" PRId64 ", strength=%" PRId32
                 ", error=%" PRIu32 ").", static_cast<int64_t>(effect),
                 static_cast<int32_t>(strength), static_cast<uint32_t>(status));
@@ -20,17 +20,25 @@
 #include <dirent.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <string>
+#include <vector>
+
 #include <android-base/stringprintf.h>
 #include <android-base/file.h>
 
 #include <nativehelper/JNIHelp.h>
+#include <nativehelper/ScopedPrimitiveArray.h>
+#include <nativehelper/ScopedUtfChars.h>
 #include <android_runtime/AndroidRuntime.h>
 #include <jni.h>
 
+using android::base::ReadFileToString;
 using android::base::StringPrintf;
 using android::base::WriteStringToFile;
 
@@ -74,9 +82,74 @@ static void com_android_server_am_AppCompactor_compactSystem(JNIEnv *, jobject)
     }
 }
 
+// Returns the resident set size of a process in bytes, or -1 if its status
+// file is gone (the process died) or has no VmRSS line.
+static int64_t getProcessRss(int pid) {
+    std::string status;
+    if (!ReadFileToString(StringPrintf("/proc/%d/status", pid), &status)) {
+        return -1;
+    }
+    const char* line = strstr(status.c_str(), "VmRSS:");
+    if (line == nullptr) {
+        return -1;
+    }
+    return strtoll(line + strlen("VmRSS:"), nullptr, 10) * 1024;
+}
+
+// Compacts a batch of processes in one JNI call and reports how much each of
+// them shrank. Reclaim writes stay sequential on the calling thread: the
+// kernel serializes per-process reclaim on mmap_sem anyway, so issuing the
+// writes from several threads only adds contention without finishing the
+// batch sooner. The returned array is parallel to the pid array and holds the
+// VmRSS drop in bytes, or -1 for processes that died mid-batch.
+static jlongArray com_android_server_am_AppCompactor_compactProcessBatch(
+        JNIEnv* env, jobject, jintArray pids, jstring action) {
+    if (pids == NULL || action == NULL) {
+        jniThrowException(env, "java/lang/NullPointerException", "null argument");
+        return NULL;
+    }
+
+    ScopedIntArrayRO pidArray(env, pids);
+    ScopedUtfChars actionChars(env, action);
+    if (actionChars.c_str() == NULL) {
+        return NULL;
+    }
+    const std::string actionString(actionChars.c_str());
+
+    std::vector<jlong> reclaimed(pidArray.size(), -1);
+    for (size_t i = 0; i < pidArray.size(); i++) {
+        int pid = pidArray[i];
+        // see compactSystem: compacting system_server risks mmap_sem stalls
+        if (pid <= 0 || pid == getpid()) {
+            continue;
+        }
+
+        int64_t rssBefore = getProcessRss(pid);
+        if (rssBefore < 0) {
+            continue;
+        }
+        if (!WriteStringToFile(actionString, StringPrintf("/proc/%d/reclaim", pid))) {
+            continue;
+        }
+        int64_t rssAfter = getProcessRss(pid);
+        if (rssAfter >= 0) {
+            reclaimed[i] = rssBefore > rssAfter ? rssBefore - rssAfter : 0;
+        }
+    }
+
+    jlongArray result = env->NewLongArray(reclaimed.size());
+    if (result == NULL) {
+        return NULL;
+    }
+    env->SetLongArrayRegion(result, 0, reclaimed.size(), reclaimed.data());
+    return result;
+}
+
 static const JNINativeMethod sMethods[] = {
     /* name, signature, funcPtr */
     {"compactSystem", "()V", (void*)com_android_server_am_AppCompactor_compactSystem},
+    {"compactProcessBatch", "([ILjava/lang/String;)[J",
+     (void*)com_android_server_am_AppCompactor_compactProcessBatch},
 };
 
 int register_android_server_am_AppCompactor(JNIEnv* env)
@@ -24,6 +24,7 @@
 #include <semaphore.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <memory>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -78,29 +79,38 @@ static jmethodID jgetSubsystem = NULL;
 static jmethodID jputVoter = NULL;
 static jmethodID jputState = NULL;
 
+// Immutable snapshot of the power.stats HAL topology: entity/state/rail names
+// never change for a given HAL instance, so they are built once at
+// (re)initialization and published as a whole. Pollers copy the shared_ptr
+// under gPowerHalMutex and then run the blocking residency query and the
+// output formatting without the mutex, so concurrent pollers only contend for
+// the pointer copy and not for the HAL round trip.
+struct PowerStatsHalInfo {
+    std::unordered_map<uint32_t, std::string> entityNames;
+    std::unordered_map<uint32_t, std::unordered_map<uint32_t, std::string>> stateNames;
+    std::vector<uint32_t> platformIds;
+    std::vector<uint32_t> subsystemIds;
+    // Cellular/Wifi power monitor rail information
+    std::unordered_map<uint32_t, std::pair<std::string, std::string>> railNames;
+    bool powerMonitorAvailable = false;
+};
+
 std::mutex gPowerHalMutex;
-std::unordered_map<uint32_t, std::string> gPowerStatsHalEntityNames = {};
-std::unordered_map<uint32_t, std::unordered_map<uint32_t, std::string>>
-    gPowerStatsHalStateNames = {};
-std::vector<uint32_t> gPowerStatsHalPlatformIds = {};
-std::vector<uint32_t> gPowerStatsHalSubsystemIds = {};
+std::shared_ptr<const PowerStatsHalInfo> gPowerStatsHalInfo = nullptr;
 sp<android::hardware::power::stats::V1_0::IPowerStats> gPowerStatsHalV1_0 = nullptr;
 std::function<void(JNIEnv*, jobject)> gGetLowPowerStatsImpl = {};
 std::function<jint(JNIEnv*, jobject)> gGetPlatformLowPowerStatsImpl = {};
 std::function<jint(JNIEnv*, jobject)> gGetSubsystemLowPowerStatsImpl = {};
 
-// Cellular/Wifi power monitor rail information
 static jmethodID jupdateRailData = NULL;
 static jmethodID jsetRailStatsAvailability = NULL;
 
 std::function<void(JNIEnv*, jobject)> gGetRailEnergyPowerStatsImpl = {};
 
-std::unordered_map<uint32_t, std::pair<std::string, std::string>> gPowerStatsHalRailNames = {};
-static bool power_monitor_available = false;
-
 // The caller must be holding gPowerHalMutex.
 static void deinitPowerStatsLocked() {
     gPowerStatsHalV1_0 = nullptr;
+    gPowerStatsHalInfo = nullptr;
 }
 
 struct PowerHalDeathRecipient : virtual public hardware::hidl_death_recipient {
@@ -258,21 +268,33 @@ static bool checkResultLocked(const Return<void> &ret, const char* function) {
     return true;
 }
 
+// Same as checkResultLocked for callers that run the HAL transaction without
+// holding gPowerHalMutex; only takes the mutex to drop dead handles.
+static bool checkResult(const Return<void> &ret, const char* function) {
+    if (!ret.isOk()) {
+        ALOGE("%s failed: requested HAL service not available. Description: %s",
+            function, ret.description().c_str());
+        if (ret.isDeadObject()) {
+            std::lock_guard<std::mutex> lock(gPowerHalMutex);
+            deinitPowerStatsLocked();
+        }
+        return false;
+    }
+    return true;
+}
+
 // The caller must be holding gPowerHalMutex.
 // gPowerStatsHalV1_0 must not be null
 static bool initializePowerStats() {
     using android::hardware::power::stats::V1_0::Status;
     using android::hardware::power::stats::V1_0::PowerEntityType;
 
-    // Clear out previous content if we are re-initializing
-    gPowerStatsHalEntityNames.clear();
-    gPowerStatsHalStateNames.clear();
-    gPowerStatsHalPlatformIds.clear();
-    gPowerStatsHalSubsystemIds.clear();
-    gPowerStatsHalRailNames.clear();
+    // Build a fresh snapshot; the previous one (if any) stays visible to
+    // in-flight pollers until the swap below.
+    auto halInfo = std::make_shared<PowerStatsHalInfo>();
 
     Return<void> ret;
-    ret = gPowerStatsHalV1_0->getPowerEntityInfo([](auto infos, auto status) {
+    ret = gPowerStatsHalV1_0->getPowerEntityInfo([&halInfo](auto infos, auto status) {
         if (status != Status::SUCCESS) {
             ALOGE("Error getting power entity info");
             return;
@@ -281,11 +303,11 @@ static bool initializePowerStats() {
         // construct lookup table of powerEntityId to power entity name
         // also construct vector of platform and subsystem IDs
         for (auto info : infos) {
-            gPowerStatsHalEntityNames.emplace(info.powerEntityId, info.powerEntityName);
+            halInfo->entityNames.emplace(info.powerEntityId, info.powerEntityName);
             if (info.type == PowerEntityType::POWER_DOMAIN) {
-                gPowerStatsHalPlatformIds.emplace_back(info.powerEntityId);
+                halInfo->platformIds.emplace_back(info.powerEntityId);
             } else {
-                gPowerStatsHalSubsystemIds.emplace_back(info.powerEntityId);
+                halInfo->subsystemIds.emplace_back(info.powerEntityId);
             }
         }
     });
@@ -293,7 +315,8 @@ static bool initializePowerStats() {
         return false;
     }
 
-    ret = gPowerStatsHalV1_0->getPowerEntityStateInfo({}, [](auto stateSpaces, auto status) {
+    ret = gPowerStatsHalV1_0->getPowerEntityStateInfo({}, [&halInfo](auto stateSpaces,
+            auto status) {
         if (status != Status::SUCCESS) {
             ALOGE("Error getting state info");
             return;
@@ -306,7 +329,7 @@ static bool initializePowerStats() {
                 stateNames.emplace(state.powerEntityStateId,
                     state.powerEntityStateName);
             }
-            gPowerStatsHalStateNames.emplace(stateSpace.powerEntityId, stateNames);
+            halInfo->stateNames.emplace(stateSpace.powerEntityId, stateNames);
         }
     });
     if (!checkResultLocked(ret, __func__)) {
@@ -314,27 +337,31 @@ static bool initializePowerStats() {
     }
 
     // Get Power monitor rails available
-    ret = gPowerStatsHalV1_0->getRailInfo([](auto rails, auto status) {
+    ret = gPowerStatsHalV1_0->getRailInfo([&halInfo](auto rails, auto status) {
         if (status != Status::SUCCESS) {
             ALOGW("Rail information is not available");
-            power_monitor_available = false;
+            halInfo->powerMonitorAvailable = false;
             return;
         }
 
-        // Fill out rail names/subsystems into gPowerStatsHalRailNames
+        // Fill out rail names/subsystems
         for (auto rail : rails) {
-            gPowerStatsHalRailNames.emplace(rail.index,
+            halInfo->railNames.emplace(rail.index,
                 std::make_pair(rail.railName, rail.subsysName));
         }
-        if (!gPowerStatsHalRailNames.empty()) {
-            power_monitor_available = true;
+        if (!halInfo->railNames.empty()) {
+            halInfo->powerMonitorAvailable = true;
         }
     });
     if (!checkResultLocked(ret, __func__)) {
         return false;
     }
 
-    return (!gPowerStatsHalEntityNames.empty()) && (!gPowerStatsHalStateNames.empty());
+    if (halInfo->entityNames.empty() || halInfo->stateNames.empty()) {
+        return false;
+    }
+    gPowerStatsHalInfo = std::move(halInfo);
+    return true;
 }
 
 // The caller must be holding gPowerHalMutex.
@@ -362,19 +389,34 @@ static bool getPowerStatsHalLocked() {
     return true;
 }
 
-// The caller must be holding powerHalMutex.
+// Copies the HAL handle and topology snapshot out under gPowerHalMutex so the
+// blocking residency queries and their formatting can run without it.
+static bool getPowerStatsHalSnapshot(
+        sp<android::hardware::power::stats::V1_0::IPowerStats>* hal,
+        std::shared_ptr<const PowerStatsHalInfo>* info) {
+    std::lock_guard<std::mutex> lock(gPowerHalMutex);
+    if (!getPowerStatsHalLocked()) {
+        return false;
+    }
+    *hal = gPowerStatsHalV1_0;
+    *info = gPowerStatsHalInfo;
+    return true;
+}
+
 static void getPowerStatsHalLowPowerData(JNIEnv* env, jobject jrpmStats) {
     using android::hardware::power::stats::V1_0::Status;
 
-    if (!getPowerStatsHalLocked()) {
+    sp<android::hardware::power::stats::V1_0::IPowerStats> hal;
+    std::shared_ptr<const PowerStatsHalInfo> halInfo;
+    if (!getPowerStatsHalSnapshot(&hal, &halInfo)) {
         ALOGE("failed to get low power stats");
         return;
     }
 
     // Get power entity state residency data
     bool success = false;
-    Return<void> ret = gPowerStatsHalV1_0->getPowerEntityStateResidencyData({},
-        [&env, &jrpmStats, &success](auto results, auto status) {
+    Return<void> ret = hal->getPowerEntityStateResidencyData({},
+        [&env, &jrpmStats, &halInfo, &success](auto results, auto status) {
             if (status == Status::NOT_SUPPORTED) {
                 ALOGW("getPowerEntityStateResidencyData is not supported");
                 success = false;
@@ -383,7 +425,7 @@ static void getPowerStatsHalLowPowerData(JNIEnv* env, jobject jrpmStats) {
 
             for (auto result : results) {
                 jobject jsubsystem = env->CallObjectMethod(jrpmStats, jgetSubsystem,
-                    env->NewStringUTF(gPowerStatsHalEntityNames.at(result.powerEntityId).c_str()));
+                    env->NewStringUTF(halInfo->entityNames.at(result.powerEntityId).c_str()));
                 if (jsubsystem == NULL) {
                     ALOGE("The rpmstats jni jobject jsubsystem is null.");
                     return;
@@ -391,7 +433,7 @@ static void getPowerStatsHalLowPowerData(JNIEnv* env, jobject jrpmStats) {
                 for (auto stateResidency : result.stateResidencyData) {
 
                     env->CallVoidMethod(jsubsystem, jputState,
-                        env->NewStringUTF(gPowerStatsHalStateNames.at(result.powerEntityId)
+                        env->NewStringUTF(halInfo->stateNames.at(result.powerEntityId)
                         .at(stateResidency.powerEntityStateId).c_str()),
                         stateResidency.totalTimeInStateMs,
                         stateResidency.totalStateEntryCount);
@@ -399,7 +441,7 @@ static void getPowerStatsHalLowPowerData(JNIEnv* env, jobject jrpmStats) {
             }
             success = true;
         });
-    checkResultLocked(ret, __func__);
+    checkResult(ret, __func__);
     if (!success) {
         ALOGE("getPowerEntityStateResidencyData failed");
     }
@@ -410,7 +452,9 @@ static jint getPowerStatsHalPlatformData(JNIEnv* env, jobject outBuf) {
     using hardware::power::stats::V1_0::PowerEntityStateResidencyResult;
     using hardware::power::stats::V1_0::PowerEntityStateResidencyData;
 
-    if (!getPowerStatsHalLocked()) {
+    sp<android::hardware::power::stats::V1_0::IPowerStats> hal;
+    std::shared_ptr<const PowerStatsHalInfo> halInfo;
+    if (!getPowerStatsHalSnapshot(&hal, &halInfo)) {
         ALOGE("failed to get low power stats");
         return -1;
     }
@@ -421,9 +465,9 @@ static jint getPowerStatsHalPlatformData(JNIEnv* env, jobject outBuf) {
     int total_added = -1;
 
     // Get power entity state residency data
-    Return<void> ret = gPowerStatsHalV1_0->getPowerEntityStateResidencyData(
-        gPowerStatsHalPlatformIds,
-        [&offset, &remaining, &total_added](auto results, auto status) {
+    Return<void> ret = hal->getPowerEntityStateResidencyData(
+        halInfo->platformIds,
+        [&halInfo, &offset, &remaining, &total_added](auto results, auto status) {
             if (status == Status::NOT_SUPPORTED) {
                 ALOGW("getPowerEntityStateResidencyData is not supported");
                 return;
@@ -437,7 +481,7 @@ static jint getPowerStatsHalPlatformData(JNIEnv* env, jobject outBuf) {
                         result.stateResidencyData[j];
                     int added = snprintf(offset, remaining,
                         "state_%zu name=%s time=%" PRIu64 " count=%" PRIu64 " ",
-                        j + 1, gPowerStatsHalStateNames.at(result.powerEntityId)
+                        j + 1, halInfo->stateNames.at(result.powerEntityId)
                            .at(stateResidency.powerEntityStateId).c_str(),
                         stateResidency.totalTimeInStateMs,
                         stateResidency.totalStateEntryCount);
@@ -460,7 +504,7 @@ static jint getPowerStatsHalPlatformData(JNIEnv* env, jobject outBuf) {
                 }
             }
         });
-    if (!checkResultLocked(ret, __func__)) {
+    if (!checkResult(ret, __func__)) {
         return -1;
     }
 
@@ -473,7 +517,9 @@ static jint getPowerStatsHalSubsystemData(JNIEnv* env, jobject outBuf) {
     using hardware::power::stats::V1_0::PowerEntityStateResidencyResult;
     using hardware::power::stats::V1_0::PowerEntityStateResidencyData;
 
-    if (!getPowerStatsHalLocked()) {
+    sp<android::hardware::power::stats::V1_0::IPowerStats> hal;
+    std::shared_ptr<const PowerStatsHalInfo> halInfo;
+    if (!getPowerStatsHalSnapshot(&hal, &halInfo)) {
         ALOGE("failed to get low power stats");
         return -1;
     }
@@ -484,9 +530,9 @@ static jint getPowerStatsHalSubsystemData(JNIEnv* env, jobject outBuf) {
     int total_added = -1;
 
     // Get power entity state residency data
-    Return<void> ret = gPowerStatsHalV1_0->getPowerEntityStateResidencyData(
-        gPowerStatsHalSubsystemIds,
-        [&offset, &remaining, &total_added](auto results, auto status) {
+    Return<void> ret = hal->getPowerEntityStateResidencyData(
+        halInfo->subsystemIds,
+        [&halInfo, &offset, &remaining, &total_added](auto results, auto status) {
             if (status == Status::NOT_SUPPORTED) {
                 ALOGW("getPowerEntityStateResidencyData is not supported");
                 return;
@@ -500,7 +546,7 @@ static jint getPowerStatsHalSubsystemData(JNIEnv* env, jobject outBuf) {
             for (size_t i = 0; i < results.size(); i++) {
                 const PowerEntityStateResidencyResult& result = results[i];
                 added = snprintf(offset, remaining, "subsystem_%zu name=%s ",
-                        i + 1, gPowerStatsHalEntityNames.at(result.powerEntityId).c_str());
+                        i + 1, halInfo->entityNames.at(result.powerEntityId).c_str());
                 if (added < 0) {
                     break;
                 }
@@ -518,7 +564,7 @@ static jint getPowerStatsHalSubsystemData(JNIEnv* env, jobject outBuf) {
                         result.stateResidencyData[j];
                     added = snprintf(offset, remaining,
                         "state_%zu name=%s time=%" PRIu64 " count=%" PRIu64 " last entry=%"
-                        PRIu64 " ", j + 1, gPowerStatsHalStateNames.at(result.powerEntityId)
+                        PRIu64 " ", j + 1, halInfo->stateNames.at(result.powerEntityId)
                            .at(stateResidency.powerEntityStateId).c_str(),
                         stateResidency.totalTimeInStateMs,
                         stateResidency.totalStateEntryCount,
@@ -542,7 +588,7 @@ static jint getPowerStatsHalSubsystemData(JNIEnv* env, jobject outBuf) {
                 }
             }
         });
-    if (!checkResultLocked(ret, __func__)) {
+    if (!checkResult(ret, __func__)) {
         return -1;
     }
 
@@ -554,20 +600,22 @@ static void getPowerStatsHalRailEnergyData(JNIEnv* env, jobject jrailStats) {
     using android::hardware::power::stats::V1_0::Status;
     using android::hardware::power::stats::V1_0::EnergyData;
 
-    if (!getPowerStatsHalLocked()) {
+    sp<android::hardware::power::stats::V1_0::IPowerStats> hal;
+    std::shared_ptr<const PowerStatsHalInfo> halInfo;
+    if (!getPowerStatsHalSnapshot(&hal, &halInfo)) {
         ALOGE("failed to get power stats");
         return;
     }
 
-    if (!power_monitor_available) {
+    if (!halInfo->powerMonitorAvailable) {
         env->CallVoidMethod(jrailStats, jsetRailStatsAvailability, false);
         ALOGW("Rail energy data is not available");
         return;
     }
 
     // Get power rail energySinceBoot data
-    Return<void> ret = gPowerStatsHalV1_0->getEnergyData({},
-        [&env, &jrailStats](auto energyData, auto status) {
+    Return<void> ret = hal->getEnergyData({},
+        [&env, &jrailStats, &halInfo](auto energyData, auto status) {
             if (status == Status::NOT_SUPPORTED) {
                 ALOGW("getEnergyData is not supported");
                 return;
@@ -579,9 +627,9 @@ static void getPowerStatsHalRailEnergyData(JNIEnv* env, jobject jrailStats) {
                         jupdateRailData,
                         data.index,
                         env->NewStringUTF(
-                            gPowerStatsHalRailNames.at(data.index).first.c_str()),
+                            halInfo->railNames.at(data.index).first.c_str()),
                         env->NewStringUTF(
-                            gPowerStatsHalRailNames.at(data.index).second.c_str()),
+                            halInfo->railNames.at(data.index).second.c_str()),
                         data.timestamp,
                         data.energy);
                 } else {
@@ -589,12 +637,11 @@ static void getPowerStatsHalRailEnergyData(JNIEnv* env, jobject jrailStats) {
                 }
             }
         });
-    if (!checkResultLocked(ret, __func__)) {
+    if (!checkResult(ret, __func__)) {
         ALOGE("getEnergyData failed");
     }
 }
 
-// The caller must be holding powerHalMutex.
 static void getPowerHalLowPowerData(JNIEnv* env, jobject jrpmStats) {
     sp<IPowerV1_0> powerHalV1_0 = getPowerHalV1_0();
     if (powerHalV1_0 == nullptr) {
@@ -860,14 +907,19 @@ static void getLowPowerStats(JNIEnv* env, jobject /* clazz */, jobject jrpmStats
         return;
     }
 
-    std::lock_guard<std::mutex> lock(gPowerHalMutex);
-
-    if (!gGetLowPowerStatsImpl) {
-        setUpPowerStatsLocked();
+    std::function<void(JNIEnv*, jobject)> impl;
+    {
+        // The lock only covers impl selection; the impls take whatever they
+        // need from gPowerHalMutex themselves before the HAL transaction.
+        std::lock_guard<std::mutex> lock(gPowerHalMutex);
+        if (!gGetLowPowerStatsImpl) {
+            setUpPowerStatsLocked();
+        }
+        impl = gGetLowPowerStatsImpl;
     }
 
-    if (gGetLowPowerStatsImpl) {
-        return gGetLowPowerStatsImpl(env, jrpmStats);
+    if (impl) {
+        return impl(env, jrpmStats);
     }
 
     ALOGE("Unable to load Power Hal or power.stats HAL");
@@ -880,14 +932,17 @@ static jint getPlatformLowPowerStats(JNIEnv* env, jobject /* clazz */, jobject o
         return -1;
     }
 
-    std::lock_guard<std::mutex> lock(gPowerHalMutex);
-
-    if (!gGetPlatformLowPowerStatsImpl) {
-        setUpPowerStatsLocked();
+    std::function<jint(JNIEnv*, jobject)> impl;
+    {
+        std::lock_guard<std::mutex> lock(gPowerHalMutex);
+        if (!gGetPlatformLowPowerStatsImpl) {
+            setUpPowerStatsLocked();
+        }
+        impl = gGetPlatformLowPowerStatsImpl;
     }
 
-    if (gGetPlatformLowPowerStatsImpl) {
-        return gGetPlatformLowPowerStatsImpl(env, outBuf);
+    if (impl) {
+        return impl(env, outBuf);
     }
 
     ALOGE("Unable to load Power Hal or power.stats HAL");
@@ -900,14 +955,17 @@ static jint getSubsystemLowPowerStats(JNIEnv* env, jobject /* clazz */, jobject
         return -1;
     }
 
-    std::lock_guard<std::mutex> lock(gPowerHalMutex);
-
-    if (!gGetSubsystemLowPowerStatsImpl) {
-        setUpPowerStatsLocked();
+    std::function<jint(JNIEnv*, jobject)> impl;
+    {
+        std::lock_guard<std::mutex> lock(gPowerHalMutex);
+        if (!gGetSubsystemLowPowerStatsImpl) {
+            setUpPowerStatsLocked();
+        }
+        impl = gGetSubsystemLowPowerStatsImpl;
     }
 
-    if (gGetSubsystemLowPowerStatsImpl) {
-        return gGetSubsystemLowPowerStatsImpl(env, outBuf);
+    if (impl) {
+        return impl(env, outBuf);
     }
 
     ALOGE("Unable to load Power Hal or power.stats HAL");
@@ -925,14 +983,17 @@ static void getRailEnergyPowerStats(JNIEnv* env, jobject /* clazz */, jobject jr
         return;
     }
 
-    std::lock_guard<std::mutex> lock(gPowerHalMutex);
-
-    if (!gGetRailEnergyPowerStatsImpl) {
-        setUpPowerStatsLocked();
+    std::function<void(JNIEnv*, jobject)> impl;
+    {
+        std::lock_guard<std::mutex> lock(gPowerHalMutex);
+        if (!gGetRailEnergyPowerStatsImpl) {
+            setUpPowerStatsLocked();
+        }
+        impl = gGetRailEnergyPowerStatsImpl;
     }
 
-    if (gGetRailEnergyPowerStatsImpl)  {
-        gGetRailEnergyPowerStatsImpl(env, jrailStats);
+    if (impl)  {
+        impl(env, jrailStats);
         return;
     }
 
@@ -21,6 +21,8 @@
 #include <string.h>
 #include <sys/epoll.h>
 
+#include <atomic>
+
 #include <jni.h>
 #include <nativehelper/JNIHelp.h>
 #include <utils/Log.h>
@@ -45,6 +47,21 @@ static constexpr int PSI_WINDOW_SIZE_US = 1000000;
 
 static int psi_epollfd = -1;
 
+// Optional mirror of the detector state into a direct ByteBuffer supplied by
+// the Java side, so consumers of the pressure level (e.g. the compaction
+// policy) can read the latest severity without a JNI call per query. Word 0
+// is a sequence number bumped after every update, word 1 the pressure level.
+static std::atomic<int32_t>* psi_state_words = nullptr;
+
+static void publish_pressure_level(uint32_t pressure_level) {
+    std::atomic<int32_t>* words = psi_state_words;
+    if (words == nullptr) {
+        return;
+    }
+    words[1].store(pressure_level, std::memory_order_relaxed);
+    words[0].fetch_add(1, std::memory_order_release);
+}
+
 static jint android_server_am_LowMemDetector_init(JNIEnv*, jobject) {
     int epollfd;
     int low_psi_fd;
@@ -113,6 +130,7 @@ static jint android_server_am_LowMemDetector_waitForPressure(JNIEnv*, jobject) {
             nevents = epoll_wait(psi_epollfd, events, PRESSURE_LEVEL_COUNT, 1000);
             if (nevents == 0) {
                 pressure_level = PRESSURE_NONE;
+                publish_pressure_level(pressure_level);
                 return pressure_level;
             }
         }
@@ -138,14 +156,34 @@ static jint android_server_am_LowMemDetector_waitForPressure(JNIEnv*, jobject) {
         }
     }
 
+    publish_pressure_level(pressure_level);
     return pressure_level;
 }
 
+static void android_server_am_LowMemDetector_setPressureStateBuffer(JNIEnv* env, jobject,
+                                                                    jobject buffer) {
+    if (buffer == NULL) {
+        psi_state_words = nullptr;
+        return;
+    }
+
+    void* address = env->GetDirectBufferAddress(buffer);
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (address == nullptr || capacity < (jlong)(2 * sizeof(int32_t))) {
+        jniThrowException(env, "java/lang/IllegalArgumentException",
+                          "Expected a direct ByteBuffer holding at least two ints");
+        return;
+    }
+    psi_state_words = static_cast<std::atomic<int32_t>*>(address);
+}
+
 static const JNINativeMethod sMethods[] = {
     /* name, signature, funcPtr */
     {"init", "()I", (void*)android_server_am_LowMemDetector_init},
     {"waitForPressure", "()I",
      (void*)android_server_am_LowMemDetector_waitForPressure},
+    {"setPressureStateBuffer", "(Ljava/nio/ByteBuffer;)V",
+     (void*)android_server_am_LowMemDetector_setPressureStateBuffer},
 };
 
 int register_android_server_am_LowMemDetector(JNIEnv* env) {
@@ -222,6 +222,7 @@ public:
     void setInputDeviceEnabled(uint32_t deviceId, bool enabled);
     void setShowTouches(bool enabled);
     void setVolumeKeysRotation(int mode);
+    void setInterceptKeyPassthroughKeys(JNIEnv* env, jintArray keyCodesArray);
     void setInteractive(bool interactive);
     void reloadCalibration();
     void setPointerIconType(int32_t iconId);
@@ -304,6 +305,11 @@ private:
         // Volume keys rotation mode (0 - off, 1 - phone, 2 - tablet)
         int32_t volumeKeysRotationMode;
 
+        // Keys the policy has promised to pass through unchanged at queue
+        // time while interactive, letting the hot path skip the Java round
+        // trip. Java replaces the whole set whenever the policy changes.
+        SortedVector<int32_t> interceptPassthroughKeys;
+
         // Sprite controller singleton, created on first use.
         sp<SpriteController> spriteController;
 
@@ -965,6 +971,21 @@ void NativeInputManager::setVolumeKeysRotation(int mode) {
             InputReaderConfiguration::CHANGE_VOLUME_KEYS_ROTATION);
 }
 
+void NativeInputManager::setInterceptKeyPassthroughKeys(JNIEnv* env, jintArray keyCodesArray) {
+    SortedVector<int32_t> keyCodes;
+    if (keyCodesArray != nullptr) {
+        jsize length = env->GetArrayLength(keyCodesArray);
+        jint* codes = env->GetIntArrayElements(keyCodesArray, nullptr);
+        for (jsize i = 0; i < length; i++) {
+            keyCodes.add(codes[i]);
+        }
+        env->ReleaseIntArrayElements(keyCodesArray, codes, JNI_ABORT);
+    }
+
+    AutoMutex _l(mLock);
+    mLocked.interceptPassthroughKeys = keyCodes;
+}
+
 void NativeInputManager::setInteractive(bool interactive) {
     mInteractive = interactive;
 }
@@ -1082,6 +1103,15 @@ void NativeInputManager::interceptKeyBeforeQueueing(const KeyEvent* keyEvent,
     }
     if ((policyFlags & POLICY_FLAG_TRUSTED)) {
         nsecs_t when = keyEvent->getEventTime();
+        if (interactive && !(policyFlags & POLICY_FLAG_INJECTED)) {
+            // Keys the policy has promised to pass through while interactive
+            // skip the Java round trip entirely.
+            AutoMutex _l(mLock);
+            if (mLocked.interceptPassthroughKeys.indexOf(keyEvent->getKeyCode()) >= 0) {
+                policyFlags |= POLICY_FLAG_PASS_TO_USER;
+                return;
+            }
+        }
         JNIEnv* env = jniEnv();
         jobject keyEventObj = android_view_KeyEvent_fromNative(env, keyEvent);
         jint wmActions;
@@ -1635,6 +1665,13 @@ static void nativeSetVolumeKeysRotation(JNIEnv* env,
     im->setVolumeKeysRotation(mode);
 }
 
+static void nativeSetInterceptKeyPassthroughKeys(JNIEnv* env,
+        jclass clazz, jlong ptr, jintArray keyCodes) {
+    NativeInputManager* im = reinterpret_cast<NativeInputManager*>(ptr);
+
+    im->setInterceptKeyPassthroughKeys(env, keyCodes);
+}
+
 static void nativeSetInteractive(JNIEnv* env,
         jclass clazz, jlong ptr, jboolean interactive) {
     NativeInputManager* im = reinterpret_cast<NativeInputManager*>(ptr);
@@ -1828,6 +1865,8 @@ static const JNINativeMethod gInputManagerMethods[] = {
             (void*) nativeSetShowTouches },
     { "nativeSetVolumeKeysRotation", "(JI)V",
             (void*) nativeSetVolumeKeysRotation },
+    { "nativeSetInterceptKeyPassthroughKeys", "(J[I)V",
+            (void*) nativeSetInterceptKeyPassthroughKeys },
     { "nativeSetInteractive", "(JZ)V",
             (void*) nativeSetInteractive },
     { "nativeReloadCalibration", "(J)V",
@@ -42,14 +42,12 @@
 #include <linux/in.h>
 #include <linux/in6.h>
 #include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 #include <utils/SystemClock.h>
 
-static jclass class_gnssMeasurementsEvent;
-static jclass class_gnssMeasurement;
 static jclass class_location;
 static jclass class_gnssNavigationMessage;
-static jclass class_gnssClock;
 static jclass class_gnssConfiguration_halInterfaceVersion;
 
 static jobject mCallbacksObj = nullptr;
@@ -74,7 +72,7 @@ static jmethodID method_reportGeofenceAddStatus;
 static jmethodID method_reportGeofenceRemoveStatus;
 static jmethodID method_reportGeofencePauseStatus;
 static jmethodID method_reportGeofenceResumeStatus;
-static jmethodID method_reportMeasurementData;
+static jmethodID method_reportMeasurementDataBatch;
 static jmethodID method_reportNavigationMessages;
 static jmethodID method_reportLocationBatch;
 static jmethodID method_reportGnssServiceDied;
@@ -102,11 +100,8 @@ static jmethodID method_correctionPlaneAltDeg;
 static jmethodID method_correctionPlaneAzimDeg;
 static jmethodID method_reportNfwNotification;
 static jmethodID method_isInEmergencySession;
-static jmethodID method_gnssMeasurementsEventCtor;
 static jmethodID method_locationCtor;
 static jmethodID method_gnssNavigationMessageCtor;
-static jmethodID method_gnssClockCtor;
-static jmethodID method_gnssMeasurementCtor;
 static jmethodID method_halInterfaceVersionCtor;
 
 /*
@@ -976,12 +971,69 @@ struct GnssMeasurementCallback : public IGnssMeasurementCallback_V2_0 {
             override;
     Return<void> gnssMeasurementCb(const IGnssMeasurementCallback_V1_1::GnssData& data) override;
     Return<void> GnssMeasurementCb(const IGnssMeasurementCallback_V1_0::GnssData& data) override;
+
+    virtual ~GnssMeasurementCallback() {
+        if (mBatchBufferGlobal != nullptr) {
+            getJniEnv()->DeleteGlobalRef(mBatchBufferGlobal);
+        }
+        free(mBatchBuffer);
+    }
+
  private:
-    template<class T>
-    void translateSingleGnssMeasurement(const T* measurement, JavaObject& object);
+    /*
+     * Flat per-epoch records handed to the Java layer in a single crossing.
+     * The Java side decodes them out of the direct ByteBuffer; both halves
+     * must agree on this layout, which is padding-free on LP64 and LP32.
+     */
+    struct GnssClockRecord {
+        jint flags;  // GnssClockFlags from the HAL.
+        jint leapSecond;
+        jlong timeNanos;
+        jdouble timeUncertaintyNanos;
+        jlong fullBiasNanos;
+        jdouble biasNanos;
+        jdouble biasUncertaintyNanos;
+        jdouble driftNanosPerSecond;
+        jdouble driftUncertaintyNanosPerSecond;
+        jdouble elapsedRealtimeUncertaintyNanos;
+        jlong elapsedRealtimeNanos;
+        jint elapsedRealtimeFlags;  // ElapsedRealtimeFlags from the HAL.
+        jint hardwareClockDiscontinuityCount;
+    };
+
+    struct GnssMeasurementRecord {
+        jint flags;  // GnssMeasurementFlags from the HAL.
+        jint svid;
+        jint constellationType;
+        jint state;
+        jint accumulatedDeltaRangeState;
+        jint multipathIndicator;
+        jdouble timeOffsetNanos;
+        jlong receivedSvTimeNanos;
+        jlong receivedSvTimeUncertaintyNanos;
+        jdouble cn0DbHz;
+        jdouble pseudorangeRateMetersPerSecond;
+        jdouble pseudorangeRateUncertaintyMetersPerSecond;
+        jdouble accumulatedDeltaRangeMeters;
+        jdouble accumulatedDeltaRangeUncertaintyMeters;
+        jdouble carrierFrequencyHz;
+        jdouble snrInDb;
+        jdouble automaticGainControlLevelInDb;
+        char codeType[8];  // NUL-terminated; empty below HAL 2.0.
+    };
+
+    static constexpr size_t kMaxBatchedMeasurements =
+            static_cast<size_t>(android::hardware::gnss::V1_0::GnssMax::SVS_COUNT);
+
+    // Backing store for one epoch, wrapped once in a direct ByteBuffer whose
+    // global reference is reused for every upcall.
+    uint8_t* mBatchBuffer = nullptr;
+    jobject mBatchBufferGlobal = nullptr;
+
+    bool ensureBatchBuffer(JNIEnv* env);
 
     template<class T>
-    jobjectArray translateAllGnssMeasurements(JNIEnv* env, const T* measurements, size_t count);
+    void packSingleGnssMeasurement(const T* measurement, GnssMeasurementRecord* record);
 
     template<class T>
     void translateAndSetGnssData(const T& data);
@@ -990,9 +1042,7 @@ struct GnssMeasurementCallback : public IGnssMeasurementCallback_V2_0 {
     size_t getMeasurementCount(const T& data);
 
     template<class T>
-    void translateGnssClock(JavaObject& object, const T& data);
-
-    void setMeasurementData(JNIEnv* env, jobject clock, jobjectArray measurementArray);
+    void packGnssClock(GnssClockRecord* record, const T& data);
 };
 
 Return<void> GnssMeasurementCallback::gnssMeasurementCb_2_0(
@@ -1013,20 +1063,57 @@ Return<void> GnssMeasurementCallback::GnssMeasurementCb(
     return Void();
 }
 
+bool GnssMeasurementCallback::ensureBatchBuffer(JNIEnv* env) {
+    if (mBatchBufferGlobal != nullptr) {
+        return true;
+    }
+    const size_t size =
+            sizeof(GnssClockRecord) + kMaxBatchedMeasurements * sizeof(GnssMeasurementRecord);
+    mBatchBuffer = static_cast<uint8_t*>(malloc(size));
+    if (mBatchBuffer == nullptr) {
+        return false;
+    }
+    memset(mBatchBuffer, 0, size);
+    jobject localBuffer = env->NewDirectByteBuffer(mBatchBuffer, size);
+    if (localBuffer == nullptr) {
+        free(mBatchBuffer);
+        mBatchBuffer = nullptr;
+        return false;
+    }
+    mBatchBufferGlobal = env->NewGlobalRef(localBuffer);
+    env->DeleteLocalRef(localBuffer);
+    return mBatchBufferGlobal != nullptr;
+}
+
 template<class T>
 void GnssMeasurementCallback::translateAndSetGnssData(const T& data) {
     JNIEnv* env = getJniEnv();
 
-    JavaObject gnssClockJavaObject(env, class_gnssClock, method_gnssClockCtor);
-    translateGnssClock(gnssClockJavaObject, data);
-    jobject clock = gnssClockJavaObject.get();
+    if (!ensureBatchBuffer(env)) {
+        ALOGE("%s: could not allocate measurement batch buffer", __func__);
+        return;
+    }
 
     size_t count = getMeasurementCount(data);
-    jobjectArray measurementArray = translateAllGnssMeasurements(env, data.measurements.data(), count);
-    setMeasurementData(env, clock, measurementArray);
+    if (count > kMaxBatchedMeasurements) {
+        ALOGD("Too many measurements %zu. Clamps to %zu.", count, kMaxBatchedMeasurements);
+        count = kMaxBatchedMeasurements;
+    }
+
+    GnssClockRecord* clockRecord = reinterpret_cast<GnssClockRecord*>(mBatchBuffer);
+    memset(clockRecord, 0, sizeof(GnssClockRecord));
+    packGnssClock(clockRecord, data);
+
+    GnssMeasurementRecord* records =
+            reinterpret_cast<GnssMeasurementRecord*>(mBatchBuffer + sizeof(GnssClockRecord));
+    for (size_t i = 0; i < count; ++i) {
+        memset(&records[i], 0, sizeof(GnssMeasurementRecord));
+        packSingleGnssMeasurement(&(data.measurements.data()[i]), &records[i]);
+    }
 
-    env->DeleteLocalRef(clock);
-    env->DeleteLocalRef(measurementArray);
+    env->CallVoidMethod(mCallbacksObj, method_reportMeasurementDataBatch, mBatchBufferGlobal,
+                        static_cast<jint>(count));
+    checkAndClearExceptionFromCallback(env, __FUNCTION__);
 }
 
 template<>
@@ -1040,170 +1127,96 @@ size_t GnssMeasurementCallback::getMeasurementCount(const T& data) {
     return data.measurements.size();
 }
 
-// Preallocate object as: JavaObject object(env, "android/location/GnssMeasurement");
 template<>
-void GnssMeasurementCallback::translateSingleGnssMeasurement
+void GnssMeasurementCallback::packSingleGnssMeasurement
         <IGnssMeasurementCallback_V1_0::GnssMeasurement>(
         const IGnssMeasurementCallback_V1_0::GnssMeasurement* measurement,
-        JavaObject& object) {
-    uint32_t flags = static_cast<uint32_t>(measurement->flags);
-
-    SET(Svid, static_cast<int32_t>(measurement->svid));
-    SET(ConstellationType, static_cast<int32_t>(measurement->constellation));
-    SET(TimeOffsetNanos, measurement->timeOffsetNs);
-    SET(State, static_cast<int32_t>(measurement->state));
-    SET(ReceivedSvTimeNanos, measurement->receivedSvTimeInNs);
-    SET(ReceivedSvTimeUncertaintyNanos,
-        measurement->receivedSvTimeUncertaintyInNs);
-    SET(Cn0DbHz, measurement->cN0DbHz);
-    SET(PseudorangeRateMetersPerSecond, measurement->pseudorangeRateMps);
-    SET(PseudorangeRateUncertaintyMetersPerSecond,
-        measurement->pseudorangeRateUncertaintyMps);
-    SET(AccumulatedDeltaRangeState,
-        (static_cast<int32_t>(measurement->accumulatedDeltaRangeState) &
-        ~ADR_STATE_HALF_CYCLE_REPORTED)); // Half Cycle state not reported from Hardware in V1_0
-    SET(AccumulatedDeltaRangeMeters, measurement->accumulatedDeltaRangeM);
-    SET(AccumulatedDeltaRangeUncertaintyMeters,
-        measurement->accumulatedDeltaRangeUncertaintyM);
-
-    if (flags & static_cast<uint32_t>(GnssMeasurementFlags::HAS_CARRIER_FREQUENCY)) {
-        SET(CarrierFrequencyHz, measurement->carrierFrequencyHz);
-    }
+        GnssMeasurementRecord* record) {
+    record->flags = static_cast<jint>(measurement->flags);
+    record->svid = static_cast<int32_t>(measurement->svid);
+    record->constellationType = static_cast<int32_t>(measurement->constellation);
+    record->timeOffsetNanos = measurement->timeOffsetNs;
+    record->state = static_cast<int32_t>(measurement->state);
+    record->receivedSvTimeNanos = measurement->receivedSvTimeInNs;
+    record->receivedSvTimeUncertaintyNanos = measurement->receivedSvTimeUncertaintyInNs;
+    record->cn0DbHz = measurement->cN0DbHz;
+    record->pseudorangeRateMetersPerSecond = measurement->pseudorangeRateMps;
+    record->pseudorangeRateUncertaintyMetersPerSecond = measurement->pseudorangeRateUncertaintyMps;
+    record->accumulatedDeltaRangeState =
+            (static_cast<int32_t>(measurement->accumulatedDeltaRangeState) &
+            ~ADR_STATE_HALF_CYCLE_REPORTED); // Half Cycle state not reported from Hardware in V1_0
+    record->accumulatedDeltaRangeMeters = measurement->accumulatedDeltaRangeM;
+    record->accumulatedDeltaRangeUncertaintyMeters = measurement->accumulatedDeltaRangeUncertaintyM;
+    record->carrierFrequencyHz = measurement->carrierFrequencyHz;
 
     // Intentionally not copying deprecated fields of carrierCycles,
     // carrierPhase, carrierPhaseUncertainty
 
-    SET(MultipathIndicator, static_cast<int32_t>(measurement->multipathIndicator));
-
-    if (flags & static_cast<uint32_t>(GnssMeasurementFlags::HAS_SNR)) {
-        SET(SnrInDb, measurement->snrDb);
-    }
-
-    if (flags & static_cast<uint32_t>(GnssMeasurementFlags::HAS_AUTOMATIC_GAIN_CONTROL)) {
-        SET(AutomaticGainControlLevelInDb, measurement->agcLevelDb);
-    }
+    record->multipathIndicator = static_cast<int32_t>(measurement->multipathIndicator);
+    record->snrInDb = measurement->snrDb;
+    record->automaticGainControlLevelInDb = measurement->agcLevelDb;
 }
 
-// Preallocate object as: JavaObject object(env, "android/location/GnssMeasurement");
 template<>
-void GnssMeasurementCallback::translateSingleGnssMeasurement
+void GnssMeasurementCallback::packSingleGnssMeasurement
         <IGnssMeasurementCallback_V1_1::GnssMeasurement>(
         const IGnssMeasurementCallback_V1_1::GnssMeasurement* measurement_V1_1,
-        JavaObject& object) {
-    translateSingleGnssMeasurement(&(measurement_V1_1->v1_0), object);
+        GnssMeasurementRecord* record) {
+    packSingleGnssMeasurement(&(measurement_V1_1->v1_0), record);
 
     // Set the V1_1 flag, and mark that new field has valid information for Java Layer
-    SET(AccumulatedDeltaRangeState,
+    record->accumulatedDeltaRangeState =
             (static_cast<int32_t>(measurement_V1_1->accumulatedDeltaRangeState) |
-            ADR_STATE_HALF_CYCLE_REPORTED));
+            ADR_STATE_HALF_CYCLE_REPORTED);
 }
 
-// Preallocate object as: JavaObject object(env, "android/location/GnssMeasurement");
 template<>
-void GnssMeasurementCallback::translateSingleGnssMeasurement
+void GnssMeasurementCallback::packSingleGnssMeasurement
         <IGnssMeasurementCallback_V2_0::GnssMeasurement>(
         const IGnssMeasurementCallback_V2_0::GnssMeasurement* measurement_V2_0,
-        JavaObject& object) {
-    JNIEnv* env = getJniEnv();
-    translateSingleGnssMeasurement(&(measurement_V2_0->v1_1), object);
+        GnssMeasurementRecord* record) {
+    packSingleGnssMeasurement(&(measurement_V2_0->v1_1), record);
 
-    SET(CodeType, env->NewStringUTF(measurement_V2_0->codeType.c_str()));
+    strlcpy(record->codeType, measurement_V2_0->codeType.c_str(), sizeof(record->codeType));
 
     // Overwrite with v2_0.state since v2_0->v1_1->v1_0.state is deprecated.
-    SET(State, static_cast<int32_t>(measurement_V2_0->state));
+    record->state = static_cast<int32_t>(measurement_V2_0->state);
 
     // Overwrite with v2_0.constellation since v2_0->v1_1->v1_0.constellation is deprecated.
-    SET(ConstellationType, static_cast<int32_t>(measurement_V2_0->constellation));
+    record->constellationType = static_cast<int32_t>(measurement_V2_0->constellation);
 }
 
 template<class T>
-void GnssMeasurementCallback::translateGnssClock(JavaObject& object, const T& data) {
-    translateGnssClock(object, data.clock);
+void GnssMeasurementCallback::packGnssClock(GnssClockRecord* record, const T& data) {
+    packGnssClock(record, data.clock);
 }
 
 template<>
-void GnssMeasurementCallback::translateGnssClock(
-       JavaObject& object, const IGnssMeasurementCallback_V1_0::GnssClock& clock) {
-    uint32_t flags = static_cast<uint32_t>(clock.gnssClockFlags);
-    if (flags & static_cast<uint32_t>(GnssClockFlags::HAS_LEAP_SECOND)) {
-        SET(LeapSecond, static_cast<int32_t>(clock.leapSecond));
-    }
-
-    if (flags & static_cast<uint32_t>(GnssClockFlags::HAS_TIME_UNCERTAINTY)) {
-        SET(TimeUncertaintyNanos, clock.timeUncertaintyNs);
-    }
-
-    if (flags & static_cast<uint32_t>(GnssClockFlags::HAS_FULL_BIAS)) {
-        SET(FullBiasNanos, clock.fullBiasNs);
-    }
-
-    if (flags & static_cast<uint32_t>(GnssClockFlags::HAS_BIAS)) {
-        SET(BiasNanos, clock.biasNs);
-    }
-
-    if (flags & static_cast<uint32_t>(GnssClockFlags::HAS_BIAS_UNCERTAINTY)) {
-        SET(BiasUncertaintyNanos, clock.biasUncertaintyNs);
-    }
-
-    if (flags & static_cast<uint32_t>(GnssClockFlags::HAS_DRIFT)) {
-        SET(DriftNanosPerSecond, clock.driftNsps);
-    }
-
-    if (flags & static_cast<uint32_t>(GnssClockFlags::HAS_DRIFT_UNCERTAINTY)) {
-        SET(DriftUncertaintyNanosPerSecond, clock.driftUncertaintyNsps);
-    }
-
-    SET(TimeNanos, clock.timeNs);
-    SET(HardwareClockDiscontinuityCount, clock.hwClockDiscontinuityCount);
+void GnssMeasurementCallback::packGnssClock(
+       GnssClockRecord* record, const IGnssMeasurementCallback_V1_0::GnssClock& clock) {
+    // Fields without their flag bit set are left zeroed; the Java side
+    // consults the flags before reading them.
+    record->flags = static_cast<jint>(clock.gnssClockFlags);
+    record->leapSecond = static_cast<int32_t>(clock.leapSecond);
+    record->timeUncertaintyNanos = clock.timeUncertaintyNs;
+    record->fullBiasNanos = clock.fullBiasNs;
+    record->biasNanos = clock.biasNs;
+    record->biasUncertaintyNanos = clock.biasUncertaintyNs;
+    record->driftNanosPerSecond = clock.driftNsps;
+    record->driftUncertaintyNanosPerSecond = clock.driftUncertaintyNsps;
+    record->timeNanos = clock.timeNs;
+    record->hardwareClockDiscontinuityCount = clock.hwClockDiscontinuityCount;
 }
 
 template<>
-void GnssMeasurementCallback::translateGnssClock(
-       JavaObject& object, const IGnssMeasurementCallback_V2_0::GnssData& data) {
+void GnssMeasurementCallback::packGnssClock(
+       GnssClockRecord* record, const IGnssMeasurementCallback_V2_0::GnssData& data) {
     auto elapsedRealtime = data.elapsedRealtime;
-    uint16_t flags = static_cast<uint16_t>(elapsedRealtime.flags);
-    if (flags & ElapsedRealtimeFlags::HAS_TIMESTAMP_NS) {
-        SET(ElapsedRealtimeNanos, static_cast<uint64_t>(elapsedRealtime.timestampNs));
-    }
-    if (flags & ElapsedRealtimeFlags::HAS_TIME_UNCERTAINTY_NS) {
-        SET(ElapsedRealtimeUncertaintyNanos, static_cast<double>(elapsedRealtime.timeUncertaintyNs));
-    }
-    translateGnssClock(object, data.clock);
-}
-
-template<class T>
-jobjectArray GnssMeasurementCallback::translateAllGnssMeasurements(JNIEnv* env,
-        const T* measurements,
-        size_t count) {
-    if (count == 0) {
-        return nullptr;
-    }
-
-    jobjectArray gnssMeasurementArray = env->NewObjectArray(
-            count,
-            class_gnssMeasurement,
-            nullptr /* initialElement */);
-
-    for (uint16_t i = 0; i < count; ++i) {
-        JavaObject object(env, class_gnssMeasurement, method_gnssMeasurementCtor);
-        translateSingleGnssMeasurement(&(measurements[i]), object);
-        env->SetObjectArrayElement(gnssMeasurementArray, i, object.get());
-    }
-
-    return gnssMeasurementArray;
-}
-
-void GnssMeasurementCallback::setMeasurementData(JNIEnv* env, jobject clock,
-                             jobjectArray measurementArray) {
-    jobject gnssMeasurementsEvent = env->NewObject(class_gnssMeasurementsEvent,
-                                                   method_gnssMeasurementsEventCtor,
-                                                   clock,
-                                                   measurementArray);
-
-    env->CallVoidMethod(mCallbacksObj, method_reportMeasurementData,
-                      gnssMeasurementsEvent);
-    checkAndClearExceptionFromCallback(env, __FUNCTION__);
-    env->DeleteLocalRef(gnssMeasurementsEvent);
+    record->elapsedRealtimeFlags = static_cast<jint>(elapsedRealtime.flags);
+    record->elapsedRealtimeNanos = static_cast<uint64_t>(elapsedRealtime.timestampNs);
+    record->elapsedRealtimeUncertaintyNanos =
+            static_cast<double>(elapsedRealtime.timeUncertaintyNs);
+    packGnssClock(record, data.clock);
 }
 
 /*
@@ -1550,10 +1563,10 @@ static void android_location_GnssLocationProvider_class_init_native(JNIEnv* env,
             "(II)V");
     method_reportGeofencePauseStatus = env->GetMethodID(clazz, "reportGeofencePauseStatus",
             "(II)V");
-    method_reportMeasurementData = env->GetMethodID(
+    method_reportMeasurementDataBatch = env->GetMethodID(
             clazz,
-            "reportMeasurementData",
-            "(Landroid/location/GnssMeasurementsEvent;)V");
+            "reportMeasurementDataBatch",
+            "(Ljava/nio/ByteBuffer;I)V");
     method_reportNavigationMessages = env->GetMethodID(
             clazz,
             "reportNavigationMessage",
@@ -1615,17 +1628,6 @@ static void android_location_GnssLocationProvider_class_init_native(JNIEnv* env,
     method_correctionPlaneAltDeg = env->GetMethodID(refPlaneClass, "getAltitudeMeters", "()D");
     method_correctionPlaneAzimDeg = env->GetMethodID(refPlaneClass, "getAzimuthDegrees", "()D");
 
-    jclass gnssMeasurementsEventClass = env->FindClass("android/location/GnssMeasurementsEvent");
-    class_gnssMeasurementsEvent= (jclass) env->NewGlobalRef(gnssMeasurementsEventClass);
-    method_gnssMeasurementsEventCtor = env->GetMethodID(
-                    class_gnssMeasurementsEvent,
-                    "<init>",
-                    "(Landroid/location/GnssClock;[Landroid/location/GnssMeasurement;)V");
-
-    jclass gnssMeasurementClass = env->FindClass("android/location/GnssMeasurement");
-    class_gnssMeasurement = (jclass) env->NewGlobalRef(gnssMeasurementClass);
-    method_gnssMeasurementCtor = env->GetMethodID(class_gnssMeasurement, "<init>", "()V");
-
     jclass locationClass = env->FindClass("android/location/Location");
     class_location = (jclass) env->NewGlobalRef(locationClass);
     method_locationCtor = env->GetMethodID(class_location, "<init>", "(Ljava/lang/String;)V");
@@ -1634,10 +1636,6 @@ static void android_location_GnssLocationProvider_class_init_native(JNIEnv* env,
     class_gnssNavigationMessage = (jclass) env->NewGlobalRef(gnssNavigationMessageClass);
     method_gnssNavigationMessageCtor = env->GetMethodID(class_gnssNavigationMessage, "<init>", "()V");
 
-    jclass gnssClockClass = env->FindClass("android/location/GnssClock");
-    class_gnssClock = (jclass) env->NewGlobalRef(gnssClockClass);
-    method_gnssClockCtor = env->GetMethodID(class_gnssClock, "<init>", "()V");
-
     jclass gnssConfiguration_halInterfaceVersionClass =
             env->FindClass("com/android/server/location/GnssConfiguration$HalInterfaceVersion");
     class_gnssConfiguration_halInterfaceVersion =
@@ -18,9 +18,14 @@
 
 #include <errno.h>
 #include <inttypes.h>
+#include <stdlib.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <jni.h>
 
 #include <nativehelper/JNIHelp.h>
@@ -92,6 +97,19 @@ static jlongArray get_long_array(JNIEnv* env, jobject obj, jfieldID field, int s
     return env->NewLongArray(size);
 }
 
+// Parses one decimal field and advances *pos past it. Returns false if no
+// digits were consumed.
+static bool parseU64(char** pos, uint64_t* out) {
+    char* endPos;
+    uint64_t value = strtoull(*pos, &endPos, 10);
+    if (endPos == *pos) {
+        return false;
+    }
+    *pos = endPos;
+    *out = value;
+    return true;
+}
+
 static int legacyReadNetworkStatsDetail(std::vector<stats_line>* lines,
                                         const std::vector<std::string>& limitIfaces,
                                         int limitTag, int limitUid, const char* path) {
@@ -167,7 +185,9 @@ static int legacyReadNetworkStatsDetail(std::vector<stats_line>* lines,
         if (endPos - pos == 3) {
             rawTag = 0;
         } else {
-            if (sscanf(pos, "%" PRIx64, &rawTag) != 1) {
+            char* tagEnd;
+            rawTag = strtoull(pos, &tagEnd, 16);
+            if (tagEnd == pos) {
                 ALOGE("bad tag: %s", pos);
                 fclose(fp);
                 return -1;
@@ -183,10 +203,15 @@ static int legacyReadNetworkStatsDetail(std::vector<stats_line>* lines,
         // Ignore whitespace
         while (*pos == ' ') pos++;
 
-        // Parse remaining fields.
-        if (sscanf(pos, "%u %u %" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64,
-                &s.uid, &s.set, &s.rxBytes, &s.rxPackets,
-                &s.txBytes, &s.txPackets) == 6) {
+        // Parse remaining fields with strtoull directly; sscanf re-interprets
+        // its format string on every line, which dominates the scan on large
+        // per-uid snapshots.
+        uint64_t uid, set;
+        if (parseU64(&pos, &uid) && parseU64(&pos, &set) &&
+                parseU64(&pos, &s.rxBytes) && parseU64(&pos, &s.rxPackets) &&
+                parseU64(&pos, &s.txBytes) && parseU64(&pos, &s.txPackets)) {
+            s.uid = uid;
+            s.set = set;
             if (limitUid != -1 && static_cast<uint32_t>(limitUid) != s.uid) {
                 //ALOGI("skipping due to uid: %s", buffer);
                 continue;
@@ -247,9 +272,24 @@ static int statsLinesToNetworkStats(JNIEnv* env, jclass clazz, jobject stats,
             gNetworkStatsClassInfo.operations, size, grow));
     if (operations.get() == NULL) return -1;
 
+    // A detail snapshot has one row per uid/set/tag but only a handful of
+    // distinct interfaces, so intern one Java string per interface instead of
+    // allocating one per row.
+    std::vector<std::pair<std::string, jstring>> ifaceCache;
     for (int i = 0; i < size; i++) {
-        ScopedLocalRef<jstring> ifaceString(env, env->NewStringUTF(lines[i].iface));
-        env->SetObjectArrayElement(iface.get(), i, ifaceString.get());
+        jstring ifaceString = NULL;
+        for (const auto& cached : ifaceCache) {
+            if (cached.first == lines[i].iface) {
+                ifaceString = cached.second;
+                break;
+            }
+        }
+        if (ifaceString == NULL) {
+            ifaceString = env->NewStringUTF(lines[i].iface);
+            if (ifaceString == NULL) return -1;
+            ifaceCache.push_back(std::make_pair(std::string(lines[i].iface), ifaceString));
+        }
+        env->SetObjectArrayElement(iface.get(), i, ifaceString);
 
         uid[i] = lines[i].uid;
         set[i] = lines[i].set;
@@ -260,6 +300,9 @@ static int statsLinesToNetworkStats(JNIEnv* env, jclass clazz, jobject stats,
         txBytes[i] = lines[i].txBytes;
         txPackets[i] = lines[i].txPackets;
     }
+    for (const auto& cached : ifaceCache) {
+        env->DeleteLocalRef(cached.second);
+    }
 
     env->SetIntField(stats, gNetworkStatsClassInfo.size, size);
     if (grow) {
@@ -29,6 +29,13 @@
 
 #include <limits.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <android-base/chrono_utils.h>
 #include <android_runtime/AndroidRuntime.h>
 #include <android_runtime/Log.h>
@@ -79,8 +86,12 @@ static bool gLineagePowerHalExists = true;
 static std::mutex gPowerHalMutex;
 static nsecs_t gLastEventTime[USER_ACTIVITY_EVENT_LAST + 1];
 
-// Throttling interval for user activity calls.
-static const nsecs_t MIN_TIME_BETWEEN_USERACTIVITIES = 100 * 1000000L; // 100ms
+// Coalescing window for user activity calls; calls of the same event type inside
+// the window collapse into the first one. Configurable from the Java side.
+static std::atomic<nsecs_t> gUserActivityCoalesceIntervalNs(100 * 1000000L); // 100ms
+
+// Number of user activity calls swallowed by the window above.
+static std::atomic<uint64_t> gSuppressedUserActivityCount(0);
 
 // ----------------------------------------------------------------------------
 
@@ -191,7 +202,9 @@ void android_server_PowerManagerService_userActivity(nsecs_t eventTime, int32_t
                 eventTime = now;
             }
 
-            if (gLastEventTime[eventType] + MIN_TIME_BETWEEN_USERACTIVITIES > eventTime) {
+            if (gLastEventTime[eventType] +
+                    gUserActivityCoalesceIntervalNs.load(std::memory_order_relaxed) > eventTime) {
+                gSuppressedUserActivityCount.fetch_add(1, std::memory_order_relaxed);
                 return;
             }
             gLastEventTime[eventType] = eventTime;
@@ -291,14 +304,105 @@ static void nativeInit(JNIEnv* env, jobject obj) {
     gPowerHalMutex.unlock();
 }
 
+// Suspend blocker releases are held back for a short window so that a
+// re-acquire of the same blocker cancels against the pending release and
+// neither transition reaches the kernel. The frequently toggled blockers
+// (wake lock and broadcast churn) bounce within milliseconds.
+struct PendingBlockerRelease {
+    std::string name;
+    nsecs_t deadline;
+};
+
+static std::mutex gSuspendBlockerMutex;
+static std::condition_variable gSuspendBlockerCv;
+static std::vector<PendingBlockerRelease> gPendingBlockerReleases;
+static std::atomic<nsecs_t> gSuspendBlockerCoalesceWindowNs(50 * 1000000L); // 50ms
+static std::atomic<uint64_t> gSuppressedBlockerTransitionCount(0);
+
+static void suspendBlockerFlushThreadLoop() {
+    std::unique_lock<std::mutex> lock(gSuspendBlockerMutex);
+    while (true) {
+        if (gPendingBlockerReleases.empty()) {
+            gSuspendBlockerCv.wait(lock);
+            continue;
+        }
+        nsecs_t earliest = gPendingBlockerReleases[0].deadline;
+        for (const auto& pending : gPendingBlockerReleases) {
+            if (pending.deadline < earliest) {
+                earliest = pending.deadline;
+            }
+        }
+        nsecs_t now = systemTime(SYSTEM_TIME_MONOTONIC);
+        if (earliest > now) {
+            gSuspendBlockerCv.wait_for(lock, std::chrono::nanoseconds(earliest - now));
+            continue;
+        }
+        // The kernel release happens under gSuspendBlockerMutex: once an entry
+        // leaves the pending list a concurrent nativeAcquireSuspendBlocker can
+        // no longer cancel it, so releasing after dropping the lock could undo
+        // an acquire_wake_lock that raced in between. The sysfs write is cheap
+        // enough to hold the mutex across.
+        for (auto it = gPendingBlockerReleases.begin(); it != gPendingBlockerReleases.end();) {
+            if (it->deadline <= now) {
+                release_wake_lock(it->name.c_str());
+                it = gPendingBlockerReleases.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+// Releases every pending blocker immediately, regardless of deadline.
+static void flushPendingBlockerReleases() {
+    // Held across release_wake_lock for the same reason as the flush thread:
+    // an entry must not leave the list before its kernel release lands.
+    std::lock_guard<std::mutex> lock(gSuspendBlockerMutex);
+    for (const auto& pending : gPendingBlockerReleases) {
+        release_wake_lock(pending.name.c_str());
+    }
+    gPendingBlockerReleases.clear();
+}
+
+static void ensureSuspendBlockerFlushThread() {
+    static std::once_flag flushThreadFlag;
+    std::call_once(flushThreadFlag, []() {
+        std::thread(suspendBlockerFlushThreadLoop).detach();
+    });
+}
+
 static void nativeAcquireSuspendBlocker(JNIEnv *env, jclass /* clazz */, jstring nameStr) {
     ScopedUtfChars name(env, nameStr);
+    {
+        std::lock_guard<std::mutex> lock(gSuspendBlockerMutex);
+        for (auto it = gPendingBlockerReleases.begin();
+                it != gPendingBlockerReleases.end(); ++it) {
+            if (it->name == name.c_str()) {
+                // The kernel still holds this blocker; cancelling the pending
+                // release makes both transitions disappear.
+                gPendingBlockerReleases.erase(it);
+                gSuppressedBlockerTransitionCount.fetch_add(2, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
     acquire_wake_lock(PARTIAL_WAKE_LOCK, name.c_str());
 }
 
 static void nativeReleaseSuspendBlocker(JNIEnv *env, jclass /* clazz */, jstring nameStr) {
     ScopedUtfChars name(env, nameStr);
-    release_wake_lock(name.c_str());
+    nsecs_t window = gSuspendBlockerCoalesceWindowNs.load(std::memory_order_relaxed);
+    if (window <= 0) {
+        release_wake_lock(name.c_str());
+        return;
+    }
+    ensureSuspendBlockerFlushThread();
+    {
+        std::lock_guard<std::mutex> lock(gSuspendBlockerMutex);
+        gPendingBlockerReleases.push_back(
+                {name.c_str(), systemTime(SYSTEM_TIME_MONOTONIC) + window});
+    }
+    gSuspendBlockerCv.notify_one();
 }
 
 static void nativeSetInteractive(JNIEnv* /* env */, jclass /* clazz */, jboolean enable) {
@@ -343,11 +447,36 @@ static void nativeSetFeature(JNIEnv* /* env */, jclass /* clazz */, jint feature
 }
 
 static bool nativeForceSuspend(JNIEnv* /* env */, jclass /* clazz */) {
+    // A blocker whose release is still pending would abort the forced suspend.
+    flushPendingBlockerReleases();
     bool retval = false;
     getSuspendControl()->forceSuspend(&retval);
     return retval;
 }
 
+static void nativeSetUserActivityCoalesceMillis(JNIEnv* /* env */, jclass /* clazz */,
+        jlong millis) {
+    gUserActivityCoalesceIntervalNs.store(milliseconds_to_nanoseconds(millis),
+            std::memory_order_relaxed);
+}
+
+static void nativeSetSuspendBlockerCoalesceMillis(JNIEnv* /* env */, jclass /* clazz */,
+        jlong millis) {
+    gSuspendBlockerCoalesceWindowNs.store(milliseconds_to_nanoseconds(millis),
+            std::memory_order_relaxed);
+    if (millis <= 0) {
+        flushPendingBlockerReleases();
+    }
+}
+
+static jlong nativeGetSuppressedUserActivityCount(JNIEnv* /* env */, jclass /* clazz */) {
+    return static_cast<jlong>(gSuppressedUserActivityCount.load(std::memory_order_relaxed));
+}
+
+static jlong nativeGetSuppressedSuspendBlockerCount(JNIEnv* /* env */, jclass /* clazz */) {
+    return static_cast<jlong>(gSuppressedBlockerTransitionCount.load(std::memory_order_relaxed));
+}
+
 // ----------------------------------------------------------------------------
 
 static const JNINativeMethod gPowerManagerServiceMethods[] = {
@@ -370,6 +499,14 @@ static const JNINativeMethod gPowerManagerServiceMethods[] = {
             (void*) nativeSetFeature },
     { "nativeGetFeature", "(I)I",
             (void*) nativeGetFeature },
+    { "nativeSetUserActivityCoalesceMillis", "(J)V",
+            (void*) nativeSetUserActivityCoalesceMillis },
+    { "nativeSetSuspendBlockerCoalesceMillis", "(J)V",
+            (void*) nativeSetSuspendBlockerCoalesceMillis },
+    { "nativeGetSuppressedUserActivityCount", "()J",
+            (void*) nativeGetSuppressedUserActivityCount },
+    { "nativeGetSuppressedSuspendBlockerCount", "()J",
+            (void*) nativeGetSuppressedSuspendBlockerCount },
 };
 
 #define FIND_CLASS(var, className) \
@@ -24,8 +24,12 @@
 #include "androidfw/AssetManager2.h"
 #include "androidfw/ResourceTypes.h"
 
+#include <atomic>
 #include <iostream>
 #include <locale>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include "android-base/stringprintf.h"
 
@@ -80,6 +84,58 @@ bool CanCompileLayout(ResXMLParser* parser) {
 }
 
 namespace {
+// 64-bit FNV-1a, used to fingerprint layout inputs. Not cryptographic, but
+// collisions only cost a stale compile being reused and the inputs are small.
+constexpr uint64_t kFingerprintOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kFingerprintPrime = 0x100000001b3ull;
+
+uint64_t FingerprintBytes(uint64_t hash, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ bytes[i]) * kFingerprintPrime;
+  }
+  return hash;
+}
+
+// A layout opened from the APK, ready to be validated and compiled. Each
+// candidate owns its own copy of the XML data, so candidates can be parsed
+// independently on different threads.
+struct LayoutCandidate {
+  std::string path;
+  std::unique_ptr<android::Asset> asset;
+  std::unique_ptr<android::ResXMLTree> xml_tree;
+  bool can_compile = false;
+};
+
+// Runs the validation parse over every candidate, spread across a small pool
+// of threads. Validation reads only the candidate's own ResXMLTree, so
+// layouts are independent here; it is the code generation into the shared
+// DexBuilder that has to stay sequential.
+void ValidateLayoutCandidates(std::vector<LayoutCandidate>* candidates) {
+  std::atomic<size_t> next_candidate{0};
+  const auto worker = [&]() {
+    for (size_t i = next_candidate++; i < candidates->size(); i = next_candidate++) {
+      LayoutCandidate& candidate = (*candidates)[i];
+      android::ResXMLParser parser{*candidate.xml_tree};
+      parser.restart();
+      candidate.can_compile = CanCompileLayout(&parser);
+    }
+  };
+
+  size_t num_workers = std::min<size_t>(std::thread::hardware_concurrency(), candidates->size());
+  if (num_workers <= 1) {
+    worker();
+    return;
+  }
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers.emplace_back(worker);
+  }
+  for (auto& thread : workers) {
+    thread.join();
+  }
+}
+
 void CompileApkAssetsLayouts(const std::unique_ptr<const android::ApkAssets>& assets,
                              CompilationTarget target, std::ostream& target_out) {
   android::AssetManager2 resources;
@@ -95,11 +151,10 @@ void CompileApkAssetsLayouts(const std::unique_ptr<const android::ApkAssets>& as
     first = false;
   }
 
-  dex::DexBuilder dex_file;
-  dex::ClassBuilder compiled_view{
-      dex_file.MakeClass(StringPrintf("%s.CompiledView", package_name.c_str()))};
-  std::vector<dex::MethodBuilder> methods;
-
+  // First gather all of the layouts from the APK. The AssetManager is not
+  // shared across threads, so the assets are opened here and only the
+  // already-copied XML trees are handed to the validation workers.
+  std::vector<LayoutCandidate> candidates;
   assets->ForEachFile("res/", [&](const android::StringPiece& s, android::FileType) {
     if (s == "layout") {
       auto path = StringPrintf("res/%s/", s.to_string().c_str());
@@ -111,45 +166,57 @@ void CompileApkAssetsLayouts(const std::unique_ptr<const android::ApkAssets>& as
         CHECK(android::kInvalidCookie != cookie);
         const auto dynamic_ref_table = resources.GetDynamicRefTableForCookie(cookie);
         CHECK(nullptr != dynamic_ref_table);
-        android::ResXMLTree xml_tree{dynamic_ref_table};
-        xml_tree.setTo(asset->getBuffer(/*wordAligned=*/true),
-                       asset->getLength(),
-                       /*copy_data=*/true);
-        android::ResXMLParser parser{xml_tree};
-        parser.restart();
-        if (CanCompileLayout(&parser)) {
-          parser.restart();
-          const std::string layout_name = startop::util::FindLayoutNameFromFilename(layout_path);
-          ResXmlVisitorAdapter adapter{&parser};
-          switch (target) {
-            case CompilationTarget::kDex: {
-              methods.push_back(compiled_view.CreateMethod(
-                  layout_name,
-                  dex::Prototype{dex::TypeDescriptor::FromClassname("android.view.View"),
-                                 dex::TypeDescriptor::FromClassname("android.content.Context"),
-                                 dex::TypeDescriptor::Int()}));
-              DexViewBuilder builder(&methods.back());
-              builder.Start();
-              LayoutCompilerVisitor visitor{&builder};
-              adapter.Accept(&visitor);
-              builder.Finish();
-              methods.back().Encode();
-              break;
-            }
-            case CompilationTarget::kJavaLanguage: {
-              JavaLangViewBuilder builder{package_name, layout_name, target_out};
-              builder.Start();
-              LayoutCompilerVisitor visitor{&builder};
-              adapter.Accept(&visitor);
-              builder.Finish();
-              break;
-            }
-          }
-        }
+        auto xml_tree = std::make_unique<android::ResXMLTree>(dynamic_ref_table);
+        xml_tree->setTo(asset->getBuffer(/*wordAligned=*/true),
+                        asset->getLength(),
+                        /*copy_data=*/true);
+        candidates.push_back(
+            LayoutCandidate{std::move(layout_path), std::move(asset), std::move(xml_tree)});
       });
     }
   });
 
+  ValidateLayoutCandidates(&candidates);
+
+  dex::DexBuilder dex_file;
+  dex::ClassBuilder compiled_view{
+      dex_file.MakeClass(StringPrintf("%s.CompiledView", package_name.c_str()))};
+  std::vector<dex::MethodBuilder> methods;
+
+  for (const LayoutCandidate& candidate : candidates) {
+    if (!candidate.can_compile) {
+      continue;
+    }
+    android::ResXMLParser parser{*candidate.xml_tree};
+    parser.restart();
+    const std::string layout_name = startop::util::FindLayoutNameFromFilename(candidate.path);
+    ResXmlVisitorAdapter adapter{&parser};
+    switch (target) {
+      case CompilationTarget::kDex: {
+        methods.push_back(compiled_view.CreateMethod(
+            layout_name,
+            dex::Prototype{dex::TypeDescriptor::FromClassname("android.view.View"),
+                           dex::TypeDescriptor::FromClassname("android.content.Context"),
+                           dex::TypeDescriptor::Int()}));
+        DexViewBuilder builder(&methods.back());
+        builder.Start();
+        LayoutCompilerVisitor visitor{&builder};
+        adapter.Accept(&visitor);
+        builder.Finish();
+        methods.back().Encode();
+        break;
+      }
+      case CompilationTarget::kJavaLanguage: {
+        JavaLangViewBuilder builder{package_name, layout_name, target_out};
+        builder.Start();
+        LayoutCompilerVisitor visitor{&builder};
+        adapter.Accept(&visitor);
+        builder.Finish();
+        break;
+      }
+    }
+  }
+
   if (target == CompilationTarget::kDex) {
     slicer::MemView image{dex_file.CreateImage()};
     target_out.write(image.ptr<const char>(), image.size());
@@ -171,4 +238,30 @@ void CompileApkLayoutsFd(android::base::unique_fd fd, CompilationTarget target,
   CompileApkAssetsLayouts(assets, target, target_out);
 }
 
+uint64_t FingerprintApkLayouts(const std::string& filename) {
+  auto assets = android::ApkAssets::Load(filename);
+  android::AssetManager2 resources;
+  resources.SetApkAssets({assets.get()});
+
+  uint64_t hash = kFingerprintOffsetBasis;
+  assets->ForEachFile("res/", [&](const android::StringPiece& s, android::FileType) {
+    if (s == "layout") {
+      auto path = StringPrintf("res/%s/", s.to_string().c_str());
+      assets->ForEachFile(path, [&](const android::StringPiece& layout_file, android::FileType) {
+        auto layout_path = StringPrintf("%s%s", path.c_str(), layout_file.to_string().c_str());
+        auto asset = resources.OpenNonAsset(layout_path, android::Asset::ACCESS_BUFFER);
+        if (!asset) {
+          return;
+        }
+        // Hash the path too, so renaming a layout changes the fingerprint
+        // even if its contents match another one.
+        hash = FingerprintBytes(hash, layout_path.data(), layout_path.size());
+        hash = FingerprintBytes(hash, asset->getBuffer(/*wordAligned=*/false),
+                                asset->getLength());
+      });
+    }
+  });
+  return hash;
+}
+
 }  // namespace startop
@@ -17,6 +17,7 @@
 #ifndef APK_LAYOUT_COMPILER_H_
 #define APK_LAYOUT_COMPILER_H_
 
+#include <cstdint>
 #include <string>
 
 #include "android-base/unique_fd.h"
@@ -30,6 +31,12 @@ void CompileApkLayouts(const std::string& filename, CompilationTarget target,
 void CompileApkLayoutsFd(android::base::unique_fd fd, CompilationTarget target,
                          std::ostream& target_out);
 
+// Computes a fingerprint over the compiled XML bytes of every res/layout file
+// in the APK. Two APKs with identical layout inputs produce the same
+// fingerprint, so callers can skip recompilation when it matches the one
+// recorded for an existing output.
+uint64_t FingerprintApkLayouts(const std::string& filename);
+
 }  // namespace startop
 
 #endif  // APK_LAYOUT_COMPILER_H_
\ No newline at end of file
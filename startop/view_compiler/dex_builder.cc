@@ -217,16 +217,15 @@ ClassBuilder DexBuilder::MakeClass(const std::string& name) {
 }
 
 ir::Type* DexBuilder::GetOrAddType(const std::string& descriptor) {
-  if (types_by_descriptor_.find(descriptor) != types_by_descriptor_.end()) {
-    return types_by_descriptor_[descriptor];
-  }
+  ir::Type*& entry = types_by_descriptor_[descriptor];
 
-  ir::Type* type = Alloc<ir::Type>();
-  type->descriptor = GetOrAddString(descriptor);
-  types_by_descriptor_[descriptor] = type;
-  type->orig_index = dex_file_->types_indexes.AllocateIndex();
-  dex_file_->types_map[type->orig_index] = type;
-  return type;
+  if (entry == nullptr) {
+    entry = Alloc<ir::Type>();
+    entry->descriptor = GetOrAddString(descriptor);
+    entry->orig_index = dex_file_->types_indexes.AllocateIndex();
+    dex_file_->types_map[entry->orig_index] = entry;
+  }
+  return entry;
 }
 
 ir::Proto* Prototype::Encode(DexBuilder* dex) const {
@@ -578,16 +577,16 @@ const MethodDeclData& DexBuilder::GetOrDeclareMethod(TypeDescriptor type, const
     decl->orig_index = decl->index = new_index;
 
     entry = {id, decl};
+    prototypes_by_method_id_.emplace(id, prototype);
   }
 
   return entry;
 }
 
 std::optional<const Prototype> DexBuilder::GetPrototypeByMethodId(size_t method_id) const {
-  for (const auto& entry : method_id_map_) {
-    if (entry.second.id == method_id) {
-      return entry.first.prototype;
-    }
+  auto found = prototypes_by_method_id_.find(method_id);
+  if (found != prototypes_by_method_id_.end()) {
+    return found->second;
   }
   return {};
 }
@@ -21,6 +21,7 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
@@ -98,8 +99,9 @@ class Prototype {
   const TypeDescriptor& ArgType(size_t index) const;
 
   bool operator<(const Prototype& rhs) const {
-    return std::make_tuple(return_type_, param_types_) <
-           std::make_tuple(rhs.return_type_, rhs.param_types_);
+    // Compare through references; building tuples of values would deep-copy
+    // the descriptor strings on every map lookup.
+    return std::tie(return_type_, param_types_) < std::tie(rhs.return_type_, rhs.param_types_);
   }
 
  private:
@@ -511,8 +513,7 @@ class DexBuilder {
     Prototype prototype;
 
     inline bool operator<(const MethodDescriptor& rhs) const {
-      return std::make_tuple(type, name, prototype) <
-             std::make_tuple(rhs.type, rhs.name, rhs.prototype);
+      return std::tie(type, name, prototype) < std::tie(rhs.type, rhs.name, rhs.prototype);
     }
   };
 
@@ -521,6 +522,10 @@ class DexBuilder {
   // the methods list.
   std::map<MethodDescriptor, MethodDeclData> method_id_map_;
 
+  // Maps method ids back to their prototypes, so EncodeInvoke can find argument
+  // types without scanning method_id_map_.
+  std::unordered_map<size_t, Prototype> prototypes_by_method_id_;
+
   // Keep track of what strings we've defined so we can look them up later.
   std::unordered_map<std::string, ir::String*> strings_;
 
@@ -112,6 +112,29 @@ int main(int argc, char** argv) {
 
   const bool is_stdout = FLAGS_out == kStdoutFilename;
 
+  // When compiling an APK to a file, a fingerprint of the layout inputs is
+  // recorded next to the output. If it still matches, the existing output is
+  // already up to date and an APK update that left the layouts alone only
+  // costs the hash pass. This is checked before the output file is opened,
+  // since opening would truncate it.
+  uint64_t layout_fingerprint = 0;
+  bool use_fingerprint = false;
+  string fingerprint_filename;
+  if (FLAGS_apk && !is_stdout && FLAGS_infd < 0 && argc > kFileNameParam) {
+    layout_fingerprint = startop::FingerprintApkLayouts(argv[kFileNameParam]);
+    // The output format is part of the output's identity.
+    layout_fingerprint ^= FLAGS_dex ? 1 : 0;
+    use_fingerprint = true;
+    fingerprint_filename = FLAGS_out + ".fingerprint";
+
+    uint64_t recorded = 0;
+    std::ifstream recorded_file{fingerprint_filename};
+    if (recorded_file >> std::hex >> recorded && recorded == layout_fingerprint &&
+        std::ifstream{FLAGS_out}.good()) {
+      return 0;
+    }
+  }
+
   std::ofstream outfile;
   if (!is_stdout) {
     outfile.open(FLAGS_out);
@@ -131,6 +154,10 @@ int main(int argc, char** argv) {
       const char* const filename = argv[kFileNameParam];
       startop::CompileApkLayouts(filename, target, is_stdout ? std::cout : outfile);
     }
+    if (use_fingerprint) {
+      std::ofstream fingerprint_file{fingerprint_filename};
+      fingerprint_file << std::hex << layout_fingerprint << std::endl;
+    }
     return 0;
   }
 
@@ -56,6 +56,26 @@ static bool validateFileName(const char* fileName)
     return true;
 }
 
+/*
+ * Returns the file type recorded in the directory entry, or kFileTypeUnknown
+ * when the entry does not carry a definitive type (symlinks, or filesystems
+ * without d_type support) and the caller must fall back to stat().
+ */
+static FileType fileTypeFromDirent(const struct dirent* entry)
+{
+#if defined(DT_UNKNOWN)
+    if (entry->d_type == DT_REG) {
+        return kFileTypeRegular;
+    }
+    if (entry->d_type == DT_DIR) {
+        return kFileTypeDirectory;
+    }
+#else
+    (void)entry;
+#endif
+    return kFileTypeUnknown;
+}
+
 // The default to use if no other ignore pattern is defined.
 const char * const gDefaultIgnoreAssets =
     "!.svn:!.git:!.ds_store:!*.scc:.*:<dir>_*:!CVS:!thumbs.db:!picasa.ini:!*~";
@@ -659,6 +679,7 @@ ssize_t AaptDir::slurpFullTree(Bundle* bundle, const String8& srcDir,
                             sp<FilePathStore>& fullResPaths, const bool overwrite)
 {
     Vector<String8> fileNames;
+    Vector<FileType> fileTypes;
     {
         DIR* dir = NULL;
 
@@ -683,6 +704,9 @@ ssize_t AaptDir::slurpFullTree(Bundle* bundle, const String8& srcDir,
 
             String8 name(entry->d_name);
             fileNames.add(name);
+            // Remember the type the directory stream reported so we can skip
+            // the stat() per entry below.
+            fileTypes.add(fileTypeFromDirent(entry));
             // Add fully qualified path for dependency purposes
             // if we're collecting them
             if (fullResPaths != NULL) {
@@ -704,7 +728,10 @@ ssize_t AaptDir::slurpFullTree(Bundle* bundle, const String8& srcDir,
         FileType type;
 
         pathName.appendPath(fileNames[i].string());
-        type = getFileType(pathName.string());
+        type = fileTypes[i];
+        if (type == kFileTypeUnknown) {
+            type = getFileType(pathName.string());
+        }
         if (type == kFileTypeDirectory) {
             sp<AaptDir> subdir;
             bool notAdded = false;
@@ -1178,7 +1205,10 @@ ssize_t AaptAssets::slurpResourceTree(Bundle* bundle, const String8& srcDir)
             }
         }
 
-        FileType type = getFileType(subdirName.string());
+        FileType type = fileTypeFromDirent(entry);
+        if (type == kFileTypeUnknown) {
+            type = getFileType(subdirName.string());
+        }
 
         if (type == kFileTypeDirectory) {
             sp<AaptDir> dir = makeDir(resType);
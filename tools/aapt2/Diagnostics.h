@@ -20,6 +20,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "android-base/macros.h"
 #include "androidfw/StringPiece.h"
@@ -150,6 +152,29 @@ class SourcePathDiagnostics : public IDiagnostics {
   DISALLOW_COPY_AND_ASSIGN(SourcePathDiagnostics);
 };
 
+// Records messages so a worker thread can emit diagnostics without interleaving with other
+// workers; the owner replays them in a deterministic order once the parallel phase is done.
+class BatchedDiagnostics : public IDiagnostics {
+ public:
+  BatchedDiagnostics() = default;
+
+  void Log(Level level, DiagMessageActual& actual_msg) override {
+    messages_.emplace_back(level, std::move(actual_msg));
+  }
+
+  void Flush(IDiagnostics* diag) {
+    for (auto& entry : messages_) {
+      diag->Log(entry.first, entry.second);
+    }
+    messages_.clear();
+  }
+
+ private:
+  std::vector<std::pair<Level, DiagMessageActual>> messages_;
+
+  DISALLOW_COPY_AND_ASSIGN(BatchedDiagnostics);
+};
+
 }  // namespace aapt
 
 #endif /* AAPT_DIAGNOSTICS_H */
@@ -72,7 +72,53 @@ static ApkFormat DetermineApkFormat(io::IFileCollection* apk) {
   }
 }
 
-std::unique_ptr<LoadedApk> LoadedApk::LoadApkFromPath(const StringPiece& path, IDiagnostics* diag) {
+// Deserializes the proto resource table in table_file. Returns null and logs to diag on failure.
+static std::unique_ptr<ResourceTable> ParseProtoTable(const Source& source,
+                                                      io::IFileCollection* collection,
+                                                      io::IFile* table_file, IDiagnostics* diag) {
+  pb::ResourceTable pb_table;
+  std::unique_ptr<io::InputStream> in = table_file->OpenInputStream();
+  if (in == nullptr) {
+    diag->Error(DiagMessage(source) << "failed to open " << kProtoResourceTablePath);
+    return {};
+  }
+
+  io::ProtoInputStreamReader proto_reader(in.get());
+  if (!proto_reader.ReadMessage(&pb_table)) {
+    diag->Error(DiagMessage(source) << "failed to read " << kProtoResourceTablePath);
+    return {};
+  }
+
+  std::string error;
+  auto table = util::make_unique<ResourceTable>(/** validate_resources **/ false);
+  if (!DeserializeTableFromPb(pb_table, collection, table.get(), &error)) {
+    diag->Error(DiagMessage(source)
+                << "failed to deserialize " << kProtoResourceTablePath << ": " << error);
+    return {};
+  }
+  return table;
+}
+
+// Parses the binary resource table in table_file. Returns null and logs to diag on failure.
+static std::unique_ptr<ResourceTable> ParseBinaryTable(const Source& source,
+                                                       io::IFileCollection* collection,
+                                                       io::IFile* table_file, IDiagnostics* diag) {
+  std::unique_ptr<io::IData> data = table_file->OpenAsData();
+  if (data == nullptr) {
+    diag->Error(DiagMessage(source) << "failed to open " << kApkResourceTablePath);
+    return {};
+  }
+
+  auto table = util::make_unique<ResourceTable>(/** validate_resources **/ false);
+  BinaryResourceParser parser(diag, table.get(), source, data->data(), data->size(), collection);
+  if (!parser.Parse()) {
+    return {};
+  }
+  return table;
+}
+
+std::unique_ptr<LoadedApk> LoadedApk::LoadApkFromPath(const StringPiece& path, IDiagnostics* diag,
+                                                      bool load_table) {
   Source source(path);
   std::string error;
   std::unique_ptr<io::ZipFileCollection> apk = io::ZipFileCollection::Create(path, &error);
@@ -84,9 +130,9 @@ std::unique_ptr<LoadedApk> LoadedApk::LoadApkFromPath(const StringPiece& path, I
   ApkFormat apkFormat = DetermineApkFormat(apk.get());
   switch (apkFormat) {
     case ApkFormat::kBinary:
-      return LoadBinaryApkFromFileCollection(source, std::move(apk), diag);
+      return LoadBinaryApkFromFileCollection(source, std::move(apk), diag, load_table);
     case ApkFormat::kProto:
-      return LoadProtoApkFromFileCollection(source, std::move(apk), diag);
+      return LoadProtoApkFromFileCollection(source, std::move(apk), diag, load_table);
     default:
       diag->Error(DiagMessage(path) << "could not identify format of APK");
       return {};
@@ -94,29 +140,14 @@ std::unique_ptr<LoadedApk> LoadedApk::LoadApkFromPath(const StringPiece& path, I
 }
 
 std::unique_ptr<LoadedApk> LoadedApk::LoadProtoApkFromFileCollection(
-    const Source& source, unique_ptr<io::IFileCollection> collection, IDiagnostics* diag) {
+    const Source& source, unique_ptr<io::IFileCollection> collection, IDiagnostics* diag,
+    bool load_table) {
   std::unique_ptr<ResourceTable> table;
 
   io::IFile* table_file = collection->FindFile(kProtoResourceTablePath);
-  if (table_file != nullptr) {
-    pb::ResourceTable pb_table;
-    std::unique_ptr<io::InputStream> in = table_file->OpenInputStream();
-    if (in == nullptr) {
-      diag->Error(DiagMessage(source) << "failed to open " << kProtoResourceTablePath);
-      return {};
-    }
-
-    io::ProtoInputStreamReader proto_reader(in.get());
-    if (!proto_reader.ReadMessage(&pb_table)) {
-      diag->Error(DiagMessage(source) << "failed to read " << kProtoResourceTablePath);
-      return {};
-    }
-
-    std::string error;
-    table = util::make_unique<ResourceTable>(/** validate_resources **/ false);
-    if (!DeserializeTableFromPb(pb_table, collection.get(), table.get(), &error)) {
-      diag->Error(DiagMessage(source)
-                  << "failed to deserialize " << kProtoResourceTablePath << ": " << error);
+  if (table_file != nullptr && load_table) {
+    table = ParseProtoTable(source, collection.get(), table_file, diag);
+    if (table == nullptr) {
       return {};
     }
   }
@@ -147,25 +178,24 @@ std::unique_ptr<LoadedApk> LoadedApk::LoadProtoApkFromFileCollection(
                 << "failed to deserialize proto " << kAndroidManifestPath << ": " << error);
     return {};
   }
+
+  if (!load_table) {
+    return util::make_unique<LoadedApk>(source, std::move(collection), std::move(manifest),
+                                        ApkFormat::kProto, diag);
+  }
   return util::make_unique<LoadedApk>(source, std::move(collection), std::move(table),
                                       std::move(manifest), ApkFormat::kProto);
 }
 
 std::unique_ptr<LoadedApk> LoadedApk::LoadBinaryApkFromFileCollection(
-    const Source& source, unique_ptr<io::IFileCollection> collection, IDiagnostics* diag) {
+    const Source& source, unique_ptr<io::IFileCollection> collection, IDiagnostics* diag,
+    bool load_table) {
   std::unique_ptr<ResourceTable> table;
 
   io::IFile* table_file = collection->FindFile(kApkResourceTablePath);
-  if (table_file != nullptr) {
-    table = util::make_unique<ResourceTable>(/** validate_resources **/ false);
-    std::unique_ptr<io::IData> data = table_file->OpenAsData();
-    if (data == nullptr) {
-      diag->Error(DiagMessage(source) << "failed to open " << kApkResourceTablePath);
-      return {};
-    }
-    BinaryResourceParser parser(diag, table.get(), source, data->data(), data->size(),
-                                collection.get());
-    if (!parser.Parse()) {
+  if (table_file != nullptr && load_table) {
+    table = ParseBinaryTable(source, collection.get(), table_file, diag);
+    if (table == nullptr) {
       return {};
     }
   }
@@ -190,14 +220,32 @@ std::unique_ptr<LoadedApk> LoadedApk::LoadBinaryApkFromFileCollection(
                 << "failed to parse binary " << kAndroidManifestPath << ": " << error);
     return {};
   }
+  if (!load_table) {
+    return util::make_unique<LoadedApk>(source, std::move(collection), std::move(manifest),
+                                        ApkFormat::kBinary, diag);
+  }
   return util::make_unique<LoadedApk>(source, std::move(collection), std::move(table),
                                       std::move(manifest), ApkFormat::kBinary);
 }
 
+ResourceTable* LoadedApk::GetResourceTable() {
+  if (!table_parsed_) {
+    table_parsed_ = true;
+    io::IFile* table_file = apk_->FindFile(format_ == ApkFormat::kProto ? kProtoResourceTablePath
+                                                                        : kApkResourceTablePath);
+    if (table_file != nullptr) {
+      table_ = format_ == ApkFormat::kProto
+                   ? ParseProtoTable(source_, apk_.get(), table_file, diag_)
+                   : ParseBinaryTable(source_, apk_.get(), table_file, diag_);
+    }
+  }
+  return table_.get();
+}
+
 bool LoadedApk::WriteToArchive(IAaptContext* context, const TableFlattenerOptions& options,
                                IArchiveWriter* writer) {
   FilterChain empty;
-  return WriteToArchive(context, table_.get(), options, &empty, writer);
+  return WriteToArchive(context, GetResourceTable(), options, &empty, writer);
 }
 
 bool LoadedApk::WriteToArchive(IAaptContext* context, ResourceTable* split_table,
@@ -44,17 +44,21 @@ class LoadedApk {
  public:
   virtual ~LoadedApk() = default;
 
-  // Loads both binary and proto APKs from disk.
+  // Loads both binary and proto APKs from disk. If load_table is false, the resource table is
+  // not deserialized until GetResourceTable() is first called, so callers that only need the
+  // manifest or individual files skip the cost entirely.
   static std::unique_ptr<LoadedApk> LoadApkFromPath(const ::android::StringPiece& path,
-                                                    IDiagnostics* diag);
+                                                    IDiagnostics* diag, bool load_table = true);
 
   // Loads a proto APK from the given file collection.
   static std::unique_ptr<LoadedApk> LoadProtoApkFromFileCollection(
-      const Source& source, std::unique_ptr<io::IFileCollection> collection, IDiagnostics* diag);
+      const Source& source, std::unique_ptr<io::IFileCollection> collection, IDiagnostics* diag,
+      bool load_table = true);
 
   // Loads a binary APK from the given file collection.
   static std::unique_ptr<LoadedApk> LoadBinaryApkFromFileCollection(
-      const Source& source, std::unique_ptr<io::IFileCollection> collection, IDiagnostics* diag);
+      const Source& source, std::unique_ptr<io::IFileCollection> collection, IDiagnostics* diag,
+      bool load_table = true);
 
   LoadedApk(const Source& source, std::unique_ptr<io::IFileCollection> apk,
             std::unique_ptr<ResourceTable> table, std::unique_ptr<xml::XmlResource> manifest,
@@ -63,23 +67,45 @@ class LoadedApk {
         apk_(std::move(apk)),
         table_(std::move(table)),
         manifest_(std::move(manifest)),
-        format_(format) {
+        format_(format),
+        table_parsed_(true) {
+  }
+
+  // Constructs an APK whose resource table is deserialized on first access. The diagnostics
+  // must outlive the LoadedApk.
+  LoadedApk(const Source& source, std::unique_ptr<io::IFileCollection> apk,
+            std::unique_ptr<xml::XmlResource> manifest, const ApkFormat& format,
+            IDiagnostics* diag)
+      : source_(source),
+        apk_(std::move(apk)),
+        manifest_(std::move(manifest)),
+        format_(format),
+        table_parsed_(false),
+        diag_(diag) {
   }
 
   io::IFileCollection* GetFileCollection() {
     return apk_.get();
   }
 
+  // Relinquishes ownership of the file collection. Useful once the resource table has been
+  // merged elsewhere and only the files it references need to stay alive; the table and
+  // manifest can then be freed along with the LoadedApk.
+  std::unique_ptr<io::IFileCollection> TakeFileCollection() {
+    return std::move(apk_);
+  }
+
   ApkFormat GetApkFormat() {
     return format_;
   }
 
-  const ResourceTable* GetResourceTable() const {
-    return table_.get();
-  }
+  // Returns the resource table, deserializing it first if the APK was loaded lazily. Returns
+  // null if the APK has no resource table or deserialization fails; failures are reported to
+  // the diagnostics the APK was loaded with.
+  ResourceTable* GetResourceTable();
 
-  ResourceTable* GetResourceTable() {
-    return table_.get();
+  const ResourceTable* GetResourceTable() const {
+    return const_cast<LoadedApk*>(this)->GetResourceTable();
   }
 
   const Source& GetSource() {
@@ -121,6 +147,11 @@ class LoadedApk {
   std::unique_ptr<ResourceTable> table_;
   std::unique_ptr<xml::XmlResource> manifest_;
   ApkFormat format_;
+
+  // Whether the resource table has been deserialized (or was provided) already. Lazily loaded
+  // APKs parse the table on the first GetResourceTable() call instead.
+  bool table_parsed_;
+  IDiagnostics* diag_ = nullptr;
 };
 
 }  // namespace aapt
@@ -16,7 +16,7 @@
 
 #include "Resource.h"
 
-#include <map>
+#include <cstdint>
 #include <sstream>
 #include <string>
 
@@ -104,41 +104,56 @@ StringPiece to_string(ResourceType type) {
   return {};
 }
 
-static const std::map<StringPiece, ResourceType> sResourceTypeMap{
-    {"anim", ResourceType::kAnim},
-    {"animator", ResourceType::kAnimator},
-    {"array", ResourceType::kArray},
-    {"attr", ResourceType::kAttr},
-    {"^attr-private", ResourceType::kAttrPrivate},
-    {"bool", ResourceType::kBool},
-    {"color", ResourceType::kColor},
-    {"configVarying", ResourceType::kConfigVarying},
-    {"dimen", ResourceType::kDimen},
-    {"drawable", ResourceType::kDrawable},
-    {"font", ResourceType::kFont},
-    {"fraction", ResourceType::kFraction},
-    {"id", ResourceType::kId},
-    {"integer", ResourceType::kInteger},
-    {"interpolator", ResourceType::kInterpolator},
-    {"layout", ResourceType::kLayout},
-    {"menu", ResourceType::kMenu},
-    {"mipmap", ResourceType::kMipmap},
-    {"navigation", ResourceType::kNavigation},
-    {"plurals", ResourceType::kPlurals},
-    {"raw", ResourceType::kRaw},
-    {"string", ResourceType::kString},
-    {"style", ResourceType::kStyle},
-    {"styleable", ResourceType::kStyleable},
-    {"transition", ResourceType::kTransition},
-    {"xml", ResourceType::kXml},
-};
+// FNV-1a, evaluated at compile time for the case labels below. The hashes of the fixed
+// type names are collision free (a collision would produce duplicate case labels and fail
+// to compile), so one hash plus one final comparison replaces a walk through a map of
+// string keys.
+static constexpr uint32_t HashTypeName(const char* str, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<uint8_t>(str[i])) * 16777619u;
+  }
+  return hash;
+}
 
 const ResourceType* ParseResourceType(const StringPiece& str) {
-  auto iter = sResourceTypeMap.find(str);
-  if (iter == std::end(sResourceTypeMap)) {
-    return nullptr;
+#define TYPE_CASE(name_, type_)                            \
+  case HashTypeName(name_, sizeof(name_) - 1): {           \
+    static const ResourceType type = ResourceType::type_;  \
+    return str == name_ ? &type : nullptr;                 \
+  }
+  switch (HashTypeName(str.data(), str.size())) {
+    TYPE_CASE("anim", kAnim)
+    TYPE_CASE("animator", kAnimator)
+    TYPE_CASE("array", kArray)
+    TYPE_CASE("attr", kAttr)
+    TYPE_CASE("^attr-private", kAttrPrivate)
+    TYPE_CASE("bool", kBool)
+    TYPE_CASE("color", kColor)
+    TYPE_CASE("configVarying", kConfigVarying)
+    TYPE_CASE("dimen", kDimen)
+    TYPE_CASE("drawable", kDrawable)
+    TYPE_CASE("font", kFont)
+    TYPE_CASE("fraction", kFraction)
+    TYPE_CASE("id", kId)
+    TYPE_CASE("integer", kInteger)
+    TYPE_CASE("interpolator", kInterpolator)
+    TYPE_CASE("layout", kLayout)
+    TYPE_CASE("menu", kMenu)
+    TYPE_CASE("mipmap", kMipmap)
+    TYPE_CASE("navigation", kNavigation)
+    TYPE_CASE("plurals", kPlurals)
+    TYPE_CASE("raw", kRaw)
+    TYPE_CASE("string", kString)
+    TYPE_CASE("style", kStyle)
+    TYPE_CASE("styleable", kStyleable)
+    TYPE_CASE("transition", kTransition)
+    TYPE_CASE("xml", kXml)
+    default:
+      break;
   }
-  return &iter->second;
+#undef TYPE_CASE
+  return nullptr;
 }
 
 bool operator<(const ResourceKey& a, const ResourceKey& b) {
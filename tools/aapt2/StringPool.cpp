@@ -19,6 +19,8 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "android-base/logging.h"
 #include "androidfw/ResourceTypes.h"
@@ -268,6 +270,7 @@ void StringPool::Merge(StringPool&& pool) {
 void StringPool::HintWillAdd(size_t string_count, size_t style_count) {
   strings_.reserve(strings_.size() + string_count);
   styles_.reserve(styles_.size() + style_count);
+  indexed_strings_.reserve(indexed_strings_.size() + string_count);
 }
 
 void StringPool::Prune() {
@@ -295,6 +298,50 @@ void StringPool::Prune() {
   ReAssignIndices();
 }
 
+// Below this size the slices would be too small to be worth the thread startup cost.
+constexpr static size_t kMinEntriesPerSortThread = 8192;
+
+// Sorts the entries, spreading the work across threads when the pool is large.
+// Each worker sorts one slice of the vector, then the sorted slices are merged
+// pairwise.  Sorting dominates flatten time for big resource tables, which is
+// why this is worth the extra machinery.
+template <typename UEntry, typename Less>
+static void ParallelSort(std::vector<UEntry>& entries, const Less& less) {
+  size_t thread_count = std::thread::hardware_concurrency();
+  if (thread_count > entries.size() / kMinEntriesPerSortThread) {
+    thread_count = entries.size() / kMinEntriesPerSortThread;
+  }
+  if (thread_count <= 1) {
+    std::sort(entries.begin(), entries.end(), less);
+    return;
+  }
+
+  std::vector<size_t> bounds;
+  bounds.reserve(thread_count + 1);
+  for (size_t i = 0; i <= thread_count; i++) {
+    bounds.push_back(entries.size() * i / thread_count);
+  }
+
+  std::vector<std::thread> workers;
+  workers.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; i++) {
+    workers.emplace_back([&entries, &less, &bounds, i]() {
+      std::sort(entries.begin() + bounds[i], entries.begin() + bounds[i + 1], less);
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  for (size_t width = 1; width < thread_count; width *= 2) {
+    for (size_t i = 0; i + width < thread_count; i += 2 * width) {
+      const size_t end = std::min(i + 2 * width, thread_count);
+      std::inplace_merge(entries.begin() + bounds[i], entries.begin() + bounds[i + width],
+                         entries.begin() + bounds[end], less);
+    }
+  }
+}
+
 template <typename E>
 static void SortEntries(
     std::vector<std::unique_ptr<E>>& entries,
@@ -302,7 +349,7 @@ static void SortEntries(
   using UEntry = std::unique_ptr<E>;
 
   if (cmp != nullptr) {
-    std::sort(entries.begin(), entries.end(), [&cmp](const UEntry& a, const UEntry& b) -> bool {
+    ParallelSort(entries, [&cmp](const UEntry& a, const UEntry& b) -> bool {
       int r = cmp(a->context, b->context);
       if (r == 0) {
         r = a->value.compare(b->value);
@@ -310,8 +357,8 @@ static void SortEntries(
       return r < 0;
     });
   } else {
-    std::sort(entries.begin(), entries.end(),
-              [](const UEntry& a, const UEntry& b) -> bool { return a->value < b->value; });
+    ParallelSort(entries,
+                 [](const UEntry& a, const UEntry& b) -> bool { return a->value < b->value; });
   }
 }
 
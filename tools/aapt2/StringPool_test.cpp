@@ -157,6 +157,25 @@ TEST(StringPoolTest, SortAndStillDedupe) {
   EXPECT_THAT(ref_f.index(), Eq(ref_c.index()));
 }
 
+TEST(StringPoolTest, SortLargePool) {
+  StringPool pool;
+
+  // Enough strings that Sort spreads the work over several threads.
+  const size_t count = 40000u;
+  pool.HintWillAdd(count, 0u);
+  for (size_t i = 0; i < count; i++) {
+    pool.MakeRef(std::to_string((i * 2654435761u) % count));
+  }
+
+  pool.Sort();
+
+  const auto& strings = pool.strings();
+  ASSERT_THAT(strings.size(), Eq(count));
+  for (size_t i = 1; i < strings.size(); i++) {
+    EXPECT_TRUE(strings[i - 1]->value < strings[i]->value);
+  }
+}
+
 TEST(StringPoolTest, AddStyles) {
   StringPool pool;
 
@@ -17,7 +17,12 @@
 #include "Compile.h"
 
 #include <dirent.h>
+
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "android-base/errors.h"
 #include "android-base/file.h"
@@ -513,8 +518,11 @@ static bool CompilePng(IAaptContext* context, const CompileOptions& options,
       }
     }
 
+    PngOptions png_options;
+    png_options.fast_crunch = options.fast_png_crunch;
+
     // Write the crunched PNG.
-    if (!WritePng(context, image.get(), nine_patch.get(), &crunched_png_buffer_out, {})) {
+    if (!WritePng(context, image.get(), nine_patch.get(), &crunched_png_buffer_out, png_options)) {
       return false;
     }
 
@@ -636,10 +644,156 @@ class CompileContext : public IAaptContext {
   bool verbose_ = false;
 };
 
+// Serializes logging, since the diagnostics sink handed to the compile phase is not thread-safe.
+class LockedDiagnostics : public IDiagnostics {
+ public:
+  explicit LockedDiagnostics(IDiagnostics* diag) : diag_(diag) {
+  }
+
+  void Log(Level level, DiagMessageActual& actual_msg) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    diag_->Log(level, actual_msg);
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(LockedDiagnostics);
+
+  IDiagnostics* diag_;
+  std::mutex mutex_;
+};
+
+// An IAaptContext for a compile worker thread. It shares everything with the main context
+// except the diagnostics sink, which is replaced with a serializing one.
+class WorkerContext : public IAaptContext {
+ public:
+  WorkerContext(IAaptContext* base, IDiagnostics* diagnostics)
+      : base_(base), diagnostics_(diagnostics) {
+  }
+
+  PackageType GetPackageType() override {
+    return base_->GetPackageType();
+  }
+
+  bool IsVerbose() override {
+    return base_->IsVerbose();
+  }
+
+  IDiagnostics* GetDiagnostics() override {
+    return diagnostics_;
+  }
+
+  NameMangler* GetNameMangler() override {
+    return base_->GetNameMangler();
+  }
+
+  const std::string& GetCompilationPackage() override {
+    return base_->GetCompilationPackage();
+  }
+
+  uint8_t GetPackageId() override {
+    return base_->GetPackageId();
+  }
+
+  SymbolTable* GetExternalSymbols() override {
+    return base_->GetExternalSymbols();
+  }
+
+  int GetMinSdkVersion() override {
+    return base_->GetMinSdkVersion();
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(WorkerContext);
+
+  IAaptContext* base_;
+  IDiagnostics* diagnostics_;
+};
+
+// Collects the entries written while compiling one file into memory, so workers can run
+// without contending for the real output archive. The buffered entries are flushed to the
+// real archive afterwards, in input order, keeping the output identical to a serial run.
+class BufferingArchiveWriter : public IArchiveWriter {
+ public:
+  BufferingArchiveWriter() = default;
+
+  bool WriteFile(const StringPiece& path, uint32_t flags, io::InputStream* in) override {
+    if (!StartEntry(path, flags)) {
+      return false;
+    }
+    const void* data;
+    size_t len;
+    while (in->Next(&data, &len)) {
+      if (!Write(data, static_cast<int>(len))) {
+        return false;
+      }
+    }
+    if (in->HadError()) {
+      return false;
+    }
+    return FinishEntry();
+  }
+
+  bool StartEntry(const StringPiece& path, uint32_t flags) override {
+    entries_.emplace_back();
+    entries_.back().path = path.to_string();
+    entries_.back().flags = flags;
+    return true;
+  }
+
+  bool FinishEntry() override {
+    return true;
+  }
+
+  bool Write(const void* buffer, int size) override {
+    entries_.back().data.append(static_cast<const char*>(buffer), size);
+    return true;
+  }
+
+  bool HadError() const override {
+    return false;
+  }
+
+  std::string GetError() const override {
+    return {};
+  }
+
+  // Writes the buffered entries to the real archive.
+  bool Flush(IArchiveWriter* writer) {
+    for (const BufferedEntry& entry : entries_) {
+      if (!writer->StartEntry(entry.path, entry.flags) ||
+          !writer->Write(entry.data.data(), static_cast<int>(entry.data.size())) ||
+          !writer->FinishEntry()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct BufferedEntry {
+    std::string path;
+    uint32_t flags;
+    std::string data;
+  };
+
+  std::vector<BufferedEntry> entries_;
+};
+
+using CompileFunc = bool (*)(IAaptContext*, const CompileOptions&, const ResourcePathData&,
+                             io::IFile*, IArchiveWriter*, const std::string&);
+
+struct CompileJob {
+  ResourcePathData path_data;
+  io::IFile* file;
+  CompileFunc compile_func;
+  std::string out_path;
+};
+
 int Compile(IAaptContext* context, io::IFileCollection* inputs, IArchiveWriter* output_writer,
              CompileOptions& options) {
   TRACE_CALL();
   bool error = false;
+  std::vector<CompileJob> jobs;
 
   // Iterate over the input files in a stable, platform-independent manner
   auto file_iterator  = inputs->Iterator();
@@ -669,7 +823,7 @@ int Compile(IAaptContext* context, io::IFileCollection* inputs, IArchiveWriter*
     }
 
     // Determine how to compile the file based on its type.
-    auto compile_func = &CompileFile;
+    CompileFunc compile_func = &CompileFile;
     if (path_data.resource_dir == "values" && path_data.extension == "xml") {
       compile_func = &CompileTable;
       // We use a different extension (not necessary anymore, but avoids altering the existing
@@ -704,8 +858,70 @@ int Compile(IAaptContext* context, io::IFileCollection* inputs, IArchiveWriter*
     }
 
     const std::string out_path = BuildIntermediateContainerFilename(path_data);
-    if (!compile_func(context, options, path_data, file, output_writer, out_path)) {
-      context->GetDiagnostics()->Error(DiagMessage(file->GetSource()) << "file failed to compile");
+    jobs.push_back(CompileJob{std::move(path_data), file, compile_func, out_path});
+  }
+
+  // Decide how many workers to use.  The files are independent of each other, so the only
+  // reasons to stay serial are having nothing to parallelize or the R.txt symbols file, which
+  // is rewritten for each input and can't have its writes interleaved.
+  size_t thread_count = std::thread::hardware_concurrency();
+  if (options.generate_text_symbols_path) {
+    thread_count = 1;
+  }
+  if (thread_count > jobs.size()) {
+    thread_count = jobs.size();
+  }
+
+  if (thread_count <= 1) {
+    for (CompileJob& job : jobs) {
+      if (!job.compile_func(context, options, job.path_data, job.file, output_writer,
+                            job.out_path)) {
+        context->GetDiagnostics()->Error(DiagMessage(job.file->GetSource())
+                                         << "file failed to compile");
+        error = true;
+      }
+    }
+    return error ? 1 : 0;
+  }
+
+  // Compile on a worker pool, each file into its own in-memory buffer.
+  LockedDiagnostics locked_diagnostics(context->GetDiagnostics());
+  std::vector<BufferingArchiveWriter> buffers(jobs.size());
+  std::vector<int> results(jobs.size(), 0);
+  std::atomic<size_t> next_job(0);
+
+  const auto worker = [&]() {
+    WorkerContext worker_context(context, &locked_diagnostics);
+    while (true) {
+      const size_t i = next_job.fetch_add(1);
+      if (i >= jobs.size()) {
+        break;
+      }
+      CompileJob& job = jobs[i];
+      results[i] = job.compile_func(&worker_context, options, job.path_data, job.file, &buffers[i],
+                                    job.out_path);
+    }
+  };
+
+  std::vector<std::thread> extra_workers;
+  extra_workers.reserve(thread_count - 1);
+  for (size_t i = 1; i < thread_count; i++) {
+    extra_workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& extra_worker : extra_workers) {
+    extra_worker.join();
+  }
+
+  // Flush the buffered containers to the real archive, in input order.
+  for (size_t i = 0; i < jobs.size(); i++) {
+    if (!results[i]) {
+      context->GetDiagnostics()->Error(DiagMessage(jobs[i].file->GetSource())
+                                       << "file failed to compile");
+      error = true;
+    } else if (!buffers[i].Flush(output_writer)) {
+      context->GetDiagnostics()->Error(DiagMessage(jobs[i].out_path)
+                                       << "failed to write to archive");
       error = true;
     }
   }
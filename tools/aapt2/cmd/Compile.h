@@ -34,6 +34,7 @@ struct CompileOptions {
   Maybe<Visibility::Level> visibility;
   bool pseudolocalize = false;
   bool no_png_crunch = false;
+  bool fast_png_crunch = false;
   bool legacy_mode = false;
   bool verbose = false;
 };
@@ -54,6 +55,8 @@ class CompileCommand : public Command {
     AddOptionalSwitch("--pseudo-localize", "Generate resources for pseudo-locales "
         "(en-XA and ar-XB)", &options_.pseudolocalize);
     AddOptionalSwitch("--no-crunch", "Disables PNG processing", &options_.no_png_crunch);
+    AddOptionalSwitch("--fast-crunch", "Crunch PNGs for speed instead of size",
+        &options_.fast_png_crunch);
     AddOptionalSwitch("--legacy", "Treat errors that used to be valid in AAPT as warnings",
         &options_.legacy_mode);
     AddOptionalFlag("--visibility",
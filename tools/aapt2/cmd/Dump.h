@@ -69,7 +69,9 @@ class DumpApkCommand : public Command {
 
     bool error = false;
     for (auto apk : args) {
-      auto loaded_apk = LoadedApk::LoadApkFromPath(apk, diag_);
+      // Load the table lazily: most dump operations only touch the manifest or individual
+      // files, and the ones that need the table will deserialize it on first access.
+      auto loaded_apk = LoadedApk::LoadApkFromPath(apk, diag_, /** load_table */ false);
       if (!loaded_apk) {
         error = true;
         continue;
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <queue>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "android-base/errors.h"
@@ -738,6 +739,17 @@ static android::ApkAssetsCookie FindFrameworkAssetManagerCookie(
   return idx;
 }
 
+// FNV-1a over the file contents, folding in the length.  Used to recognize inputs that were
+// already merged; 64 bits keeps the chance of an accidental match negligible.
+static uint64_t FingerprintData(const void* data, size_t len) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  uint64_t hash = 0xcbf29ce484222325ull ^ len;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
 class Linker {
  public:
   Linker(LinkContext* context, const LinkOptions& options)
@@ -1333,8 +1345,10 @@ class Linker {
       return false;
     }
 
-    // Make sure to move the collection into the set of IFileCollections.
-    merged_apks_.push_back(std::move(apk));
+    // Only the files need to stay alive: every value was cloned into the master table, so
+    // keep the collection and free the library's table and manifest instead of holding
+    // them resident for the rest of the link.
+    collections_.push_back(apk->TakeFileCollection());
     return true;
   }
 
@@ -1451,7 +1465,27 @@ class Linker {
       }
     }
 
-    std::unique_ptr<io::InputStream> input_stream = file->OpenInputStream();
+    // Map the container once up front; the fingerprint check and the proto parsing below
+    // then both read directly from the mapped pages without an intermediate copy.
+    std::unique_ptr<io::InputStream> input_stream;
+    if (std::unique_ptr<io::IData> data = file->OpenAsData()) {
+      // Skip containers whose exact contents were already merged.  Deserializing and merging a
+      // repeated fragment again is at best wasted work, and for non-overlay inputs it manufactures
+      // duplicate-resource conflicts out of what is really the same compilation unit.
+      const uint64_t fingerprint = FingerprintData(data->data(), data->size());
+      if (!merged_fingerprints_.insert(fingerprint).second) {
+        if (context_->IsVerbose()) {
+          context_->GetDiagnostics()->Note(DiagMessage(src)
+                                           << "skipping input identical to an earlier one");
+        }
+        return true;
+      }
+      input_stream = std::move(data);
+    } else {
+      // Mapping can fail (e.g. on some filesystems); fall back to buffered reads.
+      input_stream = file->OpenInputStream();
+    }
+
     if (input_stream == nullptr) {
       context_->GetDiagnostics()->Error(DiagMessage(src) << "failed to open file");
       return false;
@@ -1490,6 +1524,11 @@ class Linker {
           return false;
         }
 
+        // The deserialized table owns its own strings, so release the proto representation
+        // now rather than keeping three copies of a large input (proto, deserialized,
+        // merged) resident while merging.
+        pb_table.Clear();
+
         if (!table_merger_->Merge(src, &table, override)) {
           context_->GetDiagnostics()->Error(DiagMessage(src) << "failed to merge resource table");
           return false;
@@ -2038,6 +2077,11 @@ class Linker {
 
   std::unique_ptr<TableMerger> table_merger_;
 
+  // Fingerprints of the container files merged so far.  Flattened dependency lists often repeat
+  // the same .flat file under several inputs; remembering what was already merged lets those
+  // duplicates be skipped instead of deserialized and merged again.
+  std::unordered_set<uint64_t> merged_fingerprints_;
+
   // A pointer to the FileCollection representing the filesystem (not archives).
   std::unique_ptr<io::FileCollection> file_collection_;
 
@@ -2045,9 +2089,6 @@ class Linker {
   // collections.
   std::vector<std::unique_ptr<io::IFileCollection>> collections_;
 
-  // The set of merged APKs. This is mainly here to retain ownership of the APKs.
-  std::vector<std::unique_ptr<LoadedApk>> merged_apks_;
-
   // The set of included APKs (not merged). This is mainly here to retain ownership of the APKs.
   std::vector<std::unique_ptr<LoadedApk>> static_library_includes_;
 
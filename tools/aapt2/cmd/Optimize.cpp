@@ -40,6 +40,7 @@
 #include "io/Util.h"
 #include "optimize/MultiApkGenerator.h"
 #include "optimize/ResourceDeduper.h"
+#include "optimize/ResourceFileDeduper.h"
 #include "optimize/ResourceFilter.h"
 #include "optimize/ResourcePathShortener.h"
 #include "optimize/VersionCollapser.h"
@@ -145,6 +146,12 @@ class Optimizer {
       return 1;
     }
 
+    ResourceFileDeduper file_deduper;
+    if (!file_deduper.Consume(context_, apk->GetResourceTable())) {
+      context_->GetDiagnostics()->Error(DiagMessage() << "failed deduping resource files");
+      return 1;
+    }
+
     if (options_.shorten_resource_paths) {
       ResourcePathShortener shortener(options_.table_flattener_options.shortened_path_map);
       if (!shortener.Consume(context_, apk->GetResourceTable())) {
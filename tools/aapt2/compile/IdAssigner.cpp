@@ -16,7 +16,8 @@
 
 #include "compile/IdAssigner.h"
 
-#include <map>
+#include <algorithm>
+#include <vector>
 
 #include "android-base/logging.h"
 
@@ -52,23 +53,38 @@ static bool AssignId(IDiagnostics* diag, const ResourceId& id,
   return false;
 }
 
+namespace {
+
+// A reserved ID and the resource it belongs to. The name is a reference into the table or the
+// stable ID map, both of which outlive the assignment pass, so no strings are copied.
+struct AssignedId {
+  ResourceId id;
+  ResourceNameRef name;
+
+  // Whether the reservation came from the stable ID map rather than the table itself.
+  // Stable reservations may share an ID with the table entry of the same name.
+  bool from_stable_map;
+};
+
+}  // namespace
+
 bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
-  std::map<ResourceId, ResourceName> assigned_ids;
+  std::vector<AssignedId> assigned_ids;
 
   for (auto& package : table->packages) {
     CHECK(bool(package->id)) << "packages must have manually assigned IDs";
 
     for (auto& type : package->types) {
       for (auto& entry : type->entries) {
-        const ResourceName name(package->name, type->type, entry->name);
+        const ResourceNameRef name(package->name, type->type, entry->name);
 
         if (assigned_id_map_) {
           // Assign the pre-assigned stable ID meant for this resource.
-          const auto iter = assigned_id_map_->find(name);
+          const auto iter = assigned_id_map_->find(name.ToResourceName());
           if (iter != assigned_id_map_->end()) {
             const ResourceId assigned_id = iter->second;
             const bool result =
-                AssignId(context->GetDiagnostics(), assigned_id, name,
+                AssignId(context->GetDiagnostics(), assigned_id, iter->first,
                          package.get(), type.get(), entry.get());
             if (!result) {
               return false;
@@ -80,14 +96,7 @@ bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
           // If the ID is set for this resource, then reserve it.
           ResourceId resource_id(package->id.value(), type->id.value(),
                                  entry->id.value());
-          auto result = assigned_ids.insert({resource_id, name});
-          const ResourceName& existing_name = result.first->second;
-          if (!result.second) {
-            context->GetDiagnostics()->Error(
-                DiagMessage() << "resource " << name << " has same ID "
-                              << resource_id << " as " << existing_name);
-            return false;
-          }
+          assigned_ids.push_back(AssignedId{resource_id, name, false /*from_stable_map*/});
         }
       }
     }
@@ -97,18 +106,39 @@ bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
     // Reserve all the IDs mentioned in the stable ID map. That way we won't
     // assign
     // IDs that were listed in the map if they don't exist in the table.
+    assigned_ids.reserve(assigned_ids.size() + assigned_id_map_->size());
     for (const auto& stable_id_entry : *assigned_id_map_) {
-      const ResourceName& pre_assigned_name = stable_id_entry.first;
-      const ResourceId& pre_assigned_id = stable_id_entry.second;
-      auto result = assigned_ids.insert({pre_assigned_id, pre_assigned_name});
-      const ResourceName& existing_name = result.first->second;
-      if (!result.second && existing_name != pre_assigned_name) {
-        context->GetDiagnostics()->Error(
-            DiagMessage() << "stable ID " << pre_assigned_id << " for resource "
-                          << pre_assigned_name
-                          << " is already taken by resource " << existing_name);
-        return false;
-      }
+      assigned_ids.push_back(
+          AssignedId{stable_id_entry.second, stable_id_entry.first, true /*from_stable_map*/});
+    }
+  }
+
+  // Sort the reservations by ID, keeping table entries ahead of stable map reservations for the
+  // same ID, then report any ID claimed twice. A sorted flat vector avoids the per-resource node
+  // allocation and string copies a map keyed by ID would make.
+  std::stable_sort(assigned_ids.begin(), assigned_ids.end(),
+                   [](const AssignedId& lhs, const AssignedId& rhs) { return lhs.id < rhs.id; });
+
+  for (size_t i = 1; i < assigned_ids.size(); i++) {
+    const AssignedId& existing = assigned_ids[i - 1];
+    const AssignedId& assigned = assigned_ids[i];
+    if (existing.id != assigned.id) {
+      continue;
+    }
+
+    if (!assigned.from_stable_map) {
+      context->GetDiagnostics()->Error(
+          DiagMessage() << "resource " << assigned.name << " has same ID "
+                        << assigned.id << " as " << existing.name);
+      return false;
+    }
+
+    if (existing.name != assigned.name) {
+      context->GetDiagnostics()->Error(
+          DiagMessage() << "stable ID " << assigned.id << " for resource "
+                        << assigned.name
+                        << " is already taken by resource " << existing.name);
+      return false;
     }
   }
 
@@ -116,6 +146,10 @@ bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
   // if possible,
   // unless those IDs have been reserved.
 
+  const auto id_less_than = [](const AssignedId& lhs, const ResourceId& rhs) {
+    return lhs.id < rhs;
+  };
+
   const auto assigned_ids_iter_end = assigned_ids.end();
   for (auto& package : table->packages) {
     CHECK(bool(package->id)) << "packages must have manually assigned IDs";
@@ -130,7 +164,8 @@ bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
 
     // Find the closest matching ResourceId that is <= the one with only the
     // package set.
-    auto next_type_iter = assigned_ids.lower_bound(resource_id);
+    auto next_type_iter =
+        std::lower_bound(assigned_ids.begin(), assigned_ids_iter_end, resource_id, id_less_than);
     for (auto& type : package->types) {
       if (!type->id) {
         // We need to assign a type ID. Iterate over the reserved IDs until we
@@ -139,11 +174,11 @@ bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
         // seen.
         // That means there is an available type ID between these reserved IDs.
         while (next_type_iter != assigned_ids_iter_end) {
-          if (next_type_iter->first.package_id() != package->id.value()) {
+          if (next_type_iter->id.package_id() != package->id.value()) {
             break;
           }
 
-          const uint8_t type_id = next_type_iter->first.type_id();
+          const uint8_t type_id = next_type_iter->id.type_id();
           if (type_id > next_expected_type_id) {
             // There is a gap in the type IDs, so use the missing one.
             type->id = next_expected_type_id++;
@@ -172,7 +207,8 @@ bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
       // Find the closest matching ResourceId that is <= the one with only the
       // package
       // and type set.
-      auto next_entry_iter = assigned_ids.lower_bound(resource_id);
+      auto next_entry_iter =
+          std::lower_bound(assigned_ids.begin(), assigned_ids_iter_end, resource_id, id_less_than);
       for (auto& entry : type->entries) {
         if (!entry->id) {
           // We need to assign an entry ID. Iterate over the reserved IDs until
@@ -182,12 +218,12 @@ bool IdAssigner::Consume(IAaptContext* context, ResourceTable* table) {
           // That means there is an available entry ID between these reserved
           // IDs.
           while (next_entry_iter != assigned_ids_iter_end) {
-            if (next_entry_iter->first.package_id() != package->id.value() ||
-                next_entry_iter->first.type_id() != type->id.value()) {
+            if (next_entry_iter->id.package_id() != package->id.value() ||
+                next_entry_iter->id.type_id() != type->id.value()) {
               break;
             }
 
-            const uint16_t entry_id = next_entry_iter->first.entry_id();
+            const uint16_t entry_id = next_entry_iter->id.entry_id();
             if (entry_id > next_expected_entry_id) {
               // There is a gap in the entry IDs, so use the missing one.
               entry->id = next_expected_entry_id++;
@@ -36,6 +36,10 @@ constexpr size_t kPngSignatureSize = 8u;
 
 struct PngOptions {
   int grayscale_tolerance = 0;
+
+  // When true, trade output size for encode speed: use a fast deflate level and a single
+  // fixed filter instead of letting libpng try every filter at maximum compression.
+  bool fast_crunch = false;
 };
 
 /**
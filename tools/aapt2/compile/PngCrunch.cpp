@@ -517,8 +517,13 @@ bool WritePng(IAaptContext* context, const Image* image,
   // Set up the write functions which write to our custom data sources.
   png_set_write_fn(write_ptr, (png_voidp)out, WriteDataToStream, nullptr);
 
-  // We want small files and can take the performance hit to achieve this goal.
-  png_set_compression_level(write_ptr, Z_BEST_COMPRESSION);
+  if (options.fast_crunch) {
+    // The caller asked for speed over size (debug-style builds).
+    png_set_compression_level(write_ptr, Z_BEST_SPEED);
+  } else {
+    // We want small files and can take the performance hit to achieve this goal.
+    png_set_compression_level(write_ptr, Z_BEST_COMPRESSION);
+  }
 
   // Begin analysis of the image data.
   // Scan the entire image and determine if:
@@ -627,6 +632,10 @@ bool WritePng(IAaptContext* context, const Image* image,
     // libpng writePtr.
     WritePalette(write_ptr, write_info_ptr, &color_palette, &alpha_palette);
     png_set_filter(write_ptr, 0, PNG_NO_FILTERS);
+  } else if (options.fast_crunch) {
+    // Trying every filter per row is the expensive part of encoding; SUB alone
+    // is a reasonable default when size doesn't matter.
+    png_set_filter(write_ptr, 0, PNG_FILTER_SUB);
   } else {
     png_set_filter(write_ptr, 0, PNG_ALL_FILTERS);
   }
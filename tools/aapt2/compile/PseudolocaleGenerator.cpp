@@ -314,6 +314,18 @@ ConfigDescription ModifyConfigForPseudoLocale(const ConfigDescription& base,
 void PseudolocalizeIfNeeded(const Pseudolocalizer::Method method,
                             ResourceConfigValue* original_value,
                             StringPool* pool, ResourceEntry* entry) {
+  const ConfigDescription config_with_accent =
+      ModifyConfigForPseudoLocale(original_value->config, method);
+
+  // Only use auto-generated pseudo-localization if none is defined. Check before generating,
+  // so an explicitly defined pseudolocale doesn't cost us a localized copy in the string pool
+  // that is immediately thrown away.
+  ResourceConfigValue* existing_value =
+      entry->FindValue(config_with_accent, original_value->product);
+  if (existing_value != nullptr && existing_value->value != nullptr) {
+    return;
+  }
+
   Visitor visitor(pool, method);
   original_value->value->Accept(&visitor);
 
@@ -328,15 +340,8 @@ void PseudolocalizeIfNeeded(const Pseudolocalizer::Method method,
     return;
   }
 
-  ConfigDescription config_with_accent =
-      ModifyConfigForPseudoLocale(original_value->config, method);
-
-  ResourceConfigValue* new_config_value =
-      entry->FindOrCreateValue(config_with_accent, original_value->product);
-  if (!new_config_value->value) {
-    // Only use auto-generated pseudo-localization if none is defined.
-    new_config_value->value = std::move(localized_value);
-  }
+  entry->FindOrCreateValue(config_with_accent, original_value->product)->value =
+      std::move(localized_value);
 }
 
 // A value is pseudolocalizable if it does not define a locale (or is the default locale) and is
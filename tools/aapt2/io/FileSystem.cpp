@@ -48,6 +48,11 @@ std::unique_ptr<IData> RegularFile::OpenAsData() {
 }
 
 std::unique_ptr<io::InputStream> RegularFile::OpenInputStream() {
+  // Serve the mapped file when possible so readers pull pages straight from the page cache
+  // instead of copying through a read() buffer. Fall back to buffered reads if mmap fails.
+  if (std::unique_ptr<IData> data = OpenAsData()) {
+    return std::move(data);
+  }
   return util::make_unique<FileInputStream>(source_.path);
 }
 
@@ -16,6 +16,12 @@
 
 #include "link/ReferenceLinker.h"
 
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "android-base/logging.h"
 #include "androidfw/ResourceTypes.h"
 
@@ -49,12 +55,14 @@ class ReferenceLinkerVisitor : public DescendingValueVisitor {
   using DescendingValueVisitor::Visit;
 
   ReferenceLinkerVisitor(const CallSite& callsite, IAaptContext* context, SymbolTable* symbols,
-                         StringPool* string_pool, xml::IPackageDeclStack* decl)
+                         StringPool* string_pool, xml::IPackageDeclStack* decl,
+                         std::mutex* string_pool_lock = nullptr)
       : callsite_(callsite),
         context_(context),
         symbols_(symbols),
         package_decls_(decl),
-        string_pool_(string_pool) {}
+        string_pool_(string_pool),
+        string_pool_lock_(string_pool_lock) {}
 
   void Visit(Reference* ref) override {
     if (!ReferenceLinker::LinkReference(callsite_, ref, context_, symbols_, package_decls_)) {
@@ -138,6 +146,11 @@ class ReferenceLinkerVisitor : public DescendingValueVisitor {
         StringBuilder string_builder;
         string_builder.AppendText(*raw_string->value);
         if (string_builder) {
+          // The string pool is shared between shards when linking in parallel.
+          std::unique_lock<std::mutex> lock;
+          if (string_pool_lock_ != nullptr) {
+            lock = std::unique_lock<std::mutex>(*string_pool_lock_);
+          }
           transformed =
               util::make_unique<String>(string_pool_->MakeRef(string_builder.to_string()));
         }
@@ -155,9 +168,58 @@ class ReferenceLinkerVisitor : public DescendingValueVisitor {
   SymbolTable* symbols_;
   xml::IPackageDeclStack* package_decls_;
   StringPool* string_pool_;
+  std::mutex* string_pool_lock_;
   bool error_ = false;
 };
 
+// An IAaptContext that reroutes diagnostics to a per-shard collector. Everything else is
+// forwarded to the main context, whose remaining methods only read state that is immutable
+// during this phase.
+class ShardContext : public IAaptContext {
+ public:
+  ShardContext(IAaptContext* base, IDiagnostics* diagnostics)
+      : base_(base), diagnostics_(diagnostics) {
+  }
+
+  PackageType GetPackageType() override {
+    return base_->GetPackageType();
+  }
+
+  SymbolTable* GetExternalSymbols() override {
+    return base_->GetExternalSymbols();
+  }
+
+  IDiagnostics* GetDiagnostics() override {
+    return diagnostics_;
+  }
+
+  const std::string& GetCompilationPackage() override {
+    return base_->GetCompilationPackage();
+  }
+
+  uint8_t GetPackageId() override {
+    return base_->GetPackageId();
+  }
+
+  NameMangler* GetNameMangler() override {
+    return base_->GetNameMangler();
+  }
+
+  bool IsVerbose() override {
+    return base_->IsVerbose();
+  }
+
+  int GetMinSdkVersion() override {
+    return base_->GetMinSdkVersion();
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ShardContext);
+
+  IAaptContext* base_;
+  IDiagnostics* diagnostics_;
+};
+
 class EmptyDeclStack : public xml::IPackageDeclStack {
  public:
   EmptyDeclStack() = default;
@@ -199,6 +261,16 @@ bool IsSymbolVisible(const SymbolTable::Symbol& symbol, const Reference& ref,
   return false;
 }
 
+// Sharding the linking pass across fewer entries than this costs more in thread startup
+// than it saves.
+constexpr size_t kMinEntriesPerShard = 1024;
+
+// The work for a single entry: the unmangled package that defines it, and the entry itself.
+struct EntryWork {
+  std::string package;
+  ResourceEntry* entry;
+};
+
 }  // namespace
 
 const SymbolTable::Symbol* ReferenceLinker::ResolveSymbol(const Reference& reference,
@@ -357,6 +429,10 @@ bool ReferenceLinker::Consume(IAaptContext* context, ResourceTable* table) {
   TRACE_NAME("ReferenceLinker::Consume");
   EmptyDeclStack decl_stack;
   bool error = false;
+
+  // Walk the table up front, in order, so that the "no definition" diagnostics are emitted
+  // deterministically and each entry is paired with its defining package.
+  std::vector<EntryWork> work;
   for (auto& package : table->packages) {
     // Since we're linking, each package must have a name.
     CHECK(!package->name.empty()) << "all packages being linked must have a name";
@@ -383,20 +459,74 @@ bool ReferenceLinker::Consume(IAaptContext* context, ResourceTable* table) {
           error = true;
         }
 
-        // The context of this resource is the package in which it is defined.
-        const CallSite callsite{name.package};
-        ReferenceLinkerVisitor visitor(callsite, context, context->GetExternalSymbols(),
-                                       &table->string_pool, &decl_stack);
+        work.push_back(EntryWork{std::move(name.package), entry.get()});
+      }
+    }
+  }
 
-        for (auto& config_value : entry->values) {
-          config_value->value->Accept(&visitor);
-        }
+  size_t shard_count = std::thread::hardware_concurrency();
+  shard_count = std::min(shard_count, work.size() / kMinEntriesPerShard);
+  if (shard_count <= 1) {
+    for (const EntryWork& item : work) {
+      // The context of this resource is the package in which it is defined.
+      const CallSite callsite{item.package};
+      ReferenceLinkerVisitor visitor(callsite, context, context->GetExternalSymbols(),
+                                     &table->string_pool, &decl_stack);
+
+      for (auto& config_value : item.entry->values) {
+        config_value->value->Accept(&visitor);
+      }
 
-        if (visitor.HasError()) {
-          error = true;
-        }
+      if (visitor.HasError()) {
+        error = true;
       }
     }
+    return !error;
+  }
+
+  // Entries are independent of each other, so shard them across threads. Each shard gets a
+  // contiguous slice and its own diagnostics collector, which keeps error output identical
+  // to a sequential run. SymbolTable serializes its own lookups; the table's string pool is
+  // the only other shared mutable state.
+  std::mutex string_pool_lock;
+  std::vector<BatchedDiagnostics> diagnostics(shard_count);
+  std::vector<int> errors(shard_count, 0);
+
+  auto link_shard = [&](size_t shard_index) {
+    const size_t begin = work.size() * shard_index / shard_count;
+    const size_t end = work.size() * (shard_index + 1) / shard_count;
+    ShardContext shard_context(context, &diagnostics[shard_index]);
+
+    for (size_t i = begin; i < end; i++) {
+      const CallSite callsite{work[i].package};
+      ReferenceLinkerVisitor visitor(callsite, &shard_context, context->GetExternalSymbols(),
+                                     &table->string_pool, &decl_stack, &string_pool_lock);
+
+      for (auto& config_value : work[i].entry->values) {
+        config_value->value->Accept(&visitor);
+      }
+
+      if (visitor.HasError()) {
+        errors[shard_index] = 1;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(shard_count - 1);
+  for (size_t i = 1; i < shard_count; i++) {
+    workers.emplace_back(link_shard, i);
+  }
+  link_shard(0u);
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  for (size_t i = 0; i < shard_count; i++) {
+    diagnostics[i].Flush(context->GetDiagnostics());
+    if (errors[i] != 0) {
+      error = true;
+    }
   }
   return !error;
 }
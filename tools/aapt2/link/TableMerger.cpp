@@ -233,9 +233,11 @@ bool TableMerger::DoMerge(const Source& src, ResourceTablePackage* src_package,
     }
 
     for (auto& src_entry : src_type->entries) {
-      std::string entry_name = src_entry->name;
+      std::string mangled_entry_name;
+      StringPiece entry_name = src_entry->name;
       if (mangle_package) {
-        entry_name = NameMangler::MangleEntry(src_package->name, src_entry->name);
+        mangled_entry_name = NameMangler::MangleEntry(src_package->name, src_entry->name);
+        entry_name = mangled_entry_name;
       }
 
       ResourceEntry* dst_entry;
@@ -17,8 +17,11 @@
 #include "MultiApkGenerator.h"
 
 #include <algorithm>
+#include <atomic>
 #include <regex>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "androidfw/ConfigDescription.h"
 #include "androidfw/StringPiece.h"
@@ -97,8 +100,13 @@ class ContextWrapper : public IAaptContext {
   }
 
   void SetSource(const std::string& source) {
-    source_diag_ =
-        util::make_unique<SourcePathDiagnostics>(Source{source}, context_->GetDiagnostics());
+    SetSource(source, context_->GetDiagnostics());
+  }
+
+  // Prefixes messages with `source` and sends them to `diag` instead of the wrapped context's
+  // diagnostics. Used to batch output per artifact when artifacts build concurrently.
+  void SetSource(const std::string& source, IDiagnostics* diag) {
+    source_diag_ = util::make_unique<SourcePathDiagnostics>(Source{source}, diag);
   }
 
  private:
@@ -127,13 +135,10 @@ bool MultiApkGenerator::FromBaseApk(const MultiApkGeneratorOptions& options) {
   std::unordered_set<std::string> filtered_artifacts;
   std::unordered_set<std::string> kept_artifacts;
 
-  // For now, just write out the stripped APK since ABI splitting doesn't modify anything else.
+  // Decide which artifacts get built before any work starts, so the workers below share no
+  // bookkeeping state.
+  std::vector<const OutputArtifact*> artifacts;
   for (const OutputArtifact& artifact : options.apk_artifacts) {
-    FilterChain filters;
-
-    ContextWrapper wrapped_context{context_};
-    wrapped_context.SetSource(artifact.name);
-
     if (!options.kept_artifacts.empty()) {
       const auto& it = artifacts_to_keep.find(artifact.name);
       if (it == artifacts_to_keep.end()) {
@@ -147,40 +152,62 @@ bool MultiApkGenerator::FromBaseApk(const MultiApkGeneratorOptions& options) {
         kept_artifacts.insert(artifact.name);
       }
     }
+    artifacts.push_back(&artifact);
+  }
 
-    std::unique_ptr<ResourceTable> table =
-        FilterTable(context_, artifact, *apk_->GetResourceTable(), &filters);
-    if (!table) {
-      return false;
-    }
+  if (!artifacts.empty() && !file::mkdirs(options.out_dir)) {
+    context_->GetDiagnostics()->Warn(DiagMessage() << "could not create out dir: "
+                                                   << options.out_dir);
+  }
 
-    IDiagnostics* diag = wrapped_context.GetDiagnostics();
+  size_t thread_count = std::thread::hardware_concurrency();
+  thread_count = std::min(thread_count, artifacts.size());
 
-    std::unique_ptr<XmlResource> manifest;
-    if (!UpdateManifest(artifact, &manifest, diag)) {
-      diag->Error(DiagMessage() << "could not update AndroidManifest.xml for output artifact");
-      return false;
+  if (thread_count <= 1) {
+    for (const OutputArtifact* artifact : artifacts) {
+      ContextWrapper wrapped_context{context_};
+      wrapped_context.SetSource(artifact->name);
+      if (!BuildArtifact(*artifact, &wrapped_context, options)) {
+        return false;
+      }
     }
+  } else {
+    // Each artifact filters its own clone of the base table and writes its own zip, so they
+    // build concurrently. Diagnostics are batched per artifact and replayed in input order.
+    std::vector<BatchedDiagnostics> diagnostics(artifacts.size());
+    std::vector<int> results(artifacts.size(), 0);
+    std::atomic<size_t> next_artifact(0);
+
+    auto worker = [&]() {
+      while (true) {
+        const size_t i = next_artifact.fetch_add(1);
+        if (i >= artifacts.size()) {
+          break;
+        }
+        ContextWrapper wrapped_context{context_};
+        wrapped_context.SetSource(artifacts[i]->name, &diagnostics[i]);
+        results[i] = BuildArtifact(*artifacts[i], &wrapped_context, options) ? 1 : 0;
+      }
+    };
 
-    std::string out = options.out_dir;
-    if (!file::mkdirs(out)) {
-      diag->Warn(DiagMessage() << "could not create out dir: " << out);
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count - 1);
+    for (size_t i = 1; i < thread_count; i++) {
+      threads.emplace_back(worker);
     }
-    file::AppendPath(&out, artifact.name);
-
-    if (context_->IsVerbose()) {
-      diag->Note(DiagMessage() << "Generating split: " << out);
+    worker();
+    for (std::thread& thread : threads) {
+      thread.join();
     }
 
-    std::unique_ptr<IArchiveWriter> writer = CreateZipFileArchiveWriter(diag, out);
-
-    if (context_->IsVerbose()) {
-      diag->Note(DiagMessage() << "Writing output: " << out);
+    bool error = false;
+    for (size_t i = 0; i < artifacts.size(); i++) {
+      diagnostics[i].Flush(context_->GetDiagnostics());
+      if (results[i] == 0) {
+        error = true;
+      }
     }
-
-    filters.AddFilter(util::make_unique<SignatureFilter>());
-    if (!apk_->WriteToArchive(&wrapped_context, table.get(), options.table_flattener_options,
-                              &filters, writer.get(), manifest.get())) {
+    if (error) {
       return false;
     }
   }
@@ -212,6 +239,42 @@ bool MultiApkGenerator::FromBaseApk(const MultiApkGeneratorOptions& options) {
   return true;
 }
 
+bool MultiApkGenerator::BuildArtifact(const OutputArtifact& artifact, IAaptContext* context,
+                                      const MultiApkGeneratorOptions& options) {
+  FilterChain filters;
+
+  std::unique_ptr<ResourceTable> table =
+      FilterTable(context, artifact, *apk_->GetResourceTable(), &filters);
+  if (!table) {
+    return false;
+  }
+
+  IDiagnostics* diag = context->GetDiagnostics();
+
+  std::unique_ptr<XmlResource> manifest;
+  if (!UpdateManifest(artifact, &manifest, diag)) {
+    diag->Error(DiagMessage() << "could not update AndroidManifest.xml for output artifact");
+    return false;
+  }
+
+  std::string out = options.out_dir;
+  file::AppendPath(&out, artifact.name);
+
+  if (context_->IsVerbose()) {
+    diag->Note(DiagMessage() << "Generating split: " << out);
+  }
+
+  std::unique_ptr<IArchiveWriter> writer = CreateZipFileArchiveWriter(diag, out);
+
+  if (context_->IsVerbose()) {
+    diag->Note(DiagMessage() << "Writing output: " << out);
+  }
+
+  filters.AddFilter(util::make_unique<SignatureFilter>());
+  return apk_->WriteToArchive(context, table.get(), options.table_flattener_options, &filters,
+                              writer.get(), manifest.get());
+}
+
 std::unique_ptr<ResourceTable> MultiApkGenerator::FilterTable(IAaptContext* context,
                                                               const OutputArtifact& artifact,
                                                               const ResourceTable& old_table,
@@ -62,6 +62,11 @@ class MultiApkGenerator {
     return context_->GetDiagnostics();
   }
 
+  // Filters, fixes up, and writes a single artifact APK. The context carries the artifact's
+  // diagnostics and min SDK override, so artifacts can build on separate threads.
+  bool BuildArtifact(const configuration::OutputArtifact& artifact, IAaptContext* context,
+                     const MultiApkGeneratorOptions& options);
+
   bool UpdateManifest(const configuration::OutputArtifact& artifact,
                       std::unique_ptr<xml::XmlResource>* updated_manifest, IDiagnostics* diag);
 
@@ -94,6 +94,12 @@ class DominatedKeyValueRemover : public DominatorTree::BottomUpVisitor {
 };
 
 static void DedupeEntry(IAaptContext* context, ResourceEntry* entry) {
+  if (entry->values.size() <= 1) {
+    // A lone config can't dominate anything; skip the tree and visitor allocations. Most
+    // entries only define the default config, so this is the common case.
+    return;
+  }
+
   DominatorTree tree(entry->values);
   DominatedKeyValueRemover remover(context, entry);
   tree.Accept(&remover);
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "optimize/ResourceFileDeduper.h"
+
+#include <cstring>
+#include <unordered_map>
+
+#include "ResourceTable.h"
+#include "ValueVisitor.h"
+#include "io/Data.h"
+#include "trace/TraceBuffer.h"
+#include "util/Files.h"
+
+namespace aapt {
+
+namespace {
+
+// A 64-bit FNV-1a hash with the length folded into the seed, matching the fingerprint used to
+// skip duplicate inputs during linking. 64 bits keeps accidental matches negligible, and every
+// match is confirmed with a byte comparison before paths are merged.
+uint64_t HashContents(const void* data, size_t len) {
+  uint64_t hash = 0xcbf29ce484222325ull ^ len;
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+struct CanonicalFile {
+  FileReference* ref;
+  std::unique_ptr<io::IData> data;
+};
+
+}  // namespace
+
+bool ResourceFileDeduper::Consume(IAaptContext* context, ResourceTable* table) {
+  TRACE_CALL();
+
+  // Keyed by content hash; each bucket holds the first file seen with those contents.
+  std::unordered_multimap<uint64_t, CanonicalFile> canonical_files;
+
+  for (auto& package : table->packages) {
+    for (auto& type : package->types) {
+      for (auto& entry : type->entries) {
+        for (auto& config_value : entry->values) {
+          FileReference* file_ref = ValueCast<FileReference>(config_value->value.get());
+          if (file_ref == nullptr || file_ref->file == nullptr) {
+            continue;
+          }
+
+          std::unique_ptr<io::IData> data = file_ref->file->OpenAsData();
+          if (data == nullptr) {
+            continue;
+          }
+
+          const uint64_t hash = HashContents(data->data(), data->size());
+
+          FileReference* canonical = nullptr;
+          const auto bucket = canonical_files.equal_range(hash);
+          for (auto iter = bucket.first; iter != bucket.second; ++iter) {
+            const CanonicalFile& candidate = iter->second;
+            if (candidate.data->size() == data->size() &&
+                memcmp(candidate.data->data(), data->data(), data->size()) == 0 &&
+                file::GetExtension(*candidate.ref->path) == file::GetExtension(*file_ref->path)) {
+              canonical = candidate.ref;
+              break;
+            }
+          }
+
+          if (canonical == nullptr) {
+            canonical_files.emplace(hash, CanonicalFile{file_ref, std::move(data)});
+            continue;
+          }
+
+          if (*file_ref->path == *canonical->path) {
+            continue;
+          }
+
+          if (context->IsVerbose()) {
+            context->GetDiagnostics()->Note(DiagMessage(file_ref->GetSource())
+                                            << "collapsing duplicate file '" << *file_ref->path
+                                            << "' into '" << *canonical->path << "'");
+          }
+
+          // Point this reference at the canonical copy. The now-unreferenced file is dropped
+          // when the APK is written back out.
+          file_ref->path = table->string_pool.MakeRef(*canonical->path, file_ref->path.GetContext());
+          file_ref->file = canonical->file;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace aapt
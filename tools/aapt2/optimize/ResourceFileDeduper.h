@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AAPT_OPTIMIZE_RESOURCEFILEDEDUPER_H
+#define AAPT_OPTIMIZE_RESOURCEFILEDEDUPER_H
+
+#include "android-base/macros.h"
+
+#include "process/IResourceTableConsumer.h"
+
+namespace aapt {
+
+class ResourceTable;
+
+// Points file references with byte-identical contents at a single canonical path, so that the
+// duplicate files become unreferenced and are dropped when the APK is rewritten. Finds, for
+// example, drawables that are repeated verbatim across density buckets under different names.
+class ResourceFileDeduper : public IResourceTableConsumer {
+ public:
+  ResourceFileDeduper() = default;
+
+  bool Consume(IAaptContext* context, ResourceTable* table) override;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ResourceFileDeduper);
+};
+
+}  // namespace aapt
+
+#endif  // AAPT_OPTIMIZE_RESOURCEFILEDEDUPER_H
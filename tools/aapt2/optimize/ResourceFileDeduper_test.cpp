@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2019 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "optimize/ResourceFileDeduper.h"
+
+#include "ResourceTable.h"
+#include "test/Test.h"
+
+using ::android::ConfigDescription;
+
+namespace aapt {
+
+TEST(ResourceFileDeduperTest, IdenticalFilesShareOnePath) {
+  std::unique_ptr<IAaptContext> context = test::ContextBuilder().Build();
+  const ConfigDescription hdpi_config = test::ParseConfigOrDie("hdpi");
+  const ConfigDescription xhdpi_config = test::ParseConfigOrDie("xhdpi");
+
+  test::TestFile hdpi_file("res/drawable-hdpi/icon.png", "pretend png bytes");
+  test::TestFile xhdpi_file("res/drawable-xhdpi/icon.png", "pretend png bytes");
+  test::TestFile other_file("res/drawable-hdpi/other.png", "different bytes");
+
+  std::unique_ptr<ResourceTable> table =
+      test::ResourceTableBuilder()
+          .AddFileReference("android:drawable/icon", "res/drawable-hdpi/icon.png", hdpi_config,
+                            &hdpi_file)
+          .AddFileReference("android:drawable/icon", "res/drawable-xhdpi/icon.png", xhdpi_config,
+                            &xhdpi_file)
+          .AddFileReference("android:drawable/other", "res/drawable-hdpi/other.png", hdpi_config,
+                            &other_file)
+          .Build();
+
+  ASSERT_TRUE(ResourceFileDeduper().Consume(context.get(), table.get()));
+
+  FileReference* xhdpi_ref = test::GetValueForConfig<FileReference>(
+      table.get(), "android:drawable/icon", xhdpi_config);
+  ASSERT_NE(nullptr, xhdpi_ref);
+  EXPECT_EQ("res/drawable-hdpi/icon.png", *xhdpi_ref->path);
+  EXPECT_EQ(&hdpi_file, xhdpi_ref->file);
+
+  FileReference* other_ref = test::GetValueForConfig<FileReference>(
+      table.get(), "android:drawable/other", hdpi_config);
+  ASSERT_NE(nullptr, other_ref);
+  EXPECT_EQ("res/drawable-hdpi/other.png", *other_ref->path);
+}
+
+TEST(ResourceFileDeduperTest, DifferentExtensionsAreNotMerged) {
+  std::unique_ptr<IAaptContext> context = test::ContextBuilder().Build();
+  const ConfigDescription default_config = {};
+
+  test::TestFile png_file("res/raw/blob.png", "same bytes");
+  test::TestFile bin_file("res/raw/blob.bin", "same bytes");
+
+  std::unique_ptr<ResourceTable> table =
+      test::ResourceTableBuilder()
+          .AddFileReference("android:raw/blob_png", "res/raw/blob.png", default_config, &png_file)
+          .AddFileReference("android:raw/blob_bin", "res/raw/blob.bin", default_config, &bin_file)
+          .Build();
+
+  ASSERT_TRUE(ResourceFileDeduper().Consume(context.get(), table.get()));
+
+  FileReference* bin_ref = test::GetValueForConfig<FileReference>(
+      table.get(), "android:raw/blob_bin", default_config);
+  ASSERT_NE(nullptr, bin_ref);
+  EXPECT_EQ("res/raw/blob.bin", *bin_ref->path);
+}
+
+TEST(ResourceFileDeduperTest, FilesWithoutDataAreLeftAlone) {
+  std::unique_ptr<IAaptContext> context = test::ContextBuilder().Build();
+  const ConfigDescription default_config = {};
+
+  test::TestFile unopenable_a("res/raw/a.bin");
+  test::TestFile unopenable_b("res/raw/b.bin");
+
+  std::unique_ptr<ResourceTable> table =
+      test::ResourceTableBuilder()
+          .AddFileReference("android:raw/a", "res/raw/a.bin", default_config, &unopenable_a)
+          .AddFileReference("android:raw/b", "res/raw/b.bin", default_config, &unopenable_b)
+          .Build();
+
+  ASSERT_TRUE(ResourceFileDeduper().Consume(context.get(), table.get()));
+
+  FileReference* b_ref =
+      test::GetValueForConfig<FileReference>(table.get(), "android:raw/b", default_config);
+  ASSERT_NE(nullptr, b_ref);
+  EXPECT_EQ("res/raw/b.bin", *b_ref->path);
+}
+
+}  // namespace aapt
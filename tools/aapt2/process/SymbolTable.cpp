@@ -42,13 +42,12 @@ namespace aapt {
 
 SymbolTable::SymbolTable(NameMangler* mangler)
     : mangler_(mangler),
-      delegate_(util::make_unique<DefaultSymbolTableDelegate>()),
-      cache_(200),
-      id_cache_(200) {
+      delegate_(util::make_unique<DefaultSymbolTableDelegate>()) {
 }
 
 void SymbolTable::SetDelegate(std::unique_ptr<ISymbolTableDelegate> delegate) {
   CHECK(delegate != nullptr) << "can't set a nullptr delegate";
+  std::lock_guard<std::mutex> lock(mutex_);
   delegate_ = std::move(delegate);
 
   // Clear the cache in case this delegate changes the order of lookup.
@@ -56,6 +55,7 @@ void SymbolTable::SetDelegate(std::unique_ptr<ISymbolTableDelegate> delegate) {
 }
 
 void SymbolTable::AppendSource(std::unique_ptr<ISymbolSource> source) {
+  std::lock_guard<std::mutex> lock(mutex_);
   sources_.push_back(std::move(source));
 
   // We do not clear the cache, because sources earlier in the list take
@@ -63,6 +63,7 @@ void SymbolTable::AppendSource(std::unique_ptr<ISymbolSource> source) {
 }
 
 void SymbolTable::PrependSource(std::unique_ptr<ISymbolSource> source) {
+  std::lock_guard<std::mutex> lock(mutex_);
   sources_.insert(sources_.begin(), std::move(source));
 
   // We must clear the cache in case we did a lookup before adding this
@@ -82,9 +83,12 @@ const SymbolTable::Symbol* SymbolTable::FindByName(const ResourceName& name) {
     name_with_package = &name_with_package_impl.value();
   }
 
+  std::lock_guard<std::mutex> lock(mutex_);
+
   // We store the name unmangled in the cache, so look it up as-is.
-  if (const std::shared_ptr<Symbol>& s = cache_.get(*name_with_package)) {
-    return s.get();
+  auto cache_iter = cache_.find(*name_with_package);
+  if (cache_iter != cache_.end()) {
+    return cache_iter->second.get();
   }
 
   // The name was not found in the cache. Mangle it (if necessary) and find it in our sources.
@@ -101,27 +105,29 @@ const SymbolTable::Symbol* SymbolTable::FindByName(const ResourceName& name) {
     return nullptr;
   }
 
-  // Take ownership of the symbol into a shared_ptr. We do this because
-  // LruCache doesn't support unique_ptr.
+  // Take ownership of the symbol into a shared_ptr, since a symbol found
+  // by name may also be indexed by its ID below.
   std::shared_ptr<Symbol> shared_symbol(std::move(symbol));
 
   // Since we look in the cache with the unmangled, but package prefixed
   // name, we must put the same name into the cache.
-  cache_.put(*name_with_package, shared_symbol);
+  cache_[*name_with_package] = shared_symbol;
 
   if (shared_symbol->id) {
     // The symbol has an ID, so we can also cache this!
-    id_cache_.put(shared_symbol->id.value(), shared_symbol);
+    id_cache_[shared_symbol->id.value()] = shared_symbol;
   }
 
-  // Returns the raw pointer. Callers are not expected to hold on to this
-  // between calls to Find*.
+  // The raw pointer stays valid until the delegate or sources change.
   return shared_symbol.get();
 }
 
 const SymbolTable::Symbol* SymbolTable::FindById(const ResourceId& id) {
-  if (const std::shared_ptr<Symbol>& s = id_cache_.get(id)) {
-    return s.get();
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto cache_iter = id_cache_.find(id);
+  if (cache_iter != id_cache_.end()) {
+    return cache_iter->second.get();
   }
 
   // We did not find it in the cache, so look through the sources.
@@ -130,13 +136,10 @@ const SymbolTable::Symbol* SymbolTable::FindById(const ResourceId& id) {
     return nullptr;
   }
 
-  // Take ownership of the symbol into a shared_ptr. We do this because LruCache
-  // doesn't support unique_ptr.
   std::shared_ptr<Symbol> shared_symbol(std::move(symbol));
-  id_cache_.put(id, shared_symbol);
+  id_cache_[id] = shared_symbol;
 
-  // Returns the raw pointer. Callers are not expected to hold on to this
-  // between calls to Find*.
+  // The raw pointer stays valid until the delegate or sources change.
   return shared_symbol.get();
 }
 
@@ -221,21 +224,33 @@ bool AssetManagerSymbolSource::AddAssetPath(const StringPiece& path) {
   TRACE_CALL();
   if (std::unique_ptr<const ApkAssets> apk = ApkAssets::Load(path.data())) {
     apk_assets_.push_back(std::move(apk));
-
-    std::vector<const ApkAssets*> apk_assets;
-    for (const std::unique_ptr<const ApkAssets>& apk_asset : apk_assets_) {
-      apk_assets.push_back(apk_asset.get());
-    }
-
-    asset_manager_.SetApkAssets(apk_assets, true /* invalidate_caches */,
-                                false /* filter_incompatible_configs */);
+    assets_dirty_ = true;
     return true;
   }
   return false;
 }
 
+void AssetManagerSymbolSource::EnsureAssetManager() const {
+  if (!assets_dirty_) {
+    return;
+  }
+  assets_dirty_ = false;
+
+  // Rebuilding the package groups is linear in the number of loaded APKs, so defer it until the
+  // first lookup instead of paying it once per include path.
+  std::vector<const ApkAssets*> apk_assets;
+  apk_assets.reserve(apk_assets_.size());
+  for (const std::unique_ptr<const ApkAssets>& apk_asset : apk_assets_) {
+    apk_assets.push_back(apk_asset.get());
+  }
+
+  asset_manager_.SetApkAssets(apk_assets, true /* invalidate_caches */,
+                              false /* filter_incompatible_configs */);
+}
+
 std::map<size_t, std::string> AssetManagerSymbolSource::GetAssignedPackageIds() const {
   TRACE_CALL();
+  EnsureAssetManager();
   std::map<size_t, std::string> package_map;
   asset_manager_.ForEachPackage([&package_map](const std::string& name, uint8_t id) -> bool {
     package_map.insert(std::make_pair(id, name));
@@ -322,6 +337,7 @@ static std::unique_ptr<SymbolTable::Symbol> LookupAttributeInTable(
 
 std::unique_ptr<SymbolTable::Symbol> AssetManagerSymbolSource::FindByName(
     const ResourceName& name) {
+  EnsureAssetManager();
   const std::string mangled_entry = NameMangler::MangleEntry(name.package, name.entry);
 
   bool found = false;
@@ -387,6 +403,7 @@ std::unique_ptr<SymbolTable::Symbol> AssetManagerSymbolSource::FindById(
     return {};
   }
 
+  EnsureAssetManager();
   Maybe<ResourceName> maybe_name = GetResourceName(asset_manager_, id);
   if (!maybe_name) {
     return {};
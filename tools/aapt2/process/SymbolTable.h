@@ -19,13 +19,14 @@
 
 #include <algorithm>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #include "android-base/macros.h"
 #include "androidfw/Asset.h"
 #include "androidfw/AssetManager2.h"
 #include "utils/JenkinsHash.h"
-#include "utils/LruCache.h"
 
 #include "Resource.h"
 #include "ResourceTable.h"
@@ -86,29 +87,43 @@ class SymbolTable {
   // cause the existing cache to be cleared.
   void PrependSource(std::unique_ptr<ISymbolSource> source);
 
-  // NOTE: Never hold on to the result between calls to FindByXXX. The
-  // results are stored in a cache which may evict entries on subsequent calls.
+  // The Find* methods may be called concurrently from multiple threads.  The returned
+  // Symbol stays valid until the delegate or the set of sources changes, or the table is
+  // destroyed, so callers may hold on to it while linking.
   const Symbol* FindByName(const ResourceName& name);
 
-  // NOTE: Never hold on to the result between calls to FindByXXX. The
-  // results are stored in a cache which may evict entries on subsequent calls.
   const Symbol* FindById(const ResourceId& id);
 
   // Let's the ISymbolSource decide whether looking up by name or ID is faster,
   // if both are available.
-  // NOTE: Never hold on to the result between calls to FindByXXX. The
-  // results are stored in a cache which may evict entries on subsequent calls.
   const Symbol* FindByReference(const Reference& ref);
 
  private:
+  struct NameHasher {
+    size_t operator()(const ResourceName& name) const {
+      return hash_type(name);
+    }
+  };
+
+  struct IdHasher {
+    size_t operator()(const ResourceId& id) const {
+      return hash_type(id);
+    }
+  };
+
   NameMangler* mangler_;
   std::unique_ptr<ISymbolTableDelegate> delegate_;
   std::vector<std::unique_ptr<ISymbolSource>> sources_;
 
-  // We use shared_ptr because unique_ptr is not supported and
-  // we need automatic deletion.
-  android::LruCache<ResourceName, std::shared_ptr<Symbol>> cache_;
-  android::LruCache<ResourceId, std::shared_ptr<Symbol>> id_cache_;
+  // Serializes lookups, including the queries the sources make against their backing
+  // tables and assets, none of which are thread-safe themselves.
+  std::mutex mutex_;
+
+  // All symbols ever resolved are kept, both so repeated lookups are hits and so the raw
+  // pointers handed out stay valid.  We use shared_ptr because a symbol found by name is
+  // also indexed by its ID.
+  std::unordered_map<ResourceName, std::shared_ptr<Symbol>, NameHasher> cache_;
+  std::unordered_map<ResourceId, std::shared_ptr<Symbol>, IdHasher> id_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(SymbolTable);
 };
@@ -192,6 +207,8 @@ class AssetManagerSymbolSource : public ISymbolSource {
  public:
   AssetManagerSymbolSource() = default;
 
+  // Loads the APK at the given path. The AssetManager's package structures are rebuilt lazily
+  // on the next lookup, so adding several include paths costs a single rebuild.
   bool AddAssetPath(const android::StringPiece& path);
   std::map<size_t, std::string> GetAssignedPackageIds() const;
   bool IsPackageDynamic(uint32_t packageId) const;
@@ -203,12 +220,17 @@ class AssetManagerSymbolSource : public ISymbolSource {
       const Reference& ref) override;
 
   android::AssetManager2* GetAssetManager() {
+    EnsureAssetManager();
     return &asset_manager_;
   }
 
  private:
-  android::AssetManager2 asset_manager_;
+  // Applies any APKs added since the last rebuild to the AssetManager.
+  void EnsureAssetManager() const;
+
+  mutable android::AssetManager2 asset_manager_;
   std::vector<std::unique_ptr<const android::ApkAssets>> apk_assets_;
+  mutable bool assets_dirty_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(AssetManagerSymbolSource);
 };
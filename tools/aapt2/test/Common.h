@@ -17,6 +17,7 @@
 #ifndef AAPT_TEST_COMMON_H
 #define AAPT_TEST_COMMON_H
 
+#include <cstring>
 #include <iostream>
 
 #include "android-base/logging.h"
@@ -31,8 +32,10 @@
 #include "ResourceUtils.h"
 #include "ResourceValues.h"
 #include "ValueVisitor.h"
+#include "io/Data.h"
 #include "io/File.h"
 #include "process/IResourceTableConsumer.h"
+#include "util/Util.h"
 
 namespace aapt {
 namespace test {
@@ -86,8 +89,17 @@ class TestFile : public io::IFile {
  public:
   explicit TestFile(const android::StringPiece& path) : source_(path) {}
 
+  TestFile(const android::StringPiece& path, const android::StringPiece& contents)
+      : source_(path), contents_(contents.to_string()) {}
+
   std::unique_ptr<io::IData> OpenAsData() override {
-    return {};
+    if (contents_.empty()) {
+      // Tests that don't provide contents expect opening the file to fail.
+      return {};
+    }
+    auto data = std::unique_ptr<uint8_t[]>(new uint8_t[contents_.size()]);
+    memcpy(data.get(), contents_.data(), contents_.size());
+    return util::make_unique<io::MallocData>(std::move(data), contents_.size());
   }
 
   std::unique_ptr<io::InputStream> OpenInputStream() override {
@@ -102,6 +114,7 @@ class TestFile : public io::IFile {
   DISALLOW_COPY_AND_ASSIGN(TestFile);
 
   Source source_;
+  std::string contents_;
 };
 
 }  // namespace test
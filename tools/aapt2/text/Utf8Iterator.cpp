@@ -31,6 +31,17 @@ Utf8Iterator::Utf8Iterator(const StringPiece& str)
 
 void Utf8Iterator::DoNext() {
   current_pos_ = next_pos_;
+
+  // ASCII bytes, the common case by far, decode to themselves; skip the full decoder.
+  if (current_pos_ < str_.size()) {
+    const uint8_t c = static_cast<uint8_t>(str_.data()[current_pos_]);
+    if (c < 0x80) {
+      current_codepoint_ = c;
+      next_pos_ = current_pos_ + 1;
+      return;
+    }
+  }
+
   int32_t result = utf32_from_utf8_at(str_.data(), str_.size(), current_pos_, &next_pos_);
   if (result == -1) {
     current_codepoint_ = 0u;
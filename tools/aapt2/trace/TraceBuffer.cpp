@@ -17,6 +17,7 @@
 #include "TraceBuffer.h"
 
 #include <chrono>
+#include <mutex>
 #include <sstream>
 #include <unistd.h>
 #include <vector>
@@ -44,6 +45,9 @@ struct TracePoint {
 
 std::vector<TracePoint> traces;
 
+// Trace points can be added from the worker threads of parallel phases.
+std::mutex traces_mutex;
+
 int64_t GetTime() noexcept {
   auto now = std::chrono::steady_clock::now();
   return std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
@@ -53,6 +57,7 @@ int64_t GetTime() noexcept {
 
 void AddWithTime(const std::string& tag, char type, int64_t time) noexcept {
   TracePoint t = {getpid(), time, tag, type};
+  std::lock_guard<std::mutex> lock(traces_mutex);
   traces.emplace_back(t);
 }
 
@@ -76,6 +81,7 @@ void Flush(const std::string& basePath) {
     return;
   }
 
+  std::lock_guard<std::mutex> lock(traces_mutex);
   for(const TracePoint& trace : traces) {
     fprintf(f, "{\"ts\" : \"%" PRIu64 "\", \"ph\" : \"%c\", \"tid\" : \"%d\" , \"pid\" : \"%d\", "
             "\"name\" : \"%s\" },\n", trace.time, trace.type, 0, trace.tid, trace.tag.c_str());
@@ -17,6 +17,7 @@
 #include "util/Util.h"
 
 #include <algorithm>
+#include <cstring>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -418,7 +419,50 @@ std::string ModifiedUtf8ToUtf8(const std::string& modified_utf8) {
   return output;
 }
 
+// Returns the length of the leading run of ASCII bytes, scanning a machine word at a time.
+static size_t AsciiPrefixLength(const char* data, size_t len) {
+  constexpr uint64_t kHighBits = 0x8080808080808080ull;
+  size_t i = 0;
+  while (i + sizeof(uint64_t) <= len) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if ((word & kHighBits) != 0) {
+      break;
+    }
+    i += sizeof(uint64_t);
+  }
+  while (i < len && (static_cast<uint8_t>(data[i]) & 0x80) == 0) {
+    i++;
+  }
+  return i;
+}
+
+// The same scan over UTF-16 code units, stopping at the first one outside the ASCII range.
+static size_t AsciiPrefixLength16(const char16_t* data, size_t len) {
+  constexpr uint64_t kNonAsciiBits = 0xff80ff80ff80ff80ull;
+  constexpr size_t kUnitsPerWord = sizeof(uint64_t) / sizeof(char16_t);
+  size_t i = 0;
+  while (i + kUnitsPerWord <= len) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if ((word & kNonAsciiBits) != 0) {
+      break;
+    }
+    i += kUnitsPerWord;
+  }
+  while (i < len && data[i] < 0x80) {
+    i++;
+  }
+  return i;
+}
+
 std::u16string Utf8ToUtf16(const StringPiece& utf8) {
+  // Most strings are pure ASCII and can be widened directly, skipping both
+  // byte-at-a-time passes below.
+  if (AsciiPrefixLength(utf8.data(), utf8.length()) == utf8.length()) {
+    return std::u16string(utf8.begin(), utf8.end());
+  }
+
   ssize_t utf16_length = utf8_to_utf16_length(
       reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length());
   if (utf16_length <= 0) {
@@ -433,6 +477,16 @@ std::u16string Utf8ToUtf16(const StringPiece& utf8) {
 }
 
 std::string Utf16ToUtf8(const StringPiece16& utf16) {
+  // ASCII code units map to single bytes unchanged.
+  if (AsciiPrefixLength16(utf16.data(), utf16.length()) == utf16.length()) {
+    std::string utf8;
+    utf8.reserve(utf16.length());
+    for (const char16_t unit : utf16) {
+      utf8.push_back(static_cast<char>(unit));
+    }
+    return utf8;
+  }
+
   ssize_t utf8_length = utf16_to_utf8_length(utf16.data(), utf16.length());
   if (utf8_length <= 0) {
     return {};
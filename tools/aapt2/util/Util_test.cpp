@@ -157,4 +157,24 @@ TEST(UtilTest, VerifyJavaStringFormat) {
   ASSERT_FALSE(util::VerifyJavaStringFormat("%09f %08s"));
 }
 
+TEST(UtilTest, Utf8ToUtf16) {
+  EXPECT_THAT(util::Utf8ToUtf16(""), Eq(std::u16string()));
+
+  // Long enough to exercise the word-at-a-time ASCII scan.
+  EXPECT_THAT(util::Utf8ToUtf16("this is a plain ascii string"),
+              Eq(u"this is a plain ascii string"));
+
+  // Multi-byte sequences, including one past the ASCII prefix.
+  EXPECT_THAT(util::Utf8ToUtf16("caf\xc3\xa9"), Eq(u"café"));
+  EXPECT_THAT(util::Utf8ToUtf16("ascii prefix then \xe4\xbd\xa0\xe5\xa5\xbd"),
+              Eq(u"ascii prefix then 你好"));
+}
+
+TEST(UtilTest, Utf16ToUtf8) {
+  EXPECT_THAT(util::Utf16ToUtf8(u""), Eq(std::string()));
+  EXPECT_THAT(util::Utf16ToUtf8(u"this is a plain ascii string"),
+              Eq("this is a plain ascii string"));
+  EXPECT_THAT(util::Utf16ToUtf8(u"café"), Eq("caf\xc3\xa9"));
+}
+
 }  // namespace aapt
@@ -121,6 +121,12 @@ static void XMLCALL StartElementHandler(void* user_data, const char* name, const
 
   SplitName(name, &el->namespace_uri, &el->name);
 
+  size_t attr_count = 0;
+  for (const char** attr = attrs; *attr; attr += 2) {
+    attr_count++;
+  }
+  el->attributes.reserve(attr_count);
+
   while (*attrs) {
     Attribute attribute;
     SplitName(*attrs++, &attribute.namespace_uri, &attribute.name);
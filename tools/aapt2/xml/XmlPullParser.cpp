@@ -232,17 +232,24 @@ void XMLCALL XmlPullParser::StartElementHandler(void* user_data,
                     parser->depth_++};
   SplitName(name, &data.data1, &data.data2);
 
+  // Make a single allocation for the attributes and sort them once at the end,
+  // rather than shifting elements around for every sorted insertion.
+  size_t attr_count = 0;
+  for (const char** attr = attrs; *attr; attr += 2) {
+    attr_count++;
+  }
+  data.attributes.reserve(attr_count);
+
   while (*attrs) {
     Attribute attribute;
     SplitName(*attrs++, &attribute.namespace_uri, &attribute.name);
     attribute.value = *attrs++;
-
-    // Insert in sorted order.
-    auto iter = std::lower_bound(data.attributes.begin(), data.attributes.end(),
-                                 attribute);
-    data.attributes.insert(iter, std::move(attribute));
+    data.attributes.push_back(std::move(attribute));
   }
 
+  // FindAttribute relies on the attributes being sorted.
+  std::sort(data.attributes.begin(), data.attributes.end());
+
   // Move the structure into the queue (no copy).
   parser->event_queue_.push(std::move(data));
 }
@@ -251,6 +258,13 @@ void XMLCALL XmlPullParser::CharacterDataHandler(void* user_data, const char* s,
                                                  int len) {
   XmlPullParser* parser = reinterpret_cast<XmlPullParser*>(user_data);
 
+  // Expat may deliver a single text run as several chunks. Append to the last queued
+  // text event instead of allocating a new event for each chunk.
+  if (!parser->event_queue_.empty() && parser->event_queue_.back().event == Event::kText) {
+    parser->event_queue_.back().data1.append(s, len);
+    return;
+  }
+
   parser->event_queue_.push(EventData{Event::kText, XML_GetCurrentLineNumber(parser->parser_),
                                       parser->depth_, std::string(s, len)});
 }
@@ -42,6 +42,8 @@ static void usage() {
             "\n"
             "  --help                   Displays more information about this program.\n"
             "  --target <config>        Performs the Split APK selection on the given configuration.\n"
+            "                           May be repeated to evaluate many configurations in one\n"
+            "                           invocation; each result line is then prefixed with its config.\n"
             "  --generate               Generates the logic for selecting the Split APK, in JSON format.\n"
             "  --base <path/to/apk>     Specifies the base APK, from which all Split APKs must be based off.\n"
             "  --split <path/to/apk>    Includes a Split APK in the selection process.\n"
@@ -63,11 +65,6 @@ static void help() {
             "  via JSON.\n");
 }
 
-Vector<SplitDescription> select(const SplitDescription& target, const Vector<SplitDescription>& splits) {
-    const SplitSelector selector(splits);
-    return selector.getBestSplits(target);
-}
-
 void generate(const KeyedVector<String8, Vector<SplitDescription> >& splits, const String8& base) {
     Vector<SplitDescription> allSplits;
     const size_t apkSplitCount = splits.size();
@@ -243,7 +240,7 @@ static int main(int argc, char** argv) {
     argv++;
 
     bool generateFlag = false;
-    String8 targetConfigStr;
+    Vector<String8> targetConfigStrs;
     Vector<String8> splitApkPaths;
     String8 baseApkPath;
     while (argc > 0) {
@@ -256,7 +253,7 @@ static int main(int argc, char** argv) {
                 usage();
                 return 1;
             }
-            targetConfigStr.setTo(*argv);
+            targetConfigStrs.add(String8(*argv));
         } else if (arg == "--split") {
             argc--;
             argv++;
@@ -295,7 +292,7 @@ static int main(int argc, char** argv) {
         argv++;
     }
 
-    if (!generateFlag && targetConfigStr == "") {
+    if (!generateFlag && targetConfigStrs.isEmpty()) {
         usage();
         return 1;
     }
@@ -313,18 +310,23 @@ static int main(int argc, char** argv) {
         return 1;
     }
 
-    SplitDescription targetSplit;
+    Vector<SplitDescription> targetSplits;
     if (!generateFlag) {
-        if (!SplitDescription::parse(targetConfigStr, &targetSplit)) {
-            fprintf(stderr, "error: invalid --target config: '%s'.\n",
-                    targetConfigStr.string());
-            usage();
-            return 1;
-        }
+        const size_t targetCount = targetConfigStrs.size();
+        for (size_t i = 0; i < targetCount; i++) {
+            SplitDescription targetSplit;
+            if (!SplitDescription::parse(targetConfigStrs[i], &targetSplit)) {
+                fprintf(stderr, "error: invalid --target config: '%s'.\n",
+                        targetConfigStrs[i].string());
+                usage();
+                return 1;
+            }
 
-        // We don't want to match on things that will change at run-time
-        // (orientation, w/h, etc.).
-        removeRuntimeQualifiers(&targetSplit.config);
+            // We don't want to match on things that will change at run-time
+            // (orientation, w/h, etc.).
+            removeRuntimeQualifiers(&targetSplit.config);
+            targetSplits.add(targetSplit);
+        }
     }
 
     splitApkPaths.add(baseApkPath);
@@ -350,17 +352,29 @@ static int main(int argc, char** argv) {
     }
 
     if (!generateFlag) {
-        Vector<SplitDescription> matchingConfigs = select(targetSplit, splitConfigs);
-        const size_t matchingConfigCount = matchingConfigs.size();
-        SortedVector<String8> matchingSplitPaths;
-        for (size_t i = 0; i < matchingConfigCount; i++) {
-            matchingSplitPaths.add(splitApkPathMap.valueFor(matchingConfigs[i]));
-        }
+        // Group the splits once; the work is shared by every target config evaluated in this
+        // invocation.
+        const SplitSelector selector(splitConfigs);
+
+        const size_t targetCount = targetSplits.size();
+        for (size_t t = 0; t < targetCount; t++) {
+            Vector<SplitDescription> matchingConfigs = selector.getBestSplits(targetSplits[t]);
+            const size_t matchingConfigCount = matchingConfigs.size();
+            SortedVector<String8> matchingSplitPaths;
+            for (size_t i = 0; i < matchingConfigCount; i++) {
+                matchingSplitPaths.add(splitApkPathMap.valueFor(matchingConfigs[i]));
+            }
 
-        const size_t matchingSplitApkPathCount = matchingSplitPaths.size();
-        for (size_t i = 0; i < matchingSplitApkPathCount; i++) {
-            if (matchingSplitPaths[i] != baseApkPath) {
-                fprintf(stdout, "%s\n", matchingSplitPaths[i].string());
+            const size_t matchingSplitApkPathCount = matchingSplitPaths.size();
+            for (size_t i = 0; i < matchingSplitApkPathCount; i++) {
+                if (matchingSplitPaths[i] != baseApkPath) {
+                    if (targetCount == 1) {
+                        fprintf(stdout, "%s\n", matchingSplitPaths[i].string());
+                    } else {
+                        fprintf(stdout, "%s: %s\n", targetConfigStrs[t].string(),
+                                matchingSplitPaths[i].string());
+                    }
+                }
             }
         }
     } else {